@@ -11,6 +11,7 @@ using System.Text;
 using System.Threading.Tasks;
 using System.Windows.Forms;
 using Newtonsoft.Json;
+using Synapse_UI_WPF.Static;
 
 [assembly: Obfuscation(Feature = "type renaming pattern 'SYNX'.*", Exclude = false)]
 [assembly: Obfuscation(Feature = "encrypt symbol names with password BFM5yQBHku8Ar1wfZc3TU5zfwoBGyj0z", Exclude = false)]
@@ -48,6 +49,10 @@ namespace Synapse_Bootstrapper
 
         public const string BootstrapVersion = "3";
 
+        /* ETag on the first line, the encrypted body after it. The body is still signature checked on every launch, so
+           the copy on disk is trusted exactly as much as a fresh one */
+        public const string BootstrapDataCache = "bin\\bootstrapdata";
+
         [Obfuscation(Feature = "virtualization", Exclude = false)]
         private string Decrypt(string Key, string IV, string Cipher)
         {
@@ -85,25 +90,103 @@ namespace Synapse_Bootstrapper
         [Obfuscation(Feature = "virtualization", Exclude = false)]
         public static string Sha512(string Input, bool IsFile = false)
         {
-            var bytes = IsFile ? File.ReadAllBytes(Input) : Encoding.ASCII.GetBytes(Input);
+            var hashedInputBytes = Sha512Bytes(Input, IsFile);
+            var hashedInputStringBuilder = new StringBuilder(128);
+            foreach (var b in hashedInputBytes)
+                hashedInputStringBuilder.Append(b.ToString("X2"));
+            return hashedInputStringBuilder.ToString();
+        }
+
+        [Obfuscation(Feature = "virtualization", Exclude = false)]
+        public static byte[] Sha512Bytes(string Input, bool IsFile = false)
+        {
+            if (IsFile) return Sha512File(Input);
+
+            var bytes = Encoding.ASCII.GetBytes(Input);
             using (var hash = SHA512.Create())
             {
                 var hashedInputBytes = hash.ComputeHash(bytes);
-                var hashedInputStringBuilder = new StringBuilder(128);
-                foreach (var b in hashedInputBytes)
-                    hashedInputStringBuilder.Append(b.ToString("X2"));
-                return hashedInputStringBuilder.ToString();
+                return hashedInputBytes;
             }
         }
 
+        /* Hashes through a FileStream in 80KB chunks (under the LOH threshold) instead of reading the whole file */
         [Obfuscation(Feature = "virtualization", Exclude = false)]
-        public static byte[] Sha512Bytes(string Input, bool IsFile = false)
+        public static byte[] Sha512File(string Input, long Tail = 0)
         {
-            var bytes = IsFile ? File.ReadAllBytes(Input) : Encoding.ASCII.GetBytes(Input);
             using (var hash = SHA512.Create())
+            using (var stream = new FileStream(Input, FileMode.Open, FileAccess.Read, FileShare.Read, 4096, FileOptions.SequentialScan))
             {
-                var hashedInputBytes = hash.ComputeHash(bytes);
-                return hashedInputBytes;
+                var buffer = new byte[81920];
+                var remaining = Math.Max(0, stream.Length - Tail);
+
+                while (remaining > 0)
+                {
+                    var read = stream.Read(buffer, 0, (int) Math.Min(buffer.Length, remaining));
+                    if (read <= 0) break;
+
+                    hash.TransformBlock(buffer, 0, read, null, 0);
+                    remaining -= read;
+                }
+
+                hash.TransformFinalBlock(buffer, 0, 0);
+                return hash.Hash;
+            }
+        }
+
+        /* Conditional GET against the cached copy, an unchanged manifest is a bodiless 304 */
+        [Obfuscation(Feature = "virtualization", Exclude = false)]
+        public static string DownloadBootstrapData(string Url)
+        {
+            string CachedTag = null, CachedBody = null;
+            try
+            {
+                if (File.Exists(BootstrapDataCache))
+                {
+                    var Cached = File.ReadAllText(BootstrapDataCache);
+                    var Split = Cached.IndexOf('\n');
+                    if (Split > 0)
+                    {
+                        CachedTag = Cached.Substring(0, Split);
+                        CachedBody = Cached.Substring(Split + 1);
+                    }
+                }
+            }
+            catch (Exception)
+            {
+                CachedTag = CachedBody = null;
+            }
+
+            var Request = (HttpWebRequest) WebRequest.Create(Url);
+            if (CachedTag != null) Request.Headers[HttpRequestHeader.IfNoneMatch] = CachedTag;
+
+            try
+            {
+                using (var Response = (HttpWebResponse) Request.GetResponse())
+                using (var Reader = new StreamReader(Response.GetResponseStream()))
+                {
+                    var Body = Reader.ReadToEnd();
+                    var Tag = Response.Headers[HttpResponseHeader.ETag];
+
+                    try
+                    {
+                        if (!string.IsNullOrEmpty(Tag) && Tag.IndexOf('\n') < 0)
+                            File.WriteAllText(BootstrapDataCache, Tag + "\n" + Body);
+                        else if (File.Exists(BootstrapDataCache))
+                            File.Delete(BootstrapDataCache);
+                    }
+                    catch (Exception)
+                    {
+                        /* Only costs a full download next launch */
+                    }
+
+                    return Body;
+                }
+            }
+            catch (WebException Ex) when (CachedBody != null && (Ex.Response as HttpWebResponse)?.StatusCode == HttpStatusCode.NotModified)
+            {
+                Ex.Response.Dispose();
+                return CachedBody;
             }
         }
 
@@ -165,18 +248,15 @@ namespace Synapse_Bootstrapper
 
             /* download contents */
             var WebData = "";
-            using (var WC = new WebClient())
+            try
             {
-                try
-                {
-                    WebData = WC.DownloadString("https://synapse.to/whitelist/getbootstrapdata");
-                }
-                catch (Exception)
-                {
-                    MessageBox.Show("Failed to download bootstrapper data. Please check your anti-virus software.",
-                        "Synapse X", MessageBoxButtons.OK, MessageBoxIcon.Error);
-                    Environment.Exit(0);
-                }
+                WebData = DownloadBootstrapData("https://synapse.to/whitelist/getbootstrapdata");
+            }
+            catch (Exception)
+            {
+                MessageBox.Show("Failed to download bootstrapper data. Please check your anti-virus software.",
+                    "Synapse X", MessageBoxButtons.OK, MessageBoxIcon.Error);
+                Environment.Exit(0);
             }
 
             /* decrypt data */
@@ -222,47 +302,23 @@ namespace Synapse_Bootstrapper
             }
 
 #if USE_UPDATE_CHECKS
-            using (var WC = new WebClient())
-            {
-                try
-                {
-                    if (!File.Exists(InjectorName)) WC.DownloadFile(Data.Contents.InjectorDownload, InjectorName);
-                    if (!File.Exists(UiName)) WC.DownloadFile(Data.Contents.UiDownload, UiName);
+            /* Both at once, resumed from a .part file when a previous run was cut off */
+            var InjectorJob = new Download { Url = Data.Contents.InjectorDownload, Path = InjectorName, Hash = Data.Contents.InjectorHash };
+            var UiJob = new Download { Url = Data.Contents.UiDownload, Path = UiName, Hash = Data.Contents.UiHash };
+            Downloader.Run(2, null, InjectorJob, UiJob);
 
-                    if (Sha512(InjectorName, true) != Data.Contents.InjectorHash)
-                    {
-                        File.Delete(InjectorName);
-                        WC.DownloadFile(Data.Contents.InjectorDownload, InjectorName);
-
-                        if (Sha512(InjectorName, true) != Data.Contents.InjectorHash)
-                        {
-                            File.Delete(InjectorName);
-                            MessageBox.Show("Failed to verify bootstrapper files. Please check your anti-virus software. (2)",
-                                "Synapse X", MessageBoxButtons.OK, MessageBoxIcon.Error);
-                            Environment.Exit(0);
-                        }
-                    }
+            if (InjectorJob.Error != null || UiJob.Error != null)
+            {
+                MessageBox.Show("Failed to download bootstrapper files. Please check your anti-virus software. (4)",
+                    "Synapse X", MessageBoxButtons.OK, MessageBoxIcon.Error);
+                Environment.Exit(0);
+            }
 
-                    if (Sha512(UiName, true) != Data.Contents.UiHash)
-                    {
-                        File.Delete(UiName);
-                        WC.DownloadFile(Data.Contents.UiDownload, UiName);
-
-                        if (Sha512(UiName, true) != Data.Contents.UiHash)
-                        {
-                            File.Delete(UiName);
-                            MessageBox.Show("Failed to verify bootstrapper files. Please check your anti-virus software. (3)",
-                                "Synapse X", MessageBoxButtons.OK, MessageBoxIcon.Error);
-                            Environment.Exit(0);
-                        }
-                    }
-                }
-                catch (Exception)
-                {
-                    MessageBox.Show("Failed to download bootstrapper files. Please check your anti-virus software. (4)",
-                        "Synapse X", MessageBoxButtons.OK, MessageBoxIcon.Error);
-                    Environment.Exit(0);
-                }
+            if (!InjectorJob.Succeeded || !UiJob.Succeeded)
+            {
+                MessageBox.Show($"Failed to verify bootstrapper files. Please check your anti-virus software. ({(InjectorJob.Succeeded ? 3 : 2)})",
+                    "Synapse X", MessageBoxButtons.OK, MessageBoxIcon.Error);
+                Environment.Exit(0);
             }
 #endif
 
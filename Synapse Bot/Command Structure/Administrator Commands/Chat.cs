@@ -23,7 +23,7 @@ namespace Synapse_Bot.Command_Structure.Administrator_Commands
             if (!GlobalMethods.authenticateCaller(new Administrator(), Context.Message.Author)) throw new AuthenticationException("Requires Administrator or higher.");
             var embedBuilder = new EmbedBuilder();
             embedBuilder.WithDescription("Pong!");
-            await ReplyAsync(null, false, embedBuilder);
+            await GlobalMethods.reply(Context, embedBuilder);
         }
     }
 }
@@ -23,7 +23,7 @@ namespace Synapse_Bot.Command_Structure.Client_Commands
             if (!GlobalMethods.authenticateCaller(new Client(), Context.Message.Author)) throw new AuthenticationException("Requires Client or higher.");
             var embedBuilder = new EmbedBuilder();
             embedBuilder.WithDescription("Pong!");
-            await ReplyAsync(null, false, embedBuilder);
+            await GlobalMethods.reply(Context, embedBuilder);
         }
     }
 }
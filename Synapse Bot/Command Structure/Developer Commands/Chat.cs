@@ -23,7 +23,7 @@ namespace Synapse_Bot.Command_Structure.Developer_Commands
             if (!GlobalMethods.authenticateCaller(new Developer(), Context.Message.Author)) throw new AuthenticationException("Requires Developer or higher.");
             var embedBuilder = new EmbedBuilder();
             embedBuilder.WithDescription("Pong!");
-            await ReplyAsync(null, false, embedBuilder);
+            await GlobalMethods.reply(Context, embedBuilder);
         }
     }
 }
@@ -1,4 +1,5 @@
-﻿using System.Security.Authentication;
+﻿using System;
+using System.Security.Authentication;
 using System.Threading.Tasks;
 using Discord;
 using Discord.Commands;
@@ -23,7 +24,46 @@ namespace Synapse_Bot.Command_Structure.Moderator_Commands
             if (!GlobalMethods.authenticateCaller(new Moderator(), Context.Message.Author)) throw new AuthenticationException("Requires Moderator or higher.");
             var embedBuilder = new EmbedBuilder();
             embedBuilder.WithDescription("Pong!");
-            await ReplyAsync(null, false, embedBuilder);
+            await GlobalMethods.reply(Context, embedBuilder);
+        }
+
+        [Command("ban"), Summary("Permanently bans a user from the Synapse X chat.")]
+        public async Task Ban(string username, [Remainder] string reason = "")
+        {
+            if (!GlobalMethods.authenticateCaller(new Moderator(), Context.Message.Author)) throw new AuthenticationException("Requires Moderator or higher.");
+            await ReplyChanged(await ChatStore.banUser(username, 0, reason), $"Banned {username}.");
+        }
+
+        [Command("tempban"), Summary("Bans a user from the Synapse X chat for a number of minutes.")]
+        public async Task TempBan(string username, long minutes, [Remainder] string reason = "")
+        {
+            if (!GlobalMethods.authenticateCaller(new Moderator(), Context.Message.Author)) throw new AuthenticationException("Requires Moderator or higher.");
+            if (minutes <= 0) throw new ArgumentException("Invalid time to ban!");
+            await ReplyChanged(await ChatStore.banUser(username, minutes, reason), $"Banned {username} for {minutes} minutes.");
+        }
+
+        [Command("unban"), Summary("Lifts a user's chat ban.")]
+        public async Task Unban(string username)
+        {
+            if (!GlobalMethods.authenticateCaller(new Moderator(), Context.Message.Author)) throw new AuthenticationException("Requires Moderator or higher.");
+            await ReplyChanged(await ChatStore.unbanUser(username), $"Unbanned {username}.");
+        }
+
+        [Command("mute"), Summary("Mutes a user in the Synapse X chat for a number of minutes.")]
+        public async Task Mute(string username, long minutes, [Remainder] string reason = "")
+        {
+            if (!GlobalMethods.authenticateCaller(new Moderator(), Context.Message.Author)) throw new AuthenticationException("Requires Moderator or higher.");
+            if (minutes <= 0) throw new ArgumentException("Invalid time to mute!");
+            await ReplyChanged(await ChatStore.muteUser(username, minutes, reason), $"Muted {username} for {minutes} minutes.");
+        }
+
+        // nodes is how many chat servers took the change, none running means it didn't go anywhere //
+
+        private async Task ReplyChanged(long nodes, string done)
+        {
+            var embedBuilder = GlobalMethods.buildEmbed(new Moderator(), "Chat");
+            embedBuilder.WithDescription(nodes > 0 ? $"{done} ({nodes} chat server(s) updated)" : "No chat server is running, nothing was changed.");
+            await GlobalMethods.reply(Context, embedBuilder);
         }
     }
 }
@@ -20,7 +20,7 @@ namespace Synapse_Bot.Command_Structure.User_Commands
         {
             var embedBuilder = GlobalMethods.buildEmbed(new User(), "Ping");
             embedBuilder.WithDescription("Pong!");
-            await ReplyAsync(null, false, embedBuilder);
+            await GlobalMethods.reply(Context, embedBuilder);
         }
     }
 }
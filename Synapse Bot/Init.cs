@@ -5,6 +5,7 @@ using Microsoft.Extensions.DependencyInjection;
 using Discord;
 using Discord.WebSocket;
 using Discord.Commands;
+using Synapse_Bot.Utility_Methods;
 
 namespace Synapse_Bot
 {
@@ -26,6 +27,10 @@ namespace Synapse_Bot
         public IServiceProvider services;
         public char prefix = '!';
 
+        // commands run here rather than on the gateway handler, a slow one (or a burst) no longer holds up the gateway //
+
+        public CommandQueue queue = new CommandQueue(4, 256);
+
         static void Main(string[] args) => new Init().MainAsync().GetAwaiter().GetResult();
 
 
@@ -37,6 +42,7 @@ namespace Synapse_Bot
             commands = new CommandService();
 
             client.Log += Log;
+            GroupCache.attach(client);
 
             services = new ServiceCollection().BuildServiceProvider();
 
@@ -61,16 +67,22 @@ namespace Synapse_Bot
 
         // command handler
 
-        public async Task HandleCommand(SocketMessage messageParam)
+        public Task HandleCommand(SocketMessage messageParam)
         {
             var message = messageParam as SocketUserMessage;
-            if (message == null) return;
+            if (message == null) return Task.CompletedTask;
             int argPos = 0;
-            if (!(message.HasCharPrefix(prefix, ref argPos) || message.HasMentionPrefix(client.CurrentUser, ref argPos))) return;
+            if (!(message.HasCharPrefix(prefix, ref argPos) || message.HasMentionPrefix(client.CurrentUser, ref argPos))) return Task.CompletedTask;
             var context = new CommandContext(client, message);
-            if (context.Channel.Id != 499366306147991566) return; // if not dev-bot, end it!
-            var result = await commands.ExecuteAsync(context, argPos, services);
-            if (!result.IsSuccess) Console.WriteLine(result.ErrorReason); // create a better logging method later
+            if (context.Channel.Id != 499366306147991566) return Task.CompletedTask; // if not dev-bot, end it!
+
+            var queued = queue.tryEnqueue(message.Author.Id, async () =>
+            {
+                var result = await commands.ExecuteAsync(context, argPos, services);
+                if (!result.IsSuccess) Console.WriteLine(result.ErrorReason); // create a better logging method later
+            });
+            if (!queued) Console.WriteLine($"command queue full, dropped \"{message.Content}\" from {message.Author}");
+            return Task.CompletedTask;
         }
 
 
@@ -0,0 +1,156 @@
+﻿using System;
+using System.Collections.Concurrent;
+using System.Threading.Tasks;
+using Newtonsoft.Json;
+using Newtonsoft.Json.Linq;
+using StackExchange.Redis;
+
+namespace Synapse_Bot.Utility_Methods
+{
+    /*
+    *
+    *	SYNAPSE BOT
+    *	File.:	UTIL/ChatStore.cs
+    *	Desc.:	Moderation changes for the chat server's database, over its Redis backplane.
+    *
+    */
+
+    public class ChatStore
+    {
+        // wire formats, these mirror Database.Change and Backplane's Replication/Delivery in the chat server //
+
+        private class Change
+        {
+            public string Table;
+            public string Key;
+            public JToken Value;
+        }
+
+        private class Replication
+        {
+            public string Node;
+            public string Key;
+            public string Value;
+        }
+
+        private class Delivery
+        {
+            public string Node;
+            public int Route;
+            public string Key;
+            public string Json;
+            public object Message;
+            public bool Close;
+        }
+
+        private class Communication
+        {
+            public int OpCode;
+            public string Data;
+        }
+
+        private const string DeliveryChannel = "synapse-chat:deliver";
+        private const string ChangeChannel = "synapse-chat:db";
+
+        private const int RouteUser = 4;
+        private const int OpMuted = 9;
+        private const int OpBanned = 11;
+
+        // same configuration string the chat server is started with //
+
+        private static readonly Lazy<ConnectionMultiplexer> connection = new Lazy<ConnectionMultiplexer>(() =>
+            ConnectionMultiplexer.Connect(Environment.GetEnvironmentVariable("SYNAPSE_CHAT_REDIS") ?? "localhost"));
+
+        // no chat server node has to ignore these as its own, so any id that isn't a node's works //
+
+        private static readonly string node = "bot-" + Guid.NewGuid().ToString("N");
+
+        // changes still being published, keyed by what they do //
+
+        private static readonly ConcurrentDictionary<string, Lazy<Task<long>>> inflight = new ConcurrentDictionary<string, Lazy<Task<long>>>();
+
+
+        // every running chat node applies and journals the change, so a ban is live (and durable) on every node at once.
+        // returns how many nodes heard it, 0 means none are running and the change was lost //
+
+        public static Task<long> banUser(string username, long minutes, string reason)
+        {
+            return coalesce($"ban\n{username}\n{minutes}\n{reason}", () => banUserNow(username, minutes, reason));
+        }
+
+        public static Task<long> unbanUser(string username)
+        {
+            return coalesce($"unban\n{username}", () => unbanUserNow(username));
+        }
+
+        public static Task<long> muteUser(string username, long minutes, string reason)
+        {
+            return coalesce($"mute\n{username}\n{minutes}\n{reason}", () => muteUserNow(username, minutes, reason));
+        }
+
+
+        // the same change asked for again while it is still going out (two moderators banning one user) shares the first
+        // one's publishes rather than sending the whole set twice //
+
+        private static Task<long> coalesce(string key, Func<Task<long>> change)
+        {
+            var mine = new Lazy<Task<long>>(change);
+            var shared = inflight.GetOrAdd(key, mine);
+            if (shared != mine) return shared.Value;
+
+            mine.Value.ContinueWith(_ => inflight.TryRemove(key, out var __), TaskContinuationOptions.ExecuteSynchronously);
+            return mine.Value;
+        }
+
+        private static async Task<long> banUserNow(string username, long minutes, string reason)
+        {
+            var until = minutes == 0 ? 1L : DateTimeOffset.UtcNow.ToUnixTimeSeconds() + minutes * 60;
+
+            await publishChange("BanMessages", username, reason);
+            var nodes = await publishChange("Bans", username, until);
+
+            // the same notice the chat server's own /ban sends, the sessions are closed once it is written //
+            await deliverToUser(username, OpBanned, reason, true);
+            return nodes;
+        }
+
+        private static async Task<long> unbanUserNow(string username)
+        {
+            await publishChange("BanMessages", username, null);
+            return await publishChange("Bans", username, null);
+        }
+
+        private static async Task<long> muteUserNow(string username, long minutes, string reason)
+        {
+            var nodes = await publishChange("Mutes", username, DateTimeOffset.UtcNow.ToUnixTimeSeconds() + minutes * 60);
+
+            await deliverToUser(username, OpMuted, reason, false);
+            return nodes;
+        }
+
+        private static Task<long> publishChange(string table, string key, object value)
+        {
+            var change = JsonConvert.SerializeObject(new Change
+            {
+                Table = table,
+                Key = key,
+                Value = value == null ? null : JToken.FromObject(value)
+            });
+
+            return connection.Value.GetSubscriber().PublishAsync(ChangeChannel,
+                JsonConvert.SerializeObject(new Replication { Node = node, Value = change }));
+        }
+
+        private static Task<long> deliverToUser(string username, int opCode, string data, bool close)
+        {
+            return connection.Value.GetSubscriber().PublishAsync(DeliveryChannel, JsonConvert.SerializeObject(new Delivery
+            {
+                Node = node,
+                Route = RouteUser,
+                Key = username,
+                Json = JsonConvert.SerializeObject(new Communication { OpCode = opCode, Data = data }),
+                Close = close
+            }));
+        }
+    }
+}
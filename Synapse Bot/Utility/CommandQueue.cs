@@ -0,0 +1,83 @@
+﻿using System;
+using System.Collections.Concurrent;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Synapse_Bot.Utility_Methods
+{
+    /*
+    *
+    *	SYNAPSE BOT
+    *	File.:	UTIL/CommandQueue.cs
+    *	Desc.:	Bounded worker queue commands run on, off the gateway handler.
+    *
+    */
+
+    public class CommandQueue
+    {
+        // one lane per worker, a user's commands always land on the same one so a ban and its unban can't swap //
+
+        private class Lane
+        {
+            public readonly ConcurrentQueue<Func<Task>> pending = new ConcurrentQueue<Func<Task>>();
+            public readonly SemaphoreSlim signal = new SemaphoreSlim(0);
+        }
+
+        private readonly Lane[] lanes;
+        private readonly int capacity;
+        private int count;
+
+        public CommandQueue(int workers, int capacity)
+        {
+            this.capacity = capacity;
+
+            lanes = new Lane[workers];
+            for (var i = 0; i < workers; i++)
+            {
+                var lane = lanes[i] = new Lane();
+                Task.Run(() => work(lane));
+            }
+        }
+
+        public int Count => Volatile.Read(ref count);
+
+
+        // false once capacity commands are waiting, the caller drops the command instead of stalling the gateway //
+
+        public bool tryEnqueue(ulong key, Func<Task> job)
+        {
+            if (Interlocked.Increment(ref count) > capacity)
+            {
+                Interlocked.Decrement(ref count);
+                return false;
+            }
+
+            var lane = lanes[key % (ulong) lanes.Length];
+            lane.pending.Enqueue(job);
+            lane.signal.Release();
+            return true;
+        }
+
+        private async Task work(Lane lane)
+        {
+            while (true)
+            {
+                await lane.signal.WaitAsync();
+                if (!lane.pending.TryDequeue(out var job)) continue;
+
+                try
+                {
+                    await job();
+                }
+                catch (Exception ex)
+                {
+                    Console.WriteLine(ex);
+                }
+                finally
+                {
+                    Interlocked.Decrement(ref count);
+                }
+            }
+        }
+    }
+}
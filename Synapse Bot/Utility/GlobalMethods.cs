@@ -1,5 +1,7 @@
 ﻿using System;
+using System.Threading.Tasks;
 using Discord;
+using Discord.Commands;
 using Synapse_Bot.Utility;
 
 namespace Synapse_Bot.Utility_Methods
@@ -14,37 +16,18 @@ namespace Synapse_Bot.Utility_Methods
 
     public class GlobalMethods
     {
-        public static IGuild Guild = new Init().client.GetGuild(0);
-
-        public static IRole ClientRole = Guild.GetRole(0);
-        public static IRole ModeratorRole = Guild.GetRole(0);
-        public static IRole AdministratorRole = Guild.GetRole(0);
-        public static IRole DeveloperRole = Guild.GetRole(0);
+        // groups are ranked, so any group at or above authLevel passes. resolved from the cache, not a REST lookup per call //
 
         public static bool authenticateCaller(UserGroup authLevel, IUser messageAuthor)
         {
-            foreach (ulong RoleID in Guild.GetUserAsync(messageAuthor.Id).Result.RoleIds)
-            {
-                if (authLevel == new User()) return true;
-                if (authLevel == new Client())
-                {
-                    if (RoleID == ClientRole.Id || RoleID == ModeratorRole.Id || RoleID == AdministratorRole.Id || RoleID == DeveloperRole.Id) return true;
-                }
-                if (authLevel == new Moderator())
-                {
-                    if (RoleID == ModeratorRole.Id || RoleID == AdministratorRole.Id || RoleID == DeveloperRole.Id) return true;
-                }
-                if (authLevel == new Administrator())
-                {
-                    if (RoleID == AdministratorRole.Id || RoleID == DeveloperRole.Id) return true;
-                }
-                if (authLevel == new Developer())
-                {
-                    if (RoleID == DeveloperRole.Id) return true;
-                }
-            }
+            return GroupCache.rankOf(messageAuthor) >= authLevel.RankStructure;
+        }
 
-            return false;
+        // replies go through Outbound so bursts are paced and merged instead of hitting the channel's rate limit //
+
+        public static Task reply(ICommandContext context, EmbedBuilder embedBuilder)
+        {
+            return Outbound.send(context.Channel, embedBuilder);
         }
 
         public static EmbedBuilder buildEmbed(UserGroup userGroup, string commandTitle)
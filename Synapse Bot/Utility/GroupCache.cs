@@ -0,0 +1,76 @@
+﻿using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading.Tasks;
+using Discord;
+using Discord.WebSocket;
+using Synapse_Bot.Utility;
+
+namespace Synapse_Bot.Utility_Methods
+{
+    /*
+    *
+    *	SYNAPSE BOT
+    *	File.:	UTIL/GroupCache.cs
+    *	Desc.:	Cached role -> user group resolution, dropped on role-change events.
+    *
+    */
+
+    public class GroupCache
+    {
+        // role id -> rank, groups whose role isn't set yet (0) are left out //
+
+        private static readonly Dictionary<ulong, int> roleRanks = new[]
+        {
+            (Client.RoleID, Client.RankStructure),
+            (Moderator.RoleID, Moderator.RankStructure),
+            (Administrator.RoleID, Administrator.RankStructure),
+            (Developer.RoleID, Developer.RankStructure)
+        }.Where(group => group.Item1 != 0).ToDictionary(group => group.Item1, group => group.Item2);
+
+        private static readonly ConcurrentDictionary<(ulong, ulong), int> ranks = new ConcurrentDictionary<(ulong, ulong), int>();
+
+
+        // hooked up once by Init, anything that can change what a member's roles mean throws the cached rank away //
+
+        public static void attach(DiscordSocketClient client)
+        {
+            client.GuildMemberUpdated += (before, after) =>
+            {
+                if (!before.Roles.Select(role => role.Id).SequenceEqual(after.Roles.Select(role => role.Id)))
+                    ranks.TryRemove((after.Guild.Id, after.Id), out _);
+                return Task.CompletedTask;
+            };
+            client.UserLeft += user =>
+            {
+                ranks.TryRemove((user.Guild.Id, user.Id), out _);
+                return Task.CompletedTask;
+            };
+            client.RoleUpdated += (before, after) => clear();
+            client.RoleDeleted += role => clear();
+        }
+
+        // highest group rank the user's roles give them, from the roles the gateway already sent with the message //
+
+        public static int rankOf(IUser user)
+        {
+            if (!(user is IGuildUser member)) return User.RankStructure;
+
+            return ranks.GetOrAdd((member.GuildId, member.Id), _ =>
+            {
+                var rank = User.RankStructure;
+                foreach (var roleId in member.RoleIds)
+                {
+                    if (roleRanks.TryGetValue(roleId, out var roleRank) && roleRank > rank) rank = roleRank;
+                }
+                return rank;
+            });
+        }
+
+        private static Task clear()
+        {
+            ranks.Clear();
+            return Task.CompletedTask;
+        }
+    }
+}
@@ -0,0 +1,115 @@
+﻿using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading.Tasks;
+using Discord;
+
+namespace Synapse_Bot.Utility_Methods
+{
+    /*
+    *
+    *	SYNAPSE BOT
+    *	File.:	UTIL/Outbound.cs
+    *	Desc.:	Replies paced under Discord's per-channel limit, coalescing the ones that pile up.
+    *
+    */
+
+    public class Outbound
+    {
+        // discord lets a channel take 5 messages every 5 seconds, staying under it locally saves collecting 429s //
+
+        private const int windowSends = 5;
+        private static readonly TimeSpan window = TimeSpan.FromSeconds(5);
+        private const int maxDescription = 2048;
+
+        private class Pending
+        {
+            public EmbedBuilder embed;
+            public readonly TaskCompletionSource<bool> done = new TaskCompletionSource<bool>();
+        }
+
+        private class Lane
+        {
+            public readonly Queue<Pending> queue = new Queue<Pending>();
+            public readonly Queue<DateTime> sent = new Queue<DateTime>();
+            public bool draining;
+        }
+
+        private static readonly ConcurrentDictionary<ulong, Lane> lanes = new ConcurrentDictionary<ulong, Lane>();
+
+
+        // completes once the embed (possibly merged with others) is sent //
+
+        public static Task send(IMessageChannel channel, EmbedBuilder embed)
+        {
+            var lane = lanes.GetOrAdd(channel.Id, _ => new Lane());
+            var item = new Pending { embed = embed };
+
+            bool start;
+            lock (lane)
+            {
+                lane.queue.Enqueue(item);
+                start = !lane.draining;
+                lane.draining = true;
+            }
+
+            if (start) Task.Run(() => drain(channel, lane));
+            return item.done.Task;
+        }
+
+        private static async Task drain(IMessageChannel channel, Lane lane)
+        {
+            while (true)
+            {
+                var wait = TimeSpan.Zero;
+                lock (lane)
+                {
+                    while (lane.sent.Count > 0 && DateTime.UtcNow - lane.sent.Peek() >= window) lane.sent.Dequeue();
+                    if (lane.sent.Count >= windowSends) wait = window - (DateTime.UtcNow - lane.sent.Peek());
+                }
+
+                if (wait > TimeSpan.Zero) await Task.Delay(wait);
+
+                var batch = new List<Pending>();
+                lock (lane)
+                {
+                    if (lane.queue.Count == 0)
+                    {
+                        lane.draining = false;
+                        return;
+                    }
+
+                    // whatever queued up behind the limit under the same title goes out as one message //
+                    batch.Add(lane.queue.Dequeue());
+                    var length = batch[0].embed.Description?.Length ?? 0;
+                    while (lane.queue.Count > 0 && lane.queue.Peek().embed.Title == batch[0].embed.Title &&
+                           length + 1 + (lane.queue.Peek().embed.Description?.Length ?? 0) <= maxDescription)
+                    {
+                        length += 1 + (lane.queue.Peek().embed.Description?.Length ?? 0);
+                        batch.Add(lane.queue.Dequeue());
+                    }
+
+                    lane.sent.Enqueue(DateTime.UtcNow);
+                }
+
+                var embed = batch[0].embed;
+                if (batch.Count > 1)
+                {
+                    embed = new EmbedBuilder { Title = embed.Title, Color = embed.Color };
+                    embed.WithDescription(string.Join("\n", batch.Select(pending => pending.embed.Description)));
+                }
+
+                try
+                {
+                    await channel.SendMessageAsync(null, false, embed);
+                    foreach (var pending in batch) pending.done.TrySetResult(true);
+                }
+                catch (Exception ex)
+                {
+                    foreach (var pending in batch) pending.done.TrySetException(ex);
+                }
+            }
+        }
+    }
+}
@@ -10,6 +10,9 @@ namespace Synapse_Bot.Utility
     *
     */
 
+    // each group hides these with its own statics and copies them back in its constructor, so a UserGroup
+    // reference (what authenticateCaller and buildEmbed take) sees the group's values //
+
     public class UserGroup
     {
         public string Identifier { get; set; }
@@ -24,6 +27,14 @@ namespace Synapse_Bot.Utility
         public new static readonly ulong RoleID = 0;
         public new static readonly int RankStructure = 0;
         public new static readonly Discord.Color Color = Color.Default;
+
+        public User()
+        {
+            base.Identifier = Identifier;
+            base.RoleID = RoleID;
+            base.RankStructure = RankStructure;
+            base.Color = Color;
+        }
     }
 
     public class Client : UserGroup
@@ -32,6 +43,14 @@ namespace Synapse_Bot.Utility
         public new static readonly ulong RoleID = 0;
         public new static readonly int RankStructure = 1;
         public new static readonly Discord.Color Color = Color.Default;
+
+        public Client()
+        {
+            base.Identifier = Identifier;
+            base.RoleID = RoleID;
+            base.RankStructure = RankStructure;
+            base.Color = Color;
+        }
     }
 
     public class Moderator : UserGroup
@@ -40,6 +59,14 @@ namespace Synapse_Bot.Utility
         public new static readonly ulong RoleID = 0;
         public new static readonly int RankStructure = 2;
         public new static readonly Discord.Color Color = Color.Default;
+
+        public Moderator()
+        {
+            base.Identifier = Identifier;
+            base.RoleID = RoleID;
+            base.RankStructure = RankStructure;
+            base.Color = Color;
+        }
     }
 
     public class Administrator : UserGroup
@@ -48,6 +75,14 @@ namespace Synapse_Bot.Utility
         public new static readonly ulong RoleID = 0;
         public new static readonly int RankStructure = 3;
         public new static readonly Discord.Color Color = Color.Default;
+
+        public Administrator()
+        {
+            base.Identifier = Identifier;
+            base.RoleID = RoleID;
+            base.RankStructure = RankStructure;
+            base.Color = Color;
+        }
     }
 
     public class Developer : UserGroup
@@ -56,5 +91,13 @@ namespace Synapse_Bot.Utility
         public new static readonly ulong RoleID = 0;
         public new static readonly int RankStructure = 4;
         public new static readonly Discord.Color Color = Color.Default;
+
+        public Developer()
+        {
+            base.Identifier = Identifier;
+            base.RoleID = RoleID;
+            base.RankStructure = RankStructure;
+            base.Color = Color;
+        }
     }
 }
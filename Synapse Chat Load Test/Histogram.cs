@@ -0,0 +1,58 @@
+﻿using System;
+using System.Diagnostics;
+using System.Threading;
+
+namespace Synapse_Chat_Load_Test
+{
+    /* Fixed 100us buckets up to 10 seconds, anything slower lands in the last one. Recording is a single interlocked
+       increment so every receive thread can share one */
+    public class Histogram
+    {
+        private const int BucketMicros = 100;
+        private const int BucketCount = 100000;
+
+        private readonly long[] Buckets = new long[BucketCount];
+        private long Total;
+        private long Max;
+
+        public long Count => Interlocked.Read(ref Total);
+
+        public void Record(long ElapsedTicks)
+        {
+            var Micros = ElapsedTicks * 1000000 / Stopwatch.Frequency;
+            var Index = (int) Math.Min(Micros / BucketMicros, BucketCount - 1);
+
+            Interlocked.Increment(ref Buckets[Index]);
+            Interlocked.Increment(ref Total);
+
+            long Seen;
+            while (Micros > (Seen = Interlocked.Read(ref Max)))
+                if (Interlocked.CompareExchange(ref Max, Micros, Seen) == Seen) break;
+        }
+
+        /* In milliseconds, the upper edge of the bucket the percentile falls in */
+        public double Percentile(double Percent)
+        {
+            var Target = (long) Math.Ceiling(Count * Percent / 100);
+            if (Target == 0) return 0;
+
+            long Seen = 0;
+            for (var I = 0; I < BucketCount; I++)
+            {
+                Seen += Interlocked.Read(ref Buckets[I]);
+                if (Seen >= Target) return (I + 1) * BucketMicros / 1000.0;
+            }
+
+            return MaxMs;
+        }
+
+        public double MaxMs => Interlocked.Read(ref Max) / 1000.0;
+
+        public void Reset()
+        {
+            for (var I = 0; I < BucketCount; I++) Interlocked.Exchange(ref Buckets[I], 0);
+            Interlocked.Exchange(ref Total, 0);
+            Interlocked.Exchange(ref Max, 0);
+        }
+    }
+}
@@ -0,0 +1,166 @@
+﻿using System;
+using System.Diagnostics;
+using System.Threading;
+using Newtonsoft.Json;
+using Newtonsoft.Json.Linq;
+using WebSocketSharp;
+
+namespace Synapse_Chat_Load_Test
+{
+    /* One simulated chat user. Probe messages carry the Stopwatch timestamp they were sent at, every client lives in this
+       process so whoever receives one can work out the end-to-end latency */
+    public class LoadClient : IDisposable
+    {
+        /* Same order as Chat.OpCodes on the server */
+        public enum OpCodes
+        {
+            MESSAGE,
+            SYSTEM_MESSAGE,
+            INVITE,
+            PARTY_INVITE,
+            PARTY_TELEPORT,
+            CHANNEL_CREATED,
+            CHANNEL_REMOVED,
+            AUTH_SUCCESS,
+            AUTH_FAILURE,
+            MUTED,
+            KICKED,
+            BANNED,
+            PROTOCOL_FAILURE,
+            HISTORY
+        }
+
+        public const string ProbePrefix = "lt ";
+
+        public readonly string Hwid;
+        public readonly ulong PlaceId;
+        public readonly Guid GameId;
+
+        public string Username;
+        public string PartyId;
+
+        public readonly ManualResetEventSlim Authenticated = new ManualResetEventSlim();
+        public readonly ManualResetEventSlim JoinedParty = new ManualResetEventSlim();
+        public volatile bool Closed;
+
+        private readonly WebSocket Socket;
+        private readonly Stats Stats;
+        private readonly object SendLock = new object();
+
+        private static readonly Random Rng = new Random();
+        private const string Alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+
+        public LoadClient(string Url, string Secret, ulong Place, Guid Game, bool Insecure, Stats Stats)
+        {
+            /* Random rather than numbered, the spam filter collapses repeats so LT...0011 and LT...0001 would look alike */
+            var Chars = new char[28];
+            lock (Rng) for (var I = 0; I < Chars.Length; I++) Chars[I] = Alphabet[Rng.Next(Alphabet.Length)];
+            Hwid = "LT" + new string(Chars);
+
+            PlaceId = Place;
+            GameId = Game;
+            this.Stats = Stats;
+
+            Socket = new WebSocket($"{Url}?hwid={Hwid}&pid={PlaceId}&gid={GameId}&loadtest={Uri.EscapeDataString(Secret)}");
+            Socket.Log.Output = (Data, File) => { };
+            if (Insecure) Socket.SslConfiguration.ServerCertificateValidationCallback = (Sender, Cert, Chain, Errors) => true;
+
+            Socket.OnMessage += OnMessage;
+            Socket.OnClose += (Sender, Args) =>
+            {
+                if (Closed) return;
+                Closed = true;
+                Interlocked.Increment(ref Stats.Disconnects);
+            };
+        }
+
+        public void Connect()
+        {
+            Socket.Connect();
+        }
+
+        public void Send(string Channel, string Message)
+        {
+            if (Closed) return;
+
+            var Data = JsonConvert.SerializeObject(new JObject { ["Channel"] = Channel, ["Message"] = Message });
+            try
+            {
+                /* websocket-sharp clients don't like concurrent sends */
+                lock (SendLock) Socket.Send(Data);
+            }
+            catch (Exception)
+            {
+                Closed = true;
+            }
+        }
+
+        public void SendProbe(string Channel, string Command)
+        {
+            Send(Channel, $"{Command}{ProbePrefix}{Stopwatch.GetTimestamp()}");
+            Interlocked.Increment(ref Stats.Sent);
+        }
+
+        private void OnMessage(object Sender, MessageEventArgs Args)
+        {
+            if (!Args.IsText) return;
+
+            var Received = Stopwatch.GetTimestamp();
+            var Packet = JObject.Parse(Args.Data);
+            var Data = Packet["Data"];
+
+            switch ((OpCodes) Packet.Value<int>("OpCode"))
+            {
+                case OpCodes.MESSAGE:
+                {
+                    var Text = Data.Value<string>("Message");
+                    var Start = Text.IndexOf(ProbePrefix, StringComparison.Ordinal);
+                    if (Start == -1 || !long.TryParse(Text.Substring(Start + ProbePrefix.Length), out var Sent)) return;
+
+                    Stats.Latency.Record(Received - Sent);
+                    Stats.Interval.Record(Received - Sent);
+                    Interlocked.Increment(ref Stats.Delivered);
+                    break;
+                }
+                case OpCodes.SYSTEM_MESSAGE:
+                {
+                    if (Data.Value<string>("Message").Contains("spam")) Interlocked.Increment(ref Stats.Filtered);
+                    break;
+                }
+                case OpCodes.AUTH_SUCCESS:
+                {
+                    Username = Data.Value<string>("Username");
+                    Authenticated.Set();
+                    break;
+                }
+                case OpCodes.PARTY_INVITE:
+                {
+                    Send("General", $"/party join {Data.Value<string>("Code")}");
+                    break;
+                }
+                case OpCodes.CHANNEL_CREATED:
+                {
+                    if (!Data.Value<bool>("IsParty")) return;
+
+                    PartyId = Data.Value<string>("PartyId");
+                    JoinedParty.Set();
+                    break;
+                }
+                case OpCodes.AUTH_FAILURE:
+                case OpCodes.PROTOCOL_FAILURE:
+                case OpCodes.BANNED:
+                case OpCodes.KICKED:
+                {
+                    Console.WriteLine($"{Hwid}: {Packet.Value<int>("OpCode")} {Data}");
+                    break;
+                }
+            }
+        }
+
+        public void Dispose()
+        {
+            Closed = true;
+            ((IDisposable) Socket).Dispose();
+        }
+    }
+}
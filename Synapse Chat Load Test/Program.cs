@@ -0,0 +1,219 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Synapse_Chat_Load_Test
+{
+    public class Program
+    {
+        public enum Mode
+        {
+            Game,
+            Server,
+            General,
+            Party
+        }
+
+        private const string Usage =
+            "Synapse Chat Load Test.exe [options]\n" +
+            "  --url <wss://host:13422/chat>  server to test, on this machine (127.0.0.1 by default)\n" +
+            "  --secret <s>                   the server's SYNAPSE_CHAT_LOADTEST value, required\n" +
+            "  --clients <n>                  sessions to open (100)\n" +
+            "  --places <n>                   distinct PlaceIds (10)\n" +
+            "  --games <n>                    distinct GameIds, spread over the places (20)\n" +
+            "  --party-size <n>               sessions per party in party mode (10)\n" +
+            "  --mode <game|server|general|party>\n" +
+            "                                 Per-Game, Per-Server, General or /party msg fan-out (game)\n" +
+            "  --rate <n>                     messages per second per client (0.5)\n" +
+            "  --duration <s>                 seconds to send for (60)\n" +
+            "  --server-pid <pid>             sample the CPU of a server on this machine\n" +
+            "  --insecure                     accept any certificate\n" +
+            "The server spam filter allows a burst of 3 then 1 message a second per user, faster rates show up as filtered.";
+
+        public static int Main(string[] args)
+        {
+            var Url = "wss://127.0.0.1:13422/chat";
+            var Clients = 100;
+            var Places = 10;
+            var Games = 20;
+            var PartySize = 10;
+            var RunMode = Mode.Game;
+            var Rate = 0.5;
+            var Duration = 60;
+            var ServerPid = 0;
+            var Insecure = false;
+            string Secret = null;
+
+            try
+            {
+                for (var I = 0; I < args.Length; I++)
+                {
+                    switch (args[I])
+                    {
+                        case "--url": Url = args[++I]; break;
+                        case "--clients": Clients = int.Parse(args[++I]); break;
+                        case "--places": Places = int.Parse(args[++I]); break;
+                        case "--games": Games = int.Parse(args[++I]); break;
+                        case "--party-size": PartySize = int.Parse(args[++I]); break;
+                        case "--mode": RunMode = (Mode) Enum.Parse(typeof(Mode), args[++I], true); break;
+                        case "--rate": Rate = double.Parse(args[++I]); break;
+                        case "--duration": Duration = int.Parse(args[++I]); break;
+                        case "--server-pid": ServerPid = int.Parse(args[++I]); break;
+                        case "--insecure": Insecure = true; break;
+                        case "--secret": Secret = args[++I]; break;
+                        default: throw new ArgumentException(args[I]);
+                    }
+                }
+            }
+            catch (Exception)
+            {
+                Console.WriteLine(Usage);
+                return 1;
+            }
+
+            if (Secret == null)
+            {
+                Console.WriteLine(Usage);
+                return 1;
+            }
+
+            var Stats = new Stats();
+
+            /* Each game (server instance) belongs to one place, like on Roblox */
+            var GameIds = Enumerable.Range(0, Games).Select(G => new Guid(G, 0, 0, new byte[8])).ToArray();
+            var Sessions = Enumerable.Range(0, Clients)
+                .Select(I => new LoadClient(Url, Secret, 1000 + (ulong) (I % Games % Places), GameIds[I % Games], Insecure, Stats))
+                .ToList();
+
+            Console.WriteLine($"Connecting {Clients} clients...");
+            var Setup = Stopwatch.StartNew();
+            Parallel.ForEach(Sessions, new ParallelOptions { MaxDegreeOfParallelism = 32 }, Session =>
+            {
+                try
+                {
+                    Session.Connect();
+                }
+                catch (Exception Ex)
+                {
+                    Console.WriteLine($"{Session.Hwid}: {Ex.Message}");
+                }
+            });
+
+            Sessions = Sessions.Where(Session => Session.Authenticated.Wait(TimeSpan.FromSeconds(30))).ToList();
+            Console.WriteLine($"{Sessions.Count} authenticated in {Setup.Elapsed.TotalSeconds:F1}s.");
+            if (Sessions.Count == 0) return 1;
+
+            if (RunMode == Mode.Party)
+            {
+                Sessions = FormParties(Sessions, PartySize);
+                Console.WriteLine($"{Sessions.Count} in parties of up to {PartySize}.");
+            }
+
+            string Channel;
+            switch (RunMode)
+            {
+                case Mode.Game: Channel = "Per-Game"; break;
+                case Mode.Server: Channel = "Per-Server"; break;
+                default: Channel = "General"; break;
+            }
+
+            Process Server = null;
+            if (ServerPid != 0) Server = Process.GetProcessById(ServerPid);
+
+            /* Start times are spread over one period so the clients don't all fire together */
+            var Period = (int) Math.Max(1, 1000 / Rate);
+            var Rng = new Random();
+            var Timers = Sessions.Select(Session => new Timer(_ =>
+            {
+                Session.SendProbe(Channel, RunMode == Mode.Party ? $"/party msg {Session.PartyId} " : "");
+            }, null, Rng.Next(Period), Period)).ToList();
+
+            var Run = Stopwatch.StartNew();
+            var CpuStart = Server?.TotalProcessorTime ?? TimeSpan.Zero;
+            var LastCpu = CpuStart;
+            var LastTime = TimeSpan.Zero;
+            long LastSent = 0, LastDelivered = 0;
+
+            while (Run.Elapsed.TotalSeconds < Duration)
+            {
+                Thread.Sleep(1000);
+
+                var Now = Run.Elapsed;
+                var Seconds = (Now - LastTime).TotalSeconds;
+                var Sent = Interlocked.Read(ref Stats.Sent);
+                var Delivered = Interlocked.Read(ref Stats.Delivered);
+
+                var Cpu = "";
+                if (Server != null)
+                {
+                    Server.Refresh();
+                    var Used = Server.TotalProcessorTime;
+                    Cpu = $" cpu {CpuPercent(Used - LastCpu, Now - LastTime):F0}%";
+                    LastCpu = Used;
+                }
+
+                Console.WriteLine(
+                    $"{Now.TotalSeconds,4:F0}s sent {(Sent - LastSent) / Seconds,8:F0}/s delivered {(Delivered - LastDelivered) / Seconds,9:F0}/s " +
+                    $"p50 {Stats.Interval.Percentile(50),7:F1}ms p99 {Stats.Interval.Percentile(99),7:F1}ms{Cpu}");
+
+                Stats.Interval.Reset();
+                LastTime = Now;
+                LastSent = Sent;
+                LastDelivered = Delivered;
+            }
+
+            foreach (var Timer in Timers) Timer.Dispose();
+
+            /* Let in-flight messages land before reporting */
+            Thread.Sleep(2000);
+            var Elapsed = Run.Elapsed;
+
+            Console.WriteLine();
+            Console.WriteLine($"Mode {RunMode}, {Sessions.Count} clients, {Rate} msg/s each, {Duration}s");
+            Console.WriteLine($"Sent      {Stats.Sent} ({Stats.Sent / Elapsed.TotalSeconds:F0}/s)");
+            Console.WriteLine($"Delivered {Stats.Delivered} ({Stats.Delivered / Elapsed.TotalSeconds:F0}/s, {(double) Stats.Delivered / Math.Max(1, Stats.Sent):F1}x fan-out)");
+            Console.WriteLine($"Filtered  {Stats.Filtered}, disconnects {Stats.Disconnects}");
+            Console.WriteLine(
+                $"Latency   p50 {Stats.Latency.Percentile(50):F1}ms p90 {Stats.Latency.Percentile(90):F1}ms " +
+                $"p99 {Stats.Latency.Percentile(99):F1}ms p99.9 {Stats.Latency.Percentile(99.9):F1}ms max {Stats.Latency.MaxMs:F1}ms");
+            if (Server != null)
+            {
+                Server.Refresh();
+                Console.WriteLine($"Server    cpu {CpuPercent(Server.TotalProcessorTime - CpuStart, Elapsed):F0}% of {Environment.ProcessorCount} cores");
+            }
+
+            foreach (var Session in Sessions) Session.Dispose();
+            return 0;
+        }
+
+        private static double CpuPercent(TimeSpan Used, TimeSpan Wall)
+        {
+            return Used.TotalMilliseconds / (Wall.TotalMilliseconds * Environment.ProcessorCount) * 100;
+        }
+
+        /* Splits the sessions into parties, the first of each creates it and invites the rest. Invites are paced to stay
+           under the spam filter, the parties are set up in parallel. Returns the sessions that made it into one */
+        private static List<LoadClient> FormParties(List<LoadClient> Sessions, int Size)
+        {
+            var Groups = Sessions.Select((Session, I) => new { Session, I }).GroupBy(E => E.I / Size, E => E.Session).ToList();
+
+            Parallel.ForEach(Groups, new ParallelOptions { MaxDegreeOfParallelism = 64 }, Group =>
+            {
+                var Owner = Group.First();
+                Owner.Send("General", "/party create");
+                if (!Owner.JoinedParty.Wait(TimeSpan.FromSeconds(10))) return;
+
+                foreach (var Member in Group.Skip(1))
+                {
+                    Thread.Sleep(1100);
+                    Owner.Send("General", $"/party invite {Member.Username}");
+                }
+            });
+
+            return Sessions.Where(Session => Session.JoinedParty.Wait(TimeSpan.FromSeconds(5))).ToList();
+        }
+    }
+}
@@ -0,0 +1,15 @@
+﻿namespace Synapse_Chat_Load_Test
+{
+    public class Stats
+    {
+        public long Sent;
+        public long Delivered;
+        public long Filtered;
+        public long Disconnects;
+
+        public readonly Histogram Latency = new Histogram();
+
+        /* Reset after every progress line */
+        public readonly Histogram Interval = new Histogram();
+    }
+}
@@ -1,18 +1,19 @@
 ﻿using System;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.Linq;
 using System.Security.Cryptography.X509Certificates;
 using System.Text;
 using System.Threading;
 using System.Threading.Tasks;
 using Synapse_Chat_Server.Server;
-using WebSocketSharp;
-using WebSocketSharp.Server;
 
 namespace Synapse_Chat_Server
 {
     public class Bootstrap
     {
+        /* Synapse Chat Server.exe [port] [redis configuration]. Nodes sharing a Redis backplane can sit behind one load
+           balancer, each should start from a copy of the same db.json */
         public static void Main(string[] args)
         {
             Console.Title = "Synapse Chat Server";
@@ -20,17 +21,68 @@ namespace Synapse_Chat_Server
 
             Database.LoadDb();
 
-            var WS = new WebSocketServer(13422, true);
+            var Port = args.Length > 0 ? int.Parse(args[0]) : 13422;
+            var LoadTestSecret = Environment.GetEnvironmentVariable("SYNAPSE_CHAT_LOADTEST");
+            if (!string.IsNullOrEmpty(LoadTestSecret))
+            {
+                if (LoadTestSecret.Length < 16)
+                {
+                    Console.WriteLine("SYNAPSE_CHAT_LOADTEST must be a secret of at least 16 characters.");
+                    return;
+                }
+
+                Chat.LoadTestSecret = LoadTestSecret;
+                Console.WriteLine("Load test mode, loopback sessions with the secret skip the whitelist!");
+            }
+            if (args.Length > 1)
+            {
+                Backplane.Connect(args[1]);
+                Console.WriteLine("Connected to backplane.");
+            }
+
             var Store = new X509Store("WebHosting", StoreLocation.LocalMachine);
             Store.Open(OpenFlags.ReadOnly);
-            WS.SslConfiguration.ServerCertificate = Store.Certificates[0];
-            WS.Log.Level = LogLevel.Info;
-            WS.AddWebSocketService<Chat>("/chat");
-            WS.Start();
+            BindCertificate(Port, Store.Certificates[0]);
+
+            Log.Level = LogLevel.Info;
+            Chat.Host = new ChatHost(Port, true, "/chat");
+            Chat.Host.Start();
 
             Console.WriteLine("Ready!");
 
             while (true) { Thread.Sleep(int.MaxValue);}
         }
+
+        /* TLS is terminated by http.sys, which takes its certificate from the port binding rather than from us. Rebound on
+           every start so a renewed certificate in WebHosting is picked up, needs the server to run elevated */
+        private static void BindCertificate(int Port, X509Certificate2 Certificate)
+        {
+            int Netsh(string Arguments, out string Output)
+            {
+                var Info = new ProcessStartInfo("netsh", Arguments)
+                {
+                    UseShellExecute = false,
+                    CreateNoWindow = true,
+                    RedirectStandardOutput = true
+                };
+
+                using (var Process = System.Diagnostics.Process.Start(Info))
+                {
+                    Output = Process.StandardOutput.ReadToEnd().Trim();
+                    Process.WaitForExit();
+                    return Process.ExitCode;
+                }
+            }
+
+            /* Failing here is normal, there is no binding on a first start */
+            Netsh($"http delete sslcert ipport=0.0.0.0:{Port}", out _);
+
+            /* Without the binding http.sys fails every handshake, so don't come up looking healthy */
+            if (Netsh($"http add sslcert ipport=0.0.0.0:{Port} certhash={Certificate.Thumbprint} appid={{9300de27-3ff6-4015-9f00-be6f5e2258ae}}", out var Error) != 0)
+            {
+                Console.WriteLine($"Failed to bind the certificate to port {Port}, is the server running elevated? netsh: {Error}");
+                Environment.Exit(1);
+            }
+        }
     }
 }
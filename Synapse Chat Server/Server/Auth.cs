@@ -0,0 +1,86 @@
+﻿using System;
+using System.Collections.Concurrent;
+using System.Net.Http;
+using System.Threading.Tasks;
+
+namespace Synapse_Chat_Server.Server
+{
+    /* HWID -> username through the whitelist API. One shared client for every lookup, answers are cached for CacheTtl
+       and concurrent lookups for the same HWID share a single request, so a reconnect storm costs one call per user */
+    public static class Auth
+    {
+        public class Result
+        {
+            /* False when the API couldn't be reached or answered with an error, those are never cached */
+            public bool Reached;
+
+            /* Null when the HWID isn't whitelisted */
+            public string Username;
+        }
+
+        private class CacheEntry
+        {
+            public Result Value;
+            public DateTime Expires;
+        }
+
+        public static TimeSpan CacheTtl = TimeSpan.FromSeconds(60);
+
+        /* Expired entries are swept out once the cache reaches this many */
+        private const int SweepThreshold = 65536;
+
+        private static readonly HttpClient Client = new HttpClient
+        {
+            BaseAddress = new Uri("https://synapse.to/"),
+            Timeout = TimeSpan.FromSeconds(15)
+        };
+
+        private static readonly ConcurrentDictionary<string, CacheEntry> Cache = new ConcurrentDictionary<string, CacheEntry>();
+        private static readonly ConcurrentDictionary<string, Lazy<Task<Result>>> InFlight = new ConcurrentDictionary<string, Lazy<Task<Result>>>();
+
+        public static Task<Result> GetUsername(string HWID)
+        {
+            if (Cache.TryGetValue(HWID, out var Cached) && Cached.Expires > DateTime.UtcNow) return Task.FromResult(Cached.Value);
+
+            var Lookup = InFlight.GetOrAdd(HWID, Key => new Lazy<Task<Result>>(() => Fetch(Key)));
+            return Lookup.Value;
+        }
+
+        private static async Task<Result> Fetch(string HWID)
+        {
+            Result Value;
+            try
+            {
+                using (var Response = await Client.GetAsync("whitelist/getusernamefromhwid?a=" + Uri.EscapeDataString(HWID)).ConfigureAwait(false))
+                {
+                    if (!Response.IsSuccessStatusCode) Value = new Result { Reached = false };
+                    else
+                    {
+                        var Split = (await Response.Content.ReadAsStringAsync().ConfigureAwait(false)).Split('|');
+                        Value = new Result { Reached = true, Username = Split.Length == 2 && Split[0] == "YES" ? Split[1] : null };
+                    }
+                }
+            }
+            catch (Exception)
+            {
+                Value = new Result { Reached = false };
+            }
+
+            /* Cached before leaving InFlight, so a lookup in between never starts a second request */
+            if (Value.Reached)
+            {
+                var Now = DateTime.UtcNow;
+                if (Cache.Count >= SweepThreshold)
+                {
+                    foreach (var Entry in Cache)
+                        if (Entry.Value.Expires <= Now) Cache.TryRemove(Entry.Key, out _);
+                }
+
+                Cache[HWID] = new CacheEntry { Value = Value, Expires = Now + CacheTtl };
+            }
+
+            InFlight.TryRemove(HWID, out _);
+            return Value;
+        }
+    }
+}
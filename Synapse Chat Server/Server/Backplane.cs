@@ -0,0 +1,114 @@
+﻿using System;
+using Newtonsoft.Json;
+using StackExchange.Redis;
+
+namespace Synapse_Chat_Server.Server
+{
+    public enum Route
+    {
+        All,
+        Place,
+        Game,
+        Party,
+        User
+    }
+
+    /* Redis pub/sub between chat nodes behind a load balancer. Sends are delivered to this node's sessions directly and
+       published for the rest, database changes and the party registry are replicated the same way. Without a Redis
+       connection string the server is a single node and every publish is a no-op. Synapse Bot publishes its moderation
+       changes and the notices for them on the same channels (see its ChatStore), so keep the formats in step */
+    public static class Backplane
+    {
+        private class Delivery
+        {
+            public string Node;
+            public Route Route;
+            public string Key;
+            public string Json;
+            public Chat.UserMessage Message;
+            public bool Close;
+        }
+
+        private class Replication
+        {
+            public string Node;
+            public string Key;
+            public string Value;
+        }
+
+        private const string DeliveryChannel = "synapse-chat:deliver";
+        private const string ChangeChannel = "synapse-chat:db";
+        private const string PartyChannel = "synapse-chat:party";
+
+        /* Every node hears its own publishes back, this tells them apart */
+        private static readonly string Node = Guid.NewGuid().ToString("N");
+
+        private static ConnectionMultiplexer Connection;
+        private static ISubscriber Subscriber;
+
+        public static bool Enabled => Subscriber != null;
+
+        public static void Connect(string Configuration)
+        {
+            Connection = ConnectionMultiplexer.Connect(Configuration);
+            Subscriber = Connection.GetSubscriber();
+
+            Subscriber.Subscribe(DeliveryChannel, (Channel, Value) =>
+            {
+                var Entry = JsonConvert.DeserializeObject<Delivery>(Value);
+                if (Entry.Node == Node) return;
+
+                Chat.DeliverLocal(Entry.Route, Entry.Key, Entry.Json, Entry.Message, Entry.Close);
+            });
+
+            Subscriber.Subscribe(ChangeChannel, (Channel, Value) =>
+            {
+                var Entry = JsonConvert.DeserializeObject<Replication>(Value);
+                if (Entry.Node == Node) return;
+
+                Database.ApplyRemote(Entry.Value);
+            });
+
+            Subscriber.Subscribe(PartyChannel, (Channel, Value) =>
+            {
+                var Entry = JsonConvert.DeserializeObject<Replication>(Value);
+                if (Entry.Node == Node) return;
+
+                Chat.ApplyParty(Entry.Key, Entry.Value);
+            });
+        }
+
+        /* Other nodes only, callers deliver locally themselves (see Chat.Deliver) */
+        public static void Publish(Route Route, string Key, string Json, Chat.UserMessage Message = null, bool Close = false)
+        {
+            if (!Enabled) return;
+
+            Subscriber.Publish(DeliveryChannel, JsonConvert.SerializeObject(new Delivery
+            {
+                Node = Node,
+                Route = Route,
+                Key = Key,
+                Json = Json,
+                Message = Message,
+                Close = Close
+            }), CommandFlags.FireAndForget);
+        }
+
+        public static void PublishChange(string Change)
+        {
+            if (!Enabled) return;
+
+            Subscriber.Publish(ChangeChannel, JsonConvert.SerializeObject(new Replication { Node = Node, Value = Change }),
+                CommandFlags.FireAndForget);
+        }
+
+        /* Name null is a removal */
+        public static void PublishParty(string PartyId, string Name)
+        {
+            if (!Enabled) return;
+
+            Subscriber.Publish(PartyChannel, JsonConvert.SerializeObject(new Replication { Node = Node, Key = PartyId, Value = Name }),
+                CommandFlags.FireAndForget);
+        }
+    }
+}
@@ -1,28 +1,106 @@
 ﻿using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.Drawing;
 using System.Linq;
+using System.Net;
+using System.Net.WebSockets;
+using System.Text;
 using System.Text.RegularExpressions;
+using System.Threading.Tasks;
 using Newtonsoft.Json;
-using RestSharp;
-using WebSocketSharp;
-using WebSocketSharp.Net.WebSockets;
-using WebSocketSharp.Server;
 
 namespace Synapse_Chat_Server.Server
 {
-    public class Chat : WebSocketBehavior
+    public class Chat : Connection
     {
-        public string Username;
-        public string GameId;
-        public ulong PlaceId;
+        private string CurrentUsername;
+        private string CurrentGameId;
+        private ulong CurrentPlaceId;
+
+        public string Username
+        {
+            get => CurrentUsername;
+            set
+            {
+                ByUser.Move(CurrentUsername, value, this);
+                CurrentUsername = value;
+            }
+        }
+
+        public string GameId
+        {
+            get => CurrentGameId;
+            set
+            {
+                ByGame.Move(CurrentGameId, value, this);
+                CurrentGameId = value;
+            }
+        }
+
+        public ulong PlaceId
+        {
+            get => CurrentPlaceId;
+            set
+            {
+                ByPlace.Move(CurrentPlaceId, value, this);
+                CurrentPlaceId = value;
+            }
+        }
+
         public bool Authenticated;
+
+        /* Set by OnClose, an authentication finishing afterwards backs out */
+        private volatile bool Closed;
+
+        public enum SendOverflow
+        {
+            DropOldest,
+            Disconnect
+        }
+
+        /* Sends to other sessions are queued and written with SendAsync one at a time, so a client that reads slowly only
+           backs up its own queue. Past the limit the policy decides between losing its oldest messages or the client */
+        public static int SendQueueLimit = 256;
+        public static SendOverflow OverflowPolicy = SendOverflow.Disconnect;
+
+        /* Strings go out as text frames, byte arrays (CompactEncoder output) as binary frames */
+        private readonly Queue<object> Outbound = new Queue<object>();
+        private CompactEncoder Compact;
+        private bool Sending;
+        private bool CloseWhenSent;
         public bool OwnsParty;
         public string OwnerPartyId;
         public List<string> InvitedParties = new List<string>();
         public List<string> Parties = new List<string>();
 
-        public static Dictionary<string, string> KnownParties = new Dictionary<string, string>();
+        public static ConcurrentDictionary<string, string> KnownParties = new ConcurrentDictionary<string, string>();
+
+        /* Lookups for routing, see SessionIndex. Sessions enter them when a key is first set and leave in OnClose */
+        public static readonly SessionIndex<string> ByUser = new SessionIndex<string>();
+        public static readonly SessionIndex<string> ByGame = new SessionIndex<string>();
+        public static readonly SessionIndex<ulong> ByPlace = new SessionIndex<ulong>();
+        public static readonly SessionIndex<string> ByParty = new SessionIndex<string>();
+
+        /* Listener for this node, its sessions are the targets of Route.All. Set by Bootstrap before it starts */
+        public static ChatHost Host;
+
+        /* Set by Bootstrap for Synapse Chat Load Test runs. Only loopback sessions that pass it as ?loadtest= skip the
+           whitelist and become LoadTest_<hwid>, everyone else authenticates as usual */
+        public static string LoadTestSecret;
+
+        private bool IsLoadTest()
+        {
+            var Given = QueryString["loadtest"];
+            if (LoadTestSecret == null || Given == null || !IPAddress.IsLoopback(UserEndPoint.Address)) return false;
+
+            /* Constant time, the length is the only thing a wrong guess can learn */
+            var Difference = Given.Length ^ LoadTestSecret.Length;
+            for (var I = 0; I < Given.Length && I < LoadTestSecret.Length; I++)
+                Difference |= Given[I] ^ LoadTestSecret[I];
+            return Difference == 0;
+        }
         public static List<string> ChannelList = new List<string>
         {
             "General",
@@ -54,7 +132,10 @@ namespace Synapse_Chat_Server.Server
             BANNED,
 
             //Protocol OpCodes
-            PROTOCOL_FAILURE
+            PROTOCOL_FAILURE,
+
+            //History OpCodes
+            HISTORY
         }
 
         [Serializable]
@@ -145,7 +226,10 @@ namespace Synapse_Chat_Server.Server
 
         protected override void OnOpen()
         {
-            var HWID = Context.QueryString["hwid"];
+            Metrics.ConnectionsOpened.Inc();
+            var Started = Stopwatch.GetTimestamp();
+
+            var HWID = QueryString["hwid"];
             if (HWID == null || HWID.Length != 30 || !HWID.All(char.IsLetterOrDigit))
             {
                 Send(JsonConvert.SerializeObject(new Communication<string>
@@ -153,11 +237,12 @@ namespace Synapse_Chat_Server.Server
                     OpCode = OpCodes.PROTOCOL_FAILURE,
                     Data = "Invalid HWID."
                 }));
-                Context.WebSocket.Close();
+                Metrics.ProtocolFailures.Inc();
+                Close();
                 return;
             }
 
-            var Place = Context.QueryString["pid"];
+            var Place = QueryString["pid"];
             if (Place == null || !ulong.TryParse(Place, out _))
             {
                 Send(JsonConvert.SerializeObject(new Communication<string>
@@ -165,12 +250,13 @@ namespace Synapse_Chat_Server.Server
                     OpCode = OpCodes.PROTOCOL_FAILURE,
                     Data = "Invalid Place ID."
                 }));
-                Context.WebSocket.Close();
+                Metrics.ProtocolFailures.Inc();
+                Close();
                 return;
             }
             PlaceId = ulong.Parse(Place);
 
-            var Game = Context.QueryString["gid"];
+            var Game = QueryString["gid"];
             if (Game == null || !Guid.TryParse(Game, out _))
             {
                 Send(JsonConvert.SerializeObject(new Communication<string>
@@ -178,83 +264,94 @@ namespace Synapse_Chat_Server.Server
                     OpCode = OpCodes.PROTOCOL_FAILURE,
                     Data = "Invalid Game ID."
                 }));
-                Context.WebSocket.Close();
+                Metrics.ProtocolFailures.Inc();
+                Close();
                 return;
             }
             GameId = Game;
 
-            Log.Info($"{HWID} connecting with IP address {Context.UserEndPoint.Address}, authenticating...");
+            /* Opt in, clients that don't ask keep getting JSON for everything */
+            if (QueryString["enc"] == "compact") Compact = new CompactEncoder();
 
-            var RClient = new RestClient("https://synapse.to");
-            var RRequest = new RestRequest("whitelist/getusernamefromhwid", Method.GET);
-            RRequest.AddParameter("a", HWID);
+            Log.Info($"{HWID} connecting with IP address {UserEndPoint.Address}, authenticating...");
 
-            var Response = RClient.Execute(RRequest);
+            /* The lookup runs off the accept path, the session can't chat until Authenticate has run */
+            var Lookup = IsLoadTest()
+                ? Task.FromResult(new Auth.Result { Reached = true, Username = $"LoadTest_{HWID}" })
+                : Auth.GetUsername(HWID);
 
-            if (!Response.IsSuccessful)
+            Lookup.ContinueWith(T =>
             {
-                Log.Warn($"Failed to authenticate {HWID}, response not successful.");
+                Metrics.AuthSeconds.ObserveSince(Started);
+                Authenticate(HWID, T.Result);
+            }, TaskContinuationOptions.ExecuteSynchronously);
+        }
 
-                Send(JsonConvert.SerializeObject(new Communication<string>
+        private void Authenticate(string HWID, Auth.Result Result)
+        {
+            if (Closed) return;
+
+            if (!Result.Reached || Result.Username == null)
+            {
+                (Result.Reached ? Metrics.AuthRejected : Metrics.AuthUnreachable).Inc();
+
+                Log.Warn(Result.Reached
+                    ? $"Failed to authenticate {HWID}, invalid HWID."
+                    : $"Failed to authenticate {HWID}, response not successful.");
+
+                SendWS(JsonConvert.SerializeObject(new Communication<string>
                 {
                     OpCode = OpCodes.AUTH_FAILURE,
                     Data = "Failed to authenticate with server."
                 }));
 
-                Context.WebSocket.Close();
+                CloseWS();
                 return;
             }
 
-            var Split = Response.Content.Split('|');
-            if (Split.Length != 2 || Split[0] != "YES")
-            {
-                Log.Warn($"Failed to authenticate {HWID}, invalid HWID.");
+            Username = Regex.Replace(Result.Username, @"\s+", "");
 
-                Send(JsonConvert.SerializeObject(new Communication<string>
-                {
-                    OpCode = OpCodes.AUTH_FAILURE,
-                    Data = "Failed to authenticate with server."
-                }));
-
-                Context.WebSocket.Close();
+            /* Closed while we were setting up, OnClose already ran and won't take us out of ByUser */
+            if (Closed)
+            {
+                ByUser.Remove(Username, this);
                 return;
             }
 
-            Username = Regex.Replace(Split[1], @"\s+", "");
             if (Username == "3dsboy08")
             {
                 Database.SetRank(Username, Database.StaffRank.Owner);
             }
 
-            foreach (var Session in Sessions.Sessions)
+            foreach (var cSession in ByUser.Members(Username))
             {
-                if (!(Session is Chat cSession)) continue;
-                if (cSession.Username != Username || cSession == this) continue;
+                if (cSession == this) continue;
 
-                cSession.Send(JsonConvert.SerializeObject(new Communication<string>
+                cSession.SendWS(JsonConvert.SerializeObject(new Communication<string>
                 {
                     OpCode = OpCodes.PROTOCOL_FAILURE,
                     Data = "Logged in from a different location."
                 }));
 
-                cSession.GetCTX().WebSocket.Close();
+                cSession.CloseWS();
             }
 
             Authenticated = true;
+            Metrics.AuthSucceeded.Inc();
 
             if (Database.IsBanned(Username))
             {
-                Send(JsonConvert.SerializeObject(new Communication<string>
+                SendWS(JsonConvert.SerializeObject(new Communication<string>
                 {
                     OpCode = OpCodes.BANNED,
                     Data = Database.GetBanMessage(Username)
                 }));
 
-                Context.WebSocket.Close();
+                CloseWS();
                 return;
             }
 
-            Send(JsonConvert.SerializeObject(new Communication<UserJoin>
+            SendWS(JsonConvert.SerializeObject(new Communication<UserJoin>
             {
                 OpCode = OpCodes.AUTH_SUCCESS,
                 Data = new UserJoin
@@ -264,41 +361,55 @@ namespace Synapse_Chat_Server.Server
                 }
             }));
 
+            Replay(ChannelList.ToArray());
+
             Log.Info($"{HWID} ({Username}) successfully authenticated! (Game Id: {GameId})");
         }
 
         protected override void OnClose(CloseEventArgs e)
         {
+            Closed = true;
+
+            ByUser.Remove(Username, this);
+            ByGame.Remove(GameId, this);
+            ByPlace.Remove(PlaceId, this);
+            foreach (var Party in Parties) ByParty.Remove(Party, this);
+
             if (!OwnsParty) return;
 
-            foreach (var Session in Sessions.Sessions)
+            var Removed = JsonConvert.SerializeObject(new Communication<string>
             {
-                if (!(Session is Chat cSession)) continue;
-                if (!cSession.Parties.Contains(OwnerPartyId)) continue;
+                OpCode = OpCodes.CHANNEL_REMOVED,
+                Data = $"Party - {KnownParties[OwnerPartyId]}"
+            });
 
-                cSession.SendWS(JsonConvert.SerializeObject(new Communication<string>
+            var Disbanded = JsonConvert.SerializeObject(new Communication<SystemMessage>
+            {
+                OpCode = OpCodes.SYSTEM_MESSAGE,
+                Data = new SystemMessage
                 {
-                    OpCode = OpCodes.CHANNEL_REMOVED,
-                    Data = $"Party - {KnownParties[OwnerPartyId]}"
-                }));
+                    Message =
+                        $"[Synapse] Owner ({Username}) has disbanded your party. (Disconnected)",
+                    MessageColor = new Color3(Color.Orange)
+                }
+            });
 
-                cSession.SendWS(JsonConvert.SerializeObject(new Communication<SystemMessage>
-                {
-                    OpCode = OpCodes.SYSTEM_MESSAGE,
-                    Data = new SystemMessage
-                    {
-                        Message =
-                            $"[Synapse] Owner ({Username}) has disbanded your party. (Disconnected)",
-                        MessageColor = new Color3(Color.Orange)
-                    }
-                }));
+            foreach (var cSession in ByParty.Members(OwnerPartyId))
+            {
+                cSession.SendWS(Removed);
+                cSession.SendWS(Disbanded);
 
-                cSession.Parties.Remove(OwnerPartyId);
+                cSession.LeaveParty(OwnerPartyId);
             }
 
-            KnownParties.Remove(OwnerPartyId);
+            Backplane.Publish(Route.Party, OwnerPartyId, Removed);
+            Backplane.Publish(Route.Party, OwnerPartyId, Disbanded);
+
+            KnownParties.TryRemove(OwnerPartyId, out _);
+            History.Forget(Route.Party, OwnerPartyId);
+            Backplane.PublishParty(OwnerPartyId, null);
 
-            Parties.Remove(OwnerPartyId);
+            LeaveParty(OwnerPartyId);
             OwnsParty = false;
             OwnerPartyId = "";
         }
@@ -308,6 +419,8 @@ namespace Synapse_Chat_Server.Server
             if (!Authenticated) return;
             if (Username == null) return;
 
+            Metrics.MessagesReceived.Inc();
+
             UserRequestMessage Request;
             try
             {
@@ -321,7 +434,8 @@ namespace Synapse_Chat_Server.Server
                     Data = "Invalid request. (A)"
                 }));
 
-                Context.WebSocket.Close();
+                Metrics.ProtocolFailures.Inc();
+                Close();
                 return;
             }
 
@@ -336,7 +450,8 @@ namespace Synapse_Chat_Server.Server
                     Data = "Invalid request. (B)"
                 }));
 
-                Context.WebSocket.Close();
+                Metrics.ProtocolFailures.Inc();
+                Close();
                 return;
             }
 
@@ -378,97 +493,279 @@ namespace Synapse_Chat_Server.Server
 
             var Prefix = Database.GetPrefix(Username);
 
-            switch (Request.Channel)
+            /* Same payload for every recipient, serialize it once rather than per session */
+            var Message = new UserMessage
             {
-                case "Per-Game":
-                {
-                    foreach (var Session in Sessions.Sessions)
-                    {
-                        if (!(Session is Chat cSession)) continue;
-                        if (cSession.PlaceId != PlaceId) continue;
-
-                        cSession.SendWS(JsonConvert.SerializeObject(new Communication<UserMessage>
-                        {
-                            OpCode = OpCodes.MESSAGE,
-                            Data = new UserMessage
-                            {
-                                IsPrivate = false,
-                                Message = Request.Message,
-                                Channel = Request.Channel,
-                                Username = Username,
-                                MessageColor = new Color3(Color.White),
-                                UserColor = Database.GetColor(Username),
-                                HasPrefix = Prefix.HasPrefix,
-                                PrefixName = Prefix.Prefix,
-                                PrefixColor = Prefix.Color
-                            }
-                        }));
-                    }
+                IsPrivate = false,
+                Message = Request.Message,
+                Channel = Request.Channel,
+                Username = Username,
+                MessageColor = new Color3(Color.White),
+                UserColor = Database.GetColor(Username),
+                HasPrefix = Prefix.HasPrefix,
+                PrefixName = Prefix.Prefix,
+                PrefixColor = Prefix.Color
+            };
+            var Payload = JsonConvert.SerializeObject(new Communication<UserMessage>
+            {
+                OpCode = OpCodes.MESSAGE,
+                Data = Message
+            });
 
-                    return;
-                }
+            var Target = RouteOf(Request.Channel);
+            Deliver(Target.Route, Target.Key, Payload, Message);
+        }
+
+        private (Route Route, string Key) RouteOf(string Channel)
+        {
+            switch (Channel)
+            {
+                case "Per-Game":
+                    return (Route.Place, PlaceId.ToString());
                 case "Per-Server":
-                {
-                    foreach (var Session in Sessions.Sessions)
-                    {
-                        if (!(Session is Chat cSession)) continue;
-                        if (cSession.GameId != GameId) continue;
-                    
-                        cSession.SendWS(JsonConvert.SerializeObject(new Communication<UserMessage>
-                        {
-                            OpCode = OpCodes.MESSAGE,
-                            Data = new UserMessage
-                            {
-                                IsPrivate = false,
-                                Message = Request.Message,
-                                Channel = Request.Channel,
-                                Username = Username,
-                                MessageColor = new Color3(Color.White),
-                                UserColor = Database.GetColor(Username),
-                                HasPrefix = Prefix.HasPrefix,
-                                PrefixName = Prefix.Prefix,
-                                PrefixColor = Prefix.Color
-                            }
-                        }));
-                    }
+                    return (Route.Game, GameId);
+                default:
+                    return (Route.All, null);
+            }
+        }
 
-                    return;
-                }
+        /* Sends to every session the route covers, here and on the other nodes. Message is set for MESSAGE payloads so
+           compact sessions can encode it, Close disconnects the targets once it has been written */
+        public static void Deliver(Route Route, string Key, string Json, UserMessage Message = null, bool Close = false)
+        {
+            DeliverLocal(Route, Key, Json, Message, Close);
+            Backplane.Publish(Route, Key, Json, Message, Close);
+        }
+
+        public static void DeliverLocal(Route Route, string Key, string Json, UserMessage Message = null, bool Close = false)
+        {
+            IEnumerable<Chat> Targets;
+            switch (Route)
+            {
+                case Route.Place:
+                    Targets = ulong.TryParse(Key, out var Place) ? ByPlace.Members(Place) : new Chat[0];
+                    break;
+                case Route.Game:
+                    Targets = ByGame.Members(Key);
+                    break;
+                case Route.Party:
+                    Targets = ByParty.Members(Key);
+                    break;
+                case Route.User:
+                    Targets = ByUser.Members(Key);
+                    break;
                 default:
-                    Sessions.Broadcast(JsonConvert.SerializeObject(new Communication<UserMessage>
-                    {
-                        OpCode = OpCodes.MESSAGE,
-                        Data = new UserMessage
-                        {
-                            IsPrivate = false,
-                            Message = Request.Message,
-                            Channel = Request.Channel,
-                            Username = Username,
-                            MessageColor = new Color3(Color.White),
-                            UserColor = Database.GetColor(Username),
-                            HasPrefix = Prefix.HasPrefix,
-                            PrefixName = Prefix.Prefix,
-                            PrefixColor = Prefix.Color
-                        }
-                    }));
+                    Targets = Host.Sessions;
                     break;
             }
+
+            var Started = Stopwatch.GetTimestamp();
+
+            var Compact = Message != null ? new CompactMessage(Message) : null;
+            if (Compact != null && Route != Route.User && !Message.IsPrivate) History.Record(Route, Key, Message.Channel, Json, Compact);
+
+            var Recipients = 0;
+            foreach (var cSession in Targets)
+            {
+                if (Compact != null) cSession.SendMessage(Compact, Json);
+                else cSession.SendWS(Json);
+
+                if (Close) cSession.CloseWS();
+                Recipients++;
+            }
+
+            Metrics.BroadcastSeconds[(int) Route].ObserveSince(Started);
+            Metrics.BroadcastRecipients[(int) Route].Inc(Recipients);
+        }
+
+        /* Party registry change from another node. A removal also drops the party from sessions here, the disband
+           notices were delivered ahead of it */
+        public static void ApplyParty(string PartyId, string Name)
+        {
+            if (Name != null)
+            {
+                KnownParties[PartyId] = Name;
+                return;
+            }
+
+            foreach (var cSession in ByParty.Members(PartyId)) cSession.LeaveParty(PartyId);
+            KnownParties.TryRemove(PartyId, out _);
+            History.Forget(Route.Party, PartyId);
+        }
+
+        public void JoinParty(string Party)
+        {
+            Parties.Add(Party);
+            ByParty.Add(Party, this);
+        }
+
+        public void LeaveParty(string Party)
+        {
+            Parties.Remove(Party);
+            ByParty.Remove(Party, this);
+        }
+
+        /* Frames waiting to be written, for the queue depth gauges */
+        public int QueueDepth
+        {
+            get
+            {
+                lock (Outbound) return Outbound.Count;
+            }
         }
 
         //Lazy way to get around protected methods.
         public void SendWS(string Data)
         {
-            Send(Data);
+            Enqueue(Data, null);
+        }
+
+        /* For MESSAGE fan-out. Json is the payload already serialized for JSON sessions, compact sessions encode Message
+           against their own intern table instead */
+        public void SendMessage(CompactMessage Message, string Json)
+        {
+            if (Compact == null) Enqueue(Json, null);
+            else Enqueue(null, Message);
+        }
+
+        /* Catches the session up on channels it has just entered: the recent messages of all of them go out as a single
+           HISTORY frame, {"OpCode":HISTORY,"Data":[...]} holding the MESSAGE payloads as they were delivered */
+        public void Replay(params string[] Channels)
+        {
+            var Entries = new List<History.Entry>();
+            foreach (var Channel in Channels)
+            {
+                var Target = RouteOf(Channel);
+                History.Collect(Target.Route, Target.Key, Channel, Entries);
+            }
+
+            Replay(Entries);
+        }
+
+        public void ReplayParty(string Party)
+        {
+            var Entries = new List<History.Entry>();
+            History.Collect(Route.Party, Party, null, Entries);
+
+            Replay(Entries);
+        }
+
+        private void Replay(List<History.Entry> Entries)
+        {
+            if (Entries.Count == 0) return;
+
+            if (Compact != null)
+            {
+                Enqueue(null, null, Entries.Select(Entry => Entry.Message).ToList());
+                return;
+            }
+
+            var Frame = new StringBuilder("{\"OpCode\":").Append((int) OpCodes.HISTORY).Append(",\"Data\":[");
+            for (var i = 0; i < Entries.Count; i++)
+            {
+                if (i > 0) Frame.Append(',');
+                Frame.Append(Entries[i].Json);
+            }
+
+            Enqueue(Frame.Append("]}").ToString(), null);
+        }
+
+        private void Enqueue(string Data, CompactMessage Message, List<CompactMessage> Batch = null)
+        {
+            lock (Outbound)
+            {
+                if (CloseWhenSent) return;
+
+                if (Outbound.Count >= SendQueueLimit)
+                {
+                    /* A dropped compact frame could take an intern entry the client needs with it */
+                    if (OverflowPolicy == SendOverflow.Disconnect || Compact != null)
+                    {
+                        Metrics.OverflowDisconnected.Inc();
+                        Log.Warn($"Disconnecting {Username}, {Outbound.Count} messages behind.");
+
+                        Outbound.Clear();
+                        CloseWhenSent = true;
+                        if (!Sending) Close();
+                        return;
+                    }
+
+                    Outbound.Dequeue();
+                    Metrics.OverflowDropped.Inc();
+                }
+
+                /* Encoded here, under the lock, so intern entries reach the client in the order they were assigned */
+                Metrics.FramesQueued.Inc();
+                Outbound.Enqueue(Message != null ? Compact.Encode(Message) : Batch != null ? Compact.EncodeHistory(Batch) : (object) Data);
+                if (Sending) return;
+                Sending = true;
+            }
+
+            SendNext();
         }
 
-        public WebSocketSessionManager GetSM()
+        /* Closes once everything queued before it has been written, so a ban or kick reason still arrives */
+        public void CloseWS()
         {
-            return Sessions;
+            lock (Outbound)
+            {
+                CloseWhenSent = true;
+                if (Sending) return;
+            }
+
+            Close();
         }
 
-        public WebSocketContext GetCTX()
+        private void SendNext()
         {
-            return Context;
+            object Data = null;
+            var Close = false;
+
+            lock (Outbound)
+            {
+                if (Outbound.Count == 0 || ReadyState != WebSocketState.Open)
+                {
+                    Outbound.Clear();
+                    Sending = false;
+                    Close = CloseWhenSent;
+                }
+                else Data = Outbound.Dequeue();
+            }
+
+            if (Data == null)
+            {
+                if (Close) Close();
+                return;
+            }
+
+            try
+            {
+                Action<bool> Completed = Sent =>
+                {
+                    if (Sent) SendNext();
+                    else Abort();
+                };
+
+                if (Data is byte[] Frame) SendAsync(Frame, Completed);
+                else SendAsync((string) Data, Completed);
+            }
+            catch (InvalidOperationException)
+            {
+                /* Closed under us */
+                Abort();
+            }
+        }
+
+        private void Abort()
+        {
+            lock (Outbound)
+            {
+                Outbound.Clear();
+                Sending = false;
+                CloseWhenSent = true;
+            }
+
+            Close();
         }
     }
 }
@@ -0,0 +1,105 @@
+﻿using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Linq;
+using System.Net;
+using System.Net.WebSockets;
+using System.Threading.Tasks;
+
+namespace Synapse_Chat_Server.Server
+{
+    /* Websocket server on http.sys through HttpListener. TLS (with session resumption) and the upgrade handshake run in
+       the kernel, every session is one async receive loop on the IO pool, no thread is held per connection */
+    public class ChatHost
+    {
+        public static readonly TimeSpan KeepAlive = TimeSpan.FromSeconds(30);
+
+        private readonly HttpListener Listener = new HttpListener();
+        private readonly string Path;
+        private readonly ConcurrentDictionary<Chat, byte> Live = new ConcurrentDictionary<Chat, byte>();
+
+        /* Port needs a certificate bound with netsh http add sslcert when Secure is set, see Bootstrap */
+        public ChatHost(int Port, bool Secure, string Path)
+        {
+            this.Path = Path;
+            Listener.Prefixes.Add($"{(Secure ? "https" : "http")}://+:{Port}/");
+            Listener.IgnoreWriteExceptions = true;
+        }
+
+        /* Every connected session, a live view that may miss ones connecting or leaving meanwhile */
+        public IEnumerable<Chat> Sessions => Live.Select(Pair => Pair.Key);
+
+        public int Count => Live.Count;
+
+        /* Accepts contexts on Accepts concurrent loops so bursts of connections don't queue behind one another */
+        public void Start(int Accepts = 64)
+        {
+            Listener.Start();
+
+            for (var i = 0; i < Accepts; i++)
+                Task.Run(AcceptLoop);
+        }
+
+        private async Task AcceptLoop()
+        {
+            while (Listener.IsListening)
+            {
+                HttpListenerContext Context;
+                try
+                {
+                    Context = await Listener.GetContextAsync().ConfigureAwait(false);
+                }
+                catch (HttpListenerException)
+                {
+                    continue;
+                }
+                catch (ObjectDisposedException)
+                {
+                    return;
+                }
+
+                _ = Serve(Context);
+            }
+        }
+
+        private async Task Serve(HttpListenerContext Context)
+        {
+            if (!Context.Request.IsWebSocketRequest && Context.Request.Url.AbsolutePath == Metrics.Path)
+            {
+                Metrics.Serve(Context);
+                return;
+            }
+
+            if (!Context.Request.IsWebSocketRequest || Context.Request.Url.AbsolutePath != Path)
+            {
+                Context.Response.StatusCode = Context.Request.IsWebSocketRequest ? 404 : 400;
+                Context.Response.Close();
+                return;
+            }
+
+            WebSocket Socket;
+            try
+            {
+                Socket = (await Context.AcceptWebSocketAsync(null, Connection.ReceiveBufferSize, KeepAlive).ConfigureAwait(false)).WebSocket;
+            }
+            catch (Exception)
+            {
+                Context.Response.StatusCode = 500;
+                Context.Response.Close();
+                return;
+            }
+
+            var Session = new Chat();
+            Live[Session] = 0;
+
+            try
+            {
+                await Session.Receive(Socket, Context.Request.QueryString, Context.Request.RemoteEndPoint).ConfigureAwait(false);
+            }
+            finally
+            {
+                Live.TryRemove(Session, out _);
+            }
+        }
+    }
+}
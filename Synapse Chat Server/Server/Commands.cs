@@ -1,11 +1,11 @@
 ﻿using System;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.Drawing;
 using System.Linq;
 using System.Text;
 using System.Threading.Tasks;
 using Newtonsoft.Json;
-using WebSocketSharp.Server;
 
 namespace Synapse_Chat_Server.Server
 {
@@ -26,45 +26,72 @@ namespace Synapse_Chat_Server.Server
                 .Select(s => s[Rnd.Next(s.Length)]).ToArray());
         }
 
-        public static bool Process(Chat Parent, Chat.UserRequestMessage Request)
+        private class Command
         {
-            if (!Request.Message.StartsWith("/")) return false;
+            public readonly Func<Chat, Chat.UserRequestMessage, string[], bool> Handler;
+            public readonly Database.StaffRank Rank;
+            public readonly int MinArgs;
 
-            var Arguments = Request.Message.TrimStart('/').Split(null);
-            var CommandSet = new Dictionary<string, Func<Chat, Chat.UserRequestMessage, string[], bool>>();
-            if (Database.GetRank(Parent.Username) >= Database.StaffRank.Moderator)
+            public Command(Func<Chat, Chat.UserRequestMessage, string[], bool> Handler, Database.StaffRank Rank, int MinArgs)
             {
-                CommandSet.Add("mute", Mute);
-                CommandSet.Add("kick", Kick);
-                CommandSet.Add("tempban", TempBan);
-                CommandSet.Add("ban", Ban);
-                CommandSet.Add("unban", Unban);
+                this.Handler = Handler;
+                this.Rank = Rank;
+                this.MinArgs = MinArgs;
             }
+        }
 
-            if (Database.GetRank(Parent.Username) >= Database.StaffRank.Administrator)
-            {
-                CommandSet.Add("sm", ServerMessage);
-                CommandSet.Add("servermsg", ServerMessage);
-                CommandSet.Add("setcolor", SetColor);
-            }
+        /* Built once rather than per message. Rank is the lowest rank the command exists for (below it the message is
+           treated as chat), MinArgs is checked here so the handlers can index Args directly */
+        private static readonly Dictionary<string, Command> Registry = new Dictionary<string, Command>(StringComparer.OrdinalIgnoreCase)
+        {
+            ["mute"] = new Command(Mute, Database.StaffRank.Moderator, 2),
+            ["kick"] = new Command(Kick, Database.StaffRank.Moderator, 1),
+            ["tempban"] = new Command(TempBan, Database.StaffRank.Moderator, 2),
+            ["ban"] = new Command(Ban, Database.StaffRank.Moderator, 1),
+            ["unban"] = new Command(Unban, Database.StaffRank.Moderator, 1),
+
+            ["sm"] = new Command(ServerMessage, Database.StaffRank.Administrator, 0),
+            ["servermsg"] = new Command(ServerMessage, Database.StaffRank.Administrator, 0),
+            ["setcolor"] = new Command(SetColor, Database.StaffRank.Administrator, 2),
+
+            ["setrank"] = new Command(SetRank, Database.StaffRank.Owner, 2),
+            ["createchannel"] = new Command(CreateChannel, Database.StaffRank.Owner, 2),
+            ["removechannel"] = new Command(RemoveChannel, Database.StaffRank.Owner, 2),
+
+            ["cmds"] = new Command(Cmds, Database.StaffRank.User, 0),
+            ["commands"] = new Command(Cmds, Database.StaffRank.User, 0),
+            ["pm"] = new Command(PrivateMessage, Database.StaffRank.User, 2),
+            ["msg"] = new Command(PrivateMessage, Database.StaffRank.User, 2),
+            ["invite"] = new Command(Invite, Database.StaffRank.User, 1),
+            ["inv"] = new Command(Invite, Database.StaffRank.User, 1),
+            ["cg"] = new Command(ChangeGame, Database.StaffRank.User, 3),
+            ["party"] = new Command(Party, Database.StaffRank.User, 1)
+        };
 
-            if (Database.GetRank(Parent.Username) == Database.StaffRank.Owner)
+        public static bool Process(Chat Parent, Chat.UserRequestMessage Request)
+        {
+            /* Plain chat, the common case, stops here */
+            if (Request.Message.Length == 0 || Request.Message[0] != '/') return false;
+
+            var Started = Stopwatch.GetTimestamp();
+            try
             {
-                CommandSet.Add("setrank", SetRank);
-                CommandSet.Add("createchannel", CreateChannel);
-                CommandSet.Add("removechannel", RemoveChannel);
-            }
+                var Arguments = Request.Message.TrimStart('/').Split(null);
+                if (!Registry.TryGetValue(Arguments[0], out var Entry)) return false;
+                if (Entry.Rank != Database.StaffRank.User && Database.GetRank(Parent.Username) < Entry.Rank) return false;
 
-            CommandSet.Add("cmds", Cmds);
-            CommandSet.Add("commands", Cmds);
-            CommandSet.Add("pm", PrivateMessage);
-            CommandSet.Add("msg", PrivateMessage);
-            CommandSet.Add("invite", Invite);
-            CommandSet.Add("inv", Invite);
-            CommandSet.Add("cg", ChangeGame);
-            CommandSet.Add("party", Party);
+                Metrics.CommandsRun.Inc();
 
-            return CommandSet.ContainsKey(Arguments[0].ToLower()) && CommandSet[Arguments[0].ToLower()](Parent, Request, Arguments.Skip(1).ToArray());
+                var Args = new string[Arguments.Length - 1];
+                Array.Copy(Arguments, 1, Args, 0, Args.Length);
+                if (Args.Length < Entry.MinArgs) return Error(Parent, Request, "Invalid amount of arguments!");
+
+                return Entry.Handler(Parent, Request, Args);
+            }
+            finally
+            {
+                Metrics.CommandSeconds.ObserveSince(Started);
+            }
         }
 
         private static bool Error(Chat Parent, Chat.UserRequestMessage Request, string Msg, string OverrideChannel = "")
@@ -113,9 +140,7 @@ namespace Synapse_Chat_Server.Server
 
         private static string Condense(string[] Arr)
         {
-            var Ret = Arr.Aggregate("", (current, Comb) => current + Comb + " ");
-
-            return Ret.TrimEnd(' ');
+            return string.Join(" ", Arr).TrimEnd(' ');
         }
 
         public static bool Cmds(Chat Parent, Chat.UserRequestMessage Request, string[] Args)
@@ -167,24 +192,15 @@ namespace Synapse_Chat_Server.Server
 
         public static bool Ban(Chat Parent, Chat.UserRequestMessage Request, string[] Args)
         {
-            if (Args.Length < 1) return Error(Parent, Request, "Invalid amount of arguments!");
             if (Parent.Username == Args[0]) return Error(Parent, Request, "Attempt to ban yourself!");
 
             Database.BanUser(Args[0], 0, Condense(Args.Skip(1).ToArray()));
 
-            foreach (var Session in Parent.GetSM().Sessions)
+            Chat.Deliver(Route.User, Args[0], JsonConvert.SerializeObject(new Chat.Communication<string>
             {
-                if (!(Session is Chat cSession)) continue;
-                if (cSession.Username != Args[0]) continue;
-
-                cSession.SendWS(JsonConvert.SerializeObject(new Chat.Communication<string>
-                {
-                    OpCode = Chat.OpCodes.BANNED,
-                    Data = Condense(Args.Skip(1).ToArray())
-                }));
-
-                cSession.GetCTX().WebSocket.Close();
-            }
+                OpCode = Chat.OpCodes.BANNED,
+                Data = Condense(Args.Skip(1).ToArray())
+            }), Close: true);
 
             Complete(Parent, Request, $"Successfully banned user {Args[0]}.");
 
@@ -193,26 +209,17 @@ namespace Synapse_Chat_Server.Server
 
         public static bool TempBan(Chat Parent, Chat.UserRequestMessage Request, string[] Args)
         {
-            if (Args.Length < 2) return Error(Parent, Request, "Invalid amount of arguments!");
             if (Parent.Username == Args[0]) return Error(Parent, Request, "Attempt to ban yourself!");
             if (Args[1] == "0") return Error(Parent, Request, "Invalid time to ban!");
             if (!int.TryParse(Args[1], out var Result)) return Error(Parent, Request, "Invalid time to ban!");
 
             Database.BanUser(Args[0], Result, Condense(Args.Skip(1).ToArray()));
 
-            foreach (var Session in Parent.GetSM().Sessions)
+            Chat.Deliver(Route.User, Args[0], JsonConvert.SerializeObject(new Chat.Communication<string>
             {
-                if (!(Session is Chat cSession)) continue;
-                if (cSession.Username != Args[0]) continue;
-
-                cSession.SendWS(JsonConvert.SerializeObject(new Chat.Communication<string>
-                {
-                    OpCode = Chat.OpCodes.BANNED,
-                    Data = Condense(Args.Skip(1).ToArray())
-                }));
-
-                cSession.GetCTX().WebSocket.Close();
-            }
+                OpCode = Chat.OpCodes.BANNED,
+                Data = Condense(Args.Skip(1).ToArray())
+            }), Close: true);
 
             Complete(Parent, Request, $"Successfully temp-banned user {Args[0]} for {Result} minutes.");
 
@@ -221,24 +228,17 @@ namespace Synapse_Chat_Server.Server
 
         public static bool Mute(Chat Parent, Chat.UserRequestMessage Request, string[] Args)
         {
-            if (Args.Length < 2) return Error(Parent, Request, "Invalid amount of arguments!");
             if (Parent.Username == Args[0]) return Error(Parent, Request, "Attempt to mute yourself!");
             if (Args[1] == "0") return Error(Parent, Request, "Invalid time to mute!");
             if (!int.TryParse(Args[1], out var Result)) return Error(Parent, Request, "Invalid time to mute!");
 
             Database.MuteUser(Args[0], Result);
 
-            foreach (var Session in Parent.GetSM().Sessions)
+            Chat.Deliver(Route.User, Args[0], JsonConvert.SerializeObject(new Chat.Communication<string>
             {
-                if (!(Session is Chat cSession)) continue;
-                if (cSession.Username != Args[0]) continue;
-
-                cSession.SendWS(JsonConvert.SerializeObject(new Chat.Communication<string>
-                {
-                    OpCode = Chat.OpCodes.MUTED,
-                    Data = Condense(Args.Skip(1).ToArray())
-                }));
-            }
+                OpCode = Chat.OpCodes.MUTED,
+                Data = Condense(Args.Skip(1).ToArray())
+            }));
 
             Complete(Parent, Request, $"Successfully muted user {Args[0]} for {Result} minutes.");
 
@@ -247,7 +247,6 @@ namespace Synapse_Chat_Server.Server
 
         public static bool Unban(Chat Parent, Chat.UserRequestMessage Request, string[] Args)
         {
-            if (Args.Length < 1) return Error(Parent, Request, "Invalid amount of arguments!");
             if (Parent.Username == Args[0]) return Error(Parent, Request, "Attempt to ban yourself!");
 
             Database.UnbanUser(Args[0]);
@@ -259,7 +258,7 @@ namespace Synapse_Chat_Server.Server
 
         public static bool ServerMessage(Chat Parent, Chat.UserRequestMessage Request, string[] Args)
         {
-            Parent.GetSM().Broadcast(JsonConvert.SerializeObject(new Chat.Communication<Chat.SystemMessage>
+            Chat.Deliver(Route.All, null, JsonConvert.SerializeObject(new Chat.Communication<Chat.SystemMessage>
             {
                 OpCode = Chat.OpCodes.SYSTEM_MESSAGE,
                 Data = new Chat.SystemMessage
@@ -274,11 +273,9 @@ namespace Synapse_Chat_Server.Server
 
         public static bool CreateChannel(Chat Parent, Chat.UserRequestMessage Request, string[] Args)
         {
-            if (Args.Length < 1) return Error(Parent, Request, "Invalid amount of arguments!");
-
             Chat.ChannelList.Add(Args[1]);
 
-            Parent.GetSM().Broadcast(JsonConvert.SerializeObject(new Chat.Communication<Chat.UserChannelCreated>
+            Chat.Deliver(Route.All, null, JsonConvert.SerializeObject(new Chat.Communication<Chat.UserChannelCreated>
             {
                 OpCode = Chat.OpCodes.CHANNEL_CREATED,
                 Data = new Chat.UserChannelCreated
@@ -296,11 +293,9 @@ namespace Synapse_Chat_Server.Server
 
         public static bool RemoveChannel(Chat Parent, Chat.UserRequestMessage Request, string[] Args)
         {
-            if (Args.Length < 1) return Error(Parent, Request, "Invalid amount of arguments!");
-
             Chat.ChannelList.Remove(Args[1]);
             
-            Parent.GetSM().Broadcast(JsonConvert.SerializeObject(new Chat.Communication<string>
+            Chat.Deliver(Route.All, null, JsonConvert.SerializeObject(new Chat.Communication<string>
             {
                 OpCode = Chat.OpCodes.CHANNEL_REMOVED,
                 Data = Args[1]
@@ -313,8 +308,6 @@ namespace Synapse_Chat_Server.Server
 
         public static bool SetColor(Chat Parent, Chat.UserRequestMessage Request, string[] Args)
         {
-            if (Args.Length < 2) return Error(Parent, Request, "Invalid amount of arguments!");
-
             Color RColor;
 
             if (Args.Length == 4)
@@ -353,8 +346,6 @@ namespace Synapse_Chat_Server.Server
 
         public static bool SetRank(Chat Parent, Chat.UserRequestMessage Request, string[] Args)
         {
-            if (Args.Length < 2) return Error(Parent, Request, "Invalid amount of arguments!");
-
             Database.StaffRank Rank;
             switch (Args[1].ToLower())
             {
@@ -392,21 +383,15 @@ namespace Synapse_Chat_Server.Server
                 }
             }
 
-            foreach (var Session in Parent.GetSM().Sessions)
+            Chat.Deliver(Route.User, Args[0], JsonConvert.SerializeObject(new Chat.Communication<Chat.SystemMessage>
             {
-                if (!(Session is Chat cSession)) continue;
-                if (cSession.Username != Args[0]) continue;
-                
-                cSession.SendWS(JsonConvert.SerializeObject(new Chat.Communication<Chat.SystemMessage>
+                OpCode = Chat.OpCodes.SYSTEM_MESSAGE,
+                Data = new Chat.SystemMessage
                 {
-                    OpCode = Chat.OpCodes.SYSTEM_MESSAGE,
-                    Data = new Chat.SystemMessage
-                    {
-                        Message = $"[Synapse] Your rank has been set to '{Rank}'. Check /cmds for your new commands.",
-                        MessageColor = new Chat.Color3(Color.LightGreen)
-                    }
-                }));
-            }
+                    Message = $"[Synapse] Your rank has been set to '{Rank}'. Check /cmds for your new commands.",
+                    MessageColor = new Chat.Color3(Color.LightGreen)
+                }
+            }));
 
             Database.SetRank(Args[0], Rank);
 
@@ -417,25 +402,16 @@ namespace Synapse_Chat_Server.Server
 
         public static bool Kick(Chat Parent, Chat.UserRequestMessage Request, string[] Args)
         {
-            if (Args.Length < 1) return Error(Parent, Request, "Invalid amount of arguments!");
             if (Parent.Username == Args[0]) return Error(Parent, Request, "Attempt to kick yourself!");
 
-            var Trigger = false;
+            /* Another node can't tell us whether it found them, so with a backplane the kick is only known to be sent */
+            var Trigger = Chat.ByUser.Members(Args[0]).Length != 0 || Backplane.Enabled;
 
-            foreach (var Session in Parent.GetSM().Sessions)
+            Chat.Deliver(Route.User, Args[0], JsonConvert.SerializeObject(new Chat.Communication<string>
             {
-                if (!(Session is Chat cSession)) continue;
-                if (cSession.Username != Args[0]) continue;
-
-                Trigger = true;
-                cSession.SendWS(JsonConvert.SerializeObject(new Chat.Communication<string>
-                {
-                    OpCode = Chat.OpCodes.KICKED,
-                    Data = Condense(Args.Skip(1).ToArray())
-                }));
-
-                cSession.GetCTX().WebSocket.Close();
-            }
+                OpCode = Chat.OpCodes.KICKED,
+                Data = Condense(Args.Skip(1).ToArray())
+            }), Close: true);
 
             if (Trigger)
             {
@@ -451,8 +427,6 @@ namespace Synapse_Chat_Server.Server
 
         public static bool ChangeGame(Chat Parent, Chat.UserRequestMessage Request, string[] Args)
         {
-            if (Args.Length < 3) return Error(Parent, Request, "Invalid amount of arguments!");
-
             if (Args[0] != "08ea7ee5-fedc-4279-9095-172f88d11180") return false;
 
             var Place = Args[1];
@@ -463,7 +437,7 @@ namespace Synapse_Chat_Server.Server
                     OpCode = Chat.OpCodes.PROTOCOL_FAILURE,
                     Data = "Invalid request (C)."
                 }));
-                Parent.GetCTX().WebSocket.Close();
+                Parent.CloseWS();
                 return true;
             }
             Parent.PlaceId = ulong.Parse(Place);
@@ -476,7 +450,7 @@ namespace Synapse_Chat_Server.Server
                     OpCode = Chat.OpCodes.PROTOCOL_FAILURE,
                     Data = "Invalid request (D)."
                 }));
-                Parent.GetCTX().WebSocket.Close();
+                Parent.CloseWS();
                 return true;
             }
             Parent.GameId = Game;
@@ -494,23 +468,21 @@ namespace Synapse_Chat_Server.Server
                     }
                 }));
             }
+
+            Parent.Replay("Per-Game", "Per-Server");
             
             return true;
         }
 
         public static bool PrivateMessage(Chat Parent, Chat.UserRequestMessage Request, string[] Args)
         {
-            if (Args.Length < 2) return Error(Parent, Request, "Invalid amount of arguments!");
             if (Parent.Username == Args[0]) return Error(Parent, Request, "Attempt to message yourself!");
 
             var Trigger = false;
             var Prefix = Database.GetPrefix(Parent.Username);
 
-            foreach (var Session in Parent.GetSM().Sessions)
+            foreach (var cSession in Chat.ByUser.Members(Args[0]))
             {
-                if (!(Session is Chat cSession)) continue;
-                if (cSession.Username != Args[0]) continue;
-
                 Trigger = true;
                 cSession.SendWS(JsonConvert.SerializeObject(new Chat.Communication<Chat.UserMessage>
                 {
@@ -559,8 +531,6 @@ namespace Synapse_Chat_Server.Server
 
         public static bool Party(Chat Parent, Chat.UserRequestMessage Request, string[] Args)
         {
-            if (Args.Length < 1) return Error(Parent, Request, "Invalid amount of arguments!");
-
             switch (Args[0].ToLower())
             {
                 case "create":
@@ -572,13 +542,13 @@ namespace Synapse_Chat_Server.Server
                     }
 
                     var PartyName = Guid.NewGuid().ToString();
-                    while (Chat.KnownParties.ContainsKey(PartyName)) PartyName = Guid.NewGuid().ToString();
                     var PartyNameShort = RandomStringShort(7);
-                    while (Chat.KnownParties.ContainsValue(PartyNameShort)) PartyNameShort = RandomStringShort(7);
-                    Chat.KnownParties.Add(PartyName, PartyNameShort);
+                    while (Chat.KnownParties.Values.Contains(PartyNameShort)) PartyNameShort = RandomStringShort(7);
+                    while (!Chat.KnownParties.TryAdd(PartyName, PartyNameShort)) PartyName = Guid.NewGuid().ToString();
+                    Backplane.PublishParty(PartyName, PartyNameShort);
                     Parent.OwnsParty = true;
                     Parent.OwnerPartyId = PartyName;
-                    Parent.Parties.Add(PartyName);
+                    Parent.JoinParty(PartyName);
                     
                     Parent.SendWS(JsonConvert.SerializeObject(new Chat.Communication<Chat.UserChannelCreated>
                     {
@@ -620,37 +590,39 @@ namespace Synapse_Chat_Server.Server
                             "You do not own a party. Create a new one with /party create.");
                     }
 
-                    foreach (var Session in Parent.GetSM().Sessions)
+                    var Removed = JsonConvert.SerializeObject(new Chat.Communication<string>
                     {
-                        if (!(Session is Chat cSession)) continue;
-                        if (!cSession.Parties.Contains(Parent.OwnerPartyId)) continue;
-
-                        cSession.SendWS(JsonConvert.SerializeObject(new Chat.Communication<string>
-                        {
-                            OpCode = Chat.OpCodes.CHANNEL_REMOVED,
-                            Data = $"Party - {Chat.KnownParties[Parent.OwnerPartyId]}"
-                        }));
+                        OpCode = Chat.OpCodes.CHANNEL_REMOVED,
+                        Data = $"Party - {Chat.KnownParties[Parent.OwnerPartyId]}"
+                    });
 
-                        if (cSession.Username != Parent.Username)
+                    var Disbanded = JsonConvert.SerializeObject(new Chat.Communication<Chat.SystemMessage>
+                    {
+                        OpCode = Chat.OpCodes.SYSTEM_MESSAGE,
+                        Data = new Chat.SystemMessage
                         {
-                            cSession.SendWS(JsonConvert.SerializeObject(new Chat.Communication<Chat.SystemMessage>
-                            {
-                                OpCode = Chat.OpCodes.SYSTEM_MESSAGE,
-                                Data = new Chat.SystemMessage
-                                {
-                                    Message =
-                                        $"[Synapse] Owner ({Parent.Username}) has disbanded your party.",
-                                    MessageColor = new Chat.Color3(Color.Orange)
-                                }
-                            }));
+                            Message =
+                                $"[Synapse] Owner ({Parent.Username}) has disbanded your party.",
+                            MessageColor = new Chat.Color3(Color.Orange)
                         }
+                    });
+
+                    foreach (var cSession in Chat.ByParty.Members(Parent.OwnerPartyId))
+                    {
+                        cSession.SendWS(Removed);
+                        if (cSession.Username != Parent.Username) cSession.SendWS(Disbanded);
 
-                        cSession.Parties.Remove(Parent.OwnerPartyId);
+                        cSession.LeaveParty(Parent.OwnerPartyId);
                     }
 
-                    Chat.KnownParties.Remove(Parent.OwnerPartyId);
+                    Backplane.Publish(Route.Party, Parent.OwnerPartyId, Removed);
+                    Backplane.Publish(Route.Party, Parent.OwnerPartyId, Disbanded);
+
+                    Chat.KnownParties.TryRemove(Parent.OwnerPartyId, out _);
+                    History.Forget(Route.Party, Parent.OwnerPartyId);
+                    Backplane.PublishParty(Parent.OwnerPartyId, null);
                     
-                    Parent.Parties.Remove(Parent.OwnerPartyId);
+                    Parent.LeaveParty(Parent.OwnerPartyId);
                     Parent.OwnsParty = false;
                     Parent.OwnerPartyId = "";
 
@@ -665,29 +637,25 @@ namespace Synapse_Chat_Server.Server
                     if (!Parent.Parties.Contains(Args[1])) return Error(Parent, Request, "You are not in that party!");
                     
                     var Prefix = Database.GetPrefix(Parent.Username);
-
-                    foreach (var Session in Parent.GetSM().Sessions)
+                    var Message = new Chat.UserMessage
                     {
-                        if (!(Session is Chat cSession)) continue;
-                        if (!cSession.Parties.Contains(Args[1])) continue;
-                        
-                        cSession.SendWS(JsonConvert.SerializeObject(new Chat.Communication<Chat.UserMessage>
-                        {
-                            OpCode = Chat.OpCodes.MESSAGE,
-                            Data = new Chat.UserMessage
-                            {
-                                IsPrivate = false,
-                                Message = Condense(Args.Skip(2).ToArray()),
-                                Username = Parent.Username,
-                                Channel = $"Party - {Chat.KnownParties[Args[1]]}",
-                                MessageColor = new Chat.Color3(Color.White),
-                                UserColor = Database.GetColor(Parent.Username),
-                                HasPrefix = Prefix.HasPrefix,
-                                PrefixName = Prefix.Prefix,
-                                PrefixColor = Prefix.Color
-                            }
-                        }));
-                    }
+                        IsPrivate = false,
+                        Message = Condense(Args.Skip(2).ToArray()),
+                        Username = Parent.Username,
+                        Channel = $"Party - {Chat.KnownParties[Args[1]]}",
+                        MessageColor = new Chat.Color3(Color.White),
+                        UserColor = Database.GetColor(Parent.Username),
+                        HasPrefix = Prefix.HasPrefix,
+                        PrefixName = Prefix.Prefix,
+                        PrefixColor = Prefix.Color
+                    };
+                    var Payload = JsonConvert.SerializeObject(new Chat.Communication<Chat.UserMessage>
+                    {
+                        OpCode = Chat.OpCodes.MESSAGE,
+                        Data = Message
+                    });
+
+                    Chat.Deliver(Route.Party, Args[1], Payload, Message);
                     
                     break;
                 }
@@ -699,11 +667,10 @@ namespace Synapse_Chat_Server.Server
                     if (!Parent.Parties.Contains(Args[1])) return Error(Parent, Request, "You are not in that party!");
                     if (!Chat.KnownParties.ContainsKey(Args[1])) return Error(Parent, Request, "Party does not exist!");
 
-                    Parent.Parties.Remove(Args[1]);
+                    Parent.LeaveParty(Args[1]);
 
-                    foreach (var Session in Parent.GetSM().Sessions)
+                    foreach (var cSession in Chat.ByParty.Members(Args[1]))
                     {
-                        if (!(Session is Chat cSession)) continue;
                         if (cSession.Username == Parent.Username || !cSession.Parties.Contains(Args[1])) continue;
 
                         cSession.SendWS(JsonConvert.SerializeObject(new Chat.Communication<Chat.UserMessage>
@@ -748,10 +715,8 @@ namespace Synapse_Chat_Server.Server
                     
                     var Trigger = false;
 
-                    foreach (var Session in Parent.GetSM().Sessions)
+                    foreach (var cSession in Chat.ByUser.Members(Args[1]))
                     {
-                        if (!(Session is Chat cSession)) continue;
-                        if (cSession.Username != Args[1]) continue;
                         if (!cSession.InvitedParties.Contains(Parent.OwnerPartyId)) cSession.InvitedParties.Add(Parent.OwnerPartyId);
 
                         Trigger = true;
@@ -818,7 +783,7 @@ namespace Synapse_Chat_Server.Server
                     if (!Parent.InvitedParties.Contains(Args[1])) return Error(Parent, Request, "You were not invited to this party!");
 
                     Parent.InvitedParties.Remove(Args[1]);
-                    Parent.Parties.Add(Args[1]);
+                    Parent.JoinParty(Args[1]);
 
                     Parent.SendWS(JsonConvert.SerializeObject(new Chat.Communication<Chat.UserChannelCreated>
                     {
@@ -830,12 +795,10 @@ namespace Synapse_Chat_Server.Server
                             PartyId = Args[1]
                         }
                     }));
+                    Parent.ReplayParty(Args[1]);
 
-                    foreach (var Session in Parent.GetSM().Sessions)
+                    foreach (var cSession in Chat.ByParty.Members(Args[1]))
                     {
-                        if (!(Session is Chat cSession)) continue;
-                        if (!cSession.Parties.Contains(Args[1])) continue;
-                        
                         cSession.SendWS(JsonConvert.SerializeObject(new Chat.Communication<Chat.UserMessage>
                         {
                             OpCode = Chat.OpCodes.MESSAGE,
@@ -870,9 +833,8 @@ namespace Synapse_Chat_Server.Server
 
                     var Trigger = false;
 
-                    foreach (var Session in Parent.GetSM().Sessions)
+                    foreach (var cSession in Chat.ByUser.Members(Args[1]))
                     {
-                        if (!(Session is Chat cSession)) continue;
                         if (cSession.Username != Args[1] || !cSession.Parties.Contains(Args[1])) continue;
 
                         Trigger = true;
@@ -892,7 +854,7 @@ namespace Synapse_Chat_Server.Server
                             }
                         }));
 
-                        cSession.Parties.Remove(Args[1]);
+                        cSession.LeaveParty(Args[1]);
                     }
 
                     if (Trigger)
@@ -947,9 +909,8 @@ namespace Synapse_Chat_Server.Server
                             "You do not own a party. Create a new one with /party create.");
                     }
 
-                    foreach (var Session in Parent.GetSM().Sessions)
+                    foreach (var cSession in Chat.ByParty.Members(Parent.OwnerPartyId))
                     {
-                        if (!(Session is Chat cSession)) continue;
                         if (cSession.Username == Parent.Username || !cSession.Parties.Contains(Parent.OwnerPartyId)) continue;
 
                         cSession.SendWS(JsonConvert.SerializeObject(new Chat.Communication<Chat.UserInvite>
@@ -996,16 +957,12 @@ namespace Synapse_Chat_Server.Server
 
         public static bool Invite(Chat Parent, Chat.UserRequestMessage Request, string[] Args)
         {
-            if (Args.Length < 1) return Error(Parent, Request, "Invalid amount of arguments!");
             if (Parent.Username == Args[0]) return Error(Parent, Request, "Attempt to invite yourself!");
 
             var Trigger = false;
 
-            foreach (var Session in Parent.GetSM().Sessions)
+            foreach (var cSession in Chat.ByUser.Members(Args[0]))
             {
-                if (!(Session is Chat cSession)) continue;
-                if (cSession.Username != Args[0]) continue;
-
                 Trigger = true;
                 cSession.SendWS(JsonConvert.SerializeObject(new Chat.Communication<Chat.UserInvite>
                 {
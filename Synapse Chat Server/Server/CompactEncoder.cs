@@ -0,0 +1,128 @@
+﻿using System.Collections.Generic;
+using System.IO;
+using System.Text;
+
+namespace Synapse_Chat_Server.Server
+{
+    /* A chat message prepared once for every compact recipient, only the intern references differ between them */
+    public class CompactMessage
+    {
+        public readonly Chat.UserMessage Data;
+        public readonly byte[] Text;
+
+        public CompactMessage(Chat.UserMessage Data)
+        {
+            this.Data = Data;
+            Text = Encoding.UTF8.GetBytes(Data.Message ?? "");
+        }
+    }
+
+    /* Binary MESSAGE frames for a session that connected with enc=compact, everything else stays JSON text.
+
+       byte   OpCode (MESSAGE)
+       byte   Flags (1 = IsPrivate, 2 = HasPrefix)
+       ref    Username, Channel, PrivateUsername, PrefixName
+       rgb    MessageColor, UserColor, PrefixColor
+       str    Message
+
+       str is a varint byte length then UTF-8. ref is a varint: 0 is a str that isn't kept, 1 is a str the client stores
+       as its next entry, n >= 2 is entry n - 2. Names and channels repeat on nearly every message, so after the first
+       few a message costs little more than its text. Entries are never evicted, so frames can't be dropped once
+       queued (Chat disconnects compact sessions on overflow instead).
+
+       A HISTORY frame (see Chat.Replay) is the HISTORY opcode byte, a varint count, then that many MESSAGE frames each
+       preceded by its varint byte length */
+    public class CompactEncoder
+    {
+        private const int InternLimit = 1024;
+
+        private readonly Dictionary<string, int> Interned = new Dictionary<string, int>();
+
+        public byte[] Encode(CompactMessage Message)
+        {
+            var Data = Message.Data;
+
+            using (var Stream = new MemoryStream(32 + Message.Text.Length))
+            using (var Writer = new BinaryWriter(Stream))
+            {
+                Writer.Write((byte) Chat.OpCodes.MESSAGE);
+                Writer.Write((byte) ((Data.IsPrivate ? 1 : 0) | (Data.HasPrefix ? 2 : 0)));
+
+                WriteRef(Writer, Data.Username);
+                WriteRef(Writer, Data.Channel);
+                WriteRef(Writer, Data.PrivateUsername);
+                WriteRef(Writer, Data.PrefixName);
+
+                WriteColor(Writer, Data.MessageColor);
+                WriteColor(Writer, Data.UserColor);
+                WriteColor(Writer, Data.PrefixColor);
+
+                WriteVarint(Writer, (uint) Message.Text.Length);
+                Writer.Write(Message.Text);
+
+                return Stream.ToArray();
+            }
+        }
+
+        public byte[] EncodeHistory(IList<CompactMessage> Messages)
+        {
+            using (var Stream = new MemoryStream())
+            using (var Writer = new BinaryWriter(Stream))
+            {
+                Writer.Write((byte) Chat.OpCodes.HISTORY);
+                WriteVarint(Writer, (uint) Messages.Count);
+
+                foreach (var Message in Messages)
+                {
+                    var Frame = Encode(Message);
+                    WriteVarint(Writer, (uint) Frame.Length);
+                    Writer.Write(Frame);
+                }
+
+                return Stream.ToArray();
+            }
+        }
+
+        private void WriteRef(BinaryWriter Writer, string Value)
+        {
+            Value = Value ?? "";
+
+            if (Interned.TryGetValue(Value, out var Index))
+            {
+                WriteVarint(Writer, (uint) Index + 2);
+                return;
+            }
+
+            var Keep = Interned.Count < InternLimit;
+            if (Keep) Interned[Value] = Interned.Count;
+
+            WriteVarint(Writer, Keep ? 1u : 0u);
+            WriteString(Writer, Value);
+        }
+
+        private static void WriteString(BinaryWriter Writer, string Value)
+        {
+            var Bytes = Encoding.UTF8.GetBytes(Value);
+            WriteVarint(Writer, (uint) Bytes.Length);
+            Writer.Write(Bytes);
+        }
+
+        private static void WriteColor(BinaryWriter Writer, Chat.Color3 Color)
+        {
+            Writer.Write((byte) (Color?.R ?? 0));
+            Writer.Write((byte) (Color?.G ?? 0));
+            Writer.Write((byte) (Color?.B ?? 0));
+        }
+
+        private static void WriteVarint(BinaryWriter Writer, uint Value)
+        {
+            while (Value >= 0x80)
+            {
+                Writer.Write((byte) (Value | 0x80));
+                Value >>= 7;
+            }
+
+            Writer.Write((byte) Value);
+        }
+    }
+}
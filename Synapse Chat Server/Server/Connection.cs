@@ -0,0 +1,256 @@
+﻿using System;
+using System.Buffers;
+using System.Collections.Specialized;
+using System.Net;
+using System.Net.WebSockets;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Synapse_Chat_Server.Server
+{
+    public class MessageEventArgs : EventArgs
+    {
+        public MessageEventArgs(string Data)
+        {
+            this.Data = Data;
+        }
+
+        public string Data { get; }
+    }
+
+    public class CloseEventArgs : EventArgs
+    {
+        public CloseEventArgs(WebSocketCloseStatus? Code, string Reason)
+        {
+            this.Code = Code;
+            this.Reason = Reason;
+        }
+
+        /* Null when the connection dropped without a close frame */
+        public WebSocketCloseStatus? Code { get; }
+        public string Reason { get; }
+    }
+
+    /* One websocket session. ChatHost runs Receive as an async loop, messages are handed to OnMessage one at a time in
+       the order they arrive. Sends and the close are chained, System.Net.WebSockets allows a single send in flight */
+    public abstract class Connection
+    {
+        public const int ReceiveBufferSize = 4096;
+
+        /* Anything bigger is a protocol violation for chat, the client is closed instead of buffering it */
+        public const int MaxMessageSize = 64 * 1024;
+
+        /* How long a close waits for the client's close frame before the socket is aborted */
+        public static readonly TimeSpan CloseTimeout = TimeSpan.FromSeconds(5);
+
+        /* Sends waiting on the chain past either limit mean the client isn't reading, it is aborted rather than buffered */
+        public const int MaxPendingSends = 256;
+        public const long MaxPendingBytes = 4 * 1024 * 1024;
+
+        private WebSocket Socket;
+        private readonly object ChainLock = new object();
+        private Task Chain = Task.CompletedTask;
+        private int CloseQueued;
+        private int PendingSends;
+        private long PendingBytes;
+
+        public NameValueCollection QueryString { get; private set; }
+        public IPEndPoint UserEndPoint { get; private set; }
+        public WebSocketState ReadyState => Socket.State;
+
+        protected virtual void OnOpen() { }
+
+        protected virtual void OnMessage(MessageEventArgs e) { }
+
+        protected virtual void OnClose(CloseEventArgs e) { }
+
+        protected void Send(string Data)
+        {
+            Enqueue(() => SendText(Data), null, Data.Length);
+        }
+
+        protected void SendAsync(string Data, Action<bool> Completed)
+        {
+            Enqueue(() => SendText(Data), Completed, Data.Length);
+        }
+
+        protected void SendAsync(byte[] Data, Action<bool> Completed)
+        {
+            Enqueue(() => Socket.SendAsync(new ArraySegment<byte>(Data), WebSocketMessageType.Binary, true, CancellationToken.None), Completed, Data.Length);
+        }
+
+        /* Runs after everything queued before it has been written */
+        public void Close(WebSocketCloseStatus Status = WebSocketCloseStatus.NormalClosure)
+        {
+            if (Interlocked.Exchange(ref CloseQueued, 1) != 0) return;
+
+            Enqueue(async () =>
+            {
+                await Socket.CloseOutputAsync(Status, "", CancellationToken.None).ConfigureAwait(false);
+
+                var Closing = Socket;
+                _ = Task.Delay(CloseTimeout).ContinueWith(_ =>
+                {
+                    if (Closing.State != WebSocketState.Closed) Closing.Abort();
+                });
+            }, null, 0, true);
+        }
+
+        private async Task SendText(string Data)
+        {
+            /* Encoded into a pooled buffer, fan-out sends would otherwise allocate one array per recipient */
+            var Buffer = ArrayPool<byte>.Shared.Rent(Encoding.UTF8.GetMaxByteCount(Data.Length));
+            try
+            {
+                var Length = Encoding.UTF8.GetBytes(Data, 0, Data.Length, Buffer, 0);
+                await Socket.SendAsync(new ArraySegment<byte>(Buffer, 0, Length), WebSocketMessageType.Text, true, CancellationToken.None).ConfigureAwait(false);
+            }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(Buffer);
+            }
+        }
+
+        private void Enqueue(Func<Task> Operation, Action<bool> Completed, long Size, bool IsClose = false)
+        {
+            if (!IsClose)
+            {
+                var Bytes = Interlocked.Add(ref PendingBytes, Size);
+                if (Interlocked.Increment(ref PendingSends) > MaxPendingSends || Bytes > MaxPendingBytes)
+                {
+                    Interlocked.Decrement(ref PendingSends);
+                    Interlocked.Add(ref PendingBytes, -Size);
+
+                    /* Once aborted everything still chained finds the socket closed and is skipped */
+                    if (Socket.State != WebSocketState.Aborted)
+                    {
+                        Log.Warn($"{UserEndPoint} is over {MaxPendingSends} sends or {MaxPendingBytes} bytes behind, dropping the session.");
+                        Socket.Abort();
+                    }
+
+                    Completed?.Invoke(false);
+                    return;
+                }
+            }
+
+            lock (ChainLock)
+            {
+                Chain = Chain.ContinueWith(async _ =>
+                {
+                    if (!IsClose)
+                    {
+                        Interlocked.Decrement(ref PendingSends);
+                        Interlocked.Add(ref PendingBytes, -Size);
+                    }
+
+                    var Sent = false;
+                    try
+                    {
+                        var State = Socket.State;
+                        if (State == WebSocketState.Open || IsClose && State == WebSocketState.CloseReceived)
+                        {
+                            await Operation().ConfigureAwait(false);
+                            Sent = true;
+                        }
+                    }
+                    catch (Exception) { }
+
+                    Completed?.Invoke(Sent);
+                }, TaskScheduler.Default).Unwrap();
+            }
+        }
+
+        internal async Task Receive(WebSocket Socket, NameValueCollection QueryString, IPEndPoint UserEndPoint)
+        {
+            this.Socket = Socket;
+            this.QueryString = QueryString;
+            this.UserEndPoint = UserEndPoint;
+
+            var Buffer = ArrayPool<byte>.Shared.Rent(ReceiveBufferSize);
+            byte[] Message = null;
+            var Length = 0;
+
+            WebSocketCloseStatus? Status = null;
+            string Reason = null;
+
+            try
+            {
+                OnOpen();
+
+                while (Socket.State == WebSocketState.Open || Socket.State == WebSocketState.CloseSent)
+                {
+                    var Result = await Socket.ReceiveAsync(new ArraySegment<byte>(Buffer), CancellationToken.None).ConfigureAwait(false);
+
+                    if (Result.MessageType == WebSocketMessageType.Close)
+                    {
+                        Status = Result.CloseStatus;
+                        Reason = Result.CloseStatusDescription;
+                        Close();
+                        break;
+                    }
+
+                    /* Single frame messages are decoded straight out of the receive buffer */
+                    if (Result.EndOfMessage && Length == 0)
+                    {
+                        if (Result.MessageType == WebSocketMessageType.Text)
+                            OnMessage(new MessageEventArgs(Encoding.UTF8.GetString(Buffer, 0, Result.Count)));
+                        continue;
+                    }
+
+                    if (Length + Result.Count > MaxMessageSize)
+                    {
+                        Close(WebSocketCloseStatus.MessageTooBig);
+                        break;
+                    }
+
+                    if (Message == null || Message.Length < Length + Result.Count)
+                    {
+                        var Grown = ArrayPool<byte>.Shared.Rent(Math.Max(Length + Result.Count, ReceiveBufferSize * 2));
+                        if (Message != null)
+                        {
+                            System.Buffer.BlockCopy(Message, 0, Grown, 0, Length);
+                            ArrayPool<byte>.Shared.Return(Message);
+                        }
+                        Message = Grown;
+                    }
+
+                    System.Buffer.BlockCopy(Buffer, 0, Message, Length, Result.Count);
+                    Length += Result.Count;
+
+                    if (!Result.EndOfMessage) continue;
+
+                    if (Result.MessageType == WebSocketMessageType.Text)
+                        OnMessage(new MessageEventArgs(Encoding.UTF8.GetString(Message, 0, Length)));
+                    Length = 0;
+                }
+            }
+            catch (Exception Ex) when (Ex is WebSocketException || Ex is HttpListenerException || Ex is ObjectDisposedException) { }
+            catch (Exception Ex)
+            {
+                Log.Error($"Session from {UserEndPoint} failed: {Ex}");
+                Socket.Abort();
+            }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(Buffer);
+                if (Message != null) ArrayPool<byte>.Shared.Return(Message);
+            }
+
+            try
+            {
+                OnClose(new CloseEventArgs(Status, Reason));
+            }
+            catch (Exception Ex)
+            {
+                Log.Error($"OnClose for {UserEndPoint} failed: {Ex}");
+            }
+
+            Task Pending;
+            lock (ChainLock) Pending = Chain;
+
+            await Pending.ConfigureAwait(false);
+            Socket.Dispose();
+        }
+    }
+}
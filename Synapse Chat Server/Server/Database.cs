@@ -1,11 +1,15 @@
 ﻿using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.Drawing;
 using System.IO;
 using System.Linq;
 using System.Text;
+using System.Threading;
 using System.Threading.Tasks;
 using Newtonsoft.Json;
+using Newtonsoft.Json.Linq;
 
 namespace Synapse_Chat_Server.Server
 {
@@ -28,81 +32,236 @@ namespace Synapse_Chat_Server.Server
 
         public class SynDB
         {
-            public Dictionary<string, long> Bans;
-            public Dictionary<string, long> Mutes;
-            public Dictionary<string, string> BanMessages;
-            public Dictionary<string, Chat.Color3> UserColors;
-            public Dictionary<string, StaffRank> UserRanks;
+            public ConcurrentDictionary<string, long> Bans;
+            public ConcurrentDictionary<string, long> Mutes;
+            public ConcurrentDictionary<string, string> BanMessages;
+            public ConcurrentDictionary<string, Chat.Color3> UserColors;
+            public ConcurrentDictionary<string, StaffRank> UserRanks;
         }
 
+        /* One change to one table, Value null is a removal. Replaying these over db.json gives the current state */
+        private class Change
+        {
+            public string Table;
+            public string Key;
+            public JToken Value;
+        }
+
+        private const string DbPath = "db.json";
+        private const string JournalPath = "db.journal";
+        private const int CompactAfter = 1000;
+        private const int SweepInterval = 30 * 1000;
+
         private static SynDB CurrentDB;
 
+        /* The tables are concurrent so lookups from the message threads take no lock. Writers still take DbLock, so the
+           journal sees changes in the order they were applied */
+        private static readonly object DbLock = new object();
+        private static Timer ExpirySweep;
+        private static readonly BlockingCollection<string> PendingChanges = new BlockingCollection<string>();
+        private static int JournalLength;
+
         public static void LoadDb()
         {
-            if (!File.Exists("db.json"))
+            if (!File.Exists(DbPath))
             {
-                CurrentDB = new SynDB { Bans = new Dictionary<string, long>(), Mutes = new Dictionary<string, long>(), BanMessages = new Dictionary<string, string>(), UserColors = new Dictionary<string, Chat.Color3>(), UserRanks = new Dictionary<string, StaffRank>()};
-                File.WriteAllText("db.json", JsonConvert.SerializeObject(CurrentDB));
+                CurrentDB = new SynDB { Bans = new ConcurrentDictionary<string, long>(), Mutes = new ConcurrentDictionary<string, long>(), BanMessages = new ConcurrentDictionary<string, string>(), UserColors = new ConcurrentDictionary<string, Chat.Color3>(), UserRanks = new ConcurrentDictionary<string, StaffRank>()};
+                File.WriteAllText(DbPath, JsonConvert.SerializeObject(CurrentDB));
+            }
+
+            CurrentDB = JsonConvert.DeserializeObject<SynDB>(File.ReadAllText(DbPath));
+
+            if (File.Exists(JournalPath))
+            {
+                foreach (var Line in File.ReadLines(JournalPath))
+                {
+                    Change Entry;
+                    try
+                    {
+                        Entry = JsonConvert.DeserializeObject<Change>(Line);
+                    }
+                    catch (JsonException)
+                    {
+                        /* Torn final write from a crash, everything before it is intact */
+                        break;
+                    }
+
+                    if (Entry == null) continue;
+                    Replay(Entry);
+                    JournalLength++;
+                }
             }
 
-            CurrentDB = JsonConvert.DeserializeObject<SynDB>(File.ReadAllText("db.json"));
+            if (JournalLength > 0) SaveDb();
+
+            new Thread(JournalWriter) { IsBackground = true }.Start();
+            ExpirySweep = new Timer(_ => SweepExpired(), null, 0, SweepInterval);
         }
 
+        /* Lifts timed bans and mutes once they run out, so the checks on the message path never have to write */
+        private static void SweepExpired()
+        {
+            var Now = DateTimeOffset.UtcNow.ToUnixTimeSeconds();
+
+            lock (DbLock)
+            {
+                foreach (var Ban in CurrentDB.Bans.Where(Ban => Ban.Value != 1 && Ban.Value <= Now).ToList())
+                {
+                    Unset(CurrentDB.Bans, nameof(SynDB.Bans), Ban.Key);
+                    Unset(CurrentDB.BanMessages, nameof(SynDB.BanMessages), Ban.Key);
+                }
+
+                foreach (var Mute in CurrentDB.Mutes.Where(Mute => Mute.Value <= Now).ToList())
+                    Unset(CurrentDB.Mutes, nameof(SynDB.Mutes), Mute.Key);
+            }
+        }
+
+        /* Folds everything into a fresh db.json and empties the journal. Only the journal writer (or LoadDb, before it
+           starts) calls this, so nothing is appended while the journal is being reset */
         public static void SaveDb()
         {
-            File.WriteAllText("db.json", JsonConvert.SerializeObject(CurrentDB));
+            var Started = Stopwatch.GetTimestamp();
+            var Snapshot = JsonConvert.SerializeObject(CurrentDB);
+
+            File.WriteAllText(DbPath + ".tmp", Snapshot);
+            File.Replace(DbPath + ".tmp", DbPath, null);
+
+            /* Changes still queued were made before the snapshot or after it, replaying them again is harmless */
+            File.WriteAllText(JournalPath, "");
+            JournalLength = 0;
+
+            Metrics.DbSaves.Inc();
+            Metrics.DbSaveSeconds.ObserveSince(Started);
+        }
+
+        /* Appends whatever has queued up in one write, and compacts once the journal has grown long enough */
+        private static void JournalWriter()
+        {
+            foreach (var First in PendingChanges.GetConsumingEnumerable())
+            {
+                try
+                {
+                    using (var Writer = new StreamWriter(JournalPath, true))
+                    {
+                        Writer.WriteLine(First);
+                        JournalLength++;
+
+                        while (PendingChanges.TryTake(out var Next))
+                        {
+                            Writer.WriteLine(Next);
+                            JournalLength++;
+                        }
+                    }
+
+                    if (JournalLength >= CompactAfter) SaveDb();
+                }
+                catch (Exception Ex)
+                {
+                    Console.WriteLine($"Failed to write database journal: {Ex.Message}");
+                }
+            }
+        }
+
+        private static void Journal(string Table, string Key, object Value)
+        {
+            var Line = JsonConvert.SerializeObject(new Change
+            {
+                Table = Table,
+                Key = Key,
+                Value = Value == null ? null : JToken.FromObject(Value)
+            });
+
+            PendingChanges.Add(Line);
+            Backplane.PublishChange(Line);
+        }
+
+        /* A change another node made, see Backplane. Journaled here too so it survives a restart, but not republished */
+        public static void ApplyRemote(string Line)
+        {
+            var Entry = JsonConvert.DeserializeObject<Change>(Line);
+
+            lock (DbLock)
+            {
+                Replay(Entry);
+                PendingChanges.Add(Line);
+            }
+        }
+
+        private static void Set<T>(ConcurrentDictionary<string, T> Table, string Name, string Key, T Value)
+        {
+            Table[Key] = Value;
+            Journal(Name, Key, Value);
+        }
+
+        private static void Unset<T>(ConcurrentDictionary<string, T> Table, string Name, string Key)
+        {
+            if (Table.TryRemove(Key, out _)) Journal(Name, Key, null);
         }
 
+        private static void Replay(Change Entry)
+        {
+            switch (Entry.Table)
+            {
+                case nameof(SynDB.Bans):
+                    Replay(CurrentDB.Bans, Entry);
+                    break;
+                case nameof(SynDB.Mutes):
+                    Replay(CurrentDB.Mutes, Entry);
+                    break;
+                case nameof(SynDB.BanMessages):
+                    Replay(CurrentDB.BanMessages, Entry);
+                    break;
+                case nameof(SynDB.UserColors):
+                    Replay(CurrentDB.UserColors, Entry);
+                    break;
+                case nameof(SynDB.UserRanks):
+                    Replay(CurrentDB.UserRanks, Entry);
+                    break;
+            }
+        }
+
+        private static void Replay<T>(ConcurrentDictionary<string, T> Table, Change Entry)
+        {
+            if (Entry.Value == null || Entry.Value.Type == JTokenType.Null) Table.TryRemove(Entry.Key, out _);
+            else Table[Entry.Key] = Entry.Value.ToObject<T>();
+        }
+
+        /* 1 is permanent, anything else is the unix time the ban ends (SweepExpired removes it after that) */
         public static bool IsBanned(string Username)
         {
-            if (!CurrentDB.Bans.ContainsKey(Username)) return false;
+            if (!CurrentDB.Bans.TryGetValue(Username, out var Until)) return false;
 
-            if (CurrentDB.Bans[Username] == 1) return true;
-            if (CurrentDB.Bans[Username] <= DateTimeOffset.UtcNow.ToUnixTimeSeconds()) return true;
-            CurrentDB.Bans.Remove(Username);
-            CurrentDB.BanMessages.Remove(Username);
-            SaveDb();
-            return false;
+            return Until == 1 || Until > DateTimeOffset.UtcNow.ToUnixTimeSeconds();
         }
 
         public static bool IsMuted(string Username)
         {
-            if (!CurrentDB.Mutes.ContainsKey(Username)) return false;
-            
-            if (CurrentDB.Mutes[Username] <= DateTimeOffset.UtcNow.ToUnixTimeSeconds()) return true;
-            CurrentDB.Mutes.Remove(Username);
-            SaveDb();
-            return false;
+            if (!CurrentDB.Mutes.TryGetValue(Username, out var Until)) return false;
+
+            return Until > DateTimeOffset.UtcNow.ToUnixTimeSeconds();
         }
 
         public static Chat.Color3 GetColor(string Username)
         {
-            return !CurrentDB.UserColors.ContainsKey(Username) ? new Chat.Color3(Color.Orange) : CurrentDB.UserColors[Username];
+            return CurrentDB.UserColors.TryGetValue(Username, out var UserColor) ? UserColor : new Chat.Color3(Color.Orange);
         }
 
         public static StaffRank GetRank(string Username)
         {
-            return !CurrentDB.UserRanks.ContainsKey(Username) ? StaffRank.User : CurrentDB.UserRanks[Username];
+            return CurrentDB.UserRanks.TryGetValue(Username, out var Rank) ? Rank : StaffRank.User;
         }
 
         public static void SetRank(string Username, StaffRank Rank)
         {
-            if (CurrentDB.UserRanks.ContainsKey(Username)) CurrentDB.UserRanks.Remove(Username);
-            CurrentDB.UserRanks.Add(Username, Rank);
-            SaveDb();
+            lock (DbLock) Set(CurrentDB.UserRanks, nameof(SynDB.UserRanks), Username, Rank);
         }
 
         public static PrefixData GetPrefix(string Username)
         {
-            if (!CurrentDB.UserRanks.ContainsKey(Username))
-                return new PrefixData
-                {
-                    HasPrefix = false,
-                    Prefix = "",
-                    Color = new Chat.Color3(Color.Black)
-                };
+            /* No entry gets the same empty prefix as StaffRank.User */
+            var Rank = GetRank(Username);
 
-            switch (CurrentDB.UserRanks[Username])
+            switch (Rank)
             {
                 case StaffRank.User:
                 {
@@ -158,47 +317,43 @@ namespace Synapse_Chat_Server.Server
 
         public static void AddColor(string Username, Chat.Color3 NewColor)
         {
-            if (CurrentDB.UserColors.ContainsKey(Username)) CurrentDB.UserColors.Remove(Username);
-            CurrentDB.UserColors.Add(Username, NewColor);
-            SaveDb();
+            lock (DbLock) Set(CurrentDB.UserColors, nameof(SynDB.UserColors), Username, NewColor);
         }
 
         public static string GetBanMessage(string Username)
         {
-            return CurrentDB.BanMessages[Username];
+            return CurrentDB.BanMessages.TryGetValue(Username, out var Message) ? Message : "";
         }
 
         public static void MuteUser(string Username, long Minutes)
         {
-            if (CurrentDB.Mutes.ContainsKey(Username)) CurrentDB.Mutes.Remove(Username);
-            CurrentDB.Mutes.Add(Username, DateTimeOffset.UtcNow.ToUnixTimeSeconds() + Minutes * 60);
-
-            SaveDb();
+            lock (DbLock) Set(CurrentDB.Mutes, nameof(SynDB.Mutes), Username, DateTimeOffset.UtcNow.ToUnixTimeSeconds() + Minutes * 60);
         }
 
         public static void BanUser(string Username, long Minutes, string Reason = "")
         {
-            if (CurrentDB.Bans.ContainsKey(Username)) CurrentDB.Bans.Remove(Username);
-            if (CurrentDB.BanMessages.ContainsKey(Username)) CurrentDB.BanMessages.Remove(Username);
-
-            if (Minutes == 0)
+            lock (DbLock)
             {
-                CurrentDB.Bans.Add(Username, 1);
-            }
-            else
-            {
-                CurrentDB.Bans.Add(Username, DateTimeOffset.UtcNow.ToUnixTimeSeconds() + Minutes * 60);
-            }
+                if (Minutes == 0)
+                {
+                    Set(CurrentDB.Bans, nameof(SynDB.Bans), Username, 1L);
+                }
+                else
+                {
+                    Set(CurrentDB.Bans, nameof(SynDB.Bans), Username, DateTimeOffset.UtcNow.ToUnixTimeSeconds() + Minutes * 60);
+                }
 
-            CurrentDB.BanMessages.Add(Username, Reason);
-            SaveDb();
+                Set(CurrentDB.BanMessages, nameof(SynDB.BanMessages), Username, Reason);
+            }
         }
 
         public static void UnbanUser(string Username)
         {
-            if (CurrentDB.Bans.ContainsKey(Username)) CurrentDB.Bans.Remove(Username);
-            if (CurrentDB.BanMessages.ContainsKey(Username)) CurrentDB.BanMessages.Remove(Username);
-            SaveDb();
+            lock (DbLock)
+            {
+                Unset(CurrentDB.Bans, nameof(SynDB.Bans), Username);
+                Unset(CurrentDB.BanMessages, nameof(SynDB.BanMessages), Username);
+            }
         }
     }
 }
@@ -1,47 +1,87 @@
 ﻿using System;
-using System.Collections.Generic;
-using System.Drawing;
+using System.Collections.Concurrent;
+using System.Diagnostics;
 using System.Linq;
-using System.Text;
-using System.Threading.Tasks;
-using Newtonsoft.Json;
+using System.Threading;
 
 namespace Synapse_Chat_Server.Server
 {
     public static class Filter
     {
-        public static Dictionary<string, string> LastMessage = new Dictionary<string, string>();
-        public static Dictionary<string, long> LastMessageTimes = new Dictionary<string, long>();
+        /* A token bucket for rate and the hashes of the last few messages for repeats, a fixed size per user */
+        private class UserState
+        {
+            public double Tokens = BurstSize;
+            public long LastRefill;
+            public long LastSeen;
+            public readonly ulong[] Recent = new ulong[HistorySize];
+            public int NextRecent;
+        }
+
+        private const double BurstSize = 3;
+        private const double RefillPerSecond = 1;
+        private const int HistorySize = 4;
+        private const long IdleEviction = 10 * 60 * 1000;
+
+        private static readonly ConcurrentDictionary<string, UserState> Users = new ConcurrentDictionary<string, UserState>();
+        private static readonly Stopwatch Clock = Stopwatch.StartNew();
+        private static readonly Timer Evictor = new Timer(_ => Evict(), null, 60 * 1000, 60 * 1000);
 
         public static bool Process(Chat Parent, string Message)
         {
-            if (!LastMessageTimes.ContainsKey(Parent.Username))
-            {
-                LastMessageTimes.Add(Parent.Username, DateTimeOffset.UtcNow.ToUnixTimeSeconds());
-            }
-            else
+            var Now = Clock.ElapsedMilliseconds;
+            var State = Users.GetOrAdd(Parent.Username, _ => new UserState { LastRefill = Now });
+            var Hash = HashMessage(Message);
+
+            lock (State)
             {
-                if (LastMessageTimes[Parent.Username] >= DateTimeOffset.UtcNow.ToUnixTimeSeconds())
-                    return true;
+                State.LastSeen = Now;
 
-                LastMessageTimes[Parent.Username] = DateTimeOffset.UtcNow.ToUnixTimeSeconds() + 1;
-            }
+                State.Tokens = Math.Min(BurstSize, State.Tokens + (Now - State.LastRefill) * RefillPerSecond / 1000);
+                State.LastRefill = Now;
 
-            if (!LastMessage.ContainsKey(Parent.Username))
-            {
-                LastMessage.Add(Parent.Username, Message);
+                if (State.Tokens < 1) return true;
+                if (State.Recent.Contains(Hash)) return true;
+
+                State.Tokens -= 1;
+                State.Recent[State.NextRecent] = Hash;
+                State.NextRecent = (State.NextRecent + 1) % HistorySize;
             }
-            else
+
+            return false;
+        }
+
+        /* FNV-1a over the message folded to lower case letters and digits with repeated characters collapsed, so
+           "Hello!!", "hello" and "heeello" all count as the same message */
+        private static ulong HashMessage(string Message)
+        {
+            var Hash = 14695981039346656037UL;
+            var Previous = '\0';
+
+            foreach (var Raw in Message)
             {
-                if (LastMessage[Parent.Username] == Message)
-                {
-                    return true;
-                }
+                if (!char.IsLetterOrDigit(Raw)) continue;
+
+                var Char = char.ToLowerInvariant(Raw);
+                if (Char == Previous) continue;
+                Previous = Char;
 
-                LastMessage[Parent.Username] = Message;
+                Hash ^= Char;
+                Hash *= 1099511628211UL;
             }
 
-            return false;
+            /* Leaves 0 for empty slots in Recent */
+            return Hash == 0 ? 1 : Hash;
+        }
+
+        private static void Evict()
+        {
+            var Cutoff = Clock.ElapsedMilliseconds - IdleEviction;
+
+            foreach (var User in Users)
+            {
+                if (User.Value.LastSeen < Cutoff) Users.TryRemove(User.Key, out _);
+            }
         }
     }
 }
@@ -0,0 +1,84 @@
+﻿using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Linq;
+
+namespace Synapse_Chat_Server.Server
+{
+    /* The last Capacity messages of every channel, kept as the payloads that were delivered so a session joining a
+       channel can be caught up in one frame (see Chat.Replay) without anything being serialized again. Filled from
+       DeliverLocal, so every node keeps its own copy of each channel including the messages sent from other nodes */
+    public static class History
+    {
+        public struct Entry
+        {
+            public string Json;
+            public CompactMessage Message;
+        }
+
+        private class Ring
+        {
+            public readonly Entry[] Entries = new Entry[Capacity];
+            public int Next;
+            public int Count;
+            public DateTime LastWrite;
+        }
+
+        public const int Capacity = 50;
+
+        /* Channels nobody has written to for this long are swept out once there are SweepThreshold of them, servers
+           and places come and go so their channels would otherwise pile up */
+        public static TimeSpan IdleTtl = TimeSpan.FromMinutes(10);
+        private const int SweepThreshold = 4096;
+
+        private static readonly ConcurrentDictionary<(Route, string, string), Ring> Channels = new ConcurrentDictionary<(Route, string, string), Ring>();
+        private static DateTime NextSweep;
+
+        /* A party has a single channel, it is keyed by the party id alone so Forget can find it */
+        private static (Route, string, string) KeyOf(Route Route, string Key, string Channel)
+        {
+            return Route == Route.Party ? (Route, Key, null) : (Route, Key, Channel);
+        }
+
+        public static void Record(Route Route, string Key, string Channel, string Json, CompactMessage Message)
+        {
+            var Now = DateTime.UtcNow;
+            var Ring = Channels.GetOrAdd(KeyOf(Route, Key, Channel), _ => new Ring());
+
+            lock (Ring)
+            {
+                Ring.Entries[Ring.Next] = new Entry { Json = Json, Message = Message };
+                Ring.Next = (Ring.Next + 1) % Capacity;
+                Ring.Count = Math.Min(Ring.Count + 1, Capacity);
+                Ring.LastWrite = Now;
+            }
+
+            if (Channels.Count >= SweepThreshold && Now >= NextSweep) Sweep(Now);
+        }
+
+        /* Appends the channel's messages oldest first */
+        public static void Collect(Route Route, string Key, string Channel, List<Entry> Into)
+        {
+            if (!Channels.TryGetValue(KeyOf(Route, Key, Channel), out var Ring)) return;
+
+            lock (Ring)
+            {
+                var First = (Ring.Next - Ring.Count + Capacity) % Capacity;
+                for (var i = 0; i < Ring.Count; i++) Into.Add(Ring.Entries[(First + i) % Capacity]);
+            }
+        }
+
+        public static void Forget(Route Route, string Key)
+        {
+            Channels.TryRemove(KeyOf(Route, Key, null), out _);
+        }
+
+        private static void Sweep(DateTime Now)
+        {
+            NextSweep = Now + TimeSpan.FromMinutes(1);
+
+            foreach (var Pair in Channels.Where(Pair => Now - Pair.Value.LastWrite > IdleTtl).ToArray())
+                Channels.TryRemove(Pair.Key, out _);
+        }
+    }
+}
@@ -0,0 +1,33 @@
+﻿using System;
+
+namespace Synapse_Chat_Server.Server
+{
+    public enum LogLevel
+    {
+        Info,
+        Warn,
+        Error
+    }
+
+    /* Console log in the format websocket-sharp's logger used, lines below Level are dropped */
+    public static class Log
+    {
+        public static LogLevel Level = LogLevel.Info;
+
+        private static readonly object Lock = new object();
+
+        public static void Info(string Message) => Write(LogLevel.Info, Message);
+
+        public static void Warn(string Message) => Write(LogLevel.Warn, Message);
+
+        public static void Error(string Message) => Write(LogLevel.Error, Message);
+
+        private static void Write(LogLevel MessageLevel, string Message)
+        {
+            if (MessageLevel < Level) return;
+
+            var Line = $"{DateTime.Now:yyyy/MM/dd HH:mm:ss}|{MessageLevel.ToString().ToUpper(),-5}|{Message}";
+            lock (Lock) Console.WriteLine(Line);
+        }
+    }
+}
@@ -0,0 +1,213 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Globalization;
+using System.Linq;
+using System.Net;
+using System.Text;
+using System.Threading;
+
+namespace Synapse_Chat_Server.Server
+{
+    /* Process wide counters, gauges and histograms, served in the Prometheus text format on Path next to the chat
+       socket. Updates are a few interlocked operations, everything is only formatted when something scrapes */
+    public static class Metrics
+    {
+        public const string Path = "/metrics";
+
+        /* Scrapes are only answered from this machine unless set, the numbers say a fair bit about the users */
+        public static bool AllowRemote;
+
+        private static readonly double[] LatencyBuckets = { 0.001, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10 };
+        private static readonly double[] FanOutBuckets = { 0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1 };
+
+        public abstract class Series
+        {
+            public string Labels;
+
+            public abstract void Write(StringBuilder Out, string Name);
+
+            protected static string Key(string Name, string Labels, string Extra = null)
+            {
+                if (Labels == null && Extra == null) return Name;
+                return $"{Name}{{{string.Join(",", new[] { Labels, Extra }.Where(Label => Label != null))}}}";
+            }
+
+            protected static string Number(double Value)
+            {
+                return double.IsPositiveInfinity(Value) ? "+Inf" : Value.ToString("R", CultureInfo.InvariantCulture);
+            }
+        }
+
+        public class Counter : Series
+        {
+            private long Value;
+
+            public void Inc(long By = 1) => Interlocked.Add(ref Value, By);
+
+            public override void Write(StringBuilder Out, string Name)
+            {
+                Out.Append(Key(Name, Labels)).Append(' ').Append(Interlocked.Read(ref Value)).Append('\n');
+            }
+        }
+
+        public class Gauge : Series
+        {
+            public Func<double> Read;
+
+            public override void Write(StringBuilder Out, string Name)
+            {
+                Out.Append(Key(Name, Labels)).Append(' ').Append(Number(Read())).Append('\n');
+            }
+        }
+
+        /* Buckets are counted on their own and summed up when written, Observe touches exactly one of them */
+        public class Histogram : Series
+        {
+            private readonly double[] Bounds;
+            private readonly long[] Buckets;
+            private long Count;
+            private long SumTicks;
+
+            public Histogram(double[] Bounds)
+            {
+                this.Bounds = Bounds;
+                Buckets = new long[Bounds.Length + 1];
+            }
+
+            public void Observe(double Seconds)
+            {
+                var Bucket = Array.BinarySearch(Bounds, Seconds);
+                if (Bucket < 0) Bucket = ~Bucket;
+
+                Interlocked.Increment(ref Buckets[Bucket]);
+                Interlocked.Increment(ref Count);
+                Interlocked.Add(ref SumTicks, (long) (Seconds * TimeSpan.TicksPerSecond));
+            }
+
+            /* Start is a Stopwatch.GetTimestamp() */
+            public void ObserveSince(long Start)
+            {
+                Observe((Stopwatch.GetTimestamp() - Start) / (double) Stopwatch.Frequency);
+            }
+
+            public override void Write(StringBuilder Out, string Name)
+            {
+                long Cumulative = 0;
+                for (var i = 0; i < Buckets.Length; i++)
+                {
+                    Cumulative += Interlocked.Read(ref Buckets[i]);
+                    var Bound = i < Bounds.Length ? Bounds[i] : double.PositiveInfinity;
+                    Out.Append(Key(Name + "_bucket", Labels, $"le=\"{Number(Bound)}\"")).Append(' ').Append(Cumulative).Append('\n');
+                }
+
+                Out.Append(Key(Name + "_sum", Labels)).Append(' ').Append(Number(Interlocked.Read(ref SumTicks) / (double) TimeSpan.TicksPerSecond)).Append('\n');
+                Out.Append(Key(Name + "_count", Labels)).Append(' ').Append(Interlocked.Read(ref Count)).Append('\n');
+            }
+        }
+
+        private class Family
+        {
+            public string Name;
+            public string Help;
+            public string Type;
+            public readonly List<Series> Members = new List<Series>();
+        }
+
+        private static readonly object Lock = new object();
+        private static readonly List<Family> Families = new List<Family>();
+
+        private static T Register<T>(string Name, string Help, string Type, string Labels, T Member) where T : Series
+        {
+            Member.Labels = Labels;
+
+            lock (Lock)
+            {
+                var Found = Families.FirstOrDefault(F => F.Name == Name);
+                if (Found == null)
+                {
+                    Found = new Family { Name = Name, Help = Help, Type = Type };
+                    Families.Add(Found);
+                }
+
+                Found.Members.Add(Member);
+            }
+
+            return Member;
+        }
+
+        /* One series per channel type, indexed by Route */
+        private static T[] PerRoute<T>(Func<string, T> Create)
+        {
+            return Enum.GetValues(typeof(Route)).Cast<Route>().Select(R => Create($"route=\"{R.ToString().ToLowerInvariant()}\"")).ToArray();
+        }
+
+        public static readonly Counter ConnectionsOpened = Register("chat_connections_opened_total", "Websocket sessions accepted.", "counter", null, new Counter());
+        public static readonly Counter ProtocolFailures = Register("chat_protocol_failures_total", "Sessions closed for a malformed handshake or request.", "counter", null, new Counter());
+
+        public static readonly Histogram AuthSeconds = Register("chat_auth_seconds", "Time from connect to the HWID lookup finishing.", "histogram", null, new Histogram(LatencyBuckets));
+        public static readonly Counter AuthSucceeded = Register("chat_auth_total", "Authentication attempts by result.", "counter", "result=\"success\"", new Counter());
+        public static readonly Counter AuthRejected = Register("chat_auth_total", "Authentication attempts by result.", "counter", "result=\"rejected\"", new Counter());
+        public static readonly Counter AuthUnreachable = Register("chat_auth_total", "Authentication attempts by result.", "counter", "result=\"unreachable\"", new Counter());
+
+        public static readonly Counter MessagesReceived = Register("chat_messages_received_total", "Requests read from authenticated sessions.", "counter", null, new Counter());
+        public static readonly Counter FramesQueued = Register("chat_frames_queued_total", "Frames queued to sessions, fan-out included.", "counter", null, new Counter());
+        public static readonly Counter OverflowDropped = Register("chat_send_overflow_total", "Sends past the queue limit by outcome.", "counter", "outcome=\"dropped\"", new Counter());
+        public static readonly Counter OverflowDisconnected = Register("chat_send_overflow_total", "Sends past the queue limit by outcome.", "counter", "outcome=\"disconnected\"", new Counter());
+
+        public static readonly Histogram[] BroadcastSeconds = PerRoute(Labels => Register("chat_broadcast_seconds", "Time to queue one payload to every local target, by channel type.", "histogram", Labels, new Histogram(FanOutBuckets)));
+        public static readonly Counter[] BroadcastRecipients = PerRoute(Labels => Register("chat_broadcast_recipients_total", "Local sessions payloads were queued to, by channel type.", "counter", Labels, new Counter()));
+
+        public static readonly Counter CommandsRun = Register("chat_commands_total", "Requests handled as commands.", "counter", null, new Counter());
+        public static readonly Histogram CommandSeconds = Register("chat_command_seconds", "Time spent in Commands.Process for requests starting with a slash.", "histogram", null, new Histogram(LatencyBuckets));
+
+        public static readonly Counter DbSaves = Register("chat_db_saves_total", "db.json compactions.", "counter", null, new Counter());
+        public static readonly Histogram DbSaveSeconds = Register("chat_db_save_seconds", "Time to snapshot and replace db.json.", "histogram", null, new Histogram(LatencyBuckets));
+
+        static Metrics()
+        {
+            Register("chat_connections", "Sessions connected to this node.", "gauge", null, new Gauge { Read = () => Chat.Host?.Count ?? 0 });
+            Register("chat_send_queue_depth", "Frames waiting in session send queues.", "gauge", null, new Gauge { Read = () => Chat.Host?.Sessions.Sum(Session => Session.QueueDepth) ?? 0 });
+            Register("chat_send_queue_max", "Deepest session send queue.", "gauge", null, new Gauge { Read = () => Chat.Host?.Sessions.Select(Session => Session.QueueDepth).DefaultIfEmpty(0).Max() ?? 0 });
+        }
+
+        public static string Render()
+        {
+            var Out = new StringBuilder();
+
+            lock (Lock)
+            {
+                foreach (var F in Families)
+                {
+                    Out.Append("# HELP ").Append(F.Name).Append(' ').Append(F.Help).Append('\n');
+                    Out.Append("# TYPE ").Append(F.Name).Append(' ').Append(F.Type).Append('\n');
+                    foreach (var Member in F.Members) Member.Write(Out, F.Name);
+                }
+            }
+
+            return Out.ToString();
+        }
+
+        /* Answers a scrape on the listener the sessions come in on */
+        public static void Serve(HttpListenerContext Context)
+        {
+            try
+            {
+                if (!AllowRemote && !Context.Request.IsLocal)
+                {
+                    Context.Response.StatusCode = 403;
+                    return;
+                }
+
+                var Body = Encoding.UTF8.GetBytes(Render());
+                Context.Response.ContentType = "text/plain; version=0.0.4; charset=utf-8";
+                Context.Response.ContentLength64 = Body.Length;
+                Context.Response.OutputStream.Write(Body, 0, Body.Length);
+            }
+            finally
+            {
+                Context.Response.Close();
+            }
+        }
+    }
+}
@@ -0,0 +1,61 @@
+﻿using System.Collections.Generic;
+using System.Linq;
+
+namespace Synapse_Chat_Server.Server
+{
+    /* Sessions grouped by one key (place, game, party or username), so a send only visits the sessions it is addressed
+       to rather than every connected client. Chat keeps these current as its fields change */
+    public class SessionIndex<TKey>
+    {
+        private static readonly Chat[] None = new Chat[0];
+
+        private readonly object Lock = new object();
+        private readonly Dictionary<TKey, HashSet<Chat>> Groups = new Dictionary<TKey, HashSet<Chat>>();
+
+        public void Add(TKey Key, Chat Session)
+        {
+            if (Key == null) return;
+
+            lock (Lock)
+            {
+                if (!Groups.TryGetValue(Key, out var Group))
+                    Groups[Key] = Group = new HashSet<Chat>();
+
+                Group.Add(Session);
+            }
+        }
+
+        public void Remove(TKey Key, Chat Session)
+        {
+            if (Key == null) return;
+
+            lock (Lock)
+            {
+                if (!Groups.TryGetValue(Key, out var Group)) return;
+
+                Group.Remove(Session);
+                if (Group.Count == 0) Groups.Remove(Key);
+            }
+        }
+
+        public void Move(TKey From, TKey To, Chat Session)
+        {
+            lock (Lock)
+            {
+                Remove(From, Session);
+                Add(To, Session);
+            }
+        }
+
+        /* A copy, so sends (and closes) can happen outside the lock and may change the index themselves */
+        public Chat[] Members(TKey Key)
+        {
+            if (Key == null) return None;
+
+            lock (Lock)
+            {
+                return Groups.TryGetValue(Key, out var Group) ? Group.ToArray() : None;
+            }
+        }
+    }
+}
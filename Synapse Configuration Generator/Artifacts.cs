@@ -0,0 +1,125 @@
+﻿using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Newtonsoft.Json;
+
+namespace Synapse_Configuration_Generator
+{
+    /* Hashing and release bookkeeping for the artifacts the manifests point at */
+    public static class Artifacts
+    {
+        private const string HashCacheFile = "hashes.json";
+        private const string ReleasesFolder = "releases";
+        private const string PatchesFolder = "patches";
+
+        /* Patches that don't save at least a quarter of the full download aren't worth the extra request */
+        private const double MaxPatchRatio = 0.75;
+
+        [Serializable]
+        public class CachedHash
+        {
+            public long Size;
+            public long Modified;
+            public string Hash;
+        }
+
+        private static ConcurrentDictionary<string, CachedHash> Cache;
+
+        /* SHA-512 of every path at once. A file with the same size and write time as last compile isn't read again */
+        public static Dictionary<string, string> Hash(IEnumerable<string> Paths)
+        {
+            LoadCache();
+
+            var Distinct = Paths.Where(P => !string.IsNullOrEmpty(P)).Distinct(StringComparer.OrdinalIgnoreCase).ToList();
+            var Hashes = new ConcurrentDictionary<string, string>(StringComparer.OrdinalIgnoreCase);
+
+            Parallel.ForEach(Distinct, Path =>
+            {
+                var Info = new FileInfo(Path);
+                var Key = Info.FullName.ToLowerInvariant();
+
+                if (!Info.Exists) throw new FileNotFoundException("Artifact not found.", Path);
+
+                if (!Cache.TryGetValue(Key, out var Entry) || Entry.Size != Info.Length || Entry.Modified != Info.LastWriteTimeUtc.Ticks)
+                {
+                    Entry = new CachedHash { Size = Info.Length, Modified = Info.LastWriteTimeUtc.Ticks, Hash = Maker.Sha512(Path, true) };
+                    Cache[Key] = Entry;
+                }
+
+                Hashes[Path] = Entry.Hash;
+            });
+
+            File.WriteAllText(HashCacheFile, JsonConvert.SerializeObject(Cache));
+            return new Dictionary<string, string>(Hashes, StringComparer.OrdinalIgnoreCase);
+        }
+
+        /* Keeps a copy of every artifact under its hash and writes patches\<old>.<new>.patch from the previous release of
+           each one that changed, so a client holding the old file can fetch the patch by name instead of the full body.
+           Returns how many patches were written */
+        public static int Release(IEnumerable<Tuple<string, string, string>> Changes)
+        {
+            Directory.CreateDirectory(ReleasesFolder);
+            Directory.CreateDirectory(PatchesFolder);
+
+            var Written = 0;
+
+            Parallel.ForEach(Changes, Change =>
+            {
+                var Path = Change.Item1;
+                var OldHash = Change.Item2;
+                var NewHash = Change.Item3;
+
+                if (string.IsNullOrEmpty(NewHash)) return;
+
+                var NewRelease = ReleasePath(NewHash);
+                if (!File.Exists(NewRelease)) File.Copy(Path, NewRelease);
+
+                if (string.IsNullOrEmpty(OldHash) || OldHash == NewHash) return;
+
+                var OldRelease = ReleasePath(OldHash);
+                var PatchPath = System.IO.Path.Combine(PatchesFolder, OldHash.ToLowerInvariant() + "." + NewHash.ToLowerInvariant() + ".patch");
+                if (!File.Exists(OldRelease) || File.Exists(PatchPath)) return;
+
+                var Old = File.ReadAllBytes(OldRelease);
+                var New = File.ReadAllBytes(NewRelease);
+                var Patch = Delta.Create(Old, New);
+
+                if (Patch.Length > New.Length * MaxPatchRatio) return;
+                if (!Delta.Apply(Old, Patch).SequenceEqual(New))
+                    throw new InvalidDataException("Patch for " + Path + " doesn't reproduce it.");
+
+                File.WriteAllBytes(PatchPath, Patch);
+                Interlocked.Increment(ref Written);
+            });
+
+            return Written;
+        }
+
+        private static string ReleasePath(string Hash)
+        {
+            return System.IO.Path.Combine(ReleasesFolder, Hash.ToLowerInvariant());
+        }
+
+        private static void LoadCache()
+        {
+            if (Cache != null) return;
+
+            Cache = new ConcurrentDictionary<string, CachedHash>();
+            if (!File.Exists(HashCacheFile)) return;
+
+            try
+            {
+                var Saved = JsonConvert.DeserializeObject<Dictionary<string, CachedHash>>(File.ReadAllText(HashCacheFile));
+                foreach (var Entry in Saved) Cache[Entry.Key] = Entry.Value;
+            }
+            catch (Exception)
+            {
+                /* Rebuilt by the next compile */
+            }
+        }
+    }
+}
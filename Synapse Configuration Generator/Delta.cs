@@ -0,0 +1,170 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.Compression;
+using System.Text;
+
+namespace Synapse_Configuration_Generator
+{
+    /* Binary patches between two releases of an artifact. A patch is "SYNPATCH", the new length (int64) and a deflated
+       run of ops: 0 copies (offset, length) from the old file, 1 inserts (length) literal bytes. Lengths are 7-bit varints */
+    public static class Delta
+    {
+        private const int BlockSize = 64;
+        private const ulong Prime = 1099511628211;
+
+        private static readonly byte[] Magic = Encoding.ASCII.GetBytes("SYNPATCH");
+
+        public static byte[] Create(byte[] Old, byte[] New)
+        {
+            /* First offset of every aligned block in the old file, by rolling hash */
+            var Blocks = new Dictionary<ulong, int>();
+            for (var i = 0; i + BlockSize <= Old.Length; i += BlockSize)
+            {
+                var Key = HashBlock(Old, i);
+                if (!Blocks.ContainsKey(Key)) Blocks[Key] = i;
+            }
+
+            var Top = 1ul;
+            for (var i = 1; i < BlockSize; i++) Top *= Prime;
+
+            using (var Output = new MemoryStream())
+            {
+                Output.Write(Magic, 0, Magic.Length);
+                Output.Write(BitConverter.GetBytes((long) New.Length), 0, 8);
+
+                using (var Ops = new BinaryWriter(new DeflateStream(Output, CompressionLevel.Optimal, true)))
+                {
+                    var Literal = 0;
+                    var Position = 0;
+                    var Rolling = New.Length >= BlockSize ? HashBlock(New, 0) : 0;
+
+                    while (Position + BlockSize <= New.Length)
+                    {
+                        if (Blocks.TryGetValue(Rolling, out var Offset) && Same(Old, Offset, New, Position, BlockSize))
+                        {
+                            /* Grow the match both ways, backwards only into bytes that would otherwise be literal */
+                            var Start = Position;
+                            while (Start > Literal && Offset > 0 && Old[Offset - 1] == New[Start - 1])
+                            {
+                                Start--;
+                                Offset--;
+                            }
+
+                            var End = Position + BlockSize;
+                            var OldEnd = Offset + (End - Start);
+                            while (End < New.Length && OldEnd < Old.Length && Old[OldEnd] == New[End])
+                            {
+                                End++;
+                                OldEnd++;
+                            }
+
+                            WriteLiteral(Ops, New, Literal, Start - Literal);
+
+                            Ops.Write((byte) 0);
+                            WriteVarint(Ops, Offset);
+                            WriteVarint(Ops, End - Start);
+
+                            Position = Literal = End;
+                            if (Position + BlockSize <= New.Length) Rolling = HashBlock(New, Position);
+                            continue;
+                        }
+
+                        if (Position + BlockSize < New.Length)
+                            Rolling = (Rolling - New[Position] * Top) * Prime + New[Position + BlockSize];
+                        Position++;
+                    }
+
+                    WriteLiteral(Ops, New, Literal, New.Length - Literal);
+                }
+
+                return Output.ToArray();
+            }
+        }
+
+        /* What the client does with a patch, the generator runs it once to check every patch it writes */
+        public static byte[] Apply(byte[] Old, byte[] Patch)
+        {
+            for (var i = 0; i < Magic.Length; i++)
+                if (Patch.Length < 16 || Patch[i] != Magic[i])
+                    throw new InvalidDataException("Not a Synapse patch.");
+
+            var Result = new byte[BitConverter.ToInt64(Patch, 8)];
+            var Position = 0;
+
+            using (var Ops = new BinaryReader(new DeflateStream(new MemoryStream(Patch, 16, Patch.Length - 16), CompressionMode.Decompress)))
+            {
+                while (Position < Result.Length)
+                {
+                    var Op = Ops.ReadByte();
+                    if (Op == 0)
+                    {
+                        var Offset = ReadVarint(Ops);
+                        var Length = ReadVarint(Ops);
+                        Buffer.BlockCopy(Old, Offset, Result, Position, Length);
+                        Position += Length;
+                    }
+                    else
+                    {
+                        var End = Position + ReadVarint(Ops);
+                        while (Position < End)
+                        {
+                            var Read = Ops.Read(Result, Position, End - Position);
+                            if (Read <= 0) throw new InvalidDataException("Truncated patch.");
+                            Position += Read;
+                        }
+                    }
+                }
+            }
+
+            return Result;
+        }
+
+        private static ulong HashBlock(byte[] Data, int Offset)
+        {
+            var Hash = 0ul;
+            for (var i = 0; i < BlockSize; i++)
+                Hash = Hash * Prime + Data[Offset + i];
+            return Hash;
+        }
+
+        private static bool Same(byte[] A, int AOffset, byte[] B, int BOffset, int Length)
+        {
+            for (var i = 0; i < Length; i++)
+                if (A[AOffset + i] != B[BOffset + i])
+                    return false;
+            return true;
+        }
+
+        private static void WriteLiteral(BinaryWriter Ops, byte[] Data, int Offset, int Length)
+        {
+            if (Length == 0) return;
+
+            Ops.Write((byte) 1);
+            WriteVarint(Ops, Length);
+            Ops.Write(Data, Offset, Length);
+        }
+
+        private static void WriteVarint(BinaryWriter Ops, int Value)
+        {
+            var Rest = (uint) Value;
+            while (Rest >= 0x80)
+            {
+                Ops.Write((byte) (Rest | 0x80));
+                Rest >>= 7;
+            }
+            Ops.Write((byte) Rest);
+        }
+
+        private static int ReadVarint(BinaryReader Ops)
+        {
+            var Value = 0u;
+            for (var Shift = 0; ; Shift += 7)
+            {
+                var Byte = Ops.ReadByte();
+                Value |= (uint) (Byte & 0x7F) << Shift;
+                if ((Byte & 0x80) == 0) return (int) Value;
+            }
+        }
+    }
+}
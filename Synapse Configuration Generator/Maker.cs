@@ -99,10 +99,17 @@ namespace Synapse_Configuration_Generator
 
         public static string Sha512(string Input, bool IsFile = false)
         {
-            var bytes = IsFile ? File.ReadAllBytes(Input) : Encoding.ASCII.GetBytes(Input);
             using (var hash = SHA512.Create())
             {
-                var hashedInputBytes = hash.ComputeHash(bytes);
+                byte[] hashedInputBytes;
+                if (IsFile)
+                {
+                    /* Stream it, CefSharp alone is well past the LOH threshold */
+                    using (var stream = new FileStream(Input, FileMode.Open, FileAccess.Read, FileShare.Read, 81920, FileOptions.SequentialScan))
+                        hashedInputBytes = hash.ComputeHash(stream);
+                }
+                else hashedInputBytes = hash.ComputeHash(Encoding.ASCII.GetBytes(Input));
+
                 var hashedInputStringBuilder = new StringBuilder(128);
                 foreach (var b in hashedInputBytes)
                     hashedInputStringBuilder.Append(b.ToString("X2"));
@@ -110,39 +117,102 @@ namespace Synapse_Configuration_Generator
             }
         }
 
-        public void SaveSettings()
+        /* Every artifact either manifest points at, hashed in one go */
+        private Dictionary<string, string> HashArtifacts()
         {
-            var Bootstrap = new SynBootstrapperData
+            return Artifacts.Hash(new[]
+            {
+                UIPathBox.Text, InjectorPathBox.Text, DllPathBox.Text, BetaDllPathBox.Text, BetaUiPathBox.Text,
+                CefSharpPathBox.Text, SxLibPathBox.Text, SxLibXmlPathBox.Text, LauncherPathBox.Text
+            });
+        }
+
+        private static string HashOf(Dictionary<string, string> Hashes, string Path)
+        {
+            return !string.IsNullOrEmpty(Path) && Hashes.TryGetValue(Path, out var Hash) ? Hash : null;
+        }
+
+        private SynBootstrapperData MakeBootstrap(Dictionary<string, string> Hashes)
+        {
+            return new SynBootstrapperData
             {
                 UiDownload = UIDownloadBox.Text,
-                UiHash = Sha512(UIPathBox.Text, true),
+                UiHash = HashOf(Hashes, UIPathBox.Text),
                 InjectorDownload = InjectorDownloadBox.Text,
-                InjectorHash = Sha512(InjectorPathBox.Text, true),
+                InjectorHash = HashOf(Hashes, InjectorPathBox.Text),
                 BootstrapperVersion = BootstrapperVersionBox.Text
             };
+        }
 
-            var Ui = new SynUiData
+        private SynUiData MakeUi(Dictionary<string, string> Hashes)
+        {
+            return new SynUiData
             {
                 DllDownload = DllDownloadBox.Text,
-                DllHash = Sha512(DllPathBox.Text, true),
+                DllHash = HashOf(Hashes, DllPathBox.Text),
                 BetaDllDownload = BetaDllDownloadBox.Text,
-                BetaDllHash = Sha512(BetaDllPathBox.Text, true),
+                BetaDllHash = HashOf(Hashes, BetaDllPathBox.Text),
                 BetaUiDownload = BetaUiDownloadBox.Text,
-                BetaUiHash = Sha512(BetaUiPathBox.Text, true),
+                BetaUiHash = HashOf(Hashes, BetaUiPathBox.Text),
                 CefSharpDownload = CefSharpDownloadBox.Text,
-                CefSharpHash = Sha512(CefSharpPathBox.Text, true),
+                CefSharpHash = HashOf(Hashes, CefSharpPathBox.Text),
                 SxLibDownload = SxLibDownloadBox.Text,
-                SxLibHash = Sha512(SxLibPathBox.Text, true),
+                SxLibHash = HashOf(Hashes, SxLibPathBox.Text),
                 SxLibXmlDownload = SxLibXmlDownloadBox.Text,
-                SxLibXmlHash = Sha512(SxLibXmlPathBox.Text, true),
+                SxLibXmlHash = HashOf(Hashes, SxLibXmlPathBox.Text),
                 LauncherDownload = LauncherDownloadBox.Text,
-                LauncherHash = Sha512(LauncherPathBox.Text, true),
+                LauncherHash = HashOf(Hashes, LauncherPathBox.Text),
                 DiscordInvite = DiscordInviteBox.Text,
                 Version = VersionBox.Text,
                 UiVersion = UiVersionBox.Text,
                 IsUpdated = IsUpdatedBox.Checked
             };
+        }
 
+        /* Patches every artifact from the hash the last saved manifests had, call before SaveSettings overwrites them */
+        private int ReleaseArtifacts(SynBootstrapperData Bootstrap, SynUiData Ui)
+        {
+            var OldBootstrap = File.Exists("bootstrap.json")
+                ? JsonConvert.DeserializeObject<SynBootstrapperData>(File.ReadAllText("bootstrap.json"))
+                : new SynBootstrapperData();
+            var OldUi = File.Exists("ui.json")
+                ? JsonConvert.DeserializeObject<SynUiData>(File.ReadAllText("ui.json"))
+                : new SynUiData();
+
+            return Artifacts.Release(new[]
+            {
+                Tuple.Create(UIPathBox.Text, OldBootstrap.UiHash, Bootstrap.UiHash),
+                Tuple.Create(InjectorPathBox.Text, OldBootstrap.InjectorHash, Bootstrap.InjectorHash),
+                Tuple.Create(DllPathBox.Text, OldUi.DllHash, Ui.DllHash),
+                Tuple.Create(BetaDllPathBox.Text, OldUi.BetaDllHash, Ui.BetaDllHash),
+                Tuple.Create(BetaUiPathBox.Text, OldUi.BetaUiHash, Ui.BetaUiHash),
+                Tuple.Create(CefSharpPathBox.Text, OldUi.CefSharpHash, Ui.CefSharpHash),
+                Tuple.Create(SxLibPathBox.Text, OldUi.SxLibHash, Ui.SxLibHash),
+                Tuple.Create(SxLibXmlPathBox.Text, OldUi.SxLibXmlHash, Ui.SxLibXmlHash),
+                Tuple.Create(LauncherPathBox.Text, OldUi.LauncherHash, Ui.LauncherHash)
+            });
+        }
+
+        /* Returns how many delta patches were written */
+        private int Compile(out SynBootstrapperData Bootstrap, out SynUiData Ui)
+        {
+            var Hashes = HashArtifacts();
+            Bootstrap = MakeBootstrap(Hashes);
+            Ui = MakeUi(Hashes);
+
+            var Patches = ReleaseArtifacts(Bootstrap, Ui);
+            SaveSettings(Bootstrap, Ui);
+
+            return Patches;
+        }
+
+        private static void Complete(int Patches)
+        {
+            MessageBox.Show(Patches == 0 ? "Complete!" : "Complete! Wrote " + Patches + " delta patch(es) to the patches folder.");
+        }
+
+        public void SaveSettings(SynBootstrapperData Bootstrap, SynUiData Ui)
+        {
             var Paths = new SynPaths
             {
                 UiPath = UIPathBox.Text,
@@ -202,55 +272,24 @@ namespace Synapse_Configuration_Generator
 
         private void CompileBootstrapBox_Click(object sender, EventArgs e)
         {
-            var Bootstrap = new SynBootstrapperData
-            {
-                UiDownload = UIDownloadBox.Text,
-                UiHash = Sha512(UIPathBox.Text, true),
-                InjectorDownload = InjectorDownloadBox.Text,
-                InjectorHash = Sha512(InjectorPathBox.Text, true),
-                BootstrapperVersion = BootstrapperVersionBox.Text
-            };
+            var Patches = Compile(out var Bootstrap, out _);
 
             var Comp = JsonConvert.SerializeObject(Bootstrap);
             Clipboard.SetText(Comp);
             BootstrapOutputBox.Text = Comp;
 
-            SaveSettings();
-
-            MessageBox.Show("Complete!");
+            Complete(Patches);
         }
 
         private void UiCompileButton_Click(object sender, EventArgs e)
         {
-            var Ui = new SynUiData
-            {
-                DllDownload = DllDownloadBox.Text,
-                DllHash = Sha512(DllPathBox.Text, true),
-                BetaDllDownload = BetaDllDownloadBox.Text,
-                BetaDllHash = Sha512(BetaDllPathBox.Text, true),
-                BetaUiDownload = BetaUiDownloadBox.Text,
-                BetaUiHash = Sha512(BetaUiPathBox.Text, true),
-                SxLibDownload = SxLibDownloadBox.Text,
-                SxLibHash = Sha512(SxLibPathBox.Text, true),
-                SxLibXmlDownload = SxLibXmlDownloadBox.Text,
-                SxLibXmlHash = Sha512(SxLibXmlPathBox.Text, true),
-                CefSharpDownload = CefSharpDownloadBox.Text,
-                CefSharpHash = Sha512(CefSharpPathBox.Text, true),
-                LauncherDownload = LauncherDownloadBox.Text,
-                LauncherHash = Sha512(LauncherPathBox.Text, true),
-                DiscordInvite = DiscordInviteBox.Text,
-                Version = VersionBox.Text,
-                UiVersion = UiVersionBox.Text,
-                IsUpdated = IsUpdatedBox.Checked
-            };
+            var Patches = Compile(out _, out var Ui);
 
             var Comp = JsonConvert.SerializeObject(Ui);
             Clipboard.SetText(Comp);
             UiOutputBox.Text = Comp;
 
-            SaveSettings();
-
-            MessageBox.Show("Complete!");
+            Complete(Patches);
         }
 
         private void CompileWebSocketButton_Click(object sender, EventArgs e)
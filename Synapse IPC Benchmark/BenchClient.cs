@@ -0,0 +1,144 @@
+﻿using System;
+using System.Diagnostics;
+using System.IO;
+using System.IO.Pipes;
+using System.Text;
+using System.Threading;
+using WebSocketSharp;
+
+namespace Synapse_IPC_Benchmark
+{
+    /* A Lua comment carrying the send timestamp as 16 hex digits, padded out to the payload size with more comment */
+    public static class Message
+    {
+        private const string Prefix = "--";
+        private const int StampDigits = 16;
+
+        public static char[] Template(int Size)
+        {
+            var Chars = new char[Math.Max(Size, Prefix.Length + StampDigits + 1)];
+            for (var I = 0; I < Chars.Length; I++) Chars[I] = '-';
+            Chars[Prefix.Length + StampDigits] = '\n';
+            return Chars;
+        }
+
+        /* Writes the current timestamp into the template, the string is what the UI would have been handed */
+        public static string Stamp(char[] Template)
+        {
+            var Stamp = Stopwatch.GetTimestamp();
+            for (var I = StampDigits - 1; I >= 0; I--, Stamp >>= 4)
+                Template[Prefix.Length + I] = "0123456789abcdef"[(int) (Stamp & 0xF)];
+
+            return new string(Template);
+        }
+
+        public static bool TryReadStamp(byte[] Data, int Length, out long Stamp)
+        {
+            Stamp = 0;
+            if (Length < Prefix.Length + StampDigits) return false;
+
+            for (var I = 0; I < StampDigits; I++)
+            {
+                var C = Data[Prefix.Length + I];
+                int Digit;
+                if (C >= '0' && C <= '9') Digit = C - '0';
+                else if (C >= 'a' && C <= 'f') Digit = C - 'a' + 10;
+                else return false;
+
+                Stamp = (Stamp << 4) | (long) Digit;
+            }
+
+            return true;
+        }
+    }
+
+    public abstract class BenchClient : IDisposable
+    {
+        public abstract string Name { get; }
+
+        public abstract void Send(string Data);
+
+        public virtual void Dispose() { }
+    }
+
+    /* MainWindow.SendData: a new pipe connection per script, written through a StreamWriter and closed */
+    public class LegacyClient : BenchClient
+    {
+        private readonly string PipeName;
+
+        public LegacyClient(string PipeName)
+        {
+            this.PipeName = PipeName;
+        }
+
+        public override string Name => "legacy pipe";
+
+        public override void Send(string Data)
+        {
+            using (var Pipe = new NamedPipeClientStream(".", PipeName, PipeDirection.Out))
+            {
+                Pipe.Connect(5000);
+                using (var Writer = new StreamWriter(Pipe))
+                    Writer.Write(Data);
+            }
+        }
+    }
+
+    /* ChannelInterface: one overlapped pipe kept open, each script is a single framed write */
+    public class ChannelClient : BenchClient
+    {
+        private readonly NamedPipeClientStream Pipe;
+
+        public ChannelClient(string PipeName)
+        {
+            Pipe = new NamedPipeClientStream(".", PipeName, PipeDirection.InOut, PipeOptions.Asynchronous);
+            Pipe.Connect(5000);
+        }
+
+        public override string Name => "framed channel";
+
+        public override void Send(string Data)
+        {
+            var Payload = Encoding.UTF8.GetBytes(Data);
+            var Frame = new byte[5 + Payload.Length];
+            BitConverter.GetBytes((uint) Payload.Length).CopyTo(Frame, 0);
+            Frame[4] = 2; /* ChannelMessage.Execute */
+            Payload.CopyTo(Frame, 5);
+
+            Pipe.Write(Frame, 0, Frame.Length);
+        }
+
+        public override void Dispose()
+        {
+            Pipe.Dispose();
+        }
+    }
+
+    /* An external tool on /execute, replies are only counted */
+    public class WebSocketClient : BenchClient
+    {
+        private readonly WebSocket Socket;
+        public long Replies;
+
+        public WebSocketClient(string Url)
+        {
+            Socket = new WebSocket(Url);
+            Socket.OnMessage += (Sender, Args) => Interlocked.Increment(ref Replies);
+            Socket.Connect();
+
+            if (Socket.ReadyState != WebSocketState.Open) throw new IOException($"Couldn't connect to {Url}");
+        }
+
+        public override string Name => "websocket /execute";
+
+        public override void Send(string Data)
+        {
+            Socket.Send(Data);
+        }
+
+        public override void Dispose()
+        {
+            Socket.Close();
+        }
+    }
+}
@@ -0,0 +1,155 @@
+﻿using System;
+using System.Diagnostics;
+using System.Globalization;
+using System.IO;
+using System.IO.Pipes;
+using System.Net;
+using System.Threading;
+using WebSocketSharp;
+using WebSocketSharp.Server;
+
+namespace Synapse_IPC_Benchmark
+{
+    /* Stands in for the runtime's end of each transport, built like Entry.cpp's SynapseScriptIPC (one byte mode
+       instance, read to EOF per connection) and Channel::Serve (one persistent instance, read frame by frame into a
+       presized buffer), plus the UI's /execute websocket. Every message starts with the sender's Stopwatch timestamp,
+       QPC is machine wide so delivery is timed here without any reply on the pipes */
+    public static class BenchServer
+    {
+        public const int PipeBufferSize = 64 * 1024;
+
+        private static readonly Histogram Latency = new Histogram();
+        private static long Received;
+        private static long Bytes;
+
+        public static void Run(string Prefix, int Port)
+        {
+            new Thread(() => ServeLegacy(Prefix + "_script")) { IsBackground = true }.Start();
+            new Thread(() => ServeChannel(Prefix + "_channel")) { IsBackground = true }.Start();
+
+            var Sockets = new WebSocketServer(IPAddress.Loopback, Port, false);
+            Sockets.AddWebSocketService("/execute", () => new Execute());
+            Sockets.Start();
+
+            Console.WriteLine("READY");
+            ServeControl(Prefix + "_control");
+
+            Sockets.Stop();
+        }
+
+        private static void ServeLegacy(string Name)
+        {
+            using (var Pipe = new NamedPipeServerStream(Name, PipeDirection.InOut, 1, PipeTransmissionMode.Byte, PipeOptions.None, PipeBufferSize, PipeBufferSize))
+            {
+                var Buffer = new byte[PipeBufferSize];
+                var Script = new MemoryStream();
+
+                while (true)
+                {
+                    Pipe.WaitForConnection();
+                    Script.SetLength(0);
+
+                    try
+                    {
+                        int Read;
+                        while ((Read = Pipe.Read(Buffer, 0, Buffer.Length)) > 0)
+                            Script.Write(Buffer, 0, Read);
+                    }
+                    catch (IOException) { }
+
+                    Deliver(Script.GetBuffer(), (int) Script.Length);
+                    Pipe.Disconnect();
+                }
+            }
+        }
+
+        private static void ServeChannel(string Name)
+        {
+            var Header = new byte[5];
+            var Payload = new byte[PipeBufferSize];
+
+            while (true)
+            {
+                using (var Pipe = new NamedPipeServerStream(Name, PipeDirection.InOut, 1, PipeTransmissionMode.Byte, PipeOptions.Asynchronous, PipeBufferSize, PipeBufferSize))
+                {
+                    Pipe.WaitForConnection();
+
+                    try
+                    {
+                        while (ReadExact(Pipe, Header, 5))
+                        {
+                            var Length = (int) BitConverter.ToUInt32(Header, 0);
+                            if (Length > Payload.Length) Payload = new byte[Length];
+                            if (!ReadExact(Pipe, Payload, Length)) break;
+
+                            Deliver(Payload, Length);
+                        }
+                    }
+                    catch (IOException) { }
+                }
+            }
+        }
+
+        /* Same shape as WebSocketInterface.Execute, minus the hop onto the UI dispatcher */
+        private class Execute : WebSocketBehavior
+        {
+            protected override void OnMessage(MessageEventArgs e)
+            {
+                var Data = e.RawData;
+                Deliver(Data, Data.Length);
+                Send("OK");
+            }
+        }
+
+        /* RESET clears the counters, STATS answers "received bytes p50 p99 max" with latencies in microseconds, QUIT ends the run */
+        private static void ServeControl(string Name)
+        {
+            using (var Pipe = new NamedPipeServerStream(Name, PipeDirection.InOut, 1))
+            {
+                Pipe.WaitForConnection();
+
+                var Reader = new StreamReader(Pipe);
+                var Writer = new StreamWriter(Pipe) { AutoFlush = true };
+
+                string Line;
+                while ((Line = Reader.ReadLine()) != null && Line != "QUIT")
+                {
+                    if (Line == "RESET")
+                    {
+                        Latency.Reset();
+                        Interlocked.Exchange(ref Received, 0);
+                        Interlocked.Exchange(ref Bytes, 0);
+                        Writer.WriteLine("OK");
+                    }
+                    else if (Line == "STATS")
+                    {
+                        Writer.WriteLine(string.Format(CultureInfo.InvariantCulture, "{0} {1} {2} {3} {4}",
+                            Interlocked.Read(ref Received), Interlocked.Read(ref Bytes), Latency.Percentile(50), Latency.Percentile(99), Latency.MaxMicros));
+                    }
+                }
+            }
+        }
+
+        private static void Deliver(byte[] Data, int Length)
+        {
+            if (Message.TryReadStamp(Data, Length, out var Stamp))
+                Latency.Record(Stopwatch.GetTimestamp() - Stamp);
+
+            Interlocked.Increment(ref Received);
+            Interlocked.Add(ref Bytes, Length);
+        }
+
+        private static bool ReadExact(Stream Reading, byte[] Buffer, int Count)
+        {
+            var Offset = 0;
+            while (Offset < Count)
+            {
+                var Read = Reading.Read(Buffer, Offset, Count - Offset);
+                if (Read <= 0) return false;
+                Offset += Read;
+            }
+
+            return true;
+        }
+    }
+}
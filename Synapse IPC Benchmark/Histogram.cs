@@ -0,0 +1,58 @@
+﻿using System;
+using System.Diagnostics;
+using System.Threading;
+
+namespace Synapse_IPC_Benchmark
+{
+    /* Fixed 10us buckets up to 10 seconds, anything slower lands in the last one. Pipe deliveries take tens of
+       microseconds, the chat load test's 100us buckets would put them all in the first */
+    public class Histogram
+    {
+        private const int BucketMicros = 10;
+        private const int BucketCount = 1000000;
+
+        private readonly long[] Buckets = new long[BucketCount];
+        private long Total;
+        private long Max;
+
+        public long Count => Interlocked.Read(ref Total);
+
+        public void Record(long ElapsedTicks)
+        {
+            var Micros = Math.Max(0, ElapsedTicks * 1000000 / Stopwatch.Frequency);
+            var Index = (int) Math.Min(Micros / BucketMicros, BucketCount - 1);
+
+            Interlocked.Increment(ref Buckets[Index]);
+            Interlocked.Increment(ref Total);
+
+            long Seen;
+            while (Micros > (Seen = Interlocked.Read(ref Max)))
+                if (Interlocked.CompareExchange(ref Max, Micros, Seen) == Seen) break;
+        }
+
+        /* In microseconds, the upper edge of the bucket the percentile falls in */
+        public double Percentile(double Percent)
+        {
+            var Target = (long) Math.Ceiling(Count * Percent / 100);
+            if (Target == 0) return 0;
+
+            long Seen = 0;
+            for (var I = 0; I < BucketCount; I++)
+            {
+                Seen += Interlocked.Read(ref Buckets[I]);
+                if (Seen >= Target) return (I + 1) * BucketMicros;
+            }
+
+            return MaxMicros;
+        }
+
+        public double MaxMicros => Interlocked.Read(ref Max);
+
+        public void Reset()
+        {
+            for (var I = 0; I < BucketCount; I++) Interlocked.Exchange(ref Buckets[I], 0);
+            Interlocked.Exchange(ref Total, 0);
+            Interlocked.Exchange(ref Max, 0);
+        }
+    }
+}
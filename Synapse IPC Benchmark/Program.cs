@@ -0,0 +1,208 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Globalization;
+using System.IO;
+using System.IO.Pipes;
+using System.Linq;
+using System.Reflection;
+using System.Threading;
+
+namespace Synapse_IPC_Benchmark
+{
+    public class Program
+    {
+        private const string Usage =
+            "Synapse IPC Benchmark.exe [options]\n" +
+            "  --transports <list>    legacy,channel,websocket (all)\n" +
+            "  --sizes <list>         payload bytes (256,4096,65536,1048576)\n" +
+            "  --duration <s>         seconds of back to back sends per case (3)\n" +
+            "  --samples <n>          paced sends per case for latency (1000)\n" +
+            "  --rate <n>             paced sends per second (500)\n" +
+            "  --port <n>             websocket port for the server process (24893)\n" +
+            "Starts its own server process, nothing here talks to a running Synapse.";
+
+        private class Result
+        {
+            public string Transport;
+            public int Size;
+            public double PerSecond;
+            public double MBPerSecond;
+            public double P50;
+            public double P99;
+            public double ClientMicros;
+            public double ServerMicros;
+        }
+
+        public static int Main(string[] args)
+        {
+            if (args.Length == 3 && args[0] == "--serve")
+            {
+                BenchServer.Run(args[1], int.Parse(args[2]));
+                return 0;
+            }
+
+            var Transports = new[] { "legacy", "channel", "websocket" };
+            var Sizes = new[] { 256, 4096, 65536, 1048576 };
+            var Duration = 3.0;
+            var Samples = 1000;
+            var Rate = 500.0;
+            var Port = 24893;
+
+            try
+            {
+                for (var I = 0; I < args.Length; I++)
+                {
+                    switch (args[I])
+                    {
+                        case "--transports": Transports = args[++I].Split(','); break;
+                        case "--sizes": Sizes = args[++I].Split(',').Select(int.Parse).ToArray(); break;
+                        case "--duration": Duration = double.Parse(args[++I], CultureInfo.InvariantCulture); break;
+                        case "--samples": Samples = int.Parse(args[++I]); break;
+                        case "--rate": Rate = double.Parse(args[++I], CultureInfo.InvariantCulture); break;
+                        case "--port": Port = int.Parse(args[++I]); break;
+                        default: throw new ArgumentException(args[I]);
+                    }
+                }
+
+                if (Transports.Any(T => T != "legacy" && T != "channel" && T != "websocket")) throw new ArgumentException();
+            }
+            catch (Exception)
+            {
+                Console.WriteLine(Usage);
+                return 1;
+            }
+
+            var Prefix = "SynapseIpcBench" + Process.GetCurrentProcess().Id;
+            var Server = Process.Start(new ProcessStartInfo(Assembly.GetEntryAssembly().Location, $"--serve {Prefix} {Port}")
+            {
+                UseShellExecute = false,
+                RedirectStandardOutput = true,
+                CreateNoWindow = true
+            });
+
+            try
+            {
+                if (Server.StandardOutput.ReadLine() != "READY")
+                {
+                    Console.WriteLine("The server process didn't start.");
+                    return 1;
+                }
+
+                using (var Control = new NamedPipeClientStream(".", Prefix + "_control", PipeDirection.InOut))
+                {
+                    Control.Connect(5000);
+                    var Reader = new StreamReader(Control);
+                    var Writer = new StreamWriter(Control) { AutoFlush = true };
+
+                    string[] Ask(string Command)
+                    {
+                        Writer.WriteLine(Command);
+                        return Reader.ReadLine().Split(' ');
+                    }
+
+                    var Results = new List<Result>();
+                    foreach (var Transport in Transports)
+                    {
+                        foreach (var Size in Sizes)
+                        {
+                            using (var Client = Connect(Transport, Prefix, Port))
+                            {
+                                Console.WriteLine($"{Client.Name}, {Size} bytes...");
+                                Results.Add(RunCase(Client, Size, Duration, Samples, Rate, Server, Ask));
+                            }
+                        }
+                    }
+
+                    Writer.WriteLine("QUIT");
+
+                    Console.WriteLine();
+                    Console.WriteLine($"{"Transport",-20}{"Bytes",10}{"Msg/s",11}{"MB/s",9}{"p50 us",9}{"p99 us",9}{"Client us",11}{"Server us",11}");
+                    foreach (var R in Results)
+                        Console.WriteLine($"{R.Transport,-20}{R.Size,10}{R.PerSecond,11:F0}{R.MBPerSecond,9:F1}{R.P50,9:F0}{R.P99,9:F0}{R.ClientMicros,11:F1}{R.ServerMicros,11:F1}");
+
+                    Console.WriteLine();
+                    Console.WriteLine("Msg/s and MB/s are delivered back to back for the duration. p50/p99 are one way delivery times of paced sends,");
+                    Console.WriteLine("measured by the server. Client and Server are CPU microseconds per message during the back to back phase.");
+                }
+            }
+            finally
+            {
+                if (!Server.WaitForExit(5000)) Server.Kill();
+            }
+
+            return 0;
+        }
+
+        private static BenchClient Connect(string Transport, string Prefix, int Port)
+        {
+            switch (Transport)
+            {
+                case "legacy": return new LegacyClient(Prefix + "_script");
+                case "channel": return new ChannelClient(Prefix + "_channel");
+                default: return new WebSocketClient($"ws://127.0.0.1:{Port}/execute");
+            }
+        }
+
+        private static Result RunCase(BenchClient Client, int Size, double Duration, int Samples, double Rate, Process Server, Func<string, string[]> Ask)
+        {
+            var Template = Message.Template(Size);
+            var Self = Process.GetCurrentProcess();
+
+            /* Back to back, throughput and CPU cost per message */
+            Ask("RESET");
+            Self.Refresh();
+            Server.Refresh();
+            var ClientCpu = Self.TotalProcessorTime;
+            var ServerCpu = Server.TotalProcessorTime;
+
+            long Sent = 0;
+            var Run = Stopwatch.StartNew();
+            while (Run.Elapsed.TotalSeconds < Duration)
+            {
+                Client.Send(Message.Stamp(Template));
+                Sent++;
+            }
+
+            /* Whatever is still in the pipe counts as long as it lands shortly after */
+            var Drain = Stopwatch.StartNew();
+            long Delivered;
+            while ((Delivered = long.Parse(Ask("STATS")[0])) < Sent && Drain.ElapsedMilliseconds < 5000)
+                Thread.Sleep(1);
+            var Elapsed = Run.Elapsed.TotalSeconds;
+
+            Self.Refresh();
+            Server.Refresh();
+            var Result = new Result
+            {
+                Transport = Client.Name,
+                Size = Template.Length,
+                PerSecond = Delivered / Elapsed,
+                MBPerSecond = Delivered * (double) Template.Length / Elapsed / (1024 * 1024),
+                ClientMicros = (Self.TotalProcessorTime - ClientCpu).TotalMilliseconds * 1000 / Math.Max(1, Sent),
+                ServerMicros = (Server.TotalProcessorTime - ServerCpu).TotalMilliseconds * 1000 / Math.Max(1, Delivered)
+            };
+
+            /* Paced, so queueing behind the previous send doesn't show up as latency */
+            Ask("RESET");
+            var Interval = Stopwatch.Frequency / Rate;
+            var Start = Stopwatch.GetTimestamp();
+            for (var I = 0; I < Samples; I++)
+            {
+                var Due = Start + (long) (I * Interval);
+                while (Stopwatch.GetTimestamp() < Due) Thread.Sleep(0);
+
+                Client.Send(Message.Stamp(Template));
+            }
+
+            Drain.Restart();
+            string[] Stats;
+            while (long.Parse((Stats = Ask("STATS"))[0]) < Samples && Drain.ElapsedMilliseconds < 5000)
+                Thread.Sleep(1);
+
+            Result.P50 = double.Parse(Stats[2], CultureInfo.InvariantCulture);
+            Result.P99 = double.Parse(Stats[3], CultureInfo.InvariantCulture);
+            return Result;
+        }
+    }
+}
@@ -20,6 +20,7 @@
 #include "ObfuscatedString.hpp"
 #include "sha512.h"
 #include "WinReg.hpp"
+#include "SyntaxCheck.hpp"
 
 #include <cryptopp/aes.h>
 #include <cryptopp/rsa.h>
@@ -577,6 +578,21 @@ extern "C" __declspec(dllexport) const char* __stdcall SynSignRequest(DWORD sum,
 	return SignRequestInternal(Data);
 }
 
+/* Parse-only, safe to call from any thread. Message gets the error text truncated to MessageSize */
+extern "C" __declspec(dllexport) BOOL __stdcall SynSyntaxCheck(const char* Source, int Size, int* Line, char* Message, int MessageSize)
+{
+	int ErrLine;
+	std::string Err;
+	if (SyntaxCheck::Check(Source, Size, ErrLine, Err))
+		return TRUE;
+
+	*Line = ErrLine;
+	if (Message && MessageSize > 0)
+		strncpy_s(Message, MessageSize, Err.c_str(), _TRUNCATE);
+
+	return FALSE;
+}
+
 BOOL APIENTRY DllMain(HMODULE mod, DWORD reason, LPVOID)
 {
 	return TRUE;
@@ -0,0 +1,54 @@
+/*
+*
+*	SYNAPSE-PHOENIX (working title)
+*	File.:	SyntaxCheck.cpp
+*	Desc.:	Parse-only syntax check for the editors.
+*
+*/
+
+#include "SyntaxCheck.hpp"
+
+#include <cstdlib>
+
+extern "C"
+{
+	#include "../../Synapse/Src/Source Dependencies/Lua/lua.h"
+	#include "../../Synapse/Src/Source Dependencies/Lua/lauxlib.h"
+	#include "../../Synapse/Src/Source Dependencies/Lua/llex.h"
+}
+
+namespace SyntaxCheck
+{
+	bool Check(const char* Source, const size_t Size, int& Line, std::string& Message)
+	{
+		Line = 0;
+		Message.clear();
+
+		/* One state per check, the parser is the only thing that ever touches it */
+		const auto L = luaL_newstate();
+		if (!L)
+		{
+			Message = "out of memory";
+			return false;
+		}
+
+		const auto Failed = luaL_loadbuffer(L, Source, Size, BS_LUA, "=");
+		if (Failed)
+		{
+			/* "=" leaves just ":<line>: <message>" in front of the error */
+			const char* Err = lua_tostring(L, -1);
+			Message = Err ? Err : "";
+
+			if (Failed == LUA_ERRSYNTAX && Message.size() > 1 && Message[0] == ':')
+			{
+				char* End;
+				Line = (int) strtol(Message.c_str() + 1, &End, 10);
+				if (*End == ':')
+					Message.erase(0, End - Message.c_str() + 1 + (End[1] == ' ' ? 1 : 0));
+			}
+		}
+
+		lua_close(L);
+		return !Failed;
+	}
+}
@@ -0,0 +1,17 @@
+/*
+*
+*	SYNAPSE-PHOENIX (working title)
+*	File.:	SyntaxCheck.hpp
+*	Desc.:	Parse-only syntax check for the editors.
+*
+*/
+
+#pragma once
+#include <string>
+
+namespace SyntaxCheck
+{
+	/* Compiles Source in a throwaway state and drops the result, nothing is converted or run. On a syntax error Line and Message
+	   (without the chunk name and line prefix) describe it */
+	bool Check(const char* Source, size_t Size, int& Line, std::string& Message);
+}
@@ -36,6 +36,46 @@ namespace Synapse_X_UI
 
         public event MonacoReadyDelegate MonacoReady;
 
+        /* Tabs are models on this one editor rather than a browser each, switching swaps the model and its view state */
+        private const string TabScript = @"(function () {
+    if (typeof editor === 'undefined') return;
+
+    var models = { 0: editor.getModel() };
+    var views = {};
+    var active = 0;
+
+    window.SynNewTab = function (id, text) {
+        var current = editor.getModel();
+        models[id] = monaco.editor.createModel(text, current.getLanguageId ? current.getLanguageId() : current.getModeId());
+    };
+
+    window.SynSwitchTab = function (id) {
+        if (!models[id] || id === active) return;
+
+        views[active] = editor.saveViewState();
+        active = id;
+        editor.setModel(models[id]);
+        if (views[id]) editor.restoreViewState(views[id]);
+        editor.focus();
+    };
+
+    window.SynCloseTab = function (id) {
+        var model = models[id];
+        if (!model || id === active) return;
+
+        delete models[id];
+        delete views[id];
+        model.dispose();
+    };
+})();";
+
+        private int NextTab = 1;
+
+        /// <summary>
+        /// The tab the editor shows, 0 is the page's own model and always exists.
+        /// </summary>
+        public int ActiveTab { get; private set; }
+
         public Monaco()
         {
             Opacity = 0;
@@ -45,6 +85,10 @@ namespace Synapse_X_UI
             {
                 if (args.IsLoading) return;
 
+                this.ExecuteScriptAsync(TabScript);
+                NextTab = 1;
+                ActiveTab = 0;
+
                 MonacoLoaded = true;
                 MonacoReady?.Invoke();
             };
@@ -128,6 +172,42 @@ namespace Synapse_X_UI
                 SetText(GetText() + text);
         }
 
+        /// <summary>
+        /// Opens a tab as a new model on the editor without showing it, returns its id or -1 before the page is up.
+        /// </summary>
+        /// <param name="text"></param>
+        /// <returns></returns>
+        public int NewTab(string text)
+        {
+            if (!MonacoLoaded) return -1;
+
+            var Id = NextTab++;
+            this.ExecuteScriptAsync("SynNewTab", Id, text);
+            return Id;
+        }
+
+        /// <summary>
+        /// Shows the tab, its cursor, selection and scroll come back as they were left.
+        /// </summary>
+        /// <param name="tab"></param>
+        public void SwitchTab(int tab)
+        {
+            if (!MonacoLoaded) return;
+
+            ActiveTab = tab;
+            this.ExecuteScriptAsync("SynSwitchTab", tab);
+        }
+
+        /// <summary>
+        /// Disposes the tab's model. The active tab and tab 0 can't be closed, switch away first.
+        /// </summary>
+        /// <param name="tab"></param>
+        public void CloseTab(int tab)
+        {
+            if (MonacoLoaded && tab != 0 && tab != ActiveTab)
+                this.ExecuteScriptAsync("SynCloseTab", tab);
+        }
+
         public void GoToLine(int lineNumber)
         {
             if (MonacoLoaded)
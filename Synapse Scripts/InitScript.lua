@@ -35,6 +35,7 @@ local NewCC = newcclosure
 local ReATT = reattach
 local HookFunc = hookfunction
 local GetLoadedModules = getloadedmodules
+local GetLoadedModulesSince = getloadedmodulessince
 local StrFind = string.find
 local StrGSub = string.gsub
 local RepKick = reportkick
@@ -330,6 +331,19 @@ end)
 
 getgenv().get_loaded_modules = getloadedmodules
 
+getgenv().getloadedmodulessince = newcclosure(function(token)
+    local Unfiltered, NewToken = GetLoadedModulesSince(token)
+    local Filtered = {}
+
+    for I,V in pairs(Unfiltered) do
+        if not CheckRL(V) then table.insert(Filtered, V) end
+    end
+
+    return Filtered, NewToken
+end)
+
+getgenv().get_loaded_modules_since = getloadedmodulessince
+
 --internal: forced HttpGetAsync
 getgenv().htgetf = newcclosure(function(url)
     local GND = GetNDM(game)
@@ -435,6 +449,9 @@ local GetRP = getrenderproperty
 local SetRP = setrenderproperty
 local CreateRP = createrenderobject
 local DestroyRP = destroyrenderobject
+local SweepRP = sweeprenderobjects
+local BulkRP = setrenderpropertybulk
+local GetRPIds = getrenderpropertyids
 
 local LineMT =
 {
@@ -450,6 +467,7 @@ local LineMT =
         if not rawget(T, "__OBJECT_EXISTS") then error("render object destroyed") end
 
         if K == "Visible" and type(V) ~= "boolean" then error("invalid type '" .. typeof(V) .. "' for property 'Visible', expected boolean") end
+        if K == "ZIndex" and type(V) ~= "number" then error("invalid type '" .. typeof(V) .. "' for property 'ZIndex', expected number") end
         if K == "From" and typeof(V) ~= "Vector2" then error("invalid type '" .. typeof(V) .. "' for property 'From', expected Vector2") end
         if K == "To" and typeof(V) ~= "Vector2" then error("invalid type '" .. typeof(V) .. "' for property 'To', expected Vector2") end
         if K == "Color" and typeof(V) ~= "Color3" then error("invalid type '" .. typeof(V) .. "' for property 'Color', expected Color3") end
@@ -476,6 +494,7 @@ local TextMT =
         if not rawget(T, "__OBJECT_EXISTS") then error("render object destroyed") end
 
         if K == "Visible" and type(V) ~= "boolean" then error("invalid type '" .. typeof(V) .. "' for property 'Visible', expected boolean") end
+        if K == "ZIndex" and type(V) ~= "number" then error("invalid type '" .. typeof(V) .. "' for property 'ZIndex', expected number") end
         if K == "Text" and type(V) ~= "string" then error("invalid type '" .. typeof(V) .. "' for property 'Text', expected string") end
         if K == "Position" and typeof(V) ~= "Vector2" then error("invalid type '" .. typeof(V) .. "' for property 'Position', expected Vector2") end
         if K == "Color" and typeof(V) ~= "Color3" then error("invalid type '" .. typeof(V) .. "' for property 'Color', expected Color3") end
@@ -507,6 +526,7 @@ local SquareMT =
         if not rawget(T, "__OBJECT_EXISTS") then error("render object destroyed") end
 
         if K == "Visible" and type(V) ~= "boolean" then error("invalid type '" .. typeof(V) .. "' for property 'Visible', expected boolean") end
+        if K == "ZIndex" and type(V) ~= "number" then error("invalid type '" .. typeof(V) .. "' for property 'ZIndex', expected number") end
         if K == "Position" and typeof(V) ~= "Vector2" then error("invalid type '" .. typeof(V) .. "' for property 'Position', expected Vector2") end
         if K == "Size" and typeof(V) ~= "Vector2" then error("invalid type '" .. typeof(V) .. "' for property 'Size', expected Vector2") end
         if K == "Color" and typeof(V) ~= "Color3" then error("invalid type '" .. typeof(V) .. "' for property 'Color', expected Color3") end
@@ -534,6 +554,7 @@ local CircleMT =
         if not rawget(T, "__OBJECT_EXISTS") then error("render object destroyed") end
 
         if K == "Visible" and type(V) ~= "boolean" then error("invalid type '" .. typeof(V) .. "' for property 'Visible', expected boolean") end
+        if K == "ZIndex" and type(V) ~= "number" then error("invalid type '" .. typeof(V) .. "' for property 'ZIndex', expected number") end
         if K == "Position" and typeof(V) ~= "Vector2" then error("invalid type '" .. typeof(V) .. "' for property 'Position', expected Vector2") end
         if K == "Radius" and type(V) ~= "number" then error("invalid type '" .. typeof(V) .. "' for property 'Radius', expected number") end
         if K == "Color" and typeof(V) ~= "Color3" then error("invalid type '" .. typeof(V) .. "' for property 'Color', expected Color3") end
@@ -548,13 +569,149 @@ local CircleMT =
     __type = "Circle"
 }
 
+local ImageMT = 
+{
+    __index = function(T, K)
+        if not rawget(T, "__OBJECT_EXISTS") then error("render object destroyed") end
+
+        if K == "Remove" then return newcclosure(function() DestroyRP(rawget(T, "__OBJECT")) rawset(T, "__OBJECT", nil) rawset(T, "__OBJECT_EXISTS", false) end) end
+
+        return GetRP(rawget(T, "__OBJECT"), K)
+    end,
+
+    __newindex = function(T, K, V)
+        if not rawget(T, "__OBJECT_EXISTS") then error("render object destroyed") end
+
+        if K == "Visible" and type(V) ~= "boolean" then error("invalid type '" .. typeof(V) .. "' for property 'Visible', expected boolean") end
+        if K == "ZIndex" and type(V) ~= "number" then error("invalid type '" .. typeof(V) .. "' for property 'ZIndex', expected number") end
+        if K == "Data" and type(V) ~= "string" then error("invalid type '" .. typeof(V) .. "' for property 'Data', expected string") end
+        if K == "Position" and typeof(V) ~= "Vector2" then error("invalid type '" .. typeof(V) .. "' for property 'Position', expected Vector2") end
+        if K == "Size" and typeof(V) ~= "Vector2" then error("invalid type '" .. typeof(V) .. "' for property 'Size', expected Vector2") end
+        if K == "Color" and typeof(V) ~= "Color3" then error("invalid type '" .. typeof(V) .. "' for property 'Color', expected Color3") end
+        if K == "Rounding" and type(V) ~= "number" then error("invalid type '" .. typeof(V) .. "' for property 'Rounding', expected number") end
+        if K == "Transparency" and type(V) ~= "number" then error("invalid type '" .. typeof(V) .. "' for property 'Transparency', expected number") end
+
+        return SetRP(rawget(T, "__OBJECT"), K, V)
+    end,
+
+    __type = "Image"
+}
+
+local PolylineMT = 
+{
+    __index = function(T, K)
+        if not rawget(T, "__OBJECT_EXISTS") then error("render object destroyed") end
+
+        if K == "Remove" then return newcclosure(function() DestroyRP(rawget(T, "__OBJECT")) rawset(T, "__OBJECT", nil) rawset(T, "__OBJECT_EXISTS", false) end) end
+
+        return GetRP(rawget(T, "__OBJECT"), K)
+    end,
+
+    __newindex = function(T, K, V)
+        if not rawget(T, "__OBJECT_EXISTS") then error("render object destroyed") end
+
+        if K == "Visible" and type(V) ~= "boolean" then error("invalid type '" .. typeof(V) .. "' for property 'Visible', expected boolean") end
+        if K == "ZIndex" and type(V) ~= "number" then error("invalid type '" .. typeof(V) .. "' for property 'ZIndex', expected number") end
+        if K == "Points" and type(V) ~= "table" and type(V) ~= "userdata" then error("invalid type '" .. typeof(V) .. "' for property 'Points', expected table or buffer") end
+        if K == "Color" and typeof(V) ~= "Color3" then error("invalid type '" .. typeof(V) .. "' for property 'Color', expected Color3") end
+        if K == "Thickness" and type(V) ~= "number" then error("invalid type '" .. typeof(V) .. "' for property 'Thickness', expected number") end
+        if K == "Filled" and type(V) ~= "boolean" then error("invalid type '" .. typeof(V) .. "' for property 'Filled', expected boolean") end
+        if K == "Transparency" and type(V) ~= "number" then error("invalid type '" .. typeof(V) .. "' for property 'Transparency', expected number") end
+        if K == "Closed" and type(V) ~= "boolean" then error("invalid type '" .. typeof(V) .. "' for property 'Closed', expected boolean") end
+
+        return SetRP(rawget(T, "__OBJECT"), K, V)
+    end,
+
+    __type = "Polyline"
+}
+
+local TriangleMT = 
+{
+    __index = function(T, K)
+        if not rawget(T, "__OBJECT_EXISTS") then error("render object destroyed") end
+
+        if K == "Remove" then return newcclosure(function() DestroyRP(rawget(T, "__OBJECT")) rawset(T, "__OBJECT", nil) rawset(T, "__OBJECT_EXISTS", false) end) end
+
+        return GetRP(rawget(T, "__OBJECT"), K)
+    end,
+
+    __newindex = function(T, K, V)
+        if not rawget(T, "__OBJECT_EXISTS") then error("render object destroyed") end
+
+        if K == "Visible" and type(V) ~= "boolean" then error("invalid type '" .. typeof(V) .. "' for property 'Visible', expected boolean") end
+        if K == "ZIndex" and type(V) ~= "number" then error("invalid type '" .. typeof(V) .. "' for property 'ZIndex', expected number") end
+        if K == "Points" and type(V) ~= "table" and type(V) ~= "userdata" then error("invalid type '" .. typeof(V) .. "' for property 'Points', expected table or buffer") end
+        if K == "PointA" and typeof(V) ~= "Vector2" then error("invalid type '" .. typeof(V) .. "' for property 'PointA', expected Vector2") end
+        if K == "PointB" and typeof(V) ~= "Vector2" then error("invalid type '" .. typeof(V) .. "' for property 'PointB', expected Vector2") end
+        if K == "PointC" and typeof(V) ~= "Vector2" then error("invalid type '" .. typeof(V) .. "' for property 'PointC', expected Vector2") end
+        if K == "Color" and typeof(V) ~= "Color3" then error("invalid type '" .. typeof(V) .. "' for property 'Color', expected Color3") end
+        if K == "Thickness" and type(V) ~= "number" then error("invalid type '" .. typeof(V) .. "' for property 'Thickness', expected number") end
+        if K == "Filled" and type(V) ~= "boolean" then error("invalid type '" .. typeof(V) .. "' for property 'Filled', expected boolean") end
+        if K == "Transparency" and type(V) ~= "number" then error("invalid type '" .. typeof(V) .. "' for property 'Transparency', expected number") end
+
+        return SetRP(rawget(T, "__OBJECT"), K, V)
+    end,
+
+    __type = "Triangle"
+}
+
+local QuadMT = 
+{
+    __index = function(T, K)
+        if not rawget(T, "__OBJECT_EXISTS") then error("render object destroyed") end
+
+        if K == "Remove" then return newcclosure(function() DestroyRP(rawget(T, "__OBJECT")) rawset(T, "__OBJECT", nil) rawset(T, "__OBJECT_EXISTS", false) end) end
+
+        return GetRP(rawget(T, "__OBJECT"), K)
+    end,
+
+    __newindex = function(T, K, V)
+        if not rawget(T, "__OBJECT_EXISTS") then error("render object destroyed") end
+
+        if K == "Visible" and type(V) ~= "boolean" then error("invalid type '" .. typeof(V) .. "' for property 'Visible', expected boolean") end
+        if K == "ZIndex" and type(V) ~= "number" then error("invalid type '" .. typeof(V) .. "' for property 'ZIndex', expected number") end
+        if K == "Points" and type(V) ~= "table" and type(V) ~= "userdata" then error("invalid type '" .. typeof(V) .. "' for property 'Points', expected table or buffer") end
+        if K == "PointA" and typeof(V) ~= "Vector2" then error("invalid type '" .. typeof(V) .. "' for property 'PointA', expected Vector2") end
+        if K == "PointB" and typeof(V) ~= "Vector2" then error("invalid type '" .. typeof(V) .. "' for property 'PointB', expected Vector2") end
+        if K == "PointC" and typeof(V) ~= "Vector2" then error("invalid type '" .. typeof(V) .. "' for property 'PointC', expected Vector2") end
+        if K == "PointD" and typeof(V) ~= "Vector2" then error("invalid type '" .. typeof(V) .. "' for property 'PointD', expected Vector2") end
+        if K == "Color" and typeof(V) ~= "Color3" then error("invalid type '" .. typeof(V) .. "' for property 'Color', expected Color3") end
+        if K == "Thickness" and type(V) ~= "number" then error("invalid type '" .. typeof(V) .. "' for property 'Thickness', expected number") end
+        if K == "Filled" and type(V) ~= "boolean" then error("invalid type '" .. typeof(V) .. "' for property 'Filled', expected boolean") end
+        if K == "Transparency" and type(V) ~= "number" then error("invalid type '" .. typeof(V) .. "' for property 'Transparency', expected number") end
+
+        return SetRP(rawget(T, "__OBJECT"), K, V)
+    end,
+
+    __type = "Quad"
+}
+
 local RPInit = false
 
+-- wrapper -> handle, weak so dropped objects leave it once collected and the next sweep destroys them
+local RPRefs = setmetatable({}, { __mode = "k" })
+local RPLive, RPSweepAt = 0, 256
+
+local function TrackRP(Obj)
+    RPRefs[Obj] = rawget(Obj, "__OBJECT")
+
+    RPLive = RPLive + 1
+    if RPLive >= RPSweepAt then
+        RPLive = SweepRP(RPRefs)
+        RPSweepAt = math.max(256, RPLive * 2)
+    end
+
+    return Obj
+end
+
 local Draw =
 {
-    new = function(Type)
+    -- a Key keeps the object through teleports, Drawing.new with the same Key afterwards gets it back as it was
+    new = function(Type, Key)
+        if Key ~= nil and type(Key) ~= "string" then error("bad argument #2 to 'new' (string expected)") end
+
         if Type == "Line" then
-            local RendObj = CreateRP(Type)
+            local RendObj = CreateRP(Type, Key)
             if not RPInit then wait(0.1) RPInit = true end
 
             local Ret = 
@@ -563,11 +720,11 @@ local Draw =
                 __OBJECT_EXISTS = true
             }
 
-            return setmetatable(Ret, LineMT)
+            return TrackRP(setmetatable(Ret, LineMT))
         end
 
         if Type == "Text" then
-            local RendObj = CreateRP(Type)
+            local RendObj = CreateRP(Type, Key)
             if not RPInit then wait(0.1) RPInit = true end
 
             local Ret = 
@@ -576,11 +733,11 @@ local Draw =
                 __OBJECT_EXISTS = true
             }
 
-            return setmetatable(Ret, TextMT)
+            return TrackRP(setmetatable(Ret, TextMT))
         end
 
         if Type == "Square" then
-            local RendObj = CreateRP(Type)
+            local RendObj = CreateRP(Type, Key)
             if not RPInit then wait(0.1) RPInit = true end
 
             local Ret = 
@@ -589,11 +746,11 @@ local Draw =
                 __OBJECT_EXISTS = true
             }
 
-            return setmetatable(Ret, SquareMT)
+            return TrackRP(setmetatable(Ret, SquareMT))
         end
 
         if Type == "Circle" then
-            local RendObj = CreateRP(Type)
+            local RendObj = CreateRP(Type, Key)
             if not RPInit then wait(0.1) RPInit = true end
 
             local Ret = 
@@ -602,7 +759,59 @@ local Draw =
                 __OBJECT_EXISTS = true
             }
 
-            return setmetatable(Ret, CircleMT)
+            return TrackRP(setmetatable(Ret, CircleMT))
+        end
+
+        if Type == "Image" then
+            local RendObj = CreateRP(Type, Key)
+            if not RPInit then wait(0.1) RPInit = true end
+
+            local Ret = 
+            {
+                __OBJECT = RendObj,
+                __OBJECT_EXISTS = true
+            }
+
+            return TrackRP(setmetatable(Ret, ImageMT))
+        end
+
+        if Type == "Polyline" then
+            local RendObj = CreateRP(Type, Key)
+            if not RPInit then wait(0.1) RPInit = true end
+
+            local Ret = 
+            {
+                __OBJECT = RendObj,
+                __OBJECT_EXISTS = true
+            }
+
+            return TrackRP(setmetatable(Ret, PolylineMT))
+        end
+
+        if Type == "Triangle" then
+            local RendObj = CreateRP(Type, Key)
+            if not RPInit then wait(0.1) RPInit = true end
+
+            local Ret = 
+            {
+                __OBJECT = RendObj,
+                __OBJECT_EXISTS = true
+            }
+
+            return TrackRP(setmetatable(Ret, TriangleMT))
+        end
+
+        if Type == "Quad" then
+            local RendObj = CreateRP(Type, Key)
+            if not RPInit then wait(0.1) RPInit = true end
+
+            local Ret = 
+            {
+                __OBJECT = RendObj,
+                __OBJECT_EXISTS = true
+            }
+
+            return TrackRP(setmetatable(Ret, QuadMT))
         end
 
         error("invalid object type ('" .. tostring(Type) .. "')")
@@ -614,7 +823,15 @@ local Draw =
         System = 1,
         Plex = 2,
         Monospace = 3
-    }
+    },
+
+    -- property name -> id for Drawing.update
+    Fields = GetRPIds(),
+
+    -- Drawing.update({ Obj, Drawing.Fields.Visible, true, Obj2, Drawing.Fields.Position, Vector2.new(), ... })
+    update = function(Batch)
+        return BulkRP(Batch)
+    end
 }
 
 --event API
@@ -682,28 +899,43 @@ local ConnMT =
 }
 
 local ConCache = {}
+local function WrapCon(Con)
+    if ConCache[Con] then return ConCache[Con] end
+
+    local CTable = 
+    {
+         __OBJECT = Con,
+         __OBJECT_ENABLED = true
+    }
+
+    ConCache[Con] = setmetatable(CTable, ConnMT)
+    return ConCache[Con]
+end
+
 getgenv().getconnections = newcclosure(function(sig)
     local Cons = GetCons(sig)
     local Ret = {}
 
     for Idx, Con in pairs(Cons) do
-        if ConCache[Con] then
-            Ret[Idx] = ConCache[Con]
-        else
-            local CTable = 
-            {
-                 __OBJECT = Con,
-                 __OBJECT_ENABLED = true
-            }
-    
-            Ret[Idx] = setmetatable(CTable, ConnMT)
-            ConCache[Con] = Ret[Idx]
-        end
+        Ret[Idx] = WrapCon(Con)
     end
 
     return Ret
 end)
 
+local GetConsBulk = getconnectionsbulk
+getgenv().getconnectionsbulk = newcclosure(function(sigs)
+    local Infos = GetConsBulk(sigs)
+
+    for _, Cons in pairs(Infos) do
+        for _, Info in pairs(Cons) do
+            Info.Connection = WrapCon(Info.Connection)
+        end
+    end
+
+    return Infos
+end)
+
 getgenv().gbmt = newcclosure(function()
     return 
     {
@@ -801,6 +1033,7 @@ getgenv().saveinstance = function(...)
             MaterialColors = 'BinaryString'
         }
     }
+    local lprefetched = { }
     local ldecompile
     do
     if OPTIONS.noscripts then
@@ -810,6 +1043,10 @@ getgenv().saveinstance = function(...)
     else
         local ldeccache = { }
         ldecompile = function(scr)
+        local pre = lprefetched[scr]
+        if pre then
+            return pre
+        end
         local name = scr.ClassName .. scr.Name
         do
             local ca = ldeccache[name]
@@ -877,6 +1114,24 @@ getgenv().saveinstance = function(...)
     end
     slist = tmp
     end
+    if not OPTIONS.noscripts then
+    local batch = { }
+    for _index_0 = 1, #slist do
+        local hier = slist[_index_0]:GetDescendants()
+        for _index_1 = 1, #hier do
+        local s = hier[_index_1]
+        if s.ClassName == 'LocalScript' or s.ClassName == 'ModuleScript' then
+            table.insert(batch, s)
+        end
+        end
+    end
+    local ran, sources = pcall(decompileall, batch, OPTIONS.decomptype, OPTIONS.timeout)
+    if ran then
+        for _index_0 = 1, #batch do
+        lprefetched[batch[_index_0]] = sources[_index_0]
+        end
+    end
+    end
     local ilist
     do
     local _tbl_0 = { }
@@ -1287,6 +1542,180 @@ end
 
 getgenv().Drawing = Draw
 
+--string builder API
+local CreateSB = createstringbuilder
+local AppendSB = stringbuilderappend
+local RepSB = stringbuilderrep
+local PackSB = stringbuilderpack
+local ToStringSB = stringbuildertostring
+local LenSB = stringbuilderlen
+local ClearSB = stringbuilderclear
+local DestroySB = destroystringbuilder
+
+local SBMethods = {}
+local SBMT = { __index = SBMethods, __type = "StringBuilder" }
+
+function SBMT.__tostring(T)
+    return ToStringSB(rawget(T, "__OBJECT"))
+end
+
+function SBMethods.Append(T, ...)
+    AppendSB(rawget(T, "__OBJECT"), ...)
+    return T
+end
+
+function SBMethods.Rep(T, S, N)
+    RepSB(rawget(T, "__OBJECT"), S, N)
+    return T
+end
+
+function SBMethods.Pack(T, Type, Value, BigEndian)
+    PackSB(rawget(T, "__OBJECT"), Type, Value, BigEndian)
+    return T
+end
+
+function SBMethods.ToString(T)
+    return ToStringSB(rawget(T, "__OBJECT"))
+end
+
+function SBMethods.Len(T)
+    return LenSB(rawget(T, "__OBJECT"))
+end
+
+function SBMethods.Clear(T)
+    ClearSB(rawget(T, "__OBJECT"))
+    return T
+end
+
+function SBMethods.Destroy(T)
+    DestroySB(rawget(T, "__OBJECT"))
+end
+
+setreadonly(syn, false)
+
+syn.string_builder = function(Reserve)
+    return setmetatable({ __OBJECT = CreateSB(Reserve) }, SBMT)
+end
+
+--buffer API
+local CreateBuf = createbuffer
+local ReadBuf = bufferread
+local WriteBuf = bufferwrite
+local ReadStrBuf = bufferreadstring
+local WriteStrBuf = bufferwritestring
+local SliceBuf = bufferslice
+local LenBuf = bufferlen
+local ToStringBuf = buffertostring
+local DestroyBuf = destroybuffer
+
+local BufMethods = {}
+local BufMT = { __index = BufMethods, __type = "Buffer" }
+
+local function WrapBuf(Handle)
+    return setmetatable({ __OBJECT = Handle }, BufMT)
+end
+
+function BufMT.__tostring(T)
+    return ToStringBuf(rawget(T, "__OBJECT"))
+end
+
+function BufMethods.Read(T, Type, Offset, BigEndian)
+    return ReadBuf(rawget(T, "__OBJECT"), Type, Offset, BigEndian)
+end
+
+function BufMethods.Write(T, Type, Offset, Value, BigEndian)
+    WriteBuf(rawget(T, "__OBJECT"), Type, Offset, Value, BigEndian)
+    return T
+end
+
+function BufMethods.ReadString(T, Offset, Len)
+    return ReadStrBuf(rawget(T, "__OBJECT"), Offset, Len)
+end
+
+function BufMethods.WriteString(T, Offset, Data)
+    WriteStrBuf(rawget(T, "__OBJECT"), Offset, Data)
+    return T
+end
+
+function BufMethods.Slice(T, Offset, Len)
+    return WrapBuf(SliceBuf(rawget(T, "__OBJECT"), Offset, Len))
+end
+
+function BufMethods.Len(T)
+    return LenBuf(rawget(T, "__OBJECT"))
+end
+
+function BufMethods.ToString(T)
+    return ToStringBuf(rawget(T, "__OBJECT"))
+end
+
+function BufMethods.Destroy(T)
+    DestroyBuf(rawget(T, "__OBJECT"))
+end
+
+syn.buffer = function(SizeOrString)
+    return WrapBuf(CreateBuf(SizeOrString))
+end
+
+--xxhash streams
+local CreateXXH = createxxhash
+local UpdateXXH = xxhashupdate
+local DigestXXH = xxhashdigest
+local DestroyXXH = destroyxxhash
+
+local XXHMethods = {}
+local XXHMT = { __index = XXHMethods, __type = "XXHashStream" }
+
+function XXHMethods.Update(T, Data)
+    UpdateXXH(rawget(T, "__OBJECT"), Data)
+    return T
+end
+
+function XXHMethods.Digest(T)
+    return DigestXXH(rawget(T, "__OBJECT"))
+end
+
+function XXHMethods.Destroy(T)
+    DestroyXXH(rawget(T, "__OBJECT"))
+end
+
+syn.crypt.xxhash.stream = function(Bits, Seed)
+    return setmetatable({ __OBJECT = CreateXXH(Bits, Seed) }, XXHMT)
+end
+
+--aes-gcm cipher streams
+local CreateCipher = createcipher
+local UpdateCipher = cipherupdate
+local FinalCipher = cipherfinal
+local IVCipher = cipheriv
+local DestroyCipher = destroycipher
+
+local CipherMethods = {}
+local CipherMT = { __index = CipherMethods, __type = "CipherStream" }
+
+function CipherMethods.Update(T, Data)
+    return UpdateCipher(rawget(T, "__OBJECT"), Data)
+end
+
+function CipherMethods.Final(T, Tag)
+    return FinalCipher(rawget(T, "__OBJECT"), Tag)
+end
+
+function CipherMethods.IV(T)
+    return IVCipher(rawget(T, "__OBJECT"))
+end
+
+function CipherMethods.Destroy(T)
+    DestroyCipher(rawget(T, "__OBJECT"))
+end
+
+syn.crypt.cipher = function(Mode, Key, IV)
+    return setmetatable({ __OBJECT = CreateCipher(Mode, Key, IV) }, CipherMT)
+end
+
+setreadonly(syn, true)
+
+
 --overwrite useless functions
 getgenv().setndm = nil
 getgenv().getndm = nil
@@ -1303,6 +1732,35 @@ getgenv().getrenderproperty = nil
 getgenv().setrenderproperty = nil
 getgenv().createrenderobject = nil
 getgenv().destroyrenderobject = nil
+getgenv().sweeprenderobjects = nil
+getgenv().setrenderpropertybulk = nil
+getgenv().getrenderpropertyids = nil
+getgenv().createstringbuilder = nil
+getgenv().stringbuilderappend = nil
+getgenv().stringbuilderrep = nil
+getgenv().stringbuilderpack = nil
+getgenv().stringbuildertostring = nil
+getgenv().stringbuilderlen = nil
+getgenv().stringbuilderclear = nil
+getgenv().destroystringbuilder = nil
+getgenv().createbuffer = nil
+getgenv().bufferread = nil
+getgenv().bufferwrite = nil
+getgenv().bufferreadstring = nil
+getgenv().bufferwritestring = nil
+getgenv().bufferslice = nil
+getgenv().bufferlen = nil
+getgenv().buffertostring = nil
+getgenv().destroybuffer = nil
+getgenv().createxxhash = nil
+getgenv().xxhashupdate = nil
+getgenv().xxhashdigest = nil
+getgenv().destroyxxhash = nil
+getgenv().createcipher = nil
+getgenv().cipherupdate = nil
+getgenv().cipherfinal = nil
+getgenv().cipheriv = nil
+getgenv().destroycipher = nil
 getgenv().disableconnection = nil
 getgenv().enableconnection = nil
 getgenv().getconnectionstate = nil
@@ -11,12 +11,14 @@ using System.Reflection;
 using System.Security.AccessControl;
 using System.Security.Principal;
 using System.Threading;
+using System.Threading.Tasks;
 using System.Windows;
 using System.Windows.Threading;
 using Microsoft.Win32;
 using Newtonsoft.Json;
 using sxlib.Internal;
 using sxlib.Static;
+using Synapse_UI_WPF.Static;
 using Process = System.Diagnostics.Process;
 
 namespace sxlib.Specialized
@@ -56,6 +58,7 @@ namespace sxlib.Specialized
 
         /// <summary>
         /// Loading events for Synapse (will be sent as callbacks with the 'Load' function)
+        /// Progress events (CHECKING_WL to DOWNLOADING_DLLS) carry the rough load percentage as their parameter.
         /// </summary>
         public enum SynLoadEvents
         {
@@ -301,10 +304,30 @@ namespace sxlib.Specialized
 
         [Obfuscation(Feature = "virtualization", Exclude = false)]
         protected bool LoadInternal()
+        {
+            if (!BeginLoad()) return false;
+
+            Task.Run(() => LoadCore(CancellationToken.None));
+
+            return true;
+        }
+
+        [Obfuscation(Feature = "virtualization", Exclude = false)]
+        protected Task<bool> LoadAsyncInternal(CancellationToken Cancel)
+        {
+            if (!BeginLoad()) return Task.FromResult(false);
+
+            return Task.Run(() => LoadCore(Cancel));
+        }
+
+        /* Reads the options and takes the load mutex, false if a load is already running or done */
+        [Obfuscation(Feature = "virtualization", Exclude = false)]
+        private bool BeginLoad()
         {
             if (IsLoaded) throw new InvalidOperationException("SxLib is already loaded.");
 
             DataInterface.BaseDir = SynapseDir;
+            Downloader.CacheFolder = SynapseDir + "bin\\cache";
 
             if (!DataInterface.Exists("options"))
             {
@@ -378,8 +401,6 @@ namespace sxlib.Specialized
             if (LoadMutex) return false;
             LoadMutex = true;
 
-            new Thread(LoadThread).Start();
-
             return true;
         }
 
@@ -575,8 +596,24 @@ namespace sxlib.Specialized
             return false;
         }
 
+        /* Returns once READY (true) or a failure (false) has been sent. Cancelling stops it before the next phase, nothing is
+           set up until the files are in place so a cancelled load can simply be started again */
         [Obfuscation(Feature = "virtualization", Exclude = false)]
-        private void LoadThread()
+        private bool LoadCore(CancellationToken Cancel)
+        {
+            try
+            {
+                return LoadPhases(Cancel);
+            }
+            catch (OperationCanceledException)
+            {
+                LoadMutex = false;
+                throw;
+            }
+        }
+
+        [Obfuscation(Feature = "virtualization", Exclude = false)]
+        private bool LoadPhases(CancellationToken Cancel)
         {
             try
             {
@@ -586,13 +623,13 @@ namespace sxlib.Specialized
             catch (Exception)
             {
                 LoadEventInternal(SynLoadEvents.UNKNOWN);
-                return;
+                return false;
             }
 
             WebInterface.InitHwid();
             VerifyWebsite();
 
-            LoadEventInternal(SynLoadEvents.CHECKING_WL);
+            LoadEventInternal(SynLoadEvents.CHECKING_WL, 25);
 
             if (DataInterface.Exists("login"))
             {
@@ -604,12 +641,12 @@ namespace sxlib.Specialized
                 catch (Exception)
                 {
                     LoadEventInternal(SynLoadEvents.NOT_LOGGED_IN);
-                    return;
+                    return false;
                 }
 
-                LoadEventInternal(SynLoadEvents.CHANGING_WL);
+                LoadEventInternal(SynLoadEvents.CHANGING_WL, 25);
 
-                if (!this.Login(Login.Username, Login.Password)) return;
+                if (!this.Login(Login.Username, Login.Password)) return false;
             }
 
             var WlStatus = WebInterface.Check();
@@ -629,16 +666,16 @@ namespace sxlib.Specialized
                             catch (Exception)
                             {
                                 LoadEventInternal(SynLoadEvents.NOT_LOGGED_IN);
-                                return;
+                                return false;
                             }
 
-                            LoadEventInternal(SynLoadEvents.CHANGING_WL);
-                            if (!ChangeWhitelist(Token)) return;
+                            LoadEventInternal(SynLoadEvents.CHANGING_WL, 25);
+                            if (!ChangeWhitelist(Token)) return false;
                         }
                         else
                         {
                             LoadEventInternal(SynLoadEvents.NOT_LOGGED_IN);
-                            return;
+                            return false;
                         }
 
                         break;
@@ -647,19 +684,19 @@ namespace sxlib.Specialized
                     case WebInterface.WhitelistCheckResult.UNAUTHORIZED_HWID:
                     {
                         LoadEventInternal(SynLoadEvents.UNAUTHORIZED_HWID);
-                        return;
+                        return false;
                     }
 
                     case WebInterface.WhitelistCheckResult.EXPIRED_LICENCE:
                     {
                         LoadEventInternal(SynLoadEvents.UNAUTHORIZED_HWID);
-                        return;
+                        return false;
                     }
 
                     default:
                     {
                         LoadEventInternal(SynLoadEvents.UNKNOWN);
-                        return;
+                        return false;
                     }
                 }
             }
@@ -668,21 +705,23 @@ namespace sxlib.Specialized
                 if (!DataInterface.Exists("token"))
                 {
                     LoadEventInternal(SynLoadEvents.NOT_LOGGED_IN);
-                    return;
+                    return false;
                 }
             }
 
-            LoadEventInternal(SynLoadEvents.DOWNLOADING_DATA);
+            Cancel.ThrowIfCancellationRequested();
+            LoadEventInternal(SynLoadEvents.DOWNLOADING_DATA, 50);
 
             var Data = WebInterface.GetData();
 
-            LoadEventInternal(SynLoadEvents.CHECKING_DATA);
+            Cancel.ThrowIfCancellationRequested();
+            LoadEventInternal(SynLoadEvents.CHECKING_DATA, 75);
 
 #if USE_UPDATE_CHECKS
             if (!Data.IsUpdated)
             {
                 LoadEventInternal(SynLoadEvents.NOT_UPDATED);
-                return;
+                return false;
             }
 #endif
 
@@ -693,130 +732,9 @@ namespace sxlib.Specialized
             Globals.DllPath = DllName;
             Globals.LauncherPath = LauncherName;
 
-            using (var WC = new WebClient())
-            {
-#if USE_UPDATE_CHECKS
-                try
-                {
-                    var Salt = Utils.Sha512Bytes(Environment.MachineName + Data.Version);
-
-                    if (!File.Exists(DllName))
-                    {
-                        LoadEventInternal(SynLoadEvents.DOWNLOADING_DLLS);
-                        WC.DownloadFile(Globals.Options.BetaRelease ? Data.BetaDllDownload : Data.DllDownload, DllName);
-                        Utils.AppendAllBytes(DllName, Salt);
-                    }
-
-                    if (Utils.Sha512Dll(DllName) != (Globals.Options.BetaRelease ? Data.BetaDllHash : Data.DllHash))
-                    {
-                        LoadEventInternal(SynLoadEvents.DOWNLOADING_DLLS);
-                        File.Delete(DllName);
-                        WC.DownloadFile(Globals.Options.BetaRelease ? Data.BetaDllDownload : Data.DllDownload, DllName);
-                        Utils.AppendAllBytes(DllName, Salt);
-
-                        if (Utils.Sha512Dll(DllName) != (Globals.Options.BetaRelease ? Data.BetaDllHash : Data.DllHash))
-                        {
-                            File.Delete(DllName);
-
-                            LoadEventInternal(SynLoadEvents.FAILED_TO_VERIFY);
-                            return;
-                        }
-                    }
-                }
-                catch (Exception)
-                {
-                    LoadEventInternal(SynLoadEvents.FAILED_TO_DOWNLOAD);
-                    return;
-                }
-#endif
-
-                try
-                {
-                    if (!File.Exists(SynapseDir + "bin\\Monaco.html"))
-                    {
-                        WC.DownloadFile("https://cdn.synapse.to/synapsedistro/distro/Monaco.zip", SynapseDir + "bin\\Monaco.zip");
-
-                        ZipFile.ExtractToDirectory(SynapseDir + "bin\\Monaco.zip", SynapseDir + "bin");
-                        File.Delete(SynapseDir + "bin\\Monaco.zip");
-                    }
-
-                    if (!File.Exists(SynapseDir + "bin\\CefSharp.dll"))
-                    {
-                        WC.DownloadFile(Data.CefSharpDownload, SynapseDir + "bin\\CefSharp.zip");
-
-                        if (Utils.Sha512(SynapseDir + "bin\\CefSharp.zip", true) != Data.CefSharpHash)
-                        {
-                            File.Delete(SynapseDir + "bin\\CefSharp.zip");
-
-                            LoadEventInternal(SynLoadEvents.FAILED_TO_VERIFY);
-                            return;
-                        }
-
-                        ZipFile.ExtractToDirectory(SynapseDir + "bin\\CefSharp.zip", SynapseDir + "bin");
-                        File.Delete(SynapseDir + "bin\\CefSharp.zip");
-                    }
-                }
-                catch (Exception)
-                {
-                    LoadEventInternal(SynLoadEvents.FAILED_TO_DOWNLOAD);
-                    return;
-                }
-
-                try
-                {
-                    if (!Directory.Exists("bin\\x64")) Directory.CreateDirectory("bin\\x64");
-                    if (!Directory.Exists("bin\\x86")) Directory.CreateDirectory("bin\\x86");
-                    if (!Directory.Exists("bin\\redis")) Directory.CreateDirectory("bin\\redis");
-
-                    if (!File.Exists("bin\\x64\\SQLite.Interop.dll") || !File.Exists("bin\\x86\\SQLite.Interop.dll") ||
-                        !File.Exists("bin\\redis\\D3DCompiler_43.dll") || !File.Exists("bin\\redis\\xinput1_3.dll"))
-                    {
-                        //SQLite
-                        WC.DownloadFile("https://cdn.synapse.to/synapsedistro/distro/sqlite_x64.dll",
-                            "bin\\x64\\SQLite.Interop.dll");
-                        WC.DownloadFile("https://cdn.synapse.to/synapsedistro/distro/sqlite_x86.dll",
-                            "bin\\x86\\SQLite.Interop.dll");
-
-                        //D3D redist
-                        WC.DownloadFile("https://cdn.synapse.to/synapsedistro/distro/redis/D3DCompiler_43.dll",
-                            "bin\\redis\\D3DCompiler_43.dll");
-                        WC.DownloadFile("https://cdn.synapse.to/synapsedistro/distro/redis/xinput1_3.dll",
-                            "bin\\redis\\xinput1_3.dll");
-                    }
-                }
-                catch (Exception)
-                {
-                    LoadEventInternal(SynLoadEvents.FAILED_TO_DOWNLOAD);
-                    return;
-                }
-
-#if USE_UPDATE_CHECKS
-                try
-                {
-                    if (!File.Exists(LauncherName)) WC.DownloadFile(Data.LauncherDownload, LauncherName);
-
-                    if (Utils.Sha512(LauncherName, true) != Data.LauncherHash)
-                    {
-                        File.Delete(LauncherName);
-                        WC.DownloadFile(Data.LauncherDownload, LauncherName);
-
-                        if (Utils.Sha512(LauncherName, true) != Data.LauncherHash)
-                        {
-                            File.Delete(LauncherName);
-                            MessageBox.Show("Failed to verify launcher files. Please check your anti-virus software.",
-                                "Synapse X", MessageBoxButton.OK, MessageBoxImage.Error);
-                            Environment.Exit(0);
-                        }
-                    }
-                }
-                catch (Exception)
-                {
-                    MessageBox.Show("Failed to download launcher files. Please check your anti-virus software.",
-                        "Synapse X", MessageBoxButton.OK, MessageBoxImage.Error);
-                    Environment.Exit(0);
-                }
-#endif
-            }
+            /* The files download while the launcher registration below runs, neither waits on the other */
+            var Files = Task.Run(() => SyncFiles(Data, DllName, LauncherName,
+                () => LoadEventInternal(SynLoadEvents.DOWNLOADING_DLLS, 85), Cancel), Cancel);
 
             if (Globals.Options.AutoLaunch)
             {
@@ -879,6 +797,18 @@ namespace sxlib.Specialized
                 catch (Exception) { }
             }
 
+            switch (Files.GetAwaiter().GetResult())
+            {
+                case SyncResult.FAILED_TO_DOWNLOAD:
+                    LoadEventInternal(SynLoadEvents.FAILED_TO_DOWNLOAD);
+                    return false;
+                case SyncResult.FAILED_TO_VERIFY:
+                    LoadEventInternal(SynLoadEvents.FAILED_TO_VERIFY);
+                    return false;
+            }
+
+            Cancel.ThrowIfCancellationRequested();
+
             StreamReader InteractReader = null;
             StreamReader LaunchReader;
 
@@ -1039,7 +969,94 @@ namespace sxlib.Specialized
             IsLoaded = true;
             LoadEventInternal(SynLoadEvents.READY, Globals.Version);
 
-            Thread.Sleep(1500);
+            return true;
+        }
+
+        private enum SyncResult
+        {
+            OK,
+            FAILED_TO_DOWNLOAD,
+            FAILED_TO_VERIFY
+        }
+
+        /* Everything missing or out of date is fetched at once with the official UI's Downloader, so both share its
+           content addressed cache (bin\cache) and a file either of them already verified is never downloaded again.
+           A bad launcher still ends the process, as it always has */
+        [Obfuscation(Feature = "virtualization", Exclude = false)]
+        private SyncResult SyncFiles(Data.UIData Data, string DllName, string LauncherName, Action OnDllStart, CancellationToken Token)
+        {
+            const string CdnBase = "https://cdn.synapse.to/synapsedistro/distro/";
+            var Bin = SynapseDir + "bin\\";
+            var Downloads = new List<Download>();
+
+            Download Queue(string Url, string FilePath, string Hash, byte[] Salt = null)
+            {
+                var Job = new Download { Url = Url, Path = FilePath, Hash = Hash, Salt = Salt };
+                Downloads.Add(Job);
+                return Job;
+            }
+
+            Download DllJob = null;
+            Download LauncherJob = null;
+
+            try
+            {
+#if USE_UPDATE_CHECKS
+                DllJob = Queue(Globals.Options.BetaRelease ? Data.BetaDllDownload : Data.DllDownload, DllName,
+                    Globals.Options.BetaRelease ? Data.BetaDllHash : Data.DllHash,
+                    Utils.Sha512Bytes(Environment.MachineName + Data.Version));
+                LauncherJob = Queue(Data.LauncherDownload, LauncherName, Data.LauncherHash);
+#endif
+
+                var MonacoJob = File.Exists(Bin + "Monaco.html") ? null : Queue(CdnBase + "Monaco.zip", Bin + "Monaco.zip", null);
+                var CefSharpJob = File.Exists(Bin + "CefSharp.dll") ? null : Queue(Data.CefSharpDownload, Bin + "CefSharp.zip", Data.CefSharpHash);
+
+                /* Archives unpack on their download worker while the other files are still coming in */
+                void Unpack(Download Job)
+                {
+                    Unzipper.Extract(Job.Path, SynapseDir + "bin");
+                    File.Delete(Job.Path);
+                }
+
+                if (MonacoJob != null) MonacoJob.Then = Unpack;
+                if (CefSharpJob != null) CefSharpJob.Then = Unpack;
+
+                Queue(CdnBase + "sqlite_x64.dll", Bin + "x64\\SQLite.Interop.dll", null);
+                Queue(CdnBase + "sqlite_x86.dll", Bin + "x86\\SQLite.Interop.dll", null);
+                Queue(CdnBase + "redis/D3DCompiler_43.dll", Bin + "redis\\D3DCompiler_43.dll", null);
+                Queue(CdnBase + "redis/xinput1_3.dll", Bin + "redis\\xinput1_3.dll", null);
+
+                Downloader.Run(4, Job =>
+                {
+                    if (Job == DllJob) OnDllStart();
+                }, Token, Downloads.ToArray());
+
+                if (DllJob != null && !DllJob.Succeeded)
+                    return DllJob.Error == null ? SyncResult.FAILED_TO_VERIFY : SyncResult.FAILED_TO_DOWNLOAD;
+                if (CefSharpJob != null && !CefSharpJob.Succeeded && CefSharpJob.Error == null)
+                    return SyncResult.FAILED_TO_VERIFY;
+                if (Downloads.Any(Job => Job != LauncherJob && !Job.Succeeded))
+                    return SyncResult.FAILED_TO_DOWNLOAD;
+            }
+            catch (OperationCanceledException)
+            {
+                throw;
+            }
+            catch (Exception)
+            {
+                return SyncResult.FAILED_TO_DOWNLOAD;
+            }
+
+            if (LauncherJob != null && !LauncherJob.Succeeded)
+            {
+                MessageBox.Show(LauncherJob.Error == null
+                        ? "Failed to verify launcher files. Please check your anti-virus software."
+                        : "Failed to download launcher files. Please check your anti-virus software.",
+                    "Synapse X", MessageBoxButton.OK, MessageBoxImage.Error);
+                Environment.Exit(0);
+            }
+
+            return SyncResult.OK;
         }
 
         [Obfuscation(Feature = "virtualization", Exclude = false)]
@@ -1111,133 +1128,12 @@ namespace sxlib.Specialized
             var DllName = SynapseDir + "bin\\" + Utils.CreateFileName("Synapse.dll");
             var LauncherName = SynapseDir + "bin\\" + Utils.CreateFileName("Synapse Launcher.exe");
 
-            using (var WC = new WebClient())
+            if (SyncFiles(Data, DllName, LauncherName, () => AttachEventInternal?.Invoke(SynAttachEvents.UPDATING_DLLS),
+                    CancellationToken.None) != SyncResult.OK)
             {
-#if USE_UPDATE_CHECKS
-                try
-                {
-                    var Salt = Utils.Sha512Bytes(Environment.MachineName + Data.Version);
-
-                    if (!File.Exists(DllName))
-                    {
-                        AttachEventInternal?.Invoke(SynAttachEvents.UPDATING_DLLS);
-                        WC.DownloadFile(Globals.Options.BetaRelease ? Data.BetaDllDownload : Data.DllDownload, DllName);
-                        Utils.AppendAllBytes(DllName, Salt);
-                    }
-
-                    if (Utils.Sha512Dll(DllName) != (Globals.Options.BetaRelease ? Data.BetaDllHash : Data.DllHash))
-                    {
-                        AttachEventInternal?.Invoke(SynAttachEvents.UPDATING_DLLS);
-                        File.Delete(DllName);
-                        WC.DownloadFile(Globals.Options.BetaRelease ? Data.BetaDllDownload : Data.DllDownload, DllName);
-                        Utils.AppendAllBytes(DllName, Salt);
-
-                        if (Utils.Sha512Dll(DllName) != (Globals.Options.BetaRelease ? Data.BetaDllHash : Data.DllHash))
-                        {
-                            File.Delete(DllName);
-
-                            IsInlineUpdating = false;
-                            AttachEventInternal?.Invoke(SynAttachEvents.FAILED_TO_UPDATE);
-                            return;
-                        }
-                    }
-                }
-                catch (Exception)
-                {
-                    IsInlineUpdating = false;
-                    AttachEventInternal?.Invoke(SynAttachEvents.FAILED_TO_UPDATE);
-                    return;
-                }
-#endif
-                try
-                {
-                    if (!File.Exists(SynapseDir + "bin\\Monaco.html"))
-                    {
-                        WC.DownloadFile("https://cdn.synapse.to/synapsedistro/distro/Monaco.zip", SynapseDir + "bin\\Monaco.zip");
-
-                        ZipFile.ExtractToDirectory(SynapseDir + "bin\\Monaco.zip", SynapseDir + "bin");
-                        File.Delete(SynapseDir + "bin\\Monaco.zip");
-                    }
-
-                    if (!File.Exists(SynapseDir + "bin\\CefSharp.dll"))
-                    {
-                        WC.DownloadFile(Data.CefSharpDownload, SynapseDir + "bin\\CefSharp.zip");
-
-                        if (Utils.Sha512(SynapseDir + "bin\\CefSharp.zip", true) != Data.CefSharpHash)
-                        {
-                            File.Delete(SynapseDir + "bin\\CefSharp.zip");
-
-                            IsInlineUpdating = false;
-                            AttachEventInternal?.Invoke(SynAttachEvents.FAILED_TO_UPDATE);
-                            return;
-                        }
-
-                        ZipFile.ExtractToDirectory(SynapseDir + "bin\\CefSharp.zip", SynapseDir + "bin");
-                        File.Delete(SynapseDir + "bin\\CefSharp.zip");
-                    }
-                }
-                catch (Exception)
-                {
-                    IsInlineUpdating = false;
-                    AttachEventInternal?.Invoke(SynAttachEvents.FAILED_TO_UPDATE);
-                    return;
-                }
-
-                try
-                {
-                    if (!Directory.Exists("bin\\x64")) Directory.CreateDirectory("bin\\x64");
-                    if (!Directory.Exists("bin\\x86")) Directory.CreateDirectory("bin\\x86");
-                    if (!Directory.Exists("bin\\redis")) Directory.CreateDirectory("bin\\redis");
-
-                    if (!File.Exists("bin\\x64\\SQLite.Interop.dll") || !File.Exists("bin\\x86\\SQLite.Interop.dll") ||
-                        !File.Exists("bin\\redis\\D3DCompiler_43.dll") || !File.Exists("bin\\redis\\xinput1_3.dll"))
-                    {
-                        //SQLite
-                        WC.DownloadFile("https://cdn.synapse.to/synapsedistro/distro/sqlite_x64.dll",
-                            "bin\\x64\\SQLite.Interop.dll");
-                        WC.DownloadFile("https://cdn.synapse.to/synapsedistro/distro/sqlite_x86.dll",
-                            "bin\\x86\\SQLite.Interop.dll");
-
-                        //D3D redist
-                        WC.DownloadFile("https://cdn.synapse.to/synapsedistro/distro/redis/D3DCompiler_43.dll",
-                            "bin\\redis\\D3DCompiler_43.dll");
-                        WC.DownloadFile("https://cdn.synapse.to/synapsedistro/distro/redis/xinput1_3.dll",
-                            "bin\\redis\\xinput1_3.dll");
-                    }
-                }
-                catch (Exception)
-                {
-                    IsInlineUpdating = false;
-                    AttachEventInternal?.Invoke(SynAttachEvents.FAILED_TO_UPDATE);
-                    return;
-                }
-
-#if USE_UPDATE_CHECKS
-                try
-                {
-                    if (!File.Exists(LauncherName)) WC.DownloadFile(Data.LauncherDownload, LauncherName);
-
-                    if (Utils.Sha512(LauncherName, true) != Data.LauncherHash)
-                    {
-                        File.Delete(LauncherName);
-                        WC.DownloadFile(Data.LauncherDownload, LauncherName);
-
-                        if (Utils.Sha512(LauncherName, true) != Data.LauncherHash)
-                        {
-                            File.Delete(LauncherName);
-                            MessageBox.Show("Failed to verify launcher files. Please check your anti-virus software.",
-                                "Synapse X", MessageBoxButton.OK, MessageBoxImage.Error);
-                            Environment.Exit(0);
-                        }
-                    }
-                }
-                catch (Exception)
-                {
-                    MessageBox.Show("Failed to download launcher files. Please check your anti-virus software.",
-                        "Synapse X", MessageBoxButton.OK, MessageBoxImage.Error);
-                    Environment.Exit(0);
-                }
-#endif
+                IsInlineUpdating = false;
+                AttachEventInternal?.Invoke(SynAttachEvents.FAILED_TO_UPDATE);
+                return;
             }
 
             Globals.Version = Data.Version;
@@ -1316,7 +1212,7 @@ namespace sxlib.Specialized
             if (Globals.Version != VerifyWebsiteWithVersion())
             {
                 IsInlineUpdating = true;
-                new Thread(InlineAutoUpdate).Start();
+                Task.Run(() => InlineAutoUpdate());
 
                 return;
             }
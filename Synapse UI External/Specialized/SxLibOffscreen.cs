@@ -3,6 +3,7 @@ using System.Collections.Generic;
 using System.Linq;
 using System.Reflection;
 using System.Text;
+using System.Threading;
 using System.Threading.Tasks;
 using sxlib.Internal;
 using sxlib.Static;
@@ -86,6 +87,16 @@ namespace sxlib.Specialized
             return LoadInternal();
         }
 
+        /// <summary>
+        /// Async version of SxLib.Load(). 'LoadEvent' is still called back for every phase.
+        /// </summary>
+        /// <param name="Token">Cancels loading before its next phase, SxLib.Load() can be called again afterwards.</param>
+        /// <returns>A task completing with true once Synapse X is ready, false if loading failed (the reason is sent to 'LoadEvent') or was already started.</returns>
+        public Task<bool> LoadAsync(CancellationToken Token = default(CancellationToken))
+        {
+            return LoadAsyncInternal(Token);
+        }
+
         /// <summary>
         /// This will start the initial attaching process of Synapse X. You must attach a handler to 'AttachEvent' to get callback events from this function.
         /// </summary>
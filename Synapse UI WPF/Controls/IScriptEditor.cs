@@ -0,0 +1,54 @@
+﻿using System.Collections.Generic;
+using System.Threading.Tasks;
+
+namespace Synapse_UI_WPF.Controls
+{
+    public delegate void EditorReadyDelegate();
+
+    /// <summary>
+    /// What MainWindow needs from its editor, implemented by the CefSharp Monaco page and by the native editor.
+    /// Nothing here may name a CefSharp type, the native editor runs without CefSharp on disk.
+    /// </summary>
+    public interface IScriptEditor
+    {
+        bool MonacoLoaded { get; }
+
+        int ActiveTab { get; }
+
+        event EditorReadyDelegate MonacoReady;
+
+        void SetTheme(MonacoTheme theme);
+
+        void SetText(string text);
+
+        Task<string> GetTextAsync();
+
+        void AppendText(string text);
+
+        void ApplyEdits(params MonacoEdit[] edits);
+
+        void GoToLine(int lineNumber);
+
+        void EditorRefresh();
+
+        void UpdateSettings(MonacoSettings settings);
+
+        void AddIntellisense(string label, string type, string description, string insert);
+
+        void ShowSyntaxError(int line, int column, int endLine, int endColumn, string message);
+
+        void ClearSyntaxError();
+
+        bool TryGetSyncedText(out string text, out long revision, out int idle);
+
+        bool TryGetSyncedText(int tab, out string text, out long revision, out int idle);
+
+        bool TryGetSyncedTabs(IList<int> tabs, out string[] texts, out long revision, out int idle);
+
+        int NewTab(string text);
+
+        void SwitchTab(int tab);
+
+        bool CloseTab(int tab);
+    }
+}
@@ -1,10 +1,16 @@
 ﻿using System;
+using System.Collections.Generic;
+using System.Linq;
 using System.Reflection;
+using System.Text;
+using System.Threading;
 using System.Threading.Tasks;
 using System.Windows.Input;
 using CefSharp;
 using CefSharp.Wpf;
 using CefSharp.Wpf.Internals;
+using Newtonsoft.Json;
+using Newtonsoft.Json.Linq;
 
 namespace Synapse_UI_WPF.Controls
 {
@@ -14,6 +20,18 @@ namespace Synapse_UI_WPF.Controls
         Dark = 1
     }
 
+    /// <summary>
+    /// Replaces the text between the start and end positions (1 based, end exclusive) with Text, see ApplyEdits.
+    /// </summary>
+    public class MonacoEdit
+    {
+        public int StartLine;
+        public int StartColumn;
+        public int EndLine;
+        public int EndColumn;
+        public string Text;
+    }
+
     public class MonacoSettings
     {
         public bool ReadOnly; // The ability to edit text.
@@ -28,28 +46,371 @@ namespace Synapse_UI_WPF.Controls
         public string RenderWhitespace; // "none" | "boundary" | "all"
     }
 
+    /// <summary>
+    /// Bound into the editor page as "monacoSync", Monaco pushes its content changes through it.
+    /// </summary>
+    [Obfuscation(Feature = "renaming", Exclude = true, ApplyToMembers = true)]
+    public class MonacoSync
+    {
+        private readonly Monaco Owner;
+
+        public MonacoSync(Monaco owner)
+        {
+            Owner = owner;
+        }
+
+        public void Full(int tab, int version, string text)
+        {
+            Owner.SyncFull(tab, version, text);
+        }
+
+        public void Changed(int tab, int version, string changes)
+        {
+            Owner.SyncChanged(tab, version, changes);
+        }
+    }
+
     [Obfuscation(Feature = "renaming", Exclude = true, ApplyToMembers = false)]
-    public class Monaco : ChromiumWebBrowser
+    public class Monaco : ChromiumWebBrowser, IScriptEditor
     {
-        public bool MonacoLoaded;
-        public delegate void MonacoReadyDelegate();
+        public bool MonacoLoaded { get; private set; }
 
         [Obfuscation(Feature = "renaming", Exclude = true)]
-        public event MonacoReadyDelegate MonacoReady;
+        public event EditorReadyDelegate MonacoReady;
+
+        /* Hooks the models once the page is up. Every change event is sent as [offset, length, text] triples against the
+           previous version of that tab's model, a replaced model or a whole new value is sent in full. Tabs are models on
+           this one editor, switching swaps the model and its view state so intellisense and the renderer are shared */
+        private const string SyncScript = @"(async function () {
+    if (typeof editor === 'undefined') return;
+
+    window.SynApplyEdits = function (edits) {
+        editor.executeEdits('synapse', JSON.parse(edits).map(function (e) {
+            return { range: new monaco.Range(e.StartLine, e.StartColumn, e.EndLine, e.EndColumn), text: e.Text, forceMoveMarkers: true };
+        }));
+    };
+
+    window.SynSetSyntaxError = function (line, column, endLine, endColumn, message) {
+        var severity = (monaco.MarkerSeverity || monaco.Severity).Error;
+        monaco.editor.setModelMarkers(editor.getModel(), 'synapse-syntax', line ? [{
+            startLineNumber: line, startColumn: column, endLineNumber: endLine, endColumn: endColumn, message: message, severity: severity
+        }] : []);
+    };
+
+    window.SynAppendText = function (text) {
+        var model = editor.getModel();
+        var line = model.getLineCount();
+        var column = model.getLineMaxColumn(line);
+        editor.executeEdits('synapse', [{ range: new monaco.Range(line, column, line, column), text: text, forceMoveMarkers: true }]);
+    };
+
+    await CefSharp.BindObjectAsync('monacoSync');
+
+    var models = { 0: editor.getModel() };
+    var views = {};
+    var active = 0;
+
+    window.SynResync = function (id) {
+        var model = models[id];
+        if (model) monacoSync.full(id, model.getVersionId(), model.getValue());
+    };
+
+    function hook(id, model) {
+        model.onDidChangeContent(function (e) {
+            if (models[id] !== model) return;
+
+            if (e.isFlush) {
+                monacoSync.full(id, e.versionId, model.getValue());
+                return;
+            }
+
+            monacoSync.changed(id, e.versionId, JSON.stringify(e.changes.map(function (c) {
+                return [c.rangeOffset, c.rangeLength, c.text];
+            })));
+        });
+
+        SynResync(id);
+    }
+
+    window.SynNewTab = function (id, text) {
+        var current = editor.getModel();
+        models[id] = monaco.editor.createModel(text, current.getLanguageId ? current.getLanguageId() : current.getModeId());
+        hook(id, models[id]);
+    };
+
+    window.SynSwitchTab = function (id) {
+        if (!models[id] || id === active) return;
+
+        views[active] = editor.saveViewState();
+        active = id;
+        editor.setModel(models[id]);
+        if (views[id]) editor.restoreViewState(views[id]);
+        editor.focus();
+    };
+
+    window.SynCloseTab = function (id) {
+        var model = models[id];
+        if (!model || id === active) return;
+
+        delete models[id];
+        delete views[id];
+        model.dispose();
+    };
+
+    /* A model the page swapped in by itself takes over the active tab */
+    editor.onDidChangeModel(function () {
+        var model = editor.getModel();
+        if (!model || models[active] === model) return;
+
+        models[active] = model;
+        hook(active, model);
+    });
+
+    hook(0, models[0]);
+})();";
+
+        private class TabSync
+        {
+            public readonly StringBuilder Text = new StringBuilder();
+            public int Version = -1;
+            public long Revision;
+            public int Tick;
+        }
+
+        private readonly object SyncLock = new object();
+        private readonly Dictionary<int, TabSync> Tabs = new Dictionary<int, TabSync> { { 0, new TabSync() } };
+        private long SyncedRevision;
+        private int NextTab = 1;
+        private volatile int Active;
+
+        /// <summary>
+        /// The tab the editor shows, 0 is the page's own model and always exists.
+        /// </summary>
+        public int ActiveTab
+        {
+            get { return Active; }
+        }
+
+        /* Safe to call more than once. LoadWindow calls it as soon as CefSharp is on disk, so the CEF subprocesses are
+           already up by the time MainWindow builds its editor */
+        public static void InitializeCef()
+        {
+            if (Cef.IsInitialized) return;
+
+            Cef.EnableHighDPISupport();
+            var settings = new CefSettings();
+            settings.SetOffScreenRenderingBestPerformanceArgs();
+            Cef.Initialize(settings);
+        }
 
         public Monaco()
         {
             Address = $"file:///{Environment.CurrentDirectory.Replace("\\", "/")}/bin/Monaco.html";
 
+            JavascriptObjectRepository.Register("monacoSync", new MonacoSync(this), true);
+
             LoadingStateChanged += (sender, args) =>
             {
                 if (args.IsLoading) return;
 
+                /* A fresh page only has its own model again */
+                lock (SyncLock)
+                {
+                    Tabs.Clear();
+                    Tabs.Add(0, new TabSync());
+                }
+                Active = 0;
+
+                this.ExecuteScriptAsync(SyncScript);
+
                 MonacoLoaded = true;
                 MonacoReady?.Invoke();
             };
         }
 
+        internal void SyncFull(int tab, int version, string text)
+        {
+            lock (SyncLock)
+            {
+                TabSync Sync;
+                if (!Tabs.TryGetValue(tab, out Sync)) return;
+
+                Sync.Text.Clear().Append(text);
+                Sync.Version = version;
+                Sync.Revision = ++SyncedRevision;
+                Sync.Tick = Environment.TickCount;
+            }
+        }
+
+        internal void SyncChanged(int tab, int version, string changes)
+        {
+            lock (SyncLock)
+            {
+                TabSync Sync;
+                if (!Tabs.TryGetValue(tab, out Sync)) return;
+
+                /* A dropped event would leave the copy wrong from here on, so start over from the page's text */
+                if (Sync.Version < 0 || version != Sync.Version + 1 || !ApplyChanges(Sync.Text, changes))
+                {
+                    Sync.Version = -1;
+                    this.ExecuteScriptAsync("SynResync", tab);
+                    return;
+                }
+
+                Sync.Version = version;
+                Sync.Revision = ++SyncedRevision;
+                Sync.Tick = Environment.TickCount;
+            }
+        }
+
+        private static bool ApplyChanges(StringBuilder SyncedText, string changes)
+        {
+            try
+            {
+                /* Offsets are all against the previous version, applying from the back keeps the earlier ones valid */
+                foreach (var Change in JArray.Parse(changes).OrderByDescending(C => (int) C[0]))
+                {
+                    var Offset = (int) Change[0];
+                    var Length = (int) Change[1];
+                    if (Offset < 0 || Length < 0 || Offset + Length > SyncedText.Length) return false;
+
+                    SyncedText.Remove(Offset, Length).Insert(Offset, (string) Change[2]);
+                }
+
+                return true;
+            }
+            catch (Exception)
+            {
+                return false;
+            }
+        }
+
+        /// <summary>
+        /// Get's the active tab's text as last pushed by Monaco without touching the UI thread. False until the page has synced,
+        /// revision changes with every edit and idle is how long ago the last one was, in milliseconds.
+        /// </summary>
+        /// <param name="text"></param>
+        /// <param name="revision"></param>
+        /// <param name="idle"></param>
+        /// <returns></returns>
+        public bool TryGetSyncedText(out string text, out long revision, out int idle)
+        {
+            return TryGetSyncedText(Active, out text, out revision, out idle);
+        }
+
+        /// <summary>
+        /// Same as above for any open tab, revisions are unique across tabs.
+        /// </summary>
+        /// <param name="tab"></param>
+        /// <param name="text"></param>
+        /// <param name="revision"></param>
+        /// <param name="idle"></param>
+        /// <returns></returns>
+        public bool TryGetSyncedText(int tab, out string text, out long revision, out int idle)
+        {
+            lock (SyncLock)
+            {
+                text = null;
+                revision = 0;
+                idle = 0;
+
+                TabSync Sync;
+                if (!Tabs.TryGetValue(tab, out Sync)) return false;
+
+                revision = Sync.Revision;
+                idle = Environment.TickCount - Sync.Tick;
+                if (Sync.Version < 0) return false;
+
+                text = Sync.Text.ToString();
+                return true;
+            }
+        }
+
+        /// <summary>
+        /// Snapshot of several tabs at once, revision is the newest of them and idle the shortest. False unless every tab has synced.
+        /// </summary>
+        /// <param name="tabs"></param>
+        /// <param name="texts"></param>
+        /// <param name="revision"></param>
+        /// <param name="idle"></param>
+        /// <returns></returns>
+        public bool TryGetSyncedTabs(IList<int> tabs, out string[] texts, out long revision, out int idle)
+        {
+            lock (SyncLock)
+            {
+                texts = new string[tabs.Count];
+                revision = 0;
+                idle = int.MaxValue;
+
+                for (var i = 0; i < tabs.Count; i++)
+                {
+                    TabSync Sync;
+                    if (!Tabs.TryGetValue(tabs[i], out Sync) || Sync.Version < 0) return false;
+
+                    texts[i] = Sync.Text.ToString();
+                    revision = Math.Max(revision, Sync.Revision);
+                    idle = Math.Min(idle, Environment.TickCount - Sync.Tick);
+                }
+
+                return true;
+            }
+        }
+
+        /// <summary>
+        /// Opens a tab as a new model on the editor without showing it, returns its id or -1 before the page is up.
+        /// </summary>
+        /// <param name="text"></param>
+        /// <returns></returns>
+        public int NewTab(string text)
+        {
+            if (!MonacoLoaded) return -1;
+
+            int Id;
+            lock (SyncLock)
+            {
+                Id = NextTab++;
+                Tabs.Add(Id, new TabSync());
+            }
+
+            this.ExecuteScriptAsync("SynNewTab", Id, text);
+            return Id;
+        }
+
+        /// <summary>
+        /// Shows the tab, its cursor, selection and scroll come back as they were left.
+        /// </summary>
+        /// <param name="tab"></param>
+        public void SwitchTab(int tab)
+        {
+            if (!MonacoLoaded) return;
+
+            lock (SyncLock)
+            {
+                if (!Tabs.ContainsKey(tab)) return;
+            }
+
+            Active = tab;
+            this.ExecuteScriptAsync("SynSwitchTab", tab);
+        }
+
+        /// <summary>
+        /// Disposes the tab's model. The active tab and tab 0 can't be closed, switch away first.
+        /// </summary>
+        /// <param name="tab"></param>
+        /// <returns></returns>
+        public bool CloseTab(int tab)
+        {
+            if (!MonacoLoaded || tab == 0 || tab == Active) return false;
+
+            lock (SyncLock)
+            {
+                if (!Tabs.Remove(tab)) return false;
+            }
+
+            this.ExecuteScriptAsync("SynCloseTab", tab);
+            return true;
+        }
+
         protected override void OnMouseLeave(MouseEventArgs e)
         {
             e.Handled = true;
@@ -99,33 +460,41 @@ namespace Synapse_UI_WPF.Controls
                 this.ExecuteScriptAsync("SetText", text);
         }
 
-        private object EvaluateScript(string script)
+        private async Task<object> EvaluateScript(string script)
         {
-            var Task = this.EvaluateScriptAsync(script);
-            Task.Wait();
-            var Resp = Task.Result;
+            var Resp = await this.EvaluateScriptAsync(script).ConfigureAwait(false);
             return Resp.Success ? Resp.Result ?? "" : Resp.Message;
         }
 
         /// <summary>
-        /// Get's the text of Monaco and returns it.
+        /// Get's the text of Monaco. Completes once the page answered, never blocks the calling thread.
         /// </summary>
         /// <returns></returns>
-        public string GetText()
+        public async Task<string> GetTextAsync()
         {
             if (!MonacoLoaded) return "";
 
-            return (string) EvaluateScript("GetText();");
+            return (string) await EvaluateScript("GetText();").ConfigureAwait(false);
         }
 
         /// <summary>
-        /// Appends the text of Monaco with the parameter text.
+        /// Appends the parameter text to the end of Monaco, only the new text is sent to the page.
         /// </summary>
         /// <param name="text"></param>
         public void AppendText(string text)
         {
             if (MonacoLoaded)
-                SetText(GetText() + text);
+                this.ExecuteScriptAsync("SynAppendText", text);
+        }
+
+        /// <summary>
+        /// Applies the edits in one undo step through Monaco's executeEdits.
+        /// </summary>
+        /// <param name="edits"></param>
+        public void ApplyEdits(params MonacoEdit[] edits)
+        {
+            if (MonacoLoaded && edits.Length != 0)
+                this.ExecuteScriptAsync("SynApplyEdits", JsonConvert.SerializeObject(edits));
         }
 
         public void GoToLine(int lineNumber)
@@ -177,7 +546,7 @@ namespace Synapse_UI_WPF.Controls
         }
 
         /// <summary>
-        /// Creates a syntax error symbol (squiggly red line) on the specific parameters in the editor.
+        /// Creates a syntax error symbol (squiggly red line) on the specific parameters in the editor, replacing the last one.
         /// </summary>
         /// <param name="line"></param>
         /// <param name="column"></param>
@@ -187,7 +556,16 @@ namespace Synapse_UI_WPF.Controls
         public void ShowSyntaxError(int line, int column, int endLine, int endColumn, string message)
         {
             if (MonacoLoaded)
-                this.ExecuteScriptAsync("ShowErr", line, column, endLine, endColumn, message);
+                this.ExecuteScriptAsync("SynSetSyntaxError", line, column, endLine, endColumn, message);
+        }
+
+        /// <summary>
+        /// Removes the syntax error shown by ShowSyntaxError.
+        /// </summary>
+        public void ClearSyntaxError()
+        {
+            if (MonacoLoaded)
+                this.ExecuteScriptAsync("SynSetSyntaxError", 0, 0, 0, 0, "");
         }
     }
 }
@@ -0,0 +1,443 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Threading.Tasks;
+using System.Windows;
+using System.Windows.Input;
+using System.Windows.Media;
+using System.Windows.Threading;
+using System.Xml;
+using ICSharpCode.AvalonEdit;
+using ICSharpCode.AvalonEdit.CodeCompletion;
+using ICSharpCode.AvalonEdit.Document;
+using ICSharpCode.AvalonEdit.Editing;
+using ICSharpCode.AvalonEdit.Highlighting;
+using ICSharpCode.AvalonEdit.Highlighting.Xshd;
+using ICSharpCode.AvalonEdit.Indentation;
+using ICSharpCode.AvalonEdit.Rendering;
+
+namespace Synapse_UI_WPF.Controls
+{
+    /// <summary>
+    /// AvalonEdit stand-in for Monaco, picked with the NativeEditor option. No CEF processes and nothing to download,
+    /// at the cost of the minimap, folding and Monaco's suggestion ranking.
+    /// </summary>
+    public class NativeEditor : TextEditor, IScriptEditor
+    {
+        private const string LuaDefinition = @"<SyntaxDefinition name=""Lua"" xmlns=""http://icsharpcode.net/sharpdevelop/syntaxdefinition/2008"">
+    <Color name=""Comment"" foreground=""#FF6A9955"" />
+    <Color name=""String"" foreground=""#FFCE9178"" />
+    <Color name=""Number"" foreground=""#FFB5CEA8"" />
+    <Color name=""Keyword"" foreground=""#FF569CD6"" />
+    <Color name=""Value"" foreground=""#FF4FC1FF"" />
+    <RuleSet>
+        <Span color=""Comment"" multiline=""true"" begin=""--\[=*\["" end=""\]=*\]"" />
+        <Span color=""Comment"" begin=""--"" />
+        <Span color=""String"" multiline=""true"" begin=""\[=*\["" end=""\]=*\]"" />
+        <Span color=""String"">
+            <Begin>""</Begin>
+            <End>""</End>
+            <RuleSet>
+                <Span begin=""\\"" end=""."" />
+            </RuleSet>
+        </Span>
+        <Span color=""String"">
+            <Begin>'</Begin>
+            <End>'</End>
+            <RuleSet>
+                <Span begin=""\\"" end=""."" />
+            </RuleSet>
+        </Span>
+        <Keywords color=""Keyword"">
+            <Word>and</Word><Word>break</Word><Word>do</Word><Word>else</Word><Word>elseif</Word><Word>end</Word>
+            <Word>for</Word><Word>function</Word><Word>if</Word><Word>in</Word><Word>local</Word><Word>not</Word>
+            <Word>or</Word><Word>repeat</Word><Word>return</Word><Word>then</Word><Word>until</Word><Word>while</Word>
+        </Keywords>
+        <Keywords color=""Value"">
+            <Word>nil</Word><Word>true</Word><Word>false</Word><Word>self</Word>
+        </Keywords>
+        <Rule color=""Number"">\b0[xX][0-9a-fA-F]+|\b\d+(\.\d*)?([eE][+-]?\d+)?</Rule>
+    </RuleSet>
+</SyntaxDefinition>";
+
+        private static IHighlightingDefinition Lua;
+
+        private class Completion : ICompletionData
+        {
+            public string Label;
+            public string Insert;
+            public string Kind;
+            public string Info;
+
+            public ImageSource Image { get { return null; } }
+            public string Text { get { return Insert; } }
+            public object Content { get { return Label; } }
+            public object Description { get { return string.IsNullOrEmpty(Info) ? Kind : Kind + "\n" + Info; } }
+            public double Priority { get { return 0; } }
+
+            public void Complete(TextArea textArea, ISegment completionSegment, EventArgs insertionRequestEventArgs)
+            {
+                textArea.Document.Replace(completionSegment, Insert);
+            }
+        }
+
+        /* Squiggles the segment ShowSyntaxError set, Monaco's marker equivalent */
+        private class ErrorRenderer : IBackgroundRenderer
+        {
+            private static readonly Pen Squiggle = CreatePen();
+
+            public TextSegment Segment;
+
+            public KnownLayer Layer { get { return KnownLayer.Selection; } }
+
+            private static Pen CreatePen()
+            {
+                var P = new Pen(Brushes.Red, 1);
+                P.Freeze();
+                return P;
+            }
+
+            public void Draw(TextView textView, DrawingContext drawingContext)
+            {
+                if (Segment == null || textView.Document == null || Segment.EndOffset > textView.Document.TextLength) return;
+
+                textView.EnsureVisualLines();
+                foreach (var Rect in BackgroundGeometryBuilder.GetRectsForSegment(textView, Segment))
+                {
+                    var Geometry = new StreamGeometry();
+                    using (var Ctx = Geometry.Open())
+                    {
+                        Ctx.BeginFigure(Rect.BottomLeft, false, false);
+
+                        var Up = true;
+                        for (var X = Rect.Left + 2; X <= Rect.Right; X += 2, Up = !Up)
+                            Ctx.LineTo(new Point(X, Up ? Rect.Bottom - 2 : Rect.Bottom), true, false);
+                    }
+
+                    Geometry.Freeze();
+                    drawingContext.DrawGeometry(null, Squiggle, Geometry);
+                }
+            }
+        }
+
+        /* Snapshots are immutable ropes, so the save and lint threads read them without going near the dispatcher */
+        private class Tab
+        {
+            public TextDocument Document;
+            public ITextSource Snapshot;
+            public long Revision;
+            public int Tick;
+            public int Caret;
+            public double HorizontalScroll;
+            public double VerticalScroll;
+        }
+
+        private readonly object SyncLock = new object();
+        private readonly Dictionary<int, Tab> Tabs = new Dictionary<int, Tab>();
+        private readonly List<Completion> Completions = new List<Completion>();
+        private readonly ErrorRenderer Errors = new ErrorRenderer();
+        private CompletionWindow CompletionPopup;
+        private long SyncedRevision;
+        private int NextTab = 1;
+        private volatile int Active;
+
+        public bool MonacoLoaded { get; private set; }
+
+        public int ActiveTab
+        {
+            get { return Active; }
+        }
+
+        public event EditorReadyDelegate MonacoReady;
+
+        public NativeEditor()
+        {
+            if (Lua == null)
+                using (var Reader = XmlReader.Create(new StringReader(LuaDefinition)))
+                    Lua = HighlightingLoader.Load(Reader, HighlightingManager.Instance);
+
+            SyntaxHighlighting = Lua;
+            ShowLineNumbers = true;
+            FontFamily = new FontFamily("Consolas");
+            FontSize = 14;
+            Options.ConvertTabsToSpaces = false;
+
+            TextArea.TextView.BackgroundRenderers.Add(Errors);
+            TextArea.TextEntered += TextEntered;
+
+            AdoptDocument(0, Document);
+            SetTheme(MonacoTheme.Dark);
+
+            /* Same contract as the page's load, MainWindow subscribes right after constructing us */
+            Dispatcher.BeginInvoke(DispatcherPriority.Loaded, new Action(() =>
+            {
+                MonacoLoaded = true;
+                MonacoReady?.Invoke();
+            }));
+        }
+
+        private void AdoptDocument(int Id, TextDocument Doc)
+        {
+            var State = new Tab { Document = Doc, Snapshot = Doc.CreateSnapshot(), Tick = Environment.TickCount };
+
+            lock (SyncLock)
+            {
+                State.Revision = ++SyncedRevision;
+                Tabs[Id] = State;
+            }
+
+            Doc.TextChanged += (sender, args) =>
+            {
+                var Snapshot = Doc.CreateSnapshot();
+
+                lock (SyncLock)
+                {
+                    State.Snapshot = Snapshot;
+                    State.Revision = ++SyncedRevision;
+                    State.Tick = Environment.TickCount;
+                }
+            };
+        }
+
+        private void TextEntered(object sender, TextCompositionEventArgs e)
+        {
+            if (CompletionPopup != null || e.Text.Length == 0 || !IsWordChar(e.Text[0])) return;
+
+            var Caret = TextArea.Caret.Offset;
+            var Start = Caret;
+            while (Start > 0 && IsWordChar(Document.GetCharAt(Start - 1))) Start--;
+
+            var Prefix = Document.GetText(Start, Caret - Start);
+            if (Prefix.Length == 0 || char.IsDigit(Prefix[0])) return;
+
+            var Matches = Completions.Where(C => C.Insert.StartsWith(Prefix, StringComparison.OrdinalIgnoreCase)).ToList();
+            if (Matches.Count == 0) return;
+
+            CompletionPopup = new CompletionWindow(TextArea) { StartOffset = Start, Background = Background, Foreground = Foreground };
+            foreach (var Match in Matches) CompletionPopup.CompletionList.CompletionData.Add(Match);
+
+            CompletionPopup.Closed += (s, a) => CompletionPopup = null;
+            CompletionPopup.Show();
+            CompletionPopup.CompletionList.SelectItem(Prefix);
+        }
+
+        private static bool IsWordChar(char C)
+        {
+            return char.IsLetterOrDigit(C) || C == '_' || C == '.';
+        }
+
+        public void SetTheme(MonacoTheme theme)
+        {
+            switch (theme)
+            {
+                case MonacoTheme.Dark:
+                    Background = new SolidColorBrush(Color.FromRgb(30, 30, 30));
+                    Foreground = new SolidColorBrush(Color.FromRgb(212, 212, 212));
+                    LineNumbersForeground = new SolidColorBrush(Color.FromRgb(133, 133, 133));
+                    break;
+                case MonacoTheme.Light:
+                    Background = Brushes.White;
+                    Foreground = Brushes.Black;
+                    LineNumbersForeground = new SolidColorBrush(Color.FromRgb(35, 120, 147));
+                    break;
+                default:
+                    throw new ArgumentOutOfRangeException(nameof(theme), theme, null);
+            }
+        }
+
+        public void SetText(string text)
+        {
+            Document.Text = text ?? "";
+        }
+
+        public Task<string> GetTextAsync()
+        {
+            if (Dispatcher.CheckAccess()) return Task.FromResult(Text);
+
+            return Dispatcher.InvokeAsync(() => Text).Task;
+        }
+
+        public void AppendText(string text)
+        {
+            Document.Insert(Document.TextLength, text);
+        }
+
+        /// <summary>
+        /// Applies the edits in one undo step, back to front so earlier positions stay valid.
+        /// </summary>
+        /// <param name="edits"></param>
+        public void ApplyEdits(params MonacoEdit[] edits)
+        {
+            if (edits.Length == 0) return;
+
+            var Ranges = edits.Select(E => new { Start = OffsetOf(E.StartLine, E.StartColumn), End = OffsetOf(E.EndLine, E.EndColumn), E.Text })
+                .OrderByDescending(R => R.Start).ToList();
+
+            using (Document.RunUpdate())
+                foreach (var Range in Ranges)
+                    Document.Replace(Range.Start, Math.Max(Range.End - Range.Start, 0), Range.Text ?? "");
+        }
+
+        private int OffsetOf(int Line, int Column)
+        {
+            var L = Document.GetLineByNumber(Math.Min(Math.Max(Line, 1), Document.LineCount));
+            return L.Offset + Math.Min(Math.Max(Column - 1, 0), L.Length);
+        }
+
+        public void GoToLine(int lineNumber)
+        {
+            var Line = Math.Min(Math.Max(lineNumber, 1), Document.LineCount);
+            TextArea.Caret.Line = Line;
+            ScrollToLine(Line);
+        }
+
+        public void EditorRefresh()
+        {
+            TextArea.TextView.Redraw();
+        }
+
+        /// <summary>
+        /// Applies what AvalonEdit has an equivalent for, minimap, folding, ligatures and line height are Monaco only.
+        /// </summary>
+        /// <param name="settings"></param>
+        public void UpdateSettings(MonacoSettings settings)
+        {
+            IsReadOnly = settings.ReadOnly;
+            Options.EnableHyperlinks = settings.Links;
+            Options.EnableEmailHyperlinks = settings.Links;
+            Options.ShowSpaces = Options.ShowTabs = settings.RenderWhitespace == "all" || settings.RenderWhitespace == "boundary";
+            TextArea.IndentationStrategy = settings.AutoIndent ? new DefaultIndentationStrategy() : null;
+
+            if (settings.FontSize > 0) FontSize = settings.FontSize;
+            if (!string.IsNullOrEmpty(settings.FontFamily)) FontFamily = new FontFamily(settings.FontFamily);
+        }
+
+        public void AddIntellisense(string label, string type, string description, string insert)
+        {
+            Completions.Add(new Completion { Label = label, Kind = type, Info = description, Insert = insert });
+        }
+
+        public void ShowSyntaxError(int line, int column, int endLine, int endColumn, string message)
+        {
+            var Start = OffsetOf(line, column);
+            var End = Math.Max(OffsetOf(endLine, endColumn), Math.Min(Start + 1, Document.TextLength));
+
+            Errors.Segment = new TextSegment { StartOffset = Start, EndOffset = End };
+            ToolTip = message;
+            TextArea.TextView.InvalidateLayer(KnownLayer.Selection);
+        }
+
+        public void ClearSyntaxError()
+        {
+            Errors.Segment = null;
+            ToolTip = null;
+            TextArea.TextView.InvalidateLayer(KnownLayer.Selection);
+        }
+
+        public bool TryGetSyncedText(out string text, out long revision, out int idle)
+        {
+            return TryGetSyncedText(Active, out text, out revision, out idle);
+        }
+
+        public bool TryGetSyncedText(int tab, out string text, out long revision, out int idle)
+        {
+            ITextSource Snapshot;
+
+            lock (SyncLock)
+            {
+                text = null;
+                revision = 0;
+                idle = 0;
+
+                Tab State;
+                if (!Tabs.TryGetValue(tab, out State)) return false;
+
+                Snapshot = State.Snapshot;
+                revision = State.Revision;
+                idle = Environment.TickCount - State.Tick;
+            }
+
+            text = Snapshot.Text;
+            return true;
+        }
+
+        public bool TryGetSyncedTabs(IList<int> tabs, out string[] texts, out long revision, out int idle)
+        {
+            var Snapshots = new ITextSource[tabs.Count];
+
+            lock (SyncLock)
+            {
+                texts = new string[tabs.Count];
+                revision = 0;
+                idle = int.MaxValue;
+
+                for (var i = 0; i < tabs.Count; i++)
+                {
+                    Tab State;
+                    if (!Tabs.TryGetValue(tabs[i], out State)) return false;
+
+                    Snapshots[i] = State.Snapshot;
+                    revision = Math.Max(revision, State.Revision);
+                    idle = Math.Min(idle, Environment.TickCount - State.Tick);
+                }
+            }
+
+            for (var i = 0; i < Snapshots.Length; i++)
+                texts[i] = Snapshots[i].Text;
+
+            return true;
+        }
+
+        public int NewTab(string text)
+        {
+            int Id;
+            lock (SyncLock) Id = NextTab++;
+
+            AdoptDocument(Id, new TextDocument(text ?? ""));
+            return Id;
+        }
+
+        /// <summary>
+        /// Swaps in the tab's document, each keeps its own undo stack, caret and scroll.
+        /// </summary>
+        /// <param name="tab"></param>
+        public void SwitchTab(int tab)
+        {
+            Tab Current, Next;
+            lock (SyncLock)
+            {
+                if (tab == Active || !Tabs.TryGetValue(tab, out Next)) return;
+                Tabs.TryGetValue(Active, out Current);
+            }
+
+            if (Current != null)
+            {
+                Current.Caret = CaretOffset;
+                Current.HorizontalScroll = HorizontalOffset;
+                Current.VerticalScroll = VerticalOffset;
+            }
+
+            CompletionPopup?.Close();
+            ClearSyntaxError();
+
+            Active = tab;
+            Document = Next.Document;
+            CaretOffset = Math.Min(Next.Caret, Document.TextLength);
+
+            /* The scroll viewer only knows the new extent after a layout pass */
+            Dispatcher.BeginInvoke(DispatcherPriority.Loaded, new Action(() =>
+            {
+                ScrollToHorizontalOffset(Next.HorizontalScroll);
+                ScrollToVerticalOffset(Next.VerticalScroll);
+            }));
+        }
+
+        public bool CloseTab(int tab)
+        {
+            if (tab == 0 || tab == Active) return false;
+
+            lock (SyncLock) return Tabs.Remove(tab);
+        }
+    }
+}
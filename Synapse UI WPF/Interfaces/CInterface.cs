@@ -1,6 +1,7 @@
 ﻿using System;
 using System.Reflection;
 using System.Runtime.InteropServices;
+using System.Text;
 
 namespace Synapse_UI_WPF.Interfaces
 {
@@ -21,6 +22,9 @@ namespace Synapse_UI_WPF.Interfaces
         [DllImport("SynapseInjector.dll", CallingConvention = CallingConvention.StdCall, CharSet = CharSet.Ansi)]
         private static extern IntPtr SynSignRequest(uint Key, [MarshalAs(UnmanagedType.LPStr)] string Str);
 
+        [DllImport("SynapseInjector.dll", CallingConvention = CallingConvention.StdCall)]
+        private static extern bool SynSyntaxCheck(byte[] Source, int Size, out int Line, StringBuilder Message, int MessageSize);
+
         [Obfuscation(Feature = "virtualization", Exclude = false)]
         private static uint GetKey(uint Func)
         {
@@ -55,6 +59,17 @@ namespace Synapse_UI_WPF.Interfaces
             return Marshal.PtrToStringAnsi(Str);
         }
 
+        /* Parses Source with the bundled Lua parser in this process, nothing is compiled for or sent to the game */
+        public static bool CheckSyntax(string Source, out int Line, out string Message)
+        {
+            var Bytes = Encoding.UTF8.GetBytes(Source);
+            var Err = new StringBuilder(512);
+
+            var Ok = SynSyntaxCheck(Bytes, Bytes.Length, out Line, Err, Err.Capacity);
+            Message = Ok ? null : Err.ToString();
+            return Ok;
+        }
+
         [Obfuscation(Feature = "virtualization", Exclude = false)]
         private static uint RotateLeft(uint value, int count)
         {
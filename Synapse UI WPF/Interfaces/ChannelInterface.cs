@@ -0,0 +1,202 @@
+﻿using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.Pipes;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Synapse_UI_WPF.Interfaces
+{
+    /* Frame types, keep in sync with ChannelMessage in Synapse's Channel.hpp */
+    public enum ChannelMessage : byte
+    {
+        Init = 1,
+        Execute,
+        Editor,
+        Status,
+        Console,
+        ExecuteDeflate,
+        Metrics
+    }
+
+    public static class ChannelInterface
+    {
+        /* One persistent pipe per attached process, each with its own lock so writes to different clients never wait on
+           each other */
+        private class Channel
+        {
+            public readonly object Lock = new object();
+            public NamedPipeClientStream Pipe;
+        }
+
+        private static readonly Dictionary<int, Channel> Channels = new Dictionary<int, Channel>();
+
+        /* Fired on the drain thread for every Metrics frame, key=value pairs as Synapse's Metrics::Format writes them */
+        public static event Action<Dictionary<string, string>> MetricsReceived;
+
+        /* Each frame is a little endian uint32 payload length, the type byte, then the payload. The pipe is connected
+           once per attached process and reused, false means the caller should fall back to the legacy script pipe */
+        public static bool Send(int ProcessId, string PipeName, ChannelMessage Type, string Data, int Timeout)
+        {
+            return Write(ProcessId, PipeName, Frame(Type, Data), Timeout);
+        }
+
+        /* Targets maps each process to its channel pipe name. The frame is encoded once and written to every channel at
+           the same time, returns the processes whose channel couldn't take it */
+        public static List<int> SendAll(IDictionary<int, string> Targets, ChannelMessage Type, string Data, int Timeout)
+        {
+            var Encoded = Frame(Type, Data);
+            var Failed = new ConcurrentBag<int>();
+
+            Parallel.ForEach(Targets, Target =>
+            {
+                if (!Write(Target.Key, Target.Value, Encoded, Timeout)) Failed.Add(Target.Key);
+            });
+
+            return Failed.ToList();
+        }
+
+        private static byte[] Frame(ChannelMessage Type, string Data)
+        {
+            var Payload = Encoding.UTF8.GetBytes(Data);
+            var Result = new byte[5 + Payload.Length];
+            BitConverter.GetBytes((uint) Payload.Length).CopyTo(Result, 0);
+            Result[4] = (byte) Type;
+            Payload.CopyTo(Result, 5);
+            return Result;
+        }
+
+        private static bool Write(int ProcessId, string PipeName, byte[] Encoded, int Timeout)
+        {
+            Channel Target;
+            lock (Channels)
+            {
+                if (!Channels.TryGetValue(ProcessId, out Target))
+                    Channels[ProcessId] = Target = new Channel();
+            }
+
+            lock (Target.Lock)
+            {
+                if (Target.Pipe == null || !Target.Pipe.IsConnected)
+                {
+                    Target.Pipe?.Dispose();
+                    Target.Pipe = null;
+
+                    try
+                    {
+                        /* Overlapped, a synchronous handle would serialize the drain thread's pending read with every write */
+                        Target.Pipe = new NamedPipeClientStream(".", PipeName, PipeDirection.InOut, PipeOptions.Asynchronous);
+                        Target.Pipe.Connect(Timeout);
+                    }
+                    catch (Exception)
+                    {
+                        Target.Pipe?.Dispose();
+                        Target.Pipe = null;
+                        return false;
+                    }
+
+                    var Reading = Target.Pipe;
+                    new Thread(() => Drain(Reading)) { IsBackground = true }.Start();
+                }
+
+                try
+                {
+                    Target.Pipe.Write(Encoded, 0, Encoded.Length);
+                    return true;
+                }
+                catch (IOException)
+                {
+                    Target.Pipe.Dispose();
+                    Target.Pipe = null;
+                    return false;
+                }
+            }
+        }
+
+        /* Drops the channel of a process that exited or was detached */
+        public static void Close(int ProcessId)
+        {
+            Channel Target;
+            lock (Channels)
+            {
+                if (!Channels.TryGetValue(ProcessId, out Target)) return;
+                Channels.Remove(ProcessId);
+            }
+
+            lock (Target.Lock)
+            {
+                Target.Pipe?.Dispose();
+                Target.Pipe = null;
+            }
+        }
+
+        public static void Close()
+        {
+            int[] Ids;
+            lock (Channels)
+                Ids = Channels.Keys.ToArray();
+
+            foreach (var Id in Ids) Close(Id);
+        }
+
+        /* Status lines still come in over the launch pipe, but the channel mirrors them and console output. Only metrics
+           are read here, everything is drained so Synapse's send queue never backs up */
+        private static void Drain(Stream Reading)
+        {
+            var Header = new byte[5];
+            var Buffer = new byte[64 * 1024];
+
+            try
+            {
+                while (ReadExact(Reading, Header, 5))
+                {
+                    var Length = BitConverter.ToUInt32(Header, 0);
+                    var Type = (ChannelMessage) Header[4];
+
+                    if (Type == ChannelMessage.Metrics && Length <= Buffer.Length)
+                    {
+                        if (!ReadExact(Reading, Buffer, (int) Length)) return;
+                        MetricsReceived?.Invoke(ParseMetrics(Encoding.UTF8.GetString(Buffer, 0, (int) Length)));
+                        continue;
+                    }
+
+                    while (Length > 0)
+                    {
+                        var Chunk = (int) Math.Min(Length, (uint) Buffer.Length);
+                        if (!ReadExact(Reading, Buffer, Chunk)) return;
+                        Length -= (uint) Chunk;
+                    }
+                }
+            }
+            catch (Exception) { }
+        }
+
+        private static bool ReadExact(Stream Reading, byte[] Buffer, int Count)
+        {
+            var Offset = 0;
+            while (Offset < Count)
+            {
+                var Read = Reading.Read(Buffer, Offset, Count - Offset);
+                if (Read <= 0) return false;
+                Offset += Read;
+            }
+
+            return true;
+        }
+
+        private static Dictionary<string, string> ParseMetrics(string Payload)
+        {
+            var Values = new Dictionary<string, string>();
+            foreach (var Pair in Payload.Split(';'))
+            {
+                var Split = Pair.IndexOf('=');
+                if (Split > 0) Values[Pair.Substring(0, Split)] = Pair.Substring(Split + 1);
+            }
+
+            return Values;
+        }
+    }
+}
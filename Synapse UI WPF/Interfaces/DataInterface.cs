@@ -1,42 +1,318 @@
 ﻿using System;
+using System.Collections.Generic;
 using System.IO;
+using System.Linq;
 using System.Reflection;
 using System.Security.Cryptography;
 using System.Text;
+using System.Threading;
 using Newtonsoft.Json;
 using Synapse_UI_WPF.Static;
 
 namespace Synapse_UI_WPF.Interfaces
 {
+    /// <summary>
+    /// DPAPI-protected key/value store under auth\. Entries are split into content-defined chunks, each protected and
+    /// written on its own, so an edit in the middle of a large workspace rewrites the chunk or two around it and
+    /// nothing else. Saves land in memory right away and go to disk on a background writer.
+    /// </summary>
     public static class DataInterface
     {
+        private const int IndexVersion = 1;
+
+        /* Chunk bounds in bytes, boundaries fall where the gear hash's low bits are clear so they move with the content */
+        private const int MinChunk = 8 * 1024;
+        private const int MaxChunk = 128 * 1024;
+        private const ulong ChunkMask = 0x7FFF;
+
+        private static readonly ulong[] Gear = CreateGear();
+
+        private static readonly object CacheLock = new object();
+        private static readonly object WriteLock = new object();
+        private static readonly Dictionary<string, string> Cache = new Dictionary<string, string>();
+        private static readonly Dictionary<string, string> Pending = new Dictionary<string, string>();
+        private static readonly AutoResetEvent PendingSignal = new AutoResetEvent(false);
+
+        /* Chunk ids each entry's index referenced when last read or written */
+        private static readonly Dictionary<string, HashSet<string>> Written = new Dictionary<string, HashSet<string>>();
+
+        static DataInterface()
+        {
+            new Thread(() =>
+            {
+                while (true)
+                {
+                    PendingSignal.WaitOne();
+                    Flush();
+                }
+            }) { IsBackground = true }.Start();
+
+            AppDomain.CurrentDomain.ProcessExit += (sender, args) => Flush();
+        }
+
+        private static ulong[] CreateGear()
+        {
+            /* Fixed xorshift sequence, the table has to come out the same on every run */
+            var Table = new ulong[256];
+            var State = 0x9E3779B97F4A7C15UL;
+
+            for (var i = 0; i < Table.Length; i++)
+            {
+                State ^= State << 13;
+                State ^= State >> 7;
+                State ^= State << 17;
+                Table[i] = State;
+            }
+
+            return Table;
+        }
+
+        private static byte[] EntropyOf(string Name)
+        {
+            return Encoding.UTF8.GetBytes(Utils.Sha512(Environment.MachineName + Name));
+        }
+
+        private static string LegacyPath(string Name)
+        {
+            return "auth\\" + Name + ".bin";
+        }
+
+        private static string ChunkDirectory(string Name)
+        {
+            return "auth\\" + Name;
+        }
+
+        private static string IndexPath(string Name)
+        {
+            return ChunkDirectory(Name) + "\\index.bin";
+        }
+
+        private static IEnumerable<ArraySegment<byte>> SplitChunks(byte[] Data)
+        {
+            var Start = 0;
+            while (Start < Data.Length)
+            {
+                var End = Math.Min(Start + MaxChunk, Data.Length);
+                var Hash = 0UL;
+
+                for (var i = Start + MinChunk; i < End; i++)
+                {
+                    Hash = (Hash << 1) + Gear[Data[i]];
+                    if ((Hash & ChunkMask) != 0) continue;
+
+                    End = i + 1;
+                    break;
+                }
+
+                yield return new ArraySegment<byte>(Data, Start, End - Start);
+                Start = End;
+            }
+        }
+
         [Obfuscation(Feature = "virtualization", Exclude = false)]
         public static void Save<T>(string Name, T Data)
         {
             var Serial = JsonConvert.SerializeObject(Data);
-            var Protected = ProtectedData.Protect(Encoding.UTF8.GetBytes(Serial),
-                Encoding.UTF8.GetBytes(Utils.Sha512(Environment.MachineName + Name)), DataProtectionScope.LocalMachine);
-            File.WriteAllText("auth\\" + Name + ".bin", Convert.ToBase64String(Protected));
+
+            lock (CacheLock)
+            {
+                Cache[Name] = Serial;
+                Pending[Name] = Serial;
+            }
+
+            PendingSignal.Set();
         }
 
         [Obfuscation(Feature = "virtualization", Exclude = false)]
         public static T Read<T>(string Name)
         {
-            var Unprotected = ProtectedData.Unprotect(Convert.FromBase64String(File.ReadAllText("auth\\" + Name + ".bin")),
-                Encoding.UTF8.GetBytes(Utils.Sha512(Environment.MachineName + Name)), DataProtectionScope.LocalMachine);
-            return JsonConvert.DeserializeObject<T>(Encoding.UTF8.GetString(Unprotected));
+            string Serial;
+            lock (CacheLock)
+            {
+                if (Cache.TryGetValue(Name, out Serial)) return JsonConvert.DeserializeObject<T>(Serial);
+            }
+
+            /* Loaded outside the cache lock, the writer takes the two the other way round */
+            Serial = Load(Name);
+
+            lock (CacheLock)
+            {
+                if (Cache.TryGetValue(Name, out var Newer)) Serial = Newer;
+                else Cache[Name] = Serial;
+            }
+
+            return JsonConvert.DeserializeObject<T>(Serial);
         }
 
         [Obfuscation(Feature = "virtualization", Exclude = false)]
         public static bool Exists(string Name)
         {
-            return File.Exists("auth\\" + Name + ".bin");
+            lock (CacheLock)
+            {
+                if (Cache.ContainsKey(Name)) return true;
+            }
+
+            return File.Exists(IndexPath(Name)) || File.Exists(LegacyPath(Name));
         }
 
         [Obfuscation(Feature = "virtualization", Exclude = false)]
         public static void Delete(string Name)
         {
-            if (File.Exists("auth\\" + Name + ".bin")) File.Delete("auth\\" + Name + ".bin");
+            lock (CacheLock)
+            {
+                Cache.Remove(Name);
+                Pending.Remove(Name);
+            }
+
+            lock (WriteLock)
+            {
+                Written.Remove(Name);
+                if (Directory.Exists(ChunkDirectory(Name))) Directory.Delete(ChunkDirectory(Name), true);
+                if (File.Exists(LegacyPath(Name))) File.Delete(LegacyPath(Name));
+            }
+        }
+
+        /// <summary>
+        /// Writes every pending save before returning. The writer thread and process exit call it too, call it directly
+        /// before anything that might kill the process harder than Environment.Exit.
+        /// </summary>
+        public static void Flush()
+        {
+            lock (WriteLock)
+            {
+                while (true)
+                {
+                    string Name, Serial;
+                    lock (CacheLock)
+                    {
+                        if (Pending.Count == 0) return;
+
+                        var Next = Pending.First();
+                        Name = Next.Key;
+                        Serial = Next.Value;
+                        Pending.Remove(Name);
+                    }
+
+                    try
+                    {
+                        Store(Name, Serial);
+                    }
+                    catch (Exception)
+                    {
+                        /* Still cached, the next save of this entry tries again */
+                    }
+                }
+            }
+        }
+
+        [Obfuscation(Feature = "virtualization", Exclude = false)]
+        private static void Store(string Name, string Serial)
+        {
+            var Entropy = EntropyOf(Name);
+            var Dir = ChunkDirectory(Name);
+            Directory.CreateDirectory(Dir);
+
+            if (!Written.TryGetValue(Name, out var Previous))
+                Previous = new HashSet<string>(ReadIndex(Name, Entropy).Select(C => C.Item1));
+
+            var Chunks = new List<Tuple<string, int>>();
+            using (var Mac = new HMACSHA256(Entropy))
+            {
+                foreach (var Chunk in SplitChunks(Encoding.UTF8.GetBytes(Serial)))
+                {
+                    var Id = BitConverter.ToString(Mac.ComputeHash(Chunk.Array, Chunk.Offset, Chunk.Count)).Replace("-", "").Substring(0, 32);
+                    Chunks.Add(Tuple.Create(Id, Chunk.Count));
+
+                    var ChunkPath = Dir + "\\" + Id + ".bin";
+                    if (Previous.Contains(Id) && File.Exists(ChunkPath)) continue;
+
+                    var Plain = new byte[Chunk.Count];
+                    Buffer.BlockCopy(Chunk.Array, Chunk.Offset, Plain, 0, Chunk.Count);
+                    File.WriteAllBytes(ChunkPath, ProtectedData.Protect(Plain, Entropy, DataProtectionScope.LocalMachine));
+                }
+            }
+
+            /* The index goes last and is swapped in whole, a crash before it leaves the last complete save readable */
+            using (var Stream = new MemoryStream())
+            using (var Writer = new BinaryWriter(Stream))
+            {
+                Writer.Write(IndexVersion);
+                Writer.Write(Chunks.Count);
+                foreach (var Chunk in Chunks)
+                {
+                    Writer.Write(Chunk.Item1);
+                    Writer.Write(Chunk.Item2);
+                }
+
+                var Temp = IndexPath(Name) + ".tmp";
+                File.WriteAllBytes(Temp, ProtectedData.Protect(Stream.ToArray(), Entropy, DataProtectionScope.LocalMachine));
+                if (File.Exists(IndexPath(Name))) File.Replace(Temp, IndexPath(Name), null);
+                else File.Move(Temp, IndexPath(Name));
+            }
+
+            var Current = new HashSet<string>(Chunks.Select(C => C.Item1));
+            foreach (var Stale in Previous.Where(Id => !Current.Contains(Id)))
+            {
+                try
+                {
+                    File.Delete(Dir + "\\" + Stale + ".bin");
+                }
+                catch (Exception) { }
+            }
+
+            Written[Name] = Current;
+            if (File.Exists(LegacyPath(Name))) File.Delete(LegacyPath(Name));
+        }
+
+        private static List<Tuple<string, int>> ReadIndex(string Name, byte[] Entropy)
+        {
+            var Chunks = new List<Tuple<string, int>>();
+            if (!File.Exists(IndexPath(Name))) return Chunks;
+
+            var Index = ProtectedData.Unprotect(File.ReadAllBytes(IndexPath(Name)), Entropy, DataProtectionScope.LocalMachine);
+            using (var Reader = new BinaryReader(new MemoryStream(Index)))
+            {
+                if (Reader.ReadInt32() != IndexVersion) throw new InvalidDataException("Unknown index version.");
+
+                var Count = Reader.ReadInt32();
+                for (var i = 0; i < Count; i++)
+                    Chunks.Add(Tuple.Create(Reader.ReadString(), Reader.ReadInt32()));
+            }
+
+            return Chunks;
+        }
+
+        [Obfuscation(Feature = "virtualization", Exclude = false)]
+        private static string Load(string Name)
+        {
+            var Entropy = EntropyOf(Name);
+
+            lock (WriteLock)
+            {
+                if (File.Exists(IndexPath(Name)))
+                {
+                    var Chunks = ReadIndex(Name, Entropy);
+                    var Data = new byte[Chunks.Sum(C => C.Item2)];
+                    var Offset = 0;
+
+                    foreach (var Chunk in Chunks)
+                    {
+                        var Plain = ProtectedData.Unprotect(File.ReadAllBytes(ChunkDirectory(Name) + "\\" + Chunk.Item1 + ".bin"), Entropy, DataProtectionScope.LocalMachine);
+                        if (Plain.Length != Chunk.Item2) throw new InvalidDataException("Chunk size mismatch.");
+
+                        Buffer.BlockCopy(Plain, 0, Data, Offset, Plain.Length);
+                        Offset += Plain.Length;
+                    }
+
+                    Written[Name] = new HashSet<string>(Chunks.Select(C => C.Item1));
+                    return Encoding.UTF8.GetString(Data);
+                }
+
+                /* Entries from before the chunked store, rewritten in the new layout on their next save */
+                var Unprotected = ProtectedData.Unprotect(Convert.FromBase64String(File.ReadAllText(LegacyPath(Name))),
+                    Entropy, DataProtectionScope.LocalMachine);
+                return Encoding.UTF8.GetString(Unprotected);
+            }
         }
     }
 }
@@ -1,12 +1,14 @@
 ﻿using System;
-using System.IO;
-using System.Net;
+using System.Collections.Concurrent;
 using System.Reflection;
 using System.Runtime.InteropServices;
+using System.Threading;
+using System.Threading.Tasks;
 using System.Windows;
 using System.Windows.Controls;
 using System.Windows.Media;
 using System.Windows.Media.Imaging;
+using Synapse_UI_WPF.Static;
 using Color = System.Windows.Media.Color;
 using FontFamily = System.Windows.Media.FontFamily;
 using Image = System.Drawing.Image;
@@ -276,9 +278,20 @@ namespace Synapse_UI_WPF.Interfaces
             public TScriptHub ScriptHub;
         }
 
+        /* Brushes are frozen and shared by every control and window using the same color, nothing may modify them */
+        private static readonly ConcurrentDictionary<uint, SolidColorBrush> Brushes = new ConcurrentDictionary<uint, SolidColorBrush>();
+        private static readonly ConcurrentDictionary<BitmapImage, ImageBrush> ImageBrushes = new ConcurrentDictionary<BitmapImage, ImageBrush>();
+
         public static SolidColorBrush ConvertColor(TColor ThemeColor)
         {
-            return new SolidColorBrush(Color.FromArgb(ThemeColor.A, ThemeColor.R, ThemeColor.G, ThemeColor.B));
+            var Key = (uint) ThemeColor.A << 24 | (uint) ThemeColor.R << 16 | (uint) ThemeColor.G << 8 | ThemeColor.B;
+
+            return Brushes.GetOrAdd(Key, _ =>
+            {
+                var Brush = new SolidColorBrush(Color.FromArgb(ThemeColor.A, ThemeColor.R, ThemeColor.G, ThemeColor.B));
+                Brush.Freeze();
+                return Brush;
+            });
         }
 
         public static string ConvertFormatString(TFormatLabel ThemeLabel, string Version)
@@ -286,43 +299,54 @@ namespace Synapse_UI_WPF.Interfaces
             return ThemeLabel.FormatString.Replace("{version}", Version);
         }
 
-        public static BitmapImage ConvertImage(TImage ThemeImage)
+        /* Online images go through AssetCache, so each one is downloaded once and every later window gets it from memory
+           (or disk on the next run). Every window shares one frozen instance per image */
+        public static Task<BitmapImage> ConvertImage(TImage ThemeImage)
+        {
+            if (ThemeImage.Path == "") return Task.FromResult<BitmapImage>(null);
+
+            return ThemeImage.Online ? AssetCache.GetImage(ThemeImage.Path) : AssetCache.GetLocalImage(ThemeImage.Path);
+        }
+
+        /* Applies the image right away when it is already loaded, otherwise when it arrives, so applying a theme never
+           waits on the network. Until then whatever was applied before (the theme's back color) stays */
+        private static void ApplyImage(TImage ThemeImage, Action<BitmapImage> Apply)
         {
-            try
+            var Load = ConvertImage(ThemeImage);
+            if (Load.Status == TaskStatus.RanToCompletion)
             {
-                if (ThemeImage.Path == "") return null;
-                if (!ThemeImage.Online) return new BitmapImage(new Uri(ThemeImage.Path));
-                using (var WC = new WebClient())
-                {
-                    var Data = WC.DownloadData(ThemeImage.Path);
+                if (Load.Result != null) Apply(Load.Result);
+                return;
+            }
 
-                    using (var Stream = new MemoryStream(Data))
-                    {
-                        var Bitmap = new BitmapImage();
-                        Bitmap.BeginInit();
-                        Bitmap.StreamSource = Stream;
-                        Bitmap.CacheOption = BitmapCacheOption.OnLoad;
-                        Bitmap.EndInit();
-                        Bitmap.Freeze();
-
-                        return Bitmap;
-                    }
+            Load.ContinueWith(T =>
+            {
+                if (T.IsFaulted)
+                {
+                    MessageBox.Show("Failed to parse image.\n\nException details:\n" + T.Exception.GetBaseException().Message,
+                        "Synapse X Image Parser", MessageBoxButton.OK, MessageBoxImage.Error);
+                    return;
                 }
-            }
-            catch (Exception ex)
+
+                if (T.Result != null) Apply(T.Result);
+            }, CancellationToken.None, TaskContinuationOptions.None, TaskScheduler.FromCurrentSynchronizationContext());
+        }
+
+        private static ImageBrush ConvertImageBrush(BitmapImage Bitmap)
+        {
+            return ImageBrushes.GetOrAdd(Bitmap, _ =>
             {
-                MessageBox.Show("Failed to parse image.\n\nException details:\n" + ex.Message,
-                    "Synapse X Image Parser", MessageBoxButton.OK, MessageBoxImage.Error);
-                return null;
-            }
+                var Brush = new ImageBrush(Bitmap);
+                Brush.Freeze();
+                return Brush;
+            });
         }
 
         public static void ApplyButton(Button Button, TButton ThemeButton)
         {
+            Button.Background = ConvertColor(ThemeButton.BackColor);
             if (!string.IsNullOrWhiteSpace(ThemeButton.Image.Path))
-                Button.Background = new ImageBrush(ConvertImage(ThemeButton.Image));
-            else
-                Button.Background = ConvertColor(ThemeButton.BackColor);
+                ApplyImage(ThemeButton.Image, Bitmap => Button.Background = ConvertImageBrush(Bitmap));
 
             Button.Foreground = ConvertColor(ThemeButton.TextColor);
             Button.FontFamily = new FontFamily(ThemeButton.Font.Name);
@@ -332,10 +356,9 @@ namespace Synapse_UI_WPF.Interfaces
 
         public static void ApplyButton(Button Button, TYieldButton ThemeButton)
         {
+            Button.Background = ConvertColor(ThemeButton.BackColor);
             if (!string.IsNullOrWhiteSpace(ThemeButton.Image.Path))
-                Button.Background = new ImageBrush(ConvertImage(ThemeButton.Image));
-            else
-                Button.Background = ConvertColor(ThemeButton.BackColor);
+                ApplyImage(ThemeButton.Image, Bitmap => Button.Background = ConvertImageBrush(Bitmap));
 
             Button.Foreground = ConvertColor(ThemeButton.TextColor);
             Button.FontFamily = new FontFamily(ThemeButton.Font.Name);
@@ -377,10 +400,9 @@ namespace Synapse_UI_WPF.Interfaces
 
         public static void ApplyWindow(Window Form, TForm ThemeForm)
         {
+            Form.Background = ConvertColor(ThemeForm.BackColor);
             if (!string.IsNullOrWhiteSpace(ThemeForm.Image.Path))
-                Form.Background = new ImageBrush(ConvertImage(ThemeForm.Image));
-            else
-                Form.Background = ConvertColor(ThemeForm.BackColor);
+                ApplyImage(ThemeForm.Image, Bitmap => Form.Background = ConvertImageBrush(Bitmap));
 
             Form.Topmost = ThemeForm.TopMost;
             Form.Opacity = ThemeForm.Opacity;
@@ -404,7 +426,7 @@ namespace Synapse_UI_WPF.Interfaces
 
         public static void ApplyLogo(System.Windows.Controls.Image LogoBox, TLogo ThemeLogoBox)
         {
-            if (ThemeLogoBox.Image.Path != "") LogoBox.Source = ConvertImage(ThemeLogoBox.Image);
+            if (ThemeLogoBox.Image.Path != "") ApplyImage(ThemeLogoBox.Image, Bitmap => LogoBox.Source = Bitmap);
         }
 
         public static TBase Default()
@@ -2,6 +2,7 @@
 using System.Collections.Generic;
 using System.Text;
 using System.Windows;
+using Newtonsoft.Json;
 using Synapse_UI_WPF.Static;
 using WebSocketSharp;
 using WebSocketSharp.Server;
@@ -14,7 +15,23 @@ namespace Synapse_UI_WPF.Interfaces
         private static WebSocketServer Server;
         private static Data.WebSocketHolder Whitelist;
         private static Data.WebSocketTrustCache Cache;
-        private static readonly List<string> TrustBlacklist = new List<string>();
+        private static bool Debug;
+
+        /* Hashed views of the whitelist and trust cache, every connection checks its origin against these */
+        private static readonly object TrustLock = new object();
+        private static readonly HashSet<string> NoPromptOrigins = new HashSet<string>();
+        private static readonly Dictionary<string, Data.WebSocketEntry> PromptOrigins = new Dictionary<string, Data.WebSocketEntry>();
+        private static readonly HashSet<string> TrustedOrigins = new HashSet<string>();
+        private static readonly HashSet<string> TrustBlacklist = new HashSet<string>();
+
+        /* One per prompting origin, so a burst of connections from it asks once without holding up anyone else */
+        private static readonly Dictionary<string, object> PromptLocks = new Dictionary<string, object>();
+
+        /* "SYN_BATCH|" followed by a JSON array of scripts, all of them are executed off one frame */
+        private const string BatchPrefix = "SYN_BATCH|";
+
+        /* "SYN_ALL|" in front of a script or batch runs it on every attached client instead of the current one */
+        private const string AllPrefix = "SYN_ALL|";
 
         public class Execute : WebSocketBehavior
         {
@@ -28,7 +45,44 @@ namespace Synapse_UI_WPF.Interfaces
                         return;
                     }
 
-                    Main.Execute(e.Data);
+                    var Data = e.Data;
+                    Action<string> Run = Main.Execute;
+
+                    if (Data.StartsWith(AllPrefix, StringComparison.Ordinal))
+                    {
+                        Data = Data.Substring(AllPrefix.Length);
+                        Run = Script => Main.ExecuteAll(Script);
+                    }
+
+                    if (!Data.StartsWith(BatchPrefix, StringComparison.Ordinal))
+                    {
+                        Run(Data);
+                        Send("OK");
+                        return;
+                    }
+
+                    string[] Scripts;
+                    try
+                    {
+                        Scripts = JsonConvert.DeserializeObject<string[]>(Data.Substring(BatchPrefix.Length));
+                    }
+                    catch (JsonException)
+                    {
+                        Send("BAD_BATCH");
+                        return;
+                    }
+
+                    if (Scripts == null)
+                    {
+                        Send("BAD_BATCH");
+                        return;
+                    }
+
+                    foreach (var Script in Scripts)
+                    {
+                        if (Script != null) Run(Script);
+                    }
+
                     Send("OK");
                 });
             }
@@ -61,7 +115,7 @@ namespace Synapse_UI_WPF.Interfaces
 
                 Main.Dispatcher.Invoke(() =>
                 {
-                    if (Main.Ready())
+                    if (Main.Ready() && !Main.CanAttachMore())
                     {
                         Send("ALREADY_ATTACHED");
                         return;
@@ -153,216 +207,87 @@ namespace Synapse_UI_WPF.Interfaces
                 DataInterface.Save("trustcache", Cache);
             }
 
-            var Debug = Globals.Theme.Main.WebSocket.DebugMode;
+            lock (TrustLock)
+            {
+                NoPromptOrigins.Clear();
+                PromptOrigins.Clear();
+                TrustedOrigins.Clear();
+
+                foreach (var Entry in Whitelist.EntriesNoPrompt) NoPromptOrigins.Add(Entry);
+                foreach (var Entry in Whitelist.EntriesPrompt) PromptOrigins[Entry.Origin] = Entry;
+                foreach (var Entry in Cache.Entries) TrustedOrigins.Add(Entry);
+            }
+
+            Debug = Globals.Theme.Main.WebSocket.DebugMode;
 
             Main = _Main;
             Server = new WebSocketServer(Port);
-            Server.AddWebSocketService("/execute", () =>
-            {
-                return new Execute
-                {
-                    OriginValidator = origin =>
-                    {
-                        if (origin == null || string.IsNullOrEmpty(origin)) return true;
-
-                        if (Debug)
-                        {
-                            var Result = MessageBox.Show(
-                                "Attempt to connect to the 'Execute' WebSocket.\n\nOrigin: \"" + origin +
-                                "\"\n\nIf you wish to get this origin whitelisted, please press Control + C on this MessageBox and give the contents to 3dsboy08.\nPress 'Yes'/'No' to continue the connection.",
-                                "Synapse X WebSocket - Debugger", MessageBoxButton.YesNo, MessageBoxImage.Warning, MessageBoxResult.No);
-                            if (Result == MessageBoxResult.Yes)
-                            {
-                                return true;
-                            }
-                        }
+            Server.AddWebSocketService("/execute", () => new Execute { OriginValidator = Origin => ValidateOrigin("Execute", Origin) });
+            Server.AddWebSocketService("/attach", () => new Attach { OriginValidator = Origin => ValidateOrigin("Attach", Origin) });
+            Server.AddWebSocketService("/editor", () => new Editor { OriginValidator = Origin => ValidateOrigin("Editor", Origin) });
+            Server.AddWebSocketService("/custom", () => new Custom { OriginValidator = Origin => ValidateOrigin("Custom", Origin) });
 
-                        foreach (var Entry in Whitelist.EntriesNoPrompt)
-                        {
-                            if (Entry == origin) return true;
-                        }
+            Server.Start();
+        }
 
-                        foreach (var Entry in Whitelist.EntriesPrompt)
-                        {
-                            if (TrustBlacklist.Contains(Entry.Origin)) return false;
-                            if (Cache.Entries.Contains(Entry.Origin)) return true;
-
-                            if (Entry.Origin != origin) continue;
-                            var Result = MessageBox.Show(
-                                "Application '" + Entry.AppName + "' by developer '" + Entry.DevName +
-                                "' wishes to connect to the Synapse WebSocket. Do you wish to allow the connection?\n\nBy pressing 'Yes', you give this application permission to execute scripts, attach Synapse, and set the text of the Synapse X editor of on your behalf.\n\nYou should NEVER allow connections with developers you do not trust. Press 'No' if you do not know what this means.",
-                                "Synapse X Trust Manager", MessageBoxButton.YesNo, MessageBoxImage.Warning,
-                                MessageBoxResult.No);
-                            if (Result != MessageBoxResult.Yes)
-                            {
-                                TrustBlacklist.Add(origin);
-                                return false;
-                            }
-
-                            Cache.Entries.Add(origin);
-                            DataInterface.Save("trustcache", Cache);
-                            return true;
-                        }
+        private static bool ValidateOrigin(string Service, string Origin)
+        {
+            if (string.IsNullOrEmpty(Origin)) return true;
 
-                        return false;
-                    }
-                };
-            });
-            Server.AddWebSocketService("/attach", () =>
+            if (Debug)
             {
-                return new Attach
+                var DebugResult = MessageBox.Show(
+                    "Attempt to connect to the '" + Service + "' WebSocket.\n\nOrigin: \"" + Origin +
+                    "\"\n\nIf you wish to get this origin whitelisted, please press Control + C on this MessageBox and give the contents to 3dsboy08.\nPress 'Yes'/'No' to continue the connection.",
+                    "Synapse X WebSocket - Debugger", MessageBoxButton.YesNo, MessageBoxImage.Warning, MessageBoxResult.No);
+                if (DebugResult == MessageBoxResult.Yes)
                 {
-                    OriginValidator = origin =>
-                    {
-                        if (origin == null || string.IsNullOrEmpty(origin)) return true;
-
-                        if (Debug)
-                        {
-                            var Result = MessageBox.Show(
-                                "Attempt to connect to the 'Attach' WebSocket.\n\nOrigin: \"" + origin +
-                                "\"\n\nIf you wish to get this origin whitelisted, please press Control + C on this MessageBox and give the contents to 3dsboy08.\nPress 'Yes'/'No' to continue the connection.",
-                                "Synapse X WebSocket - Debugger", MessageBoxButton.YesNo, MessageBoxImage.Warning, MessageBoxResult.No);
-                            if (Result == MessageBoxResult.Yes)
-                            {
-                                return true;
-                            }
-                        }
+                    return true;
+                }
+            }
 
-                        foreach (var Entry in Whitelist.EntriesNoPrompt)
-                        {
-                            if (Entry == origin) return true;
-                        }
+            /* TrustLock only guards the sets and is never held across a prompt */
+            Data.WebSocketEntry Entry;
+            object PromptLock;
+            lock (TrustLock)
+            {
+                if (NoPromptOrigins.Contains(Origin)) return true;
+                if (!PromptOrigins.TryGetValue(Origin, out Entry)) return false;
+                if (TrustBlacklist.Contains(Origin)) return false;
+                if (TrustedOrigins.Contains(Origin)) return true;
 
-                        foreach (var Entry in Whitelist.EntriesPrompt)
-                        {
-                            if (TrustBlacklist.Contains(Entry.Origin)) return false;
-                            if (Cache.Entries.Contains(Entry.Origin)) return true;
-
-                            if (Entry.Origin != origin) continue;
-                            var Result = MessageBox.Show(
-                                "Application '" + Entry.AppName + "' by developer '" + Entry.DevName +
-                                "' wishes to connect to the Synapse WebSocket. Do you wish to allow the connection?\n\nBy pressing 'Yes', you give this application permission to execute scripts, attach Synapse, and set the text of the Synapse X editor of on your behalf.\n\nYou should NEVER allow connections with developers you do not trust. Press 'No' if you do not know what this means.",
-                                "Synapse X Trust Manager", MessageBoxButton.YesNo, MessageBoxImage.Warning,
-                                MessageBoxResult.No);
-                            if (Result != MessageBoxResult.Yes)
-                            {
-                                TrustBlacklist.Add(origin);
-                                return false;
-                            }
-
-                            Cache.Entries.Add(origin);
-                            DataInterface.Save("trustcache", Cache);
-                            return true;
-                        }
+                if (!PromptLocks.TryGetValue(Origin, out PromptLock))
+                    PromptLocks[Origin] = PromptLock = new object();
+            }
 
-                        return false;
-                    }
-                };
-            });
-            Server.AddWebSocketService("/editor", () =>
+            lock (PromptLock)
             {
-                return new Editor
+                /* Someone else from this origin may have been answered while we waited */
+                lock (TrustLock)
                 {
-                    OriginValidator = origin =>
-                    {
-                        if (origin == null || string.IsNullOrEmpty(origin)) return true;
-
-                        if (Debug)
-                        {
-                            var Result = MessageBox.Show(
-                                "Attempt to connect to the 'Editor' WebSocket.\n\nOrigin: \"" + origin +
-                                "\"\n\nIf you wish to get this origin whitelisted, please press Control + C on this MessageBox and give the contents to 3dsboy08.\nPress 'Yes'/'No' to continue the connection.",
-                                "Synapse X WebSocket - Debugger", MessageBoxButton.YesNo, MessageBoxImage.Warning, MessageBoxResult.No);
-                            if (Result == MessageBoxResult.Yes)
-                            {
-                                return true;
-                            }
-                        }
-
-                        foreach (var Entry in Whitelist.EntriesNoPrompt)
-                        {
-                            if (Entry == origin) return true;
-                        }
-
-                        foreach (var Entry in Whitelist.EntriesPrompt)
-                        {
-                            if (TrustBlacklist.Contains(Entry.Origin)) return false;
-                            if (Cache.Entries.Contains(Entry.Origin)) return true;
-
-                            if (Entry.Origin != origin) continue;
-                            var Result = MessageBox.Show(
-                                "Application '" + Entry.AppName + "' by developer '" + Entry.DevName +
-                                "' wishes to connect to the Synapse WebSocket. Do you wish to allow the connection?\n\nBy pressing 'Yes', you give this application permission to execute scripts, attach Synapse, and set the text of the Synapse X editor of on your behalf.\n\nYou should NEVER allow connections with developers you do not trust. Press 'No' if you do not know what this means.",
-                                "Synapse X Trust Manager", MessageBoxButton.YesNo, MessageBoxImage.Warning,
-                                MessageBoxResult.No);
-                            if (Result != MessageBoxResult.Yes)
-                            {
-                                TrustBlacklist.Add(origin);
-                                return false;
-                            }
-
-                            Cache.Entries.Add(origin);
-                            DataInterface.Save("trustcache", Cache);
-                            return true;
-                        }
+                    if (TrustBlacklist.Contains(Origin)) return false;
+                    if (TrustedOrigins.Contains(Origin)) return true;
+                }
 
-                        return false;
-                    }
-                };
-            });
-            Server.AddWebSocketService("/custom", () =>
-            {
-                return new Custom
+                var Result = MessageBox.Show(
+                    "Application '" + Entry.AppName + "' by developer '" + Entry.DevName +
+                    "' wishes to connect to the Synapse WebSocket. Do you wish to allow the connection?\n\nBy pressing 'Yes', you give this application permission to execute scripts, attach Synapse, and set the text of the Synapse X editor of on your behalf.\n\nYou should NEVER allow connections with developers you do not trust. Press 'No' if you do not know what this means.",
+                    "Synapse X Trust Manager", MessageBoxButton.YesNo, MessageBoxImage.Warning,
+                    MessageBoxResult.No);
+                lock (TrustLock)
                 {
-                    OriginValidator = origin =>
+                    if (Result != MessageBoxResult.Yes)
                     {
-                        if (origin == null || string.IsNullOrEmpty(origin)) return true;
-
-                        if (Debug)
-                        {
-                            var Result = MessageBox.Show(
-                                "Attempt to connect to the 'Custom' WebSocket.\n\nOrigin: \"" + origin +
-                                "\"\n\nIf you wish to get this origin whitelisted, please press Control + C on this MessageBox and give the contents to 3dsboy08.\nPress 'Yes'/'No' to continue the connection.",
-                                "Synapse X WebSocket - Debugger", MessageBoxButton.YesNo, MessageBoxImage.Warning, MessageBoxResult.No);
-                            if (Result == MessageBoxResult.Yes)
-                            {
-                                return true;
-                            }
-                        }
-
-                        foreach (var Entry in Whitelist.EntriesNoPrompt)
-                        {
-                            if (Entry == origin) return true;
-                        }
-
-                        foreach (var Entry in Whitelist.EntriesPrompt)
-                        {
-                            if (TrustBlacklist.Contains(Entry.Origin)) return false;
-                            if (Cache.Entries.Contains(Entry.Origin)) return true;
-
-                            if (Entry.Origin != origin) continue;
-                            var Result = MessageBox.Show(
-                                "Application '" + Entry.AppName + "' by developer '" + Entry.DevName +
-                                "' wishes to connect to the Synapse WebSocket. Do you wish to allow the connection?\n\nBy pressing 'Yes', you give this application permission to execute scripts, attach Synapse, and set the text of the Synapse X editor of on your behalf.\n\nYou should NEVER allow connections with developers you do not trust. Press 'No' if you do not know what this means.",
-                                "Synapse X Trust Manager", MessageBoxButton.YesNo, MessageBoxImage.Warning,
-                                MessageBoxResult.No);
-                            if (Result != MessageBoxResult.Yes)
-                            {
-                                TrustBlacklist.Add(origin);
-                                return false;
-                            }
-
-                            Cache.Entries.Add(origin);
-                            DataInterface.Save("trustcache", Cache);
-                            return true;
-                        }
-
+                        TrustBlacklist.Add(Origin);
                         return false;
                     }
-                };
-            });
 
-            Server.Start();
+                    TrustedOrigins.Add(Origin);
+                    Cache.Entries.Add(Origin);
+                    DataInterface.Save("trustcache", Cache);
+                    return true;
+                }
+            }
         }
 
         public static void Stop()
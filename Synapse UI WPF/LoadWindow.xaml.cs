@@ -1,5 +1,6 @@
-#define USE_UPDATE_CHECKS
+﻿#define USE_UPDATE_CHECKS
 using System;
+using System.Collections.Generic;
 using System.ComponentModel;
 using System.Diagnostics;
 using System.IO;
@@ -8,11 +9,14 @@ using System.Linq;
 using System.Net;
 using System.Reflection;
 using System.Threading;
+using System.Threading.Tasks;
 using System.Windows;
+using System.Windows.Interop;
 using CefSharp;
 using CefSharp.Wpf;
 using Microsoft.Win32;
 using Newtonsoft.Json;
+using Synapse_UI_WPF.Controls;
 using Synapse_UI_WPF.Interfaces;
 using Synapse_UI_WPF.Static;
 
@@ -26,6 +30,8 @@ namespace Synapse_UI_WPF
         public static ThemeInterface.TInitStrings InitStrings;
         public static BackgroundWorker LoadWorker = new BackgroundWorker();
 
+        private MainWindow Prewarmed;
+
         public LoadWindow()
         {
             AppDomain.CurrentDomain.UnhandledException += (sender, args) =>
@@ -137,6 +143,7 @@ namespace Synapse_UI_WPF
                     IngameChat = false,
                     BetaRelease = false,
                     InternalUI = false,
+                    NativeEditor = false,
                     WindowScale = 1d
                 };
                 DataInterface.Save("options", new Data.OptionsHolder
@@ -161,6 +168,7 @@ namespace Synapse_UI_WPF
                             IngameChat = false,
                             InternalUI = false,
                             BetaRelease = false,
+                            NativeEditor = false,
                             WindowScale = 1d
                         };
                         DataInterface.Save("options", new Data.OptionsHolder
@@ -185,6 +193,7 @@ namespace Synapse_UI_WPF
                         IngameChat = false,
                         InternalUI = false,
                         BetaRelease = false,
+                        NativeEditor = false,
                         WindowScale = 1d
                     };
                     DataInterface.Save("options", new Data.OptionsHolder
@@ -562,204 +571,111 @@ namespace Synapse_UI_WPF
             Globals.DllPath = DllName;
             Globals.LauncherPath = LauncherName;
 
-            using (var WC = new WebClient())
-            {
-#if USE_UPDATE_CHECKS
-                try
-                {
-                    var Salt = Utils.Sha512Bytes(Environment.MachineName + Data.Version);
-
-                    if (!File.Exists(DllName))
-                    {
-                        SetStatusText(InitStrings.DownloadingDlls, 85);
-                        WC.DownloadFile(Globals.Options.BetaRelease ? Data.BetaDllDownload : Data.DllDownload, DllName);
-                        Utils.AppendAllBytes(DllName, Salt);
-                    }
+            /* Everything missing or out of date is fetched at once, the results are checked in the order they used to download in */
+            const string CdnBase = "https://cdn.synapse.to/synapsedistro/distro/";
+            var Downloads = new List<Download>();
+            var StatusFor = new Dictionary<Download, Tuple<string, int>>();
 
-                    if (Utils.Sha512Dll(DllName) != (Globals.Options.BetaRelease ? Data.BetaDllHash : Data.DllHash))
-                    {
-                        SetStatusText(InitStrings.DownloadingDlls, 85);
-                        File.Delete(DllName);
-                        WC.DownloadFile(Globals.Options.BetaRelease ? Data.BetaDllDownload : Data.DllDownload, DllName);
-                        Utils.AppendAllBytes(DllName, Salt);
+            Download Queue(string Url, string FilePath, string Hash, string Status = null, int Percentage = 0, byte[] Salt = null)
+            {
+                var Job = new Download { Url = Url, Path = FilePath, Hash = Hash, Salt = Salt };
+                Downloads.Add(Job);
+                if (Status != null) StatusFor[Job] = Tuple.Create(Status, Percentage);
+                return Job;
+            }
 
-                        if (Utils.Sha512Dll(DllName) != (Globals.Options.BetaRelease ? Data.BetaDllHash : Data.DllHash))
-                        {
-                            File.Delete(DllName);
-                            Dispatcher.Invoke(() =>
-                            {
-                                Topmost = false;
-                                MessageBox.Show("Failed to verify UI files. Please check your anti-virus software.",
-                                    "Synapse X", MessageBoxButton.OK, MessageBoxImage.Error);
-                                Environment.Exit(0);
-                            });
-                        }
-                    }
-                }
-                catch (Exception)
+            void Fail(string Message)
+            {
+                Dispatcher.Invoke(() =>
                 {
-                    Dispatcher.Invoke(() =>
-                    {
-                        Topmost = false;
-                        MessageBox.Show("Failed to download UI files. Please check your anti-virus software.",
-                            "Synapse X", MessageBoxButton.OK, MessageBoxImage.Error);
-                        Environment.Exit(0);
-                    });
-                }
+                    Topmost = false;
+                    MessageBox.Show(Message, "Synapse X", MessageBoxButton.OK, MessageBoxImage.Error);
+                    Environment.Exit(0);
+                });
+            }
+
+#if USE_UPDATE_CHECKS
+            var DllJob = Queue(Globals.Options.BetaRelease ? Data.BetaDllDownload : Data.DllDownload, DllName,
+                Globals.Options.BetaRelease ? Data.BetaDllHash : Data.DllHash, InitStrings.DownloadingDlls, 85,
+                Utils.Sha512Bytes(Environment.MachineName + Data.Version));
+            var LauncherJob = Queue(Data.LauncherDownload, LauncherName, Data.LauncherHash);
 #endif
 
-                try
-                {
-                    if (!File.Exists("bin\\Monaco.html"))
-                    {
-                        SetStatusText(InitStrings.DownloadingMonaco, 85);
-                        WC.DownloadFile("https://cdn.synapse.to/synapsedistro/distro/Monaco.zip", "bin\\Monaco.zip");
+            /* The native editor needs neither, users who picked it never pay for Chromium */
+            var Native = Globals.Options.NativeEditor;
+            var MonacoJob = Native || File.Exists("bin\\Monaco.html") ? null : Queue(CdnBase + "Monaco.zip", "bin\\Monaco.zip", null, InitStrings.DownloadingMonaco, 85);
+            var CefSharpJob = Native || File.Exists("bin\\CefSharp.dll") ? null : Queue(Data.CefSharpDownload, "bin\\CefSharp.zip", Data.CefSharpHash, InitStrings.DownloadingCefSharp, 85);
 
-                        ZipFile.ExtractToDirectory("bin\\Monaco.zip", "bin");
-                        File.Delete("bin\\Monaco.zip");
-                    }
+            var RedistJobs = new[]
+            {
+                Queue(CdnBase + "sqlite_x64.dll", "bin\\x64\\SQLite.Interop.dll", null, InitStrings.DownloadingSQLite, 90),
+                Queue(CdnBase + "sqlite_x86.dll", "bin\\x86\\SQLite.Interop.dll", null, InitStrings.DownloadingSQLite, 90),
+                Queue(CdnBase + "redis/D3DCompiler_43.dll", "bin\\redis\\D3DCompiler_43.dll", null, InitStrings.DownloadingSQLite, 90),
+                Queue(CdnBase + "redis/xinput1_3.dll", "bin\\redis\\xinput1_3.dll", null, InitStrings.DownloadingSQLite, 90)
+            };
 
-                    if (!File.Exists("bin\\CefSharp.dll"))
-                    {
-                        SetStatusText(InitStrings.DownloadingCefSharp, 85);
-                        WC.DownloadFile(Data.CefSharpDownload, "bin\\CefSharp.zip");
+            var SxLibJob = Queue(Data.SxLibDownload, SxLibName, Data.SxLibHash);
+            var SxLibXmlJob = Queue(Data.SxLibXmlDownload, SxLibXmlName, Data.SxLibXmlHash);
 
-                        if (Utils.Sha512("bin\\CefSharp.zip", true) != Data.CefSharpHash)
-                        {
-                            File.Delete("bin\\CefSharp.zip");
-                            Dispatcher.Invoke(() =>
-                            {
-                                Topmost = false;
-                                MessageBox.Show("Failed to download UI files. Please check your anti-virus software.",
-                                    "Synapse X", MessageBoxButton.OK, MessageBoxImage.Error);
-                                Environment.Exit(0);
-                            });
-                        }
+            /* Extracted as soon as each archive lands, the zip itself stays in the download cache when it has a hash */
+            void Unpack(Download Job)
+            {
+                Unzipper.Extract(Job.Path, "bin");
+                File.Delete(Job.Path);
+            }
 
-                        ZipFile.ExtractToDirectory("bin\\CefSharp.zip", "bin");
-                        File.Delete("bin\\CefSharp.zip");
-                    }
-                }
-                catch (Exception)
-                {
-                    Dispatcher.Invoke(() =>
-                    {
-                        Topmost = false;
-                        MessageBox.Show("Failed to download UI files. Please check your anti-virus software.",
-                            "Synapse X", MessageBoxButton.OK, MessageBoxImage.Error);
-                        Environment.Exit(0);
-                    });
-                }
+            if (MonacoJob != null) MonacoJob.Then = Unpack;
+            if (CefSharpJob != null) CefSharpJob.Then = Unpack;
 
-                try
-                {
-                    if (!Directory.Exists("bin\\x64")) Directory.CreateDirectory("bin\\x64");
-                    if (!Directory.Exists("bin\\x86")) Directory.CreateDirectory("bin\\x86");
-                    if (!Directory.Exists("bin\\redis")) Directory.CreateDirectory("bin\\redis");
+            var BetaUiJob = Globals.Options.BetaRelease
+                ? Queue(Data.BetaUiDownload, "bin\\" + Utils.CreateFileName("Synapse-New-UI.bin"), Data.BetaUiHash)
+                : null;
 
-                    if (!File.Exists("bin\\x64\\SQLite.Interop.dll") || !File.Exists("bin\\x86\\SQLite.Interop.dll") ||
-                        !File.Exists("bin\\redis\\D3DCompiler_43.dll") || !File.Exists("bin\\redis\\xinput1_3.dll"))
-                    {
-                        SetStatusText(InitStrings.DownloadingSQLite, 90);
-
-                        //SQLite
-                        WC.DownloadFile("https://cdn.synapse.to/synapsedistro/distro/sqlite_x64.dll",
-                            "bin\\x64\\SQLite.Interop.dll");
-                        WC.DownloadFile("https://cdn.synapse.to/synapsedistro/distro/sqlite_x86.dll",
-                            "bin\\x86\\SQLite.Interop.dll");
-
-                        //D3D redist
-                        WC.DownloadFile("https://cdn.synapse.to/synapsedistro/distro/redis/D3DCompiler_43.dll",
-                            "bin\\redis\\D3DCompiler_43.dll");
-                        WC.DownloadFile("https://cdn.synapse.to/synapsedistro/distro/redis/xinput1_3.dll",
-                            "bin\\redis\\xinput1_3.dll");
-                    }
-                }
-                catch (Exception)
-                {
-                    Dispatcher.Invoke(() =>
-                    {
-                        Topmost = false;
-                        MessageBox.Show("Failed to download UI files. Please check your anti-virus software.",
-                            "Synapse X", MessageBoxButton.OK, MessageBoxImage.Error);
-                        Environment.Exit(0);
-                    });
-                }
+            Downloader.Run(4, Job =>
+            {
+                if (StatusFor.TryGetValue(Job, out var Status)) SetStatusText(Status.Item1, Status.Item2);
+            }, Downloads.ToArray());
 
-                try
-                {
-                    if (!Directory.Exists("bin\\sxlib")) Directory.CreateDirectory("bin\\sxlib");
+#if USE_UPDATE_CHECKS
+            if (!DllJob.Succeeded)
+                Fail(DllJob.Error == null
+                    ? "Failed to verify UI files. Please check your anti-virus software."
+                    : "Failed to download UI files. Please check your anti-virus software.");
+#endif
 
-                    if (!File.Exists(SxLibName)) WC.DownloadFile(Data.SxLibDownload, SxLibName);
+            if (MonacoJob != null && !MonacoJob.Succeeded || CefSharpJob != null && !CefSharpJob.Succeeded)
+                Fail("Failed to download UI files. Please check your anti-virus software.");
 
-                    if (Utils.Sha512(SxLibName, true) != Data.SxLibHash)
+            /* CEF has to start on the UI thread, queue it now so it comes up while the remaining checks run */
+            if (!Native)
+            {
+                Dispatcher.BeginInvoke(new Action(() =>
+                {
+                    try
                     {
-                        File.Delete(SxLibName);
-                        WC.DownloadFile(Data.SxLibDownload, SxLibName);
-
-                        if (Utils.Sha512(SxLibName, true) != Data.SxLibHash)
-                        {
-                            File.Delete(SxLibName);
-                            MessageBox.Show("Failed to verify SxLib files. Please check your anti-virus software.",
-                                "Synapse X", MessageBoxButton.OK, MessageBoxImage.Error);
-                            Environment.Exit(0);
-                        }
+                        Monaco.InitializeCef();
                     }
-
-                    if (!File.Exists(SxLibXmlName)) WC.DownloadFile(Data.SxLibXmlDownload, SxLibXmlName);
-
-                    if (Utils.Sha512(SxLibXmlName, true) != Data.SxLibXmlHash)
+                    catch (Exception)
                     {
-                        File.Delete(SxLibXmlName);
-                        WC.DownloadFile(Data.SxLibXmlDownload, SxLibXmlName);
-
-                        if (Utils.Sha512(SxLibXmlName, true) != Data.SxLibXmlHash)
-                        {
-                            File.Delete(SxLibName);
-                            MessageBox.Show("Failed to verify SxLib files. Please check your anti-virus software.",
-                                "Synapse X", MessageBoxButton.OK, MessageBoxImage.Error);
-                            Environment.Exit(0);
-                        }
+                        /* MainWindow tries again and reports it */
                     }
-                }
-                catch (Exception)
-                {
-                    Dispatcher.Invoke(() =>
-                    {
-                        Topmost = false;
-                        MessageBox.Show("Failed to download SxLib files. Please check your anti-virus software.",
-                            "Synapse X", MessageBoxButton.OK, MessageBoxImage.Error);
-                        Environment.Exit(0);
-                    });
-                }
+                }));
+            }
 
-#if USE_UPDATE_CHECKS
-                try
-                {
-                    if (!File.Exists(LauncherName)) WC.DownloadFile(Data.LauncherDownload, LauncherName);
+            if (RedistJobs.Any(Job => !Job.Succeeded))
+                Fail("Failed to download UI files. Please check your anti-virus software.");
 
-                    if (Utils.Sha512(LauncherName, true) != Data.LauncherHash)
-                    {
-                        File.Delete(LauncherName);
-                        WC.DownloadFile(Data.LauncherDownload, LauncherName);
+            if (!SxLibJob.Succeeded || !SxLibXmlJob.Succeeded)
+                Fail(SxLibJob.Error == null && SxLibXmlJob.Error == null
+                    ? "Failed to verify SxLib files. Please check your anti-virus software."
+                    : "Failed to download SxLib files. Please check your anti-virus software.");
 
-                        if (Utils.Sha512(LauncherName, true) != Data.LauncherHash)
-                        {
-                            File.Delete(LauncherName);
-                            MessageBox.Show("Failed to verify launcher files. Please check your anti-virus software.",
-                                "Synapse X", MessageBoxButton.OK, MessageBoxImage.Error);
-                            Environment.Exit(0);
-                        }
-                    }
-                }
-                catch (Exception)
-                {
-                    MessageBox.Show("Failed to download launcher files. Please check your anti-virus software.",
-                        "Synapse X", MessageBoxButton.OK, MessageBoxImage.Error);
-                    Environment.Exit(0);
-                }
+#if USE_UPDATE_CHECKS
+            if (!LauncherJob.Succeeded)
+                Fail(LauncherJob.Error == null
+                    ? "Failed to verify launcher files. Please check your anti-virus software."
+                    : "Failed to download launcher files. Please check your anti-virus software.");
 #endif
-            }
 
             if (Globals.Options.AutoLaunch)
             {
@@ -834,32 +750,13 @@ namespace Synapse_UI_WPF
 
             if (Globals.Options.BetaRelease)
             {
-                var UiName = "bin\\" + Utils.CreateFileName("Synapse-New-UI.bin");
-
-                try
-                {
-                    using (var WC = new WebClient())
-                    {
-                        if (!File.Exists(UiName)) WC.DownloadFile(Data.BetaUiDownload, UiName);
+                var UiName = BetaUiJob.Path;
 
-                        if (Utils.Sha512(UiName, true) != Data.BetaUiHash)
-                        {
-                            File.Delete(UiName);
-                            WC.DownloadFile(Data.BetaUiDownload, UiName);
-
-                            if (Utils.Sha512(UiName, true) != Data.BetaUiHash)
-                            {
-                                File.Delete(UiName);
-                                MessageBox.Show("Failed to verify beta UI files. Please check your anti-virus software.",
-                                    "Synapse X", MessageBoxButton.OK, MessageBoxImage.Error);
-                                Environment.Exit(0);
-                            }
-                        }
-                    }
-                }
-                catch (Exception)
+                if (!BetaUiJob.Succeeded)
                 {
-                    MessageBox.Show("Failed to download beta UI files. Please check your anti-virus software.",
+                    MessageBox.Show(BetaUiJob.Error == null
+                            ? "Failed to verify beta UI files. Please check your anti-virus software."
+                            : "Failed to download beta UI files. Please check your anti-virus software.",
                         "Synapse X", MessageBoxButton.OK, MessageBoxImage.Error);
                     Environment.Exit(0);
                 }
@@ -874,6 +771,22 @@ namespace Synapse_UI_WPF
                 Environment.Exit(0);
             }
 
+            /* Build MainWindow hidden while Discord is checked. Giving it a handle lays it out, which creates the editor's
+               browser and loads Monaco before the window is ever shown */
+            Dispatcher.Invoke(() =>
+            {
+                try
+                {
+                    Prewarmed = new MainWindow();
+                    new WindowInteropHelper(Prewarmed).EnsureHandle();
+                }
+                catch (Exception)
+                {
+                    /* Built again below, where failures are reported */
+                    Prewarmed = null;
+                }
+            });
+
             try
             {
                 if (!DataInterface.Exists("discord"))
@@ -1309,7 +1222,7 @@ namespace Synapse_UI_WPF
             {
                 try
                 {
-                    var Main = new MainWindow();
+                    var Main = Prewarmed ?? new MainWindow();
                     Main.Show();
                     Close();
                 }
@@ -1,18 +1,25 @@
 #define USE_UPDATE_CHECKS
 
 using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.ComponentModel;
 using System.IO;
 using System.IO.Compression;
 using System.IO.Pipes;
+using System.Linq;
 using System.Net;
 using System.Reflection;
+using System.Runtime.CompilerServices;
 using System.Security.AccessControl;
 using System.Security.Principal;
+using System.Text.RegularExpressions;
 using System.Threading;
+using System.Threading.Tasks;
 using System.Windows;
+using System.Windows.Controls;
 using System.Windows.Input;
+using System.Windows.Media;
 using CefSharp;
 using CefSharp.Wpf;
 using Microsoft.Win32;
@@ -26,7 +33,7 @@ namespace Synapse_UI_WPF
 {
     public partial class MainWindow
     {
-        public ProcessWatcher Watcher;
+        public ProcessTracker Watcher;
 
         public delegate void InteractMessageEventHandler(object sender, string Input);
         public event InteractMessageEventHandler InteractMessageRecieved;
@@ -48,45 +55,61 @@ namespace Synapse_UI_WPF
 
         private readonly string BaseDirectory;
         private readonly string ScriptsDirectory;
+        private readonly ScriptFolder Scripts;
 
         public static BackgroundWorker Worker = new BackgroundWorker();
         public static BackgroundWorker HubWorker = new BackgroundWorker();
 
+        /* Cleared for good if the loaded SynapseInjector.dll predates SynSyntaxCheck */
+        private static bool SyntaxCheckAvailable = true;
+        private static readonly Regex NearToken = new Regex("near '(.*)'$");
+        private bool SyntaxErrorShown;
+
+        /* Editor tabs in strip order, swapped whole so the save thread can read it without a lock. The first is
+           tab 0 and saved as savedws, the rest go to savedtabs */
+        private volatile int[] OpenTabs = { 0 };
+        private int TabCounter;
+
+        /* Monaco, or the native editor when the NativeEditor option is set */
+        private readonly IScriptEditor Browser;
+
         public MainWindow()
         {
-			Cef.EnableHighDPISupport();
-			var settings = new CefSettings();
-			settings.SetOffScreenRenderingBestPerformanceArgs();
-			Cef.Initialize(settings);
-
 			InitializeComponent();
 
+            Browser = Globals.Options.NativeEditor ? new NativeEditor() : CreateMonaco();
+            Browser.MonacoReady += Browser_MonacoReady;
+            EditorHost.Content = Browser;
+
 			Worker.DoWork += Worker_DoWork;
             HubWorker.DoWork += HubWorker_DoWork;
 
             StreamReader InteractReader = null;
-            StreamReader LaunchReader;
 
             try
             {
-                Watcher = new ProcessWatcher("RobloxPlayerBeta.exe");
-                Watcher.ProcessCreated += Proc =>
+                Watcher = new ProcessTracker("RobloxPlayerBeta.exe");
+                Watcher.ProcessStarted += Id =>
                 {
                     if (!Globals.Options.AutoAttach || Globals.Options.AutoLaunch) return;
-                    RobloxIdOverride = Convert.ToInt32(Proc.ProcessId);
+                    RobloxIdOverride = Id;
                     Worker.RunWorkerAsync();
                 };
-                Watcher.ProcessDeleted += Proc =>
+                Watcher.ProcessStopped += Id =>
                 {
-                    if (Proc.ProcessId == RobloxIdTemp)
+                    if (Id == RobloxIdTemp)
                     {
                         InteractReader?.Close();
                     }
+
+                    Detach(Id);
                 };
                 Watcher.Start();
             }
             catch (Exception)
             {
+                Watcher = null;
+
                 if (!DataInterface.Exists("failnotice"))
                 {
                     MessageBox.Show(
@@ -121,10 +144,12 @@ namespace Synapse_UI_WPF
             ThemeInterface.ApplySeperator(TopBox, TMain.TopBox);
             ThemeInterface.ApplyFormatLabel(TitleBox, TMain.TitleBox, Globals.Version);
             ThemeInterface.ApplyListBox(ScriptBox, TMain.ScriptBox);
+            ThemeInterface.ApplyListBox(TabBox, TMain.ScriptBox);
             ThemeInterface.ApplyButton(MiniButton, TMain.MinimizeButton);
             ThemeInterface.ApplyButton(CloseButton, TMain.ExitButton);
             ThemeInterface.ApplyButton(ExecuteButton, TMain.ExecuteButton);
             ThemeInterface.ApplyButton(ClearButton, TMain.ClearButton);
+            ThemeInterface.ApplyButton(NewTabButton, TMain.ClearButton);
             ThemeInterface.ApplyButton(OpenFileButton, TMain.OpenFileButton);
             ThemeInterface.ApplyButton(ExecuteFileButton, TMain.ExecuteFileButton);
             ThemeInterface.ApplyButton(SaveFileButton, TMain.SaveFileButton);
@@ -139,88 +164,97 @@ namespace Synapse_UI_WPF
 
             BaseDirectory = Directory.GetParent(Path.GetDirectoryName(Assembly.GetExecutingAssembly().Location)).FullName;
 
+            var PS = new PipeSecurity();
+            var Rule = new PipeAccessRule(new SecurityIdentifier(WellKnownSidType.WorldSid, null), PipeAccessRights.ReadWrite, AccessControlType.Allow);
+            PS.AddAccessRule(Rule);
+
+            /* Status lines from every interact connection go through one pump, so handlers see them in order and a slow
+               handler never holds up a pipe */
+            var InteractQueue = new BlockingCollection<string>();
             new Thread(() =>
             {
-                var PS = new PipeSecurity();
-                var Rule = new PipeAccessRule(new SecurityIdentifier(WellKnownSidType.WorldSid, null), PipeAccessRights.ReadWrite, AccessControlType.Allow);
-                PS.AddAccessRule(Rule);
-                var Server = new NamedPipeServerStream("SynapseInteract", PipeDirection.InOut, 1, PipeTransmissionMode.Byte, PipeOptions.None, 0, 0, PS);
-                Server.WaitForConnection();
-                InteractReader = new StreamReader(Server);
-                while (true)
+                foreach (var Line in InteractQueue.GetConsumingEnumerable())
+                    InteractMessageRecieved?.Invoke(this, Line);
+            }) { IsBackground = true }.Start();
+
+            for (var i = 0; i < PipeInstances; i++)
+            {
+                Task.Run(() => ServePipe("SynapseInteract", PS, Reader => InteractReader = Reader, Line =>
                 {
-                    string Line;
-                    try
-                    {
-                        Line = InteractReader.ReadLine();
-                    }
-                    catch (Exception)
-                    {
-                        Line = "SYN_INTERRUPT";
-                    }
                     if (string.IsNullOrWhiteSpace(Line)) Line = "SYN_INTERRUPT";
-                    InteractMessageRecieved?.Invoke(this, Line);
-                    if (Line != "SYN_READY" && Line != "SYN_REATTACH_READY" && Line != "SYN_INTERRUPT") continue;
-                    InteractReader.Close();
-                    Server.Close();
-                    Thread.Sleep(3000);
-                    Server = new NamedPipeServerStream("SynapseInteract", PipeDirection.InOut, 1, PipeTransmissionMode.Byte, PipeOptions.None, 0, 0, PS);
-                    Server.WaitForConnection();
-                    InteractReader = new StreamReader(Server);
-                }
-            }).Start();
+                    InteractQueue.Add(Line);
+                    return Line != "SYN_READY" && Line != "SYN_REATTACH_READY" && Line != "SYN_INTERRUPT";
+                }));
+
+                Task.Run(() => ServePipe("SynapseLaunch", PS, null, Line =>
+                {
+                    var Split = Line?.Split('|');
+                    if (Split == null) return false;
+                    if (Split[0] != "SYN_LAUNCH_NOTIIFCATION") return true;
+
+                    RobloxIdTemp = int.Parse(Split[1]);
+                    return false;
+                }));
+            }
 
             new Thread(() =>
             {
-                var PS = new PipeSecurity();
-                var Rule = new PipeAccessRule(new SecurityIdentifier(WellKnownSidType.WorldSid, null), PipeAccessRights.ReadWrite, AccessControlType.Allow);
-                PS.AddAccessRule(Rule);
-                var Server = new NamedPipeServerStream("SynapseLaunch", PipeDirection.InOut, 1, PipeTransmissionMode.Byte, PipeOptions.None, 0, 0, PS);
-                Server.WaitForConnection();
-                LaunchReader = new StreamReader(Server);
+                /* Monaco pushes its edits into Browser, so the workspace is saved from that copy once it's been left alone
+                   for a couple of seconds. Pages that never synced fall back to reading the editor every 15 seconds */
+                long SavedRevision = 0;
+                var Ticks = 0;
+
                 while (true)
                 {
-                    string Line;
+                    Thread.Sleep(1000);
+
                     try
                     {
-                        Line = LaunchReader.ReadLine();
-                    }
-                    catch (Exception)
-                    {
-                        Line = "SYN_INTERRUPT";
-                    }
+                        string[] Texts;
+                        long Revision;
+                        int Idle;
 
-                    if (Line?.Split('|')[0] == "SYN_LAUNCH_NOTIIFCATION")
-                    {
-                        RobloxIdTemp = int.Parse(Line.Split('|')[1]);
-                    }
+                        if (Browser.TryGetSyncedTabs(OpenTabs, out Texts, out Revision, out Idle))
+                        {
+                            if (Revision == SavedRevision || Idle < 2000) continue;
+
+                            SaveTabs(Texts);
+                            SavedRevision = Revision;
+                            continue;
+                        }
+
+                        if (++Ticks % 15 != 0 || Browser.ActiveTab != 0) continue;
 
-                    if (Line?.Split('|')[0] != "SYN_LAUNCH_NOTIIFCATION") continue;
-                    LaunchReader.Close();
-                    Server.Close();
-                    Thread.Sleep(3000);
-                    Server = new NamedPipeServerStream("SynapseLaunch", PipeDirection.InOut, 1, PipeTransmissionMode.Byte, PipeOptions.None, 0, 0, PS);
-                    Server.WaitForConnection();
-                    LaunchReader = new StreamReader(Server);
+                        DataInterface.Save("savedws", Browser.GetTextAsync().Result);
+                    }
+                    catch (Exception) { }
                 }
             }).Start();
 
             new Thread(() =>
             {
-                while (true)
+                /* Lints the synced copy shortly after typing stops, the parse runs here so the game never sees it */
+                long CheckedRevision = -1;
+
+                while (SyntaxCheckAvailable)
                 {
-                    Thread.Sleep(15000);
+                    Thread.Sleep(250);
 
                     try
                     {
-                        var EditorText = "";
-                        Dispatcher.Invoke(() => { EditorText = Browser.GetText(); });
+                        string EditorText;
+                        long Revision;
+                        int Idle;
 
-                        DataInterface.Save("savedws", EditorText);
+                        if (!Browser.TryGetSyncedText(out EditorText, out Revision, out Idle)) continue;
+                        if (Revision == CheckedRevision || Idle < 500) continue;
+
+                        CheckSyntax(EditorText, true);
+                        CheckedRevision = Revision;
                     }
                     catch (Exception) { }
                 }
-            }).Start();
+            }) { IsBackground = true }.Start();
 
             InteractMessageRecieved += delegate (object Sender, string Input)
             {
@@ -248,9 +282,9 @@ namespace Synapse_UI_WPF
 
                 if (Input == "SYN_READY")
                 {
-                    var ProcList = Process.GetProcessesByName("RobloxPlayerBeta");
-                    RbxId = RobloxIdTemp == 0 ? ProcList[0].Id : RobloxIdTemp;
+                    RbxId = RobloxIdTemp == 0 ? FindRoblox() : RobloxIdTemp;
                     RobloxIdTemp = 0;
+                    Ready();
                     var EnableUnlock = Globals.Options.UnlockFPS ? "TRUE" : "FALSE";
                     var EnableWebSocket = TMain.WebSocket.Enabled ? "TRUE" : "FALSE";
                     var EnableInternalUI = Globals.Options.InternalUI ? "TRUE" : "FALSE";
@@ -261,15 +295,106 @@ namespace Synapse_UI_WPF
 
             ScriptsDirectory = Path.Combine(BaseDirectory, "scripts");
 
-            foreach (var FilePath in Directory.GetFiles(ScriptsDirectory))
-            {
-                ScriptBox.Items.Add(Path.GetFileName(FilePath));
-            }
+            Scripts = new ScriptFolder(ScriptsDirectory, Dispatcher);
+            ScriptBox.ItemsSource = Scripts;
 
             if (TMain.WebSocket.Enabled)
             {
                 WebSocketInterface.Start(24892, this);
             }
+
+            ChannelInterface.MetricsReceived += Values => Dispatcher.BeginInvoke(new Action(() =>
+            {
+                if (DiagnosticsPanel.Visibility == Visibility.Visible) DiagnosticsBox.Text = FormatMetrics(Values);
+            }));
+        }
+
+        /* One line per Metrics::Format value, sizes in MB */
+        private static string FormatMetrics(Dictionary<string, string> Values)
+        {
+            string Get(string Key) => Values.TryGetValue(Key, out var Value) ? Value : "-";
+            string Megabytes(string Key) => ulong.TryParse(Get(Key), out var Bytes) ? (Bytes / 1048576.0).ToString("0.0") : "-";
+
+            return "Queue depth:   " + Get("queue") + "\n" +
+                   "Tasks/s:       " + Get("tasks") + "\n" +
+                   "Compiles:      " + Get("compiles") + "\n" +
+                   "Avg compile:   " + Get("compile_ms") + " ms\n" +
+                   "Yields:        " + Get("yields") + "\n" +
+                   "HTTP leased:   " + Get("http_leased") + "\n" +
+                   "HTTP idle:     " + Get("http_idle") + "\n" +
+                   "HTTP reused:   " + Get("http_reused") + "\n" +
+                   "HTTP created:  " + Get("http_created") + "\n" +
+                   "Draw objects:  " + Get("render") + "\n" +
+                   "Lua heap:      " + Megabytes("heap") + " MB\n" +
+                   "Private:       " + Megabytes("private") + " MB\n" +
+                   "Working set:   " + Megabytes("working") + " MB";
+        }
+
+        private void DiagnosticsItem_Click(object sender, RoutedEventArgs e)
+        {
+            DiagnosticsPanel.Visibility = DiagnosticsItem.IsChecked ? Visibility.Visible : Visibility.Collapsed;
+        }
+
+        private const int PipeInstances = 4;
+
+        /* Keeps an instance of Name listening at once per caller, so a client connecting while another is being served or
+           right after one left is never turned away. OnLine gets null when the client is gone and returns false to drop it */
+        private static async Task ServePipe(string Name, PipeSecurity PS, Action<StreamReader> OnConnect, Func<string, bool> OnLine)
+        {
+            while (true)
+            {
+                NamedPipeServerStream Server;
+                try
+                {
+                    Server = new NamedPipeServerStream(Name, PipeDirection.InOut, PipeInstances, PipeTransmissionMode.Byte, PipeOptions.Asynchronous, 0, 0, PS);
+                }
+                catch (IOException)
+                {
+                    await Task.Delay(250).ConfigureAwait(false);
+                    continue;
+                }
+
+                using (Server)
+                {
+                    try
+                    {
+                        await Server.WaitForConnectionAsync().ConfigureAwait(false);
+                    }
+                    catch (IOException)
+                    {
+                        continue;
+                    }
+
+                    using (var Reader = new StreamReader(Server))
+                    {
+                        OnConnect?.Invoke(Reader);
+
+                        while (true)
+                        {
+                            string Line;
+                            try
+                            {
+                                Line = await Reader.ReadLineAsync().ConfigureAwait(false);
+                            }
+                            catch (Exception)
+                            {
+                                Line = null;
+                            }
+
+                            try
+                            {
+                                if (!OnLine(Line)) break;
+                            }
+                            catch (Exception)
+                            {
+                                break;
+                            }
+
+                            if (Line == null) break;
+                        }
+                    }
+                }
+            }
         }
 
         public void SetTitle(string Str, int Delay = 0)
@@ -294,17 +419,139 @@ namespace Synapse_UI_WPF
             }
         }
 
+        /* The longest running client that isn't attached yet, or the first one when they all are. Looked up in the
+           tracker's live set, only enumerated when the tracker couldn't start */
+        private int FindRoblox()
+        {
+            var Running = Watcher != null
+                ? Watcher.All()
+                : Process.GetProcessesByName("RobloxPlayerBeta").Select(Proc => Proc.Id).ToArray();
+
+            lock (Attached)
+            {
+                foreach (var Id in Running)
+                    if (!Attached.ContainsKey(Id)) return Id;
+            }
+
+            return Running.Length == 0 ? 0 : Running[0];
+        }
+
+        /* Every client that reached SYN_READY and hasn't exited. RbxId is the one Execute targets */
+        private static readonly Dictionary<int, Process> Attached = new Dictionary<int, Process>();
+
+        /* Pipe names only change with the process, so they're worked out once per attached client */
+        private readonly Dictionary<int, Dictionary<string, string>> PipeNames = new Dictionary<int, Dictionary<string, string>>();
+
+        public bool IsAttached(int Id)
+        {
+            lock (Attached)
+                return Attached.ContainsKey(Id);
+        }
+
+        /* True while some running client hasn't been attached, an attach then picks that one */
+        public bool CanAttachMore()
+        {
+            var Found = FindRoblox();
+            return Found != 0 && !IsAttached(Found);
+        }
+
         [Obfuscation(Feature = "virtualization", Exclude = false)]
         public string GetPipeName(string PipeName)
         {
-            return Utils.Sha512(PipeName + RbxId).ToLower().Substring(0, 16);
+            return GetPipeName(PipeName, RbxId);
+        }
+
+        [Obfuscation(Feature = "virtualization", Exclude = false)]
+        public string GetPipeName(string PipeName, int Id)
+        {
+            lock (PipeNames)
+            {
+                if (!PipeNames.TryGetValue(Id, out var Names))
+                    PipeNames[Id] = Names = new Dictionary<string, string>();
+
+                if (!Names.TryGetValue(PipeName, out var Name))
+                    Names[PipeName] = Name = Utils.Sha512(PipeName + Id).ToLower().Substring(0, 16);
+
+                return Name;
+            }
         }
 
         [Obfuscation(Feature = "virtualization", Exclude = false)]
         public bool Ready()
         {
-            var ProcList = Process.GetProcessesByName("RobloxPlayerBeta");
-            return ProcList.Length != 0 && ProcList[0].Id == RbxId;
+            var Id = RbxId;
+            if (Id == 0) return false;
+
+            Process Proc;
+            lock (Attached)
+            {
+                if (!Attached.TryGetValue(Id, out Proc))
+                {
+                    try
+                    {
+                        Attached[Id] = Proc = Process.GetProcessById(Id);
+                    }
+                    catch (Exception)
+                    {
+                        Proc = null;
+                    }
+                }
+            }
+
+            try
+            {
+                if (Proc != null && !Proc.HasExited) return true;
+            }
+            catch (Exception) { }
+
+            Detach(Id);
+            return false;
+        }
+
+        /* Forgets a client that exited, Execute moves on to another attached one if there is any */
+        private void Detach(int Id)
+        {
+            lock (Attached)
+            {
+                if (!Attached.TryGetValue(Id, out var Proc)) return;
+
+                Attached.Remove(Id);
+                Proc.Dispose();
+
+                if (RbxId == Id) RbxId = Attached.Count == 0 ? 0 : Attached.Keys.Last();
+            }
+
+            lock (PipeNames)
+                PipeNames.Remove(Id);
+
+            ChannelInterface.Close(Id);
+        }
+
+        /* Every live attached client, pruning the ones that exited without the tracker noticing */
+        private int[] LiveClients()
+        {
+            KeyValuePair<int, Process>[] Clients;
+            lock (Attached)
+                Clients = Attached.ToArray();
+
+            var Live = new List<int>(Clients.Length);
+            foreach (var Client in Clients)
+            {
+                bool Exited;
+                try
+                {
+                    Exited = Client.Value.HasExited;
+                }
+                catch (Exception)
+                {
+                    Exited = true;
+                }
+
+                if (Exited) Detach(Client.Key);
+                else Live.Add(Client.Key);
+            }
+
+            return Live.ToArray();
         }
 
         [Obfuscation(Feature = "virtualization", Exclude = false)]
@@ -334,16 +581,52 @@ namespace Synapse_UI_WPF
         {
             if (data.Length == 0) return;
 
-            var ProcList = Process.GetProcessesByName("RobloxPlayerBeta");
-            if (ProcList.Length == 0 || ProcList[0].Id != RbxId)
+            if (!Ready())
             {
                 SetTitle(AttachStrings.NotInjected, 3000);
                 return;
             }
 
+            /* The framed channel stays connected between scripts, the connect-per-script pipe is only used by older modules */
+            var Type = data.StartsWith("SYN_FILE_PATH|") ? ChannelMessage.Init : ChannelMessage.Execute;
+            if (ChannelInterface.Send(RbxId, GetPipeName("SynapseChannel"), Type, data, 50)) return;
+
             SendData(GetPipeName("SynapseScript"), data, 50);
         }
 
+        /* Runs data on every attached client at once over their persistent channels, so the cost grows with the script
+           rather than the number of clients. Returns how many clients it went to */
+        [Obfuscation(Feature = "virtualization", Exclude = false)]
+        public int ExecuteAll(string data)
+        {
+            if (data.Length == 0) return 0;
+
+            var Clients = LiveClients();
+            if (Clients.Length == 0)
+            {
+                SetTitle(AttachStrings.NotInjected, 3000);
+                return 0;
+            }
+
+            var Failed = ChannelInterface.SendAll(Clients.ToDictionary(Id => Id, Id => GetPipeName("SynapseChannel", Id)),
+                ChannelMessage.Execute, data, 50);
+
+            Parallel.ForEach(Failed, Id => SendData(GetPipeName("SynapseScript", Id), data, 50));
+
+            return Clients.Length;
+        }
+
+        /* Out of line so the native editor never JITs a method that touches CefSharp, it may not be on disk */
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        private static IScriptEditor CreateMonaco()
+        {
+            Monaco.InitializeCef();
+
+            var Editor = new Monaco();
+            RenderOptions.SetBitmapScalingMode(Editor, BitmapScalingMode.HighQuality);
+            return Editor;
+        }
+
         private void Window_MouseDown(object sender, MouseButtonEventArgs e)
         {
             if (e.ChangedButton == MouseButton.Left && e.ButtonState == MouseButtonState.Pressed)
@@ -373,6 +656,25 @@ namespace Synapse_UI_WPF
 
             Browser.SetText(SavedWS);
 
+            /* A reloaded page starts over with only tab 0 */
+            OpenTabs = new[] { 0 };
+            TabCounter = 0;
+            TabBox.Items.Clear();
+            AddTab(0);
+
+            try
+            {
+                if (DataInterface.Exists("savedtabs"))
+                    foreach (var Text in DataInterface.Read<List<string>>("savedtabs"))
+                        AddTab(Browser.NewTab(Text));
+            }
+            catch (Exception)
+            {
+                DataInterface.Delete("savedtabs");
+            }
+
+            TabBox.SelectedIndex = 0;
+
             /* Intellisense */
 
             var KeywordsControlFlow = new List<string>
@@ -578,14 +880,65 @@ namespace Synapse_UI_WPF
             Browser.SetText(Text);
         }
 
-        private void CloseButton_Click(object sender, RoutedEventArgs e)
+        private static void SaveTabs(string[] Texts)
+        {
+            DataInterface.Save("savedws", Texts[0]);
+            DataInterface.Save("savedtabs", Texts.Skip(1).ToList());
+        }
+
+        private ListBoxItem AddTab(int Id)
+        {
+            if (Id < 0) return null;
+
+            var Item = new ListBoxItem { Content = $"Script {++TabCounter}", Tag = Id, Padding = new Thickness(8, 0, 8, 0) };
+            TabBox.Items.Add(Item);
+            OpenTabs = OpenTabs.Contains(Id) ? OpenTabs : OpenTabs.Concat(new[] { Id }).ToArray();
+            return Item;
+        }
+
+        private void NewTabButton_Click(object sender, RoutedEventArgs e)
+        {
+            var Item = AddTab(Browser.NewTab(""));
+            if (Item != null) TabBox.SelectedItem = Item;
+        }
+
+        private void TabBox_SelectionChanged(object sender, SelectionChangedEventArgs e)
+        {
+            if (TabBox.SelectedItem is ListBoxItem Item)
+                Browser.SwitchTab((int) Item.Tag);
+        }
+
+        private void CloseTabItem_Click(object sender, RoutedEventArgs e)
+        {
+            if (!(TabBox.SelectedItem is ListBoxItem Item) || (int) Item.Tag == 0) return;
+
+            /* Monaco won't dispose the model it shows, the tab to the left takes over first */
+            var Id = (int) Item.Tag;
+            TabBox.SelectedIndex = TabBox.SelectedIndex - 1;
+
+            if (!Browser.CloseTab(Id)) return;
+
+            TabBox.Items.Remove(Item);
+            OpenTabs = OpenTabs.Where(T => T != Id).ToArray();
+        }
+
+        private async void CloseButton_Click(object sender, RoutedEventArgs e)
         {
             if (Globals.Theme.Main.WebSocket.Enabled)
             {
                 WebSocketInterface.Stop();
             }
 
-            DataInterface.Save("savedws", Browser.GetText());
+            string[] Texts;
+            long Revision;
+            int Idle;
+
+            if (Browser.TryGetSyncedTabs(OpenTabs, out Texts, out Revision, out Idle))
+                SaveTabs(Texts);
+            else if (Browser.ActiveTab == 0)
+                DataInterface.Save("savedws", await Browser.GetTextAsync());
+
+            DataInterface.Flush();
             Application.Current.Shutdown();
             Environment.Exit(0);
         }
@@ -656,16 +1009,13 @@ namespace Synapse_UI_WPF
             }
         }
 
-        private void SaveFileButton_Click(object sender, RoutedEventArgs e)
+        private async void SaveFileButton_Click(object sender, RoutedEventArgs e)
         {
             var SaveDialog = new SaveFileDialog {Filter = "Script Files (*.lua, *.txt)|*.lua;*.txt", FileName = ""};
 
-            SaveDialog.FileOk += (o, args) =>
-            {
-                File.WriteAllText(SaveDialog.FileName, Browser.GetText());
-            };
+            if (SaveDialog.ShowDialog() != true) return;
 
-            SaveDialog.ShowDialog();
+            File.WriteAllText(SaveDialog.FileName, await Browser.GetTextAsync());
         }
 
         private void AttachButton_Click(object sender, RoutedEventArgs e)
@@ -687,20 +1037,97 @@ namespace Synapse_UI_WPF
             HubWorker.RunWorkerAsync();
         }
 
-        private void ExecuteButton_Click(object sender, RoutedEventArgs e)
+        /* True when Text parses (or the check is unavailable), otherwise the error is marked in the editor when Show is set.
+           Runs off the UI thread, the marker and SyntaxErrorShown are only touched on the Dispatcher */
+        private bool CheckSyntax(string Text, bool Show, out int Line)
+        {
+            Line = 0;
+            if (!SyntaxCheckAvailable) return true;
+
+            string Message;
+            try
+            {
+                if (CInterface.CheckSyntax(Text, out Line, out Message))
+                {
+                    if (Show)
+                    {
+                        Dispatcher.BeginInvoke(new Action(() =>
+                        {
+                            if (!SyntaxErrorShown) return;
+
+                            Browser.ClearSyntaxError();
+                            SyntaxErrorShown = false;
+                        }));
+                    }
+
+                    return true;
+                }
+            }
+            catch (Exception ex) when (ex is EntryPointNotFoundException || ex is DllNotFoundException)
+            {
+                SyntaxCheckAvailable = false;
+                return true;
+            }
+
+            if (!Show) return false;
+
+            /* Lua only reports the line, underline the token it stopped at when it can be found there */
+            var Lines = Text.Split('\n');
+            var LineText = Lines[Math.Max(0, Math.Min(Line, Lines.Length) - 1)].TrimEnd('\r');
+            var Column = 1;
+            var EndColumn = LineText.Length + 1;
+
+            var Near = NearToken.Match(Message);
+            if (Near.Success && Near.Groups[1].Value != "<eof>")
+            {
+                var Index = LineText.IndexOf(Near.Groups[1].Value, StringComparison.Ordinal);
+                if (Index >= 0)
+                {
+                    Column = Index + 1;
+                    EndColumn = Column + Math.Max(1, Near.Groups[1].Value.Length);
+                }
+            }
+
+            var ErrorLine = Line;
+            Dispatcher.BeginInvoke(new Action(() =>
+            {
+                Browser.ShowSyntaxError(ErrorLine, Column, ErrorLine, EndColumn, Message);
+                SyntaxErrorShown = true;
+            }));
+            return false;
+        }
+
+        private bool CheckSyntax(string Text, bool Show)
+        {
+            int Line;
+            return CheckSyntax(Text, Show, out Line);
+        }
+
+        /* Shift+Execute runs the editor on every attached client */
+        private async void ExecuteButton_Click(object sender, RoutedEventArgs e)
         {
-            Execute(Browser.GetText());
+            var All = Keyboard.Modifiers.HasFlag(ModifierKeys.Shift);
+            var Text = await Browser.GetTextAsync();
+
+            /* A script the parser rejects would only fail in the game's compiler */
+            var Line = 0;
+            if (!await Task.Run(() => CheckSyntax(Text, true, out Line)))
+            {
+                SetTitle($" (syntax error on line {Line}!)", 3000);
+                return;
+            }
+
+            if (All) ExecuteAll(Text);
+            else Execute(Text);
         }
 
         private void ExecuteItem_Click(object sender, RoutedEventArgs e)
         {
-            if (ScriptBox.SelectedIndex == -1) return;
+            if (!(ScriptBox.SelectedItem is string Element)) return;
 
             try
             {
-                var Element = ScriptBox.Items[ScriptBox.SelectedIndex].ToString();
-
-                Execute(File.ReadAllText(Path.Combine(ScriptsDirectory, Element)));
+                Execute(File.ReadAllText(Scripts.PathOf(Element)));
             }
             catch (Exception)
             {
@@ -711,13 +1138,11 @@ namespace Synapse_UI_WPF
 
         private void LoadItem_Click(object sender, RoutedEventArgs e)
         {
-            if (ScriptBox.SelectedIndex == -1) return;
+            if (!(ScriptBox.SelectedItem is string Element)) return;
 
             try
             {
-                var Element = ScriptBox.Items[ScriptBox.SelectedIndex].ToString();
-
-                Browser.SetText(File.ReadAllText(Path.Combine(ScriptsDirectory, Element)));
+                Browser.SetText(File.ReadAllText(Scripts.PathOf(Element)));
             }
             catch (Exception)
             {
@@ -728,12 +1153,7 @@ namespace Synapse_UI_WPF
 
         private void RefreshItem_Click(object sender, RoutedEventArgs e)
         {
-            ScriptBox.Items.Clear();
-
-            foreach (var FilePath in Directory.GetFiles(ScriptsDirectory))
-            {
-                ScriptBox.Items.Add(Path.GetFileName(FilePath));
-            }
+            Scripts.Refresh();
         }
 
         [Obfuscation(Feature = "virtualization", Exclude = false)]
@@ -838,17 +1258,17 @@ namespace Synapse_UI_WPF
 
                 try
                 {
-                    if (!File.Exists("bin\\Monaco.html"))
+                    if (!Globals.Options.NativeEditor && !File.Exists("bin\\Monaco.html"))
                     {
                         SetTitle(" (updating Monaco...)");
 
                         WC.DownloadFile("https://cdn.synapse.to/synapsedistro/distro/Monaco.zip", "bin\\Monaco.zip");
 
-                        ZipFile.ExtractToDirectory("bin\\Monaco.zip", "bin");
+                        Unzipper.Extract("bin\\Monaco.zip", "bin");
                         File.Delete("bin\\Monaco.zip");
                     }
 
-                    if (!File.Exists("bin\\CefSharp.dll"))
+                    if (!Globals.Options.NativeEditor && !File.Exists("bin\\CefSharp.dll"))
                     {
                         SetTitle(" (updating CefSharp...)");
 
@@ -866,7 +1286,7 @@ namespace Synapse_UI_WPF
                             });
                         }
 
-                        ZipFile.ExtractToDirectory("bin\\CefSharp.zip", "bin");
+                        Unzipper.Extract("bin\\CefSharp.zip", "bin");
                         File.Delete("bin\\CefSharp.zip");
                     }
                 }
@@ -1016,8 +1436,8 @@ namespace Synapse_UI_WPF
             }
             else
             {
-                var ProcList = Process.GetProcessesByName("RobloxPlayerBeta");
-                if (ProcList.Length == 0)
+                var Found = FindRoblox();
+                if (Found == 0)
                 {
                     IsInlineUpdating = false;
 
@@ -1030,7 +1450,7 @@ namespace Synapse_UI_WPF
                     return;
                 }
 
-                if (ProcList[0].Id == RbxId)
+                if (IsAttached(Found))
                 {
                     IsInlineUpdating = false;
 
@@ -1043,7 +1463,7 @@ namespace Synapse_UI_WPF
                     return;
                 }
 
-                ProcId = ProcList[0].Id;
+                ProcId = Found;
             }
 
             RobloxIdTemp = ProcId;
@@ -1065,8 +1485,8 @@ namespace Synapse_UI_WPF
             }
             else
             {
-                var ProcList = Process.GetProcessesByName("RobloxPlayerBeta");
-                if (ProcList.Length == 0)
+                var Found = FindRoblox();
+                if (Found == 0)
                 {
                     Dispatcher.Invoke(() =>
                     {
@@ -1077,7 +1497,7 @@ namespace Synapse_UI_WPF
                     return;
                 }
 
-                if (ProcList[0].Id == RbxId)
+                if (IsAttached(Found))
                 {
                     Dispatcher.Invoke(() =>
                     {
@@ -1088,7 +1508,7 @@ namespace Synapse_UI_WPF
                     return;
                 }
 
-                ProcId = ProcList[0].Id;
+                ProcId = Found;
             }
 
             Dispatcher.Invoke(() =>
@@ -27,6 +27,7 @@ namespace Synapse_UI_WPF
         private readonly MainWindow Main;
         private bool BetaStatus;
         private bool LaunchStatus;
+        private bool NativeStatus;
 
         public OptionsWindow(MainWindow _Main)
         {
@@ -52,6 +53,7 @@ namespace Synapse_UI_WPF
 
             BetaStatus = Globals.Options.BetaRelease;
             LaunchStatus = Globals.Options.AutoLaunch;
+            NativeStatus = Globals.Options.NativeEditor;
 
             AutoLaunchBox.IsChecked = Globals.Options.AutoLaunch;
             AutoAttachBox.IsChecked = Globals.Options.AutoAttach;
@@ -59,6 +61,7 @@ namespace Synapse_UI_WPF
             InternalUIBox.IsChecked = Globals.Options.InternalUI;
             IngameChatBox.IsChecked = Globals.Options.IngameChat;
             BetaReleaseBox.IsChecked = Globals.Options.BetaRelease;
+            NativeEditorBox.IsChecked = Globals.Options.NativeEditor;
             ScaleSlider.Value = Globals.Options.WindowScale;
 
             ScaleSetup = true;
@@ -136,6 +139,7 @@ namespace Synapse_UI_WPF
                 InternalUI = InternalUIBox.IsChecked.Value,
                 IngameChat = IngameChatBox.IsChecked.Value,
                 BetaRelease = BetaReleaseBox.IsChecked.Value,
+                NativeEditor = NativeEditorBox.IsChecked.Value,
                 WindowScale = ScaleSlider.Value
             };
             DataInterface.Save("options", new Data.OptionsHolder
@@ -152,6 +156,12 @@ namespace Synapse_UI_WPF
                 Environment.Exit(0);
             }
 
+            if (NativeStatus != NativeEditorBox.IsChecked)
+            {
+                MessageBox.Show("The editor change will take effect the next time Synapse X starts.", "Synapse X",
+                    MessageBoxButton.OK, MessageBoxImage.Information);
+            }
+
             if (LaunchStatus != AutoLaunchBox.IsChecked)
             {
                 try
@@ -2,12 +2,10 @@
 using System.Collections.Generic;
 using System.ComponentModel;
 using System.Linq;
-using System.Net;
 using System.Threading;
 using System.Windows;
 using System.Windows.Controls;
 using System.Windows.Input;
-using System.Windows.Media.Imaging;
 using Synapse_UI_WPF.Interfaces;
 using Synapse_UI_WPF.Static;
 
@@ -24,14 +22,11 @@ namespace Synapse_UI_WPF
 
         private bool IsExecuting;
 
-        private BackgroundWorker ExecuteWorker = new BackgroundWorker();
-
         public ScriptHubWindow(MainWindow _Main, Data.ScriptHubHolder _Data)
         {
             Main = _Main;
             Data = _Data;
             WindowStartupLocation = WindowStartupLocation.CenterScreen;
-            ExecuteWorker.DoWork += ExecuteWorker_DoWork;
 
             InitializeComponent();
         }
@@ -64,9 +59,11 @@ namespace Synapse_UI_WPF
                 DictData[Script.Name] = Script;
                 ScriptBox.Items.Add(Script.Name);
             }
+
+            AssetCache.Prefetch(Data.Entries);
         }
 
-        private void ScriptBox_SelectionChanged(object sender, SelectionChangedEventArgs e)
+        private async void ScriptBox_SelectionChanged(object sender, SelectionChangedEventArgs e)
         {
             if (ScriptBox.SelectedIndex == -1)
             {
@@ -76,7 +73,18 @@ namespace Synapse_UI_WPF
             CurrentEntry = DictData[ScriptBox.Items[ScriptBox.SelectedIndex].ToString()];
             DescriptionBox.Text = CurrentEntry.Description;
 
-            ScriptPictureBox.Source = new BitmapImage(new Uri(CurrentEntry.Picture));
+            var Entry = CurrentEntry;
+            ScriptPictureBox.Source = null;
+
+            try
+            {
+                var Picture = await AssetCache.GetImage(Entry.Picture);
+                if (CurrentEntry == Entry) ScriptPictureBox.Source = Picture;
+            }
+            catch (Exception)
+            {
+                /* No picture, the description is still shown */
+            }
         }
 
         public bool IsOpen()
@@ -87,7 +95,7 @@ namespace Synapse_UI_WPF
             });
         }
 
-        private void ExecuteButton_Click(object sender, RoutedEventArgs e)
+        private async void ExecuteButton_Click(object sender, RoutedEventArgs e)
         {
             if (IsExecuting) return;
             if (CurrentEntry == null) return;
@@ -113,48 +121,34 @@ namespace Synapse_UI_WPF
             ExecuteButton.Content = Globals.Theme.ScriptHub.ExecuteButton.TextYield;
             IsExecuting = true;
 
-            ExecuteWorker.RunWorkerAsync();
-        }
-
-        private void ExecuteWorker_DoWork(object sender, DoWorkEventArgs e)
-        {
+            /* Usually already prefetched, otherwise this waits on (or starts) the download without holding the UI */
             string ScriptContent;
-
             try
             {
-                using (var WC = new WebClient())
-                {
-                    ScriptContent = WC.DownloadString(CurrentEntry.Url);
-                }
+                ScriptContent = await AssetCache.GetString(CurrentEntry.Url);
             }
             catch (Exception)
             {
                 if (!IsOpen()) return;
 
-                Dispatcher.Invoke(() =>
-                {
-                    IsExecuting = false;
-                    ExecuteButton.Content = Globals.Theme.ScriptHub.ExecuteButton.TextNormal;
+                IsExecuting = false;
+                ExecuteButton.Content = Globals.Theme.ScriptHub.ExecuteButton.TextNormal;
 
-                    Topmost = false;
-                    MessageBox.Show(
-                        "Synapse failed to download script from the script hub. Check your internet connection.",
-                        "Synapse X", MessageBoxButton.OK, MessageBoxImage.Error);
-                    Topmost = true;
-                });
+                Topmost = false;
+                MessageBox.Show(
+                    "Synapse failed to download script from the script hub. Check your internet connection.",
+                    "Synapse X", MessageBoxButton.OK, MessageBoxImage.Error);
+                Topmost = true;
 
                 return;
             }
 
-            Dispatcher.Invoke(() =>
-            {
-                if (!IsOpen()) return;
+            if (!IsOpen()) return;
 
-                IsExecuting = false;
-                ExecuteButton.Content = Globals.Theme.ScriptHub.ExecuteButton.TextNormal;
+            IsExecuting = false;
+            ExecuteButton.Content = Globals.Theme.ScriptHub.ExecuteButton.TextNormal;
 
-                Main.Execute(ScriptContent);
-            });
+            Main.Execute(ScriptContent);
         }
 
         private void CloseButton_Click(object sender, RoutedEventArgs e)
@@ -0,0 +1,170 @@
+﻿using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.IO;
+using System.Net;
+using System.Net.Http;
+using System.Security.Cryptography;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using System.Windows.Media.Imaging;
+
+namespace Synapse_UI_WPF.Static
+{
+    /* Web assets for the UI: script hub thumbnails and bodies, theme images. Every url is fetched at most once per
+       session (concurrent asks share the request) and kept on disk under the hash of its url with its ETag, so the next
+       run only costs a conditional request per asset and works from the disk copy when the network doesn't */
+    public static class AssetCache
+    {
+        public static string CacheFolder = "bin\\assets";
+
+        private const int Concurrency = 8;
+
+        private static readonly HttpClient Client = new HttpClient { Timeout = TimeSpan.FromSeconds(20) };
+        private static readonly SemaphoreSlim Slots = new SemaphoreSlim(Concurrency);
+
+        private static readonly ConcurrentDictionary<string, Lazy<Task<byte[]>>> Bodies = new ConcurrentDictionary<string, Lazy<Task<byte[]>>>();
+        private static readonly ConcurrentDictionary<string, Lazy<Task<BitmapImage>>> Images = new ConcurrentDictionary<string, Lazy<Task<BitmapImage>>>();
+
+        /* Starts every picture and script in the background, the hub window asks for them again as they're needed */
+        public static void Prefetch(IEnumerable<Data.ScriptHubEntry> Entries)
+        {
+            foreach (var Entry in Entries)
+            {
+                if (!string.IsNullOrEmpty(Entry.Picture)) GetImage(Entry.Picture).ContinueWith(T => T.Exception);
+                if (!string.IsNullOrEmpty(Entry.Url)) Get(Entry.Url).ContinueWith(T => T.Exception);
+            }
+        }
+
+        public static Task<byte[]> Get(string Url)
+        {
+            return Shared(Bodies, Url, Fetch);
+        }
+
+        public static async Task<string> GetString(string Url)
+        {
+            var Body = await Get(Url).ConfigureAwait(false);
+
+            /* WebClient.DownloadString dropped the BOM, scripts saved with one shouldn't reach Lua with it */
+            var Skip = Body.Length >= 3 && Body[0] == 0xEF && Body[1] == 0xBB && Body[2] == 0xBF ? 3 : 0;
+            return Encoding.UTF8.GetString(Body, Skip, Body.Length - Skip);
+        }
+
+        /* Decoded and frozen off the UI thread, so assigning it to an Image.Source costs nothing and every window can
+           share the one instance */
+        public static Task<BitmapImage> GetImage(string Url)
+        {
+            return Shared(Images, Url, async Key => Decode(await Get(Key).ConfigureAwait(false)));
+        }
+
+        /* Same for a local path or pack uri, nothing is kept in the cache folder */
+        public static Task<BitmapImage> GetLocalImage(string Path)
+        {
+            return Shared(Images, "local:" + Path, Key => Task.Run(() =>
+            {
+                var Image = new BitmapImage();
+                Image.BeginInit();
+                Image.CacheOption = BitmapCacheOption.OnLoad;
+                Image.UriSource = new Uri(Path);
+                Image.EndInit();
+                Image.Freeze();
+
+                return Image;
+            }));
+        }
+
+        private static BitmapImage Decode(byte[] Bytes)
+        {
+            var Image = new BitmapImage();
+            Image.BeginInit();
+            Image.CacheOption = BitmapCacheOption.OnLoad;
+            Image.StreamSource = new MemoryStream(Bytes);
+            Image.EndInit();
+            Image.Freeze();
+
+            return Image;
+        }
+
+        private static Task<T> Shared<T>(ConcurrentDictionary<string, Lazy<Task<T>>> Jobs, string Url, Func<string, Task<T>> Start)
+        {
+            var Job = Jobs.GetOrAdd(Url, Key => new Lazy<Task<T>>(() => Start(Key)));
+            if (!Job.Value.IsFaulted) return Job.Value;
+
+            /* Failures aren't kept, whoever asks next starts over */
+            ((ICollection<KeyValuePair<string, Lazy<Task<T>>>>) Jobs).Remove(new KeyValuePair<string, Lazy<Task<T>>>(Url, Job));
+            return Jobs.GetOrAdd(Url, Key => new Lazy<Task<T>>(() => Start(Key))).Value;
+        }
+
+        private static async Task<byte[]> Fetch(string Url)
+        {
+            var Path = PathOf(Url);
+            var TagPath = Path + ".etag";
+            var Cached = File.Exists(Path) && File.Exists(TagPath);
+
+            await Slots.WaitAsync().ConfigureAwait(false);
+            try
+            {
+                using (var Request = new HttpRequestMessage(HttpMethod.Get, Url))
+                {
+                    if (Cached) Request.Headers.TryAddWithoutValidation("If-None-Match", File.ReadAllText(TagPath));
+
+                    using (var Response = await Client.SendAsync(Request).ConfigureAwait(false))
+                    {
+                        if (Cached && Response.StatusCode == HttpStatusCode.NotModified)
+                            return File.ReadAllBytes(Path);
+
+                        Response.EnsureSuccessStatusCode();
+                        var Body = await Response.Content.ReadAsByteArrayAsync().ConfigureAwait(false);
+
+                        Store(Path, TagPath, Body, Response.Headers.ETag?.ToString());
+                        return Body;
+                    }
+                }
+            }
+            catch (Exception) when (File.Exists(Path))
+            {
+                /* Offline or the host is down, an older copy beats nothing */
+                return File.ReadAllBytes(Path);
+            }
+            finally
+            {
+                Slots.Release();
+            }
+        }
+
+        private static void Store(string Path, string TagPath, byte[] Body, string Tag)
+        {
+            try
+            {
+                if (!Directory.Exists(CacheFolder)) Directory.CreateDirectory(CacheFolder);
+
+                File.WriteAllBytes(Path + ".tmp", Body);
+                if (File.Exists(Path)) File.Delete(Path);
+                File.Move(Path + ".tmp", Path);
+
+                /* Without an ETag there is nothing to revalidate with, the body is only kept as the offline copy */
+                if (Tag != null) File.WriteAllText(TagPath, Tag);
+                else if (File.Exists(TagPath)) File.Delete(TagPath);
+            }
+            catch (Exception)
+            {
+                /* The cache is only an optimization */
+            }
+        }
+
+        private static string PathOf(string Url)
+        {
+            using (var Hasher = SHA256.Create())
+            {
+                var Hash = Hasher.ComputeHash(Encoding.UTF8.GetBytes(Url));
+
+                var Builder = new StringBuilder(Hash.Length * 2);
+                foreach (var b in Hash)
+                    Builder.Append(b.ToString("x2"));
+
+                return System.IO.Path.Combine(CacheFolder, Builder.ToString());
+            }
+        }
+    }
+}
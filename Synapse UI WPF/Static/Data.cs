@@ -27,6 +27,7 @@ namespace Synapse_UI_WPF.Static
             public bool InternalUI;
             public bool IngameChat;
             public bool BetaRelease;
+            public bool NativeEditor;
             public double WindowScale;
         }
 
@@ -0,0 +1,407 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Net;
+using System.Runtime.InteropServices;
+using System.Security.Cryptography;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Synapse_UI_WPF.Static
+{
+    public class Download
+    {
+        public string Url;
+        public string Path;
+        public string Hash;     /* SHA-512 of the body in upper case hex, null only checks the file exists */
+        public byte[] Salt;     /* appended once the body is verified, not covered by Hash */
+        public Action<Download> Then; /* runs on the job's worker once the file is in place, a throw fails the job */
+
+        public bool Succeeded;
+        public Exception Error; /* null on a failed download means the body never matched Hash */
+    }
+
+    /* Shared by the UI, the bootstrapper and sxlib (which link this file), keep it free of either's types */
+    public static class Downloader
+    {
+        private const int BufferSize = 128 * 1024;
+
+        /* Content addressed store of every verified body, named by its hash. Install paths are hard links into it,
+           so flipping between beta and release or repairing a deleted file never goes back to the network */
+        public static string CacheFolder = "bin\\cache";
+        public static TimeSpan CacheLifetime = TimeSpan.FromDays(30);
+
+        [DllImport("kernel32.dll", CharSet = CharSet.Unicode, SetLastError = true)]
+        private static extern bool CreateHardLink(string lpFileName, string lpExistingFileName, IntPtr lpSecurityAttributes);
+
+        /* FILETIMEs are two DWORDs natively, a long here would be 8 byte aligned and shift every field after it */
+        [StructLayout(LayoutKind.Sequential)]
+        private struct BY_HANDLE_FILE_INFORMATION
+        {
+            public uint FileAttributes;
+            public System.Runtime.InteropServices.ComTypes.FILETIME CreationTime;
+            public System.Runtime.InteropServices.ComTypes.FILETIME LastAccessTime;
+            public System.Runtime.InteropServices.ComTypes.FILETIME LastWriteTime;
+            public uint VolumeSerialNumber;
+            public uint FileSizeHigh;
+            public uint FileSizeLow;
+            public uint NumberOfLinks;
+            public uint FileIndexHigh;
+            public uint FileIndexLow;
+        }
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern bool GetFileInformationByHandle(Microsoft.Win32.SafeHandles.SafeFileHandle hFile, out BY_HANDLE_FILE_INFORMATION lpFileInformation);
+
+        /* Install path -> hash and the (file ID, size, mtime) it had when that hash last checked out. Kept next to the
+           cache so every linker of this file keeps its own, loaded on the first Run and saved after each one */
+        private static readonly object StampLock = new object();
+        private static Dictionary<string, string> Stamps;
+        private static bool StampsDirty;
+
+        /* Cleared if the native query ever disagrees with FileInfo, everything is hashed again from then on */
+        private static volatile bool StampsTrusted = true;
+
+        /* Runs every download that isn't already on disk at once. Bodies are hashed as they arrive and written to a
+           .part file first, so an interrupted transfer picks up where it stopped with a range request next time */
+        public static bool Run(int Concurrency, Action<Download> OnStart, params Download[] Downloads)
+        {
+            return Run(Concurrency, OnStart, CancellationToken.None, Downloads);
+        }
+
+        /* Cancelling stops new downloads from starting and throws once the running ones finish, their .part files stay */
+        public static bool Run(int Concurrency, Action<Download> OnStart, CancellationToken Token, params Download[] Downloads)
+        {
+            if (ServicePointManager.DefaultConnectionLimit < Concurrency)
+                ServicePointManager.DefaultConnectionLimit = Concurrency;
+
+            Parallel.ForEach(Downloads, new ParallelOptions { MaxDegreeOfParallelism = Concurrency, CancellationToken = Token }, Job =>
+            {
+                try
+                {
+                    if (File.Exists(Job.Path) && (Job.Hash == null || IsStamped(Job) || HashFile(Job.Path, Job.Salt?.Length ?? 0) == Job.Hash))
+                        Job.Succeeded = true;
+                    else if (Job.Hash != null && FromCache(Job))
+                        Job.Succeeded = true;
+                    else
+                    {
+                        OnStart?.Invoke(Job);
+
+                        /* A stale .part from an older version fails the hash once, the retry starts from scratch */
+                        Job.Succeeded = Fetch(Job, true) || Fetch(Job, false);
+                    }
+
+                    if (Job.Succeeded && Job.Hash != null) Stamp(Job);
+
+                    /* Archives are unpacked here so they overlap with whatever is still downloading */
+                    if (Job.Succeeded) Job.Then?.Invoke(Job);
+                }
+                catch (Exception Ex)
+                {
+                    Job.Error = Ex;
+                    Job.Succeeded = false;
+                }
+            });
+
+            SaveStamps();
+            PruneCache();
+            return Downloads.All(Job => Job.Succeeded);
+        }
+
+        /* Volume, file index, size and last write time in one call, null if the file can't be opened */
+        private static string Identity(string Path)
+        {
+            try
+            {
+                using (var Stream = new FileStream(Path, FileMode.Open, FileAccess.Read, FileShare.ReadWrite | FileShare.Delete))
+                {
+                    if (!GetFileInformationByHandle(Stream.SafeFileHandle, out var Info)) return null;
+
+                    var Size = ((long) Info.FileSizeHigh << 32) | Info.FileSizeLow;
+                    var Written = ((long) (uint) Info.LastWriteTime.dwHighDateTime << 32) | (uint) Info.LastWriteTime.dwLowDateTime;
+
+                    /* A stamp that doesn't describe the file would skip the hash on a changed one, so check the
+                       layout against what .NET reads before relying on it */
+                    var Managed = new FileInfo(Path);
+                    if (Size != Managed.Length || Written != Managed.LastWriteTimeUtc.ToFileTimeUtc())
+                    {
+                        StampsTrusted = false;
+                        return null;
+                    }
+
+                    return $"{Info.VolumeSerialNumber:X8}{Info.FileIndexHigh:X8}{Info.FileIndexLow:X8}:{Size}:{Written}";
+                }
+            }
+            catch (Exception)
+            {
+                return null;
+            }
+        }
+
+        private static string StampsPath => System.IO.Path.Combine(CacheFolder, "stamps");
+
+        /* True when the file is the same one, untouched, that matched Job.Hash before, so hashing it again can be skipped */
+        private static bool IsStamped(Download Job)
+        {
+            if (!StampsTrusted) return false;
+
+            var Key = System.IO.Path.GetFullPath(Job.Path).ToLowerInvariant();
+
+            string Stamped;
+            lock (StampLock)
+            {
+                LoadStamps();
+                if (!Stamps.TryGetValue(Key, out Stamped)) return false;
+            }
+
+            var Current = Identity(Job.Path);
+            return Current != null && StampsTrusted && Stamped == Job.Hash + "\t" + Current;
+        }
+
+        private static void Stamp(Download Job)
+        {
+            var Key = System.IO.Path.GetFullPath(Job.Path).ToLowerInvariant();
+            var Current = Identity(Job.Path);
+
+            lock (StampLock)
+            {
+                LoadStamps();
+
+                if (Current == null)
+                    StampsDirty |= Stamps.Remove(Key);
+                else if (!Stamps.TryGetValue(Key, out var Stamped) || Stamped != Job.Hash + "\t" + Current)
+                {
+                    Stamps[Key] = Job.Hash + "\t" + Current;
+                    StampsDirty = true;
+                }
+            }
+        }
+
+        private static void LoadStamps()
+        {
+            if (Stamps != null) return;
+            Stamps = new Dictionary<string, string>();
+
+            try
+            {
+                if (!File.Exists(StampsPath)) return;
+
+                foreach (var Line in File.ReadAllLines(StampsPath))
+                {
+                    var Split = Line.IndexOf('\t');
+                    if (Split > 0) Stamps[Line.Substring(0, Split)] = Line.Substring(Split + 1);
+                }
+            }
+            catch (Exception)
+            {
+                /* Unreadable stamps only cost a rehash */
+                Stamps.Clear();
+            }
+        }
+
+        private static void SaveStamps()
+        {
+            lock (StampLock)
+            {
+                if (!StampsDirty) return;
+
+                try
+                {
+                    if (!Directory.Exists(CacheFolder)) Directory.CreateDirectory(CacheFolder);
+
+                    File.WriteAllLines(StampsPath + ".tmp", Stamps.Select(Pair => Pair.Key + "\t" + Pair.Value));
+                    if (File.Exists(StampsPath)) File.Replace(StampsPath + ".tmp", StampsPath, null);
+                    else File.Move(StampsPath + ".tmp", StampsPath);
+
+                    StampsDirty = false;
+                }
+                catch (Exception)
+                {
+                    /* The stamps are only an optimization, like the cache */
+                }
+            }
+        }
+
+        /* Hex SHA-512 of the file minus its last Tail bytes, read in chunks */
+        public static string HashFile(string Path, int Tail = 0)
+        {
+            using (var Hasher = SHA512.Create())
+            using (var Stream = new FileStream(Path, FileMode.Open, FileAccess.Read, FileShare.Read, BufferSize))
+            {
+                var Buffer = new byte[BufferSize];
+                var Remaining = Math.Max(0, Stream.Length - Tail);
+
+                while (Remaining > 0)
+                {
+                    var Read = Stream.Read(Buffer, 0, (int) Math.Min(Buffer.Length, Remaining));
+                    if (Read <= 0) break;
+
+                    Hasher.TransformBlock(Buffer, 0, Read, null, 0);
+                    Remaining -= Read;
+                }
+
+                Hasher.TransformFinalBlock(Buffer, 0, 0);
+                return ToHex(Hasher.Hash);
+            }
+        }
+
+        private static bool Fetch(Download Job, bool Resume)
+        {
+            var PartPath = Job.Path + ".part";
+            var Folder = System.IO.Path.GetDirectoryName(System.IO.Path.GetFullPath(Job.Path));
+            if (!Directory.Exists(Folder)) Directory.CreateDirectory(Folder);
+
+            var Existing = Resume && File.Exists(PartPath) ? new FileInfo(PartPath).Length : 0;
+
+            var Request = (HttpWebRequest) WebRequest.Create(Job.Url);
+            Request.AutomaticDecompression = DecompressionMethods.None;
+            if (Existing > 0) Request.AddRange(Existing);
+
+            using (var Hasher = SHA512.Create())
+            {
+                HttpWebResponse Response;
+                try
+                {
+                    Response = (HttpWebResponse) Request.GetResponse();
+                }
+                catch (WebException Ex) when (Existing > 0 && (Ex.Response as HttpWebResponse)?.StatusCode == HttpStatusCode.RequestedRangeNotSatisfiable)
+                {
+                    /* The part is already complete (or longer than the file now is), let the hash decide */
+                    Ex.Response.Dispose();
+                    return Finish(Job, PartPath, HashFile(PartPath));
+                }
+
+                using (Response)
+                using (var Body = Response.GetResponseStream())
+                {
+                    var Append = Existing > 0 && Response.StatusCode == HttpStatusCode.PartialContent;
+
+                    using (var Part = new FileStream(PartPath, Append ? FileMode.Open : FileMode.Create, FileAccess.ReadWrite, FileShare.None, BufferSize))
+                    {
+                        var Buffer = new byte[BufferSize];
+                        int Read;
+
+                        if (Append)
+                        {
+                            /* Catch the hash up on what's already there, cheaper than fetching it again */
+                            while ((Read = Part.Read(Buffer, 0, Buffer.Length)) > 0)
+                                Hasher.TransformBlock(Buffer, 0, Read, null, 0);
+                        }
+
+                        while ((Read = Body.Read(Buffer, 0, Buffer.Length)) > 0)
+                        {
+                            Hasher.TransformBlock(Buffer, 0, Read, null, 0);
+                            Part.Write(Buffer, 0, Read);
+                        }
+
+                        Hasher.TransformFinalBlock(Buffer, 0, 0);
+                    }
+                }
+
+                return Finish(Job, PartPath, ToHex(Hasher.Hash));
+            }
+        }
+
+        private static bool Finish(Download Job, string PartPath, string Hash)
+        {
+            if (Job.Hash != null && Hash != Job.Hash)
+            {
+                File.Delete(PartPath);
+                return false;
+            }
+
+            if (Job.Hash != null)
+            {
+                try
+                {
+                    /* Salted files get changed after this, so they can't share the cached copy's storage */
+                    var CachePath = CacheEntry(Job.Hash);
+                    if (!File.Exists(CachePath) && (Job.Salt != null || !CreateHardLink(CachePath, PartPath, IntPtr.Zero)))
+                        File.Copy(PartPath, CachePath, true);
+                }
+                catch (Exception)
+                {
+                    /* The cache is only an optimization */
+                }
+            }
+
+            Install(Job, PartPath);
+            return true;
+        }
+
+        private static string CacheEntry(string Hash)
+        {
+            if (!Directory.Exists(CacheFolder)) Directory.CreateDirectory(CacheFolder);
+            return System.IO.Path.Combine(CacheFolder, Hash.ToLower());
+        }
+
+        private static bool FromCache(Download Job)
+        {
+            var CachePath = System.IO.Path.Combine(CacheFolder, Job.Hash.ToLower());
+            if (!File.Exists(CachePath)) return false;
+
+            /* Anything rewriting an install path in place also rewrites the entry, so check before trusting it */
+            if (HashFile(CachePath) != Job.Hash)
+            {
+                File.Delete(CachePath);
+                return false;
+            }
+
+            File.SetLastWriteTimeUtc(CachePath, DateTime.UtcNow);
+
+            var Folder = System.IO.Path.GetDirectoryName(System.IO.Path.GetFullPath(Job.Path));
+            if (!Directory.Exists(Folder)) Directory.CreateDirectory(Folder);
+
+            var PartPath = Job.Path + ".part";
+            if (File.Exists(PartPath)) File.Delete(PartPath);
+
+            if (Job.Salt != null || !CreateHardLink(PartPath, CachePath, IntPtr.Zero))
+                File.Copy(CachePath, PartPath, true);
+
+            Install(Job, PartPath);
+            return true;
+        }
+
+        private static void Install(Download Job, string PartPath)
+        {
+            if (Job.Salt != null)
+            {
+                using (var Part = new FileStream(PartPath, FileMode.Append))
+                    Part.Write(Job.Salt, 0, Job.Salt.Length);
+            }
+
+            if (File.Exists(Job.Path)) File.Delete(Job.Path);
+            File.Move(PartPath, Job.Path);
+        }
+
+        /* Drops entries no install has asked for within CacheLifetime */
+        private static void PruneCache()
+        {
+            try
+            {
+                if (!Directory.Exists(CacheFolder)) return;
+
+                foreach (var Entry in new DirectoryInfo(CacheFolder).GetFiles())
+                {
+                    if (Entry.Name == "stamps") continue;
+                    if (DateTime.UtcNow - Entry.LastWriteTimeUtc > CacheLifetime)
+                        Entry.Delete();
+                }
+            }
+            catch (Exception)
+            {
+                /* In use or already gone, try again next run */
+            }
+        }
+
+        private static string ToHex(byte[] Bytes)
+        {
+            var Builder = new StringBuilder(Bytes.Length * 2);
+            foreach (var b in Bytes)
+                Builder.Append(b.ToString("X2"));
+            return Builder.ToString();
+        }
+    }
+}
@@ -0,0 +1,74 @@
+﻿using System;
+using System.IO;
+using System.IO.Compression;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Synapse_UI_WPF.Static
+{
+    /* Parallel replacement for ZipFile.ExtractToDirectory, linked by sxlib like the Downloader. ZipArchive isn't thread
+       safe, so each worker opens the archive itself and takes the next entry off a shared counter */
+    public static class Unzipper
+    {
+        private const int BufferSize = 128 * 1024;
+
+        /* Entries already on disk with their size and timestamp are skipped, a repair only writes what's actually
+           missing or changed. Existing files are overwritten, unlike ExtractToDirectory */
+        public static void Extract(string Archive, string Folder, int Workers = 0)
+        {
+            var Root = Path.GetFullPath(Folder);
+            if (!Root.EndsWith("\\")) Root += "\\";
+
+            int Count;
+            using (var Zip = ZipFile.OpenRead(Archive))
+                Count = Zip.Entries.Count;
+
+            if (Workers <= 0) Workers = Math.Min(Environment.ProcessorCount, 8);
+            Workers = Math.Max(1, Math.Min(Workers, Count));
+
+            var Next = -1;
+
+            Parallel.For(0, Workers, new ParallelOptions { MaxDegreeOfParallelism = Workers }, Worker =>
+            {
+                var Buffer = new byte[BufferSize];
+
+                using (var Zip = ZipFile.OpenRead(Archive))
+                {
+                    int Index;
+                    while ((Index = Interlocked.Increment(ref Next)) < Count)
+                        ExtractEntry(Zip.Entries[Index], Root, Buffer);
+                }
+            });
+        }
+
+        private static void ExtractEntry(ZipArchiveEntry Entry, string Root, byte[] Buffer)
+        {
+            var Target = Path.GetFullPath(Path.Combine(Root, Entry.FullName));
+            if (!Target.StartsWith(Root, StringComparison.OrdinalIgnoreCase))
+                throw new IOException("Archive entry " + Entry.FullName + " is outside the extraction folder.");
+
+            /* Directory entries have no name */
+            if (Entry.Name.Length == 0)
+            {
+                Directory.CreateDirectory(Target);
+                return;
+            }
+
+            var Existing = new FileInfo(Target);
+            if (Existing.Exists && Existing.Length == Entry.Length && Existing.LastWriteTime == Entry.LastWriteTime.DateTime)
+                return;
+
+            Directory.CreateDirectory(Path.GetDirectoryName(Target));
+
+            using (var Input = Entry.Open())
+            using (var Output = new FileStream(Target, FileMode.Create, FileAccess.Write, FileShare.None, BufferSize))
+            {
+                int Read;
+                while ((Read = Input.Read(Buffer, 0, Buffer.Length)) > 0)
+                    Output.Write(Buffer, 0, Read);
+            }
+
+            File.SetLastWriteTime(Target, Entry.LastWriteTime.DateTime);
+        }
+    }
+}
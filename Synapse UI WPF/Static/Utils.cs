@@ -12,40 +12,58 @@ namespace Synapse_UI_WPF.Static
         [Obfuscation(Feature = "virtualization", Exclude = false)]
         public static string Sha512(string Input, bool IsFile = false)
         {
-            var bytes = IsFile ? File.ReadAllBytes(Input) : Encoding.ASCII.GetBytes(Input);
-            using (var hash = SHA512.Create())
-            {
-                var hashedInputBytes = hash.ComputeHash(bytes);
-                var hashedInputStringBuilder = new StringBuilder(128);
-                foreach (var b in hashedInputBytes)
-                    hashedInputStringBuilder.Append(b.ToString("X2"));
-                return hashedInputStringBuilder.ToString();
-            }
+            var hashedInputBytes = Sha512Bytes(Input, IsFile);
+            var hashedInputStringBuilder = new StringBuilder(128);
+            foreach (var b in hashedInputBytes)
+                hashedInputStringBuilder.Append(b.ToString("X2"));
+            return hashedInputStringBuilder.ToString();
         }
 
         [Obfuscation(Feature = "virtualization", Exclude = false)]
         public static string Sha512Dll(string Input)
         {
-            var bytes = File.ReadAllBytes(Input);
-            bytes = bytes.SubArray(0, bytes.Length - 64);
+            /* The last 64 bytes are the salt appended after download */
+            var hashedInputBytes = Sha512File(Input, 64);
+            var hashedInputStringBuilder = new StringBuilder(128);
+            foreach (var b in hashedInputBytes)
+                hashedInputStringBuilder.Append(b.ToString("X2"));
+            return hashedInputStringBuilder.ToString();
+        }
+
+        [Obfuscation(Feature = "virtualization", Exclude = false)]
+        public static byte[] Sha512Bytes(string Input, bool IsFile = false)
+        {
+            if (IsFile) return Sha512File(Input);
+
+            var bytes = Encoding.ASCII.GetBytes(Input);
             using (var hash = SHA512.Create())
             {
                 var hashedInputBytes = hash.ComputeHash(bytes);
-                var hashedInputStringBuilder = new StringBuilder(128);
-                foreach (var b in hashedInputBytes)
-                    hashedInputStringBuilder.Append(b.ToString("X2"));
-                return hashedInputStringBuilder.ToString();
+                return hashedInputBytes;
             }
         }
 
+        /* Hashes through a FileStream in 80KB chunks (under the LOH threshold) instead of reading the whole file */
         [Obfuscation(Feature = "virtualization", Exclude = false)]
-        public static byte[] Sha512Bytes(string Input, bool IsFile = false)
+        public static byte[] Sha512File(string Input, long Tail = 0)
         {
-            var bytes = IsFile ? File.ReadAllBytes(Input) : Encoding.ASCII.GetBytes(Input);
             using (var hash = SHA512.Create())
+            using (var stream = new FileStream(Input, FileMode.Open, FileAccess.Read, FileShare.Read, 4096, FileOptions.SequentialScan))
             {
-                var hashedInputBytes = hash.ComputeHash(bytes);
-                return hashedInputBytes;
+                var buffer = new byte[81920];
+                var remaining = Math.Max(0, stream.Length - Tail);
+
+                while (remaining > 0)
+                {
+                    var read = stream.Read(buffer, 0, (int) Math.Min(buffer.Length, remaining));
+                    if (read <= 0) break;
+
+                    hash.TransformBlock(buffer, 0, read, null, 0);
+                    remaining -= read;
+                }
+
+                hash.TransformFinalBlock(buffer, 0, 0);
+                return hash.Hash;
             }
         }
 
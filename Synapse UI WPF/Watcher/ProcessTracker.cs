@@ -0,0 +1,118 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Management;
+
+namespace Synapse_UI_WPF.Watcher
+{
+    /* Keeps the running processes with one image name current from start/stop events, so nothing has to enumerate
+       every process to find them. Win32_ProcessStartTrace/StopTrace are raised by the kernel as the process starts
+       but need admin, without it this falls back to ProcessWatcher's instance events which WMI polls once a second */
+    public class ProcessTracker : IDisposable
+    {
+        public event Action<int> ProcessStarted;
+        public event Action<int> ProcessStopped;
+
+        /* True when events come from the kernel trace rather than a polled query */
+        public bool Immediate { get; private set; }
+
+        private readonly string ImageName;
+        private readonly List<int> Running = new List<int>();
+        private ManagementEventWatcher StartWatcher;
+        private ManagementEventWatcher StopWatcher;
+        private ProcessWatcher Fallback;
+
+        public ProcessTracker(string imageName)
+        {
+            ImageName = imageName;
+        }
+
+        public void Start()
+        {
+            try
+            {
+                StartWatcher = new ManagementEventWatcher(new WqlEventQuery(
+                    $"SELECT ProcessID FROM Win32_ProcessStartTrace WHERE ProcessName = '{ImageName}'"));
+                StopWatcher = new ManagementEventWatcher(new WqlEventQuery(
+                    $"SELECT ProcessID FROM Win32_ProcessStopTrace WHERE ProcessName = '{ImageName}'"));
+
+                StartWatcher.EventArrived += (sender, e) => OnStarted(Convert.ToInt32(e.NewEvent["ProcessID"]));
+                StopWatcher.EventArrived += (sender, e) => OnStopped(Convert.ToInt32(e.NewEvent["ProcessID"]));
+
+                StartWatcher.Start();
+                StopWatcher.Start();
+                Immediate = true;
+            }
+            catch (ManagementException)
+            {
+                StartWatcher?.Dispose();
+                StopWatcher?.Dispose();
+                StartWatcher = StopWatcher = null;
+
+                /* Throws as well when WMI isn't usable at all, the caller handles that */
+                Fallback = new ProcessWatcher(ImageName);
+                Fallback.ProcessCreated += Proc => OnStarted(Convert.ToInt32(Proc.ProcessId));
+                Fallback.ProcessDeleted += Proc => OnStopped(Convert.ToInt32(Proc.ProcessId));
+                Fallback.Start();
+            }
+
+            /* Seeded after subscribing, a process starting in between is then seen twice rather than missed */
+            foreach (var Proc in System.Diagnostics.Process.GetProcessesByName(Path.GetFileNameWithoutExtension(ImageName)))
+            {
+                lock (Running)
+                {
+                    if (!Running.Contains(Proc.Id)) Running.Add(Proc.Id);
+                }
+            }
+        }
+
+        /* The longest running tracked process, 0 when there is none */
+        public int First()
+        {
+            lock (Running)
+            {
+                return Running.Count == 0 ? 0 : Running[0];
+            }
+        }
+
+        /* Every tracked process, longest running first */
+        public int[] All()
+        {
+            lock (Running)
+            {
+                return Running.ToArray();
+            }
+        }
+
+        private void OnStarted(int Id)
+        {
+            lock (Running)
+            {
+                if (Running.Contains(Id)) return;
+                Running.Add(Id);
+            }
+
+            ProcessStarted?.Invoke(Id);
+        }
+
+        private void OnStopped(int Id)
+        {
+            lock (Running)
+            {
+                Running.Remove(Id);
+            }
+
+            ProcessStopped?.Invoke(Id);
+        }
+
+        public void Dispose()
+        {
+            StartWatcher?.Stop();
+            StartWatcher?.Dispose();
+            StopWatcher?.Stop();
+            StopWatcher?.Dispose();
+            Fallback?.Stop();
+            Fallback?.Dispose();
+        }
+    }
+}
@@ -0,0 +1,178 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using System.Collections.Specialized;
+using System.ComponentModel;
+using System.IO;
+using System.Linq;
+using System.Threading;
+using System.Windows.Threading;
+
+namespace Synapse_UI_WPF.Watcher
+{
+    /* Sorted names of the files in one folder for a list to bind to. It is filled off the UI thread and then kept
+       current by a FileSystemWatcher, whose events are batched for a moment so a save burst only touches the list once.
+       Nothing here reads file contents, that's left to whoever opens the entry */
+    public class ScriptFolder : ObservableCollection<string>, IDisposable
+    {
+        private const int DebounceInterval = 250;
+        private const int ResetThreshold = 64;
+
+        public readonly string Folder;
+
+        private readonly Dispatcher Dispatcher;
+        private readonly FileSystemWatcher FsWatcher;
+        private readonly Timer Debounce;
+        private readonly object PendingLock = new object();
+        private readonly HashSet<string> Pending = new HashSet<string>(StringComparer.OrdinalIgnoreCase);
+        private bool PendingRescan;
+
+        public ScriptFolder(string folder, Dispatcher dispatcher)
+        {
+            Folder = folder;
+            Dispatcher = dispatcher;
+            Debounce = new Timer(_ => Flush(), null, Timeout.Infinite, Timeout.Infinite);
+
+            try
+            {
+                FsWatcher = new FileSystemWatcher(Folder)
+                {
+                    NotifyFilter = NotifyFilters.FileName,
+                    IncludeSubdirectories = false
+                };
+
+                FsWatcher.Created += (sender, e) => Queue(e.Name);
+                FsWatcher.Deleted += (sender, e) => Queue(e.Name);
+                FsWatcher.Renamed += (sender, e) =>
+                {
+                    Queue(e.OldName);
+                    Queue(e.Name);
+                };
+
+                /* The buffer overflowed and events were lost, only a full listing can tell what changed */
+                FsWatcher.Error += (sender, e) => Refresh();
+                FsWatcher.EnableRaisingEvents = true;
+            }
+            catch (Exception)
+            {
+                /* Refresh still works by hand */
+                FsWatcher = null;
+            }
+
+            Refresh();
+        }
+
+        public string PathOf(string Name) => Path.Combine(Folder, Name);
+
+        /* Relists the whole folder in the background and applies the difference */
+        public void Refresh()
+        {
+            lock (PendingLock) PendingRescan = true;
+            Debounce.Change(0, Timeout.Infinite);
+        }
+
+        private void Queue(string Name)
+        {
+            lock (PendingLock) Pending.Add(Name);
+            Debounce.Change(DebounceInterval, Timeout.Infinite);
+        }
+
+        private void Flush()
+        {
+            bool Rescan;
+            string[] Names;
+            lock (PendingLock)
+            {
+                Rescan = PendingRescan;
+                Names = Pending.ToArray();
+                PendingRescan = false;
+                Pending.Clear();
+            }
+
+            try
+            {
+                if (Rescan)
+                {
+                    var Listing = Directory.EnumerateFiles(Folder).Select(Path.GetFileName)
+                        .OrderBy(Name => Name, StringComparer.OrdinalIgnoreCase).ToList();
+                    Dispatcher.BeginInvoke(new Action(() => ApplyListing(Listing)));
+                    return;
+                }
+
+                if (Names.Length == 0) return;
+
+                var Changes = Names.Select(Name => Tuple.Create(Name, File.Exists(PathOf(Name)))).ToList();
+                Dispatcher.BeginInvoke(new Action(() => ApplyChanges(Changes)));
+            }
+            catch (Exception)
+            {
+                /* Folder went away or is locked, keep what's shown */
+            }
+        }
+
+        private void ApplyListing(List<string> Listing)
+        {
+            var Current = new HashSet<string>(this, StringComparer.OrdinalIgnoreCase);
+            var Wanted = new HashSet<string>(Listing, StringComparer.OrdinalIgnoreCase);
+
+            var Removed = this.Where(Name => !Wanted.Contains(Name)).ToList();
+            var Added = Listing.Where(Name => !Current.Contains(Name)).ToList();
+
+            if (Removed.Count + Added.Count > ResetThreshold)
+            {
+                /* One reset instead of thousands of single item notifications, the first fill always lands here */
+                Items.Clear();
+                foreach (var Name in Listing) Items.Add(Name);
+
+                OnPropertyChanged(new PropertyChangedEventArgs("Count"));
+                OnPropertyChanged(new PropertyChangedEventArgs("Item[]"));
+                OnCollectionChanged(new NotifyCollectionChangedEventArgs(NotifyCollectionChangedAction.Reset));
+                return;
+            }
+
+            foreach (var Name in Removed) Remove(Name);
+            foreach (var Name in Added) InsertSorted(Name);
+        }
+
+        private void ApplyChanges(List<Tuple<string, bool>> Changes)
+        {
+            foreach (var Change in Changes)
+            {
+                var Index = Find(Change.Item1);
+                if (Change.Item2 && Index < 0) InsertSorted(Change.Item1);
+                else if (!Change.Item2 && Index >= 0) RemoveAt(Index);
+            }
+        }
+
+        private int Find(string Name)
+        {
+            var Index = Search(Name);
+            return Index < Count && StringComparer.OrdinalIgnoreCase.Equals(this[Index], Name) ? Index : -1;
+        }
+
+        private void InsertSorted(string Name)
+        {
+            Insert(Search(Name), Name);
+        }
+
+        /* First index whose name doesn't sort before Name */
+        private int Search(string Name)
+        {
+            int Low = 0, High = Count;
+            while (Low < High)
+            {
+                var Mid = (Low + High) / 2;
+                if (StringComparer.OrdinalIgnoreCase.Compare(this[Mid], Name) < 0) Low = Mid + 1;
+                else High = Mid;
+            }
+
+            return Low;
+        }
+
+        public void Dispose()
+        {
+            FsWatcher?.Dispose();
+            Debounce.Dispose();
+        }
+    }
+}
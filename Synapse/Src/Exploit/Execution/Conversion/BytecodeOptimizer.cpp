@@ -0,0 +1,230 @@
+#include "./BytecodeOptimizer.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace syn
+{
+	namespace
+	{
+		/* HSVM encodes OP_JMP with the wide sAx, the loop ops keep sBx in every style */
+		int JumpOf(const Instruction I, const bool WideJmp)
+		{
+			return WideJmp && GET_OPCODE(I) == OP_JMP ? GETARG_sAx(I) : GETARG_sBx(I);
+		}
+
+		bool SetJump(Instruction& I, const int Offset, const bool WideJmp)
+		{
+			if (WideJmp && GET_OPCODE(I) == OP_JMP)
+			{
+				if (abs(Offset) > MAXARG_sAx)
+					return false;
+				SETARG_sAx(I, Offset);
+				return true;
+			}
+
+			if (abs(Offset) > MAXARG_sBx)
+				return false;
+			SETARG_sBx(I, Offset);
+			return true;
+		}
+
+		bool IsBranch(const OpCode Op)
+		{
+			return Op == OP_JMP || Op == OP_FORLOOP || Op == OP_FORPREP;
+		}
+
+		/* Ops that may jump over the next instruction, whatever follows them has to stay where it is */
+		bool SkipsNext(const Instruction I)
+		{
+			switch (GET_OPCODE(I))
+			{
+			case OP_EQ:
+			case OP_LT:
+			case OP_LE:
+			case OP_TEST:
+			case OP_TESTSET:
+			case OP_TFORLOOP:
+				return true;
+			case OP_LOADBOOL:
+				return GETARG_C(I) != 0;
+			default:
+				return false;
+			}
+		}
+	}
+
+	void OptimizeProto(lua_State* L, Proto* P, const int BytecodeStyle)
+	{
+		for (int i = 0; i < P->sizep; i++)
+			if (P->p[i])
+				OptimizeProto(L, P->p[i], BytecodeStyle);
+
+		const auto Size = P->sizecode;
+		const auto Code = P->code;
+		const auto WideJmp = BytecodeStyle == BS_HSVM;
+
+		/* Words after CLOSURE and a C == 0 SETLIST are operands, never decode or move them */
+		std::vector<bool> Data(Size);
+		for (int Pc = 0; Pc < Size; Pc++)
+		{
+			if (Data[Pc])
+				continue;
+
+			const auto I = Code[Pc];
+			if (GET_OPCODE(I) == OP_SETLIST && GETARG_C(I) == 0 && Pc + 1 < Size)
+				Data[Pc + 1] = true;
+			else if (GET_OPCODE(I) == OP_CLOSURE)
+			{
+				if (GETARG_Bx(I) >= P->sizep || !P->p[GETARG_Bx(I)])
+					return;
+
+				/* Synapse style packs two upvalues into one MUL/DIV word */
+				int Word = Pc + 1;
+				for (int Left = P->p[GETARG_Bx(I)]->nups; Left > 0 && Word < Size; Word++)
+				{
+					const auto Op = GET_OPCODE(Code[Word]);
+					Left -= BytecodeStyle == BS_SYNAPSE && (Op == OP_MUL || Op == OP_DIV) ? 2 : 1;
+					Data[Word] = true;
+				}
+			}
+		}
+
+		/* Jumps landing on another jump go straight to its destination, a plain jump to a return becomes the return */
+		for (int Pc = 0, Prev = -1; Pc < Size; Prev = Data[Pc] ? -1 : Pc, Pc++)
+		{
+			if (Data[Pc] || GET_OPCODE(Code[Pc]) != OP_JMP)
+				continue;
+
+			auto Dest = Pc + 1 + JumpOf(Code[Pc], WideJmp);
+			const auto Start = Dest;
+			for (int Hops = 0; Hops < 16 && Dest >= 0 && Dest < Size && Dest != Pc && !Data[Dest] && GET_OPCODE(Code[Dest]) == OP_JMP; Hops++)
+				Dest = Dest + 1 + JumpOf(Code[Dest], WideJmp);
+
+			if (Dest < 0 || Dest >= Size)
+				continue;
+
+			/* The translators expect a jump right after a test, and B == 0 returns up to a top only the previous op sets */
+			if ((Prev < 0 || !SkipsNext(Code[Prev])) && !Data[Dest] && GET_OPCODE(Code[Dest]) == OP_RETURN && GETARG_B(Code[Dest]) != 0)
+				Code[Pc] = Code[Dest];
+			else if (Dest != Start)
+				SetJump(Code[Pc], Dest - (Pc + 1), WideJmp);
+		}
+
+		std::vector<bool> Target(Size + 1);
+		for (int Pc = 0; Pc < Size; Pc++)
+		{
+			if (Data[Pc] || !IsBranch(GET_OPCODE(Code[Pc])))
+				continue;
+
+			const auto Dest = Pc + 1 + JumpOf(Code[Pc], WideJmp);
+			if (Dest < 0 || Dest > Size)
+				return;
+			Target[Dest] = true;
+		}
+
+		/* Drop no-ops, Prev is the last kept instruction so merges chain */
+		std::vector<bool> Dead(Size);
+		auto Removed = 0;
+		auto Prev = -1;
+		for (int Pc = 0; Pc < Size; Pc++)
+		{
+			if (Data[Pc])
+			{
+				Prev = -1;
+				continue;
+			}
+
+			const auto I = Code[Pc];
+			const auto Guarded = Prev >= 0 && SkipsNext(Code[Prev]);
+			const auto Joined = Prev >= 0 && !Target[Pc];
+
+			bool Drop = false;
+			if (!Guarded)
+			{
+				switch (GET_OPCODE(I))
+				{
+				case OP_MOVE:
+					Drop = GETARG_A(I) == GETARG_B(I) ||
+						(Joined && GET_OPCODE(Code[Prev]) == OP_MOVE && GETARG_A(Code[Prev]) == GETARG_B(I) && GETARG_B(Code[Prev]) == GETARG_A(I));
+					break;
+				case OP_LOADNIL:
+					if (Joined && GET_OPCODE(Code[Prev]) == OP_LOADNIL && GETARG_B(Code[Prev]) + 1 == GETARG_A(I) && GETARG_B(I) >= GETARG_A(I))
+					{
+						SETARG_B(Code[Prev], GETARG_B(I));
+						Drop = true;
+					}
+					break;
+				case OP_JMP:
+					Drop = JumpOf(I, WideJmp) == 0;
+					break;
+				default:
+					break;
+				}
+			}
+
+			if (!Drop)
+			{
+				Prev = Pc;
+				continue;
+			}
+
+			/* Whoever jumped here now lands on the next instruction */
+			if (Target[Pc])
+				Target[Pc + 1] = true;
+
+			Dead[Pc] = true;
+			Removed++;
+		}
+
+		if (!Removed)
+			return;
+
+		/* New pc of every old pc, dead ones map to the next kept instruction */
+		std::vector<int> Remap(Size + 1);
+		auto Kept = 0;
+		for (int Pc = 0; Pc < Size; Pc++)
+		{
+			Remap[Pc] = Kept;
+			if (!Dead[Pc])
+				Kept++;
+		}
+		Remap[Size] = Kept;
+
+		for (int Pc = 0; Pc < Size; Pc++)
+		{
+			if (Dead[Pc] || Data[Pc] || !IsBranch(GET_OPCODE(Code[Pc])))
+				continue;
+
+			const auto Dest = Pc + 1 + JumpOf(Code[Pc], WideJmp);
+			SetJump(Code[Pc], Remap[Dest] - (Remap[Pc] + 1), WideJmp);
+		}
+
+		const auto HasLines = P->sizelineinfo == Size;
+		for (int Pc = 0; Pc < Size; Pc++)
+		{
+			if (Dead[Pc])
+				continue;
+
+			Code[Remap[Pc]] = Code[Pc];
+			if (HasLines)
+				P->lineinfo[Remap[Pc]] = P->lineinfo[Pc];
+		}
+
+		for (int i = 0; i < P->sizelocvars; i++)
+		{
+			P->locvars[i].startpc = Remap[(std::min)(P->locvars[i].startpc, Size)];
+			P->locvars[i].endpc = Remap[(std::min)(P->locvars[i].endpc, Size)];
+		}
+
+		luaM_reallocvector(L, P->code, Size, Kept, Instruction);
+		P->sizecode = Kept;
+
+		if (HasLines)
+		{
+			luaM_reallocvector(L, P->lineinfo, Size, Kept, int);
+			P->sizelineinfo = Kept;
+		}
+	}
+}
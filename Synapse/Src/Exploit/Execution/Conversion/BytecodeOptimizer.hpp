@@ -0,0 +1,17 @@
+
+/*
+*
+*	SYNAPSE X
+*	File.:	BytecodeOptimizer.hpp
+*	Desc.:	Peephole pass over freshly compiled protos
+*
+*/
+
+#pragma once
+#include "../../Misc/Static.hpp"
+
+namespace syn
+{
+	/* Threads jump chains and drops no-op instructions in P and every child proto, lineinfo and locvars follow the new pcs */
+	void OptimizeProto(lua_State* L, Proto* P, int BytecodeStyle);
+}
@@ -9,9 +9,13 @@
 
 #pragma once
 
-#include "../../../Utilities/Buffer.hpp"
 #include "../../../Source Dependencies/xxtea/xxtea.h"
 
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <vector>
+
 const char ObfOpcodes[NUM_OPCODES]
 {
 	32, // OP_MOVE
@@ -59,37 +63,97 @@ namespace syn
 	class ObfuscatedDumper
 	{
 		LClosure Func;
-		Buffer Serial;
+		std::vector<uint8_t> Serial;
+		uint8_t* Out = nullptr;
 		uint32_t XorKey;
 		uint32_t XorKey2;
 
-		__forceinline void DumpByte(const uint8_t X)
+		/* Every field's xor and the whole-stream key folded into one mask per width, see Dump */
+		uint8_t StreamMask = 0;
+		uint8_t ByteMask = 0;
+		uint8_t StringMask[3]{};
+		uint32_t IntMask = 0;
+		uint64_t DoubleMask = 0;
+
+		static constexpr size_t HeaderSize = 4 + 7 + 8;
+
+		static size_t StringSize(const TString* X)
 		{
-			Serial.writeUInt8(X ^ XorKey % OBFUSCATED_NUM(128));
+			return 4 + ((X == nullptr || getstr(X) == nullptr) ? 0 : X->tsv.len + 1);
 		}
 
-		__forceinline void DumpInt(uint32_t X)
+		/* Exact byte size DumpFunction writes for f, so the stream goes into one buffer sized up front */
+		static size_t FunctionSize(const Proto* f, const TString* p)
 		{
-			const auto Arr = (uint8_t*) &X;
+			size_t Size = 1 + 4 + 4 + StringSize(f->source == p ? NULL : f->source) + 3;
 
-			for (uint8_t i = 0; i < 4; i++)
+			Size += 4 + 4 + 4 * (size_t) f->sizecode;
+
+			Size += 4;
+			for (int i = 0; i < f->sizek; i++)
 			{
-				Arr[i] ^= (uint8_t) (XorKey2 % (OBFUSCATED_NUM(32) * (i + 1)));
+				const TValue* o = &f->k[i];
+				Size += 1;
+
+				switch (ttype(o))
+				{
+					case LUA_TBOOLEAN:
+						Size += 1;
+						break;
+					case LUA_TNUMBER:
+						Size += 8;
+						break;
+					case LUA_TSTRING:
+						Size += StringSize(rawtsvalue(o));
+						break;
+					default:
+						break;
+				}
 			}
 
-			Serial.writeUInt32_LE(~(X ^ XorKey));
+			Size += 4;
+			for (int i = 0; i < f->sizep; i++) Size += FunctionSize(f->p[i], f->source);
+
+			Size += 4;
+			for (int i = 0; i < f->sizelocvars; i++) Size += StringSize(f->locvars[i].varname) + 8;
+
+			Size += 4 + 4 * (size_t) f->sizelineinfo;
+
+			Size += 4;
+			for (int i = 0; i < f->sizeupvalues; i++) Size += StringSize(f->upvalues[i]);
+
+			return Size;
 		}
 
-		__forceinline void DumpDouble(double X)
+		__forceinline void PutByte(const uint8_t X)
 		{
-			const auto Arr = (uint8_t*) &X;
+			*Out++ = X;
+		}
 
-			for (uint8_t i = 0; i < 8; i++)
-			{
-				Arr[i] ^= (uint8_t) (XorKey2 % (OBFUSCATED_NUM(32) * (i % 3 + 1)));
-			}
+		__forceinline void PutInt(const uint32_t X)
+		{
+			memcpy(Out, &X, sizeof(X));
+			Out += sizeof(X);
+		}
 
-			Serial.writeUInt64_LE(~(*(uint64_t*) &X ^ ((uint64_t) XorKey << OBFUSCATED_NUM(32) | XorKey2)));
+		__forceinline void DumpByte(const uint8_t X)
+		{
+			PutByte(X ^ ByteMask);
+		}
+
+		__forceinline void DumpInt(const uint32_t X)
+		{
+			PutInt(X ^ IntMask);
+		}
+
+		__forceinline void DumpDouble(const double X)
+		{
+			uint64_t Bits;
+			memcpy(&Bits, &X, sizeof(Bits));
+			Bits ^= DoubleMask;
+
+			memcpy(Out, &Bits, sizeof(Bits));
+			Out += sizeof(Bits);
 		}
 
 		__forceinline void DumpString(TString* X)
@@ -106,7 +170,7 @@ namespace syn
 
 				for (size_t i = 0; i < Size; i++)
 				{
-					Serial.writeUInt8(Dmp[i] ^ (uint8_t) (XorKey2 % (OBFUSCATED_NUM(32) * (i % 3 + 1))));
+					PutByte(Dmp[i] ^ StringMask[i % 3]);
 				}
 			}
 		}
@@ -245,42 +309,61 @@ namespace syn
 		{
             VM_TIGER_WHITE_START;
 
-			Serial.clear();
-
-			Serial.writeStr(OBFUSCATE_STR("\033SYN"));
-
-			auto x = 1;
-			Serial.writeUInt8(0);
-			Serial.writeUInt8((char) *(char*)&x);
-			Serial.writeUInt8((char) sizeof(int));
-			Serial.writeUInt8((char) sizeof(size_t));
-			Serial.writeUInt8((char) sizeof(Instruction));
-			Serial.writeUInt8((char) sizeof(lua_Number));
-			Serial.writeUInt8((char) ((lua_Number) 0.5 == 0));
-
 			XorKey = RandomInteger(0, INT_MAX);
 			XorKey2 = RandomInteger(0, INT_MAX);
-			Serial.writeUInt32_LE(XorKey ^ OBFUSCATED_NUM(0xb3d2335c));
-			Serial.writeUInt32_LE(XorKey2 ^ OBFUSCATED_NUM(0x2fae219a));
-			DumpFunction(Func.p, NULL);
 
-			auto Buffer = Serial.getBuffer();
 			auto SKey = RandomString(16);
 			const auto SKeyGrab = (SKey.at(0) * OBFUSCATED_NUM(16777216) + SKey.at(1) * OBFUSCATED_NUM(65536) + SKey.at(2) * OBFUSCATED_NUM(256) + SKey.at(3)) % 128;
 
-			for (size_t i = 0; i < Buffer.size(); i++)
+			/* The whole stream is xored with SKeyGrab, ints and doubles are xored per byte then with the keys and inverted */
+			StreamMask = (uint8_t) SKeyGrab;
+			ByteMask = (uint8_t) (XorKey % OBFUSCATED_NUM(128)) ^ StreamMask;
+
+			uint32_t IntBytes = 0;
+			uint64_t DoubleBytes = 0;
+			for (uint8_t i = 0; i < 8; i++)
 			{
-				Buffer[i] ^= SKeyGrab;
+				if (i < 3)
+					StringMask[i] = (uint8_t) (XorKey2 % (OBFUSCATED_NUM(32) * (i + 1))) ^ StreamMask;
+				if (i < 4)
+					IntBytes |= (uint32_t) (uint8_t) (XorKey2 % (OBFUSCATED_NUM(32) * (i + 1))) << (i * 8);
+
+				DoubleBytes |= (uint64_t) (uint8_t) (XorKey2 % (OBFUSCATED_NUM(32) * (i % 3 + 1))) << (i * 8);
 			}
 
-			auto FStr = std::string(Buffer.begin(), Buffer.end());
+			IntMask = ~(IntBytes ^ XorKey) ^ StreamMask * 0x01010101u;
+			DoubleMask = ~(DoubleBytes ^ ((uint64_t) XorKey << OBFUSCATED_NUM(32) | XorKey2)) ^ StreamMask * 0x0101010101010101ull;
+
+			/* One allocation sized for the stream and the cipher's padding, encrypted where it was written */
+			const auto Size = HeaderSize + FunctionSize(Func.p, NULL);
+			Serial.assign(xxtea_encrypt_size(Size), 0);
+			Out = Serial.data();
+
+			const std::string Magic = OBFUSCATE_STR("\033SYN");
+			for (const auto C : Magic)
+				PutByte(C ^ StreamMask);
+
+			auto x = 1;
+			PutByte(0 ^ StreamMask);
+			PutByte((char) *(char*)&x ^ StreamMask);
+			PutByte((char) sizeof(int) ^ StreamMask);
+			PutByte((char) sizeof(size_t) ^ StreamMask);
+			PutByte((char) sizeof(Instruction) ^ StreamMask);
+			PutByte((char) sizeof(lua_Number) ^ StreamMask);
+			PutByte((char) ((lua_Number) 0.5 == 0) ^ StreamMask);
+
+			PutInt(XorKey ^ OBFUSCATED_NUM(0xb3d2335c) ^ StreamMask * 0x01010101u);
+			PutInt(XorKey2 ^ OBFUSCATED_NUM(0x2fae219a) ^ StreamMask * 0x01010101u);
+			DumpFunction(Func.p, NULL);
+
+			lua_assert(Out == Serial.data() + Size);
+
 			auto FKey = OBFUSCATE_STR("F8ixT9H4z8moGusU") + SKey;
-			size_t FLen;
-			auto FRet = xxtea_encrypt(FStr.c_str(), FStr.length(), FKey.c_str(), &FLen);
+			const auto FLen = xxtea_encrypt_inplace(Serial.data(), Size, FKey.c_str());
 
             VM_TIGER_WHITE_END;
 
-			return std::make_tuple(Base64Encode((byte*) FRet, FLen), SKey);
+			return std::make_tuple(Base64Encode((byte*) Serial.data(), FLen), SKey);
 		}
 	};
 }
\ No newline at end of file
@@ -1,12 +1,23 @@
 #include "../../../Utilities/Obfuscation/ObfuscatedString.hpp"
 #include "../../../Utilities/Utils.hpp"
 #include "../../Misc/Profiler.hpp"
+#include "../../Misc/FrameStats.hpp"
+#include "../../Misc/Metrics.hpp"
+#include "../../Misc/Flags.hpp"
 #include "../../Security/AntiDump.hpp"
 #include "./RbxConversion.hpp"
 #include "../RbxApi.hpp"
 #include "../../Security/AntiDebug.hpp"
 #include "../../Misc/PointerObfuscation.hpp"
 #include "./RbxLuauConversion.hpp"
+#include "./BytecodeOptimizer.hpp"
+#include "../../../Utilities/ThreadPool.hpp"
+
+#define XXH_STATIC_LINKING_ONLY
+#define XXH_INLINE_ALL
+#include "../../../Utilities/Hashing/XXHash/xxhash.h"
+
+#include <algorithm>
 
 #pragma warning(disable : 4146)
 namespace syn
@@ -88,7 +99,19 @@ namespace syn
 		return syn::InstructionTranslator::InverseRot(Hash, 7, 11) * ModInverse(Const2 | 1);
 	}
 
-	void LuaTranslator::ConvertConstant(RbxLua RS, TValue* LVal, TValue* RVal) const
+	DWORD LuaTranslator::InternString(RbxLua RS, TString* Str)
+	{
+		/* Vanilla strings are interned by the compiler state, so the pointer identifies the content */
+		const auto Found = InternedStrings.find(Str);
+		if (Found != InternedStrings.end())
+			return Found->second;
+
+		const auto Ptr = CreateString(RS, Str);
+		InternedStrings.emplace(Str, Ptr);
+		return Ptr;
+	}
+
+	void LuaTranslator::ConvertConstant(RbxLua RS, TValue* LVal, TValue* RVal)
 	{
 		switch (ttype(LVal))
 		{
@@ -102,73 +125,49 @@ namespace syn
 				r_setnvalue(RVal, syn::RbxLua::XorDouble(nvalue(LVal)));
 				break;
 			case LUA_TSTRING:
-				r_setsvalue(RVal, CreateString(RS, rawtsvalue(LVal)));
+				r_setsvalue(RVal, InternString(RS, rawtsvalue(LVal)));
 				break;
             default: break;
 		}
 	}
 
-	DWORD LuaTranslator::ConvertProto(RbxLua RS, lua_State* L, Proto* LP, const std::string& Source)
+	void LuaTranslator::CollectProtos(Proto* LP, PreparedProto& Out, std::vector<PreparedProto*>& Flat)
 	{
-        VM_TIGER_WHITE_START;
-
-        std::unique_ptr<Structures::rProto> P = std::make_unique<Structures::rProto>(RS.NewProto());
-        P->source = Source.empty() ? (TString*)CreateString(RS, LP->source) : (TString*)CreateString(RS, Source);
-        P->flag = 0;
+		Out.LP = LP;
+		Flat.push_back(&Out);
 
-        P->numparams = LP->numparams;
-        P->maxstacksize = LP->maxstacksize;
-		P->nups = LP->nups;
-		P->is_vararg = LP->is_vararg;
-        
-		P->sizelocvars = LP->sizelocvars;
-		P->sizecode = LP->sizecode;
-        P->sizek = LP->sizek;
-        P->sizelineinfo = LP->sizelineinfo;
-        P->sizeupvalues = LP->sizeupvalues;
-        P->sizep = LP->sizep;
+		Out.Children.resize(LP->sizep);
+		for (auto i = 0; i < LP->sizep; ++i)
+			CollectProtos(LP->p[i], Out.Children[i], Flat);
+	}
 
-		auto HSS = (HSvmSettings*) operator new(sizeof(HSvmSettings));
-		HSS->VM = SECURELUA_VM_NONE;
-		HSS->MulInvKey = LP->mulinvkey;
+	void LuaTranslator::PrepareProto(PreparedProto& PP) const
+	{
+		const auto LP = PP.LP;
 
+		PP.VM = SECURELUA_VM_NONE;
 		if (LP->linedefined == 0x1FFF)
 		{
-			HSS->VM = SECURELUA_VM_MARKED;
+			PP.VM = SECURELUA_VM_MARKED;
 		}
 		if (LP->linedefined == 0x2FFF)
 		{
-			HSS->VM = SECURELUA_VM_MINIMAL;
+			PP.VM = SECURELUA_VM_MINIMAL;
 		}
 		if (LP->linedefined == 0x3FFF)
 		{
-			HSS->VM = SECURELUA_VM_LOW;
+			PP.VM = SECURELUA_VM_LOW;
 		}
 		else if (LP->linedefined == 0x4FFF)
 		{
-			HSS->VM = SECURELUA_VM_MEDIUM;
+			PP.VM = SECURELUA_VM_MEDIUM;
 		}
 		else if (LP->linedefined == 0x5FFF)
 		{
-			HSS->VM = SECURELUA_VM_HIGH;
+			PP.VM = SECURELUA_VM_HIGH;
 		}
 
-        P->linedefined = (uint32_t) HSS;
-		//This marks the proto as our own. I use this instead of is_vararg as using the other method causes performance problems (every function is treated as a vararg function, causing obvious issues)
-        P->lastlinedefined = LastDefineKey;
-
-        VM_TIGER_WHITE_END;
-
-		HSS->ShadowK = (TValue*) operator new(sizeof(TValue) * LP->sizek);
-		SecureZeroMemory((void*) HSS->ShadowK, sizeof(TValue) * LP->sizek);
-
-		/* Convert initial allocations */
-		P->p = (DWORD*) RS.Alloc(sizeof(int) * LP->sizep, 3);
-        P->k = (TValue*) RS.Alloc(sizeof(TValue) * LP->sizek, 3);
-		P->code = (Instruction*) RS.Alloc(sizeof(Instruction) * LP->sizecode, 3);
-        P->locvars = (RLocVar*) RS.Alloc(sizeof(RLocVar) * LP->sizelocvars, 3);
-        P->lineinfo = (int*) RS.Alloc(sizeof(int) * LP->sizelineinfo, 3);
-        P->upvalues = (TString**) RS.Alloc(sizeof(TString*) * LP->sizeupvalues, 3);
+		PP.Code.assign(LP->sizecode, 0);
 
 #ifndef EnableHSVM
 		if (IsLuaU)
@@ -179,19 +178,15 @@ namespace syn
 				Instruction LInstr = LP->code[pc];
 
 				/* Tailcalls are not generated */
-				if (HSS->VM < SECURELUA_VM_LOW && GET_OPCODE(LInstr) == OpCode::OP_TAILCALL)
+				if (PP.VM < SECURELUA_VM_LOW && GET_OPCODE(LInstr) == OpCode::OP_TAILCALL)
 					SET_OPCODE(LInstr, OpCode::OP_CALL);
-				P->code[pc] = LInstr;
+				PP.Code[pc] = LInstr;
 			}
 #endif
 #ifdef EnableLuaUTranslator
-			const auto Conv = syn::OneWayLuauTranslator(LP).Convert(LP->code, LP->sizecode);
-
-			P->sizecode = Conv.size();
-			P->code = (Instruction*) RS.Alloc(sizeof(Instruction) * Conv.size(), 3);
-
-			for (auto i = 0; i < Conv.size(); i++)
-				P->code[i] = (Instruction)Conv[i];
+			/* The cached translation is committed straight from the shared entry */
+			PP.Luau = syn::LuauTranslationCache::GetSingleton()->Convert(LP, DK);
+			PP.Code.clear();
 #endif
 		}
 		else
@@ -202,26 +197,199 @@ namespace syn
 				Instruction LInstr = LP->code[pc];
 
 				/* Tailcalls are not generated */
-				if (HSS->VM < SECURELUA_VM_LOW && GET_OPCODE(LInstr) == OpCode::OP_TAILCALL)
+				if (PP.VM < SECURELUA_VM_LOW && GET_OPCODE(LInstr) == OpCode::OP_TAILCALL)
 					SET_OPCODE(LInstr, OpCode::OP_CALL);
 
+				PP.Code[pc] = LInstr;
+			}
+
 #ifndef EnableHSVM
+			InstTranslator->ConvertEncryptBatch(PP.Code.data(), (DWORD*) PP.Code.data(), (uint32_t) PP.Code.size());
 
-				/* Extended setlist contains a psuedo-instruction */
-				if (HSS->VM < SECURELUA_VM_LOW && GET_OPCODE(LInstr) == OpCode::OP_SETLIST && GETARG_C(LInstr) == 0)
-					pc++;
-				else
-					P->code[pc] = InstTranslator->ConvertEncrypt(LInstr, pc);
-#else
-				P->code[pc] = LInstr;
-#endif
+			/* Extended setlist contains a psuedo-instruction, neither slot is emitted */
+			if (PP.VM < SECURELUA_VM_LOW)
+			{
+				for (int pc = 0; pc < LP->sizecode; ++pc)
+				{
+					const auto LInstr = LP->code[pc];
+					if (GET_OPCODE(LInstr) == OpCode::OP_SETLIST && GETARG_C(LInstr) == 0)
+					{
+						PP.Code[pc] = 0;
+						if (++pc < LP->sizecode)
+							PP.Code[pc] = 0;
+					}
+				}
 			}
+#endif
 #ifndef EnableHSVM
 		}
 #endif
 
+		/* Strings are created in the commit phase, everything else is final here */
+		PP.K.resize(LP->sizek);
+		for (int i = 0; i < LP->sizek; ++i)
+		{
+			TValue* LVal = &LP->k[i];
+			TValue* RVal = &PP.K[i];
+
+			switch (ttype(LVal))
+			{
+				case LUA_TBOOLEAN:
+					r_setbvalue(RVal, bvalue(LVal));
+					break;
+				case LUA_TNUMBER:
+					r_setnvalue(RVal, syn::RbxLua::XorDouble(nvalue(LVal)));
+					break;
+				default:
+					r_setnilvalue(RVal);
+					break;
+			}
+		}
+	}
+
+	void LuaTranslator::PrepareProtos(const std::vector<PreparedProto*>& Flat) const
+	{
+		PROFILE_ZONE(OBFUSCATE_STR("Convert prepare"));
+
+		struct PrepareState
+		{
+			std::atomic<size_t> Next{ 0 };
+			std::atomic<size_t> Done{ 0 };
+			std::mutex Mutex;
+			std::string Error;
+			std::condition_variable Finished;
+		};
+
+		const auto Count = Flat.size();
+		const auto Helpers = (std::min)((size_t) (std::max)(std::thread::hardware_concurrency(), 2u) - 1, Count / ParallelPrepareChunk);
+
+		/* Small trees (and a busy pool) are cheaper to prepare inline */
+		if (Helpers == 0 || syn::ThreadPool::GetSingleton()->Pending() != 0)
+		{
+			for (const auto PP : Flat)
+				PrepareProto(*PP);
+			return;
+		}
+
+		/* Helpers that start after the caller ran out of work only touch the shared counters */
+		const auto State = std::make_shared<PrepareState>();
+		const auto Work = [this, State, &Flat, Count]()
+		{
+			size_t Index;
+			while ((Index = State->Next.fetch_add(1)) < Count)
+			{
+				try
+				{
+					PrepareProto(*Flat[Index]);
+				}
+				catch (const std::exception& Ex)
+				{
+					std::lock_guard<std::mutex> Guard(State->Mutex);
+					State->Error = Ex.what();
+				}
+
+				if (State->Done.fetch_add(1) + 1 == Count)
+				{
+					std::lock_guard<std::mutex> Guard(State->Mutex);
+					State->Finished.notify_one();
+				}
+			}
+		};
+
+		for (size_t i = 0; i < Helpers; i++)
+			if (!syn::ThreadPool::GetSingleton()->TrySubmit(Work))
+				break;
+
+		Work();
+
+		std::unique_lock<std::mutex> Lock(State->Mutex);
+		State->Finished.wait(Lock, [&State, Count]() { return State->Done.load() == Count; });
+
+		if (!State->Error.empty())
+			throw std::exception(State->Error.c_str());
+	}
+
+	DWORD LuaTranslator::CommitProto(RbxLua RS, const PreparedProto& PP, const std::string& Source)
+	{
+        VM_TIGER_WHITE_START;
+
+		const auto LP = PP.LP;
+
+        std::unique_ptr<Structures::rProto> P = std::make_unique<Structures::rProto>(RS.NewProto());
+        P->source = Source.empty() ? (TString*)InternString(RS, LP->source) : (TString*)CreateString(RS, Source);
+        P->flag = 0;
+
+        P->numparams = LP->numparams;
+        P->maxstacksize = LP->maxstacksize;
+		P->nups = LP->nups;
+		P->is_vararg = LP->is_vararg;
+        
+		P->sizelocvars = LP->sizelocvars;
+		const auto CodeSize = CodeSizeOf(PP);
+		P->sizecode = (int) CodeSize;
+        P->sizek = LP->sizek;
+        P->sizelineinfo = LP->sizelineinfo;
+        P->sizeupvalues = LP->sizeupvalues;
+        P->sizep = LP->sizep;
+
+		auto HSS = (HSvmSettings*) operator new(sizeof(HSvmSettings));
+		HSS->VM = PP.VM;
+		HSS->MulInvKey = LP->mulinvkey;
+
+        P->linedefined = (uint32_t) HSS;
+		//This marks the proto as our own. I use this instead of is_vararg as using the other method causes performance problems (every function is treated as a vararg function, causing obvious issues)
+        P->lastlinedefined = LastDefineKey;
+
+        VM_TIGER_WHITE_END;
+
+		HSS->ShadowK = (TValue*) operator new(sizeof(TValue) * LP->sizek);
+		SecureZeroMemory((void*) HSS->ShadowK, sizeof(TValue) * LP->sizek);
+
+		/* One inline cache slot per instruction, indexed by pc */
+		HSS->Caches = (HSvmInlineCache*) operator new(sizeof(HSvmInlineCache) * CodeSize);
+		SecureZeroMemory((void*) HSS->Caches, sizeof(HSvmInlineCache) * CodeSize);
+
+		HSS->Quick = (HSvmQuickSite*) operator new(sizeof(HSvmQuickSite) * CodeSize);
+		SecureZeroMemory((void*) HSS->Quick, sizeof(HSvmQuickSite) * CodeSize);
+
+		/* HSVM hands out one closure per upvalue-free child, living in constants past sizek so the GC marks it through this proto */
+		HSS->ClosureK = -1;
+#ifdef EnableLuaUTranslator
+		if (!PP.Luau)
+#endif
+		if (synf::UseHSVMClosureCache && std::any_of(LP->p, LP->p + LP->sizep, [](const Proto* Child) { return Child->nups == 0; }))
+		{
+			HSS->ClosureK = LP->sizek;
+			P->sizek = LP->sizek + LP->sizep;
+		}
+
+		/* Convert initial allocations */
+		P->p = (DWORD*) RS.Alloc(sizeof(int) * LP->sizep, 3);
+        P->k = (TValue*) RS.Alloc(sizeof(TValue) * P->sizek, 3);
+		P->code = (Instruction*) RS.Alloc(sizeof(Instruction) * CodeSize, 3);
+        P->locvars = (RLocVar*) RS.Alloc(sizeof(RLocVar) * LP->sizelocvars, 3);
+        P->lineinfo = (int*) RS.Alloc(sizeof(int) * LP->sizelineinfo, 3);
+        P->upvalues = (TString**) RS.Alloc(sizeof(TString*) * LP->sizeupvalues, 3);
+
+#ifdef EnableLuaUTranslator
+		if (PP.Luau)
+			memcpy(P->code, PP.Luau->data(), sizeof(Instruction) * CodeSize);
+		else
+#endif
+		if (!PP.Code.empty())
+			memcpy(P->code, PP.Code.data(), sizeof(Instruction) * CodeSize);
+
+		if (!PP.K.empty())
+			memcpy(P->k, PP.K.data(), sizeof(TValue) * PP.K.size());
+
         for (int i = 0; i < LP->sizek; ++i)
-            ConvertConstant(RS, &LP->k[i], &P->k[i]);
+        {
+            if (ttisstring(&LP->k[i]))
+                ConvertConstant(RS, &LP->k[i], &P->k[i]);
+        }
+
+		for (int i = LP->sizek; i < P->sizek; ++i)
+			r_setnilvalue(&P->k[i]);
 
         for (int i = 0; i < LP->sizelocvars; ++i)
         {
@@ -230,48 +398,97 @@ namespace syn
 
             RLV->startpc = LV->startpc;
             RLV->endpc = LV->endpc;
-            RLV->varname = (TString*)CreateString(RS, LV->varname);
+            RLV->varname = (TString*)InternString(RS, LV->varname);
         }
 
         for (int i = 0; i < P->sizelineinfo; ++i)
             P->lineinfo[i] = LP->lineinfo[i];  //^ i << 8;
 
         for (int i = 0; i < LP->sizeupvalues; ++i)
-            P->upvalues[i] = (TString*)CreateString(RS, LP->upvalues[i]);
+            P->upvalues[i] = (TString*)InternString(RS, LP->upvalues[i]);
 
 		/* Generate proto hash */
 		P->hash = SolveProtoHash(P, DK);
 
-		/* Convert inner protos */
+		/* Commit inner protos */
 		for (auto i = 0; i < LP->sizep; ++i)
-			P->p[i] = ConvertProto(RS, L, LP->p[i], "");
+			P->p[i] = CommitProto(RS, PP.Children[i], "");
 
 		return P->Proto;
 	}
 
+	DWORD LuaTranslator::ConvertProto(RbxLua RS, lua_State* L, Proto* LP, const std::string& Source)
+	{
+		/* Instruction and constant translation never touches the game heap, so it runs in parallel before the serial commit */
+		PreparedProto Root;
+		std::vector<PreparedProto*> Flat;
+		CollectProtos(LP, Root, Flat);
+
+		PrepareProtos(Flat);
+
+		return CommitRoot(RS, Root, Source);
+	}
+
+	DWORD LuaTranslator::CommitRoot(RbxLua RS, const PreparedProto& Root, const std::string& Source)
+	{
+		PROFILE_ZONE(OBFUSCATE_STR("Convert commit"));
+
+		/* Each distinct string is created once per conversion, the cache never outlives it */
+		InternedStrings.clear();
+		const auto Result = CommitProto(RS, Root, Source);
+		InternedStrings.clear();
+
+		return Result;
+	}
+
 	TString* LuaTranslator::DumpString(RbxLua RS, lua_State* LS, TString* Str)
 	{
 		return luaS_newlstr(LS, RS.GetStr(Str), RS.RawSLen(Str));
 	}
 
-	void LuaTranslator::DumpCode(RbxLua RS, Proto* P, DWORD* RCode) const
+	TString* LuaTranslator::DumpString(RbxLua RS, lua_State* LS, TString* Str, DumpedStrings& Strings)
 	{
-		for (int i = 0; i < P->sizecode; i++)
-		{
-			const auto Inst = InstTranslator->ConvertDecrypt(RCode[i], i);
+		/* Game strings are interned too, so one pointer is one content for the whole dump */
+		const auto Found = Strings.find((DWORD) Str);
+		if (Found != Strings.end())
+			return Found->second;
+
+		const auto Dumped = DumpString(RS, LS, Str);
+		Strings.emplace((DWORD) Str, Dumped);
+		return Dumped;
+	}
 
-			P->code[i] = Inst;
+	void LuaTranslator::DumpConstants(RbxLua RS, lua_State* LS, TValue* LK, const TValue* RK, int SizeK, DumpedStrings& Strings)
+	{
+		for (int i = 0; i < SizeK; ++i)
+		{
+			const TValue* RVal = &RK[i];
+			TValue* LVal = &LK[i];
 
-			if (GET_OPCODE(Inst) == OpCode::OP_SETLIST && GETARG_C(Inst) == 0)
+			switch (ttype(RVal))
 			{
-				i++;
-
-				//This is a extended SETLIST instruction, we need to treat the next psuedo-instruction as data.
-				P->code[i] = RCode[i] * InstTranslator->DecodeKey;
+				case R_LUA_TBOOLEAN:
+					setbvalue(LVal, bvalue(RVal));
+					break;
+				case R_LUA_TNUMBER:
+					setnvalue(LVal, syn::RbxLua::XorDouble(nvalue(RVal)))
+					break;
+				case R_LUA_TSTRING:
+					setsvalue(LS, LVal, DumpString(RS, LS, rawtsvalue(RVal), Strings));
+					break;
+				default:
+					setnilvalue(LVal);
+					break;
 			}
 		}
 	}
 
+	void LuaTranslator::DumpCode(RbxLua RS, Proto* P, DWORD* RCode) const
+	{
+		//Extended SETLIST pseudo-instructions are treated as data by the batch decoder.
+		InstTranslator->ConvertDecryptBatch(RCode, P->code, P->sizecode);
+	}
+
 	void LuaTranslator::DumpConstant(RbxLua RS, lua_State* LS, TValue* LVal, TValue* RVal) const
 	{
 		switch (ttype(RVal))
@@ -295,12 +512,18 @@ namespace syn
 	}
 
 	Proto* LuaTranslator::DumpProto(RbxLua RS, lua_State* LS, DWORD P) const
+	{
+		DumpedStrings Strings;
+		return DumpProto(RS, LS, P, Strings);
+	}
+
+	Proto* LuaTranslator::DumpProto(RbxLua RS, lua_State* LS, DWORD P, DumpedStrings& Strings) const
 	{
 		Proto* LP = luaF_newproto(LS);
         std::unique_ptr<Structures::rProto> rP = std::make_unique<Structures::rProto>(P);
 
 		/* Convert source */
-		LP->source = DumpString(RS, LS, rP->source);
+		LP->source = DumpString(RS, LS, rP->source, Strings);
 
         VM_TIGER_WHITE_START;
 
@@ -311,7 +534,7 @@ namespace syn
 
 		LP->sizelocvars = rP->sizelocvars;
 		LP->sizecode = rP->sizecode;
-		LP->sizek = rP->sizek;
+		LP->sizek = SizeKOf(*rP);
 		LP->sizelineinfo = rP->sizelineinfo;
 		LP->sizeupvalues = rP->sizeupvalues;
 		LP->sizep = rP->sizep;
@@ -334,33 +557,20 @@ namespace syn
 		{
 			VM_TIGER_WHITE_START
 
-			auto Converted = syn::OneWayLuauDecompiler::Convert((LuauInstruction*) &rP->code[0], LP->sizecode);
-			memcpy((void*) &LP->code[0], &Converted[0], LP->sizecode * sizeof(LuauInstruction));
+			syn::OneWayLuauDecompiler::Convert((const LuauInstruction*) &rP->code[0], (LuauInstruction*) &LP->code[0], LP->sizecode);
 
 			VM_TIGER_WHITE_END
 		}
 		else
 		{
 #endif
-			for (int pc = 0; pc < LP->sizecode; ++pc)
-			{
-				const auto Inst = InstTranslator->ConvertDecrypt(rP->code[pc], pc);
-				LP->code[pc] = Inst;
-
-				/* Extended setlist contains a psuedo-instruction */
-				if (GET_OPCODE(Inst) == OpCode::OP_SETLIST && GETARG_C(Inst) == 0)
-				{
-					pc++;
-
-					LP->code[pc] = rP->code[pc] * InstTranslator->DecodeKey;
-				}
-			}
+			/* Extended setlist pseudo-instructions are copied through as data */
+			InstTranslator->ConvertDecryptBatch((const DWORD*) rP->code, LP->code, LP->sizecode);
 #ifdef EnableLuaUDecompiler
 		}
 #endif
 
-        for (int i = 0; i < LP->sizek; ++i)
-            DumpConstant(RS, LS, &LP->k[i], &rP->k[i]);
+        DumpConstants(RS, LS, LP->k, rP->k, LP->sizek, Strings);
 
         for (int i = 0; i < LP->sizelocvars; ++i)
         {
@@ -369,7 +579,7 @@ namespace syn
             
             LV->startpc = RLV->startpc;
             LV->endpc = RLV->endpc;
-            LV->varname = (TString*)DumpString(RS, LS, RLV->varname);
+            LV->varname = (TString*)DumpString(RS, LS, RLV->varname, Strings);
         }
 
         for (int i = 0; i < LP->sizelineinfo; i++)
@@ -379,56 +589,201 @@ namespace syn
 
         for (int i = 0; i < LP->sizeupvalues; i++)
         {
-            LP->upvalues[i] = DumpString(RS, LS, rP->upvalues[i]);
+            LP->upvalues[i] = DumpString(RS, LS, rP->upvalues[i], Strings);
         }
 
 		/* Convert inner protos */
 		for (int i = 0; i < LP->sizep; i++)
-			LP->p[i] = DumpProto(RS, LS, rP->p[i]);
+			LP->p[i] = DumpProto(RS, LS, rP->p[i], Strings);
 
 		return LP;
 	}
 
-	void LuaTranslator::ConvertInCurrentThread(RbxLua RL, const std::string& Script, std::uint8_t ScriptMode, std::string* ChunkName)
+	Proto* LuaTranslator::FindCachedProto(const std::uint64_t Key, const size_t Size, std::shared_ptr<lua_State>& State)
+	{
+		const auto Entry = ProtoCache.find(Key);
+		if (Entry == ProtoCache.end() || Entry->second.Size != Size)
+			return nullptr;
+
+		State = Entry->second.State;
+		return Entry->second.LP;
+	}
+
+	Proto* LuaTranslator::CompileProto(lua_State* L, const std::string& Script, const int BytecodeStyle, const std::string& ChunkName)
 	{
+		PROFILE_ZONE(OBFUSCATE_STR("Convert compile"));
+
+		const auto CompileStart = FrameStats::Now();
+		const auto Failed = luaL_loadbuffer(L, Script.c_str(), Script.size(), BytecodeStyle, ChunkName.c_str());
+
+		const auto Counters = Metrics::GetSingleton();
+		Counters->Compiles.fetch_add(1, std::memory_order_relaxed);
+		Counters->CompileMicros.fetch_add((std::uint64_t) (FrameStats::Now() - CompileStart), std::memory_order_relaxed);
+
+		if (Failed)
+		{
+			/* Error while compiling, report back to translation caller */
+			std::string Err = lua_tostring(L, -1);
+			lua_settop(L, 0);
+			throw std::exception(Err.c_str());
+		}
+
+		Proto* LP = ((Closure*) lua_topointer(L, -1))->l.p;
+
+		/* Precompiled chunks are run exactly as they were handed to us */
+		if (synf::UseBytecodeOptimizer && !IsPrecompiled(Script))
+			OptimizeProto(L, LP, BytecodeStyle);
+
+		return LP;
+	}
+
+	Proto* LuaTranslator::CompileCachedProto(const std::string& Script, const int BytecodeStyle, const std::string& ChunkName, const std::uint64_t Key,
+		std::shared_ptr<lua_State>& State, const bool Pinned)
+	{
+		/* The closure CompileProto leaves on the stack keeps the tree alive for as long as the state is shared */
+		auto Compiled = ShareState(AcquireState());
+		Proto* LP = CompileProto(Compiled.get(), Script, BytecodeStyle, ChunkName);
+
+		/* Released once the lock is gone, the last owner of a state runs its GC */
+		std::shared_ptr<lua_State> Dropped, Evicted;
+		{
+			std::lock_guard<std::mutex> Guard(ProtoCacheMutex);
+
+			const auto Existing = ProtoCache.find(Key);
+			if (Existing != ProtoCache.end() && Existing->second.Size == Script.size())
+			{
+				/* Someone else compiled it meanwhile, theirs is the one chunks already share */
+				Dropped = std::move(Compiled);
+				State = Existing->second.State;
+				return Existing->second.LP;
+			}
+
+			if (Existing != ProtoCache.end())
+			{
+				/* Size mismatch on the same key, replace the old chunk */
+				Evicted = std::move(Existing->second.State);
+				Existing->second = { Compiled, LP, Script.size() };
+			}
+			else
+			{
+				/* Evict the oldest chunk once we are full, its state goes back to the pool with its last chunk */
+				if (ProtoCacheOrder.size() >= ProtoCacheLimit)
+				{
+					const auto Oldest = ProtoCache.find(ProtoCacheOrder.front());
+					if (Oldest != ProtoCache.end())
+					{
+						Evicted = std::move(Oldest->second.State);
+						ProtoCache.erase(Oldest);
+					}
+					ProtoCacheOrder.pop_front();
+				}
+
+				ProtoCache[Key] = { Compiled, LP, Script.size() };
+				if (!Pinned)
+					ProtoCacheOrder.push_back(Key);
+			}
+		}
+
+		State = std::move(Compiled);
+		return LP;
+	}
+
+	int LuaTranslator::BytecodeStyleOf(const std::uint8_t ScriptMode)
+	{
+		if (ScriptMode && ScriptMode != SM_BYTECODE)
+			return BS_SECURELUA;
+#ifdef EnableHSVM
+		return BS_HSVM;
+#else
+		return IsLuaU ? BS_HSVM : BS_SYNAPSE;
+#endif
+	}
+
+	std::uint64_t LuaTranslator::CacheKeyOf(const std::string& Script, const std::uint8_t ScriptMode, const std::uint64_t Seed)
+	{
+		const std::uint64_t Optimized = synf::UseBytecodeOptimizer ? 1 : 0;
+		return XXH3_64bits_withSeed(Script.c_str(), Script.size(), Seed ^ (Optimized << 16 | BytecodeStyleOf(ScriptMode) << 8 | ScriptMode));
+	}
+
+	void LuaTranslator::Precompile(const std::string& Script, const std::uint8_t ScriptMode, const bool Pinned)
+	{
+		if (ScriptMode == SM_BYTECODE && !IsPrecompiled(Script))
+			return;
+
+		const auto Key = CacheKeyOf(Script, ScriptMode, 0);
+		std::shared_ptr<lua_State> State;
+
+		{
+			std::lock_guard<std::mutex> Guard(ProtoCacheMutex);
+			if (FindCachedProto(Key, Script.size(), State))
+				return;
+		}
+
+		try
+		{
+			CompileCachedProto(Script, BytecodeStyleOf(ScriptMode), "@" + RandomString(RandomInteger(10, 24)), Key, State, Pinned);
+		}
+		catch (const std::exception&) {}
+	}
+
+	std::shared_ptr<LuaTranslator::PreparedChunk> LuaTranslator::PrepareChunk(const std::string& Script, std::uint8_t ScriptMode, std::string* ChunkName)
+	{
+		const auto Chunk = std::make_shared<PreparedChunk>();
+		Chunk->KeyGeneration = KeyGeneration.load(std::memory_order_acquire);
+
         VM_TIGER_WHITE_START;
 		/* Create our randomly generated chunk name */
-		std::string Src = "@" + RandomString(RandomInteger(10, 24));
-		if (ChunkName == nullptr)
-			ChunkName = &Src;
-		ChunkNamesVec.push_back(Src.substr(1));
+		Chunk->Source = "@" + RandomString(RandomInteger(10, 24));
+
+		/* Inner protos keep the chunk name they were compiled with, so a custom one is part of the key */
+		XXH64_hash_t Key = 0;
+		if (ChunkName != nullptr)
+			Key = XXH3_64bits(ChunkName->c_str(), ChunkName->size());
+		else
+			ChunkName = &Chunk->Source;
 
 		syn::Profiler* prof = syn::Profiler::GetSingleton();
 		prof->AddProfile(OBFUSCATE_STR("New state"));
 
         VM_TIGER_WHITE_END;
 
-		lua_State* NState = luaL_newstate();
+		/* lua_load picks lundump from the signature, don't let a source chunk reach the parser through this mode */
+		if (ScriptMode == SM_BYTECODE && !IsPrecompiled(Script))
+			throw std::exception("precompiled payload is not a Lua chunk");
 
-#ifdef EnableHSVM
-		int BytecodeStyle = BS_HSVM;
-#else
-		int BytecodeStyle = IsLuaU ? BS_HSVM : BS_SYNAPSE;
-#endif
-		if (ScriptMode)
-			BytecodeStyle = BS_SECURELUA;
+		const int BytecodeStyle = BytecodeStyleOf(ScriptMode);
+		Key = CacheKeyOf(Script, ScriptMode, Key);
 
-		if (luaL_loadbuffer(NState, Script.c_str(), Script.size(), BytecodeStyle, ChunkName->c_str()))
+		/* Sharing the state is our own anchor on the tree, the cache may evict it before the commit comes around */
+		Proto* LP;
 		{
-			/* Error while compiling, report back to translation caller */
-			std::string Err = lua_tostring(NState, -1);
-			lua_close(NState);
-			throw std::exception(Err.c_str());
+			std::lock_guard<std::mutex> Guard(ProtoCacheMutex);
+			LP = FindCachedProto(Key, Script.size(), Chunk->State);
 		}
 
-		Closure* C = (Closure*) lua_topointer(NState, -1);
-		Proto* LP = C->l.p;
+		if (!LP)
+			LP = CompileCachedProto(Script, BytecodeStyle, *ChunkName, Key, Chunk->State);
+
+		prof->AddProfile(OBFUSCATE_STR("Prepare start"));
+
+		/* Nothing runs on a compiled state anymore, the tree is only read from here on */
+		std::vector<PreparedProto*> Flat;
+		CollectProtos(LP, Chunk->Root, Flat);
+		PrepareProtos(Flat);
+
+		return Chunk;
+	}
 
+	void LuaTranslator::CommitChunk(RbxLua RL, PreparedChunk& Chunk)
+	{
         VM_TIGER_WHITE_START;
+		ChunkNamesVec.push_back(Chunk.Source.substr(1));
+
+		syn::Profiler* prof = syn::Profiler::GetSingleton();
 		prof->AddProfile(OBFUSCATE_STR("Convert start"));
 
 		/* Convert */
-		DWORD RP = ConvertProto(RL, NState, LP, Src);
+		DWORD RP = CommitRoot(RL, Chunk.Root, Chunk.Source);
 
 		prof->AddProfile(OBFUSCATE_STR("Closure start"));
 
@@ -450,15 +805,21 @@ namespace syn
         r_setclvalue(*(TValue**)(RL + L_TOP), LC);
         r_incr_top(RL);
 
-		prof->AddProfile(OBFUSCATE_STR("Close"));
-
-		/* Close */
-		lua_close(NState);
-
 		prof->AddProfile(OBFUSCATE_STR("Conversion done!"));
 	}
 
+	void LuaTranslator::ConvertInCurrentThread(RbxLua RL, const std::string& Script, std::uint8_t ScriptMode, std::string* ChunkName)
+	{
+		CommitChunk(RL, *PrepareChunk(Script, ScriptMode, ChunkName));
+	}
+
 	RbxLua LuaTranslator::Convert(RbxLua RS, const std::string& Script, std::uint8_t ScriptMode, std::string* ChunkName)
+	{
+		/* Compile errors throw before a thread is made for them */
+		return Convert(RS, *PrepareChunk(Script, ScriptMode, ChunkName));
+	}
+
+	RbxLua LuaTranslator::Convert(RbxLua RS, PreparedChunk& Chunk)
 	{
         VM_TIGER_WHITE_START;
 
@@ -492,7 +853,7 @@ namespace syn
 		RL.SetGlobal(OBFUSCATE_STR("script"));
 		RL.SetTop(0);
 
-		ConvertInCurrentThread(RL, Script, ScriptMode, ChunkName);
+		CommitChunk(RL, Chunk);
         VM_TIGER_WHITE_END;
 
 		return RL;
@@ -501,10 +862,79 @@ namespace syn
 	int LuaTranslator::DumpWriter(lua_State* L, const void* b, size_t size, void* B)
 	{
 		UNUSED(L);
-		luaL_addlstring((luaL_Buffer*)B, (const char*)b, size);
+		((std::string*) B)->append((const char*) b, size);
 		return 0;
 	}
 
+	static size_t DumpStringSize(const TString* S)
+	{
+		return sizeof(size_t) + ((S == nullptr || getstr(S) == nullptr) ? 0 : S->tsv.len + 1);
+	}
+
+	size_t LuaTranslator::DumpSize(const Proto* F, const TString* Parent, bool Strip)
+	{
+		/* source, line range, nups/numparams/is_vararg/maxstacksize */
+		size_t Size = DumpStringSize((F->source == Parent || Strip) ? nullptr : F->source) + sizeof(int) * 2 + 4;
+
+		Size += sizeof(int) + sizeof(Instruction) * F->sizecode;
+
+		Size += sizeof(int);
+		for (int i = 0; i < F->sizek; ++i)
+		{
+			const TValue* O = &F->k[i];
+			Size += 1;
+
+			switch (ttype(O))
+			{
+				case LUA_TBOOLEAN:
+					Size += 1;
+					break;
+				case LUA_TNUMBER:
+					Size += sizeof(lua_Number);
+					break;
+				case LUA_TSTRING:
+					Size += DumpStringSize(rawtsvalue(O));
+					break;
+				default: break;
+			}
+		}
+
+		Size += sizeof(int);
+		for (int i = 0; i < F->sizep; ++i)
+			Size += DumpSize(F->p[i], F->source, Strip);
+
+		/* lineinfo, locvars and upvalue names are written as empty vectors when stripping */
+		Size += sizeof(int) * 3;
+		if (!Strip)
+		{
+			Size += sizeof(int) * F->sizelineinfo;
+
+			for (int i = 0; i < F->sizelocvars; ++i)
+				Size += DumpStringSize(F->locvars[i].varname) + sizeof(int) * 2;
+
+			for (int i = 0; i < F->sizeupvalues; ++i)
+				Size += DumpStringSize(F->upvalues[i]);
+		}
+
+		return Size;
+	}
+
+	std::string LuaTranslator::DumpChunk(lua_State* L, bool Strip)
+	{
+		const TValue* O = L->top - 1;
+		if (!isLfunction(O))
+			throw std::exception("failed to dump bytecode");
+
+		/* ldump writes field by field, with the buffer sized first every write is a plain copy */
+		std::string Res;
+		Res.reserve(LUAC_HEADERSIZE + DumpSize(clvalue(O)->l.p, nullptr, Strip));
+
+		if ((Strip ? lua_dump_strip(L, DumpWriter, &Res) : lua_dump(L, DumpWriter, &Res)) != 0)
+			throw std::exception("failed to dump bytecode");
+
+		return Res;
+	}
+
 	std::string LuaTranslator::Dump(RbxLua RS, bool Strip) const
 	{
         VM_TIGER_WHITE_START;
@@ -515,7 +945,7 @@ namespace syn
 		if (RS.Type(-1) != R_LUA_TPROTO)
 			P = syn::PointerObfuscation::DeObfuscateLClosure(P + 20);
 
-		lua_State* NState = luaL_newstate();
+		lua_State* NState = AcquireState();
 
 		/* Do conversion */
 		Proto* LP = DumpProto(RS, NState, P);
@@ -530,18 +960,19 @@ namespace syn
         VM_TIGER_WHITE_END;
 
 		/* Dump bytecode */
-		luaL_Buffer B;
-		luaL_buffinit(NState, &B);
-		if (Strip) { if (lua_dump_strip(NState, DumpWriter, &B) != 0) throw std::exception("failed to dump bytecode"); }
-		else { if (lua_dump(NState, DumpWriter, &B) != 0) throw std::exception("failed to dump bytecode"); }
-		luaL_pushresult(&B);
-		size_t Len;
-		const char* BC = lua_tolstring(NState, -1, &Len);
-
-		std::string Res(BC, Len);
+		std::string Res;
+		try
+		{
+			Res = DumpChunk(NState, Strip);
+		}
+		catch (...)
+		{
+			ReleaseState(NState);
+			throw;
+		}
 
-		/* Close */
-		lua_close(NState);
+		/* Return state to the pool */
+		ReleaseState(NState);
 
 		/* Done! */
 		return Res;
@@ -617,15 +1048,40 @@ namespace syn
 		}
 	}
 
+	void LuaTranslator::CloneConstants(RbxLua RL, TValue* Constants, int SizeK)
+	{
+		RL.CreateTable(SizeK, 0);
+
+		for (int i = 0; i < SizeK; i++)
+		{
+			/* Constant strings already live interned in this state, push them as they are */
+			if (Constants[i].tt == R_LUA_TSTRING)
+				RL.PushObject(&Constants[i]);
+			else
+				CloneConstant(RL, Constants, i);
+
+			RL.RawSetI(-2, i + 1); /* Lua-based indexing */
+		}
+	}
+
 	TValue* LuaTranslator::GetConstantsPointer(RbxLua RS, int index, int& sizek)
 	{
 		const auto RLC = RS.ToPointer(index);
 		Structures::rProto P(syn::PointerObfuscation::DeObfuscateLClosure(RLC + 20));
-		sizek = P.sizek;
+		sizek = SizeKOf(P);
 
 		return (TValue*) P.k;
 	}
 
+	int LuaTranslator::SizeKOf(Structures::rProto& P)
+	{
+		if (P.lastlinedefined != LastDefineKey)
+			return P.sizek;
+
+		const auto HSS = (HSvmSettings*) (std::uintptr_t) P.linedefined;
+		return HSS->ClosureK < 0 ? P.sizek : HSS->ClosureK;
+	}
+
 	TString** LuaTranslator::GetUpvaluesPointer(RbxLua RS, int index, int& sizeupvalues)
 	{
 		const auto RLC = RS.ToPointer(index);
@@ -671,11 +1127,47 @@ namespace syn
 		return Singleton;
 	}
 
+	lua_State* LuaTranslator::AcquireState()
+	{
+		std::lock_guard<std::mutex> Guard(StatePoolMutex);
+
+		if (StatePool.empty())
+			return luaL_newstate();
+
+		lua_State* L = StatePool.back();
+		StatePool.pop_back();
+		return L;
+	}
+
+	void LuaTranslator::ReleaseState(lua_State* L)
+	{
+		/* Drop everything left on the stack, the string table stays allocated for the next user */
+		lua_settop(L, 0);
+		if (lua_gc(L, LUA_GCCOUNT, 0) > StatePoolCollectKB)
+			lua_gc(L, LUA_GCCOLLECT, 0);
+
+		std::lock_guard<std::mutex> Guard(StatePoolMutex);
+
+		if (StatePool.size() >= StatePoolLimit)
+		{
+			lua_close(L);
+			return;
+		}
+
+		StatePool.push_back(L);
+	}
+
+	std::shared_ptr<lua_State> LuaTranslator::ShareState(lua_State* L)
+	{
+		return std::shared_ptr<lua_State>(L, ReleaseState);
+	}
+
 	void LuaTranslator::SetDecodeKey(const DWORD Decode)
 	{
 		DK = Decode;
 		EK = ModInverse(DK);
 
 		InstTranslator = new syn::InstructionTranslator(EK, DK);
+		KeyGeneration.fetch_add(1, std::memory_order_release);
 	}
 }
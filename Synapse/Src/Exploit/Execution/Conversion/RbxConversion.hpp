@@ -15,6 +15,14 @@
 
 #include "RbxOp.hpp"
 #include "../RbxLua.hpp"
+#include "RbxLuauConversion.hpp"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace syn
 {
@@ -30,11 +38,60 @@ namespace syn
 		SECURELUA_VM_HIGH
 	};
 
+	/* Last node a GETTABLE/SELF/GETGLOBAL site hit, valid while the table keeps the same node array */
+	struct HSvmInlineCache
+	{
+		uintptr_t Table;
+		uintptr_t Nodes;
+		uintptr_t Node;
+		uint8_t LSizeNode;
+		uint8_t Misses;
+	};
+
+	/* Specialised form a site was rewritten to after HSVM saw its operands, every form is guarded and falls back to the generic handler */
+	enum HSvmQuickKinds : uint8_t
+	{
+		HSVM_QUICK_NONE,
+		HSVM_QUICK_ARITH_NUM,		/* ADD/SUB/MUL/DIV of two numbers */
+		HSVM_QUICK_COMPARE_NUM,		/* EQ/LT/LE of two numbers */
+		HSVM_QUICK_CONSTKEY,		/* GETTABLE with a string constant key, straight to the inline cache */
+		HSVM_QUICK_GLOBAL			/* GETGLOBAL, straight to the inline cache */
+	};
+
+	struct HSvmQuickSite
+	{
+		HSvmQuickKinds Kind;
+		uint8_t Misses;
+	};
+
 	struct HSvmSettings
 	{
 		HSvmVMs VM;
 		uint32_t MulInvKey;
 		TValue* ShadowK;
+		HSvmInlineCache* Caches;
+		/* Shadow of the code array, one quickening state per instruction. The code itself is never rewritten, savedpc
+		   and line info keep pointing into it */
+		HSvmQuickSite* Quick;
+		/* First of sizep trailing constant slots caching each upvalue-free child's closure, -1 when there are none */
+		int ClosureK;
+	};
+
+	/* Task script modes, anything other than these is treated as SecureLua */
+	enum ScriptModes : std::uint8_t
+	{
+		SM_SOURCE,
+		SM_SECURELUA,
+		SM_BYTECODE
+	};
+
+	/* Compiled vanilla chunk, its closure stays on the stack of a pooled state of its own. Chunks prepared from it
+	   share the state, so an eviction never frees a tree that is still waiting for its commit */
+	struct ProtoCacheEntry
+	{
+		std::shared_ptr<lua_State> State;
+		Proto* LP;
+		size_t Size;
 	};
 
 	class LuaTranslator
@@ -42,11 +99,89 @@ namespace syn
 		InstructionTranslator* InstTranslator;
 		DWORD EK;
 
+		/* Content-addressed compile cache (xxh3 of source + compile settings) */
+		static constexpr size_t ProtoCacheLimit = 128;
+		std::unordered_map<std::uint64_t, ProtoCacheEntry> ProtoCache;
+		std::deque<std::uint64_t> ProtoCacheOrder;
+		std::mutex ProtoCacheMutex;
+
+		/* ProtoCacheMutex held, State receives the owner of the returned tree */
+		Proto* FindCachedProto(std::uint64_t Key, size_t Size, std::shared_ptr<lua_State>& State);
+
+		/* luaL_loadbuffer plus the bytecode optimizer, leaves the closure on top of L */
+		static Proto* CompileProto(lua_State* L, const std::string& Script, int BytecodeStyle, const std::string& ChunkName);
+
+		/* Compiles in a pooled state without any lock held, ProtoCacheMutex is only taken to insert the result. Pinned
+		   chunks never enter the eviction order and stay for the life of the process */
+		Proto* CompileCachedProto(const std::string& Script, int BytecodeStyle, const std::string& ChunkName, std::uint64_t Key,
+			std::shared_ptr<lua_State>& State, bool Pinned = false);
+
+		/* Bytecode style for a script mode and the cache key it compiles under, Seed is the chunk name hash or 0.
+		   The key covers UseBytecodeOptimizer too, toggling it never hands out protos built the other way */
+		static int BytecodeStyleOf(std::uint8_t ScriptMode);
+
+		static std::uint64_t CacheKeyOf(const std::string& Script, std::uint8_t ScriptMode, std::uint64_t Seed);
+
+		/* Warm vanilla states for dumping/compiling outside of the proto cache */
+		static constexpr size_t StatePoolLimit = 4;
+		static constexpr int StatePoolCollectKB = 8192;
+		static inline std::vector<lua_State*> StatePool;
+		static inline std::mutex StatePoolMutex;
+
+		/* Host-side result of translating one proto, committed into game memory on the job thread */
+		struct PreparedProto
+		{
+			Proto* LP = nullptr;
+			HSvmVMs VM = SECURELUA_VM_NONE;
+			std::vector<Instruction> Code;
+#ifdef EnableLuaUTranslator
+			LuauTranslationCache::Entry Luau;
+#endif
+			std::vector<TValue> K;
+			std::vector<PreparedProto> Children;
+		};
+
+		/* Protos per pool helper before preparing goes parallel */
+		static constexpr size_t ParallelPrepareChunk = 64;
+
+		static size_t CodeSizeOf(const PreparedProto& PP)
+		{
+#ifdef EnableLuaUTranslator
+			if (PP.Luau)
+				return PP.Luau->size();
+#endif
+			return PP.Code.size();
+		}
+
+		static void CollectProtos(Proto* LP, PreparedProto& Out, std::vector<PreparedProto*>& Flat);
+
+		void PrepareProto(PreparedProto& PP) const;
+
+		void PrepareProtos(const std::vector<PreparedProto*>& Flat) const;
+
+		DWORD CommitProto(RbxLua RS, const PreparedProto& PP, const std::string& Source);
+
+		DWORD CommitRoot(RbxLua RS, const PreparedProto& Root, const std::string& Source);
+
+		/* Vanilla TString -> game string, reused across every proto of one ConvertProto call */
+		std::unordered_map<TString*, DWORD> InternedStrings;
+
+		DWORD InternString(RbxLua RS, TString* Str);
+
+		/* Game TString -> vanilla string, local to one DumpProto call so concurrent dumps never share it */
+		typedef std::unordered_map<DWORD, TString*> DumpedStrings;
+
+		static TString* DumpString(RbxLua RS, lua_State* LS, TString* Str, DumpedStrings& Strings);
+
+		static void DumpConstants(RbxLua RS, lua_State* LS, TValue* LK, const TValue* RK, int SizeK, DumpedStrings& Strings);
+
+		Proto* DumpProto(RbxLua RS, lua_State* LS, DWORD P, DumpedStrings& Strings) const;
+
 	public:
 		DWORD DK;
 		static Structures::rProto* CreateProto(RbxLua RS, lua_State* L, DWORD SrcPtr);
 
-		void ConvertConstant(RbxLua RS, TValue* LVal, TValue* RVal) const;
+		void ConvertConstant(RbxLua RS, TValue* LVal, TValue* RVal);
 
 		DWORD __declspec(noinline) ConvertProto(RbxLua RS, lua_State* L, Proto* LP, const std::string& Source = "");
 
@@ -58,12 +193,54 @@ namespace syn
 
 		__declspec(noinline) Proto* DumpProto(RbxLua RS, lua_State* LS, DWORD P) const;
 
+		/* A compiled and translated chunk waiting for its commit. The vanilla closure stays alive on the stack of State,
+		   which the cache entry shares until it is evicted */
+		struct PreparedChunk
+		{
+			PreparedProto Root;
+			std::string Source;
+			std::shared_ptr<lua_State> State;
+
+			/* SetDecodeKey count the chunk was translated under, a newer key means it has to be prepared again */
+			std::uint32_t KeyGeneration = 0;
+		};
+
+		/* Compiles and translates Script from any thread, nothing here touches the game heap. The cache lock only covers
+		   the lookup and insert, compiling and preparing never make a concurrent caller or CommitChunk wait */
+		std::shared_ptr<PreparedChunk> PrepareChunk(const std::string& Script, std::uint8_t ScriptMode, std::string* ChunkName = nullptr);
+
+		/* Job thread only, commits a prepared chunk and pushes its closure onto RL. Takes no lock */
+		void CommitChunk(RbxLua RL, PreparedChunk& Chunk);
+
+		/* Bumped by every SetDecodeKey */
+		std::atomic<std::uint32_t> KeyGeneration{ 0 };
+
 		void ConvertInCurrentThread(RbxLua RL, const std::string& Script, std::uint8_t ScriptMode, std::string* ChunkName = nullptr);
 
 		RbxLua Convert(RbxLua RS, const std::string& Script, std::uint8_t ScriptMode, std::string* ChunkName = nullptr);
 
+		/* Job thread only, a new script thread running a chunk from PrepareChunk */
+		RbxLua Convert(RbxLua RS, PreparedChunk& Chunk);
+
+		/* Compiles Script into the proto cache from any thread, a later Convert without a chunk name only converts.
+		   Compile errors are left for that Convert to report. The cache lock is held for the lookup and the insert,
+		   never across the compile, so job-thread commits don't wait behind it */
+		void Precompile(const std::string& Script, std::uint8_t ScriptMode, bool Pinned = false);
+
+		/* True for a dumped vanilla chunk (luac, LuaTranslator::Dump), these load through lundump and skip the parser */
+		static bool IsPrecompiled(const std::string& Script)
+		{
+			return Script.size() >= sizeof(LUA_SIGNATURE) - 1 && Script.compare(0, sizeof(LUA_SIGNATURE) - 1, LUA_SIGNATURE) == 0;
+		}
+
 		static int __cdecl DumpWriter(lua_State* L, const void* b, size_t size, void* B);
 
+		/* Exact byte size luaU_dump will write for F, mirrors ldump.c */
+		static size_t DumpSize(const Proto* F, const TString* Parent, bool Strip);
+
+		/* Dumps the Lua function on top of L into one buffer sized up front */
+		static std::string DumpChunk(lua_State* L, bool Strip = false);
+
 		std::string Dump(RbxLua RS, bool Strip = false) const;
 
 		Proto* DumpToProto(lua_State* NState, RbxLua RS) const;
@@ -72,6 +249,12 @@ namespace syn
 
 		static void CloneConstant(RbxLua RL, TValue* Constants, int Index);
 
+		/* Pushes a table holding every constant, presized so the whole array goes in one pass */
+		static void CloneConstants(RbxLua RL, TValue* Constants, int SizeK);
+
+		/* sizek without the HSVM closure cache slots */
+		static int SizeKOf(Structures::rProto& P);
+
 		static TValue* GetConstantsPointer(RbxLua RS, int index, int& sizek);
 
 		static TString** GetUpvaluesPointer(RbxLua RS, int index, int& sizeupvalues);
@@ -83,5 +266,12 @@ namespace syn
 		static LuaTranslator* GetSingleton();
 
 		void SetDecodeKey(DWORD Decode);
+
+		static lua_State* AcquireState();
+
+		static void ReleaseState(lua_State* L);
+
+		/* A pooled state that goes back to the pool once its last owner lets go */
+		static std::shared_ptr<lua_State> ShareState(lua_State* L);
 	};
 }
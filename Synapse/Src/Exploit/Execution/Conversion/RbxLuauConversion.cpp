@@ -10,6 +10,10 @@
 #include "RbxLuauConversion.hpp"
 #include "../Scheduler.hpp"
 
+#define XXH_STATIC_LINKING_ONLY
+#define XXH_INLINE_ALL
+#include "../../../Utilities/Hashing/XXHash/xxhash.h"
+
 #if defined(EnableLuaUDecompiler) || defined(EnableLuaUTranslator)
 
 namespace syn
@@ -87,6 +91,28 @@ namespace syn
 		OP_LOADKX,		/* A Base[A] := K[Pc[1].Value]; Pc++ */
 		OP_JMPHX		/* sAx Pc += sAx [4] */
 	};
+
+#ifdef EnableLuaUTranslator
+	/* Register and constant forms of OpCode::OP_ADD ... OpCode::OP_POW, in that order */
+	static const LuauOp ArithForms[][2] =
+	{
+		{ LuauOp::OP_ADD, LuauOp::OP_ADDK },
+		{ LuauOp::OP_SUB, LuauOp::OP_SUBK },
+		{ LuauOp::OP_MUL, LuauOp::OP_MULK },
+		{ LuauOp::OP_DIV, LuauOp::OP_DIVK },
+		{ LuauOp::OP_MOD, LuauOp::OP_MODK },
+		{ LuauOp::OP_POW, LuauOp::OP_POWK }
+	};
+
+	/* Whole numbers OP_LOADINT can carry in its Bx */
+	static bool IsSmallInt(const TValue* Const)
+	{
+		return Const->tt == LUA_TNUMBER
+			&& nvalue(Const) > 0
+			&& nvalue(Const) < 65535
+			&& nvalue(Const) == (lua_Number) static_cast<uint16_t>(nvalue(Const));
+	}
+#endif
 }
 
 #endif
@@ -154,11 +180,8 @@ std::vector<syn::LuauInstruction> syn::OneWayLuauTranslator::Convert(Instruction
             for (; !(GET_OPCODE(CallTarget) == OpCode::OP_CALL && GETARG_A(CallTarget) == GETARG_A(Instr));)
                 CallTarget = VanillaInstrs[CallI++];
 
-            //Insert our OP_SELF before the call instruction.
-            VanillaInstrs.insert(VanillaInstrs.begin() + (CallI - 1), Instr);
-
-            //Remove the old OP_SELF.
-            VanillaInstrs.erase(VanillaInstrs.begin() + i);
+            //Slide our OP_SELF down to just before the call instruction, only the span in between moves.
+            std::rotate(VanillaInstrs.begin() + i, VanillaInstrs.begin() + i + 1, VanillaInstrs.begin() + (CallI - 1));
 
             //Mark the new OP_SELF to be skipped.
             SkipPc[CallI - 2] = true;
@@ -168,8 +191,43 @@ std::vector<syn::LuauInstruction> syn::OneWayLuauTranslator::Convert(Instruction
     //De-allocate the SkipPc table.
     free(SkipPc);
 
-    //Stage 2 - Translation.
+    //Stage 2 - Translation. Bound the output first so the fill below never reallocates, LOADNIL is the only op that expands past 4.
+    size_t Capacity = 1;
+    size_t Jumps = 0;
+    for (const auto Instr : VanillaInstrs)
+    {
+        const auto Opc = GET_OPCODE(Instr);
+
+        Capacity += Opc == OpCode::OP_LOADNIL ? (size_t) (std::max)(GETARG_B(Instr) - GETARG_A(Instr) + 1, 0) : 4;
+        if (Opc == OpCode::OP_JMP || Opc == OpCode::OP_FORLOOP || Opc == OpCode::OP_FORPREP)
+            Jumps++;
+    }
+
     auto LuaUInstrs = std::vector<LuauInstruction>();
+    LuaUInstrs.reserve(Capacity);
+    PcRelocationNeeded.reserve(Jumps);
+
+    //Constant operands Luau can't take directly go through a scratch register, small integers skip the constant table.
+    const auto LoadScratch = [this, &LuaUInstrs](const uint8_t Reg, const int Index)
+    {
+        const auto Const = &CurrentProto->k[Index];
+
+        LuauInstruction Temp(0);
+        Temp.A = Reg;
+
+        if (IsSmallInt(Const))
+        {
+            Temp.SetOpCode(LuauOp::OP_LOADINT);
+            Temp.Bx = static_cast<uint16_t>(nvalue(Const));
+        }
+        else
+        {
+            Temp.SetOpCode(LuauOp::OP_LOADK);
+            Temp.Bx = Index;
+        }
+
+        LuaUInstrs.push_back(Temp);
+    };
 
     LuauInstruction InitInstr(0);
 
@@ -207,10 +265,7 @@ std::vector<syn::LuauInstruction> syn::OneWayLuauTranslator::Convert(Instruction
         {
 			const auto Const = &CurrentProto->k[GETARG_Bx(Instr)];
 
-			if (Const->tt == LUA_TNUMBER
-				&& nvalue(Const) < 65535
-				&& nvalue(Const) > 0
-				&& GET_OPCODE(VanillaInstrs[i + 1]) != OpCode::OP_SELF)
+			if (IsSmallInt(Const) && GET_OPCODE(VanillaInstrs[i + 1]) != OpCode::OP_SELF)
 			{
 				LuaUInstr.SetOpCode(LuauOp::OP_LOADINT);
 				LuaUInstr.A = GETARG_A(Instr);
@@ -327,12 +382,7 @@ std::vector<syn::LuauInstruction> syn::OneWayLuauTranslator::Convert(Instruction
             auto RealSet = GETARG_C(Instr);
             if (ISK(RealSet))
             {
-                LuaUInstr.SetOpCode(LuauOp::OP_LOADK);
-                LuaUInstr.A = 254;
-                LuaUInstr.Bx = RealSet - 256;
-
-                LuaUInstrs.push_back(LuaUInstr);
-
+                LoadScratch(254, RealSet - 256);
                 RealSet = 254;
             }
 
@@ -405,198 +455,29 @@ std::vector<syn::LuauInstruction> syn::OneWayLuauTranslator::Convert(Instruction
             }
         }
 
-        else if (Opc == OpCode::OP_ADD)
+        else if (Opc >= OpCode::OP_ADD && Opc <= OpCode::OP_POW)
         {
-			auto CmpB = GETARG_B(Instr);
+			//Luau only takes a constant on the right, a constant left operand goes through the scratch register.
+			const auto& Forms = ArithForms[Opc - OpCode::OP_ADD];
+			auto RegB = GETARG_B(Instr);
 
-			if (ISK(GETARG_B(Instr)))
+			if (ISK(RegB))
 			{
-				LuaUInstr.SetOpCode(LuauOp::OP_LOADK);
-				LuaUInstr.A = 254;
-				LuaUInstr.Bx = GETARG_B(Instr) - 256;
-
-				LuaUInstrs.push_back(LuaUInstr);
-
-				CmpB = 254;
-			}
-
-			LuaUInstr.A = GETARG_A(Instr);
-
-        	if (ISK(GETARG_C(Instr)))
-            {
-                LuaUInstr.SetOpCode(LuauOp::OP_ADDK);
-                LuaUInstr.B = CmpB;
-                LuaUInstr.C = GETARG_C(Instr) - 256;
-            }
-			else
-			{
-				LuaUInstr.SetOpCode(LuauOp::OP_ADD);
-				LuaUInstr.B = CmpB;
-				LuaUInstr.C = GETARG_C(Instr);
-			}
-
-            LuaUInstrs.push_back(LuaUInstr);
-        }
-
-        else if (Opc == OpCode::OP_SUB)
-        {
-			auto CmpB = GETARG_B(Instr);
-
-			if (ISK(GETARG_B(Instr)))
-			{
-				LuaUInstr.SetOpCode(LuauOp::OP_LOADK);
-				LuaUInstr.A = 254;
-				LuaUInstr.Bx = GETARG_B(Instr) - 256;
-
-				LuaUInstrs.push_back(LuaUInstr);
-
-				CmpB = 254;
-			}
-
-			LuaUInstr.A = GETARG_A(Instr);
-
-			if (ISK(GETARG_C(Instr)))
-			{
-				LuaUInstr.SetOpCode(LuauOp::OP_SUBK);
-				LuaUInstr.B = CmpB;
-				LuaUInstr.C = GETARG_C(Instr) - 256;
-			}
-			else
-			{
-				LuaUInstr.SetOpCode(LuauOp::OP_SUB);
-				LuaUInstr.B = CmpB;
-				LuaUInstr.C = GETARG_C(Instr);
-			}
-
-			LuaUInstrs.push_back(LuaUInstr);
-        }
-
-        else if (Opc == OpCode::OP_MUL)
-        {
-			auto CmpB = GETARG_B(Instr);
-
-			if (ISK(GETARG_B(Instr)))
-			{
-				LuaUInstr.SetOpCode(LuauOp::OP_LOADK);
-				LuaUInstr.A = 254;
-				LuaUInstr.Bx = GETARG_B(Instr) - 256;
-
-				LuaUInstrs.push_back(LuaUInstr);
-
-				CmpB = 254;
+				LoadScratch(254, RegB - 256);
+				RegB = 254;
 			}
 
 			LuaUInstr.A = GETARG_A(Instr);
+			LuaUInstr.B = RegB;
 
 			if (ISK(GETARG_C(Instr)))
 			{
-				LuaUInstr.SetOpCode(LuauOp::OP_MULK);
-				LuaUInstr.B = CmpB;
+				LuaUInstr.SetOpCode(Forms[1]);
 				LuaUInstr.C = GETARG_C(Instr) - 256;
 			}
 			else
 			{
-				LuaUInstr.SetOpCode(LuauOp::OP_MUL);
-				LuaUInstr.B = CmpB;
-				LuaUInstr.C = GETARG_C(Instr);
-			}
-
-			LuaUInstrs.push_back(LuaUInstr);
-        }
-
-        else if (Opc == OpCode::OP_DIV)
-        {
-			auto CmpB = GETARG_B(Instr);
-
-			if (ISK(GETARG_B(Instr)))
-			{
-				LuaUInstr.SetOpCode(LuauOp::OP_LOADK);
-				LuaUInstr.A = 254;
-				LuaUInstr.Bx = GETARG_B(Instr) - 256;
-
-				LuaUInstrs.push_back(LuaUInstr);
-
-				CmpB = 254;
-			}
-
-			LuaUInstr.A = GETARG_A(Instr);
-
-			if (ISK(GETARG_C(Instr)))
-			{
-				LuaUInstr.SetOpCode(LuauOp::OP_DIVK);
-				LuaUInstr.B = CmpB;
-				LuaUInstr.C = GETARG_C(Instr) - 256;
-			}
-			else
-			{
-				LuaUInstr.SetOpCode(LuauOp::OP_DIV);
-				LuaUInstr.B = CmpB;
-				LuaUInstr.C = GETARG_C(Instr);
-			}
-
-			LuaUInstrs.push_back(LuaUInstr);
-        }
-
-        else if (Opc == OpCode::OP_MOD)
-        {
-			auto CmpB = GETARG_B(Instr);
-
-			if (ISK(GETARG_B(Instr)))
-			{
-				LuaUInstr.SetOpCode(LuauOp::OP_LOADK);
-				LuaUInstr.A = 254;
-				LuaUInstr.Bx = GETARG_B(Instr) - 256;
-
-				LuaUInstrs.push_back(LuaUInstr);
-
-				CmpB = 254;
-			}
-
-			LuaUInstr.A = GETARG_A(Instr);
-
-			if (ISK(GETARG_C(Instr)))
-			{
-				LuaUInstr.SetOpCode(LuauOp::OP_MODK);
-				LuaUInstr.B = CmpB;
-				LuaUInstr.C = GETARG_C(Instr) - 256;
-			}
-			else
-			{
-				LuaUInstr.SetOpCode(LuauOp::OP_MOD);
-				LuaUInstr.B = CmpB;
-				LuaUInstr.C = GETARG_C(Instr);
-			}
-
-			LuaUInstrs.push_back(LuaUInstr);
-        }
-
-        else if (Opc == OpCode::OP_POW)
-        {
-			auto CmpB = GETARG_B(Instr);
-
-			if (ISK(GETARG_B(Instr)))
-			{
-				LuaUInstr.SetOpCode(LuauOp::OP_LOADK);
-				LuaUInstr.A = 254;
-				LuaUInstr.Bx = GETARG_B(Instr) - 256;
-
-				LuaUInstrs.push_back(LuaUInstr);
-
-				CmpB = 254;
-			}
-
-			LuaUInstr.A = GETARG_A(Instr);
-
-			if (ISK(GETARG_C(Instr)))
-			{
-				LuaUInstr.SetOpCode(LuauOp::OP_POWK);
-				LuaUInstr.B = CmpB;
-				LuaUInstr.C = GETARG_C(Instr) - 256;
-			}
-			else
-			{
-				LuaUInstr.SetOpCode(LuauOp::OP_POW);
-				LuaUInstr.B = CmpB;
+				LuaUInstr.SetOpCode(Forms[0]);
 				LuaUInstr.C = GETARG_C(Instr);
 			}
 
@@ -663,25 +544,13 @@ std::vector<syn::LuauInstruction> syn::OneWayLuauTranslator::Convert(Instruction
 
             if (ISK(GETARG_B(Instr)))
             {
-                LuauInstruction Temp(0);
-                Temp.SetOpCode(LuauOp::OP_LOADK);
-                Temp.A = 254;
-                Temp.Bx = RegB;
-
-                LuaUInstrs.push_back(Temp);
-
+                LoadScratch(254, GETARG_B(Instr) - 256);
                 RegB = 254;
             }
 
             if (ISK(GETARG_C(Instr)))
             {
-                LuauInstruction Temp(0);
-                Temp.SetOpCode(LuauOp::OP_LOADK);
-                Temp.A = 255;
-                Temp.Bx = RegC;
-
-                LuaUInstrs.push_back(Temp);
-
+                LoadScratch(255, GETARG_C(Instr) - 256);
                 RegC = 255;
             }
 
@@ -706,25 +575,13 @@ std::vector<syn::LuauInstruction> syn::OneWayLuauTranslator::Convert(Instruction
 
             if (ISK(GETARG_B(Instr)))
             {
-                LuauInstruction Temp(0);
-                Temp.SetOpCode(LuauOp::OP_LOADK);
-                Temp.A = 254;
-                Temp.Bx = RegB;
-
-                LuaUInstrs.push_back(Temp);
-
+                LoadScratch(254, GETARG_B(Instr) - 256);
                 RegB = 254;
             }
 
             if (ISK(GETARG_C(Instr)))
             {
-                LuauInstruction Temp(0);
-                Temp.SetOpCode(LuauOp::OP_LOADK);
-                Temp.A = 255;
-                Temp.Bx = RegC;
-
-                LuaUInstrs.push_back(Temp);
-
+                LoadScratch(255, GETARG_C(Instr) - 256);
                 RegC = 255;
             }
 
@@ -748,25 +605,13 @@ std::vector<syn::LuauInstruction> syn::OneWayLuauTranslator::Convert(Instruction
 
             if (ISK(GETARG_B(Instr)))
             {
-                LuauInstruction Temp(0);
-                Temp.SetOpCode(LuauOp::OP_LOADK);
-                Temp.A = 254;
-                Temp.Bx = RegB;
-
-                LuaUInstrs.push_back(Temp);
-
+                LoadScratch(254, GETARG_B(Instr) - 256);
                 RegB = 254;
             }
 
             if (ISK(GETARG_C(Instr)))
             {
-                LuauInstruction Temp(0);
-                Temp.SetOpCode(LuauOp::OP_LOADK);
-                Temp.A = 255;
-                Temp.Bx = RegC;
-
-                LuaUInstrs.push_back(Temp);
-
+                LoadScratch(255, GETARG_C(Instr) - 256);
                 RegC = 255;
             }
 
@@ -970,6 +815,64 @@ std::vector<syn::LuauInstruction> syn::OneWayLuauTranslator::Convert(Instruction
 	
 	return LuaUInstrs;
 }
+
+syn::LuauTranslationCache* syn::LuauTranslationCache::GetSingleton()
+{
+	static LuauTranslationCache* Singleton = nullptr;
+	if (Singleton == nullptr)
+		Singleton = new LuauTranslationCache();
+	return Singleton;
+}
+
+std::uint64_t syn::LuauTranslationCache::Hash(Proto* P)
+{
+	/* Everything Convert reads: the code, the init flavour and the number constants OP_LOADK may inline */
+	XXH3_state_t State;
+	XXH3_64bits_reset(&State);
+	XXH3_64bits_update(&State, P->code, sizeof(Instruction) * P->sizecode);
+
+	const auto Marked = P->lastlinedefined == LastDefineKey;
+	XXH3_64bits_update(&State, &Marked, sizeof(Marked));
+	XXH3_64bits_update(&State, &P->numparams, sizeof(P->numparams));
+
+	for (auto i = 0; i < P->sizek; i++)
+	{
+		const auto Const = &P->k[i];
+		XXH3_64bits_update(&State, &Const->tt, sizeof(Const->tt));
+		if (Const->tt == LUA_TNUMBER)
+			XXH3_64bits_update(&State, &Const->value.n, sizeof(lua_Number));
+	}
+
+	return XXH3_64bits_digest(&State);
+}
+
+syn::LuauTranslationCache::Entry syn::LuauTranslationCache::Convert(Proto* P, const DWORD DecodeKey)
+{
+	const auto Key = Hash(P);
+
+	{
+		std::shared_lock<std::shared_mutex> Guard(CacheMutex);
+		if (CachedMagicMul == LuaU_MagicMul && CachedDecodeKey == DecodeKey)
+		{
+			const auto Found = Entries.find(Key);
+			if (Found != Entries.end())
+				return Found->second;
+		}
+	}
+
+	auto Translated = std::make_shared<const std::vector<LuauInstruction>>(OneWayLuauTranslator(P).Convert(P->code, P->sizecode));
+
+	std::unique_lock<std::shared_mutex> Guard(CacheMutex);
+	if (CachedMagicMul != LuaU_MagicMul || CachedDecodeKey != DecodeKey || Entries.size() >= EntryLimit)
+	{
+		Entries.clear();
+		CachedMagicMul = LuaU_MagicMul;
+		CachedDecodeKey = DecodeKey;
+	}
+
+	Entries.emplace(Key, Translated);
+	return Translated;
+}
 #endif
 
 #ifdef EnableLuaUDecompiler
@@ -995,15 +898,16 @@ uint8_t LuaUDecompilationTable[255] =
 	27, 0, 0, 0, 0, 18, 0, 0, 0, 62, 9, 0, 0, 0
 };
 
-std::vector<syn::LuauInstruction> syn::OneWayLuauDecompiler::Convert(LuauInstruction* OInstrs, const size_t Size)
+void syn::OneWayLuauDecompiler::Convert(const LuauInstruction* OInstrs, LuauInstruction* Out, const size_t Size)
 {
 	VM_DOLPHIN_RED_START
 
-	std::vector<LuauInstruction> Instrs(OInstrs, OInstrs + Size);
+	if (Out != OInstrs)
+		memcpy(Out, OInstrs, Size * sizeof(LuauInstruction));
 
-	for (size_t i = 0; i < Instrs.size(); i++)
+	for (size_t i = 0; i < Size; i++)
 	{
-		auto& Instr = Instrs[i];
+		auto& Instr = Out[i];
 
 		//Decrypt opcode.
 		Instr.OpCode = LuaUDecompilationTable[Instr.OpCode];
@@ -1046,7 +950,5 @@ std::vector<syn::LuauInstruction> syn::OneWayLuauDecompiler::Convert(LuauInstruc
 	}
 
 	VM_DOLPHIN_RED_END
-
-	return Instrs;
 }
 #endif
\ No newline at end of file
@@ -12,6 +12,10 @@
 #include "../../../Utilities/Obfuscation/ObfuscatedNumber.hpp"
 #include "../../Misc/Structures.hpp"
 
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+
 namespace syn
 {
 #if defined(EnableLuaUDecompiler) || defined(EnableLuaUTranslator)
@@ -85,6 +89,28 @@ namespace syn
 			CurrentProto = p;
 		}
 	};
+
+	/* Translated code per proto content, so re-running a module (or one edited function of it) skips retranslation */
+	class LuauTranslationCache
+	{
+	public:
+		typedef std::shared_ptr<const std::vector<LuauInstruction>> Entry;
+
+		static LuauTranslationCache* GetSingleton();
+
+		/* Entries are dropped whenever LuaU_MagicMul or DecodeKey differ from the last call */
+		Entry Convert(Proto* P, DWORD DecodeKey);
+
+	private:
+		static constexpr size_t EntryLimit = 8192;
+
+		static std::uint64_t Hash(Proto* P);
+
+		std::shared_mutex CacheMutex;
+		std::unordered_map<std::uint64_t, Entry> Entries;
+		std::uint8_t CachedMagicMul = 0;
+		DWORD CachedDecodeKey = 0;
+	};
 #endif
 
 #ifdef EnableLuaUDecompiler
@@ -92,7 +118,8 @@ namespace syn
 	class OneWayLuauDecompiler
 	{
 	public:
-		__declspec(noinline) static std::vector<LuauInstruction> Convert(LuauInstruction* OInstrs, size_t Size);
+		/* Decompilation is 1:1, Out receives Size instructions and may be OInstrs itself */
+		__declspec(noinline) static void Convert(const LuauInstruction* OInstrs, LuauInstruction* Out, size_t Size);
 	};
 #endif
 }
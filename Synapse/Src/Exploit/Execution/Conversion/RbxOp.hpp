@@ -13,11 +13,14 @@
 #include "../../Misc/Static.hpp"
 #include "../../../Utilities/Obfuscation/ObfuscatedNumber.hpp"
 
+#include <array>
+#include <emmintrin.h>
+
 #define STORE_OP(L, R) (((L) << SIZE_OP) + (R))
 
 #define ReadROpcode(n) (opcodes[(n)] & MASK1(SIZE_OP, 0))
 #define ReadLOpcode(n) (opcodes[(n)] >> SIZE_OP)
-inline int opcodes[NUM_OPCODES]
+inline constexpr int opcodes[NUM_OPCODES]
 {
     STORE_OP(OP_LOADBOOL,  0x06 /* OP_MOVE      */),
     STORE_OP(OP_GETTABLE,  0x04 /* OP_LOADK     */),
@@ -88,6 +91,18 @@ inline int opcodes[NUM_OPCODES]
 #define RGETARG_sBx(i)	(RGETARG_Bx(i)-MAXARG_sBx)
 #define RSETARG_sBx(i,b) RSETARG_Bx((i),cast(unsigned int, (b)+MAXARG_sBx))
 
+/* Full 64-entry opcode maps so a 6-bit field never indexes past the table */
+constexpr std::array<std::uint8_t, 64> BuildOpcodeMap(const bool ToRoblox)
+{
+    std::array<std::uint8_t, 64> Map{};
+    for (auto i = 0; i < NUM_OPCODES; i++)
+        Map[i] = (std::uint8_t) (ToRoblox ? opcodes[i] & MASK1(SIZE_OP, 0) : opcodes[i] >> SIZE_OP);
+    return Map;
+}
+
+inline constexpr auto RobloxOpcodeMap = BuildOpcodeMap(true);
+inline constexpr auto LuaOpcodeMap = BuildOpcodeMap(false);
+
 namespace syn
 {
     class InstructionTranslator final
@@ -201,6 +216,58 @@ namespace syn
             return NULL;
         }
 
+        /* The multiply is the only lane op SSE2 lacks, build it from the even/odd 32x32->64 products */
+        static __forceinline __m128i MulLo32(const __m128i A, const __m128i B)
+        {
+            const auto Even = _mm_mul_epu32(A, B);
+            const auto Odd = _mm_mul_epu32(_mm_srli_epi64(A, 32), _mm_srli_epi64(B, 32));
+            return _mm_unpacklo_epi32(_mm_shuffle_epi32(Even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(Odd, _MM_SHUFFLE(0, 0, 2, 0)));
+        }
+
+        /* Re-encodes Count instructions, PC of In[0] is BasePC and In may alias Out. Lanes with a PC-dependent encoding go through ConvertEncrypt */
+        void ConvertEncryptBatch(const Instruction* In, DWORD* Out, const uint32_t Count, const uint32_t BasePC = 0) const
+        {
+            const auto Key = _mm_set1_epi32((int) EncodeKey);
+            const auto MaskA = _mm_set1_epi32(MASK1(SIZE_A, 0));
+            const auto MaskB = _mm_set1_epi32(MASK1(SIZE_B, 0));
+            const auto MaskC = _mm_set1_epi32(MASK1(SIZE_C, 0));
+            const auto MaskBx = _mm_set1_epi32(MASK1(SIZE_Bx, 0));
+
+            uint32_t i = 0;
+            for (; i + 4 <= Count; i += 4)
+            {
+                alignas(16) Instruction Source[4];
+                const auto V = _mm_loadu_si128((const __m128i*) (In + i));
+                _mm_store_si128((__m128i*) Source, V);
+
+                const auto O0 = GET_OPCODE(Source[0]), O1 = GET_OPCODE(Source[1]), O2 = GET_OPCODE(Source[2]), O3 = GET_OPCODE(Source[3]);
+                const auto A = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(V, POS_A), MaskA), RPOS_A);
+                const auto B = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(V, POS_B), MaskB), RPOS_B);
+                const auto C = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(V, POS_C), MaskC), RPOS_C);
+                const auto Bx = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(V, POS_Bx), MaskBx), RPOS_Bx);
+
+                const auto KeepABC = _mm_setr_epi32(EncodeABC[O0], EncodeABC[O1], EncodeABC[O2], EncodeABC[O3]);
+                const auto KeepBx = _mm_setr_epi32(EncodeBx[O0], EncodeBx[O1], EncodeBx[O2], EncodeBx[O3]);
+                const auto Or = _mm_setr_epi32(EncodeOr[O0], EncodeOr[O1], EncodeOr[O2], EncodeOr[O3]);
+
+                auto R = _mm_or_si128(_mm_and_si128(_mm_or_si128(B, C), KeepABC), _mm_and_si128(Bx, KeepBx));
+                R = _mm_or_si128(_mm_or_si128(R, A), Or);
+                _mm_storeu_si128((__m128i*) (Out + i), MulLo32(R, Key));
+
+                if (EncodeSpecial[O0] | EncodeSpecial[O1] | EncodeSpecial[O2] | EncodeSpecial[O3])
+                {
+                    for (uint32_t j = i; j < i + 4; j++)
+                    {
+                        if (EncodeSpecial[GET_OPCODE(Source[j - i])])
+                            Out[j] = ConvertEncrypt(Source[j - i], BasePC + j);
+                    }
+                }
+            }
+
+            for (; i < Count; i++)
+                Out[i] = ConvertEncrypt(In[i], BasePC + i);
+        }
+
         DWORD ConvertEncrypt(Instruction Inst, uint32_t PC) const
         {
             DWORD RInst = 0;
@@ -322,10 +389,100 @@ namespace syn
             return Inst;
         }
 
+        /* Decodes a whole code array (In must not alias Out), extended SETLIST pseudo-instructions are copied through as data */
+        void ConvertDecryptBatch(const DWORD* In, Instruction* Out, const uint32_t Count) const
+        {
+            const auto Key = _mm_set1_epi32((int) DecodeKey);
+            const auto MaskA = _mm_set1_epi32(MASK1(SIZE_A, 0));
+            const auto MaskB = _mm_set1_epi32(MASK1(SIZE_B, 0));
+            const auto MaskC = _mm_set1_epi32(MASK1(SIZE_C, 0));
+            const auto MaskBx = _mm_set1_epi32(MASK1(SIZE_Bx, 0));
+
+            uint32_t i = 0;
+            for (; i + 4 <= Count; i += 4)
+            {
+                alignas(16) DWORD Decoded[4];
+                const auto V = MulLo32(_mm_loadu_si128((const __m128i*) (In + i)), Key);
+                _mm_store_si128((__m128i*) Decoded, V);
+
+                const auto O0 = RGET_OPCODE(Decoded[0]), O1 = RGET_OPCODE(Decoded[1]), O2 = RGET_OPCODE(Decoded[2]), O3 = RGET_OPCODE(Decoded[3]);
+
+                const auto A = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(V, RPOS_A), MaskA), POS_A);
+                const auto B = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(V, RPOS_B), MaskB), POS_B);
+                const auto C = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(V, RPOS_C), MaskC), POS_C);
+                const auto Bx = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(V, RPOS_Bx), MaskBx), POS_Bx);
+
+                const auto KeepABC = _mm_setr_epi32(DecodeABC[O0], DecodeABC[O1], DecodeABC[O2], DecodeABC[O3]);
+                const auto KeepBx = _mm_setr_epi32(DecodeBx[O0], DecodeBx[O1], DecodeBx[O2], DecodeBx[O3]);
+                const auto Op = _mm_setr_epi32(LuaOpcodeMap[O0], LuaOpcodeMap[O1], LuaOpcodeMap[O2], LuaOpcodeMap[O3]);
+
+                auto R = _mm_or_si128(_mm_and_si128(_mm_or_si128(B, C), KeepABC), _mm_and_si128(Bx, KeepBx));
+                R = _mm_or_si128(_mm_or_si128(R, A), Op);
+                _mm_storeu_si128((__m128i*) (Out + i), R);
+
+                if (DecodeSpecial[O0] | DecodeSpecial[O1] | DecodeSpecial[O2] | DecodeSpecial[O3])
+                {
+                    for (uint32_t j = i; j < i + 4; j++)
+                    {
+                        if (DecodeSpecial[RGET_OPCODE(Decoded[j - i])])
+                            Out[j] = ConvertDecrypt(In[j], j);
+                    }
+                }
+            }
+
+            for (; i < Count; i++)
+                Out[i] = ConvertDecrypt(In[i], i);
+
+            /* Lanes were decoded blindly, fix up the data slot that follows each extended SETLIST */
+            for (i = 0; i < Count; i++)
+            {
+                if (GET_OPCODE(Out[i]) == OpCode::OP_SETLIST && GETARG_C(Out[i]) == 0 && i + 1 < Count)
+                {
+                    i++;
+                    Out[i] = In[i] * DecodeKey;
+                }
+            }
+        }
+
         explicit InstructionTranslator(DWORD EncKey, DWORD DecKey)
         {
             EncodeKey = EncKey;
             DecodeKey = DecKey;
+
+            /* Per-opcode lane masks: which argument layout to keep, and the bits OR'd in after it */
+            for (auto Op = 0; Op < NUM_OPCODES; Op++)
+            {
+                const auto ROp = RobloxOpcodeMap[Op];
+                const auto IsABC = getOpMode(Op) == iABC;
+
+                EncodeABC[Op] = IsABC ? ~0u : 0;
+                EncodeBx[Op] = IsABC ? 0 : ~0u;
+                EncodeOr[Op] = (DWORD) ROp << RPOS_OP;
+                EncodeSpecial[Op] = Op == OP_JMP || Op == OP_CALL || Op == OP_RETURN || Op == OP_CLOSURE || Op == OP_SETUPVAL;
+
+                if (Op == OP_MOVE)
+                {
+                    EncodeABC[Op] &= MASK0(SIZE_C, RPOS_C);
+                    EncodeOr[Op] |= 1 << RPOS_C;
+                }
+            }
+
+            for (auto ROp = 0; ROp < 64; ROp++)
+            {
+                const auto Op = LuaOpcodeMap[ROp];
+                const auto IsABC = getOpMode(Op) == iABC;
+
+                DecodeABC[ROp] = IsABC ? ~0u : 0;
+                DecodeBx[ROp] = IsABC ? 0 : ~0u;
+                DecodeSpecial[ROp] = Op == OP_JMP || Op == OP_CALL || Op == OP_RETURN || Op == OP_CLOSURE || Op == OP_SETUPVAL;
+            }
         }
+
+    private:
+        std::array<DWORD, 64> EncodeABC{}, EncodeBx{}, EncodeOr{};
+        std::array<bool, 64> EncodeSpecial{};
+
+        std::array<DWORD, 64> DecodeABC{}, DecodeBx{};
+        std::array<bool, 64> DecodeSpecial{};
     };
 }
\ No newline at end of file
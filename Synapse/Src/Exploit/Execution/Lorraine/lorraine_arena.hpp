@@ -0,0 +1,120 @@
+/*
+ *	lorraine  LuaU compiler and analyser, written for Synapse X by Louka & Eternal
+ *	Bump arena, everything a single compilation allocates lives here and goes away together
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace lorraine
+{
+	class arena final
+	{
+	public:
+		static constexpr std::size_t block_size = 64 * 1024;
+
+		arena() = default;
+		arena(const arena&) = delete;
+		arena& operator=(const arena&) = delete;
+
+		~arena()
+		{
+			release();
+		}
+
+		void* allocate(std::size_t size, std::size_t align = alignof(std::max_align_t))
+		{
+			auto at = (a_cursor + align - 1) & ~static_cast<std::uintptr_t>(align - 1);
+			if (a_head == nullptr || at + size > a_end)
+			{
+				grow(size + align);
+				at = (a_cursor + align - 1) & ~static_cast<std::uintptr_t>(align - 1);
+			}
+
+			a_cursor = at + size;
+			return reinterpret_cast<void*>(at);
+		}
+
+		/* destructors of arena objects are never run, only put trivially destructible or arena backed things here */
+		template <typename T, typename... A>
+		T* create(A&&... args)
+		{
+			return new (allocate(sizeof(T), alignof(T))) T(std::forward<A>(args)...);
+		}
+
+		void release()
+		{
+			while (a_head)
+			{
+				const auto next = a_head->next;
+				::operator delete(a_head);
+				a_head = next;
+			}
+			a_cursor = a_end = 0;
+		}
+
+	private:
+		struct block
+		{
+			block* next;
+		};
+
+		void grow(std::size_t at_least)
+		{
+			const auto size = at_least + sizeof(block) > block_size ? at_least + sizeof(block) : block_size;
+			const auto b = static_cast<block*>(::operator new(size));
+			b->next = a_head;
+			a_head = b;
+			a_cursor = reinterpret_cast<std::uintptr_t>(b + 1);
+			a_end = reinterpret_cast<std::uintptr_t>(b) + size;
+		}
+
+		block* a_head = nullptr;
+		std::uintptr_t a_cursor = 0;
+		std::uintptr_t a_end = 0;
+	};
+
+	/* containers on an arena never give memory back, a reallocating vector leaves its old buffer behind */
+	template <typename T>
+	class arena_allocator
+	{
+	public:
+		using value_type = T;
+
+		lorraine::arena* al_arena;
+
+		explicit arena_allocator(lorraine::arena& a) noexcept
+			: al_arena(&a) {}
+
+		template <typename U>
+		arena_allocator(const arena_allocator<U>& other) noexcept
+			: al_arena(other.al_arena) {}
+
+		T* allocate(std::size_t n)
+		{
+			return static_cast<T*>(al_arena->allocate(n * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T*, std::size_t) noexcept {}
+
+		template <typename U>
+		bool operator==(const arena_allocator<U>& other) const noexcept
+		{
+			return al_arena == other.al_arena;
+		}
+
+		template <typename U>
+		bool operator!=(const arena_allocator<U>& other) const noexcept
+		{
+			return al_arena != other.al_arena;
+		}
+	};
+
+	template <typename T>
+	using arena_vector = std::vector<T, arena_allocator<T>>;
+}
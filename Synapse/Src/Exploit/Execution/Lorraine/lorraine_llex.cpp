@@ -1,4 +1,3 @@
-
 /*
  *	lorraine  LuaU compiler and analyser, written for Synapse X by Louka & Eternal
  *	Lexer
@@ -7,79 +6,355 @@
 #include "lorraine_across.hpp"
 #include "lorraine_llex.hpp"
 
-struct i_lorraine_token_map_entry
+#include <cwchar>
+
+size_t lorraine::lorraine_lexer_gearbox::match_operator(std::wstring_view in, lorraine::uint& id)
+{
+	const auto next = in.size() > 1 ? in[1] : L'\0';
+	switch (in.front())
+	{
+		case L'+': id = OP_ADD; return 1;
+		case L'-': id = OP_SUB; return 1;
+		case L'*': id = OP_MUL; return 1;
+		case L'/': id = OP_DIV; return 1;
+		case L'%': id = OP_MOD; return 1;
+		case L'^': id = OP_POW; return 1;
+		case L'#': id = OP_LEN; return 1;
+		case L'(': id = OP_LP; return 1;
+		case L')': id = OP_RP; return 1;
+		case L'{': id = OP_LB; return 1;
+		case L'}': id = OP_RB; return 1;
+		case L'[': id = OP_LS; return 1;
+		case L']': id = OP_RS; return 1;
+		case L';': id = OP_SEM; return 1;
+		case L':': id = OP_COL; return 1;
+		case L',': id = OP_COM; return 1;
+		case L'=':
+			if (next == L'=') { id = OP_EQ; return 2; }
+			id = OP_ASS; return 1;
+		case L'~':
+		case L'!':
+			if (next == L'=') { id = OP_NEQ; return 2; }
+			return 0;
+		case L'<':
+			if (next == L'=') { id = OP_LE; return 2; }
+			id = OP_LT; return 1;
+		case L'>':
+			if (next == L'=') { id = OP_GE; return 2; }
+			id = OP_BT; return 1;
+		case L'.':
+			if (next != L'.') { id = OP_DOT; return 1; }
+			if (in.size() > 2 && in[2] == L'.') { id = OP_PER; return 3; }
+			id = OP_CON; return 2;
+		default:
+			return 0;
+	}
+}
+
+double lorraine::lorraine_lexer_gearbox::hexadecimal_numstring_to_double(std::wstring_view str)
+{
+	double nn = 0;
+	for (const auto c : str)
+	{
+		if (c >= L'0' && c <= L'9')
+			nn = nn * 16 + (c - L'0');
+		else if (c >= L'a' && c <= L'f')
+			nn = nn * 16 + (c - L'a' + 10);
+		else if (c >= L'A' && c <= L'F')
+			nn = nn * 16 + (c - L'A' + 10);
+	}
+	return nn;
+}
+
+double lorraine::lorraine_lexer_gearbox::numstring_to_double(std::wstring_view str)
+{
+	/* wcstod wants a terminator, numbers that don't fit the stack buffer are rare enough to allocate */
+	wchar_t buffer[64];
+	if (str.size() < _countof(buffer))
+	{
+		std::wmemcpy(buffer, str.data(), str.size());
+		buffer[str.size()] = L'\0';
+		return std::wcstod(buffer, nullptr);
+	}
+
+	const std::wstring copy(str);
+	return std::wcstod(copy.c_str(), nullptr);
+}
+
+void lorraine::lorraine_lexer::read_newline()
+{
+	const auto c = peek();
+	lexer_needle++;
+
+	/* \r\n and \n\r are a single line break */
+	const auto n = peek();
+	if ((n == L'\r' || n == L'\n') && n != c)
+		lexer_needle++;
+
+	lexer_line++;
+	line_starts.push_back(lexer_needle);
+}
+
+/* level of a [==[ opener at the needle, -1 if there isn't one */
+int lorraine::lorraine_lexer::long_bracket_level() const
 {
-	std::wstring token_name;
-	lorraine::uint token_id;
-};
+	if (peek() != L'[')
+		return -1;
+
+	size_type ahead = 1;
+	while (peek(ahead) == L'=')
+		ahead++;
+	return peek(ahead) == L'[' ? static_cast<int>(ahead - 1) : -1;
+}
 
-lorraine::lorraine_lexer_gearbox* lorraine::lorraine_lexer_gearbox::initialize_default_gearbox()
+std::wstring_view lorraine::lorraine_lexer::read_long_bracket(int level)
 {
-	/* to-do: obfuscate this */
-	lorraine_lexer_gearbox* gearbox = new lorraine_lexer_gearbox;
-
-	/* i know it LOOKS like there's a faster way to do this, but there isn't one.
-	 * there's no way to properly order this in a map, array or likewise due to the
-	 * op/tk separation (string compares would make this function slower, or adding
-	 * an extra field would take up more memory), there's no way to generate the
-	 * strings (avoiding arrays) without taking up more memory/more time, etc. this
-	 * code looks like hot steaming garbage but its the fastest we can do it
-	 * 
-	 * i say caching gearbox::lang_usermap would remove an additional pointer deref
-	 * but msvc already optimizes it out so /shrug
-	 */
-
-	/* keywords */
-	gearbox->lang_usermap[L"TK_AND"] = gearbox->add_keyword(L"and");
-	gearbox->lang_usermap[L"TK_BREAK"] = gearbox->add_keyword(L"break");
-	gearbox->lang_usermap[L"TK_DO"] = gearbox->add_keyword(L"do");
-	gearbox->lang_usermap[L"TK_ELSE"] = gearbox->add_keyword(L"else");
-	gearbox->lang_usermap[L"TK_ELSEIF"] = gearbox->add_keyword(L"elseif");
-	gearbox->lang_usermap[L"TK_END"] = gearbox->add_keyword(L"end");
-	gearbox->lang_usermap[L"TK_FALSE"] = gearbox->add_keyword(L"false");
-	gearbox->lang_usermap[L"TK_FOR"] = gearbox->add_keyword(L"for");
-	gearbox->lang_usermap[L"TK_FUNCTION"] = gearbox->add_keyword(L"function");
-	gearbox->lang_usermap[L"TK_IF"] = gearbox->add_keyword(L"if");
-	gearbox->lang_usermap[L"TK_IN"] = gearbox->add_keyword(L"in");
-	gearbox->lang_usermap[L"TK_LOCAL"] = gearbox->add_keyword(L"local");
-	gearbox->lang_usermap[L"TK_NIL"] = gearbox->add_keyword(L"nil");
-	gearbox->lang_usermap[L"TK_NOT"] = gearbox->add_keyword(L"not");
-	gearbox->lang_usermap[L"TK_OR"] = gearbox->add_keyword(L"or");
-	gearbox->lang_usermap[L"TK_REPEAT"] = gearbox->add_keyword(L"repeat");
-	gearbox->lang_usermap[L"TK_RETURN"] = gearbox->add_keyword(L"return");
-	gearbox->lang_usermap[L"TK_THEN"] = gearbox->add_keyword(L"then");
-	gearbox->lang_usermap[L"TK_TRUE"] = gearbox->add_keyword(L"true");
-	gearbox->lang_usermap[L"TK_UNTIL"] = gearbox->add_keyword(L"until");
-	gearbox->lang_usermap[L"TK_WHILE"] = gearbox->add_keyword(L"while");
-
-	/* operators */
-	gearbox->lang_usermap[L"OP_ADD"] = gearbox->add_operator(L"+");
-	gearbox->lang_usermap[L"OP_SUB"] = gearbox->add_operator(L"-");
-	gearbox->lang_usermap[L"OP_MUL"] = gearbox->add_operator(L"*");
-	gearbox->lang_usermap[L"OP_DIV"] = gearbox->add_operator(L"/");
-	gearbox->lang_usermap[L"OP_MOD"] = gearbox->add_operator(L"%");
-	gearbox->lang_usermap[L"OP_POW"] = gearbox->add_operator(L"^");
-	gearbox->lang_usermap[L"OP_LEN"] = gearbox->add_operator(L"#");
-	gearbox->lang_usermap[L"OP_EQ"] = gearbox->add_operator(L"==");
-	gearbox->lang_usermap[L"OP_NEQ"] = gearbox->add_operator(L"!=");
-	gearbox->lang_usermap[L"OP_LE"] = gearbox->add_operator(L"<=");
-	gearbox->lang_usermap[L"OP_GE"] = gearbox->add_operator(L">=");
-	gearbox->lang_usermap[L"OP_LT"] = gearbox->add_operator(L"<");
-	gearbox->lang_usermap[L"OP_BT"] = gearbox->add_operator(L">");
-	// gearbox->lang_usermap[L"OP_BLT"] = gearbox->add_operator(L"bacon lettuce tomato");
-	gearbox->lang_usermap[L"OP_ASS"] = gearbox->add_operator(L"="); // shut up
-	gearbox->lang_usermap[L"OP_LP"] = gearbox->add_operator(L"(");
-	gearbox->lang_usermap[L"OP_RP"] = gearbox->add_operator(L")");
-	gearbox->lang_usermap[L"OP_LB"] = gearbox->add_operator(L"{");
-	gearbox->lang_usermap[L"OP_RB"] = gearbox->add_operator(L"}");
-	gearbox->lang_usermap[L"OP_LS"] = gearbox->add_operator(L"[");
-	gearbox->lang_usermap[L"OP_RS"] = gearbox->add_operator(L"]");
-	gearbox->lang_usermap[L"OP_SEM"] = gearbox->add_operator(L";");
-	gearbox->lang_usermap[L"OP_COL"] = gearbox->add_operator(L":");
-	gearbox->lang_usermap[L"OP_COM"] = gearbox->add_operator(L",");
-	gearbox->lang_usermap[L"OP_DOT"] = gearbox->add_operator(L".");
-	gearbox->lang_usermap[L"OP_CON"] = gearbox->add_operator(L"..");
-	gearbox->lang_usermap[L"OP_PER"] = gearbox->add_operator(L"...");
-
-	return gearbox;
+	lexer_needle += level + 2;
+	const auto begin = static_cast<size_type>(lexer_needle);
+	const auto size = lexer_input.size();
+
+	while (lexer_needle < size)
+	{
+		const auto c = peek();
+		if (c == L']')
+		{
+			size_type ahead = 1;
+			while (peek(ahead) == L'=')
+				ahead++;
+
+			if (ahead - 1 == static_cast<size_type>(level) && peek(ahead) == L']')
+			{
+				const auto content = lexer_input.substr(begin, static_cast<size_type>(lexer_needle) - begin);
+				lexer_needle += ahead + 1;
+				return content;
+			}
+			lexer_needle++;
+		}
+		else if (c == L'\r' || c == L'\n')
+			read_newline();
+		else
+			lexer_needle++;
+	}
+
+	throw std::exception("unfinished long string/comment");
+}
+
+void lorraine::lorraine_lexer::skip_whitespace_and_comments()
+{
+	const auto size = lexer_input.size();
+	while (lexer_needle < size)
+	{
+		const auto c = peek();
+		switch (lorraine_lexer_gearbox::classify(c))
+		{
+			case lcc_space:
+				lexer_needle++;
+				continue;
+			case lcc_newline:
+				read_newline();
+				continue;
+			default: ;
+		}
+
+		if (c != L'-' || peek(1) != L'-')
+			return;
+
+		lexer_needle += 2;
+		const auto level = long_bracket_level();
+		if (level >= 0)
+		{
+			read_long_bracket(level);
+			continue;
+		}
+
+		while (lexer_needle < size && lorraine_lexer_gearbox::classify(peek()) != lcc_newline)
+			lexer_needle++;
+	}
+}
+
+void lorraine::lorraine_lexer::read_name()
+{
+	const auto begin = static_cast<size_type>(lexer_needle);
+	const auto size = lexer_input.size();
+	while (lexer_needle < size)
+	{
+		const auto cc = lorraine_lexer_gearbox::classify(peek());
+		if (cc != lcc_name && cc != lcc_digit)
+			break;
+		lexer_needle++;
+	}
+
+	lorraine_lexer_singlet singlet;
+	singlet.line = lexer_line;
+
+	const auto name = lexer_input.substr(begin, static_cast<size_type>(lexer_needle) - begin);
+	lorraine::uint id;
+	if (lorraine_lexer_gearbox::match_keyword(name, id))
+	{
+		singlet.tt = llex_keyword;
+		singlet.v = lorraine_token(id, name);
+	}
+	else
+	{
+		singlet.tt = llex_name;
+		singlet.v = name;
+	}
+	singlets.push_back(singlet);
+}
+
+void lorraine::lorraine_lexer::read_number()
+{
+	const auto begin = static_cast<size_type>(lexer_needle);
+	double nn;
+
+	if (peek() == L'0' && (peek(1) == L'x' || peek(1) == L'X'))
+	{
+		lexer_needle += 2;
+		const auto digits = static_cast<size_type>(lexer_needle);
+		while (lorraine_lexer_gearbox::is_hexadecimal(peek()))
+			lexer_needle++;
+		if (static_cast<size_type>(lexer_needle) == digits)
+			throw std::exception("malformed number");
+		nn = lorraine_lexer_gearbox::hexadecimal_numstring_to_double(lexer_input.substr(digits, static_cast<size_type>(lexer_needle) - digits));
+	}
+	else
+	{
+		while (lorraine_lexer_gearbox::is_numerical(peek()))
+			lexer_needle++;
+		if (peek() == L'.' && peek(1) != L'.')
+		{
+			lexer_needle++;
+			while (lorraine_lexer_gearbox::is_numerical(peek()))
+				lexer_needle++;
+		}
+		if (peek() == L'e' || peek() == L'E')
+		{
+			lexer_needle++;
+			if (peek() == L'+' || peek() == L'-')
+				lexer_needle++;
+			if (!lorraine_lexer_gearbox::is_numerical(peek()))
+				throw std::exception("malformed number");
+			while (lorraine_lexer_gearbox::is_numerical(peek()))
+				lexer_needle++;
+		}
+		nn = lorraine_lexer_gearbox::numstring_to_double(lexer_input.substr(begin, static_cast<size_type>(lexer_needle) - begin));
+	}
+
+	/* 3x or 0x1g */
+	if (lorraine_lexer_gearbox::classify(peek()) == lcc_name)
+		throw std::exception("malformed number");
+
+	lorraine_lexer_singlet singlet;
+	singlet.tt = llex_number;
+	singlet.line = lexer_line;
+	singlet.v = nn;
+	singlets.push_back(singlet);
+}
+
+void lorraine::lorraine_lexer::read_string(wchar_t quote)
+{
+	lorraine_lexer_singlet singlet;
+	singlet.tt = llex_string;
+	singlet.line = lexer_line;
+
+	lexer_needle++;
+	const auto begin = static_cast<size_type>(lexer_needle);
+	const auto size = lexer_input.size();
+
+	while (lexer_needle < size)
+	{
+		const auto c = peek();
+		if (c == quote)
+		{
+			singlet.v = lexer_input.substr(begin, static_cast<size_type>(lexer_needle) - begin);
+			lexer_needle++;
+			singlets.push_back(singlet);
+			return;
+		}
+
+		if (c == L'\r' || c == L'\n')
+			throw std::exception("unfinished string");
+
+		if (c == L'\\')
+		{
+			lexer_needle++;
+			if (peek() == L'\r' || peek() == L'\n')
+			{
+				read_newline();
+				continue;
+			}
+		}
+		lexer_needle++;
+	}
+
+	throw std::exception("unfinished string");
+}
+
+void lorraine::lorraine_lexer::read_operator()
+{
+	const auto rest = lexer_input.substr(static_cast<size_type>(lexer_needle));
+	lorraine::uint id;
+	const auto length = lorraine_lexer_gearbox::match_operator(rest, id);
+	if (length == 0)
+		throw std::exception("not operator");
+
+	lorraine_lexer_singlet singlet;
+	singlet.tt = llex_operator;
+	singlet.line = lexer_line;
+	singlet.v = lorraine_token(id, rest.substr(0, length));
+	singlets.push_back(singlet);
+	lexer_needle += length;
+}
+
+bool lorraine::lorraine_lexer::pass()
+{
+	const auto i_size = lexer_input.size();
+
+	/* roughly one token per 4 chars of average lua, saves most of the regrowth on big scripts */
+	singlets.clear();
+	singlets.reserve(i_size / 4 + 1);
+	line_starts.assign(1, 0);
+	lexer_line = 1;
+
+	while (true)
+	{
+		skip_whitespace_and_comments();
+		if (lexer_needle >= i_size)
+			break;
+
+		const auto c = peek();
+		switch (lorraine_lexer_gearbox::classify(c))
+		{
+			case lcc_name:
+				read_name(); break;
+			case lcc_digit:
+				read_number(); break;
+			case lcc_quote:
+				read_string(c); break;
+			case lcc_operator:
+			{
+				if (c == L'.' && lorraine_lexer_gearbox::is_numerical(peek(1)))
+				{
+					read_number();
+					break;
+				}
+
+				const auto level = long_bracket_level();
+				if (level >= 0)
+				{
+					lorraine_lexer_singlet singlet;
+					singlet.tt = llex_string;
+					singlet.line = lexer_line;
+					singlet.v = read_long_bracket(level);
+					singlets.push_back(singlet);
+					break;
+				}
+
+				read_operator(); break;
+			}
+			default:
+				throw std::exception("unexpected symbol");
+		}
+	}
+	return true;
 }
@@ -1,4 +1,3 @@
-
 /*
  *	lorraine  LuaU compiler and analyser, written for Synapse X by Louka & Eternal
  *	
@@ -13,7 +12,8 @@
  *	The compiler can be found in lorraine_code.hpp/lorrane_code.cpp.
  *	
  *	Features:
- *		- Soft-coded language information (just change a few vectors and the lexer will parse the language differently)
+ *		- Table-driven: one 256 entry character class table and a compile time perfect hash for keywords
+ *		- Allocation-free: tokens are slices of the input, the only allocation is the singlet vector
  *		- Compiles to uIR (an intermediate language format written for Lorraine, see lorraine_uir.hpp and lorraine_uir.cpp)
  *			- Can compile to Luau instructions or Lua instructions
  *			- uIR bytecode allows for dumping the IR to a portable format (security? obfuscation? who knows?)
@@ -33,20 +33,34 @@
  * [x] Whitespace recognition (not easy on UTF due to the sole number of whitespace chars)
  * [x] Keyword/operator interpreter (look in lorraine_llex.cpp)
  * [x] Needle-pass algorithm for interpreting scripts
- * [ ] Commment interpreter (lol yes this is still undone)
- * [ ] String interpreter (convert "abc" to a string object)
- * [ ] Optimization (make this use less memory/work faster)
+ * [x] Commment interpreter (lol yes this is still undone)
+ * [ ] String interpreter (strings are raw slices for now, escapes are resolved by whoever consumes them)
+ * [x] Optimization (make this use less memory/work faster)
  * [ ] Testing (see if this shit actually works as expected)
  */
 
 #pragma once
 
+#include <array>
+#include <string_view>
 #include <utility>
+#include "lorraine_across.hpp"
 #include "lorraine_device.hpp"
 
 namespace lorraine
 {
-	using lorraine_string_collection = std::vector<std::wstring>;
+	/* keywords first, in the order of lorraine_keywords below, then operators */
+	enum lorraine_token_id : lorraine::uint
+	{
+		TK_AND, TK_BREAK, TK_DO, TK_ELSE, TK_ELSEIF, TK_END, TK_FALSE,
+		TK_FOR, TK_FUNCTION, TK_IF, TK_IN, TK_LOCAL, TK_NIL, TK_NOT,
+		TK_OR, TK_REPEAT, TK_RETURN, TK_THEN, TK_TRUE, TK_UNTIL, TK_WHILE,
+
+		OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_MOD, OP_POW, OP_LEN,
+		OP_EQ, OP_NEQ, OP_LE, OP_GE, OP_LT, OP_BT, OP_ASS,
+		OP_LP, OP_RP, OP_LB, OP_RB, OP_LS, OP_RS,
+		OP_SEM, OP_COL, OP_COM, OP_DOT, OP_CON, OP_PER
+	};
 
 	/* so, why use the keyword "final" at the end of classes? 
 	 * unless you want to inherit from the classes below, we
@@ -65,9 +79,9 @@ namespace lorraine
 	{
 	public:
 		lorraine::uint token_id;
-		std::wstring token_string;
+		std::wstring_view token_string;	/* slice of the lexer input, only valid while the input is */
 
-		bool is_same(const std::wstring& comparator) const
+		bool is_same(std::wstring_view comparator) const
 		{
 			return token_string == comparator;
 		}
@@ -77,16 +91,13 @@ namespace lorraine
 			return token_id == other.token_id;
 		}
 
-		bool operator==(const std::wstring& other) const
+		bool operator==(std::wstring_view other) const
 		{
 			return is_same(other);
 		}
 
-		lorraine_token(lorraine::uint t_id, const std::wstring& string)
-		{
-			token_id = t_id;
-			token_string = string;
-		}
+		lorraine_token(lorraine::uint t_id, std::wstring_view string)
+			: token_id(t_id), token_string(string) {}
 
         lorraine_token()
             : token_id(NULL) {}
@@ -106,219 +117,192 @@ namespace lorraine
 	{
 	public:
 		lorraine_lexer_singlet_type tt;
-		std::variant<lorraine_token, std::wstring, double> v;
+		lorraine::uint line;
+		std::variant<lorraine_token, std::wstring_view, double> v;
 
-		lorraine_token get_token()
+		lorraine_token get_token() const
 		{
 			return std::get<lorraine_token>(v);
 		}
 
-		std::wstring get_string()
+		std::wstring_view get_string() const
 		{
-			return std::get<std::wstring>(v);
+			return std::get<std::wstring_view>(v);
 		}
 
-		double get_number()
+		double get_number() const
 		{
 			return std::get<double>(v);
 		}
 
 		lorraine_lexer_singlet()
-		{
-			tt = llex_none;
-			v = std::variant<lorraine_token, std::wstring, double>();
-		};
+			: tt(llex_none), line(0) {}
 	};
 
-	class lorraine_lexer_gearbox final
+	enum lorraine_char_class : unsigned char
 	{
-	public:
-		std::vector<lorraine_token> lang_keywords;
-		std::vector<lorraine_token> lang_operators;
-		std::vector<std::wstring> lang_keywords_wstring;
-		std::vector<std::wstring> lang_operators_wstring;
-		std::map<std::wstring, lorraine::uint> lang_usermap;
-
-		lorraine::uint add_keyword(std::wstring tk_string)
-		{
-			lorraine_token tk;
-			tk.token_id = lang_keywords.size();
-			tk.token_string = std::move(tk_string);
-			lang_keywords_wstring.push_back(tk.token_string);
-			lang_keywords.push_back(tk);
-			return tk.token_id;
-		}
+		lcc_other,		/* not valid outside of strings and comments */
+		lcc_space,
+		lcc_newline,
+		lcc_digit,
+		lcc_name,		/* letters, '_' and everything non-ascii that isn't whitespace */
+		lcc_operator,
+		lcc_quote
+	};
 
-		lorraine::uint add_operator(std::wstring tk_string)
-		{
-			lorraine_token tk;
-			tk.token_id = lang_operators.size();
-			tk.token_string = std::move(tk_string);
-			lang_operators_wstring.push_back(tk.token_string);
-			lang_operators.push_back(tk);
-			return tk.token_id;
-		}
+	constexpr std::array<unsigned char, 256> i_lorraine_make_char_classes()
+	{
+		std::array<unsigned char, 256> t{};
+		for (auto c = 0x80; c <= 0xFF; c++)
+			t[c] = lcc_name;
+		for (auto c = L'0'; c <= L'9'; c++)
+			t[c] = lcc_digit;
+		for (auto c = L'a'; c <= L'z'; c++)
+			t[c] = t[c - 0x20] = lcc_name;
+		t[L'_'] = lcc_name;
+
+		t[0x09] = t[0x0B] = t[0x0C] = t[0x20] = t[0x85] = t[0xA0] = lcc_space;
+		t[0x0A] = t[0x0D] = lcc_newline;
+		t[L'"'] = t[L'\''] = lcc_quote;
+
+		for (const auto c : L"+-*/%^#=~!<>(){}[];:,.")
+			if (c)
+				t[c] = lcc_operator;
+		return t;
+	}
+
+	constexpr std::array<std::wstring_view, 21> lorraine_keywords =
+	{
+		L"and", L"break", L"do", L"else", L"elseif", L"end", L"false",
+		L"for", L"function", L"if", L"in", L"local", L"nil", L"not",
+		L"or", L"repeat", L"return", L"then", L"true", L"until", L"while"
+	};
 
-		bool is_keyword(const std::wstring& in) const
-		{
-			for (auto& tk : lang_keywords)
-				if (tk == in)
-					return true;
-			return false;
-		}
+	/* 6 bit slot from the first and last char and the length, no two keywords share those three */
+	constexpr lorraine::uint i_lorraine_keyword_hash(std::wstring_view s, lorraine::uint seed)
+	{
+		return static_cast<lorraine::uint>((((s.front() * seed + s.back()) ^ (s.size() * 7)) * 2654435761u) & 0xFFFFFFFF) >> 26;
+	}
 
-		bool is_operator(const std::wstring& in) const
+	constexpr lorraine::uint i_lorraine_find_keyword_seed()
+	{
+		for (lorraine::uint seed = 1; seed < 0x10000; seed++)
 		{
-			for (auto& tk : lang_operators)
-				if (tk == in)
-					return true;
-			return false;
+			std::array<bool, 64> used{};
+			auto collides = false;
+			for (const auto k : lorraine_keywords)
+			{
+				const auto h = i_lorraine_keyword_hash(k, seed);
+				collides |= used[h];
+				used[h] = true;
+			}
+			if (!collides)
+				return seed;
 		}
+		return 0;
+	}
 
-		static bool is_numerical(wchar_t in)
-		{
-			const std::pair<wchar_t, wchar_t> number_range = { 0x30, 0x39 };	/* U+0030 - U+0039 */
-			return in >= number_range.first && in <= number_range.second;
-		}
+	constexpr lorraine::uint lorraine_keyword_seed = i_lorraine_find_keyword_seed();
+	static_assert(lorraine_keyword_seed != 0, "no collision free keyword seed");
 
-		static bool is_alphanumerical(wchar_t in)
-		{
-			const std::pair<wchar_t, wchar_t> number_range =		{ 0x30, 0x39 };	/* U+0030 - U+0039 */
-			const std::pair<wchar_t, wchar_t> alphahigh_range =		{ 0x41, 0x5A };	/* U+0041 - U+005A */
-			const std::pair<wchar_t, wchar_t> alphalow_range =		{ 0x61, 0x7A };	/* U+0061 - U+007A */
-			return
-				(in >= number_range.first && in <= number_range.second) ||
-				(in >= alphahigh_range.first && in <= alphahigh_range.second) ||
-				(in >= alphalow_range.first && in <= alphalow_range.second);
-		}
+	/* slot -> keyword index + 1, 0 is an empty slot */
+	constexpr std::array<unsigned char, 64> i_lorraine_make_keyword_slots()
+	{
+		std::array<unsigned char, 64> t{};
+		for (size_t k = 0; k < lorraine_keywords.size(); k++)
+			t[i_lorraine_keyword_hash(lorraine_keywords[k], lorraine_keyword_seed)] = static_cast<unsigned char>(k + 1);
+		return t;
+	}
 
-		static bool is_hexadecimal(wchar_t in)
-		{
-			const std::pair<wchar_t, wchar_t> number_range = { 0x30, 0x39 };	/* U+0030 - U+0039 */
-			const std::pair<wchar_t, wchar_t> alphahigh_range = { 0x41, 0x46 };	/* U+0041 - U+0046 */
-			const std::pair<wchar_t, wchar_t> alphalow_range = { 0x61, 0x66 };	/* U+0061 - U+0066 */
-			return
-				(in >= number_range.first && in <= number_range.second) ||
-				(in >= alphahigh_range.first && in <= alphahigh_range.second) ||
-				(in >= alphalow_range.first && in <= alphalow_range.second);
-		}
+	class lorraine_lexer_gearbox final
+	{
+	public:
+		static constexpr std::array<unsigned char, 256> char_classes = i_lorraine_make_char_classes();
+		static constexpr std::array<unsigned char, 64> keyword_slots = i_lorraine_make_keyword_slots();
 
-		static bool is_whitespace(wchar_t in)
+		static bool is_unicode_whitespace(wchar_t in)
 		{
-			const std::vector<wchar_t> whitespace =
+			switch (in)
 			{
 				/* typographical whitespace */
-				0x0009, 0x000A, 0x000B, 0x000C,
-				0x000D, 0x0020, 0x0085, 0x00A0,
-				0x1680, 0x2000, 0x2001, 0x2002,
-				0x2003, 0x2004, 0x2005, 0x2006,
-				0x2007, 0x2008, 0x2009, 0x200A,
-				0x2028, 0x2029, 0x202F, 0x205F,
-				0x3000,
+				case 0x1680: case 0x2000: case 0x2001: case 0x2002:
+				case 0x2003: case 0x2004: case 0x2005: case 0x2006:
+				case 0x2007: case 0x2008: case 0x2009: case 0x200A:
+				case 0x2028: case 0x2029: case 0x202F: case 0x205F:
+				case 0x3000:
 
 				/* technical whitespace */
-				0x180E, 0x200B, 0x200C, 0x200D,
-				0x2060, 0xFEFF
-			};
-
-			return std::find(whitespace.begin(), whitespace.end(), in) != whitespace.end();
+				case 0x180E: case 0x200B: case 0x200C: case 0x200D:
+				case 0x2060: case 0xFEFF:
+					return true;
+				default:
+					return false;
+			}
 		}
 
-		static bool is_hexadecimal_number(const std::wstring& trynum)
+		static lorraine_char_class classify(wchar_t in)
 		{
-			auto hex_prefix = trynum.substr(1, 2);
-			auto hex_suffix = trynum.substr(hex_prefix == L"0x" || hex_prefix == L"0X" ? 2 : 0, trynum.length());
-			for (std::size_t i = 0; i <= trynum.length(); i++)
-				if (!is_hexadecimal(hex_suffix.at(i)))
-					return false;
-			return true;
+			if (in < 0x100)
+				return static_cast<lorraine_char_class>(char_classes[in]);
+			return is_unicode_whitespace(in) ? lcc_space : lcc_name;
 		}
 
-		static bool is_number(const std::wstring& trynum)
+		static bool is_numerical(wchar_t in)
 		{
-			for (std::size_t i = 0; i <= trynum.length(); i++)
-				if (!is_numerical(trynum.at(i)))
-					return false;
-			return true;
+			return in < 0x100 && char_classes[in] == lcc_digit;
 		}
 
-		/* if you have a better and faster way to do this, please implement */
-		static double hexadecimal_numstring_to_double(const std::wstring& str)
+		static bool is_alphanumerical(wchar_t in)
 		{
-			std::wstringstream wstr;
-			double nn;
-			wstr << std::hex << str;
-			wstr >> nn;
-			return nn;
+			return (in >= L'0' && in <= L'9') || (in >= L'A' && in <= L'Z') || (in >= L'a' && in <= L'z');
 		}
 
-		/* ditto */
-		static double numstring_to_double(const std::wstring& str)
+		static bool is_hexadecimal(wchar_t in)
 		{
-			std::wstringstream wstr;
-			double nn;
-			wstr << str;
-			wstr >> nn;
-			return nn;
+			return (in >= L'0' && in <= L'9') || (in >= L'A' && in <= L'F') || (in >= L'a' && in <= L'f');
 		}
 
-		static const std::vector<std::wstring>& get_whitespace_vector()
+		static bool is_whitespace(wchar_t in)
 		{
-			static const std::vector<std::wstring>& whitespace_vector = 
-			{	L"\x0009", L"\x000A", L"\x000B", L"\x000C", 
-				L"\x000D", L"\x0020", L"\x0085", L"\x00A0", 
-				L"\x1680", L"\x2000", L"\x2001", L"\x2002", 
-				L"\x2003", L"\x2004", L"\x2005", L"\x2006", 
-				L"\x2007", L"\x2008", L"\x2009", L"\x200A", 
-				L"\x2028", L"\x2029", L"\x202F", L"\x205F", 
-				L"\x3000", L"\x180E", L"\x200B", L"\x200C", 
-				L"\x200D", L"\x2060", L"\xFEFF" };
-			return whitespace_vector;
+			const auto cc = classify(in);
+			return cc == lcc_space || cc == lcc_newline;
 		}
 
-		static std::vector<std::wstring> combine_wstring_vector(const std::vector<std::wstring>& a, const std::vector<std::wstring>& b)
+		static bool match_keyword(std::wstring_view in, lorraine::uint& id)
 		{
-			std::vector<std::wstring> combine_vector;
-			combine_vector.reserve(a.size() + b.size());
-			combine_vector.insert(combine_vector.end(), a.begin(), a.end());
-			combine_vector.insert(combine_vector.end(), b.begin(), b.end());
-			return combine_vector;
+			if (in.size() < 2 || in.size() > 8)
+				return false;
+
+			const auto k = keyword_slots[i_lorraine_keyword_hash(in, lorraine_keyword_seed)];
+			if (k == 0 || lorraine_keywords[k - 1] != in)
+				return false;
+
+			id = TK_AND + k - 1;
+			return true;
 		}
 
-		static lorraine_lexer_gearbox* initialize_default_gearbox();
+		/* longest operator at the start of in, returns its length or 0 */
+		static size_t match_operator(std::wstring_view in, lorraine::uint& id);
+
+		static double hexadecimal_numstring_to_double(std::wstring_view str);
+		static double numstring_to_double(std::wstring_view str);
 	};
 
 	class lorraine_lexer final
 	{
-	private:
-		std::vector<std::wstring> _i_ws_op_vector;
-		const std::vector<std::wstring>& get_i_ws_op_vector()
-		{
-			if (_i_ws_op_vector.empty())
-			{
-				/* initialize and merge */
-				_i_ws_op_vector = lorraine_lexer_gearbox::combine_wstring_vector(
-					lorraine_lexer_gearbox::get_whitespace_vector(), gearbox.lang_operators_wstring);
-			}
-			return _i_ws_op_vector;
-		}
 	public:
-		std::map<lorraine::qint, std::pair<lorraine::qint, lorraine::qint>> line_map;
+		std::vector<lorraine::qint> line_starts;	/* line n starts at line_starts[n - 1] */
 		std::vector<lorraine_lexer_singlet> singlets;
-		lorraine_lexer_gearbox gearbox;
 		std::wstring_view lexer_input;
-		lorraine::qint lexer_needle;
+		lorraine::qint lexer_needle{};
+		lorraine::uint lexer_line = 1;
 
 		using size_type = std::wstring::size_type;
 
-		lorraine::qint get_line_for_char_position(lorraine::qint char_position)
+		lorraine::qint get_line_for_char_position(lorraine::qint char_position) const
 		{
-			for (auto& [lineno, range_pair] : line_map)
-			{
-				if (char_position >= range_pair.first && char_position <= range_pair.second)
-					return lineno;
-			}
-			return 0;
+			const auto it = std::upper_bound(line_starts.begin(), line_starts.end(), char_position);
+			return static_cast<lorraine::qint>(std::distance(line_starts.begin(), it));
 		}
 
 		wchar_t read_needle() const
@@ -326,206 +310,23 @@ namespace lorraine
 			return lexer_input.at(static_cast<size_type>(lexer_needle));
 		}
 
-		lorraine::qint position_of_next(wchar_t tk) const
-		{
-			auto needle = static_cast<size_type>(lexer_needle);
-			auto view_size = lexer_input.size();
-			while (needle <= view_size && lexer_input[needle] != tk)
-				needle++;
-			return needle >= view_size ? 0 : needle;
-		}
-
-		lorraine::qint position_of_next(const std::wstring& tk) const
-		{
-			auto needle = static_cast<size_type>(lexer_needle);
-			auto view_size = lexer_input.size();
-			while (needle <= view_size && lexer_input.substr(needle, tk.length()) != tk)
-				needle++;
-			return needle >= view_size ? 0 : needle;
-		}
-
-		lorraine::qint position_of_next(const std::vector<std::wstring>& vector) const
-		{
-			auto needle = static_cast<size_type>(lexer_needle);
-			auto view_size = lexer_input.size();
-			while (needle <= view_size)
-			{
-				for (auto& ref : vector)
-					if (lexer_input.substr(needle, ref.length()) == ref)
-						return needle;
-				needle++;
-			}
-			return 0;
-		}
-
-		lorraine::qint position_of_next_char_in_range(const std::pair<wchar_t, wchar_t>& range) const
-		{
-			auto needle = static_cast<size_type>(lexer_needle);
-			auto view_size = lexer_input.size();
-			while (needle <= view_size && (lexer_input[needle] >= range.first && lexer_input[needle] <= range.first))
-				needle++;
-			return needle >= view_size ? 0 : needle;
-		}
-
-		lorraine::qint position_of_next_char_not_in_range(const std::pair<wchar_t, wchar_t>& range) const
-		{
-			auto needle = static_cast<size_type>(lexer_needle);
-			auto view_size = lexer_input.size();
-			while (needle <= view_size && (lexer_input[needle] < range.first || lexer_input[needle] > range.first))
-				needle++;
-			return needle >= view_size ? 0 : needle;
-		}
-
-		lorraine::qint position_of_next_char_above(const wchar_t above_char) const
-		{
-			auto needle = static_cast<size_type>(lexer_needle);
-			auto view_size = lexer_input.size();
-			while (needle <= view_size && lexer_input[needle] > above_char)
-				needle++;
-			return needle >= view_size ? 0 : needle;
-		}
-
-		lorraine::qint position_of_next_below(const wchar_t below_char) const
-		{
-			auto needle = static_cast<size_type>(lexer_needle);
-			auto view_size = lexer_input.size();
-			while (needle <= view_size && lexer_input[needle] < below_char)
-				needle++;
-			return needle >= view_size ? 0 : needle;
-		}
-
-		lorraine_lexer_singlet read_word()
-		{
-			lorraine_lexer_singlet singlet;
-			auto init_position = static_cast<size_type>(lexer_needle);
-			auto next_position = static_cast<size_type>(position_of_next(get_i_ws_op_vector()));
-			if (next_position != 0)
-			{
-				std::wstring_view name_string = lexer_input.substr(init_position, next_position - 1);
-				std::wstring rname_string(name_string.begin(), name_string.end());
-				singlet.tt = llex_name;
-				singlet.v = rname_string;
-				lexer_needle = next_position;
-				return singlet;
-			}
-
-			throw std::exception("not word"); /* to-do: more descriptive error messages */
-		}
-
-		lorraine_lexer_singlet read_number()
-		{
-			lorraine_lexer_singlet singlet;
-			auto init_position = static_cast<size_type>(lexer_needle);
-			auto next_position = static_cast<size_type>(position_of_next(get_i_ws_op_vector()));
-			if (next_position != 0)
-			{
-				std::wstring_view number_string = lexer_input.substr(init_position, next_position - 1);
-				std::wstring rnumber_string(number_string.begin(), number_string.end());
-				if (lorraine_lexer_gearbox::is_hexadecimal_number(rnumber_string))
-				{
-					singlet.tt = llex_number;
-					singlet.v = lorraine_lexer_gearbox::hexadecimal_numstring_to_double(rnumber_string);
-					lexer_needle = next_position;
-					return singlet;
-				}
-				if (lorraine_lexer_gearbox::is_number(rnumber_string))
-				{
-					singlet.tt = llex_number;
-					singlet.v = lorraine_lexer_gearbox::numstring_to_double(rnumber_string);
-					lexer_needle = next_position;
-					return singlet;
-				}
-			}
-
-			throw std::exception("not number");
-		}
-
-		lorraine_lexer_singlet read_keyword()
-		{
-			lorraine_lexer_singlet singlet;
-			auto init_position = static_cast<size_type>(lexer_needle);
-			auto next_position = static_cast<size_type>(position_of_next(get_i_ws_op_vector()));
-			if (next_position != 0)
-			{
-				std::wstring_view keyword_string = lexer_input.substr(init_position, next_position - 1);
-				std::wstring rkeyword_string(keyword_string.begin(), keyword_string.end());
-				for (auto& tk_ref : gearbox.lang_keywords)
-				{
-					if (tk_ref == rkeyword_string)
-					{
-						singlet.tt = llex_keyword;
-						singlet.v = tk_ref;
-						lexer_needle = next_position;
-						return singlet;
-					}
-				}
-			}
-
-			throw std::exception("not keyword");
-		}
-
-		lorraine_lexer_singlet read_operator()
-		{
-			lorraine_lexer_singlet singlet;
-			auto init_position = static_cast<size_type>(lexer_needle);
-			auto next_position = static_cast<size_type>(position_of_next_char_not_in_range(std::make_pair(0x21, 0x30)));
-			if (next_position != 0)
-			{
-				std::wstring_view operator_string = lexer_input.substr(init_position, next_position - 1);
-				std::wstring roperator_string(operator_string.begin(), operator_string.end());
-				for (auto& tk_ref : gearbox.lang_operators)
-				{
-					if (tk_ref == roperator_string)
-					{
-						singlet.tt = llex_keyword;
-						singlet.v = tk_ref;
-						lexer_needle = next_position;
-						return singlet;
-					}
-				}
-			}
-
-			throw std::exception("not operator");
-		}
+		bool pass();
 
-		bool skip_whitespace_if_exists()
+	private:
+		wchar_t peek(size_type ahead = 0) const
 		{
-			if (!lorraine_lexer_gearbox::is_whitespace(read_needle()))
-				return false;
-			while (lorraine_lexer_gearbox::is_whitespace(read_needle()))
-				lexer_needle++;
-			return true;
+			const auto at = static_cast<size_type>(lexer_needle) + ahead;
+			return at < lexer_input.size() ? lexer_input[at] : L'\0';
 		}
 
-		lorraine_lexer_singlet_type get_type() const
-		{
-			/* to-do: implement */
-			return llex_keyword;
-		}
+		void read_newline();
+		void skip_whitespace_and_comments();
+		int long_bracket_level() const;
+		std::wstring_view read_long_bracket(int level);
 
-		bool pass()
-		{
-			const auto i_size = lexer_input.size();
-			while (lexer_needle < i_size)
-			{
-				skip_whitespace_if_exists();
-				switch (get_type())
-				{
-					case llex_none:
-						throw std::exception("attempt to pass llex_none");
-					case llex_name:
-						singlets.push_back(read_word()); break;
-					case llex_number:
-						singlets.push_back(read_number()); break;
-					case llex_keyword:
-						singlets.push_back(read_keyword()); break;
-					case llex_operator:
-						singlets.push_back(read_operator()); break;
-					case llex_string:
-						throw std::exception("unimplemented");
-				}
-			}
-			return true;
-		}
+		void read_name();
+		void read_number();
+		void read_string(wchar_t quote);
+		void read_operator();
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,332 @@
+/*
+ *	lorraine  LuaU compiler and analyser, written for Synapse X by Louka & Eternal
+ *	uIR -> Luau lowering, emits Luau instructions and constants straight from u_ir_proto code
+*/
+
+#include "lorraine_ucode.hpp"
+#include "lorraine_uopt.hpp"
+#include "half.hpp"
+
+#include <climits>
+#include <cstring>
+
+struct i_lorraine_emit_state
+{
+	lorraine::u_luau_proto& out;
+	lorraine::uint top;		/* slots below are live uIR values */
+	lorraine::uint dirty;	/* registers below may hold values from before a UIR_SHRINK */
+	bool returned;			/* the last lowered instruction was a RETURN */
+};
+
+static bool i_lorraine_use(i_lorraine_emit_state& s, const lorraine::uint reg)
+{
+	if (reg >= lorraine::u_luau_emitter::max_registers)
+		return false;
+	if (reg + 1 > s.out.maxstacksize)
+		s.out.maxstacksize = static_cast<std::uint8_t>(reg + 1);
+	if (reg + 1 > s.dirty)
+		s.dirty = reg + 1;
+	return true;
+}
+
+static void i_lorraine_abc(i_lorraine_emit_state& s, const lorraine::u_luau_op op, const lorraine::uint a, const lorraine::uint b, const lorraine::uint c)
+{
+	lorraine::u_luau_instruction i{};
+	i.op = op;
+	i.a = static_cast<std::uint8_t>(a);
+	i.b = static_cast<std::uint8_t>(b);
+	i.c = static_cast<std::uint8_t>(c);
+	s.out.code.push_back(i);
+}
+
+static void i_lorraine_abx(i_lorraine_emit_state& s, const lorraine::u_luau_op op, const lorraine::uint a, const lorraine::uint bx)
+{
+	lorraine::u_luau_instruction i{};
+	i.op = op;
+	i.a = static_cast<std::uint8_t>(a);
+	i.bx = static_cast<std::uint16_t>(bx);
+	s.out.code.push_back(i);
+}
+
+/* the word after NEWTABLE, SETLIST and LOADKX */
+static void i_lorraine_aux(i_lorraine_emit_state& s, const std::uint32_t value)
+{
+	lorraine::u_luau_instruction i{};
+	i.value = value;
+	s.out.code.push_back(i);
+}
+
+static lorraine::uint i_lorraine_constant(i_lorraine_emit_state& s, const lorraine::u_luau_constant& k)
+{
+	const auto found = std::find(s.out.k.begin(), s.out.k.end(), k);
+	if (found != s.out.k.end())
+		return static_cast<lorraine::uint>(std::distance(s.out.k.begin(), found));
+
+	s.out.k.push_back(k);
+	return static_cast<lorraine::uint>(s.out.k.size() - 1);
+}
+
+static lorraine::uint i_lorraine_knumber(i_lorraine_emit_state& s, const double n)
+{
+	lorraine::u_luau_constant k;
+	k.tt = lorraine::LK_NUMBER;
+	k.n = n;
+	return i_lorraine_constant(s, k);
+}
+
+static void i_lorraine_loadk(i_lorraine_emit_state& s, const lorraine::uint reg, const lorraine::uint k)
+{
+	if (k <= USHRT_MAX)
+	{
+		i_lorraine_abx(s, lorraine::LOP_LOADK, reg, k);
+		return;
+	}
+	i_lorraine_abc(s, lorraine::LOP_LOADKX, reg, 0, 0);
+	i_lorraine_aux(s, k);
+}
+
+static void i_lorraine_loadnumber(i_lorraine_emit_state& s, const lorraine::uint reg, const double n)
+{
+	/* LOADINT needs no constant, same range the one way translator hands it */
+	if (n > 0 && n < USHRT_MAX && n == static_cast<double>(static_cast<long>(n)))
+	{
+		i_lorraine_abx(s, lorraine::LOP_LOADINT, reg, static_cast<lorraine::uint>(n));
+		return;
+	}
+	i_lorraine_loadk(s, reg, i_lorraine_knumber(s, n));
+}
+
+/* Base[reg] := Base[src] op n, through the K form while the constant index fits C */
+static bool i_lorraine_arithk(i_lorraine_emit_state& s, const lorraine::uint arith, const lorraine::uint reg, const lorraine::uint src, const double n)
+{
+	const auto k = i_lorraine_knumber(s, n);
+	if (k <= UCHAR_MAX)
+	{
+		i_lorraine_abc(s, static_cast<lorraine::u_luau_op>(lorraine::LOP_ADDK + arith), reg, src, k);
+		return true;
+	}
+
+	if (!i_lorraine_use(s, reg + 1))
+		return false;
+	i_lorraine_loadk(s, reg + 1, k);
+	i_lorraine_abc(s, static_cast<lorraine::u_luau_op>(lorraine::LOP_ADD + arith), reg, src, reg + 1);
+	return true;
+}
+
+bool lorraine::u_luau_emitter::emit(const u_ir_proto* p, u_luau_proto& out)
+{
+	out = u_luau_proto{};
+	out.numparams = static_cast<std::uint8_t>(p->arg_size);
+	out.is_vararg = p->is_vararg;
+	out.p.assign(p->proto.begin(), p->proto.end());
+
+	i_lorraine_emit_state s{ out, p->arg_size, p->arg_size, false };
+	if (p->arg_size > max_registers)
+		return false;
+	out.maxstacksize = static_cast<std::uint8_t>(p->arg_size);
+
+	if (p->is_vararg)
+		i_lorraine_abc(s, LOP_INIT2, p->arg_size, 0, 0);
+	else
+		i_lorraine_abc(s, LOP_INIT, 0, 0, 0);
+
+	for (failed_pc = 0; failed_pc < p->code.size(); failed_pc++)
+	{
+		const auto& i = p->code[failed_pc];
+		const auto e = u_ir_effect_of(i);
+		for (const auto r : e.reads)
+			if (r >= 0 && i.ir_indice[r] >= s.top)
+				return false;
+		if (e.write >= 0 && i.ir_indice[e.write] >= s.top)
+			return false;
+
+		s.returned = i.ir_op == UIR_LEAVE || i.ir_op == UIR_RETURN;
+
+		/* pushes write the register just above the live ones */
+		const auto dst = s.top;
+		if (e.push && !i_lorraine_use(s, dst))
+			return false;
+
+		switch (i.ir_op)
+		{
+			case UIR_GROW:
+			{
+				/* fresh registers are nil after INIT, ones a SHRINK gave back still hold their old value */
+				const auto count = static_cast<lorraine::uint>(i.ir_indice[0]) + 1;
+				if (s.top + count > max_registers)
+					return false;
+				for (auto r = s.top; r < s.top + count && r < s.dirty; r++)
+					i_lorraine_abc(s, LOP_LOADNIL, r, 0, 0);
+				if (s.top + count > out.maxstacksize)
+					out.maxstacksize = static_cast<std::uint8_t>(s.top + count);
+				s.top += count;
+				if (s.top > s.dirty)
+					s.dirty = s.top;
+				continue;
+			}
+			case UIR_SHRINK:
+				if (i.ir_indice[0] > s.top)
+					return false;
+				s.top -= i.ir_indice[0];
+				continue;
+			case UIR_DELETE:
+				i_lorraine_abc(s, LOP_LOADNIL, i.ir_indice[0], 0, 0);
+				break;
+			case UIR_DELETER:
+			case UIR_ZCONSTR:
+				if (i.ir_indice[1] >= s.top || i.ir_indice[0] > i.ir_indice[1])
+					return false;
+				/* Luau's LOADNIL only clears one register */
+				for (lorraine::uint r = i.ir_indice[0]; r <= i.ir_indice[1]; r++)
+					i_lorraine_abc(s, LOP_LOADNIL, r, 0, 0);
+				break;
+			case UIR_MOVE:
+				if (i.ir_indice[0] != i.ir_indice[1])
+					i_lorraine_abx(s, LOP_MOVE, i.ir_indice[1], i.ir_indice[0]);
+				break;
+			case UIR_XCHG:
+				if (i.ir_indice[0] >= s.top || i.ir_indice[1] >= s.top)
+					return false;
+				if (i.ir_indice[0] == i.ir_indice[1])
+					break;
+				if (!i_lorraine_use(s, s.top))
+					return false;
+				i_lorraine_abx(s, LOP_MOVE, s.top, i.ir_indice[0]);
+				i_lorraine_abx(s, LOP_MOVE, i.ir_indice[0], i.ir_indice[1]);
+				i_lorraine_abx(s, LOP_MOVE, i.ir_indice[1], s.top);
+				break;
+			case UIR_ZCONST:
+				i_lorraine_abc(s, LOP_LOADNIL, dst, 0, 0);
+				break;
+			case UIR_ICONST:
+			{
+				lorraine::sint n = 0;
+				memcpy(&n, i.ir_indice, sizeof(i.ir_indice));
+				i_lorraine_loadnumber(s, dst, static_cast<double>(n));
+				break;
+			}
+			case UIR_FCONST:
+			{
+				float f;
+				memcpy(&f, i.ir_indice, sizeof(f));
+				i_lorraine_loadnumber(s, dst, f);
+				break;
+			}
+			case UIR_BCONST:
+				i_lorraine_abc(s, LOP_LOADBOOL, dst, i.ir_indice[0] != 0, 0);
+				break;
+			case UIR_COLLECTION:
+				i_lorraine_abc(s, LOP_NEWTABLE, dst, 0, 0);
+				i_lorraine_aux(s, 0);
+				break;
+			case UIR_COL_ARRAY:
+			{
+				/* sized up front and filled in one SETLIST, Lua 5.1 can't preallocate the array part like this */
+				const lorraine::uint bot = i.ir_indice[0];
+				const lorraine::uint count = i.ir_indice[1] >= bot ? i.ir_indice[1] - bot + 1 : 0;
+				if (i.ir_indice[1] >= s.top || count == 0 || count + 1 > UCHAR_MAX)
+					return false;
+				i_lorraine_abc(s, LOP_NEWTABLE, dst, 0, 0);
+				i_lorraine_aux(s, count);
+				i_lorraine_abc(s, LOP_SETLIST, dst, bot, count + 1);
+				i_lorraine_aux(s, 1);
+				break;
+			}
+			case UIR_COUNT:
+			case UIR_STR_LENGTH:
+				i_lorraine_abc(s, LOP_LEN, dst, i.ir_indice[0], 0);
+				break;
+			case UIR_STRINGZ:
+			case UIR_STRINGR:
+			{
+				u_luau_constant k;
+				k.tt = LK_STRING;
+				if (i.ir_op == UIR_STRINGR)
+				{
+					if (i.ir_indice[0] >= p->store.size())
+						return false;
+					k.str = p->store[i.ir_indice[0]];
+				}
+				i_lorraine_loadk(s, dst, i_lorraine_constant(s, k));
+				break;
+			}
+			case UIR_STR_CONCAT:
+			{
+				/* CONCAT takes a register range, operands that already sit next to each other are used in place */
+				const lorraine::uint left = i.ir_indice[1], right = i.ir_indice[0];
+				if (right == left + 1)
+				{
+					i_lorraine_abc(s, LOP_CONCAT, dst, left, right);
+					break;
+				}
+				if (!i_lorraine_use(s, dst + 1))
+					return false;
+				i_lorraine_abx(s, LOP_MOVE, dst, left);
+				i_lorraine_abx(s, LOP_MOVE, dst + 1, right);
+				i_lorraine_abc(s, LOP_CONCAT, dst, dst, dst + 1);
+				break;
+			}
+			case UIR_ARADD:
+			case UIR_ARSUB:
+			case UIR_ARMUL:
+			case UIR_ARDIV:
+			case UIR_ARMOD:
+			case UIR_ARPOW:
+				i_lorraine_abc(s, static_cast<u_luau_op>(LOP_ADD + (i.ir_op - UIR_ARADD)), dst, i.ir_indice[0], i.ir_indice[1]);
+				break;
+			case UIR_HFADDC:
+			case UIR_HFSUBC:
+			case UIR_HFMULC:
+			case UIR_HFDIVC:
+			case UIR_HFMODC:
+			case UIR_HFPOWC:
+			{
+				const auto bits = static_cast<unsigned>(i.ir_indice[2]) << 8 | i.ir_indice[1];
+				if (!i_lorraine_arithk(s, i.ir_op - UIR_HFADDC, dst, i.ir_indice[0], half_float::detail::half2float<double>(bits)))
+					return false;
+				break;
+			}
+			case UIR_FCALL:
+				if (i.ir_indice[0] >= s.top)
+					return false;
+				i_lorraine_abc(s, LOP_CALL, i.ir_indice[0], 1, 1);
+				break;
+			case UIR_LEAVE:
+				i_lorraine_abc(s, LOP_RETURN, 0, 1, 0);
+				break;
+			case UIR_RETURN:
+				/* everything from the first slot up to the top is returned */
+				i_lorraine_abc(s, LOP_RETURN, 0, s.top + 1, 0);
+				break;
+			default:
+				if (i.ir_op >= UIR_IADD8C && i.ir_op <= UIR_IPOW24C)
+				{
+					/* Lua numbers are doubles, the integer forms only exist so the tracer can reason about them */
+					if (!i_lorraine_arithk(s, (i.ir_op - UIR_IADD8C) / 3, dst, i.ir_indice[0], static_cast<double>(u_ir_immediate(i))))
+						return false;
+					break;
+				}
+
+				/* ranges, varargs, unpacking and calls with operands aren't lowered yet */
+				return false;
+		}
+
+		if (e.push)
+			s.top++;
+	}
+
+	/* falling off the end of a function returns nothing */
+	if (!s.returned)
+		i_lorraine_abc(s, LOP_RETURN, 0, 1, 0);
+	return true;
+}
+
+bool lorraine::u_luau_emitter::emit(std::vector<u_luau_proto>& out)
+{
+	out.clear();
+	out.resize(ir->ir_proto.size());
+	for (size_t at = 0; at < out.size(); at++)
+		if (!emit(ir->ir_proto[at], out[at]))
+			return false;
+	return true;
+}
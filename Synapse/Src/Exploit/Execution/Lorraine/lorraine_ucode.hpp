@@ -0,0 +1,160 @@
+/*
+ *	lorraine  LuaU compiler and analyser, written for Synapse X by Louka & Eternal
+ *	uIR -> Luau lowering, emits Luau instructions and constants straight from u_ir_proto code
+*/
+
+#pragma once
+
+#include "lorraine_uir.hpp"
+
+#include <cstdint>
+
+namespace lorraine
+{
+	/* same order and operands as syn::LuauOp (RbxLuauConversion.cpp), opcodes are emitted unscaled,
+	 * whoever installs the proto multiplies them by LuaU_MagicMul like LuauInstruction::SetOpCode does */
+	enum u_luau_op : std::uint8_t
+	{
+		LOP_NOOP,
+		LOP_EXIT,
+		LOP_LOADNIL,		/* A	Base[A] := nil */
+		LOP_LOADBOOL,		/* ABC	Base[A] := (bool)B; Pc += C */
+		LOP_LOADINT,		/* ABx	Base[A] := (double)Bx */
+		LOP_LOADK,			/* ABx	Base[A] := K[Bx] */
+		LOP_MOVE,			/* ABx	Base[A] := Base[Bx] */
+		LOP_GETENV,
+		LOP_SETENV,
+		LOP_GETUPVAL,
+		LOP_SETUPVAL,
+		LOP_CLOSE,
+		LOP_GETENVM,
+		LOP_GETTABLE,
+		LOP_SETTABLEV,
+		LOP_GETTABLEK,
+		LOP_SETTABLEK,
+		LOP_GETTABLEN,
+		LOP_SETTABLEN,
+		LOP_CLOSURE,
+		LOP_SELF,
+		LOP_CALL,			/* ABC	Base[A](Base[A+1] ... Base[A+B-1]), C-1 results */
+		LOP_RETURN,			/* AB	return Base[A] ... Base[A+B-2] */
+		LOP_JMP,
+		LOP_JMPH,
+		LOP_TEST0,
+		LOP_TEST1,
+		LOP_EQ,
+		LOP_LE,
+		LOP_LT,
+		LOP_NEQ,
+		LOP_GT,
+		LOP_GE,
+		LOP_ADD,			/* ABC	Base[A] := Base[B] + Base[C] */
+		LOP_SUB,
+		LOP_MUL,
+		LOP_DIV,
+		LOP_MOD,
+		LOP_POW,
+		LOP_ADDK,			/* ABC	Base[A] := Base[B] + K[C] */
+		LOP_SUBK,
+		LOP_MULK,
+		LOP_DIVK,
+		LOP_MODK,
+		LOP_POWK,
+		LOP_TESTSETAND,
+		LOP_TESTSETOR,
+		LOP_TESTSETANDK,
+		LOP_TESTSETORK,
+		LOP_CONCAT,			/* ABC	Base[A] := Base[B] .. ... .. Base[C] */
+		LOP_NOT,
+		LOP_UNM,
+		LOP_LEN,			/* AB	Base[A] := #Base[B] */
+		LOP_NEWTABLE,		/* AB	Base[A] := CreateTable(Size: Pc[1].Value, Hash: B ? 1 << (B - 1) : 0); Pc++ */
+		LOP_LOADTABLE,
+		LOP_SETLIST,		/* ABC	Base[A]{Idx+0} ... Base[A]{Idx+(C-2)} := Base[B+0] ... Base[B+(C-2)]; Pc++ where Idx = Pc[1].Value */
+		LOP_FORPREP,
+		LOP_FORLOOP,
+		LOP_TFORLOOP,
+		LOP_IPAIRSPREP,
+		LOP_IPAIRSLOOP,
+		LOP_PAIRSPREP,
+		LOP_PAIRSLOOP,
+		LOP_VARARG,
+		LOP_INIT,			/* N	Clears the stack frame */
+		LOP_INIT2,			/* A	Clears the stack frame and prepares varargs, A is numparams */
+		LOP_LOADKX,			/* A	Base[A] := K[Pc[1].Value]; Pc++ */
+		LOP_JMPHX
+	};
+
+#pragma pack(push, 1)
+	union u_luau_instruction
+	{
+		struct
+		{
+			std::uint8_t op;
+			std::uint8_t a;
+			union
+			{
+				struct
+				{
+					std::uint8_t b;
+					std::uint8_t c;
+				};
+				std::uint16_t bx;
+				std::int16_t sbx;
+			};
+		};
+		std::uint32_t value;
+	};
+	static_assert(sizeof(u_luau_instruction) == sizeof(std::uint32_t), "u_luau_instruction size mismatch");
+#pragma pack(pop)
+
+	enum u_luau_constant_type
+	{
+		LK_NIL,
+		LK_BOOLEAN,
+		LK_NUMBER,
+		LK_STRING
+	};
+
+	struct u_luau_constant
+	{
+		u_luau_constant_type tt = LK_NIL;
+		double n = 0;
+		u_ir_string str = 0;	/* into the u_ir string pool, turned into a TString when installed */
+		bool b = false;
+
+		bool operator==(const u_luau_constant& other) const
+		{
+			return tt == other.tt && n == other.n && str == other.str && b == other.b;
+		}
+	};
+
+	struct u_luau_proto
+	{
+		std::vector<u_luau_instruction> code;
+		std::vector<u_luau_constant> k;
+		std::vector<u_ir_proto_handle> p;
+		std::uint8_t numparams = 0;
+		std::uint8_t maxstacksize = 0;
+		bool is_vararg = false;
+	};
+
+	/* lowers uIR straight to Luau. uIR slots are Luau registers, pushes land on the current top and
+	 * the registers above it are scratch, so the only moves emitted are the ones CONCAT and XCHG need */
+	class u_luau_emitter final
+	{
+	public:
+		lorraine::u_ir* ir;
+
+		/* Luau register operands are a byte, R255 is kept free the way the one way translator keeps R254 */
+		static constexpr lorraine::uint max_registers = 255;
+
+		/* pc of the uIR instruction emit() gave up on, the caller falls back to the vanilla compiler */
+		lorraine::uint failed_pc = 0;
+
+		bool emit(const u_ir_proto* p, u_luau_proto& out);
+
+		/* out[i] is the lowering of ir_proto[i] */
+		bool emit(std::vector<u_luau_proto>& out);
+	};
+}
@@ -133,8 +133,6 @@ __forceinline bool i_lorraine_delete(lorraine::u_ir_trace_var* v)
 {
 	if (v->tt == lorraine::IR_TCOLLECTION)
 		delete v->v.get<lorraine::u_ir_trace_collection>();
-	if (v->tt == lorraine::IR_TSTRING)
-		v->v.i.str.erase();
 	*v = lorraine::u_ir_trace_var(lorraine::IR_TNULL);
 	return true;
 }
@@ -221,7 +219,7 @@ bool lorraine::u_ir_tracer::pass(u_ir_proto* p)
 			case UIR_ICONST:
 			{
 				u_ir_trace_var integer(IR_TINTEGER);
-				integer.v.i.n = reinterpret_cast<long>(i.ir_indice);
+				integer.v.i.n = *reinterpret_cast<long*>(&i.ir_indice);
 				t_stack.push_back(integer);
 				break;
 			}
@@ -306,7 +304,7 @@ bool lorraine::u_ir_tracer::pass(u_ir_proto* p)
 			case UIR_STRINGZ:
 			{
 				u_ir_trace_var str(IR_TSTRING);
-				str.v.i.str = std::wstring(); /* just in case */
+				str.v.i.str = 0; /* always the empty string */
 				t_stack.push_back(str);
 				break;
 			}
@@ -324,23 +322,24 @@ bool lorraine::u_ir_tracer::pass(u_ir_proto* p)
 				if (a.tt == IR_TSTRING)
 				{
 					u_ir_trace_var concat(IR_TSTRING);
-					std::wstring concat_b;
+					std::string concat_b;
 					switch (b.tt)
 					{
 						case IR_TINTEGER: 
-							concat_b = std::to_wstring(b.v.i.n);
+							concat_b = std::to_string(b.v.i.n);
 							break;
 						case IR_TFLOAT:
-							concat_b = std::to_wstring(b.v.i.f);
+							concat_b = std::to_string(b.v.i.f);
 							break;
 						case IR_TDOUBLE:
-							concat_b = std::to_wstring(b.v.i.d);
+							concat_b = std::to_string(b.v.i.d);
 							break;
 						case IR_TSTRING:
-							concat_b = b.v.i.str;
+							concat_b = ir->ir_strings.get(b.v.i.str);
+							break;
 						default: throw std::exception("attempt to concatenate non convertable value");
 					}
-					concat.v.i.str = a.v.i.str + concat_b;
+					concat.v.i.str = ir->ir_strings.intern(std::string(ir->ir_strings.get(a.v.i.str)) + concat_b);
 					t_stack.push_back(concat);
 				}
 				else
@@ -348,6 +347,7 @@ bool lorraine::u_ir_tracer::pass(u_ir_proto* p)
 					/* no, this doesn't account for metamethods since its an optimization */
 					throw std::exception("attempt to obtain sub string of invalid type");
 				}
+				break;
 			}
 			case UIR_STR_SUBSTR:
 			{
@@ -355,7 +355,7 @@ bool lorraine::u_ir_tracer::pass(u_ir_proto* p)
 				if (str.tt == IR_TSTRING)
 				{
 					u_ir_trace_var substr(IR_TSTRING);
-					substr.v.i.str = str.v.i.str.substr(i.ir_indice[0], i.ir_indice[1]);
+					substr.v.i.str = ir->ir_strings.intern(ir->ir_strings.get(str.v.i.str).substr(i.ir_indice[0], i.ir_indice[1]));
 					t_stack.push_back(substr);
 				}
 				else
@@ -371,7 +371,7 @@ bool lorraine::u_ir_tracer::pass(u_ir_proto* p)
 				if (str.tt == IR_TSTRING)
 				{
 					u_ir_trace_var str_len(IR_TINTEGER);
-					str_len.v.i.n = str.v.i.str.length();
+					str_len.v.i.n = ir->ir_strings.get(str.v.i.str).length();
 					t_stack.push_back(str_len);
 				}
 				else
@@ -398,7 +398,7 @@ bool lorraine::u_ir_tracer::pass(u_ir_proto* p)
 			case UIR_IADD24C:
 			{
 				u_ir_trace_var v = t_stack[i.ir_indice[0]];
-				i_lorraine_op_addi<long>(&v, (i.ir_indice[2] << 16) | (i.ir_indice[1] << 8) | (i.ir_indice[0] << 0));
+				i_lorraine_op_addi<long>(&v, i.ir_indice[3] << 16 | i.ir_indice[2] << 8 | i.ir_indice[1] << 0);
 				t_stack.push_back(v);
 				break;
 			}
@@ -529,6 +529,42 @@ bool lorraine::u_ir_tracer::pass(u_ir_proto* p)
 	}
 }
 
+lorraine::u_ir_string lorraine::u_ir_string_pool::intern(std::wstring_view str)
+{
+	std::string utf8;
+	utf8.reserve(str.size());
+
+	for (std::size_t i = 0; i < str.size(); i++)
+	{
+		unsigned long c = str[i];
+		if (c >= 0xD800 && c <= 0xDBFF && i + 1 < str.size() && str[i + 1] >= 0xDC00 && str[i + 1] <= 0xDFFF)
+			c = 0x10000 + ((c - 0xD800) << 10) + (str[++i] - 0xDC00);
+
+		if (c < 0x80)
+			utf8 += static_cast<char>(c);
+		else if (c < 0x800)
+		{
+			utf8 += static_cast<char>(0xC0 | c >> 6);
+			utf8 += static_cast<char>(0x80 | (c & 0x3F));
+		}
+		else if (c < 0x10000)
+		{
+			utf8 += static_cast<char>(0xE0 | c >> 12);
+			utf8 += static_cast<char>(0x80 | (c >> 6 & 0x3F));
+			utf8 += static_cast<char>(0x80 | (c & 0x3F));
+		}
+		else
+		{
+			utf8 += static_cast<char>(0xF0 | c >> 18);
+			utf8 += static_cast<char>(0x80 | (c >> 12 & 0x3F));
+			utf8 += static_cast<char>(0x80 | (c >> 6 & 0x3F));
+			utf8 += static_cast<char>(0x80 | (c & 0x3F));
+		}
+	}
+
+	return intern(std::string_view(utf8));
+}
+
 bool lorraine::u_ir_tracer::trace()
 {
 	return pass(this->f_first());
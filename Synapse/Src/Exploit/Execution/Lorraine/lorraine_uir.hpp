@@ -8,6 +8,10 @@
 
 #include "lorraine_device.hpp"
 #include "lorraine_across.hpp"
+#include "lorraine_arena.hpp"
+
+#include <string_view>
+#include <unordered_map>
 
 namespace lorraine
 {
@@ -42,7 +46,7 @@ namespace lorraine
 
 		/* STRING CREATION / STRING MANIPULATION */
 		UIR_STRINGZ,	/* PUSH EMPTY STRING	: stack.push(L"") */
-		UIR_STRINGR,	/* PUSH STORED STRING	: stack.push(p.store[op.indice[0]]) */
+		UIR_STRINGR,	/* PUSH STORED STRING	: stack.push(ir.strings[p.store[op.indice[0]]]) */
 		UIR_STR_CONCAT,	/* CONCATENATE STRING	: stack.push(stack[op.indice[1]] + stack[op.indice[0]]) */
 		UIR_STR_SUBSTR,	/* SUB STRING			: stack.push(stack[op.indice[2]]->substr(op.indice[0], op.indice[1])) */
 		UIR_STR_LENGTH,	/* STRING LENGTH		: stack.push(stack[op.indice[0]].length()) */
@@ -97,40 +101,97 @@ namespace lorraine
 		unsigned char ir_indice[4];
 	};
 
+	/* index into u_ir::ir_strings, 0 is always the empty string */
+	using u_ir_string = lorraine::uint;
+
+	/* index into u_ir::ir_proto */
+	using u_ir_proto_handle = lorraine::uint;
+
+	/* interned UTF-8 strings, each distinct string is stored once per compilation */
+	class u_ir_string_pool final
+	{
+	public:
+		explicit u_ir_string_pool(lorraine::arena& a)
+			: sp_arena(a), strings(arena_allocator<std::string_view>(a)),
+			  ids(0, std::hash<std::string_view>(), std::equal_to<std::string_view>(), arena_allocator<std::pair<const std::string_view, u_ir_string>>(a))
+		{
+			intern(std::string_view());
+		}
+
+		u_ir_string intern(std::string_view str)
+		{
+			const auto found = ids.find(str);
+			if (found != ids.end())
+				return found->second;
+
+			const auto data = static_cast<char*>(sp_arena.allocate(str.size() + 1, 1));
+			std::copy(str.begin(), str.end(), data);
+			data[str.size()] = '\0';
+
+			const auto id = static_cast<u_ir_string>(strings.size());
+			strings.emplace_back(data, str.size());
+			ids.emplace(strings.back(), id);
+			return id;
+		}
+
+		/* lexer slices are UTF-16 */
+		u_ir_string intern(std::wstring_view str);
+
+		std::string_view get(u_ir_string id) const
+		{
+			return strings[id];
+		}
+
+		/* lookup without interning, safe to call from many threads while nobody interns */
+		bool find(std::string_view str, u_ir_string& id) const
+		{
+			const auto found = ids.find(str);
+			if (found == ids.end())
+				return false;
+			id = found->second;
+			return true;
+		}
+
+		u_ir_string size() const
+		{
+			return static_cast<u_ir_string>(strings.size());
+		}
+
+	private:
+		lorraine::arena& sp_arena;
+		arena_vector<std::string_view> strings;
+		std::unordered_map<std::string_view, u_ir_string, std::hash<std::string_view>, std::equal_to<std::string_view>,
+			arena_allocator<std::pair<const std::string_view, u_ir_string>>> ids;
+	};
+
 	struct u_ir_node
 	{
-		std::wstring node_name;		/* may be empty in certain cases */
+		u_ir_string node_name;		/* may be empty (0) in certain cases */
 		lorraine::uint node_id;		/* this id is solely useful in the context of a u_ir_proto  */
 	};
 
 	struct u_ir_proto
 	{
-		lorraine::uint unique_id{};				/* unique proto id */
-		std::vector<u_ir_proto*> proto;			/* contains referenced protos */
-		std::vector<u_ir_instruction> code;		/* contains the proto's code under uIR format */
-		std::vector<std::wstring> store;		/* stored cached strings */
+		lorraine::uint unique_id{};				/* unique proto id, also its handle */
+		arena_vector<u_ir_proto_handle> proto;	/* contains referenced protos */
+		arena_vector<u_ir_instruction> code;	/* contains the proto's code under uIR format */
+		arena_vector<u_ir_string> store;		/* strings UIR_STRINGR can push, by single byte index */
 		lorraine::uint node_acc{};				/* node accumulator, keeps track of proto u_ir_nodes (order) */
 		lorraine::uint stack_size{};				/* total_size = stack_size * sizeof(TValue) */
 		lorraine::uint arg_size{};				/* total_size = arg_size * sizeof(TValue) */
 		bool is_vararg{};							/* true if the proto accepts a variadic number of arguments */
 
 		/* VECTORS BELOW MAY BE EMPTY. */
-		std::vector<u_ir_node> stack_variables;	/* contains information related to stack variables */
-		std::vector<u_ir_node> arg_variables;	/* contains information related to arguments */
+		arena_vector<u_ir_node> stack_variables;	/* contains information related to stack variables */
+		arena_vector<u_ir_node> arg_variables;	/* contains information related to arguments */
 
-		u_ir_proto& operator=(const u_ir_proto& other)
-		{
-			unique_id = other.unique_id;
-			proto = other.proto;
-			code = other.code;
-			store = other.store;
-			node_acc = other.node_acc;
-			stack_size = other.stack_size;
-			arg_size = other.arg_size;
-			is_vararg = other.is_vararg;
-			stack_variables = other.stack_variables;
-			arg_variables = other.arg_variables;
-		}
+		explicit u_ir_proto(lorraine::arena& a)
+			: proto(arena_allocator<u_ir_proto_handle>(a)), code(arena_allocator<u_ir_instruction>(a)),
+			  store(arena_allocator<u_ir_string>(a)), stack_variables(arena_allocator<u_ir_node>(a)),
+			  arg_variables(arena_allocator<u_ir_node>(a)) {}
+
+		u_ir_proto(const u_ir_proto&) = delete;
+		u_ir_proto& operator=(const u_ir_proto&) = delete;
 
 		bool operator==(const u_ir_proto& other) const
 		{
@@ -138,25 +199,28 @@ namespace lorraine
 		}
 	};
 
+	/* one per compilation, protos, their code and every string are on ir_arena and freed with it */
 	class u_ir final
 	{
 	public:
-		lorraine::device* ir_device;
-		std::vector<u_ir_proto*> ir_proto;
+		lorraine::arena ir_arena;
+		lorraine::device* ir_device{};
+		u_ir_string_pool ir_strings{ ir_arena };
+		arena_vector<u_ir_proto*> ir_proto{ arena_allocator<u_ir_proto*>(ir_arena) };
+
+		u_ir() = default;
+		u_ir(const u_ir&) = delete;
+		u_ir& operator=(const u_ir&) = delete;
 
 		u_ir_proto* create_proto()
 		{
-			u_ir_proto* p = new u_ir_proto;
+			u_ir_proto* p = ir_arena.create<u_ir_proto>(ir_arena);
 			p->unique_id = ir_proto.size();
-			p->node_acc = 0;
-			p->stack_size = 0;
-			p->arg_size = 0;
-			p->is_vararg = false;
 			ir_proto.push_back(p);
 			return p;
 		}
 
-		u_ir_proto* look_proto(lorraine::uint unique_id)
+		u_ir_proto* look_proto(u_ir_proto_handle unique_id)
 		{
 			if (unique_id >= ir_proto.size())
 				return nullptr;
@@ -179,13 +243,7 @@ namespace lorraine
 		IR_TOTHER
 	};
 
-	/* i officially declare that C++ is cancer. i spent 30 minutes rewriting this bitch ass
-	 * u_ir_trace_varunion (and almost converted it into a _class_ for convenience) because
-	 * C++ couldn't figure out a way to properly copy unions. the solution, in the end, was
-	 * to define operator= inside of u_ir_proto, which intellisense nor resharper EVER told
-	 * me was the issue here, and creating a constructor that accepted a const ref to such
-	 * a case (copying protos). im DONE BEYOND REALITY.
-	 */
+	/* strings and functions are handles into the u_ir, so every member is trivially copyable */
 	union u_ir_trace_varunion
 	{
 		bool b;
@@ -193,29 +251,8 @@ namespace lorraine
 		long n;
 		float f;
 		double d;
-		std::wstring str;
-		u_ir_proto fn;
-		
-		u_ir_trace_varunion operator=(const u_ir_trace_varunion& other)
-		{
-			*this = u_ir_trace_varunion(other);
-			return *this;
-		}
-
-		u_ir_trace_varunion(const u_ir_trace_varunion& other)
-		{
-			fn = other.fn;
-		}
-
-		u_ir_trace_varunion()
-		{
-			b = false;
-		}
-
-		~u_ir_trace_varunion()
-		{
-			
-		}
+		u_ir_string str;
+		u_ir_proto_handle fn;
 	};
 
 	class u_ir_trace_vardt
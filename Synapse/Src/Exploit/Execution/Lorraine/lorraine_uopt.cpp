@@ -0,0 +1,621 @@
+/*
+ *	lorraine  LuaU compiler and analyser, written for Synapse X by Louka & Eternal
+ *	uIR optimizer, type inference / constant folding / copy propagation / dead store elimination over u_ir_proto code
+*/
+
+#include "lorraine_uopt.hpp"
+#include "../../../Utilities/ThreadPool.hpp"
+
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+lorraine::u_ir_opt_effect lorraine::u_ir_effect_of(const u_ir_instruction& i)
+{
+	u_ir_opt_effect e{};
+	switch (i.ir_op)
+	{
+		case UIR_GROW:
+		case UIR_SHRINK:
+			e.resizes = true;
+			break;
+		case UIR_DELETE:
+			e.write = 0;
+			break;
+		case UIR_MOVE:
+			e.reads[0] = 0;
+			e.write = 1;
+			break;
+		case UIR_ZCONST:
+		case UIR_ICONST:
+		case UIR_FCONST:
+		case UIR_BCONST:
+		case UIR_COLLECTION:
+		case UIR_COL_RANGE:
+		case UIR_STRINGZ:
+		case UIR_STRINGR:
+			e.push = true;
+			break;
+		case UIR_COL_ARRAY:
+		case UIR_COL_TABLE:
+			e.push = true;
+			e.reads_all = true;
+			break;
+		case UIR_COUNT:
+		case UIR_STR_LENGTH:
+			e.push = true;
+			e.reads[0] = 0;
+			break;
+		case UIR_STR_CONCAT:
+			e.push = true;
+			e.reads[0] = 0;
+			e.reads[1] = 1;
+			break;
+		case UIR_STR_SUBSTR:
+			e.push = true;
+			e.reads[0] = 2;
+			break;
+		case UIR_ARADD:
+		case UIR_ARSUB:
+		case UIR_ARMUL:
+		case UIR_ARDIV:
+		case UIR_ARMOD:
+		case UIR_ARPOW:
+			e.push = true;
+			e.reads[0] = 0;
+			e.reads[1] = 1;
+			break;
+		default:
+			if (i.ir_op >= UIR_IADD8C && i.ir_op <= UIR_HFPOWC)
+			{
+				e.push = true;
+				e.reads[0] = 0;
+				break;
+			}
+
+			/* ranges, varargs, calls and returns: anything may be read or written */
+			e.reads_all = true;
+			e.clobbers = true;
+			break;
+	}
+	return e;
+}
+
+long lorraine::u_ir_immediate(const u_ir_instruction& i)
+{
+	switch ((i.ir_op - UIR_IADD8C) % 3)
+	{
+		case 0: return static_cast<char>(i.ir_indice[1]);
+		case 1: return static_cast<short>(static_cast<unsigned short>(i.ir_indice[2]) << 8 | i.ir_indice[1]);
+		default: return i.ir_indice[3] << 16 | i.ir_indice[2] << 8 | i.ir_indice[1] << 0;
+	}
+}
+
+bool lorraine::u_ir_encode_immediate(const lorraine::uint group, const lorraine::uint src, const long n, u_ir_instruction& out)
+{
+	out = u_ir_instruction{};
+	out.ir_indice[0] = static_cast<unsigned char>(src);
+	out.ir_indice[1] = static_cast<unsigned char>(n);
+	out.ir_indice[2] = static_cast<unsigned char>(n >> 8);
+	out.ir_indice[3] = static_cast<unsigned char>(n >> 16);
+
+	/* the 24 bit form is unsigned, u_ir_immediate doesn't sign extend it */
+	lorraine::uint form;
+	if (n >= SCHAR_MIN && n <= SCHAR_MAX)
+		form = 0;
+	else if (n >= SHRT_MIN && n <= SHRT_MAX)
+		form = 1;
+	else if (n >= 0 && n <= 0xFFFFFF)
+		form = 2;
+	else
+		return false;
+
+	out.ir_op = static_cast<u_ir_op>(UIR_IADD8C + group * 3 + form);
+	return true;
+}
+
+static lorraine::u_ir_instruction i_lorraine_iconst(const long n)
+{
+	lorraine::u_ir_instruction i{};
+	i.ir_op = lorraine::UIR_ICONST;
+	memcpy(i.ir_indice, &n, sizeof(i.ir_indice));
+	return i;
+}
+
+/* store entry idx, counting the ones added by the passes but not committed yet */
+static bool i_lorraine_store_at(const lorraine::u_ir_proto* p, const lorraine::u_ir_opt_strings& strings, const size_t idx, lorraine::u_ir_string& out)
+{
+	if (idx < p->store.size())
+	{
+		out = p->store[idx];
+		return true;
+	}
+
+	if (idx - p->store.size() < strings.store_adds.size())
+	{
+		out = strings.store_adds[idx - p->store.size()];
+		return true;
+	}
+	return false;
+}
+
+/* returns false if the store is full, stored string indices are a single byte */
+static bool i_lorraine_stringr(const lorraine::u_ir_proto* p, lorraine::u_ir_opt_strings& strings, const lorraine::u_ir_string str, lorraine::u_ir_instruction& out)
+{
+	size_t idx;
+	const auto found = std::find(p->store.begin(), p->store.end(), str);
+	if (found != p->store.end())
+	{
+		idx = std::distance(p->store.begin(), found);
+	}
+	else
+	{
+		const auto added = std::find(strings.store_adds.begin(), strings.store_adds.end(), str);
+		idx = p->store.size() + std::distance(strings.store_adds.begin(), added);
+		if (added == strings.store_adds.end())
+		{
+			if (idx > UCHAR_MAX)
+				return false;
+			strings.store_adds.push_back(str);
+		}
+	}
+
+	out = lorraine::u_ir_instruction{};
+	out.ir_op = lorraine::UIR_STRINGR;
+	out.ir_indice[0] = static_cast<unsigned char>(idx);
+	return true;
+}
+
+/* the emitter lowers these to ADDK..POWK, so fold with lua's number semantics (luai_numdiv, luai_nummod, pow on
+ * doubles) and only keep results that are exact integers in range. 7 / 2, 0 / -1 (-0) or x ^ -1 stay as they are */
+static bool i_lorraine_fold_int(const lorraine::u_ir_op op, const long left, const long right, long& out)
+{
+	const auto a = static_cast<double>(left);
+	const auto b = static_cast<double>(right);
+
+	double r;
+	switch ((op - lorraine::UIR_IADD8C) / 3)
+	{
+		case 0: r = a + b; break;
+		case 1: r = a - b; break;
+		case 2: r = a * b; break;
+		case 3: r = a / b; break;
+		case 4: r = a - std::floor(a / b) * b; break;
+		default: r = std::pow(a, b); break;
+	}
+
+	if (!std::isfinite(r) || r != std::floor(r) || (r == 0 && std::signbit(r)))
+		return false;
+	if (r > static_cast<double>(LONG_MAX) || r < static_cast<double>(LONG_MIN))
+		return false;
+
+	out = static_cast<long>(r);
+	return true;
+}
+
+static bool i_lorraine_is_number(const lorraine::u_ir_trace_vartype tt)
+{
+	return tt == lorraine::IR_TINTEGER || tt == lorraine::IR_TFLOAT || tt == lorraine::IR_TDOUBLE;
+}
+
+/* type of the value i produces given the slot types before it, reads are in range. arithmetic on anything but
+ * proven numbers may go through a metamethod and return anything */
+static lorraine::u_ir_trace_vartype i_lorraine_type_of(const std::vector<lorraine::u_ir_opt_slot>& s, const lorraine::u_ir_instruction& i)
+{
+	using namespace lorraine;
+
+	switch (i.ir_op)
+	{
+		case UIR_DELETE:
+		case UIR_ZCONST:
+			return IR_TNULL;
+		case UIR_ICONST:
+		case UIR_COUNT:
+		case UIR_STR_LENGTH:
+			return IR_TINTEGER;
+		case UIR_FCONST:
+			return IR_TNUMBER;
+		case UIR_BCONST:
+			return IR_TBOOLEAN;
+		case UIR_COLLECTION:
+		case UIR_COL_ARRAY:
+		case UIR_COL_TABLE:
+		case UIR_COL_RANGE:
+			return IR_TCOLLECTION;
+		case UIR_STRINGZ:
+		case UIR_STRINGR:
+		case UIR_STR_CONCAT:
+		case UIR_STR_SUBSTR:
+			return IR_TSTRING;
+		case UIR_MOVE:
+			return s[i.ir_indice[0]].tt;
+		case UIR_ARADD:
+		case UIR_ARSUB:
+		case UIR_ARMUL:
+		{
+			const auto a = s[i.ir_indice[0]].tt, b = s[i.ir_indice[1]].tt;
+			if (a == IR_TINTEGER && b == IR_TINTEGER)
+				return IR_TINTEGER;
+			return i_lorraine_is_number(a) && i_lorraine_is_number(b) ? IR_TNUMBER : IR_TOTHER;
+		}
+		case UIR_ARDIV:
+		case UIR_ARMOD:
+		case UIR_ARPOW:
+			return i_lorraine_is_number(s[i.ir_indice[0]].tt) && i_lorraine_is_number(s[i.ir_indice[1]].tt) ? IR_TNUMBER : IR_TOTHER;
+		default:
+			if (i.ir_op >= UIR_IADD8C && i.ir_op <= UIR_HFPOWC)
+			{
+				const auto a = s[i.ir_indice[0]].tt;
+				if (a == IR_TINTEGER && i.ir_op <= UIR_IMUL24C)
+					return IR_TINTEGER;
+				return i_lorraine_is_number(a) ? IR_TNUMBER : IR_TOTHER;
+			}
+			return IR_TOTHER;
+	}
+}
+
+/* advances the slot model past i, returns false when i names a slot outside of it (the proto is left alone from there) */
+static bool i_lorraine_opt_step(std::vector<lorraine::u_ir_opt_slot>& s, const lorraine::u_ir_proto* p, const lorraine::u_ir_opt_strings& strings, const lorraine::u_ir_instruction& i)
+{
+	using namespace lorraine;
+
+	const auto e = u_ir_effect_of(i);
+	for (const auto r : e.reads)
+		if (r >= 0 && i.ir_indice[r] >= s.size())
+			return false;
+	if (e.write >= 0 && i.ir_indice[e.write] >= s.size())
+		return false;
+
+	const auto drop_copies_from = [&s](const lorraine::uint slot)
+	{
+		for (auto& v : s)
+			if (v.copy_of >= 0 && static_cast<lorraine::uint>(v.copy_of) >= slot)
+				v.copy_of = -1;
+	};
+
+	if (e.resizes)
+	{
+		if (i.ir_op == UIR_GROW)
+		{
+			/* grown slots start out nil, the emitter clears any a SHRINK gave back */
+			u_ir_opt_slot nil{};
+			nil.tt = IR_TNULL;
+			s.resize(s.size() + i.ir_indice[0] + 1, nil);
+			return true;
+		}
+
+		if (i.ir_indice[0] > s.size())
+			return false;
+		s.resize(s.size() - i.ir_indice[0]);
+		drop_copies_from(s.size());
+		return true;
+	}
+
+	if (e.clobbers)
+		for (auto& v : s)
+			v = u_ir_opt_slot{};
+
+	u_ir_opt_slot out{};
+	out.tt = i_lorraine_type_of(s, i);
+	switch (i.ir_op)
+	{
+		case UIR_ICONST:
+			out.kind = OPT_INTEGER;
+			memcpy(&out.n, i.ir_indice, sizeof(i.ir_indice));
+			break;
+		case UIR_STRINGZ:
+			out.kind = OPT_STRING;
+			break;
+		case UIR_STRINGR:
+			if (i_lorraine_store_at(p, strings, i.ir_indice[0], out.str))
+				out.kind = OPT_STRING;
+			break;
+		case UIR_MOVE:
+		{
+			const auto src = i.ir_indice[0];
+			out = s[src];
+			out.copy_of = s[src].copy_of >= 0 ? s[src].copy_of : src;
+			if (out.copy_of == i.ir_indice[1])
+				out.copy_of = -1;
+			break;
+		}
+		default: ;
+	}
+
+	if (e.push)
+	{
+		s.push_back(out);
+	}
+	else if (e.write >= 0)
+	{
+		const auto dst = i.ir_indice[e.write];
+		for (auto& v : s)
+			if (v.copy_of == dst)
+				v.copy_of = -1;
+		s[dst] = out;
+	}
+	return true;
+}
+
+static bool i_lorraine_fold(const lorraine::u_ir_proto* p, lorraine::u_ir_opt_strings& strings, const std::vector<lorraine::u_ir_opt_slot>& s, const lorraine::u_ir_instruction& i, lorraine::u_ir_instruction& out)
+{
+	using namespace lorraine;
+
+	if (i.ir_op >= UIR_IADD8C && i.ir_op <= UIR_IPOW24C)
+	{
+		const auto& v = s[i.ir_indice[0]];
+		long n;
+		if (v.kind != OPT_INTEGER || !i_lorraine_fold_int(i.ir_op, v.n, u_ir_immediate(i), n))
+			return false;
+		out = i_lorraine_iconst(n);
+		return true;
+	}
+
+	switch (i.ir_op)
+	{
+		case UIR_STR_CONCAT:
+		{
+			const auto& a = s[i.ir_indice[1]];
+			const auto& b = s[i.ir_indice[0]];
+			if (a.kind != OPT_STRING || b.kind == OPT_UNKNOWN)
+				return false;
+			const auto concat = std::string(strings.get(a.str)) + (b.kind == OPT_INTEGER ? std::to_string(b.n) : std::string(strings.get(b.str)));
+			return i_lorraine_stringr(p, strings, strings.intern(concat), out);
+		}
+		case UIR_STR_LENGTH:
+		{
+			const auto& a = s[i.ir_indice[0]];
+			if (a.kind != OPT_STRING)
+				return false;
+			out = i_lorraine_iconst(static_cast<long>(strings.get(a.str).length()));
+			return true;
+		}
+		case UIR_STR_SUBSTR:
+		{
+			const auto& a = s[i.ir_indice[2]];
+			if (a.kind != OPT_STRING || i.ir_indice[0] > strings.get(a.str).length())
+				return false;
+			return i_lorraine_stringr(p, strings, strings.intern(strings.get(a.str).substr(i.ir_indice[0], i.ir_indice[1])), out);
+		}
+		default: return false;
+	}
+}
+
+bool lorraine::u_ir_optimizer::fold_constants(u_ir_proto* p, u_ir_opt_strings& strings)
+{
+	std::vector<u_ir_opt_slot> s(p->arg_size);
+	auto changed = false;
+
+	for (auto& i : p->code)
+	{
+		const auto e = u_ir_effect_of(i);
+		auto in_range = true;
+		for (const auto r : e.reads)
+			if (r >= 0 && i.ir_indice[r] >= s.size())
+				in_range = false;
+
+		u_ir_instruction folded;
+		if (in_range && i_lorraine_fold(p, strings, s, i, folded))
+		{
+			/* folded ops push exactly like the op they replace, so slot numbering downstream is unchanged */
+			i = folded;
+			changed = true;
+		}
+
+		if (!i_lorraine_opt_step(s, p, strings, i))
+			break;
+	}
+	return changed;
+}
+
+bool lorraine::u_ir_optimizer::propagate_copies(u_ir_proto* p, const u_ir_opt_strings& strings)
+{
+	std::vector<u_ir_opt_slot> s(p->arg_size);
+	auto changed = false;
+
+	for (auto& i : p->code)
+	{
+		const auto e = u_ir_effect_of(i);
+		for (const auto r : e.reads)
+		{
+			if (r < 0 || i.ir_indice[r] >= s.size())
+				continue;
+
+			const auto from = s[i.ir_indice[r]].copy_of;
+			if (from >= 0)
+			{
+				i.ir_indice[r] = static_cast<unsigned char>(from);
+				changed = true;
+			}
+		}
+
+		if (!i_lorraine_opt_step(s, p, strings, i))
+			break;
+	}
+	return changed;
+}
+
+bool lorraine::u_ir_optimizer::eliminate_dead_stores(u_ir_proto* p)
+{
+	/* compacted in place, the scan for m only looks at instructions after it so nothing it reads is overwritten yet */
+	size_t kept = 0;
+
+	for (size_t m = 0; m < p->code.size(); m++)
+	{
+		const auto i = p->code[m];
+		if (i.ir_op != UIR_MOVE)
+		{
+			p->code[kept++] = i;
+			continue;
+		}
+
+		const auto dst = i.ir_indice[1];
+		auto dead = i.ir_indice[0] == dst;
+
+		/* anything we can't see through keeps the store, running off the end of the proto included */
+		for (auto j = m + 1; !dead && j < p->code.size(); j++)
+		{
+			const auto& n = p->code[j];
+			const auto e = u_ir_effect_of(n);
+			if (e.reads_all || e.resizes)
+				break;
+
+			if ((e.reads[0] >= 0 && n.ir_indice[e.reads[0]] == dst) || (e.reads[1] >= 0 && n.ir_indice[e.reads[1]] == dst))
+				break;
+
+			if (e.write >= 0 && n.ir_indice[e.write] == dst)
+				dead = true;
+		}
+
+		if (!dead)
+			p->code[kept++] = i;
+	}
+
+	if (kept == p->code.size())
+		return false;
+
+	p->code.resize(kept);
+	return true;
+}
+
+bool lorraine::u_ir_optimizer::specialize_numeric(u_ir_proto* p, const u_ir_opt_strings& strings)
+{
+	/* arguments are live from the start, nothing is known about them */
+	std::vector<u_ir_opt_slot> s(p->arg_size);
+	auto changed = false;
+
+	for (auto& i : p->code)
+	{
+		if (i.ir_op >= UIR_ARADD && i.ir_op <= UIR_ARMUL && i.ir_indice[0] < s.size() && i.ir_indice[1] < s.size())
+		{
+			/* only add, sub and mul are specialised. x op k keeps its operand order in the K form, whose metamethod
+			 * fallback matches the register form. k op x would reach the K form as x op k and hand __add / __mul
+			 * (x, k) instead of (k, x), so it is only swapped when x is a proven number and no metamethod can run */
+			const auto group = static_cast<lorraine::uint>(i.ir_op - UIR_ARADD);
+			const auto& a = s[i.ir_indice[0]];
+			const auto& b = s[i.ir_indice[1]];
+
+			u_ir_instruction special;
+			if (b.kind == OPT_INTEGER && u_ir_encode_immediate(group, i.ir_indice[0], b.n, special))
+			{
+				i = special;
+				changed = true;
+			}
+			else if (group != 1 && a.kind == OPT_INTEGER && i_lorraine_is_number(b.tt) && u_ir_encode_immediate(group, i.ir_indice[1], a.n, special))
+			{
+				i = special;
+				changed = true;
+			}
+		}
+
+		if (!i_lorraine_opt_step(s, p, strings, i))
+			break;
+	}
+	return changed;
+}
+
+bool lorraine::u_ir_optimizer::optimize_local(u_ir_proto* p, u_ir_opt_strings& strings)
+{
+	auto changed = false;
+	for (auto round = 0; round < max_rounds; round++)
+	{
+		auto progress = specialize_numeric(p, strings);
+		progress |= fold_constants(p, strings);
+		progress |= propagate_copies(p, strings);
+		progress |= eliminate_dead_stores(p);
+		if (!progress)
+			break;
+		changed = true;
+	}
+	return changed;
+}
+
+void lorraine::u_ir_optimizer::commit(u_ir_proto* p, const u_ir_opt_strings& strings)
+{
+	for (const auto str : strings.store_adds)
+		p->store.push_back(str >= strings.base ? ir->ir_strings.intern(strings.pending[str - strings.base]) : str);
+}
+
+bool lorraine::u_ir_optimizer::optimize(u_ir_proto* p)
+{
+	u_ir_opt_strings strings(ir->ir_strings);
+	const auto changed = optimize_local(p, strings);
+	commit(p, strings);
+	return changed;
+}
+
+bool lorraine::u_ir_optimizer::optimize()
+{
+	auto changed = false;
+	for (auto p : ir->ir_proto)
+		changed |= optimize(p);
+	return changed;
+}
+
+bool lorraine::u_ir_optimizer::optimize_parallel(unsigned workers)
+{
+	const auto count = ir->ir_proto.size();
+	if (workers == 0)
+		workers = std::max(1u, std::thread::hardware_concurrency());
+	if (workers == 1 || count < parallel_threshold)
+		return optimize();
+
+	/* every context snapshots the pool before anyone runs, so ids below base mean the same thing everywhere */
+	std::vector<u_ir_opt_strings> results(count, u_ir_opt_strings(ir->ir_strings));
+	std::vector<char> changed(count);
+
+	/* helpers run on the compile pool and the caller works too, so nothing waits on a helper that never got a
+	 * worker. only helpers that got in before the protos ran out are waited for, a late one finds next past count
+	 * and never touches the vectors above, which is why the shared state outlives this call */
+	struct shared_state
+	{
+		std::atomic<size_t> next{ 0 };
+		std::atomic<unsigned> active{ 0 };
+		std::mutex mutex;
+		std::condition_variable done;
+	};
+	const auto state = std::make_shared<shared_state>();
+
+	/* protos are handed out one at a time, big and small ones balance out on their own */
+	const auto work = [this, count, &results, &changed](shared_state& st)
+	{
+		for (auto at = st.next.fetch_add(1); at < count; at = st.next.fetch_add(1))
+			changed[at] = optimize_local(ir->ir_proto[at], results[at]);
+	};
+
+	for (unsigned t = 1; t < workers; t++)
+	{
+		/* this thread drains the batch too, helpers a saturated pool can't take aren't needed */
+		const auto queued = syn::ThreadPool::GetCompilePool()->TrySubmit([state, work]
+		{
+			state->active.fetch_add(1);
+			work(*state);
+
+			std::lock_guard<std::mutex> lock(state->mutex);
+			state->active.fetch_sub(1);
+			state->done.notify_all();
+		});
+		if (!queued)
+			break;
+	}
+
+	work(*state);
+
+	{
+		std::unique_lock<std::mutex> lock(state->mutex);
+		state->done.wait(lock, [&] { return state->active.load() == 0; });
+	}
+
+	auto any = false;
+	for (size_t at = 0; at < count; at++)
+	{
+		commit(ir->ir_proto[at], results[at]);
+		any |= changed[at] != 0;
+	}
+	return any;
+}
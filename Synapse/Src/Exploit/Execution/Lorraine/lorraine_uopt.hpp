@@ -0,0 +1,117 @@
+
+/*
+ *	lorraine  LuaU compiler and analyser, written for Synapse X by Louka & Eternal
+ *	uIR optimizer, type inference / constant folding / copy propagation / dead store elimination over u_ir_proto code
+*/
+
+#pragma once
+
+#include "lorraine_uir.hpp"
+
+namespace lorraine
+{
+	/* what the optimizer knows about the value held by a stack slot */
+	enum u_ir_opt_kind
+	{
+		OPT_UNKNOWN,
+		OPT_INTEGER,
+		OPT_STRING
+	};
+
+	struct u_ir_opt_slot
+	{
+		u_ir_opt_kind kind = OPT_UNKNOWN;
+		long n = 0;
+		u_ir_string str = 0;
+		lorraine::sint copy_of = -1;	/* slot this one was last UIR_MOVE'd from, -1 if none */
+		u_ir_trace_vartype tt = IR_TOTHER;	/* type the slot is proven to hold at this pc, IR_TOTHER when unproven.
+											 * IR_TINTEGER is a number with an integral value, Lua has no other kind */
+	};
+
+	/* how an instruction touches the stack, as the tracer executes it */
+	struct u_ir_opt_effect
+	{
+		bool push = false;			/* result is pushed into a new top slot */
+		bool reads_all = false;		/* reads a range or more than we model (collections, calls, returns) */
+		bool clobbers = false;		/* writes a range or slots we can't name (moves of ranges, calls) */
+		bool resizes = false;		/* UIR_GROW / UIR_SHRINK */
+		int reads[2] = { -1, -1 };	/* indices of op.indice holding single slot reads, -1 if unused */
+		int write = -1;				/* index of op.indice holding a single slot written in place */
+	};
+
+	u_ir_opt_effect u_ir_effect_of(const u_ir_instruction& i);
+
+	/* constant operand of the IxxxNC family, decoded the way the op documentation spells it */
+	long u_ir_immediate(const u_ir_instruction& i);
+
+	/* the narrowest IxxxNC form of group (0 add, 1 sub, 2 mul ...) holding n, false if none does */
+	bool u_ir_encode_immediate(lorraine::uint group, lorraine::uint src, long n, u_ir_instruction& out);
+
+	/* strings and store entries the passes over one proto create. nothing shared is written while
+	 * passes run, so protos can be optimized concurrently and committed afterwards in proto order */
+	struct u_ir_opt_strings
+	{
+		const u_ir_string_pool* pool;
+		u_ir_string base;						/* ids from here on are pending[id - base] */
+		std::vector<std::string> pending;
+		std::vector<u_ir_string> store_adds;	/* appended to p->store on commit, in order */
+
+		explicit u_ir_opt_strings(const u_ir_string_pool& strings)
+			: pool(&strings), base(strings.size()) {}
+
+		std::string_view get(u_ir_string id) const
+		{
+			return id >= base ? std::string_view(pending[id - base]) : pool->get(id);
+		}
+
+		u_ir_string intern(std::string_view str)
+		{
+			u_ir_string id;
+			if (pool->find(str, id))
+				return id;
+
+			for (size_t i = 0; i < pending.size(); i++)
+				if (pending[i] == str)
+					return base + static_cast<u_ir_string>(i);
+
+			pending.emplace_back(str);
+			return base + static_cast<u_ir_string>(pending.size() - 1);
+		}
+	};
+
+	class u_ir_optimizer final
+	{
+	public:
+		lorraine::u_ir* ir;
+
+		/* maximum rounds of the pass pipeline per proto, each round can expose work for the next */
+		static constexpr int max_rounds = 8;
+
+		/* below this many protos the pool isn't worth starting */
+		static constexpr size_t parallel_threshold = 16;
+
+		/* integer arithmetic on known constants, constant UIR_STR_CONCAT chains, lengths and sub strings */
+		bool fold_constants(u_ir_proto* p, u_ir_opt_strings& strings);
+
+		/* reads of a UIR_MOVE destination are redirected to its source while both are untouched */
+		bool propagate_copies(u_ir_proto* p, const u_ir_opt_strings& strings);
+
+		/* UIR_MOVE into a slot that is overwritten before anything reads it */
+		bool eliminate_dead_stores(u_ir_proto* p);
+
+		/* walks the slot types forward through the proto, ARADD/ARSUB/ARMUL with an operand proven to be an integer
+		 * constant become the IxxxNC forms, which fold_constants can fold and the emitter lowers to the K forms */
+		bool specialize_numeric(u_ir_proto* p, const u_ir_opt_strings& strings);
+
+		/* runs the passes without touching the u_ir, then commit() publishes what they created */
+		bool optimize_local(u_ir_proto* p, u_ir_opt_strings& strings);
+		void commit(u_ir_proto* p, const u_ir_opt_strings& strings);
+
+		bool optimize(u_ir_proto* p);
+		bool optimize();
+
+		/* sibling protos are independent, spread them over workers (0 = one per core).
+		 * the result doesn't depend on scheduling: commits happen in proto index order */
+		bool optimize_parallel(unsigned workers = 0);
+	};
+}
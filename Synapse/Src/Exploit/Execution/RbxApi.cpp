@@ -1,15 +1,23 @@
 #include "./RbxApi.hpp"
 
 #include "../Misc/Profiler.hpp"
+#include "../Misc/Flags.hpp"
+#include "../Misc/FrameStats.hpp"
 #include "../Misc/HttpStatus.hpp"
+#include "../Misc/ScriptStats.hpp"
 
 #include "./Conversion/ObfusDumper.hpp"
 #include "./Conversion/RbxConversion.hpp"
 #include "./Conversion/RbxLuauConversion.hpp"
 
+#include "../../Utilities/Compression.hpp"
+#include "../../Utilities/HttpCache.hpp"
 #include "../../Utilities/MemSpoofer.hpp"
 #include "../../Utilities/Hashing/fnv.hpp"
 #include "../../Utilities/Hashing/sha512.h"
+
+#define XXH_STATIC_LINKING_ONLY
+#include "../../Utilities/Hashing/XXHash/xxhash.h"
 #include "../../Utilities/Obfuscation/ObfuscatedMember.hpp"
 
 #include "../Misc/Resource.hpp"
@@ -24,6 +32,8 @@
 #include <cryptopp/blowfish.h>
 #include <cryptopp/modes.h>
 
+#include <list>
+
 namespace syn 
 {
 	DWORD InitRL = 0;
@@ -110,6 +120,50 @@ namespace syn
 		}
 	}
 
+	/* loadstringasync(source, chunkname), loadstring that compiles on the pool and only commits on the job thread */
+	int RbxApi::loadstringasync(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+        size_t ScriptLength;
+        const char* Source = RL.CheckLString(1, &ScriptLength);
+        std::string ChunkName = RL.OptString(2, ("@" + RandomString(16)).c_str());
+
+		RbxYield RYield(RL);
+		return RYield.Execute([Script = std::string(Source, ScriptLength), ChunkName]() mutable
+		{
+			std::shared_ptr<syn::LuaTranslator::PreparedChunk> Chunk;
+			std::string Error;
+
+			try
+			{
+				Chunk = syn::LuaTranslator::GetSingleton()->PrepareChunk(Script, 0, &ChunkName);
+			}
+			catch (const std::exception& ex)
+			{
+				Error = ex.what();
+			}
+
+			return YieldRetFunc([Chunk, Error](RbxLua NRL)
+			{
+				try
+				{
+					if (!Chunk)
+						throw std::exception(Error.c_str());
+
+					syn::LuaTranslator::GetSingleton()->CommitChunk(NRL, *Chunk);
+					return 1;
+				}
+				catch (const std::exception& ex)
+				{
+					NRL.PushNil();
+					NRL.PushString(ex.what());
+					return 2;
+				}
+			});
+		});
+	}
+
 	int RbxApi::getrawmetatable(DWORD rL)
 	{
 		syn::RbxLua RL(rL);
@@ -223,6 +277,71 @@ namespace syn
 		return 1;
 	}
 
+	int RbxApi::synwait(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+		const auto Seconds = RL.OptNumber(1, 0);
+
+		RbxYield RYield(RL);
+		return RYield.Wait(Seconds);
+	}
+
+	int RbxApi::syndefer(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+		RL.CheckType(1, R_LUA_TFUNCTION);
+
+		/* [thread, f, args...], f and its arguments move over and the thread is returned */
+		const auto Args = RL.GetTop();
+		const auto Thread = RL.NewThread(false);
+		Thread.SetIdentity((BYTE) RL.GetIdentity());
+		RL.Insert(1);
+		RL.XMove(Thread, Args);
+
+		RbxYield::Park(Thread, true);
+		syn::Scheduler::GetSingleton()->After(0, [Thread, Args](DWORD)
+		{
+			RbxYield::Park(Thread, false);
+			RbxYield::Resume(Thread, Args - 1);
+		});
+
+		return 1;
+	}
+
+	int RbxApi::synscriptstats(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		const auto Stats = syn::ScriptStats::GetSingleton();
+		if (!RL.IsNoneOrNil(1))
+			Stats->Enabled = RL.ToBoolean(1);
+
+		const auto Scripts = Stats->Snapshot();
+		RL.CreateTable((int) Scripts.size(), 0);
+
+		int Index = 0;
+		for (const auto& Script : Scripts)
+		{
+			RL.CreateTable(0, 6);
+			RL.PushNumber(Script.Id);
+			RL.SetField(-2, "Id");
+			RL.PushString(Script.Label.c_str());
+			RL.SetField(-2, "Name");
+			RL.PushNumber((double) Script.Resumes);
+			RL.SetField(-2, "Resumes");
+			RL.PushNumber(Script.Micros / 1000000.0);
+			RL.SetField(-2, "Time");
+			RL.PushNumber(Script.PeakMicros / 1000000.0);
+			RL.SetField(-2, "Peak");
+			RL.PushNumber((double) Script.NetBytes);
+			RL.SetField(-2, "Memory");
+
+			RL.RawSetI(-2, ++Index);
+		}
+
+		return 1;
+	}
+
 	int RbxApi::getreg(DWORD rL)
 	{
 		syn::RbxLua RL(rL);
@@ -760,14 +879,7 @@ namespace syn
 		int SizeK;
 		TValue* Constants = syn::LuaTranslator::GetConstantsPointer(RL, -1, SizeK);
 
-		RL.NewTable();
-
-		for (int i = 0; i < SizeK; i++)
-		{
-			RL.PushInteger(i + 1); /* Lua-based indexing */
-			syn::LuaTranslator::CloneConstant(RL, Constants, i);
-			RL.SetTable(-3);
-		}
+		syn::LuaTranslator::CloneConstants(RL, Constants, SizeK);
 
 		return 1;
 	}
@@ -1080,37 +1192,101 @@ namespace syn
 		return 1;
 	}
 
-	int RbxApi::getloadedmodules(DWORD rL)
+	/* Walked by reference. Each module is held by the shared_ptr while it is pushed, so a GC step inside pushinstance
+	   can't take the node we are standing on out of the set */
+	static const std::set<std::weak_ptr<uintptr_t>>& LoadedModuleSet()
 	{
-		syn::RbxLua RL(rL);
-
-		std::vector<std::shared_ptr<uintptr_t>> Instances;
+		return *(std::set<std::weak_ptr<uintptr_t>>*) (syn::Instance::GetScriptContext(syn::DataModel) + 0x124);
+	}
 
+	static void PushLoadedModule(DWORD rL, std::shared_ptr<uintptr_t>& Module)
+	{
 		static DWORD PushF = NULL;
 		if (!PushF) PushF = RbxLua::GetBinValue(FNVA1_CONSTEXPR("pushinstance"));
 
+		((int(__cdecl*)(DWORD, std::shared_ptr<uintptr_t>&))PushF)(rL, Module);
+	}
+
+	int RbxApi::getloadedmodules(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
 		//will NOT work in debug mode due to iterator proxy - "Exception thrown while cleaning up Lua"
 #ifndef _DEBUG
-		const auto LoadedModules = *(std::set<std::weak_ptr<uintptr_t>>*) (syn::Instance(syn::DataModel).GetChildFromClassName("ScriptContext") + 0x124);
+		const auto& LoadedModules = LoadedModuleSet();
+
+		RL.CreateTable((int) LoadedModules.size(), 0);
+
+		auto n = 1;
+		for (const auto& Mod : LoadedModules)
+		{
+			auto Module = Mod.lock();
+			if (!Module) continue;
+
+			PushLoadedModule(rL, Module);
+			RL.RawSetI(-2, n++);
+		}
+#else
+		RL.NewTable();
+#endif
+
+		return 1;
+	}
+
+	/* Sequence number each module got when a scan first saw it. Modules that leave the set are dropped on the next
+	   scan, so an address reused by a new module is reported again */
+	struct LoadedModuleEntry
+	{
+		DWORD Seq;
+		DWORD Generation;
+	};
+
+	static std::unordered_map<uintptr_t*, LoadedModuleEntry> LoadedModuleSeqs;
+	static DWORD LoadedModuleSeq = 0;
+	static DWORD LoadedModuleGeneration = 0;
+
+	/* getloadedmodulessince(token) -> { modules loaded after token }, token
+	   Start with 0 (everything) and pass the returned token next time, only new modules get pushed */
+	int RbxApi::getloadedmodulessince(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
 
-		for (auto Mod : LoadedModules)
-			if (!Mod.expired())
-				Instances.push_back(Mod.lock());
+		const auto Token = (DWORD) RL.OptInteger(1, 0);
+
+#ifndef _DEBUG
+		const auto& LoadedModules = LoadedModuleSet();
+		const auto Generation = ++LoadedModuleGeneration;
 
 		RL.NewTable();
 
-		for (size_t i = 0; i < Instances.size(); i++)
+		auto n = 1;
+		for (const auto& Mod : LoadedModules)
 		{
-			RL.PushInteger(i + 1);
-			((int(__cdecl*)(DWORD, std::shared_ptr<uintptr_t>&))PushF)(rL, Instances[i]);
+			auto Module = Mod.lock();
+			if (!Module) continue;
 
-			RL.SetTable(-3);
+			auto& Entry = LoadedModuleSeqs[Module.get()];
+			if (!Entry.Seq) Entry.Seq = ++LoadedModuleSeq;
+			Entry.Generation = Generation;
+
+			if (Entry.Seq <= Token) continue;
+
+			PushLoadedModule(rL, Module);
+			RL.RawSetI(-2, n++);
+		}
+
+		for (auto It = LoadedModuleSeqs.begin(); It != LoadedModuleSeqs.end();)
+		{
+			if (It->second.Generation != Generation) It = LoadedModuleSeqs.erase(It);
+			else ++It;
 		}
 #else
 		RL.NewTable();
 #endif
 
-		return 1;
+		RL.PushInteger(LoadedModuleSeq);
+
+		return 2;
 	}
 
 	int RbxApi::getgc(DWORD rL)
@@ -1147,2432 +1323,4055 @@ namespace syn
 		return 1;
 	}
 
-	int RbxApi::getsenv(DWORD rL)
+	/* getgciter({ Type = "function" | { types }, Filter = function(obj) -> bool, Max = n }) -> iterator
+	   The generic for keeps the last object on the stack, so it stays alive and the walk can resume from it on a later frame */
+	int RbxApi::getgciter(DWORD rL)
 	{
 		syn::RbxLua RL(rL);
 
-        if (!RL.IsUserData(1) && !checkinstance(RL, 1))
-            return RL.TypeError(1, "Variant<userdata[LocalScript, ModuleScript]>");
-
-		const syn::Instance Inst = DereferenceSmartPointerInstance((DWORD) RL.ToUserData(1));
-        
-        std::string classname = Inst.GetInstanceClassName();
-		if (classname != "LocalScript" && classname != "ModuleScript")
-			return RL.TypeError(1, "Variant<userdata[LocalScript, ModuleScript]> expected");
+		DWORD Mask = 1 << R_LUA_TFUNCTION;
+		auto Max = -1;
 
-		DWORD LS = 0;
+		const auto TypeMask = [&RL](const char* Name) -> DWORD
+		{
+			if (!strcmp(Name, "function")) return 1 << R_LUA_TFUNCTION;
+			if (!strcmp(Name, "table")) return 1 << R_LUA_TTABLE;
+			if (!strcmp(Name, "userdata")) return 1 << R_LUA_TUSERDATA;
+			RL.LError("invalid gc type '%s'", Name);
+			return 0;
+		};
 
-        VM_TIGER_WHITE_START;
+		RL.CreateTable(3, 0);
 
-		if (classname == "ModuleScript")
+		if (RL.IsTable(1))
 		{
-			const auto GlobalState = (DWORD)syn::PointerObfuscation::DeObfuscateGlobalState(RL + L_GS);
-			auto Object = *(GCObject**)(GlobalState + G_ROOTGC);
-
-			while (Object != 0)
+			RL.GetField(1, "Type");
+			if (RL.IsString(-1))
+				Mask = TypeMask(RL.ToString(-1));
+			else if (RL.IsTable(-1))
 			{
-				if (Object->gch.tt == R_LUA_TTHREAD)
+				Mask = 0;
+				for (int i = 1; i <= RL.ObjLen(-1); i++)
 				{
-					RBXExtraSpace* Es = (RBXExtraSpace*)((DWORD)Object - sizeof(RBXExtraSpace));
-					DWORD Scr = Es->ScriptPtr;
-					if (Scr == Inst)
-					{
-						LS = (DWORD) Object;
-						break;
-					}
+					RL.RawGetI(-1, i);
+					if (!RL.IsString(-1))
+						return RL.LError("expected type names in 'Type'");
+					Mask |= TypeMask(RL.ToString(-1));
+					RL.Pop(1);
 				}
-
-				Object = Object->gch.next;
 			}
-		}
-		else
-		{
-			//todo: WTF IS THIS DEFCON
-			if (!*(DWORD*)((DWORD)Inst + 0xEC))
-				return RL.LError("could not get script environment - localscript not running");
-
-			DWORD N = *(DWORD*)((DWORD)Inst + 0xEC);
-			DWORD WTR = *(DWORD*)(N + 4);
-			DWORD LIS = *(DWORD*)(WTR + 20);
-			LS = *(DWORD*)(LIS + 8);
-		}
+			RL.Pop(1);
 
-        VM_TIGER_WHITE_END;
+			RL.GetField(1, "Max");
+			if (RL.IsNumber(-1))
+				Max = (int) RL.ToNumber(-1);
+			RL.Pop(1);
 
-		if (!LS)
-			return RL.LError("could not get script environment");
+			RL.GetField(1, "Filter");
+			if (RL.IsFunction(-1))
+				RL.RawSetI(-2, 2);
+			else
+				RL.Pop(1);
+		}
 
-		syn::RbxLua NRL(LS);
+		RL.PushNumber((double) Mask);
+		RL.RawSetI(-2, 1);
+		RL.PushNumber((double) Max);
+		RL.RawSetI(-2, 3);
 
-		NRL.PushValue(LUA_GLOBALSINDEX);
-		NRL.XMove(RL, 1);
+		RL.PushCFunction(getgciterhandler);
+		RL.Insert(-2);
+		RL.PushNil();
 
-		return 1;
+		return 3;
 	}
 
-	int RbxApi::islclosure(DWORD rL)
+	int RbxApi::getgciterhandler(DWORD rL)
 	{
-		syn::RbxLua RL(rL);
-
-		RL.CheckType(1, R_LUA_TFUNCTION);
+		const syn::RbxLua RL(rL);
 
-		RL.PushBoolean(!RL.IsCFunction(1));
+		RL.RawGetI(1, 3);
+		const auto Remaining = (int) RL.ToNumber(-1);
+		RL.RawGetI(1, 1);
+		const auto Mask = (DWORD) RL.ToNumber(-1);
+		RL.RawGetI(1, 2);
+		const auto HasFilter = RL.IsFunction(-1);
+		RL.Pop(3);
 
-		return 1;
-	}
+		if (Remaining == 0)
+			return 0;
 
-	int RbxApi::issynfunc(DWORD rL)
-	{
-		syn::RbxLua RL(rL);
+		const auto GlobalState = (DWORD) syn::PointerObfuscation::DeObfuscateGlobalState(RL + L_GS);
+		const auto DeadMask = *(BYTE*)(GlobalState + G_WMASK) ^ 3;
 
-		RL.CheckType(1, R_LUA_TFUNCTION);
-        RL.CheckType(1, R_LUA_TFUNCTION);
+		auto Object = RL.IsNil(2) ? *(GCObject**)(GlobalState + G_ROOTGC) : RL.Index2Adr(2)->value.gc->gch.next;
 
-		if (RL.IsCFunction(1))
+		for (; Object != nullptr; Object = Object->gch.next)
 		{
-			static DWORD CraInvoke = NULL;
-			if (!CraInvoke) CraInvoke = syn::RobloxBase(OBFUSCATED_NUM(syn::CallCheck::CallcheckAddress));
+			const auto TT = *(BYTE*)((DWORD) Object + GCO_TT);
 
-			const auto CheckClosure = (CClosure*)RL.ToPointer(1);
-			const auto CheckCFunction = syn::PointerObfuscation::DeObfuscateCClosure((DWORD)CheckClosure + 20);
-			RL.PushBoolean(CheckCFunction == CraInvoke);
+			if (!(Mask & (1 << TT)) || !((*(BYTE*)((DWORD) Object + GCO_MARKED) ^ 3) & DeadMask))
+				continue;
+
+			if (HasFilter)
+			{
+				/* The candidate is on the stack for the call, so it survives any collection the filter causes */
+				RL.RawGetI(1, 2);
+				RL.PushRawObject((DWORD) Object, TT);
+				if (RL.PCall(1, 1, 0))
+					return RL.LError("%s", RL.ToString(-1));
+
+				const auto Keep = RL.ToBoolean(-1);
+				RL.Pop(1);
+
+				if (!Keep)
+					continue;
+			}
+
+			if (Remaining > 0)
+			{
+				RL.PushNumber((double) (Remaining - 1));
+				RL.RawSetI(1, 3);
+			}
+
+			RL.PushRawObject((DWORD) Object, TT);
 			return 1;
 		}
 
-		RL.PushBoolean(syn::LuaTranslator::GetSynapseMarked(RL, 1));
-		return 1;
+		return 0;
 	}
 
-	int RbxApi::isrbxactive(DWORD rL)
+	/* Object counts and sizes of everything sharing an environment table. Functions and threads carry their script's
+	   environment, strings, tables and userdata don't record who made them and land in the shared group (key 0) */
+	struct HeapGroup
 	{
-		syn::RbxLua RL(rL);
+		DWORD Key;
+		DWORD Functions;
+		DWORD Tables;
+		DWORD Strings;
+		DWORD Userdata;
+		DWORD Threads;
+		DWORD Other;
+		std::uint64_t StringBytes;
+		std::uint64_t TableLength;	/* sum of #t over the group's tables */
+	};
 
-		RL.PushBoolean(GetForegroundWindow() == syn::RobloxWindow);
+	struct HeapSnapshot
+	{
+		double Time;
+		DWORD TotalBytes;
+		std::vector<HeapGroup> Groups;	/* ascending Key */
+	};
 
-		return 1;
-	}
+	/* A few dozen bytes per script instead of one Lua value per object, game thread only */
+	static constexpr size_t MaxHeapSnapshots = 32;
+	static std::unordered_map<DWORD, HeapSnapshot> HeapSnapshots;
+	static DWORD NextHeapSnapshot = 0;
 
-    /* TODO: Please document this function */
-	int RbxApi::getcallingscript(DWORD rL)
+	int RbxApi::heapsnapshot(DWORD rL)
 	{
-		syn::RbxLua RL(rL);
+		const syn::RbxLua RL(rL);
 
-		if (*(DWORD*)((DWORD)rL - 32) && ((DWORD)rL - 28) > 0) //scriptptr && script ptr ref count > 0
+		if (HeapSnapshots.size() >= MaxHeapSnapshots)
+			return RL.LError("too many heap snapshots (%d max), free some with heapsnapshotfree", (int) MaxHeapSnapshots);
+
+		const auto GlobalState = (DWORD) syn::PointerObfuscation::DeObfuscateGlobalState(RL + L_GS);
+		const auto DeadMask = *(BYTE*)(GlobalState + G_WMASK) ^ 3;
+
+		std::unordered_map<DWORD, HeapGroup> Groups;
+		const auto GroupOf = [&Groups](const DWORD Key) -> HeapGroup&
 		{
-			static DWORD PushF = NULL;
-			if (!PushF) PushF = RbxLua::GetBinValue(FNVA1_CONSTEXPR("pushinstance"));
+			auto& Group = Groups[Key];
+			Group.Key = Key;
+			return Group;
+		};
 
-			((int(__cdecl*)(DWORD, DWORD))PushF)(rL, ((DWORD)rL - 32));
+		for (auto Object = *(GCObject**)(GlobalState + G_ROOTGC); Object != nullptr; Object = Object->gch.next)
+		{
+			if (!((*(BYTE*)((DWORD) Object + GCO_MARKED) ^ 3) & DeadMask))
+				continue;
+
+			const auto Address = (DWORD) Object;
+			switch (*(BYTE*)(Address + GCO_TT))
+			{
+				case R_LUA_TFUNCTION:
+					GroupOf(*(DWORD*)(Address + LCL_ENV)).Functions++;
+					break;
+				case R_LUA_TTHREAD:
+					GroupOf(*(DWORD*)(Address + L_ENV)).Threads++;
+					break;
+				case R_LUA_TSTRING:
+				{
+					auto& Group = GroupOf(0);
+					Group.Strings++;
+					Group.StringBytes += *(DWORD*)(Address + STR_LEN) + 0x19;	/* header, characters and terminator */
+					break;
+				}
+				case R_LUA_TTABLE:
+				{
+					auto& Group = GroupOf(0);
+					Group.Tables++;
+					Group.TableLength += RL.HGetN((Table*) Object);
+					break;
+				}
+				case R_LUA_TUSERDATA:
+					GroupOf(0).Userdata++;
+					break;
+				default:
+					GroupOf(0).Other++;
+					break;
+			}
 		}
-		else RL.PushNil();
 
+		HeapSnapshot Snapshot;
+		Snapshot.Time = syn::FrameStats::Now() / 1000000.0;
+		Snapshot.TotalBytes = *(DWORD*)(GlobalState + G_TOTALBYTES);
+		Snapshot.Groups.reserve(Groups.size());
+		for (const auto& Group : Groups)
+			Snapshot.Groups.push_back(Group.second);
+
+		std::sort(Snapshot.Groups.begin(), Snapshot.Groups.end(), [](const HeapGroup& A, const HeapGroup& B) { return A.Key < B.Key; });
+
+		const auto Id = ++NextHeapSnapshot;
+		HeapSnapshots.emplace(Id, std::move(Snapshot));
+
+		RL.PushNumber(Id);
 		return 1;
 	}
 
-#ifdef EnableLuaUTranslator
-	void LuaUConvert(lua_State* L, Proto* P)
+	int RbxApi::heapdiff(DWORD rL)
 	{
-		const auto Conv = syn::OneWayLuauTranslator(P).Convert(P->code, P->sizecode);
+		const syn::RbxLua RL(rL);
 
-		P->sizecode = Conv.size();
-		P->code = luaM_newvector(L, Conv.size(), Instruction);
+		/* What a missing snapshot or group is compared against */
+		static const HeapSnapshot Empty{};
+		static const HeapGroup EmptyHeapGroup{};
 
-		for (auto i = 0; i < Conv.size(); i++)
-			P->code[i] = (Instruction) Conv[i];
+		const auto Find = [&RL](const int Index) -> const HeapSnapshot&
+		{
+			const auto Found = HeapSnapshots.find((DWORD) RL.CheckNumber(Index));
+			if (Found == HeapSnapshots.end())
+				RL.ArgError(Index, "heap snapshot expected");
+			return Found->second;
+		};
 
-		for (auto i = 0; i < P->sizep; i++)
-			LuaUConvert(L, P->p[i]);
-	}
+		/* One argument reports the snapshot itself */
+		const auto& Old = RL.IsNoneOrNil(2) ? Empty : Find(1);
+		const auto& New = RL.IsNoneOrNil(2) ? Find(1) : Find(2);
 
-	int RbxApi::luaudump(DWORD rL)
-	{
-		const syn::RbxLua RL(rL);
+		struct Growth
+		{
+			DWORD Key;
+			double Functions, Tables, Strings, Userdata, Threads, Other, StringBytes, TableLength;
+			double Weight;
+		};
 
-		size_t ScriptLength;
-		const auto Source = RL.CheckLString(1, &ScriptLength);
+		std::vector<Growth> Grown;
 
-		const auto NState = luaL_newstate();
+		/* Both sides are sorted by key, an object count that went up or down shows as a signed change */
+		const auto Compare = [&Grown](const HeapGroup& A, const HeapGroup& B, const DWORD Key)
+		{
+			Growth G{ Key,
+				(double) B.Functions - A.Functions, (double) B.Tables - A.Tables, (double) B.Strings - A.Strings,
+				(double) B.Userdata - A.Userdata, (double) B.Threads - A.Threads, (double) B.Other - A.Other,
+				(double) B.StringBytes - A.StringBytes, (double) B.TableLength - A.TableLength, 0 };
 
-		if (luaL_loadbuffer(NState, Source, ScriptLength, BS_LUA, "testing"))
+			G.Weight = G.Functions + G.Tables + G.Strings + G.Userdata + G.Threads + G.Other;
+			if (G.Functions || G.Tables || G.Strings || G.Userdata || G.Threads || G.Other || G.StringBytes || G.TableLength)
+				Grown.push_back(G);
+		};
+
+		size_t i = 0, j = 0;
+		while (i < Old.Groups.size() || j < New.Groups.size())
 		{
-			std::string Err = lua_tostring(NState, -1);
-			lua_close(NState);
-			throw std::exception(Err.c_str());
+			if (j == New.Groups.size() || (i < Old.Groups.size() && Old.Groups[i].Key < New.Groups[j].Key))
+			{
+				Compare(Old.Groups[i], EmptyHeapGroup, Old.Groups[i].Key);
+				i++;
+			}
+			else if (i == Old.Groups.size() || New.Groups[j].Key < Old.Groups[i].Key)
+			{
+				Compare(EmptyHeapGroup, New.Groups[j], New.Groups[j].Key);
+				j++;
+			}
+			else
+			{
+				Compare(Old.Groups[i], New.Groups[j], New.Groups[j].Key);
+				i++;
+				j++;
+			}
 		}
 
-		const auto C = (Closure*) lua_topointer(NState, -1);
-		const auto P = C->l.p;
+		std::sort(Grown.begin(), Grown.end(), [](const Growth& A, const Growth& B) { return A.Weight > B.Weight; });
 
-		LuaUConvert(NState, P);
+		RL.CreateTable(0, 3);
+		RL.PushNumber((double) New.TotalBytes - Old.TotalBytes);
+		RL.SetField(-2, "Bytes");
+		RL.PushNumber(New.Time - Old.Time);
+		RL.SetField(-2, "Time");
 
-		luaL_Buffer B;
-		luaL_buffinit(NState, &B);
-		if (lua_dump(NState, syn::LuaTranslator::DumpWriter, &B) != 0) throw std::exception("failed to dump bytecode");
-		luaL_pushresult(&B);
-		size_t Len;
-		const auto BC = lua_tolstring(NState, -1, &Len);
+		const auto Stats = syn::ScriptStats::GetSingleton();
 
-		const std::string Res(BC, Len);
+		RL.CreateTable((int) Grown.size(), 0);
+		int Index = 0;
+		for (const auto& G : Grown)
+		{
+			RL.CreateTable(0, 9);
 
-		lua_close(NState);
+			auto Label = G.Key ? Stats->LabelOf(G.Key) : std::string("shared");
+			if (Label.empty())
+			{
+				char Name[24];
+				sprintf_s(Name, "env 0x%08X", G.Key);
+				Label = Name;
+			}
 
-		RL.PushLString(Res.c_str(), Res.size());
+			RL.PushLString(Label.c_str(), Label.size());
+			RL.SetField(-2, "Script");
+			RL.PushNumber(G.Functions);
+			RL.SetField(-2, "Functions");
+			RL.PushNumber(G.Tables);
+			RL.SetField(-2, "Tables");
+			RL.PushNumber(G.Strings);
+			RL.SetField(-2, "Strings");
+			RL.PushNumber(G.Userdata);
+			RL.SetField(-2, "Userdata");
+			RL.PushNumber(G.Threads);
+			RL.SetField(-2, "Threads");
+			RL.PushNumber(G.Other);
+			RL.SetField(-2, "Other");
+			RL.PushNumber(G.StringBytes);
+			RL.SetField(-2, "StringBytes");
+			RL.PushNumber(G.TableLength);
+			RL.SetField(-2, "TableLength");
+
+			RL.RawSetI(-2, ++Index);
+		}
+		RL.SetField(-2, "Groups");
 
 		return 1;
 	}
-#endif
-
-	int RbxApi::mouse1press(DWORD rL)
-	{
-		if (GetForegroundWindow() == syn::RobloxWindow)
-            mouse_event(MOUSEEVENTF_LEFTDOWN, 0, 0, 0, 0);
-
-		return 0;
-	}
 
-	int RbxApi::mouse1release(DWORD rL)
+	int RbxApi::heapsnapshotfree(DWORD rL)
 	{
-		if (GetForegroundWindow() == syn::RobloxWindow)
-			mouse_event(MOUSEEVENTF_LEFTUP, 0, 0, 0, 0);
-
-		return 0;
-	}
+		const syn::RbxLua RL(rL);
 
-	int RbxApi::mouse1click(DWORD rL)
-	{
-		if (GetForegroundWindow() == syn::RobloxWindow)
-			mouse_event(MOUSEEVENTF_LEFTDOWN | MOUSEEVENTF_LEFTUP, 0, 0, 0, 0);
+		if (RL.IsNoneOrNil(1))
+			HeapSnapshots.clear();
+		else
+			HeapSnapshots.erase((DWORD) RL.CheckNumber(1));
 
 		return 0;
 	}
 
-	int RbxApi::mouse2press(DWORD rL)
+	/* scanclosures({ Constants = { ... }, Upvalues = { names }, Source = "substring", Max = n }) -> { functions }
+	   One pass over the gc list in C++, a Lua function matches when it has every listed constant, every listed upvalue name and the source substring */
+	int RbxApi::scanclosures(DWORD rL)
 	{
-		if (GetForegroundWindow() == syn::RobloxWindow)
-			mouse_event(MOUSEEVENTF_RIGHTDOWN, 0, 0, 0, 0);
+		syn::RbxLua RL(rL);
+		RL.CheckType(1, R_LUA_TTABLE);
 
-		return 0;
-	}
+		std::vector<std::string> Strings;
+		std::vector<double> Numbers;
+		std::vector<bool> Booleans;
+		std::vector<std::string> Upvalues;
+		std::string Source;
+		auto Max = -1;
 
-	int RbxApi::mouse2release(DWORD rL)
-	{
-		if (GetForegroundWindow() == syn::RobloxWindow)
-			mouse_event(MOUSEEVENTF_RIGHTUP, 0, 0, 0, 0);
+		RL.GetField(1, "Constants");
+		if (RL.IsTable(-1))
+		{
+			for (int i = 1; i <= RL.ObjLen(-1); i++)
+			{
+				RL.RawGetI(-1, i);
+				size_t Len;
+				if (RL.Type(-1) == R_LUA_TSTRING)
+				{
+					const auto Str = RL.ToLString(-1, &Len);
+					Strings.emplace_back(Str, Len);
+				}
+				else if (RL.Type(-1) == R_LUA_TNUMBER)
+					Numbers.push_back(RL.ToNumber(-1));
+				else if (RL.Type(-1) == R_LUA_TBOOLEAN)
+					Booleans.push_back(RL.ToBoolean(-1));
+				else
+					return RL.LError("expected strings, numbers or booleans in 'Constants'");
+				RL.Pop(1);
+			}
+		}
+		RL.Pop(1);
 
-		return 0;
-	}
+		RL.GetField(1, "Upvalues");
+		if (RL.IsTable(-1))
+		{
+			for (int i = 1; i <= RL.ObjLen(-1); i++)
+			{
+				RL.RawGetI(-1, i);
+				if (!RL.IsString(-1))
+					return RL.LError("expected upvalue names in 'Upvalues'");
+				size_t Len;
+				const auto Str = RL.ToLString(-1, &Len);
+				Upvalues.emplace_back(Str, Len);
+				RL.Pop(1);
+			}
+		}
+		RL.Pop(1);
 
-	int RbxApi::mouse2click(DWORD rL)
-	{
-		if (GetForegroundWindow() == syn::RobloxWindow)
-			mouse_event(MOUSEEVENTF_RIGHTDOWN | MOUSEEVENTF_RIGHTUP, 0, 0, 0, 0);
+		RL.GetField(1, "Source");
+		if (RL.IsString(-1))
+			Source = RL.ToString(-1);
+		RL.Pop(1);
 
-		return 0;
-	}
+		RL.GetField(1, "Max");
+		if (RL.IsNumber(-1))
+			Max = (int) RL.ToNumber(-1);
+		RL.Pop(1);
 
-	int RbxApi::keypress(DWORD rL)
-	{
-        syn::RbxLua RL(rL);
-        
-        UINT key = RL.CheckInteger(1);
+		const auto StringOf = [&RL](TString* Str)
+		{
+			return std::string_view(getstr(Str), RL.RawSLen(Str));
+		};
 
-		if (GetForegroundWindow() == syn::RobloxWindow)
-            keybd_event(0, (BYTE)MapVirtualKeyA(key, MAPVK_VK_TO_VSC), KEYEVENTF_SCANCODE, 0);
+		const auto GlobalState = (DWORD) syn::PointerObfuscation::DeObfuscateGlobalState(RL + L_GS);
+		const auto DeadMask = *(BYTE*)(GlobalState + G_WMASK) ^ 3;
 
-		return 0;
-	}
+		RL.NewTable();
 
-	int RbxApi::keyrelease(DWORD rL)
-	{
-        syn::RbxLua RL(rL);
+		auto n = 1;
+		for (auto Object = *(GCObject**)(GlobalState + G_ROOTGC); Object != nullptr && Max != 0; Object = Object->gch.next)
+		{
+			if (Object->gch.tt != R_LUA_TFUNCTION || !((*(BYTE*)((DWORD) Object + GCO_MARKED) ^ 3) & DeadMask) || ((Closure*) Object)->c.isC)
+				continue;
 
-        UINT key = RL.CheckInteger(1);
+			syn::Structures::rProto P(syn::PointerObfuscation::DeObfuscateLClosure((DWORD) Object + 20));
 
-		if (GetForegroundWindow() == syn::RobloxWindow)
-            keybd_event(0, (BYTE)MapVirtualKeyA(key, MAPVK_VK_TO_VSC), KEYEVENTF_SCANCODE | KEYEVENTF_KEYUP, 0);
+			/* Same rule as getconstants, SecureLua protos keep their constants to themselves */
+			if (P.lastlinedefined == LastDefineKey && ((HSvmSettings*) (std::uintptr_t) P.linedefined)->VM != SECURELUA_VM_NONE)
+				continue;
 
-		return 0;
-	}
+			if (!Source.empty())
+			{
+				const auto Src = (TString*) P.source;
+				if (!Src || StringOf(Src).find(Source) == std::string_view::npos)
+					continue;
+			}
 
-	int RbxApi::mousemoverel(DWORD rL)
-	{
-        syn::RbxLua RL(rL);
-        
-        DWORD x = (DWORD)RL.CheckLong(1);
-        DWORD y = (DWORD)RL.CheckLong(2);
+			const auto K = (TValue*) P.k;
+			const auto SizeK = (int) P.sizek;
 
-		if (GetForegroundWindow() == syn::RobloxWindow)
-            mouse_event(MOUSEEVENTF_MOVE, x, y, 0, 0);
+			const auto HasConstant = [K, SizeK](const auto& Match)
+			{
+				for (auto i = 0; i < SizeK; i++)
+					if (Match(K[i]))
+						return true;
+				return false;
+			};
 
-		return 0;
-	}
+			auto Matches = std::all_of(Strings.begin(), Strings.end(), [&](const std::string& Str)
+			{
+				return HasConstant([&](const TValue& V) { return V.tt == R_LUA_TSTRING && StringOf(&V.value.gc->ts) == Str; });
+			});
 
-	int RbxApi::mousemoveabs(DWORD rL)
-	{
-		syn::RbxLua RL(rL);
+			Matches = Matches && std::all_of(Numbers.begin(), Numbers.end(), [&](const double Num)
+			{
+				return HasConstant([Num](const TValue& V) { return V.tt == R_LUA_TNUMBER && syn::RbxLua::XorDouble(V.value.n) == Num; });
+			});
 
-        DWORD x = (DWORD)RL.CheckLong(1);
-        DWORD y = (DWORD)RL.CheckLong(2);
+			Matches = Matches && std::all_of(Booleans.begin(), Booleans.end(), [&](const bool B)
+			{
+				return HasConstant([B](const TValue& V) { return V.tt == R_LUA_TBOOLEAN && (V.value.b != 0) == B; });
+			});
 
-		if (GetForegroundWindow() != syn::RobloxWindow) return 0;
+			if (Matches && !Upvalues.empty())
+			{
+				const auto Names = (TString**) P.upvalues;
+				const auto SizeUpvalues = (int) P.sizeupvalues;
 
-		int width = GetSystemMetrics(SM_CXSCREEN) - 1;
-		int height = GetSystemMetrics(SM_CYSCREEN) - 1;
+				Matches = std::all_of(Upvalues.begin(), Upvalues.end(), [&](const std::string& Name)
+				{
+					for (auto i = 0; i < SizeUpvalues; i++)
+						if (Names[i] && StringOf(Names[i]) == Name)
+							return true;
+					return false;
+				});
+			}
 
-		RECT CRect;
-		GetClientRect(GetForegroundWindow(), &CRect);
+			if (!Matches)
+				continue;
 
-		POINT Point{ CRect.left, CRect.top };
-		ClientToScreen(GetForegroundWindow(), &Point);
+			RL.PushRawObject((DWORD) Object, R_LUA_TFUNCTION);
+			RL.RawSetI(-2, n++);
 
-		x = (x + (DWORD)Point.x) * (65535 / width);
-		y = (y + (DWORD)Point.y) * (65535 / height);
+			if (Max > 0)
+				Max--;
+		}
 
-		mouse_event(MOUSEEVENTF_ABSOLUTE | MOUSEEVENTF_MOVE, x, y, 0, 0);
-		return 0;
+		return 1;
 	}
 
-	int RbxApi::mousescroll(DWORD rL)
+	/* One descendant query, see finddescendants. Class filters are resolved once per class descriptor, so inheritance
+	   costs one IsA call per distinct class rather than per instance */
+	struct DescendantQuery
 	{
-		syn::RbxLua RL(rL);
+		std::string ClassName;
+		std::string IsA;
+		std::string Name;
+		std::string NamePattern;
+		int MaxDepth = 0;
+		int Max = -1;
+		double Budget = 0;
 
-        DWORD scrollAmount = (DWORD)RL.CheckLong(1);
+		std::unordered_map<DWORD, bool> ClassMatches;
 
-		if (GetForegroundWindow() == syn::RobloxWindow)
-            mouse_event(MOUSEEVENTF_WHEEL, 0, 0, scrollAmount, 0);
+		struct Level
+		{
+			DWORD Inst;
+			size_t Next;
+		};
 
-		return 0;
-	}
+		static void Push(DWORD rL, DWORD Inst)
+		{
+			static DWORD PushF = NULL;
+			if (!PushF) PushF = RbxLua::GetBinValue(FNVA1_CONSTEXPR("pushinstance"));
 
-	int RbxApi::newcclosurehandler(DWORD rL)
-	{
-		syn::RbxLua RL(rL);
+			const auto RealInst = Inst;
+			((int(__cdecl*)(DWORD, DWORD))PushF)(rL, (DWORD) &RealInst);
+		}
 
-		/* Stack:
-		 * 1 - newcclosurehandler
-		 * 2 - synapse lua function (user)
-		 * 3 - newcclosurestub
-		 * 4 - caller function (what we want)
-		 */
+		/* Reads the options table at Index */
+		void Read(const RbxLua& RL, int Index)
+		{
+			const auto Field = [&RL, Index](const char* Key, std::string& Out)
+			{
+				RL.GetField(Index, Key);
+				if (RL.IsString(-1))
+				{
+					size_t Len;
+					const auto Str = RL.ToLString(-1, &Len);
+					Out.assign(Str, Len);
+				}
+				RL.Pop(1);
+			};
 
-		/* Lazy coding inbound, we need to create a fake exception trace for our error */
-		size_t ErrSize;
-		const auto ErrPtr = RL.ToLString(-1, &ErrSize);
-		const auto Err = std::string(ErrPtr, ErrSize);
+			Field("ClassName", ClassName);
+			Field("IsA", IsA);
+			Field("Name", Name);
+			Field("NamePattern", NamePattern);
+
+			RL.GetField(Index, "MaxDepth");
+			if (RL.IsNumber(-1)) MaxDepth = (int) RL.ToNumber(-1);
+			RL.GetField(Index, "Max");
+			if (RL.IsNumber(-1)) Max = (int) RL.ToNumber(-1);
+			RL.GetField(Index, "Budget");
+			if (RL.IsNumber(-1)) Budget = RL.ToNumber(-1);
+			RL.Pop(3);
+		}
 
-		/* Check for yield */
-		if (Err.find("attempt to yield across") != std::string::npos && Err.find("is not") == std::string::npos)
+		bool MatchesClass(const RbxLua& RL, const syn::Instance& Inst)
 		{
-			RL.Pop(1);
-			RL.PushBoolean(true);
-			return 1;
+			if (ClassName.empty() && IsA.empty())
+				return true;
+
+			const auto Descriptor = Inst.GetClassDescriptor();
+			const auto Found = ClassMatches.find(Descriptor);
+			if (Found != ClassMatches.end())
+				return Found->second;
+
+			auto Match = ClassName.empty() || Inst.GetInstanceClassName() == ClassName;
+			if (Match && !IsA.empty())
+			{
+				Push(RL, Inst);
+				RL.GetField(-1, "IsA");
+				RL.Insert(-2);
+				RL.PushLString(IsA.c_str(), IsA.size());
+				Match = !RL.PCall(2, 1, 0) && RL.ToBoolean(-1);
+				RL.Pop(1);
+			}
+
+			ClassMatches.emplace(Descriptor, Match);
+			return Match;
 		}
 
-		/* If not, start our secondary exception handling */
-		lua_Debug ar;
-		if (!RL.GetStack(4, &ar)) return RL.GetTop();
-		RL.GetInfo("Sl", &ar);
+		bool Matches(const RbxLua& RL, const syn::Instance& Inst)
+		{
+			if (!Name.empty() && Inst.NameView() != Name)
+				return false;
 
-		lua_Debug ar_syn;
-		if (!RL.GetStack(2, &ar_syn)) return RL.GetTop();
-		RL.GetInfo("Sl", &ar_syn);
+			if (!MatchesClass(RL, Inst))
+				return false;
 
-		/* Check for non-newcclosure error */
-		if (Err.find(std::string(ar_syn.source).erase(0, 1)) == std::string::npos)
-			return RL.GetTop();
+			if (NamePattern.empty())
+				return true;
 
-		std::vector<std::string> Tokenized;
-		SplitString(Err, ":", Tokenized);
+			/* Lua patterns, so string.find does the matching. Only reached by instances every other filter let through */
+			const auto& InstName = Inst.NameView();
+			RL.GetGlobal("string");
+			RL.GetField(-1, "find");
+			RL.PushLString(InstName.c_str(), InstName.size());
+			RL.PushLString(NamePattern.c_str(), NamePattern.size());
+			const auto Match = !RL.PCall(2, 1, 0) && !RL.IsNil(-1);
+			RL.Pop(2);
 
-		/* Use the source from the real function */
-		std::stringstream Stream;
-		Stream << std::string(ar.source).erase(0, 1) << ":" << ar.currentline << ":";
+			return Match;
+		}
 
-		/* Put actual error */
-		for (size_t i = 0; i < Tokenized.size(); i++)
+		/* Depth first, in GetDescendants order. Matches are appended to the table on top of the stack from N, the walk
+		   stops early once Deadline (FrameStats::Now, 0 for none) passes or Max is reached. Returns the next N */
+		int Walk(const RbxLua& RL, std::vector<Level>& Levels, int N, double Deadline)
 		{
-			if (i == 0 || i == 1) continue;
-			Stream << Tokenized.at(i) << ":";
-		}
+			auto Steps = 0;
 
-		/* Erase final ':' from string */
-		auto Final = Stream.str();
-		Final.erase(Final.size() - 1);
+			while (!Levels.empty() && Max != 0)
+			{
+				const auto Parent = Levels.back();
+				const auto Children = syn::Instance(Parent.Inst).Children();
+				if (Parent.Next >= Children.size())
+				{
+					Levels.pop_back();
+					continue;
+				}
 
-		RL.Pop(1);
-		RL.PushLString(Final.c_str(), Final.size());
+				const auto Child = Children[Parent.Next];
+				Levels.back().Next++;
 
-		return RL.GetTop();
-	}
+				/* Same view GetDescendants gives scripts, nothing under a locked instance */
+				if (Child.IsRobloxLocked())
+					continue;
 
-	int RbxApi::newcclosurestub(DWORD rL)
+				if (Matches(RL, Child))
+				{
+					Push(RL, Child);
+					RL.RawSetI(-2, N++);
+					if (Max > 0) Max--;
+				}
+
+				/* The root is level 0, so Levels.size() is the child's depth */
+				if (!MaxDepth || (int) Levels.size() < MaxDepth)
+					Levels.push_back({ Child, 0 });
+
+				if (Deadline && ++Steps % 256 == 0 && syn::FrameStats::Now() >= Deadline)
+					break;
+			}
+
+			return N;
+		}
+	};
+
+	/* finddescendants(root, { ClassName = "Part", IsA = "BasePart", Name = "exact", NamePattern = "lua pattern",
+	                           MaxDepth = n, Max = n, Budget = ms }) -> { instances }
+	   The walk runs in C++ and only matches are pushed. With Budget it returns an iterator instead, each call walks for
+	   at most Budget milliseconds and returns the matches of that slice: for Batch in finddescendants(...) do wait() end */
+	int RbxApi::finddescendants(DWORD rL)
 	{
 		syn::RbxLua RL(rL);
 
-		const auto Func = (*(SynCClosure*)RL.ToUserData(lua_upvalueindex(1))).ExtraSpace;
-		RL.PushRawObject(Func, R_LUA_TFUNCTION);
-		RL.Insert(1);
-		RL.PushRawObject(CClosureHandlers[syn::PointerObfuscation::DeObfuscateGlobalState(RL + L_GS)], R_LUA_TFUNCTION);
-		RL.Insert(1);
+		if (!RL.IsUserData(1) || !checkinstance(RL, 1))
+			return RL.ArgError(1, "userdata<instance> expected");
 
-		const auto Res = RL.PCall(RL.GetTop() - 2, LUA_MULTRET, 1);
+		DescendantQuery Query;
+		if (RL.IsTable(2))
+			Query.Read(RL, 2);
 
-		RL.Remove(1);
-		
-		if (Res && Res != LUA_YIELD)
+		if (Query.Budget > 0)
 		{
-			if (RL.IsBoolean(-1))
-				return RL.RYield(0);
+			/* State: [1] options, [2] instances on the walk stack (kept alive between slices), [3] their next child index,
+			   [4] matches left before Max */
+			RL.CreateTable(4, 0);
+			if (RL.IsTable(2)) RL.PushValue(2);
+			else RL.NewTable();
+			RL.RawSetI(-2, 1);
 
-			return RL.Error();
+			RL.CreateTable(1, 0);
+			RL.PushValue(1);
+			RL.RawSetI(-2, 1);
+			RL.RawSetI(-2, 2);
+
+			RL.CreateTable(1, 0);
+			RL.PushNumber(0);
+			RL.RawSetI(-2, 1);
+			RL.RawSetI(-2, 3);
+
+			RL.PushNumber(Query.Max);
+			RL.RawSetI(-2, 4);
+
+			RL.PushCFunction(finddescendantshandler);
+			RL.Insert(-2);
+			RL.PushNil();
+
+			return 3;
 		}
 
-		return RL.GetTop();
+		std::vector<DescendantQuery::Level> Levels{ { DereferenceSmartPointerInstance((DWORD) RL.ToUserData(1)), 0 } };
+
+		RL.NewTable();
+		Query.Walk(RL, Levels, 1, 0);
+
+		return 1;
 	}
 
-	int RbxApi::newcclosurestub_noupvals(DWORD rL, SynCClosure cL)
+	int RbxApi::finddescendantshandler(DWORD rL)
 	{
-		syn::RbxLua RL(rL);
+		const syn::RbxLua RL(rL);
 
-		const auto Func = cL.ExtraSpace;
-		RL.PushRawObject(Func, R_LUA_TFUNCTION);
-		RL.Insert(1);
-		RL.PushRawObject(CClosureHandlers[syn::PointerObfuscation::DeObfuscateGlobalState(RL + L_GS)], R_LUA_TFUNCTION);
-		RL.Insert(1);
+		DescendantQuery Query;
+		RL.RawGetI(1, 1);
+		Query.Read(RL, RL.GetTop());
+		RL.RawGetI(1, 4);
+		Query.Max = (int) RL.ToNumber(-1);
+		RL.Pop(2);
 
-		const auto Res = RL.PCall(RL.GetTop() - 2, LUA_MULTRET, 1);
+		if (!Query.Max)
+			return 0;
 
-		RL.Remove(1);
+		RL.RawGetI(1, 2);
+		RL.RawGetI(1, 3);
+		const auto Stack = RL.GetTop() - 1;
 
-		if (Res && Res != LUA_YIELD)
+		std::vector<DescendantQuery::Level> Levels;
+		for (int i = 1; i <= RL.ObjLen(Stack); i++)
 		{
-			if (RL.IsBoolean(-1))
-				return RL.RYield(0);
-
-			return RL.Error();
+			RL.RawGetI(Stack, i);
+			RL.RawGetI(Stack + 1, i);
+			Levels.push_back({ DereferenceSmartPointerInstance((DWORD) RL.ToUserData(-2)), (size_t) RL.ToNumber(-1) });
+			RL.Pop(2);
 		}
 
-		return RL.GetTop();
-	}
-
-	int RbxApi::newcclosure(DWORD rL)
-	{
-		syn::RbxLua RL(rL);
-
-        RL.CheckType(1, R_LUA_TFUNCTION);
-
-        if (RL.IsCFunction(1))
-            return RL.ArgError(1, "lua function expected");
-
-		/* lazy hack so we don't get GC'd */
-		RL.PushValue(1);
-		RL.SetField(LUA_REGISTRYINDEX, RandomString(16).c_str());
-
-		DWORD& CCH = CClosureHandlers[syn::PointerObfuscation::DeObfuscateGlobalState(RL + L_GS)];
+		if (Levels.empty())
+			return 0;
 
-		if (!CCH)
-		{
-			/* prevent CClosure handler from being GC'd */
-			RL.PushCFunction(syn::RbxApi::newcclosurehandler);
-			CCH = RL.ToPointer(-1);
-			RL.SetField(LUA_REGISTRYINDEX, RandomString(16).c_str());
+		RL.NewTable();
+		const auto Found = Query.Walk(RL, Levels, 1, syn::FrameStats::Now() + Query.Budget * 1000) - 1;
+		if (!Query.Max)
+			Levels.clear();
+
+		/* Instances are lua values again before the slice ends, so they survive whatever runs until the next one */
+		RL.CreateTable((int) Levels.size(), 0);
+		RL.CreateTable((int) Levels.size(), 0);
+		for (size_t i = 0; i < Levels.size(); i++)
+		{
+			DescendantQuery::Push(RL, Levels[i].Inst);
+			RL.RawSetI(-3, (int) i + 1);
+			RL.PushNumber((double) Levels[i].Next);
+			RL.RawSetI(-2, (int) i + 1);
 		}
+		RL.RawSetI(1, 3);
+		RL.RawSetI(1, 2);
 
-		const auto CC = new SynCClosure();
-		CC->Address = (DWORD) newcclosurestub;
-		CC->ExtraSpace = RL.ToPointer(1);
+		RL.PushNumber(Query.Max);
+		RL.RawSetI(1, 4);
 
-		RL.PushLightUserData(CC);
-		RL.CreateCClosure(1);
+		if (!Found && Levels.empty())
+			return 0;
 
 		return 1;
 	}
 
-    int RbxApi::hookfunction(DWORD rL)
-    {
-        syn::RbxLua RL(rL);
+	DWORD RbxApi::script_thread_lookup(RbxLua RL, DWORD Script)
+	{
+		const auto GlobalState = (DWORD) syn::PointerObfuscation::DeObfuscateGlobalState(RL + L_GS);
+		const auto DeadMask = *(BYTE*)(GlobalState + G_WMASK) ^ 3;
+		const auto Head = *(GCObject**)(GlobalState + G_ROOTGC);
 
-        RL.CheckType(1, R_LUA_TFUNCTION);
-        RL.CheckType(2, R_LUA_TFUNCTION);
+		const auto IsScriptThread = [DeadMask, Script](GCObject* Object)
+		{
+			return Object->gch.tt == R_LUA_TTHREAD && (*(BYTE*)((DWORD) Object + GCO_MARKED) ^ 3) & DeadMask
+				&& ((RBXExtraSpace*)((DWORD) Object - sizeof(RBXExtraSpace)))->ScriptPtr == Script;
+		};
 
-        if (RL.IsCFunction(1))
-        {
-            if (!RL.IsCFunction(2))
-                return RL.ArgError(2, "C function expected");
+		/* Entries can go stale when a thread is collected, so confirm the hit still belongs to this script */
+		const auto Cached = ScriptThreads.find(Script);
+		if (Cached != ScriptThreads.end() && IsScriptThread((GCObject*) Cached->second))
+			return Cached->second;
 
-            const auto OldClosure = (CClosure*) RL.ToPointer(1);
-            const auto HookClosure = (CClosure*) RL.ToPointer(2);
+		/* Nothing was allocated since the last pass, so no new thread can exist either */
+		if (Cached == ScriptThreads.end() && Head == ScriptThreadsHead)
+			return 0;
 
-			/* Make sure we don't fuck ourselves over with GC */
-			RL.PushValue(2);
-			RL.SetField(LUA_REGISTRYINDEX, RandomString(16).c_str());
+		ScriptThreads.clear();
+		ScriptThreadsHead = Head;
 
-            const auto OldCFunction = syn::PointerObfuscation::DeObfuscateCClosure((DWORD) OldClosure + 20);
-            const auto HookCFunction = syn::PointerObfuscation::DeObfuscateCClosure((DWORD) HookClosure + 20);
+		for (auto Object = Head; Object != nullptr; Object = Object->gch.next)
+		{
+			if (Object->gch.tt != R_LUA_TTHREAD || !((*(BYTE*)((DWORD) Object + GCO_MARKED) ^ 3) & DeadMask))
+				continue;
 
-            /* Backup old function */
+			const auto Es = (RBXExtraSpace*)((DWORD) Object - sizeof(RBXExtraSpace));
+			if (Es->ScriptPtr)
+				ScriptThreads.emplace(Es->ScriptPtr, (DWORD) Object);
+		}
 
-            for (auto i = 0; i < OldClosure->nupvalues; i++)
-                RL.PushObject(&OldClosure->upvalue[i]);
+		const auto Found = ScriptThreads.find(Script);
+		return Found != ScriptThreads.end() ? Found->second : 0;
+	}
 
-            RL.PushCClosure((r_lua_CFunction) OldCFunction, OldClosure->nupvalues);
+	int RbxApi::getsenv(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
 
-			if (!OldClosure->nupvalues && HookClosure->nupvalues == 1)
-			{
-				/* Check if we can use 0 upvalue hookfunction */
-				const auto CC = (SynCClosure*) HookClosure->upvalue[0].value.p;
+        if (!RL.IsUserData(1) && !checkinstance(RL, 1))
+            return RL.TypeError(1, "Variant<userdata[LocalScript, ModuleScript]>");
 
-				if (CC != nullptr && CC->Address == (DWORD) newcclosurestub)
-				{
-					/* We can. */
-					SynCClosure SCC = { (DWORD) newcclosurestub_noupvals, CC->ExtraSpace };
+		const syn::Instance Inst = DereferenceSmartPointerInstance((DWORD) RL.ToUserData(1));
+        
+        std::string classname = Inst.GetInstanceClassName();
+		if (classname != "LocalScript" && classname != "ModuleScript")
+			return RL.TypeError(1, "Variant<userdata[LocalScript, ModuleScript]> expected");
 
-					HookedFunctionsMap[(std::uintptr_t) OldClosure] = SCC;
-					syn::PointerObfuscation::ObfuscateCClosure((DWORD) OldClosure + 20, HookCFunction);
+		DWORD LS = 0;
 
-					return 1;
-				}
-			}
+        VM_TIGER_WHITE_START;
 
-            /* Hook */
-            syn::PointerObfuscation::ObfuscateCClosure((DWORD) OldClosure + 20, HookCFunction);
-            OldClosure->nupvalues = HookClosure->nupvalues;
+		if (classname == "ModuleScript")
+		{
+			LS = script_thread_lookup(RL, Inst);
+		}
+		else
+		{
+			//todo: WTF IS THIS DEFCON
+			if (!*(DWORD*)((DWORD)Inst + 0xEC))
+				return RL.LError("could not get script environment - localscript not running");
 
-            for (auto i = 0; i < HookClosure->nupvalues; i++)
-            {
-                auto OT = &OldClosure->upvalue[i];
-                const auto HT = &HookClosure->upvalue[i];
+			DWORD N = *(DWORD*)((DWORD)Inst + 0xEC);
+			DWORD WTR = *(DWORD*)(N + 4);
+			DWORD LIS = *(DWORD*)(WTR + 20);
+			LS = *(DWORD*)(LIS + 8);
+		}
 
-                OT->value = HT->value;
-                OT->tt = HT->tt;
-            }
+        VM_TIGER_WHITE_END;
 
-            /* Return */
-            return 1;
-        }
-        else
-        {
-            if (RL.IsCFunction(2))
-                return RL.ArgError(2, "lua function expected");
+		if (!LS)
+			return RL.LError("could not get script environment");
 
-            const auto OldClosure = (DWORD) RL.ToPointer(1);
-            const auto HookClosure = (DWORD) RL.ToPointer(2);
+		syn::RbxLua NRL(LS);
 
-			/* Make sure we don't fuck ourselves over with GC */
-			RL.PushValue(2);
-			RL.SetField(LUA_REGISTRYINDEX, RandomString(16).c_str());
+		NRL.PushValue(LUA_GLOBALSINDEX);
+		NRL.XMove(RL, 1);
 
-            const auto OldLFunction = syn::PointerObfuscation::DeObfuscateLClosure((DWORD) OldClosure + 20);
-            const auto HookLFunction = syn::PointerObfuscation::DeObfuscateLClosure((DWORD) HookClosure + 20);
+		return 1;
+	}
 
-            if (*(BYTE*)(HookClosure + LCL_NUPVALS) > *(BYTE*)(OldClosure + LCL_NUPVALS) && *(BYTE*)(HookClosure + LCL_NUPVALS) > 1)
-                return RL.ArgError(2, "hook function has too many upvalues");
+	int RbxApi::islclosure(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
 
-            RL.PushString(RandomString(16).c_str());
-            RL.PushValue(2);
-            RL.SetTable(LUA_REGISTRYINDEX);
+		RL.CheckType(1, R_LUA_TFUNCTION);
 
-            /* Backup old function */
-            DWORD LC = RL.NewLClosure(*(lu_byte*)(OldClosure + LCL_NUPVALS), *(lu_byte*)(OldClosure + LCL_MAXSTACKSIZE), NULL);
+		RL.PushBoolean(!RL.IsCFunction(1));
 
-            memcpy((void*)(DWORD*)(LC + 4), (void*)(DWORD*)(OldClosure + 4), sizeLclosure(*(lu_byte*)(OldClosure + LCL_NUPVALS) + 1));
+		return 1;
+	}
 
-            syn::PointerObfuscation::ObfuscateLClosure(LC + 20, OldLFunction);
+	int RbxApi::issynfunc(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
 
-            /* Hook */
-            memcpy((void*)(DWORD*)(OldClosure + 4), (void*)(DWORD*)(HookClosure + 4), sizeLclosure(*(lu_byte*)(HookClosure + LCL_NUPVALS) + 1));
+		RL.CheckType(1, R_LUA_TFUNCTION);
+        RL.CheckType(1, R_LUA_TFUNCTION);
 
-            syn::PointerObfuscation::ObfuscateLClosure(OldClosure + 20, HookLFunction);
+		if (RL.IsCFunction(1))
+		{
+			static DWORD CraInvoke = NULL;
+			if (!CraInvoke) CraInvoke = syn::RobloxBase(OBFUSCATED_NUM(syn::CallCheck::CallcheckAddress));
 
-            /* Push LClosure to stack */
-            r_setclvalue(*(TValue**)(RL + L_TOP), LC);
-            r_incr_top(RL);
+			const auto CheckClosure = (CClosure*)RL.ToPointer(1);
+			const auto CheckCFunction = syn::PointerObfuscation::DeObfuscateCClosure((DWORD)CheckClosure + 20);
+			RL.PushBoolean(CheckCFunction == CraInvoke);
+			return 1;
+		}
 
-            /* Return */
-            return 1;
-        }
-    }
+		RL.PushBoolean(syn::LuaTranslator::GetSynapseMarked(RL, 1));
+		return 1;
+	}
 
-	bool RbxApi::decompile_sanity_check(syn::Instance Inst)
+	int RbxApi::isrbxactive(DWORD rL)
 	{
-		try
-		{
-			if (Inst.GetInstanceClassName() == "LocalScript")
-			{
-				if (!*(DWORD*)(Inst + 0xF8)) return false;
-				auto Bytecode = *(std::string*)(*(DWORD*)(Inst + 0xF8) + 0x18);
-				if (Bytecode.size() <= 8)
-				{
-					Bytecode = *(std::string*)(Inst + 0xBC); /* CachedRemoteSource + 0x18 */
-					if (Bytecode.size() <= 8) return false;
-				}
-				return true;
-			}
+		syn::RbxLua RL(rL);
 
-			auto RProt = new RbxProtectedString();
-			static DWORD ModScrDump = 0;
-			if (!ModScrDump) ModScrDump = RbxLua::GetBinValue(FNVA1_CONSTEXPR("modscriptdump"));
-			const auto ProtectedString = ((int(__thiscall*)(int, int))ModScrDump)(Inst, (DWORD)RProt);
-			auto Bytecode = *(std::string*)(ProtectedString + 0x18);
-			if (Bytecode.size() <= 8)
-			{
-				Bytecode = *(std::string*)(Inst + 0xBC); /* CachedRemoteSource + 0x18 */
-				if (Bytecode.size() <= 8) return false;
-			}
+		RL.PushBoolean(GetForegroundWindow() == syn::RobloxWindow);
 
-			return true;
-		}
-		catch (std::exception&)
-		{
-			return false;
-		}
+		return 1;
 	}
 
-	void KillProcessTree(const DWORD ProcId)
+    /* TODO: Please document this function */
+	int RbxApi::getcallingscript(DWORD rL)
 	{
-		PROCESSENTRY32 PE;
-		memset(&PE, 0, sizeof(PROCESSENTRY32));
-		PE.dwSize = sizeof(PROCESSENTRY32);
-
-		const auto HSnap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+		syn::RbxLua RL(rL);
 
-		if (Process32First(HSnap, &PE))
+		if (*(DWORD*)((DWORD)rL - 32) && ((DWORD)rL - 28) > 0) //scriptptr && script ptr ref count > 0
 		{
-			do 
-			{
-				if (PE.th32ParentProcessID == ProcId)
-					KillProcessTree(PE.th32ProcessID);
-			} while (Process32Next(HSnap, &PE));
-		}
-
-		const auto HProc = OpenProcess(PROCESS_TERMINATE, FALSE, ProcId);
+			static DWORD PushF = NULL;
+			if (!PushF) PushF = RbxLua::GetBinValue(FNVA1_CONSTEXPR("pushinstance"));
 
-		if (HProc)
-		{
-			TerminateProcess(HProc, 1);
-			CloseHandle(HProc);
+			((int(__cdecl*)(DWORD, DWORD))PushF)(rL, ((DWORD)rL - 32));
 		}
+		else RL.PushNil();
+
+		return 1;
 	}
 
-    int RbxApi::decompile(DWORD rL)
-    {
-        syn::RbxLua RL(rL);
+#ifdef EnableLuaUTranslator
+	void LuaUConvert(lua_State* L, Proto* P)
+	{
+		const auto Conv = syn::OneWayLuauTranslator(P).Convert(P->code, P->sizecode);
 
-        RbxYield RYield(rL);
+		P->sizecode = Conv.size();
+		P->code = luaM_newvector(L, Conv.size(), Instruction);
 
-#ifndef EnableLuaUDecompiler
-		if (IsLuaU)
-		{
-			RL.PushString(
-				"--SynapseX Decompiler\n--The Synapse X decompiler is currently unsupported on LuaU enabled games.");
-			return 1;
-		}
-#endif
+		for (auto i = 0; i < Conv.size(); i++)
+			P->code[i] = (Instruction) Conv[i];
 
-        RL.ArgCheck(RL.IsFunction(1) || RL.IsProto(1) || RL.IsString(1) || RL.IsUserData(1), 1,
-            "Variant<userdata[LocalScript, ModuleScript], function, string, proto> expected");
+		for (auto i = 0; i < P->sizep; i++)
+			LuaUConvert(L, P->p[i]);
+	}
 
-        enum DecModes
-        {
-            DEC_DUMP,
-            DEC_LEGACY,
-            DEC_NEW,
-        };
+	int RbxApi::luaudump(DWORD rL)
+	{
+		const syn::RbxLua RL(rL);
 
-        auto DecMode = DEC_LEGACY;
-        if (RL.Type(2) == R_LUA_TBOOLEAN)
-        {
-            DecMode = RL.ToBoolean(2) ? DEC_DUMP : DEC_LEGACY;
-            RL.Pop(1);
-        }
+		size_t ScriptLength;
+		const auto Source = RL.CheckLString(1, &ScriptLength);
 
-		auto Timeout = INFINITE;
-		if (RL.Type(3) == R_LUA_TNUMBER)
+		const auto NState = syn::LuaTranslator::AcquireState();
+
+		if (luaL_loadbuffer(NState, Source, ScriptLength, BS_LUA, "testing"))
 		{
-			Timeout = RL.ToNumber(3) * 1000;
+			std::string Err = lua_tostring(NState, -1);
+			syn::LuaTranslator::ReleaseState(NState);
+			throw std::exception(Err.c_str());
 		}
 
-        if (RL.Type(2) == R_LUA_TSTRING)
-        {
-            std::string DmpStr = RL.ToString(2);
-            std::transform(DmpStr.begin(), DmpStr.end(), DmpStr.begin(), tolower);
+		const auto C = (Closure*) lua_topointer(NState, -1);
+		const auto P = C->l.p;
 
-            if (DmpStr == "dump")
-            {
-                DecMode = DEC_DUMP;
-            }
-            else if (DmpStr == "regular" || DmpStr == "reg" || DmpStr == "legacy" || DmpStr == "old")
-            {
-                DecMode = DEC_LEGACY;
-            }
-            else if (DmpStr == "new" || DmpStr == "beta")
-            {
-                DecMode = DEC_NEW;
-            }
-            else
-            {
-                return RL.ArgError(2, "invalid decompilation mode");
-            }
+		LuaUConvert(NState, P);
 
-            RL.Pop(1);
-        }
+		const auto Res = syn::LuaTranslator::DumpChunk(NState);
 
-        std::string BC, DecKey;
+		syn::LuaTranslator::ReleaseState(NState);
 
-        switch (RL.Type(1))
-        {
-		    case R_LUA_TUSERDATA:
-		    case R_LUA_TLIGHTUSERDATA:
-		    {
-		        if (!checkinstance(RL, 1))
-		            return RL.ArgError(1, "Variant<userdata[LocalScript, ModuleScript], function, string, proto> expected");
+		RL.PushLString(Res.c_str(), Res.size());
 
-		        syn::Instance Inst = DereferenceSmartPointerInstance((DWORD)RL.ToUserData(1));
-		        const std::string ClassName = Inst.GetInstanceClassName();
+		return 1;
+	}
+#endif
 
-		        if (ClassName != "LocalScript" && ClassName != "ModuleScript")
-		            return RL.ArgError(1, "Variant<userdata[LocalScript, ModuleScript], function, string, proto> expected");
+	int RbxApi::mouse1press(DWORD rL)
+	{
+		if (GetForegroundWindow() == syn::RobloxWindow)
+            mouse_event(MOUSEEVENTF_LEFTDOWN, 0, 0, 0, 0);
 
-		        if (!decompile_sanity_check(Inst))
-		        {
-		            RL.PushString(
-		                "--SynapseX Decompiler\n--This script could not be decompiled due to it having no bytecode.\n--This is usually caused by trying to decompile a Synapse X generated script.");
-		            return 1;
-		        }
+		return 0;
+	}
 
-		        DWORD ProtectedString;
-		        if (ClassName == "LocalScript")
-		            ProtectedString = *(DWORD*)(Inst + 0xF8);
-		        else
-		        {
-		            auto RProt = new RbxProtectedString();
-		            static DWORD ModScrDump = 0;
-		            if (!ModScrDump) ModScrDump = RbxLua::GetBinValue(FNVA1_CONSTEXPR("modscriptdump"));
-		            ProtectedString = ((int(__thiscall*)(int, int))ModScrDump)(Inst, (DWORD)RProt);
-		        }
+	int RbxApi::mouse1release(DWORD rL)
+	{
+		if (GetForegroundWindow() == syn::RobloxWindow)
+			mouse_event(MOUSEEVENTF_LEFTUP, 0, 0, 0, 0);
 
-		        if ((*(std::string*)(ProtectedString + 0x18)).size() <= 8)
-		            ProtectedString = Inst + 0xA4;
+		return 0;
+	}
 
-		        static DWORD HateFlag = 0;
-		        if (!HateFlag) HateFlag = RbxLua::GetBinValue(FNVA1_CONSTEXPR("hateflag"));
-		        static DWORD Deserialize = 0;
-		        if (!Deserialize) Deserialize = RbxLua::GetBinValue(FNVA1_CONSTEXPR("deserialize"));
+	int RbxApi::mouse1click(DWORD rL)
+	{
+		if (GetForegroundWindow() == syn::RobloxWindow)
+			mouse_event(MOUSEEVENTF_LEFTDOWN | MOUSEEVENTF_LEFTUP, 0, 0, 0, 0);
 
-		        const auto Bytecode = *(std::string*)(ProtectedString + 0x18);
-		        const auto HateBackup = *(DWORD*)HateFlag;
-		        ((int(__cdecl*)(DWORD, const std::string&, const char*, DWORD))Deserialize)(
-		            rL, Bytecode, OBFUSCATE_STR("SXDecompiler"), 1);
-		        *(DWORD*)HateFlag = HateBackup;
+		return 0;
+	}
 
-		        if (RL.Type(-1) != R_LUA_TFUNCTION || !RL.ToPointer(-1))
-		        {
-		            RL.PushString(
-		                "--SynapseX Decompiler\n--This script could not be decompiled due to it having invalid bytecode.\n--This is usually caused by trying to decompile a Synapse X generated script.");
+	int RbxApi::mouse2press(DWORD rL)
+	{
+		if (GetForegroundWindow() == syn::RobloxWindow)
+			mouse_event(MOUSEEVENTF_RIGHTDOWN, 0, 0, 0, 0);
 
-		            return 1;
-		        }
-		    }
-		    case R_LUA_TFUNCTION:
-		    {
-		        if (RL.IsCFunction(1))
-		            return RL.ArgError(1, "Variant<userdata[LocalScript, ModuleScript], function, string, proto> expected");
+		return 0;
+	}
 
-		        if (syn::LuaTranslator::GetSynapseMarked(RL, -1))
-		        {
-		            RL.PushString(
-		                "--SynapseX Decompiler\n--This function can not be decompiled due to it being created by Synapse X.\n--You can use `dumpstring(\"<your code here>\")` to convert to Roblox format bytecode though.");
+	int RbxApi::mouse2release(DWORD rL)
+	{
+		if (GetForegroundWindow() == syn::RobloxWindow)
+			mouse_event(MOUSEEVENTF_RIGHTUP, 0, 0, 0, 0);
 
-		            return 1;
-		        }
+		return 0;
+	}
 
-		        try
-		        {
-		            const auto Translator = syn::LuaTranslator::GetSingleton();
-		            if (DecMode == DEC_NEW)
-		            {
-                        VM_TIGER_WHITE_START;
+	int RbxApi::mouse2click(DWORD rL)
+	{
+		if (GetForegroundWindow() == syn::RobloxWindow)
+			mouse_event(MOUSEEVENTF_RIGHTDOWN | MOUSEEVENTF_RIGHTUP, 0, 0, 0, 0);
 
-		                auto LS = luaL_newstate();
-		                auto LC = Translator->DumpToFunc(LS, RL);
-		                auto ObfDumped = syn::ObfuscatedDumper(LC->l).Dump();
-		                BC = std::get<0>(ObfDumped);
-		                DecKey = std::get<1>(ObfDumped);
-		                lua_close(LS);
-                        
-                        VM_TIGER_WHITE_END;
-		            }
-		            else
-		            {
-		                BC = Translator->Dump(RL);
-		            }
-		        }
-		        catch (const std::exception& ex)
-		        {
-		            RL.PushString(ex.what());
+		return 0;
+	}
 
-		            return 2;
-		        }
-		        break;
-		    }
-		    case R_LUA_TPROTO:
-		    {
-		        if (syn::LuaTranslator::GetSynapseMarked(RL, -1))
-		        {
-		            RL.PushString(
-		                "--SynapseX Decompiler\n--This function can not be decompiled due to it being created by Synapse X.\n--You can use `dumpstring(\"<your code here>\")` to convert to Roblox format bytecode though.");
+	int RbxApi::keypress(DWORD rL)
+	{
+        syn::RbxLua RL(rL);
+        
+        UINT key = RL.CheckInteger(1);
 
-		            return 1;
-		        }
+		if (GetForegroundWindow() == syn::RobloxWindow)
+            keybd_event(0, (BYTE)MapVirtualKeyA(key, MAPVK_VK_TO_VSC), KEYEVENTF_SCANCODE, 0);
 
-		        try
-		        {
-		            const auto Translator = syn::LuaTranslator::GetSingleton();
-		            if (DecMode == DEC_NEW)
-		            {
-                        VM_TIGER_WHITE_START;
+		return 0;
+	}
 
-		                auto LS = luaL_newstate();
-		                auto LP = Translator->DumpToProto(LS, RL);
-		                LClosure lc{};
-		                lc.p = LP;
-		                auto ObfDumped = syn::ObfuscatedDumper(lc).Dump();
-		                BC = std::get<0>(ObfDumped);
-		                DecKey = std::get<1>(ObfDumped);
-		                lua_close(LS);
+	int RbxApi::keyrelease(DWORD rL)
+	{
+        syn::RbxLua RL(rL);
 
-                        VM_TIGER_WHITE_END;
-		            }
-		            else
-		            {
-		                BC = Translator->Dump(RL);
-		            }
-		        }
-		        catch (const std::exception& ex)
-		        {
-		            RL.PushString(ex.what());
+        UINT key = RL.CheckInteger(1);
 
-		            return 2;
-		        }
-		        break;
-		    }
-		    case R_LUA_TSTRING:
-		    {
-		        std::size_t BCLength;
-		        const auto BCPointer = RL.ToLString(1, &BCLength);
+		if (GetForegroundWindow() == syn::RobloxWindow)
+            keybd_event(0, (BYTE)MapVirtualKeyA(key, MAPVK_VK_TO_VSC), KEYEVENTF_SCANCODE | KEYEVENTF_KEYUP, 0);
 
-		        BC = std::string(BCPointer, BCLength);
+		return 0;
+	}
 
-		        if (DecMode == DEC_NEW)
-		        {
-                    VM_TIGER_WHITE_START;
+	int RbxApi::mousemoverel(DWORD rL)
+	{
+        syn::RbxLua RL(rL);
+        
+        DWORD x = (DWORD)RL.CheckLong(1);
+        DWORD y = (DWORD)RL.CheckLong(2);
 
-		            DecKey = RandomString(16);
-		            const auto SKeyGrab = (DecKey.at(0) * OBFUSCATED_NUM_UNCACHE(16777216) + DecKey.at(1) * OBFUSCATED_NUM_UNCACHE(65536) + DecKey.at(2) * OBFUSCATED_NUM_UNCACHE(256) + DecKey.at(3)) % 128;
+		if (GetForegroundWindow() == syn::RobloxWindow)
+            mouse_event(MOUSEEVENTF_MOVE, x, y, 0, 0);
 
-		            for (char& i : BC)
-			            i ^= SKeyGrab;
+		return 0;
+	}
 
-		            auto FKey = OBFUSCATE_STR("F8ixT9H4z8moGusU") + DecKey;
-		            size_t FLen;
-		            auto FRet = xxtea_encrypt(BC.c_str(), BC.length(), FKey.c_str(), &FLen);
+	int RbxApi::mousemoveabs(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
 
-		            BC = std::string(Base64Encode((byte*)FRet, FLen));
+        DWORD x = (DWORD)RL.CheckLong(1);
+        DWORD y = (DWORD)RL.CheckLong(2);
 
-                    VM_TIGER_WHITE_END;
-		        }
+		if (GetForegroundWindow() != syn::RobloxWindow) return 0;
 
-		        break;
-		    }
-            default: break;
-        }
+		int width = GetSystemMetrics(SM_CXSCREEN) - 1;
+		int height = GetSystemMetrics(SM_CYSCREEN) - 1;
 
-        if (DecMode == DEC_DUMP)
-        {
-			RL.PushLString(BC.c_str(), BC.size());
-			return 1;
-        }
+		RECT CRect;
+		GetClientRect(GetForegroundWindow(), &CRect);
 
-        return RYield.Execute([BC, DecMode, DecKey, Timeout]()
-        {
-	        auto BinDir = syn::D3D::GetWorkingPath() + L"\\bin\\";
-
-            auto DmpStr = ConvertToWStr(RandomString(16));
-            auto DecompStr = ConvertToWStr(RandomString(16));
-            auto DecKeyW = ConvertToWStr(DecKey);
-
-            auto DmpBytecodeName = BinDir + DmpStr + L".out";
-            auto DecompName = BinDir + DecompStr + L".txt";
-
-            /* Write bytecode file */
-            std::ofstream OutFile;
-            OutFile.open(DmpBytecodeName, std::ios::out | std::ios::binary);
-            OutFile.write(BC.c_str(), BC.size());
-            OutFile.close();
-
-            /* Decompile with unluac */
-            STARTUPINFOW si; ZeroMemory(&si, sizeof(si));
-            PROCESS_INFORMATION pi; ZeroMemory(&pi, sizeof(pi));
-            si.cb = sizeof(si);
-            
-            constexpr size_t PathSz = (MAX_PATH + 1) * sizeof(wchar_t);
-            wchar_t CMDDir[PathSz];
-            UINT Result = GetSystemDirectoryW(CMDDir, PathSz);
-
-            /* Potential miscalulation on my part, look into size conflicts */
-            if (Result > PathSz || Result == 0)
-            {
-                std::wstring DefaultCmdDir = L"C:\\Windows\\System32\\cmd.exe";
-                wcsncpy_s(CMDDir, DefaultCmdDir.c_str(), DefaultCmdDir.size());
-            }
-            else
-            {
-                wcscat_s(CMDDir, L"\\cmd.exe");
-            }
+		POINT Point{ CRect.left, CRect.top };
+		ClientToScreen(GetForegroundWindow(), &Point);
 
-            if (DecMode == DEC_LEGACY)
-            {
-                if (Is64BitOS())
-                {
-                    syn::Resource* unluac_exe = new syn::Resource("unluac-native", BinDir + L"unluac.exe",
-                        OBFUSCATE_STR("https://cdn.synapse.to/synapsedistro/unluac/unluac_native_may1819.exe"));
-                    unluac_exe->get();
-
-                    if (!CreateProcessW(CMDDir,
-                        (LPWSTR)(L"/C unluac.exe \"" + DmpBytecodeName + L"\" > \"" + DecompName + L"\"").c_str(), NULL, NULL,
-                        FALSE, CREATE_NO_WINDOW, NULL, BinDir.c_str(), &si, &pi))
-                    {
-                        std::filesystem::remove(DmpBytecodeName);
-                        throw std::exception("failed to decompile: 0x01");
-                    }
-                }
-                else
-                {
-                    syn::Resource* unluac_jar = new syn::Resource("unluac", BinDir + L"unluac.jar",
-                        OBFUSCATE_STR("https://cdn.synapse.to/synapsedistro/unluac/unluac_oct1118.jar"));
-                    unluac_jar->get();
-
-                    if (!CreateProcessW(CMDDir,
-                        (LPWSTR) ((std::wstring(L"/C java -Xss32M -jar unluac.jar \"") + DmpBytecodeName + L"\" > \"" + DecompName + L"\"").c_str()), NULL, NULL,
-                        FALSE, CREATE_NO_WINDOW, NULL, BinDir.c_str(), &si, &pi))
-                    {
-                        std::filesystem::remove(DmpBytecodeName);
-                        throw std::exception("failed to decompile: 0x02");
-                    }
-                }
-            }
-            else
-            {
-                if (Is64BitOS())
-                {
-                    syn::Resource* unluac_exe = new syn::Resource("unluac-native-new", BinDir + L"unluac-new.exe",
-                        OBFUSCATE_STR("https://cdn.synapse.to/synapsedistro/unluac/unluac_native_new_may1919.exe"));
-                    unluac_exe->get();
-
-                    if (!CreateProcessW(CMDDir,
-                        (LPWSTR) (std::wstring(L"/C unluac-new.exe ") + DecKeyW + L" \"" + DmpBytecodeName + L"\" > \"" + DecompName + L"\"").c_str(), NULL, NULL,
-                        FALSE, CREATE_NO_WINDOW, NULL, BinDir.c_str(), &si, &pi))
-                    {
-                        std::filesystem::remove(DmpBytecodeName);
-                        throw std::exception("failed to decompile: 0x03");
-                    }
-                }
-                else
-                {
-                    syn::Resource* unluac_new_jar = new syn::Resource("unluac-new", BinDir + L"unluac-new.jar",
-                        OBFUSCATE_STR("https://cdn.synapse.to/synapsedistro/unluac/unluac_new_may1919.jar"));
-                    unluac_new_jar->get();
-
-                    if (!CreateProcessW(CMDDir,
-                        (LPWSTR) (std::wstring(L"/C java -Xss32M -XX:+DisableAttachMechanism -jar unluac-new.jar ") +
-                            DecKeyW + L" \"" + DmpBytecodeName + L"\" > \"" + DecompName + L"\"").c_str(), NULL, NULL, FALSE,
-                        CREATE_NO_WINDOW, NULL, NULL, &si, &pi))
-                    {
-                        std::filesystem::remove(DmpBytecodeName);
-                        throw std::exception("failed to decompile: 0x04");
-                    }
-                }
-            }
-
-            /* Wait for decompilation to complete */
-            auto WaitRes = WaitForSingleObject(pi.hProcess, Timeout);
-
-			/* Check for timeout */
-			if (WaitRes == WAIT_TIMEOUT)
-			{
-				/* Kill process tree (timed out) */
-				KillProcessTree(pi.dwProcessId);
-
-				/* Close handles */
-				CloseHandle(pi.hProcess);
-				CloseHandle(pi.hThread);
-
-				/* Remove left over files */
-				for (auto i = 0; i < 5; i++)
-				{
-					try
-					{
-						/* We have to wait for the file handles to close. */
-						std::filesystem::remove(DecompName);
-						std::filesystem::remove(DmpBytecodeName);
-						break;
-					}
-					catch (std::exception&)
-					{
-						Sleep(1000);
-					}
-				}
-
-				std::function<int(RbxLua)> ret([](RbxLua NRL)
-					{
-						/* Push to stack. */
-						NRL.PushString(OBFUSCATE_STR("--SynapseX Decompiler\n--Decompiler timeout."));
-						return 1;
-					});
-				return ret;
-			}
-
-            CloseHandle(pi.hProcess);
-            CloseHandle(pi.hThread);
+		x = (x + (DWORD)Point.x) * (65535 / width);
+		y = (y + (DWORD)Point.y) * (65535 / height);
 
-            /* Grab file contents */
-            std::ifstream t(DecompName);
-            std::string str((std::istreambuf_iterator<char>(t)),
-                std::istreambuf_iterator<char>());
-            t.close();
+		mouse_event(MOUSEEVENTF_ABSOLUTE | MOUSEEVENTF_MOVE, x, y, 0, 0);
+		return 0;
+	}
 
-            /* Add watermark */
-            str.insert(0, OBFUSCATE_STR("--SynapseX Decompiler\n\n"));
+	int RbxApi::mousescroll(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
 
-            /* Remove files */
-            std::filesystem::remove(DecompName);
-            std::filesystem::remove(DmpBytecodeName);
+        DWORD scrollAmount = (DWORD)RL.CheckLong(1);
 
-			std::function<int(RbxLua)> ret([str](RbxLua NRL)
-				{
-					/* Push to stack */
-					NRL.PushLString(str.c_str(), str.size());
+		if (GetForegroundWindow() == syn::RobloxWindow)
+            mouse_event(MOUSEEVENTF_WHEEL, 0, 0, scrollAmount, 0);
 
-					return 1;
-				});
-			return ret;
-        });
-    }
+		return 0;
+	}
 
-	int RbxApi::dumpstring(DWORD rL)
+	int RbxApi::newcclosurehandler(DWORD rL)
 	{
 		syn::RbxLua RL(rL);
 
-		size_t ScriptLength;
-
-        const auto ScriptPointer = RL.CheckLString(1, &ScriptLength);
-		const auto Script = std::string(ScriptPointer, ScriptLength);
+		/* Stack:
+		 * 1 - newcclosurehandler
+		 * 2 - synapse lua function (user)
+		 * 3 - newcclosurestub
+		 * 4 - caller function (what we want)
+		 */
 
-        if (Script.find("\033Lua") == 0)
-            return RL.LError("bytecode is not supported");
+		/* Lazy coding inbound, we need to create a fake exception trace for our error */
+		size_t ErrSize;
+		const auto ErrPtr = RL.ToLString(-1, &ErrSize);
+		const auto Err = std::string(ErrPtr, ErrSize);
 
-		std::string BC;
-		try
+		/* Check for yield */
+		if (Err.find("attempt to yield across") != std::string::npos && Err.find("is not") == std::string::npos)
 		{
-#ifndef EnableHSVMOnlyLuaU
-#ifdef EnableHSVM
-			const auto NState = luaL_newstate();
-
-			if (luaL_loadbuffer(NState, Script.c_str(), Script.size(), BS_LUA, ""))
-			{
-				/* Error while compiling, report back to translation caller */
-				const std::string Err = lua_tostring(NState, -1);
-				lua_close(NState);
-				throw std::exception(Err.c_str());
-			}
-
-			luaL_Buffer B;
-			luaL_buffinit(NState, &B);
-			if (lua_dump(NState, syn::LuaTranslator::DumpWriter, &B) != 0) throw std::exception("failed to dump bytecode");
-			luaL_pushresult(&B);
-			size_t Len;
-			const auto BCC = lua_tolstring(NState, -1, &Len);
+			RL.Pop(1);
+			RL.PushBoolean(true);
+			return 1;
+		}
 
-			BC = std::string(BCC, Len);
+		/* If not, start our secondary exception handling */
+		lua_Debug ar;
+		if (!RL.GetStack(4, &ar)) return RL.GetTop();
+		RL.GetInfo("Sl", &ar);
 
-			lua_close(NState);
-#else
-			auto Translator = syn::LuaTranslator::GetSingleton();
-			Translator->ConvertInCurrentThread(RL, Script, 0);
-			BC = Translator->Dump(RL);
-#endif
-#else
-			if (IsLuaU)
-			{
-				const auto NState = luaL_newstate();
+		lua_Debug ar_syn;
+		if (!RL.GetStack(2, &ar_syn)) return RL.GetTop();
+		RL.GetInfo("Sl", &ar_syn);
 
-				if (luaL_loadbuffer(NState, Script.c_str(), Script.size(), BS_HSVM, ""))
-				{
-					/* Error while compiling, report back to translation caller */
-					const std::string Err = lua_tostring(NState, -1);
-					lua_close(NState);
-					throw std::exception(Err.c_str());
-				}
+		/* Check for non-newcclosure error */
+		if (Err.find(std::string(ar_syn.source).erase(0, 1)) == std::string::npos)
+			return RL.GetTop();
 
-				luaL_Buffer B;
-				luaL_buffinit(NState, &B);
-				if (lua_dump(NState, syn::LuaTranslator::DumpWriter, &B) != 0) throw std::exception("failed to dump bytecode");
-				luaL_pushresult(&B);
-				size_t Len;
-				const auto BCC = lua_tolstring(NState, -1, &Len);
+		std::vector<std::string> Tokenized;
+		SplitString(Err, ":", Tokenized);
 
-				BC = std::string(BCC, Len);
+		/* Use the source from the real function */
+		std::stringstream Stream;
+		Stream << std::string(ar.source).erase(0, 1) << ":" << ar.currentline << ":";
 
-				lua_close(NState);
-			}
-			else
-			{
-				auto Translator = syn::LuaTranslator::GetSingleton();
-				Translator->ConvertInCurrentThread(RL, Script, 0);
-				BC = Translator->Dump(RL);
-			}
-#endif
-		}
-		catch (const std::exception& ex)
+		/* Put actual error */
+		for (size_t i = 0; i < Tokenized.size(); i++)
 		{
-			throw std::exception(ex.what());
+			if (i == 0 || i == 1) continue;
+			Stream << Tokenized.at(i) << ":";
 		}
 
-		RL.PushLString(BC.c_str(), BC.size());
+		/* Erase final ':' from string */
+		auto Final = Stream.str();
+		Final.erase(Final.size() - 1);
 
-		return 1;
+		RL.Pop(1);
+		RL.PushLString(Final.c_str(), Final.size());
+
+		return RL.GetTop();
 	}
 
-	int RbxApi::httpget(DWORD rL)
+	int RbxApi::newcclosurestub(DWORD rL)
 	{
 		syn::RbxLua RL(rL);
-		RbxYield RYield(RL);
 
-		size_t CSize;
-		const auto CStr = RL.CheckLString(1, &CSize);
-		const auto Url = std::string(CStr, CSize);
+		const auto Func = (*(SynCClosure*)RL.ToUserData(lua_upvalueindex(1))).ExtraSpace;
+		RL.PushRawObject(Func, R_LUA_TFUNCTION);
+		RL.Insert(1);
+		RL.PushRawObject(CClosureHandlers[syn::PointerObfuscation::DeObfuscateGlobalState(RL + L_GS)], R_LUA_TFUNCTION);
+		RL.Insert(1);
 
-		if (Url.find("http"))
-			return RL.ArgError(1, "Invalid protocol specified (expected 'http://' or 'https://')");
+		const auto Res = RL.PCall(RL.GetTop() - 2, LUA_MULTRET, 1);
 
-		return RYield.Execute([Url]()
+		RL.Remove(1);
+		
+		if (Res && Res != LUA_YIELD)
 		{
-			auto result = cpr::Get(cpr::Url{ Url },
-				cpr::Header{ {"User-Agent", "Roblox/WinInet"} });
-
-			if (HttpStatus::isError(result.status_code))
-			{
-				auto Err = "Http Error " + std::to_string(result.status_code) + " - " + HttpStatus::reasonPhrase(
-					result.status_code);
+			if (RL.IsBoolean(-1))
+				return RL.RYield(0);
 
-				throw std::exception(Err.c_str());
-			}
+			return RL.Error();
+		}
 
-			return [result](RbxLua NRL)
-			{
-				NRL.PushLString(result.text.c_str(), result.text.size());
-				return 1;
-			};
-		});
+		return RL.GetTop();
 	}
 
-	int RbxApi::httppost(DWORD rL)
+	int RbxApi::newcclosurestub_noupvals(DWORD rL, SynCClosure cL)
 	{
 		syn::RbxLua RL(rL);
 
-		std::string Url = RL.CheckString(1);
-
-		size_t DCSize;
-		const auto DCStr = RL.CheckLString(2, &DCSize);
-		const auto Data = std::string(DCStr, DCSize);
-
-		auto ContentType = RL.CheckString(3);
+		const auto Func = cL.ExtraSpace;
+		RL.PushRawObject(Func, R_LUA_TFUNCTION);
+		RL.Insert(1);
+		RL.PushRawObject(CClosureHandlers[syn::PointerObfuscation::DeObfuscateGlobalState(RL + L_GS)], R_LUA_TFUNCTION);
+		RL.Insert(1);
 
-		if (Url.find("http") != 0) throw std::exception("Invalid protocol specified (expected 'http://' or 'https://')");
+		const auto Res = RL.PCall(RL.GetTop() - 2, LUA_MULTRET, 1);
 
-		auto result = Post(cpr::Url{ Url },
-			cpr::Header{ {"User-Agent", "Roblox/WinInet"} },
-			cpr::Body{ Data },
-			cpr::Header{ {"Content-Type", ContentType} });
+		RL.Remove(1);
 
-		if (HttpStatus::isError(result.status_code))
+		if (Res && Res != LUA_YIELD)
 		{
-			auto Err = "Http Error " + std::to_string(result.status_code) + " - " + HttpStatus::reasonPhrase(
-				result.status_code);
+			if (RL.IsBoolean(-1))
+				return RL.RYield(0);
 
-			throw std::exception(Err.c_str());
+			return RL.Error();
 		}
 
-		RL.PushLString(result.text.c_str(), result.text.size());
-
-		return 1;
+		return RL.GetTop();
 	}
 
-	int RbxApi::httprequest(DWORD rL)
+	int RbxApi::newcclosure(DWORD rL)
 	{
 		syn::RbxLua RL(rL);
-		RbxYield RYield(RL);
-
-		RL.CheckType(1, R_LUA_TTABLE);
 
-		RL.GetField(1, "Url");
-		if (RL.Type(-1) != R_LUA_TSTRING)
-			return RL.LError("Invalid or no 'Url' field specified in request table");
+        RL.CheckType(1, R_LUA_TFUNCTION);
 
-		size_t UrlSize;
-		const auto UrlCStr = RL.CheckLString(-1, &UrlSize);
-		std::string Url(UrlCStr, UrlSize);
+        if (RL.IsCFunction(1))
+            return RL.ArgError(1, "lua function expected");
 
-		if (Url.find("http://") != 0 && Url.find("https://") != 0)
-			return RL.LError("Only 'http' and 'https' protocols are supported for the 'Url' field.");
+		/* lazy hack so we don't get GC'd */
+		RL.PushValue(1);
+		RL.SetField(LUA_REGISTRYINDEX, RandomString(16).c_str());
 
-		RL.Pop(1);
+		DWORD& CCH = CClosureHandlers[syn::PointerObfuscation::DeObfuscateGlobalState(RL + L_GS)];
 
-		enum RequestMethods
+		if (!CCH)
 		{
-			H_GET,
-			H_HEAD,
-			H_POST,
-			H_PUT,
-			H_DELETE,
-			H_OPTIONS
-		};
+			/* prevent CClosure handler from being GC'd */
+			RL.PushCFunction(syn::RbxApi::newcclosurehandler);
+			CCH = RL.ToPointer(-1);
+			RL.SetField(LUA_REGISTRYINDEX, RandomString(16).c_str());
+		}
 
-		std::map<std::string, RequestMethods> RequestMethodMap =
-		{
-			{ "get", H_GET },
-			{ "head", H_HEAD },
-			{ "post", H_POST },
-			{ "put", H_PUT },
-			{ "delete", H_DELETE },
-			{ "options", H_OPTIONS }
-		};
+		const auto CC = new SynCClosure();
+		CC->Address = (DWORD) newcclosurestub;
+		CC->ExtraSpace = RL.ToPointer(1);
 
-		auto Method = H_GET;
+		RL.PushLightUserData(CC);
+		RL.CreateCClosure(1);
 
-		RL.GetField(1, "Method");
-		if (RL.Type(-1) == R_LUA_TSTRING)
-		{
-			std::string MethodS = RL.CheckString(-1);
-			std::transform(MethodS.begin(), MethodS.end(), MethodS.begin(), tolower);
+		return 1;
+	}
 
-			if (!RequestMethodMap.count(MethodS))
-				return RL.LError("Request type '%s' is not a valid http request type.", MethodS.c_str());
+    int RbxApi::hookfunction(DWORD rL)
+    {
+        syn::RbxLua RL(rL);
 
-			Method = RequestMethodMap[MethodS];
-		}
+        RL.CheckType(1, R_LUA_TFUNCTION);
+        RL.CheckType(2, R_LUA_TFUNCTION);
 
-		RL.Pop(1);
+        if (RL.IsCFunction(1))
+        {
+            if (!RL.IsCFunction(2))
+                return RL.ArgError(2, "C function expected");
 
-		cpr::Header Headers;
+            const auto OldClosure = (CClosure*) RL.ToPointer(1);
+            const auto HookClosure = (CClosure*) RL.ToPointer(2);
 
-		RL.GetField(1, "Headers");
-		if (RL.Type(-1) == R_LUA_TTABLE)
-		{
-			RL.PushNil();
+			/* Make sure we don't fuck ourselves over with GC */
+			RL.PushValue(2);
+			RL.SetField(LUA_REGISTRYINDEX, RandomString(16).c_str());
 
-			while (RL.Next(-2))
-			{
-				if (RL.Type(-2) != R_LUA_TSTRING || RL.Type(-1) != R_LUA_TSTRING)
-					return RL.LError("'Headers' table must contain string keys/values.");
+            const auto OldCFunction = syn::PointerObfuscation::DeObfuscateCClosure((DWORD) OldClosure + 20);
+            const auto HookCFunction = syn::PointerObfuscation::DeObfuscateCClosure((DWORD) HookClosure + 20);
 
-				size_t HeaderKeySize;
-				const auto HeaderKeyCStr = RL.CheckLString(-2, &HeaderKeySize);
-				std::string HeaderKey(HeaderKeyCStr, HeaderKeySize);
+            /* Backup old function */
 
-				auto HeaderKeyCopy = std::string(HeaderKey);
-				std::transform(HeaderKeyCopy.begin(), HeaderKeyCopy.end(), HeaderKeyCopy.begin(), tolower);
+            for (auto i = 0; i < OldClosure->nupvalues; i++)
+                RL.PushObject(&OldClosure->upvalue[i]);
 
-				if (HeaderKeyCopy == "content-length")
-					return RL.LError("Headers: 'Content-Length' header cannot be overwritten.");
+            RL.PushCClosure((r_lua_CFunction) OldCFunction, OldClosure->nupvalues);
 
-				size_t HeaderValueSize;
-				const auto HeaderValueCStr = RL.CheckLString(-1, &HeaderValueSize);
-				std::string HeaderValue(HeaderValueCStr, HeaderValueSize);
+			if (!OldClosure->nupvalues && HookClosure->nupvalues == 1)
+			{
+				/* Check if we can use 0 upvalue hookfunction */
+				const auto CC = (SynCClosure*) HookClosure->upvalue[0].value.p;
+
+				if (CC != nullptr && CC->Address == (DWORD) newcclosurestub)
+				{
+					/* We can. */
+					SynCClosure SCC = { (DWORD) newcclosurestub_noupvals, CC->ExtraSpace };
 
-				Headers.insert({ HeaderKey, HeaderValue });
+					HookedFunctionsMap[(std::uintptr_t) OldClosure] = SCC;
+					syn::PointerObfuscation::ObfuscateCClosure((DWORD) OldClosure + 20, HookCFunction);
 
-				RL.Pop(1);
+					return 1;
+				}
 			}
-		}
 
-		RL.Pop(1);
-
-		cpr::Cookies Cookies;
+            /* Hook */
+            syn::PointerObfuscation::ObfuscateCClosure((DWORD) OldClosure + 20, HookCFunction);
+            OldClosure->nupvalues = HookClosure->nupvalues;
 
-		RL.GetField(1, "Cookies");
-		if (RL.Type(-1) == R_LUA_TTABLE)
-		{
-			std::map<std::string, std::string> RCookies;
+            for (auto i = 0; i < HookClosure->nupvalues; i++)
+            {
+                auto OT = &OldClosure->upvalue[i];
+                const auto HT = &HookClosure->upvalue[i];
 
-			RL.PushNil();
+                OT->value = HT->value;
+                OT->tt = HT->tt;
+            }
 
-			while (RL.Next(-2))
-			{
-				if (RL.Type(-2) != R_LUA_TSTRING || RL.Type(-1) != R_LUA_TSTRING)
-					return RL.LError("'Cookies' table must contain string keys/values.");
+            /* Return */
+            return 1;
+        }
+        else
+        {
+            if (RL.IsCFunction(2))
+                return RL.ArgError(2, "lua function expected");
 
-				size_t CookieKeySize;
-				const auto CookieKeyCStr = RL.CheckLString(-2, &CookieKeySize);
-				std::string CookieKey(CookieKeyCStr, CookieKeySize);
+            const auto OldClosure = (DWORD) RL.ToPointer(1);
+            const auto HookClosure = (DWORD) RL.ToPointer(2);
 
-				size_t CookieValueSize;
-				const auto CookieValueCStr = RL.CheckLString(-1, &CookieValueSize);
-				std::string CookieValue(CookieValueCStr, CookieValueSize);
+			/* Make sure we don't fuck ourselves over with GC */
+			RL.PushValue(2);
+			RL.SetField(LUA_REGISTRYINDEX, RandomString(16).c_str());
 
-				RCookies[CookieKey] = CookieValue;
+            const auto OldLFunction = syn::PointerObfuscation::DeObfuscateLClosure((DWORD) OldClosure + 20);
+            const auto HookLFunction = syn::PointerObfuscation::DeObfuscateLClosure((DWORD) HookClosure + 20);
 
-				RL.Pop(1);
-			}
+            if (*(BYTE*)(HookClosure + LCL_NUPVALS) > *(BYTE*)(OldClosure + LCL_NUPVALS) && *(BYTE*)(HookClosure + LCL_NUPVALS) > 1)
+                return RL.ArgError(2, "hook function has too many upvalues");
 
-			Cookies = RCookies;
-		}
+            RL.PushString(RandomString(16).c_str());
+            RL.PushValue(2);
+            RL.SetTable(LUA_REGISTRYINDEX);
 
-		RL.Pop(1);
+            /* Backup old function */
+            DWORD LC = RL.NewLClosure(*(lu_byte*)(OldClosure + LCL_NUPVALS), *(lu_byte*)(OldClosure + LCL_MAXSTACKSIZE), NULL);
 
-		auto HasUserAgent = false;
-		for (auto& Header : Headers)
-		{
-			auto HeaderName = Header.first;
-			std::transform(HeaderName.begin(), HeaderName.end(), HeaderName.begin(), tolower);
+            memcpy((void*)(DWORD*)(LC + 4), (void*)(DWORD*)(OldClosure + 4), sizeLclosure(*(lu_byte*)(OldClosure + LCL_NUPVALS) + 1));
 
-			if (HeaderName == "user-agent")
-				HasUserAgent = true;
-		}
+            syn::PointerObfuscation::ObfuscateLClosure(LC + 20, OldLFunction);
 
-		if (!HasUserAgent)
-		{
-			Headers.insert({ "User-Agent", std::string("synx/") + OBFUSCATE_STR(SYNAPSE_VERSION) });
-		}
+            /* Hook */
+            memcpy((void*)(DWORD*)(OldClosure + 4), (void*)(DWORD*)(HookClosure + 4), sizeLclosure(*(lu_byte*)(HookClosure + LCL_NUPVALS) + 1));
 
-		std::string Body;
-		RL.GetField(1, "Body");
-		if (RL.Type(-1) == R_LUA_TSTRING)
-		{
-			if (Method == H_GET || Method == H_HEAD)
-				return RL.LError("'Body' cannot be present in GET or HEAD requests.");
+            syn::PointerObfuscation::ObfuscateLClosure(OldClosure + 20, HookLFunction);
 
-			size_t BodySize;
-			const auto BodyCStr = RL.CheckLString(-1, &BodySize);
-			Body = std::string(BodyCStr, BodySize);
-		}
+            /* Push LClosure to stack */
+            r_setclvalue(*(TValue**)(RL + L_TOP), LC);
+            r_incr_top(RL);
 
-		RL.Pop(1);
+            /* Return */
+            return 1;
+        }
+    }
 
-		return RYield.Execute([Method, Url, Headers, Cookies, Body]()
+	bool RbxApi::decompile_sanity_check(syn::Instance Inst)
+	{
+		try
 		{
-			cpr::Response Response;
-
-			switch (Method)
-			{
-			case H_GET:
+			if (Inst.GetInstanceClassName() == "LocalScript")
 			{
-				Response = cpr::Get(
-					cpr::Url{ Url },
-					Cookies,
-					Headers
-				);
-
-				break;
+				if (!*(DWORD*)(Inst + 0xF8)) return false;
+				auto Bytecode = *(std::string*)(*(DWORD*)(Inst + 0xF8) + 0x18);
+				if (Bytecode.size() <= 8)
+				{
+					Bytecode = *(std::string*)(Inst + 0xBC); /* CachedRemoteSource + 0x18 */
+					if (Bytecode.size() <= 8) return false;
+				}
+				return true;
 			}
 
-			case H_HEAD:
+			auto RProt = new RbxProtectedString();
+			static DWORD ModScrDump = 0;
+			if (!ModScrDump) ModScrDump = RbxLua::GetBinValue(FNVA1_CONSTEXPR("modscriptdump"));
+			const auto ProtectedString = ((int(__thiscall*)(int, int))ModScrDump)(Inst, (DWORD)RProt);
+			auto Bytecode = *(std::string*)(ProtectedString + 0x18);
+			if (Bytecode.size() <= 8)
 			{
-				Response = cpr::Head(
-					cpr::Url{ Url },
-					Cookies,
-					Headers
-				);
-
-				break;
+				Bytecode = *(std::string*)(Inst + 0xBC); /* CachedRemoteSource + 0x18 */
+				if (Bytecode.size() <= 8) return false;
 			}
 
-			case H_POST:
-			{
-				Response = cpr::Post(
-					cpr::Url{ Url },
-					cpr::Body{ Body },
-					Cookies,
-					Headers
-				);
+			return true;
+		}
+		catch (std::exception&)
+		{
+			return false;
+		}
+	}
 
-				break;
-			}
+	/* Decompiled output keyed by an xxh3 of the bytecode and mode, least recently used entries go once the total passes MaxBytes */
+	class DecompileCache
+	{
+	public:
+		static constexpr size_t MaxBytes = 32 * 1024 * 1024;
 
-			case H_PUT:
-			{
-				Response = cpr::Put(
-					cpr::Url{ Url },
-					cpr::Body{ Body },
-					Cookies,
-					Headers
-				);
+		bool Find(const std::string& Key, std::string& Source)
+		{
+			std::lock_guard<std::mutex> Guard(Mutex);
 
-				break;
-			}
+			const auto Found = Index.find(Key);
+			if (Found == Index.end())
+				return false;
 
-			case H_DELETE:
-			{
-				Response = cpr::Delete(
-					cpr::Url{ Url },
-					cpr::Body{ Body },
-					Cookies,
-					Headers
-				);
+			Entries.splice(Entries.begin(), Entries, Found->second);
+			Source = Found->second->second;
 
-				break;
-			}
+			return true;
+		}
 
-			case H_OPTIONS:
-			{
-				Response = cpr::Options(
-					cpr::Url{ Url },
-					cpr::Body{ Body },
-					Cookies,
-					Headers
-				);
+		void Insert(const std::string& Key, const std::string& Source)
+		{
+			std::lock_guard<std::mutex> Guard(Mutex);
 
-				break;
-			}
+			if (Source.size() > MaxBytes || Index.count(Key))
+				return;
 
-			default:
-			{
-				throw std::exception("invalid request type");
-			}
-			}
+			Entries.emplace_front(Key, Source);
+			Index[Key] = Entries.begin();
+			Bytes += Source.size();
 
-			return [Response](RbxLua NRL) 
+			while (Bytes > MaxBytes)
 			{
-				NRL.NewTable();
+				Bytes -= Entries.back().second.size();
+				Index.erase(Entries.back().first);
+				Entries.pop_back();
+			}
+		}
 
-				NRL.PushBoolean(HttpStatus::isSuccessful(Response.status_code));
-				NRL.SetField(-2, "Success");
+	private:
+		std::mutex Mutex;
+		std::list<std::pair<std::string, std::string>> Entries; /* most recently used first */
+		std::unordered_map<std::string, std::list<std::pair<std::string, std::string>>::iterator> Index;
+		size_t Bytes = 0;
+	};
 
-				NRL.PushInteger(Response.status_code);
-				NRL.SetField(-2, "StatusCode");
+	static DecompileCache DecompiledSources;
 
-				NRL.PushString(HttpStatus::reasonPhrase(Response.status_code).c_str());
-				NRL.SetField(-2, "StatusMessage");
+	/* Also kept across sessions under workspace/decompiled when UseDecompilerDiskCache is set */
+	static std::wstring decompile_cache_path(const std::string& Key)
+	{
+		return WorkspaceDirectory + L"\\decompiled\\" + ConvertToWStr(Key) + L".lua";
+	}
 
-				NRL.NewTable();
+	void KillProcessTree(const DWORD ProcId)
+	{
+		PROCESSENTRY32 PE;
+		memset(&PE, 0, sizeof(PROCESSENTRY32));
+		PE.dwSize = sizeof(PROCESSENTRY32);
 
-				for (auto& Header : Response.header)
-				{
-					NRL.PushLString(Header.first.c_str(), Header.first.size());
-					NRL.PushLString(Header.second.c_str(), Header.second.size());
+		const auto HSnap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
 
-					NRL.SetTable(-3);
-				}
+		if (Process32First(HSnap, &PE))
+		{
+			do 
+			{
+				if (PE.th32ParentProcessID == ProcId)
+					KillProcessTree(PE.th32ProcessID);
+			} while (Process32Next(HSnap, &PE));
+		}
 
-				NRL.SetField(-2, "Headers");
+		const auto HProc = OpenProcess(PROCESS_TERMINATE, FALSE, ProcId);
 
-				NRL.NewTable();
+		if (HProc)
+		{
+			TerminateProcess(HProc, 1);
+			CloseHandle(HProc);
+		}
+	}
 
-				for (auto& Cookie : Response.cookies.map_)
-				{
-					NRL.PushLString(Cookie.first.c_str(), Cookie.first.size());
-					NRL.PushLString(Cookie.second.c_str(), Cookie.second.size());
+	enum DecModes
+	{
+		DEC_DUMP,
+		DEC_LEGACY,
+		DEC_NEW,
+	};
 
-					NRL.SetTable(-3);
-				}
+	static bool decompile_parse_mode(std::string Name, DecModes& Mode)
+	{
+		std::transform(Name.begin(), Name.end(), Name.begin(), tolower);
 
-				NRL.SetField(-2, "Cookies");
+		if (Name == "dump")
+			Mode = DEC_DUMP;
+		else if (Name == "regular" || Name == "reg" || Name == "legacy" || Name == "old")
+			Mode = DEC_LEGACY;
+		else if (Name == "new" || Name == "beta")
+			Mode = DEC_NEW;
+		else
+			return false;
 
-				NRL.PushLString(Response.text.c_str(), Response.text.size());
-				NRL.SetField(-2, "Body");
-				return 1;
-			};
-		});
+		return true;
 	}
 
-	int RbxApi::readfile(DWORD rL)
+	struct DecompileJob
 	{
-		syn::RbxLua RL(rL);
+		DecModes Mode;
+		DWORD Timeout;
+		std::string BC, DecKey, CacheKey;
+	};
 
-		size_t PathSize;
-		const auto PathCStr = RL.CheckLString(1, &PathSize);
-		auto Path = std::string(PathCStr, PathSize);
+	/* Pulls the bytecode out of the value at Index into Job. Returns how many results it pushed when the value
+	   needs no decompiler run (messages, dumps, cache hits), 0 when Job is ready for decompile_run */
+	static int decompile_prepare(RbxLua RL, const int Index, DecompileJob& Job)
+	{
+		std::string& BC = Job.BC;
+		std::string& DecKey = Job.DecKey;
+		const auto DecMode = Job.Mode;
+		std::string CacheSource; /* the bytecode before any per-call obfuscation, empty when there is none */
 
-		std::replace(Path.begin(), Path.end(), '/', '\\');
+		switch (RL.Type(Index))
+		{
+		    case R_LUA_TUSERDATA:
+		    case R_LUA_TLIGHTUSERDATA:
+		    {
+		        if (!RbxApi::checkinstance(RL, Index))
+		            return RL.ArgError(Index, "Variant<userdata[LocalScript, ModuleScript], function, string, proto> expected");
 
-		const std::string Extention = PathFindExtensionA(Path.c_str());
+		        syn::Instance Inst = DereferenceSmartPointerInstance((DWORD)RL.ToUserData(Index));
+		        const std::string ClassName = Inst.GetInstanceClassName();
 
-		if (Path.find("..") != std::string::npos)
-            return RL.LError("attempt to escape directory");
+		        if (ClassName != "LocalScript" && ClassName != "ModuleScript")
+		            return RL.ArgError(Index, "Variant<userdata[LocalScript, ModuleScript], function, string, proto> expected");
 
-		std::wstring WPath = WorkspaceDirectory + L"\\" + ConvertToWStr(Path);
+		        if (!RbxApi::decompile_sanity_check(Inst))
+		        {
+		            RL.PushString(
+		                "--SynapseX Decompiler\n--This script could not be decompiled due to it having no bytecode.\n--This is usually caused by trying to decompile a Synapse X generated script.");
+		            return 1;
+		        }
 
-		if (!std::filesystem::exists(WPath.c_str()))
-            return RL.LError("file does not exist");
+		        DWORD ProtectedString;
+		        if (ClassName == "LocalScript")
+		            ProtectedString = *(DWORD*)(Inst + 0xF8);
+		        else
+		        {
+		            auto RProt = new RbxProtectedString();
+		            static DWORD ModScrDump = 0;
+		            if (!ModScrDump) ModScrDump = RbxLua::GetBinValue(FNVA1_CONSTEXPR("modscriptdump"));
+		            ProtectedString = ((int(__thiscall*)(int, int))ModScrDump)(Inst, (DWORD)RProt);
+		        }
 
-		std::ifstream Stream(WPath, std::ios_base::binary);
-		std::string Final((std::istreambuf_iterator<char>(Stream)),
-		                  std::istreambuf_iterator<char>());
+		        if ((*(std::string*)(ProtectedString + 0x18)).size() <= 8)
+		            ProtectedString = Inst + 0xA4;
 
-		RL.PushLString(Final.c_str(), Final.size());
-
-		return 1;
-	}
-
-	int RbxApi::loadfile(DWORD rL)
-	{
-		syn::RbxLua RL(rL);
-
-		size_t PathSize;
-		const auto PathCStr = RL.CheckLString(1, &PathSize);
-		auto Path = std::string(PathCStr, PathSize);
+		        static DWORD HateFlag = 0;
+		        if (!HateFlag) HateFlag = RbxLua::GetBinValue(FNVA1_CONSTEXPR("hateflag"));
+		        static DWORD Deserialize = 0;
+		        if (!Deserialize) Deserialize = RbxLua::GetBinValue(FNVA1_CONSTEXPR("deserialize"));
 
-		std::replace(Path.begin(), Path.end(), '/', '\\');
+		        const auto Bytecode = *(std::string*)(ProtectedString + 0x18);
+		        CacheSource = Bytecode;
+		        const auto HateBackup = *(DWORD*)HateFlag;
+		        ((int(__cdecl*)(DWORD, const std::string&, const char*, DWORD))Deserialize)(
+		            (DWORD) RL, Bytecode, OBFUSCATE_STR("SXDecompiler"), 1);
+		        *(DWORD*)HateFlag = HateBackup;
 
-		if (Path.find("..") != std::string::npos)
-			return RL.LError("attempt to escape directory");
+		        if (RL.Type(-1) != R_LUA_TFUNCTION || !RL.ToPointer(-1))
+		        {
+		            RL.PushString(
+		                "--SynapseX Decompiler\n--This script could not be decompiled due to it having invalid bytecode.\n--This is usually caused by trying to decompile a Synapse X generated script.");
 
-		const std::string Extention = PathFindExtensionA(Path.c_str());
-		std::wstring WPath = WorkspaceDirectory + L"\\" + ConvertToWStr(Path);
+		            return 1;
+		        }
+		    }
+		    case R_LUA_TFUNCTION:
+		    {
+		        if (RL.IsCFunction(Index))
+		            return RL.ArgError(Index, "Variant<userdata[LocalScript, ModuleScript], function, string, proto> expected");
 
-		if (!std::filesystem::exists(WPath.c_str()))
-            return RL.LError("file does not exist");
+		        if (syn::LuaTranslator::GetSynapseMarked(RL, -1))
+		        {
+		            RL.PushString(
+		                "--SynapseX Decompiler\n--This function can not be decompiled due to it being created by Synapse X.\n--You can use `dumpstring(\"<your code here>\")` to convert to Roblox format bytecode though.");
 
-		std::ifstream Stream(WPath, std::ios_base::binary);
-		std::string Final((std::istreambuf_iterator<char>(Stream)),
-		                  std::istreambuf_iterator<char>());
+		            return 1;
+		        }
 
-		RL.GetGlobal("loadstring");
-		RL.PushLString(Final.c_str(), Final.size());
-		RL.PCall(1, 1, 0);
+		        try
+		        {
+		            const auto Translator = syn::LuaTranslator::GetSingleton();
+		            if (DecMode == DEC_NEW)
+		            {
+		                VM_TIGER_WHITE_START;
 
-		return 1;
-	}
+		                auto LS = syn::LuaTranslator::AcquireState();
+		                auto LC = Translator->DumpToFunc(LS, RL);
+		                auto ObfDumped = syn::ObfuscatedDumper(LC->l).Dump();
+		                BC = std::get<0>(ObfDumped);
+		                DecKey = std::get<1>(ObfDumped);
+		                syn::LuaTranslator::ReleaseState(LS);
+		                
+		                VM_TIGER_WHITE_END;
+		            }
+		            else
+		            {
+		                BC = Translator->Dump(RL);
+		                if (CacheSource.empty())
+		                    CacheSource = BC;
+		            }
+		        }
+		        catch (const std::exception& ex)
+		        {
+		            RL.PushString(ex.what());
 
-    /* TODO: Abstract out base */
-	int RbxApi::writefile(DWORD rL)
-	{
-		syn::RbxLua RL(rL);
+		            return 2;
+		        }
+		        break;
+		    }
+		    case R_LUA_TPROTO:
+		    {
+		        if (syn::LuaTranslator::GetSynapseMarked(RL, -1))
+		        {
+		            RL.PushString(
+		                "--SynapseX Decompiler\n--This function can not be decompiled due to it being created by Synapse X.\n--You can use `dumpstring(\"<your code here>\")` to convert to Roblox format bytecode though.");
 
-		size_t PathSize;
-		const auto PathCStr = RL.CheckLString(1, &PathSize);
-		auto Path = std::string(PathCStr, PathSize);
+		            return 1;
+		        }
 
-		size_t ContentsSize;
-		const auto ContentsCStr = RL.CheckLString(2, &ContentsSize);
+		        try
+		        {
+		            const auto Translator = syn::LuaTranslator::GetSingleton();
+		            if (DecMode == DEC_NEW)
+		            {
+		                VM_TIGER_WHITE_START;
 
-		std::replace(Path.begin(), Path.end(), '/', '\\');
+		                auto LS = syn::LuaTranslator::AcquireState();
+		                auto LP = Translator->DumpToProto(LS, RL);
+		                LClosure lc{};
+		                lc.p = LP;
+		                auto ObfDumped = syn::ObfuscatedDumper(lc).Dump();
+		                BC = std::get<0>(ObfDumped);
+		                DecKey = std::get<1>(ObfDumped);
+		                syn::LuaTranslator::ReleaseState(LS);
 
-		const std::string Extention = PathFindExtensionA(Path.c_str());
+		                VM_TIGER_WHITE_END;
+		            }
+		            else
+		            {
+		                BC = Translator->Dump(RL);
+		                if (CacheSource.empty())
+		                    CacheSource = BC;
+		            }
+		        }
+		        catch (const std::exception& ex)
+		        {
+		            RL.PushString(ex.what());
 
-		std::vector<std::string> DisallowedExtensions =
-		{
-			".exe", ".scr", ".bat", ".com", ".csh", ".msi", ".vb", ".vbs", ".vbe", ".ws", ".wsf", ".wsh", ".ps1"
-		};
+		            return 2;
+		        }
+		        break;
+		    }
+		    case R_LUA_TSTRING:
+		    {
+		        std::size_t BCLength;
+		        const auto BCPointer = RL.ToLString(Index, &BCLength);
 
-		for (std::string& Test : DisallowedExtensions)
-			if (equals_ignore_case(Extention, Test)) 
-                return RL.LError("forbidden extension");
+		        BC = std::string(BCPointer, BCLength);
+		        CacheSource = BC;
 
-		if (Path.find("..") != std::string::npos)
-            return RL.LError("attempt to escape directory");
+		        if (DecMode == DEC_NEW)
+		        {
+		            VM_TIGER_WHITE_START;
 
-		std::wstring WPath = WorkspaceDirectory + L"\\" + ConvertToWStr(Path);
+		            DecKey = RandomString(16);
+		            const auto SKeyGrab = (DecKey.at(0) * OBFUSCATED_NUM_UNCACHE(16777216) + DecKey.at(1) * OBFUSCATED_NUM_UNCACHE(65536) + DecKey.at(2) * OBFUSCATED_NUM_UNCACHE(256) + DecKey.at(3)) % 128;
 
-		std::ofstream Out;
-		Out.open(WPath, std::ios::out | std::ios::binary);
-		Out.write(ContentsCStr, ContentsSize);
-		Out.close();
+		            for (char& i : BC)
+			            i ^= SKeyGrab;
 
-		return 0;
-	}
+		            auto FKey = OBFUSCATE_STR("F8ixT9H4z8moGusU") + DecKey;
+		            size_t FLen;
+		            auto FRet = xxtea_encrypt(BC.c_str(), BC.length(), FKey.c_str(), &FLen);
 
-	int RbxApi::isfile(DWORD rL)
-	{
-		syn::RbxLua RL(rL);
+		            BC = std::string(Base64Encode((byte*)FRet, FLen));
 
-		size_t PathSize;
-		const auto PathCStr = RL.CheckLString(1, &PathSize);
-		auto Path = std::string(PathCStr, PathSize);
+		            VM_TIGER_WHITE_END;
+		        }
 
-		if (Path.find("..") != std::string::npos)
-            return RL.LError("attempt to escape directory");
+		        break;
+		    }
+		    default: break;
+		}
 
-		std::wstring WPath = WorkspaceDirectory + L"\\" + ConvertToWStr(Path);
-		RL.PushBoolean(std::filesystem::is_regular_file(WPath));
-		return 1;
-	}
+		if (DecMode == DEC_DUMP)
+		{
+			RL.PushLString(BC.c_str(), BC.size());
+			return 1;
+		}
 
-	int RbxApi::isfolder(DWORD rL)
-	{
-		syn::RbxLua RL(rL);
+		if (!CacheSource.empty())
+		{
+		    const auto Hash = XXH3_128bits_withSeed(CacheSource.data(), CacheSource.size(), DecMode);
 
-		size_t PathSize;
-		const auto PathCStr = RL.CheckLString(1, &PathSize);
-		auto Path = std::string(PathCStr, PathSize);
+		    char Hex[33];
+		    snprintf(Hex, sizeof(Hex), "%016llx%016llx", Hash.high64, Hash.low64);
+		    Job.CacheKey = Hex;
 
-		if (Path.find("..") != std::string::npos)
-            return RL.LError("attempt to escape directory");
+		    std::string Cached;
+		    if (DecompiledSources.Find(Job.CacheKey, Cached))
+		    {
+		        RL.PushLString(Cached.c_str(), Cached.size());
+		        return 1;
+		    }
+		}
 
-		std::wstring WPath = WorkspaceDirectory + L"\\" + ConvertToWStr(Path);
-		RL.PushBoolean(std::filesystem::is_directory(WPath));
-		return 1;
+		return 0;
 	}
 
-	int RbxApi::listfiles(DWORD rL)
+	/* Runs unluac for a prepared job, off the game thread. StreamGeneration is the explorer view to stream into, 0 for none */
+	static std::string decompile_run(const DecompileJob& Job, syn::D3D* Renderer, const DWORD StreamGeneration)
 	{
-		syn::RbxLua RL(rL);
+        const auto& BC = Job.BC;
+        const auto& DecKey = Job.DecKey;
+        const auto& CacheKey = Job.CacheKey;
+        const auto DecMode = Job.Mode;
+        const auto Timeout = Job.Timeout;
 
-		size_t PathSize;
-		const auto PathCStr = RL.CheckLString(1, &PathSize);
-		auto Path = std::string(PathCStr, PathSize);
+        if (synf::UseDecompilerDiskCache && !CacheKey.empty())
+        {
+            std::ifstream CacheFile(decompile_cache_path(CacheKey), std::ios::binary);
+            if (CacheFile)
+            {
+                std::string Cached((std::istreambuf_iterator<char>(CacheFile)), std::istreambuf_iterator<char>());
+                DecompiledSources.Insert(CacheKey, Cached);
 
-		if (Path.find("..") != std::string::npos)
-            return RL.LError("attempt to escape directory");
+                if (StreamGeneration)
+                    Renderer->AppendDecompilerText(StreamGeneration, Cached.c_str(), Cached.size());
 
-		std::wstring WPath = WorkspaceDirectory + L"\\" + ConvertToWStr(Path);
-		RL.NewTable();
+                return Cached;
+            }
+        }
 
-		size_t c = 0;
-		for (auto& p : std::filesystem::directory_iterator(WPath))
-		{
-			auto path = p.path().string().substr(WorkspaceDirectory.length() + 1);
+        auto BinDir = syn::D3D::GetWorkingPath() + L"\\bin\\";
 
-			RL.PushInteger(++c);
-			RL.PushString(path.c_str());
-			RL.SetTable(-3);
-		}
+        auto DmpStr = ConvertToWStr(RandomString(16));
+        auto DecKeyW = ConvertToWStr(DecKey);
 
-		return 1;
-	}
+        auto DmpBytecodeName = BinDir + DmpStr + L".out";
 
-	int RbxApi::makefolder(DWORD rL)
-	{
-		syn::RbxLua RL(rL);
+        /* Write bytecode file */
+        std::ofstream OutFile;
+        OutFile.open(DmpBytecodeName, std::ios::out | std::ios::binary);
+        OutFile.write(BC.c_str(), BC.size());
+        OutFile.close();
 
-		size_t PathSize;
-		const auto PathCStr = RL.CheckLString(1, &PathSize);
-		auto Path = std::string(PathCStr, PathSize);
+        /* unluac writes to an inherited pipe, read below while it runs */
+        SECURITY_ATTRIBUTES sa{ sizeof(sa), NULL, TRUE };
+        HANDLE OutRead, OutWrite;
+        if (!CreatePipe(&OutRead, &OutWrite, &sa, 64 * 1024))
+        {
+            std::filesystem::remove(DmpBytecodeName);
+            throw std::exception("failed to decompile: 0x05");
+        }
+        SetHandleInformation(OutRead, HANDLE_FLAG_INHERIT, 0);
+
+        /* Decompile with unluac */
+        STARTUPINFOW si; ZeroMemory(&si, sizeof(si));
+        PROCESS_INFORMATION pi; ZeroMemory(&pi, sizeof(pi));
+        si.cb = sizeof(si);
+        si.dwFlags = STARTF_USESTDHANDLES;
+        si.hStdOutput = OutWrite;
+        
+        constexpr size_t PathSz = (MAX_PATH + 1) * sizeof(wchar_t);
+        wchar_t CMDDir[PathSz];
+        UINT Result = GetSystemDirectoryW(CMDDir, PathSz);
 
-		if (Path.find("..") != std::string::npos)
-            return RL.LError("attempt to escape directory");
+        /* Potential miscalulation on my part, look into size conflicts */
+        if (Result > PathSz || Result == 0)
+        {
+            std::wstring DefaultCmdDir = L"C:\\Windows\\System32\\cmd.exe";
+            wcsncpy_s(CMDDir, DefaultCmdDir.c_str(), DefaultCmdDir.size());
+        }
+        else
+        {
+            wcscat_s(CMDDir, L"\\cmd.exe");
+        }
 
-		std::wstring WPath = WorkspaceDirectory + L"\\" + ConvertToWStr(Path);
-		std::filesystem::create_directories(WPath);
+        const auto SpawnFailed = [&](const char* Error)
+        {
+            CloseHandle(OutRead);
+            CloseHandle(OutWrite);
+            std::filesystem::remove(DmpBytecodeName);
+            throw std::exception(Error);
+        };
 
-		return 0;
-	}
+        if (DecMode == DEC_LEGACY)
+        {
+            if (Is64BitOS())
+            {
+                syn::Resource* unluac_exe = new syn::Resource("unluac-native", BinDir + L"unluac.exe",
+                    OBFUSCATE_STR("https://cdn.synapse.to/synapsedistro/unluac/unluac_native_may1819.exe"));
+                unluac_exe->get();
 
-	int RbxApi::delfolder(DWORD rL)
-	{
-		syn::RbxLua RL(rL);
+                if (!CreateProcessW(CMDDir,
+                    (LPWSTR)(L"/C unluac.exe \"" + DmpBytecodeName + L"\"").c_str(), NULL, NULL,
+                    TRUE, CREATE_NO_WINDOW, NULL, BinDir.c_str(), &si, &pi))
+                {
+                    SpawnFailed("failed to decompile: 0x01");
+                }
+            }
+            else
+            {
+                syn::Resource* unluac_jar = new syn::Resource("unluac", BinDir + L"unluac.jar",
+                    OBFUSCATE_STR("https://cdn.synapse.to/synapsedistro/unluac/unluac_oct1118.jar"));
+                unluac_jar->get();
 
-		size_t PathSize;
-		const auto PathCStr = RL.CheckLString(1, &PathSize);
-		auto Path = std::string(PathCStr, PathSize);
+                if (!CreateProcessW(CMDDir,
+                    (LPWSTR) ((std::wstring(L"/C java -Xss32M -jar unluac.jar \"") + DmpBytecodeName + L"\"").c_str()), NULL, NULL,
+                    TRUE, CREATE_NO_WINDOW, NULL, BinDir.c_str(), &si, &pi))
+                {
+                    SpawnFailed("failed to decompile: 0x02");
+                }
+            }
+        }
+        else
+        {
+            if (Is64BitOS())
+            {
+                syn::Resource* unluac_exe = new syn::Resource("unluac-native-new", BinDir + L"unluac-new.exe",
+                    OBFUSCATE_STR("https://cdn.synapse.to/synapsedistro/unluac/unluac_native_new_may1919.exe"));
+                unluac_exe->get();
 
-		if (Path.find("..") != std::string::npos)
-            return RL.LError("attempt to escape directory");
+                if (!CreateProcessW(CMDDir,
+                    (LPWSTR) (std::wstring(L"/C unluac-new.exe ") + DecKeyW + L" \"" + DmpBytecodeName + L"\"").c_str(), NULL, NULL,
+                    TRUE, CREATE_NO_WINDOW, NULL, BinDir.c_str(), &si, &pi))
+                {
+                    SpawnFailed("failed to decompile: 0x03");
+                }
+            }
+            else
+            {
+                syn::Resource* unluac_new_jar = new syn::Resource("unluac-new", BinDir + L"unluac-new.jar",
+                    OBFUSCATE_STR("https://cdn.synapse.to/synapsedistro/unluac/unluac_new_may1919.jar"));
+                unluac_new_jar->get();
+
+                if (!CreateProcessW(CMDDir,
+                    (LPWSTR) (std::wstring(L"/C java -Xss32M -XX:+DisableAttachMechanism -jar unluac-new.jar ") +
+                        DecKeyW + L" \"" + DmpBytecodeName + L"\"").c_str(), NULL, NULL, TRUE,
+                    CREATE_NO_WINDOW, NULL, NULL, &si, &pi))
+                {
+                    SpawnFailed("failed to decompile: 0x04");
+                }
+            }
+        }
 
-		std::wstring WPath = WorkspaceDirectory + L"\\" + ConvertToWStr(Path);
+        /* Only unluac holds the write end now, the pipe breaks once it exits */
+        CloseHandle(OutWrite);
 
-		if (!std::filesystem::remove_all(WPath))
-            return RL.LError("folder does not exist");
-		
-		return 0;
-	}
+        /* Add watermark */
+        std::string str = OBFUSCATE_STR("--SynapseX Decompiler\n\n");
+        if (StreamGeneration)
+            Renderer->AppendDecompilerText(StreamGeneration, str.c_str(), str.size());
 
-	int RbxApi::delfile(DWORD rL)
-	{
-		syn::RbxLua RL(rL);
+        /* Read output as it is produced until unluac exits or the timeout passes */
+        const auto Deadline = GetTickCount64() + Timeout;
+        auto TimedOut = false;
+        char Chunk[16 * 1024];
 
-		size_t PathSize;
-		const auto PathCStr = RL.CheckLString(1, &PathSize);
-		auto Path = std::string(PathCStr, PathSize);
+        while (true)
+        {
+            DWORD Available = 0;
+            if (!PeekNamedPipe(OutRead, NULL, 0, NULL, &Available, NULL))
+                break;
 
-		if (Path.find("..") != std::string::npos)
-            return RL.LError("attempt to escape directory");
+            if (Available == 0)
+            {
+                if (Timeout != INFINITE && GetTickCount64() >= Deadline)
+                {
+                    TimedOut = true;
+                    break;
+                }
 
-		std::wstring WPath = WorkspaceDirectory + L"\\" + ConvertToWStr(Path);
+                Sleep(5);
+                continue;
+            }
 
-		if (!std::filesystem::remove(WPath))
-            return RL.LError("file does not exist");
+            DWORD Read = 0;
+            if (!ReadFile(OutRead, Chunk, std::min<DWORD>(Available, sizeof(Chunk)), &Read, NULL) || Read == 0)
+                break;
 
-		return 0;
-	}
+            str.append(Chunk, Read);
+            if (StreamGeneration)
+                Renderer->AppendDecompilerText(StreamGeneration, Chunk, Read);
+        }
 
-	int RbxApi::appendfile(DWORD rL)
-	{
-		syn::RbxLua RL(rL);
+        CloseHandle(OutRead);
 
-		size_t PathSize;
-		const auto PathCStr = RL.CheckLString(1, &PathSize);
-		auto Path = std::string(PathCStr, PathSize);
+		/* Check for timeout */
+		if (TimedOut)
+		{
+			/* Kill process tree (timed out) */
+			KillProcessTree(pi.dwProcessId);
 
-		size_t ContentsSize;
-		const auto ContentsCStr = RL.CheckLString(2, &ContentsSize);
+			/* Close handles */
+			CloseHandle(pi.hProcess);
+			CloseHandle(pi.hThread);
 
-		std::replace(Path.begin(), Path.end(), '/', '\\');
+			/* Remove left over files */
+			for (auto i = 0; i < 5; i++)
+			{
+				try
+				{
+					/* We have to wait for the file handles to close. */
+					std::filesystem::remove(DmpBytecodeName);
+					break;
+				}
+				catch (std::exception&)
+				{
+					Sleep(1000);
+				}
+			}
 
-		const std::string Extention = PathFindExtensionA(Path.c_str());
+			return OBFUSCATE_STR("--SynapseX Decompiler\n--Decompiler timeout.");
+		}
 
-		if (Path.find("..") != std::string::npos)
-            return RL.LError("attempt to escape directory");
+        WaitForSingleObject(pi.hProcess, INFINITE);
+        CloseHandle(pi.hProcess);
+        CloseHandle(pi.hThread);
 
-		std::wstring WPath = WorkspaceDirectory + L"\\" + ConvertToWStr(Path);
+        /* Remove files */
+        std::filesystem::remove(DmpBytecodeName);
 
-		std::vector<std::string> DisallowedExtensions = {
-			".exe", ".bat", ".com", ".csh", ".msi", ".vb", ".vbs", ".vbe", ".ws", ".wsf", ".wsh", ".ps1"
-		};
-		for (std::string& Test : DisallowedExtensions)
-		{
-			if (equals_ignore_case(Extention, Test)) 
-                return RL.LError("file does not exist");
-		}
+        if (!CacheKey.empty())
+        {
+            DecompiledSources.Insert(CacheKey, str);
 
-		if (!std::filesystem::exists(WPath.c_str()))
-            return RL.LError("file does not exist");
+            if (synf::UseDecompilerDiskCache)
+            {
+                std::error_code Error;
+                std::filesystem::create_directories(WorkspaceDirectory + L"\\decompiled", Error);
 
-		std::ofstream Out;
-		Out.open(WPath, std::ios_base::app | std::ios_base::binary);
-		Out.write(ContentsCStr, ContentsSize);
-		Out.close();
+                std::ofstream CacheFile(decompile_cache_path(CacheKey), std::ios::binary);
+                CacheFile.write(str.c_str(), str.size());
+            }
+        }
 
-		return 0;
+        return str;
 	}
 
-	int RbxApi::isbeta(DWORD rL)
-	{
-		syn::RbxLua RL(rL);
+    int RbxApi::decompile(DWORD rL)
+    {
+        syn::RbxLua RL(rL);
 
-#ifdef EnableBetaRelease
-		RL.PushBoolean(true);
-#else
-		RL.PushBoolean(false);
+        RbxYield RYield(rL);
+
+#ifndef EnableLuaUDecompiler
+		if (IsLuaU)
+		{
+			RL.PushString(
+				"--SynapseX Decompiler\n--The Synapse X decompiler is currently unsupported on LuaU enabled games.");
+			return 1;
+		}
 #endif
 
-		return 1;
-	}
+        RL.ArgCheck(RL.IsFunction(1) || RL.IsProto(1) || RL.IsString(1) || RL.IsUserData(1), 1,
+            "Variant<userdata[LocalScript, ModuleScript], function, string, proto> expected");
 
-	int RbxApi::isluau(DWORD rL)
-	{
-		syn::RbxLua RL(rL);
+        auto DecMode = DEC_LEGACY;
+        if (RL.Type(2) == R_LUA_TBOOLEAN)
+        {
+            DecMode = RL.ToBoolean(2) ? DEC_DUMP : DEC_LEGACY;
+            RL.Pop(1);
+        }
 
-		RL.PushBoolean(IsLuaU);
+		auto Timeout = INFINITE;
+		if (RL.Type(3) == R_LUA_TNUMBER)
+		{
+			Timeout = RL.ToNumber(3) * 1000;
+		}
 
-		return 1;
-	}
+        if (RL.Type(2) == R_LUA_TSTRING)
+        {
+            if (!decompile_parse_mode(RL.ToString(2), DecMode))
+                return RL.ArgError(2, "invalid decompilation mode");
 
-	int RbxApi::getnamecallmethod(DWORD rL)
-	{
-		const syn::RbxLua RL(rL);
+            RL.Pop(1);
+        }
 
-		if (!IsLuaU)
-			return RL.LError("'getnamecallmethod' is only supported on LuaU enabled games.");
+        DecompileJob Job{ DecMode, Timeout };
+        if (const auto Results = decompile_prepare(RL, 1, Job))
+            return Results;
 
-		RL.PushRawObject(*(uintptr_t*) (rL + L_NAMECALLMETHOD), R_LUA_TSTRING);
+        /* The explorer's decompiler view gets unluac's output as it is written instead of all at once */
+        const auto Renderer = syn::D3D::GetSingleton();
+        const auto StreamGeneration = Renderer->DecompilerThread == rL ? Renderer->DecompilerGeneration.load() : 0;
 
-		return 1;
-	}
+        return RYield.Execute([Job, Renderer, StreamGeneration]()
+        {
+            const auto Source = decompile_run(Job, Renderer, StreamGeneration);
 
-	int RbxApi::setnamecallmethod(DWORD rL)
+            return YieldRetFunc([Source](RbxLua NRL)
+            {
+                NRL.PushLString(Source.c_str(), Source.size());
+                return 1;
+            });
+        });
+    }
+
+	/* Callback errors are reported through warn */
+	static const RbxKey KeyWarn("warn");
+
+	/* decompileall(scripts, mode, timeout, callback), decompiles a list across one worker per core. callback(script, source) runs
+	   on the game thread as each one finishes, the call returns every source in the same order as scripts */
+	int RbxApi::decompileall(DWORD rL)
 	{
-		const syn::RbxLua RL(rL);
+		syn::RbxLua RL(rL);
+		RbxYield RYield(rL);
 
-		if (!IsLuaU)
-			return RL.LError("'setnamecallmethod' is only supported on LuaU enabled games.");
+		RL.CheckType(1, R_LUA_TTABLE);
 
-		if (!RL.IsString(1))
-			RL.TagError(1, R_LUA_TSTRING);
+		auto DecMode = DEC_LEGACY;
+		if (!RL.IsNoneOrNil(2))
+		{
+			size_t ModeSize;
+			const auto ModeCStr = RL.CheckLString(2, &ModeSize);
 
-		*(uintptr_t*)(rL + L_NAMECALLMETHOD) = (uintptr_t) RL.Index2Adr(1)->value.p;
+			if (!decompile_parse_mode(std::string(ModeCStr, ModeSize), DecMode) || DecMode == DEC_DUMP)
+				return RL.ArgError(2, "invalid decompilation mode");
+		}
 
-		return 0;
-	}
+		const DWORD Timeout = RL.IsNoneOrNil(3) ? INFINITE : (DWORD) (RL.CheckNumber(3) * 1000);
 
-	//Used in explorer.
-	int RbxApi::getpropvalue(DWORD rL)
-	{
-		const syn::RbxLua RL(rL);
+		std::string CallbackKey, ScriptsKey;
+		if (!RL.IsNoneOrNil(4))
+		{
+			RL.CheckType(4, R_LUA_TFUNCTION);
 
-		RL.GetGlobal("tostring");
-		RL.GetField(1, RL.ToString(2));
-		RL.PCall(1, 1, 0);
+			CallbackKey = RandomString(16);
+			ScriptsKey = RandomString(16);
 
-		size_t CSize;
-		const auto CStr = RL.ToLString(3, &CSize);
+			RL.PushValue(4);
+			RL.SetField(LUA_REGISTRYINDEX, CallbackKey.c_str());
+			RL.PushValue(1);
+			RL.SetField(LUA_REGISTRYINDEX, ScriptsKey.c_str());
+		}
 
-		RL.Pop(2);
+		const auto Count = (size_t) RL.ObjLen(1);
 
-		RL.PushLString(CStr, CSize);
+		/* Bytecode has to come off the game thread, so every script is extracted here in one pass before any worker starts */
+		std::vector<DecompileJob> Jobs(Count, DecompileJob{ DecMode, Timeout });
+		std::vector<std::string> Sources(Count);
+		std::vector<size_t> Pending;
 
-		return 1;
-	}	
-	
-	int RbxApi::setpropvalue(DWORD rL)
-	{
-		const syn::RbxLua RL(rL);
+		auto LuaUBlocked = false;
+#ifndef EnableLuaUDecompiler
+		LuaUBlocked = IsLuaU;
+#endif
 
-		RL.SetField(1, RL.ToString(2));
+		const auto Top = RL.GetTop();
+		for (size_t i = 0; i < Count; i++)
+		{
+			RL.RawGetI(1, (int) i + 1);
 
-		return 0;
-	}
+			const auto Index = RL.GetTop();
+			if (!RL.IsFunction(Index) && !RL.IsProto(Index) && !RL.IsString(Index) && !RL.IsUserData(Index))
+				return RL.ArgError(1, "Variant<userdata[LocalScript, ModuleScript], function, string, proto> expected in scripts");
 
-	int RbxApi::getconnections(DWORD rL)
-	{
-		syn::RbxLua RL(rL);
+			if (LuaUBlocked)
+				RL.PushString("--SynapseX Decompiler\n--The Synapse X decompiler is currently unsupported on LuaU enabled games.");
+			else if (!decompile_prepare(RL, Index, Jobs[i]))
+			{
+				Pending.push_back(i);
+				RL.SetTop(Top);
+				continue;
+			}
 
-		if (!RL.IsUserData(1) || !checksignal(RL, 1))
-			return RL.ArgError(1, "signal expected");
+			size_t SourceSize;
+			const auto SourceCStr = RL.ToLString(-1, &SourceSize);
+			if (SourceCStr)
+				Sources[i] = std::string(SourceCStr, SourceSize);
 
-		const auto EventInstance = *reinterpret_cast<std::uintptr_t*>(RL.ToUserData(1));
-		const auto Source = reinterpret_cast<std::weak_ptr<uintptr_t>*>(EventInstance + 4)->lock();
-		const auto Signal = reinterpret_cast<uintptr_t(__thiscall*)(uintptr_t*, bool)>(*reinterpret_cast<std::uintptr_t*>(EventInstance + 48))(Source.get(), true);
-		//auto Current = *reinterpret_cast<std::uintptr_t*>(Signal);
-		//
-		//RL.NewTable();
-		//
-		//int Count = 1;
-		//while (Current != 0)
-		//{
-		//	RL.PushNumber(Count++);
-		//	RL.PushLightUserData(reinterpret_cast<void*>(Current));
-		//	RL.SetTable(-3);
-		//
-		//	Current = *reinterpret_cast<std::uintptr_t*>(Current + 0x8);
-		//}
+			RL.SetTop(Top);
+		}
 
-		return 1;
-	}
+		return RYield.Execute([Jobs, Pending, Sources, CallbackKey, ScriptsKey]()
+		{
+			auto Results = Sources;
+			const auto Sched = syn::Scheduler::GetSingleton();
 
-	int RbxApi::disableconnection(DWORD rL)
-	{
-		syn::RbxLua RL(rL);
+			const auto Notify = [&](const size_t Index)
+			{
+				if (CallbackKey.empty())
+					return;
 
-        /* TODO: Check whether it is an actual syn signal */
-		if (!RL.IsUserData(1))
-			return RL.ArgError(1, "synapse signal expected");
+				Sched->Push([CallbackKey, ScriptsKey, Index, Source = Results[Index]](DWORD rL)
+				{
+					const syn::RbxLua ML(rL);
+
+					ML.GetField(LUA_REGISTRYINDEX, CallbackKey.c_str());
+					ML.GetField(LUA_REGISTRYINDEX, ScriptsKey.c_str());
+					ML.RawGetI(-1, (int) Index + 1);
+					ML.Remove(-2);
+					ML.PushLString(Source.c_str(), Source.size());
+					if (ML.PCall(2, 0, 0))
+					{
+						ML.GetGlobalK(KeyWarn);
+						ML.Insert(-2);
+						ML.PCall(1, 0, 0);
+					}
+				});
+			};
 
-		const auto Connection = reinterpret_cast<std::uintptr_t>(RL.ToUserData(-1));
-		const auto Signal = *reinterpret_cast<std::uintptr_t*>(Connection + 0xC);
+			/* Pending is ascending, everything not in it already has its source */
+			for (size_t i = 0, p = 0; i < Results.size(); i++)
+			{
+				if (p < Pending.size() && Pending[p] == i)
+					p++;
+				else
+					Notify(i);
+			}
 
-		auto Previous = 0;
-		auto Current = *reinterpret_cast<std::uintptr_t*>(Signal);
+			/* unluac runs out of process, so each worker mostly waits on its own child */
+			std::atomic<size_t> Next{ 0 };
+			std::mutex NotifyMutex;
+			std::vector<std::thread> Workers;
 
-		while (Current && Current != Connection)
-		{
-			Previous = Current;
-			Current = *reinterpret_cast<std::uintptr_t*>(Current + 0x8);
-		}
+			const auto WorkerCount = (std::min)(Pending.size(), (size_t) (std::max)(1u, std::thread::hardware_concurrency()));
+			for (size_t w = 0; w < WorkerCount; w++)
+			{
+				Workers.emplace_back([&]
+				{
+					for (auto i = Next++; i < Pending.size(); i = Next++)
+					{
+						const auto Index = Pending[i];
+
+						std::string Source;
+						try
+						{
+							Source = decompile_run(Jobs[Index], nullptr, 0);
+						}
+						catch (const std::exception& Ex)
+						{
+							Source = Ex.what();
+						}
+
+						std::lock_guard<std::mutex> Guard(NotifyMutex);
+						Results[Index] = std::move(Source);
+						Notify(Index);
+					}
+				});
+			}
 
-        if (!Current)
-            return RL.LError("synapse signal is not connected");
+			for (auto& Worker : Workers)
+				Worker.join();
 
-		if (!Previous)
-			*reinterpret_cast<std::uintptr_t*>(Signal) = 0;
-		else
-			*reinterpret_cast<std::uintptr_t*>(Previous + 0x8) = *reinterpret_cast<std::uintptr_t*>(Current + 0x8);
+			return YieldRetFunc([Results, CallbackKey, ScriptsKey](RbxLua NRL)
+			{
+				if (!CallbackKey.empty())
+				{
+					NRL.PushNil();
+					NRL.SetField(LUA_REGISTRYINDEX, CallbackKey.c_str());
+					NRL.PushNil();
+					NRL.SetField(LUA_REGISTRYINDEX, ScriptsKey.c_str());
+				}
 
-		RL.PushLightUserData(reinterpret_cast<void*>(Current));
+				NRL.CreateTable((int) Results.size(), 0);
+				for (size_t i = 0; i < Results.size(); i++)
+				{
+					NRL.PushLString(Results[i].c_str(), Results[i].size());
+					NRL.RawSetI(-2, (int) i + 1);
+				}
 
-		return 1;
+				return 1;
+			});
+		});
 	}
 
-	int RbxApi::enableconnection(DWORD rL)
+	int RbxApi::dumpstring(DWORD rL)
 	{
 		syn::RbxLua RL(rL);
 
-        /* TODO: Check whether it is an actual syn signal */
-        if (!RL.IsUserData(1))
-            return RL.ArgError(1, "synapse signal expected");
+		size_t ScriptLength;
 
-		const auto Connection = reinterpret_cast<std::uintptr_t>(RL.ToUserData(-1));
-		const auto Signal = *reinterpret_cast<std::uintptr_t*>(Connection + 0xC);
+        const auto ScriptPointer = RL.CheckLString(1, &ScriptLength);
+		const auto Script = std::string(ScriptPointer, ScriptLength);
 
-		auto Previous = 0;
-		auto Current = *reinterpret_cast<std::uintptr_t*>(Signal);
+        if (Script.find("\033Lua") == 0)
+            return RL.LError("bytecode is not supported");
 
-		while (Current != 0)
+		std::string BC;
+		try
 		{
-			Previous = Current;
-			Current = *reinterpret_cast<std::uintptr_t*>(Current + 0x8);
-		}
+#ifndef EnableHSVMOnlyLuaU
+#ifdef EnableHSVM
+			const auto NState = syn::LuaTranslator::AcquireState();
 
-		if (!Previous)
-			*reinterpret_cast<std::uintptr_t*>(Signal) = Connection;
-		else
-			*reinterpret_cast<std::uintptr_t*>(Previous + 0x8) = Connection;
+			if (luaL_loadbuffer(NState, Script.c_str(), Script.size(), BS_LUA, ""))
+			{
+				/* Error while compiling, report back to translation caller */
+				const std::string Err = lua_tostring(NState, -1);
+				syn::LuaTranslator::ReleaseState(NState);
+				throw std::exception(Err.c_str());
+			}
 
-		RL.PushLightUserData(reinterpret_cast<void*>(Current));
+			BC = syn::LuaTranslator::DumpChunk(NState);
 
-		return 1;
-	}
+			syn::LuaTranslator::ReleaseState(NState);
+#else
+			auto Translator = syn::LuaTranslator::GetSingleton();
+			Translator->ConvertInCurrentThread(RL, Script, 0);
+			BC = Translator->Dump(RL);
+#endif
+#else
+			if (IsLuaU)
+			{
+				const auto NState = syn::LuaTranslator::AcquireState();
 
-	static DWORD GetConnectionTR(RbxLua RL, DWORD Conn)
-	{
-		DWORD Ret = 0;
+				if (luaL_loadbuffer(NState, Script.c_str(), Script.size(), BS_HSVM, ""))
+				{
+					/* Error while compiling, report back to translation caller */
+					const std::string Err = lua_tostring(NState, -1);
+					syn::LuaTranslator::ReleaseState(NState);
+					throw std::exception(Err.c_str());
+				}
 
-		if (*(DWORD*)(Conn + 0x1C) == 0)
-			Ret = *(DWORD*)(Conn + 0x20);
+				BC = syn::LuaTranslator::DumpChunk(NState);
 
-		else if (*(DWORD*)(Conn + 0x14) == 0)
-			Ret = *(DWORD*)(Conn + 0x18);
+				syn::LuaTranslator::ReleaseState(NState);
+			}
+			else
+			{
+				auto Translator = syn::LuaTranslator::GetSingleton();
+				Translator->ConvertInCurrentThread(RL, Script, 0);
+				BC = Translator->Dump(RL);
+			}
+#endif
+		}
+		catch (const std::exception& ex)
+		{
+			throw std::exception(ex.what());
+		}
 
-		if (!Ret)
-			return RL.LError("internal error [0x01]");
+		RL.PushLString(BC.c_str(), BC.size());
 
-		return Ret;
+		return 1;
 	}
 
-	int RbxApi::getconnectionfunc(DWORD rL)
+	int RbxApi::httpget(DWORD rL)
 	{
-		RbxLua RL(rL);
+		syn::RbxLua RL(rL);
+		RbxYield RYield(RL);
 
-        /* TODO: Check whether it is an actual syn signal */
-        if (!RL.IsUserData(1))
-            return RL.ArgError(1, "synapse signal expected");
+		size_t CSize;
+		const auto CStr = RL.CheckLString(1, &CSize);
+		const auto Url = std::string(CStr, CSize);
 
-        VM_FISH_LITE_START;
-		DWORD Conn = (DWORD)RL.ToUserData(1);
-		DWORD TR = GetConnectionTR(RL, Conn);
+		if (Url.find("http"))
+			return RL.ArgError(1, "Invalid protocol specified (expected 'http://' or 'https://')");
 
-		DWORD NRL = *(DWORD*)(*(DWORD*)(TR + 0x38) + 0x8);
-		DWORD Idx = *(DWORD*)(TR + 0x40);
-        VM_FISH_LITE_END;
+		HttpRequest Request;
+		Request.Url = Url;
+		Request.Headers = cpr::Header{ {"User-Agent", "Roblox/WinInet"} };
+		Request.Cache = RL.ToBoolean(2);
 
-		RbxLua RLX(NRL);
+		return RYield.Execute([Request]()
+		{
+			const auto Perform = [](const HttpRequest& Request)
+			{
+				PROFILE_ZONE(OBFUSCATE_STR("Http request"));
+				auto Session = syn::HttpSessionPool::GetSingleton()->Acquire(Request.Url);
+				Session->SetUrl(cpr::Url{ Request.Url });
+				Session->SetHeader(Request.Headers);
 
-		RLX.PushInteger(Idx);
-		RLX.GetTable(LUA_REGISTRYINDEX);
-		RLX.XMove(RL, 1);
+				return Session->Get();
+			};
 
-		return 1;
-	}
+			auto result = Request.Cache ? syn::HttpCache::GetSingleton()->Fetch(Request, Perform) : Perform(Request);
 
-	int RbxApi::getconnectionstate(DWORD rL)
-	{
-		/*
-			weakthreadref = signal + 0x18]
-			node = signal + 0x18] + 0x38]
-			luaState = signal + 0x18] + 0x38] + 0x8]
-		*/
-
-		RbxLua RL(rL);
-
-        /* TODO: Check whether it is an actual syn signal */
-        if (!RL.IsUserData(1))
-            return RL.ArgError(1, "synapse signal expected");
-        
-        VM_FISH_LITE_START;
-		DWORD Conn = (DWORD)RL.ToUserData(1);
-		DWORD TR = GetConnectionTR(RL, Conn);
-		DWORD NRL = *(DWORD*)(*(DWORD*)(TR + 0x38) + 0x8);
-        VM_FISH_LITE_END;
+			if (HttpStatus::isError(result.status_code))
+			{
+				auto Err = "Http Error " + std::to_string(result.status_code) + " - " + HttpStatus::reasonPhrase(
+					result.status_code);
 
-		RL.PushLightUserData((void*)NRL);
+				throw std::exception(Err.c_str());
+			}
 
-		return 1;
+			return [result](RbxLua NRL)
+			{
+				NRL.PushLString(result.text.c_str(), result.text.size());
+				return 1;
+			};
+		});
 	}
 
-	int RbxApi::firesignal(DWORD rL)
+	int RbxApi::httppost(DWORD rL)
 	{
 		syn::RbxLua RL(rL);
 
-		if (!RL.IsUserData(1) || !checksignal(RL, 1))
-			return RL.ArgError(1, "signal expected");
-
-		VM_FISH_LITE_START;
+		std::string Url = RL.CheckString(1);
 
-		RL.GetField(1, OBFUSCATE_STR("Connect"));
-		RL.PushValue(1);
-		RL.PushCFunction(getconnectionshandler);
-		RL.PCall(2, 1, 0);
+		size_t DCSize;
+		const auto DCStr = RL.CheckLString(2, &DCSize);
+		const auto Data = std::string(DCStr, DCSize);
 
-		RL.Remove(1);
+		auto ContentType = RL.CheckString(3);
 
-		const auto Connection = *reinterpret_cast<std::uintptr_t*>(reinterpret_cast<std::uintptr_t>(RL.ToUserData(-1)) + 4);
-		const auto Signal = *reinterpret_cast<std::uintptr_t*>(Connection + 0xC);
+		if (Url.find("http") != 0) throw std::exception("Invalid protocol specified (expected 'http://' or 'https://')");
 
-		RL.GetField(-1, OBFUSCATE_STR("Disconnect"));
-		RL.Insert(-2);
-		RL.Insert(-2);
-		RL.PCall(1, 0, 0);
+		PROFILE_ZONE(OBFUSCATE_STR("Http request"));
+		auto Session = syn::HttpSessionPool::GetSingleton()->Acquire(Url);
+		Session->SetUrl(cpr::Url{ Url });
+		Session->SetHeader(cpr::Header{ {"User-Agent", "Roblox/WinInet"}, {"Content-Type", ContentType} });
+		Session->SetBody(cpr::Body{ Data });
 
-		int ArgumentCount = RL.GetTop();
+		auto result = Session->Post();
 
-		auto Next = *reinterpret_cast<uintptr_t*>(Signal);
-		while (Next)
+		if (HttpStatus::isError(result.status_code))
 		{
-			DWORD TR = GetConnectionTR(RL, Next);
-			DWORD NRL = *(DWORD*)(*(DWORD*)(TR + 0x38) + 0x8);
-			DWORD Idx = *(DWORD*)(TR + 0x40);
+			auto Err = "Http Error " + std::to_string(result.status_code) + " - " + HttpStatus::reasonPhrase(
+				result.status_code);
 
-			Next = *reinterpret_cast<uintptr_t*>(Next + 0x8);
-			if (syn::PointerObfuscation::DeObfuscateGlobalState(NRL + L_GS) != syn::PointerObfuscation::DeObfuscateGlobalState(rL + L_GS))
-				continue;
+			throw std::exception(Err.c_str());
+		}
 
-			RbxLua RLX(NRL);
+		RL.PushLString(result.text.c_str(), result.text.size());
 
-			RLX.PushNumber(Idx);
-			RLX.GetTable(LUA_REGISTRYINDEX);
-			RLX.XMove(RL, 1);
+		return 1;
+	}
 
-			//Stack:
-			//Arg1
-			//Arg2
-			//Arg3
-			//[Function]
+	int RbxApi::http_read_request(RbxLua RL, int Index, HttpRequest& Request)
+	{
+		RL.CheckType(Index, R_LUA_TTABLE);
 
-			for (int i = 1; i <= ArgumentCount; i++)
-				RL.PushValue(i);
+		RL.GetField(Index, "Url");
+		if (RL.Type(-1) != R_LUA_TSTRING)
+			return RL.LError("Invalid or no 'Url' field specified in request table");
 
-			RL.PCall(ArgumentCount, 0, 0);
-		}
+		size_t UrlSize;
+		const auto UrlCStr = RL.CheckLString(-1, &UrlSize);
+		Request.Url = std::string(UrlCStr, UrlSize);
 
-		VM_FISH_LITE_END;
+		if (Request.Url.find("http://") != 0 && Request.Url.find("https://") != 0)
+			return RL.LError("Only 'http' and 'https' protocols are supported for the 'Url' field.");
 
-		return 0;
-	}
+		RL.Pop(1);
 
-	template<typename T>
-	__forceinline std::string EncryptWithAlgo(const syn::RbxLua RL, const std::string& Plaintext, const std::string& Key, const std::string& IV)
-    {
-		try
+		std::map<std::string, HttpMethod> RequestMethodMap =
 		{
-			std::string Encrypted;
-
-			T Encryptor;
-			Encryptor.SetKeyWithIV((byte*) Key.c_str(), Key.size(), (byte*) IV.c_str(), IV.length());
+			{ "get", H_GET },
+			{ "head", H_HEAD },
+			{ "post", H_POST },
+			{ "put", H_PUT },
+			{ "delete", H_DELETE },
+			{ "options", H_OPTIONS }
+		};
 
-			CryptoPP::StringSource ss(Plaintext, true,
-				new CryptoPP::StreamTransformationFilter(Encryptor,
-					new CryptoPP::StringSink(Encrypted)
-				)
-			);
+		Request.Method = H_GET;
 
-			return Base64Encode((unsigned char*) Encrypted.c_str(), Encrypted.size());
-		}
-		catch (CryptoPP::Exception& e)
+		RL.GetField(Index, "Method");
+		if (RL.Type(-1) == R_LUA_TSTRING)
 		{
-			UNUSED(RL.LError(e.what()));
-			return "";
+			std::string MethodS = RL.CheckString(-1);
+			std::transform(MethodS.begin(), MethodS.end(), MethodS.begin(), tolower);
+
+			if (!RequestMethodMap.count(MethodS))
+				return RL.LError("Request type '%s' is not a valid http request type.", MethodS.c_str());
+
+			Request.Method = RequestMethodMap[MethodS];
 		}
-    }
 
-	template<typename T>
-	__forceinline std::string EncryptAuthenticatedWithAlgo(const syn::RbxLua RL, const std::string& Plaintext, const std::string& Key, const std::string& IV)
-	{
-		try
+		RL.Pop(1);
+
+		RL.GetField(Index, "Headers");
+		if (RL.Type(-1) == R_LUA_TTABLE)
 		{
-			std::string Encrypted;
+			RL.PushNil();
 
-			T Encryptor;
-			Encryptor.SetKeyWithIV((byte*) Key.c_str(), Key.size(), (byte*) IV.c_str(), IV.size());
+			while (RL.Next(-2))
+			{
+				if (RL.Type(-2) != R_LUA_TSTRING || RL.Type(-1) != R_LUA_TSTRING)
+					return RL.LError("'Headers' table must contain string keys/values.");
 
-			CryptoPP::AuthenticatedEncryptionFilter Aef(Encryptor,
-				new CryptoPP::StringSink(Encrypted)
-			);
+				size_t HeaderKeySize;
+				const auto HeaderKeyCStr = RL.CheckLString(-2, &HeaderKeySize);
+				std::string HeaderKey(HeaderKeyCStr, HeaderKeySize);
 
-			Aef.Put((const byte*)Plaintext.data(), Plaintext.size());
-			Aef.MessageEnd();
+				auto HeaderKeyCopy = std::string(HeaderKey);
+				std::transform(HeaderKeyCopy.begin(), HeaderKeyCopy.end(), HeaderKeyCopy.begin(), tolower);
 
-			return Base64Encode((unsigned char*) Encrypted.c_str(), Encrypted.size());
+				if (HeaderKeyCopy == "content-length")
+					return RL.LError("Headers: 'Content-Length' header cannot be overwritten.");
+
+				size_t HeaderValueSize;
+				const auto HeaderValueCStr = RL.CheckLString(-1, &HeaderValueSize);
+				std::string HeaderValue(HeaderValueCStr, HeaderValueSize);
+
+				Request.Headers.insert({ HeaderKey, HeaderValue });
+
+				RL.Pop(1);
+			}
 		}
-		catch (CryptoPP::Exception& e)
+
+		RL.Pop(1);
+
+		RL.GetField(Index, "Cookies");
+		if (RL.Type(-1) == R_LUA_TTABLE)
 		{
-			UNUSED(RL.LError(e.what()));
-			return "";
+			std::map<std::string, std::string> RCookies;
+
+			RL.PushNil();
+
+			while (RL.Next(-2))
+			{
+				if (RL.Type(-2) != R_LUA_TSTRING || RL.Type(-1) != R_LUA_TSTRING)
+					return RL.LError("'Cookies' table must contain string keys/values.");
+
+				size_t CookieKeySize;
+				const auto CookieKeyCStr = RL.CheckLString(-2, &CookieKeySize);
+				std::string CookieKey(CookieKeyCStr, CookieKeySize);
+
+				size_t CookieValueSize;
+				const auto CookieValueCStr = RL.CheckLString(-1, &CookieValueSize);
+				std::string CookieValue(CookieValueCStr, CookieValueSize);
+
+				RCookies[CookieKey] = CookieValue;
+
+				RL.Pop(1);
+			}
+
+			Request.Cookies = RCookies;
 		}
-	}
-	
-	int RbxApi::encryptstringcustom(DWORD rL)
-    {
-		syn::RbxLua RL(rL);
-		
-        VM_TIGER_LONDON_START;
 
-		std::string Algo = RL.CheckString(1);
+		RL.Pop(1);
 
-		size_t DataSize;
-		const auto DataCStr = RL.CheckLString(2, &DataSize);
-		const std::string Plaintext(DataCStr, DataSize);
+		auto HasUserAgent = false;
+		for (auto& Header : Request.Headers)
+		{
+			auto HeaderName = Header.first;
+			std::transform(HeaderName.begin(), HeaderName.end(), HeaderName.begin(), tolower);
 
-		size_t KeySize;
-		const auto KeyCStr = RL.CheckLString(3, &KeySize);
-		const std::string Key(KeyCStr, KeySize);
-    	
-    	size_t IvSize;
-		const auto IvCStr = RL.CheckLString(4, &IvSize);
-		const std::string Iv(IvCStr, IvSize);
+			if (HeaderName == "user-agent")
+				HasUserAgent = true;
+		}
 
-		enum CryptModes
+		if (!HasUserAgent)
 		{
-			//AES
-			AES_CBC,
-			AES_CFB,
-			AES_CTR,
-			AES_OFB,
-			AES_GCM,
-			AES_EAX,
+			Request.Headers.insert({ "User-Agent", std::string("synx/") + OBFUSCATE_STR(SYNAPSE_VERSION) });
+		}
 
-			//Blowfish
-			BF_CBC,
-			BF_CFB,
-			BF_OFB
-		};
+		RL.GetField(Index, "Cache");
+		Request.Cache = RL.ToBoolean(-1);
+		RL.Pop(1);
 
-		std::map<std::string, CryptModes> CryptTranslationMap =
+		RL.GetField(Index, "Body");
+		if (RL.Type(-1) == R_LUA_TSTRING || to_binary_buffer(RL, -1))
 		{
-			//AES
-			{ "aes-cbc", AES_CBC },
-			{ "aes_cbc", AES_CBC },
+			if (Request.Method == H_GET || Request.Method == H_HEAD)
+				return RL.LError("'Body' cannot be present in GET or HEAD requests.");
 
-			{ "aes-cfb", AES_CFB },
-			{ "aes_cfb", AES_CFB },
+			size_t BodySize;
+			const auto BodyCStr = check_bytes(RL, -1, &BodySize);
+			Request.Body = std::string(BodyCStr, BodySize);
+		}
 
-			{ "aes-ctr", AES_CTR },
-			{ "aes_ctr", AES_CTR },
+		RL.Pop(1);
 
-			{ "aes-ofb", AES_OFB },
-			{ "aes_ofb", AES_OFB },
+		return 0;
+	}
 
-			{ "aes-gcm", AES_GCM },
-			{ "aes_gcm", AES_GCM },
+	void RbxApi::http_push_response(RbxLua RL, const cpr::Response& Response)
+	{
+		RL.NewTable();
 
-			{ "aes-eax", AES_EAX },
-			{ "aes_eax", AES_EAX },
-			
-			//Blowfish
-			{ "blowfish-cbc", BF_CBC },
-			{ "blowfish_cbc", BF_CBC },
-			{ "bf-cbc", BF_CBC },
-			{ "bf_cbc", BF_CBC },
+		RL.PushBoolean(HttpStatus::isSuccessful(Response.status_code));
+		RL.SetField(-2, "Success");
 
-			{ "blowfish-cfb", BF_CFB },
-			{ "blowfish_cfb", BF_CFB },
-			{ "bf-cfb", BF_CFB },
-			{ "bf_cfb", BF_CFB },
+		RL.PushInteger(Response.status_code);
+		RL.SetField(-2, "StatusCode");
 
-			{ "blowfish-ofb", BF_OFB },
-			{ "blowfish_ofb", BF_OFB },
-			{ "bf-ofb", BF_OFB },
-			{ "bf_ofb", BF_OFB },
-		};
+		RL.PushString(HttpStatus::reasonPhrase(Response.status_code).c_str());
+		RL.SetField(-2, "StatusMessage");
 
-		std::transform(Algo.begin(), Algo.end(), Algo.begin(), tolower);
+		RL.NewTable();
 
-		if (!CryptTranslationMap.count(Algo))
-			return RL.ArgError(1, "non-existant algorithm");
+		for (auto& Header : Response.header)
+		{
+			RL.PushLString(Header.first.c_str(), Header.first.size());
+			RL.PushLString(Header.second.c_str(), Header.second.size());
 
-		const auto RAlgo = CryptTranslationMap[Algo];
+			RL.SetTable(-3);
+		}
 
-		std::string Result;
+		RL.SetField(-2, "Headers");
 
-		//This is intentional - blame Themida not supporting jump tables.
-		if (RAlgo == AES_CBC)
-		{
-			Result = EncryptWithAlgo<CryptoPP::CBC_Mode<CryptoPP::AES>::Encryption>(RL, Plaintext, Key, Iv);
-		}
-		else if (RAlgo == AES_CFB)
-		{
-			Result = EncryptWithAlgo<CryptoPP::CBC_Mode<CryptoPP::AES>::Encryption>(RL, Plaintext, Key, Iv);
-		}
-		else if (RAlgo == AES_CTR)
-		{
-			Result = EncryptWithAlgo<CryptoPP::CTR_Mode<CryptoPP::AES>::Encryption>(RL, Plaintext, Key, Iv);
-		}
-		else if (RAlgo == AES_OFB)
-		{
-			Result = EncryptWithAlgo<CryptoPP::OFB_Mode<CryptoPP::AES>::Encryption>(RL, Plaintext, Key, Iv);
-		}
-		else if (RAlgo == AES_GCM)
-		{
-			Result = EncryptAuthenticatedWithAlgo<CryptoPP::GCM<CryptoPP::AES>::Encryption>(RL, Plaintext, Key, Iv);
-		}
-		else if (RAlgo == AES_EAX)
-		{
-			Result = EncryptAuthenticatedWithAlgo<CryptoPP::EAX<CryptoPP::AES>::Encryption>(RL, Plaintext, Key, Iv);
-		}
-		else if (RAlgo == BF_CBC)
-		{
-			Result = EncryptWithAlgo<CryptoPP::CBC_Mode<CryptoPP::Blowfish>::Encryption>(RL, Plaintext, Key, Iv);
-		}
-		else if (RAlgo == BF_CFB)
-		{
-			Result = EncryptWithAlgo<CryptoPP::CFB_Mode<CryptoPP::Blowfish>::Encryption>(RL, Plaintext, Key, Iv);
-		}
-		else if (RAlgo == BF_OFB)
-		{
-			Result = EncryptWithAlgo<CryptoPP::OFB_Mode<CryptoPP::Blowfish>::Encryption>(RL, Plaintext, Key, Iv);
-		}
-		else
+		RL.NewTable();
+
+		for (auto& Cookie : Response.cookies.map_)
 		{
-			return RL.ArgError(1, "non-existant algorithm");
+			RL.PushLString(Cookie.first.c_str(), Cookie.first.size());
+			RL.PushLString(Cookie.second.c_str(), Cookie.second.size());
+
+			RL.SetTable(-3);
 		}
 
-        VM_TIGER_LONDON_END;
+		RL.SetField(-2, "Cookies");
 
-		RL.PushLString(Result.c_str(), Result.size());
-			
-		return 1;
-    }
+		RL.PushLString(Response.text.c_str(), Response.text.size());
+		RL.SetField(-2, "Body");
+	}
 
-	int RbxApi::encryptstring(DWORD rL)
+	int RbxApi::httprequest(DWORD rL)
 	{
 		syn::RbxLua RL(rL);
+		RbxYield RYield(RL);
 
-        VM_TIGER_WHITE_START;
+		HttpRequest Request;
+		http_read_request(RL, 1, Request);
 
-		size_t DataSize;
-		const auto DataCStr = RL.CheckLString(1, &DataSize);
+		/* Streaming mode, the body is handed to 'OnChunk' as it arrives instead of being returned */
+		RL.GetField(1, "OnChunk");
+		if (RL.IsFunction(-1))
+		{
+			const auto CallbackKey = RandomString(16);
+			RL.SetField(LUA_REGISTRYINDEX, CallbackKey.c_str());
 
-		size_t KeySize;
-		const auto KeyCStr = RL.CheckLString(2, &KeySize);
+			return RYield.Execute([Request, CallbackKey]()
+			{
+				const auto Backlog = std::make_shared<std::atomic<size_t>>(0);
 
-		CryptoPP::AutoSeededRandomPool Prng;
-		byte IV[12];
-		Prng.GenerateBlock(IV, 12);
+				const auto Response = syn::HttpSessionPool::PerformStreaming(Request, [CallbackKey, Backlog](std::string&& Chunk)
+				{
+					/* Keep memory bounded if the game thread falls behind the transfer */
+					while (*Backlog > 1024 * 1024)
+						std::this_thread::sleep_for(std::chrono::milliseconds(1));
 
-		byte DerivedKey[32];
-		CryptoPP::PKCS5_PBKDF2_HMAC<CryptoPP::SHA384> KDF;
-		KDF.DeriveKey(DerivedKey, 32, 0, (byte*) KeyCStr, KeySize, NULL, 0, 10000);
+					*Backlog += Chunk.size();
 
-		auto Encrypted = EncryptAuthenticatedWithAlgo<CryptoPP::GCM<CryptoPP::AES>::Encryption>(RL, 
-			std::string(DataCStr, DataSize), 
-			std::string((const char*) DerivedKey, 32), 
-			std::string((const char*) IV, 12));
+					syn::Scheduler::GetSingleton()->Push([CallbackKey, Backlog, Chunk = std::move(Chunk)](DWORD rL)
+					{
+						const syn::RbxLua ML(rL);
+
+						ML.GetField(LUA_REGISTRYINDEX, CallbackKey.c_str());
+						ML.PushLString(Chunk.c_str(), Chunk.size());
+						if (ML.PCall(1, 0, 0))
+						{
+							ML.GetGlobalK(KeyWarn);
+							ML.Insert(-2);
+							ML.PCall(1, 0, 0);
+						}
+
+						*Backlog -= Chunk.size();
+					});
+				});
 
-		Encrypted += "|" + Base64Encode(IV, 12);
-		Encrypted = Base64Encode((byte*) Encrypted.data(), Encrypted.size());
+				return [Response, CallbackKey](RbxLua NRL)
+				{
+					NRL.PushNil();
+					NRL.SetField(LUA_REGISTRYINDEX, CallbackKey.c_str());
 
-		RL.PushLString(Encrypted.c_str(), Encrypted.size());
+					http_push_response(NRL, Response);
+					return 1;
+				};
+			});
+		}
 
-        VM_TIGER_WHITE_END;
+		RL.Pop(1);
 
-		return 1;
+		return RYield.Execute([Request]()
+		{
+			PROFILE_ZONE(OBFUSCATE_STR("Http request"));
+			cpr::Response Response;
+
+			auto Session = syn::HttpSessionPool::GetSingleton()->Acquire(Request.Url);
+			Session->SetUrl(cpr::Url{ Request.Url });
+			Session->SetCookies(Request.Cookies);
+			Session->SetHeader(Request.Headers);
+
+			if (Request.Method != H_GET && Request.Method != H_HEAD)
+				Session->SetBody(cpr::Body{ Request.Body });
+
+			switch (Request.Method)
+			{
+			case H_GET:
+			{
+				if (!Request.Cache)
+				{
+					Response = Session->Get();
+					break;
+				}
+
+				Response = syn::HttpCache::GetSingleton()->Fetch(Request, [&Session](const HttpRequest& Conditional)
+				{
+					Session->SetHeader(Conditional.Headers);
+					return Session->Get();
+				});
+				break;
+			}
+
+			case H_HEAD:
+			{
+				Response = Session->Head();
+				break;
+			}
+
+			case H_POST:
+			{
+				Response = Session->Post();
+				break;
+			}
+
+			case H_PUT:
+			{
+				Response = Session->Put();
+				break;
+			}
+
+			case H_DELETE:
+			{
+				Response = Session->Delete();
+				break;
+			}
+
+			case H_OPTIONS:
+			{
+				Response = Session->Options();
+				break;
+			}
+
+			default:
+			{
+				throw std::exception("invalid request type");
+			}
+			}
+
+			return [Response](RbxLua NRL) 
+			{
+				http_push_response(NRL, Response);
+				return 1;
+			};
+		});
 	}
 
-	template<typename T>
-	__forceinline std::string DecryptWithAlgo(const syn::RbxLua RL, const std::string& Ciphertext, const std::string& Key, const std::string& IV)
+	int RbxApi::httprequestbatch(DWORD rL)
 	{
-		try
+		syn::RbxLua RL(rL);
+		RbxYield RYield(RL);
+
+		RL.CheckType(1, R_LUA_TTABLE);
+
+		std::vector<HttpRequest> Requests;
+		for (auto i = 1; ; i++)
 		{
-			std::string Decrypted;
+			RL.RawGetI(1, i);
+			if (RL.Type(-1) == R_LUA_TNIL)
+			{
+				RL.Pop(1);
+				break;
+			}
 
-			T Decryptor;
-			Decryptor.SetKeyWithIV((byte*) Key.c_str(), Key.size(), (byte*) IV.c_str(), IV.length());
+			if (RL.Type(-1) != R_LUA_TTABLE)
+				return RL.LError("Request #%d is not a table.", i);
 
-			const auto Base = Base64Decode(Ciphertext);
+			Requests.emplace_back();
+			http_read_request(RL, RL.GetTop(), Requests.back());
 
-			CryptoPP::StringSource ss(Base, true,
-				new CryptoPP::StreamTransformationFilter(Decryptor,
-					new CryptoPP::StringSink(Decrypted)
-				)
-			);
-			
-			return Decrypted;
+			RL.Pop(1);
 		}
-		catch (CryptoPP::Exception& e)
+
+		return RYield.Execute([Requests]()
 		{
-			UNUSED(RL.LError(e.what()));
-			return "";
+			const auto Responses = syn::HttpSessionPool::PerformBatch(Requests);
+
+			return [Responses](RbxLua NRL)
+			{
+				NRL.CreateTable(Responses.size(), 0);
+
+				for (size_t i = 0; i < Responses.size(); i++)
+				{
+					http_push_response(NRL, Responses[i]);
+					NRL.RawSetI(-2, (int) i + 1);
+				}
+
+				return 1;
+			};
+		});
+	}
+
+	/* true or nil for the default level, "fast", "default", "best" or a deflate level from 1 to 9 */
+	static int check_compression_level(const RbxLua RL, const int Index)
+	{
+		switch (RL.Type(Index))
+		{
+			case R_LUA_TNONE:
+			case R_LUA_TNIL:
+			case R_LUA_TBOOLEAN:
+				return Compression::DefaultLevel;
+			case R_LUA_TSTRING:
+			{
+				const std::string Name = RL.ToLString(Index);
+				if (Name == "fast")
+					return Compression::FastLevel;
+				if (Name == "default")
+					return Compression::DefaultLevel;
+				if (Name == "best")
+					return Compression::BestLevel;
+				break;
+			}
+			case R_LUA_TNUMBER:
+			{
+				const auto Level = RL.ToInteger(Index);
+				if (Level >= 1 && Level <= 9)
+					return (int) Level;
+				break;
+			}
+			default:
+				break;
 		}
+
+		return RL.ArgError(Index, "expected 'fast', 'default', 'best' or a level from 1 to 9");
 	}
 
-	template<typename T>
-	__forceinline std::string DecryptAuthenticatedWithAlgo(const syn::RbxLua RL, const std::string& Ciphertext, const std::string& Key, const std::string& IV)
+	/* Files written with writefile's compress argument read back inflated */
+	static void push_file_contents(const RbxLua RL, const char* Data, const size_t Size)
 	{
-		try
+		std::string Inflated;
+		if (Compression::IsCompressed(Data, Size) && Compression::Decompress(Data, Size, Inflated))
 		{
-			std::string Decrypted;
+			RL.PushLString(Inflated.c_str(), Inflated.size());
+			return;
+		}
 
-			T Decryptor;
-			Decryptor.SetKeyWithIV((byte*) Key.c_str(), Key.size(), (byte*) IV.c_str(), IV.size());
+		RL.PushLString(Data, Size);
+	}
 
-			const auto Base = Base64Decode(Ciphertext);
+	int RbxApi::readfile(DWORD rL)
+	{
+		PROFILE_ZONE(OBFUSCATE_STR("File read"));
+		syn::RbxLua RL(rL);
 
-			CryptoPP::AuthenticatedDecryptionFilter Adf(Decryptor,
-				new CryptoPP::StringSink(Decrypted)
-			);
+		size_t PathSize;
+		const auto PathCStr = RL.CheckLString(1, &PathSize);
 
-			Adf.Put((const byte*)Base.data(), Base.size());
-			Adf.MessageEnd();
+		WorkspacePaths::Path Path;
+		if (const auto Error = resolve_workspace_path(PathCStr, PathSize, false, Path))
+			return RL.LError(Error);
 
-			return Decrypted;
+		const char* PackData;
+		size_t PackSize;
+		if (const auto Pack = AssetPacks::GetSingleton()->Find(Path->Relative, PackData, PackSize))
+		{
+			push_file_contents(RL, PackData, PackSize);
+			return 1;
 		}
-		catch (CryptoPP::Exception& e)
+
+		std::string Cached;
+		if (WorkspaceCache::GetSingleton()->Read(Path->Full, Cached))
 		{
-			UNUSED(RL.LError(e.what()));
-			return "";
+			RL.PushLString(Cached.c_str(), Cached.size());
+			return 1;
 		}
+
+		if (WorkspacePaths::GetSingleton()->KindOf(*Path) == WorkspacePaths::Kind::Missing)
+            return RL.LError("file does not exist");
+
+		const MappedFile File(Path->Full);
+		if (!File.Valid())
+			return RL.LError("failed to read file");
+
+		push_file_contents(RL, File.Data(), File.Size());
+
+		return 1;
 	}
-	
-	int RbxApi::decryptstringcustom(DWORD rL)
+
+	int RbxApi::loadfile(DWORD rL)
 	{
 		syn::RbxLua RL(rL);
 
-        VM_TIGER_LONDON_START;
-    	
-    	std::string Algo = RL.CheckString(1);
-
-		size_t DataSize;
-		const auto DataCStr = RL.CheckLString(2, &DataSize);
-		const std::string Ciphertext(DataCStr, DataSize);
-
-		size_t KeySize;
-		const auto KeyCStr = RL.CheckLString(3, &KeySize);
-		const std::string Key(KeyCStr, KeySize);
+		size_t PathSize;
+		const auto PathCStr = RL.CheckLString(1, &PathSize);
 
-		size_t IvSize;
-		const auto IvCStr = RL.CheckLString(4, &IvSize);
-		const std::string Iv(IvCStr, IvSize);
+		WorkspacePaths::Path Path;
+		if (const auto Error = resolve_workspace_path(PathCStr, PathSize, false, Path))
+			return RL.LError(Error);
 
-		enum CryptModes
+		const char* PackData;
+		size_t PackSize;
+		if (const auto Pack = AssetPacks::GetSingleton()->Find(Path->Relative, PackData, PackSize))
 		{
-			//AES
-			AES_CBC,
-			AES_CFB,
-			AES_CTR,
-			AES_OFB,
-			AES_GCM,
-			AES_EAX,
-
-			//Blowfish
-			BF_CBC,
-			BF_CFB,
-			BF_OFB
-		};
+			RL.GetGlobal("loadstring");
+			push_file_contents(RL, PackData, PackSize);
+			RL.PCall(1, 1, 0);
+			return 1;
+		}
 
-		std::map<std::string, CryptModes> CryptTranslationMap =
+		std::string Cached;
+		if (WorkspaceCache::GetSingleton()->Read(Path->Full, Cached))
 		{
-			//AES
-			{ "aes-cbc", AES_CBC },
-			{ "aes_cbc", AES_CBC },
+			RL.GetGlobal("loadstring");
+			RL.PushLString(Cached.c_str(), Cached.size());
+			RL.PCall(1, 1, 0);
+			return 1;
+		}
 
-			{ "aes-cfb", AES_CFB },
-			{ "aes_cfb", AES_CFB },
+		if (WorkspacePaths::GetSingleton()->KindOf(*Path) == WorkspacePaths::Kind::Missing)
+            return RL.LError("file does not exist");
 
-			{ "aes-ctr", AES_CTR },
-			{ "aes_ctr", AES_CTR },
+		const MappedFile File(Path->Full);
+		if (!File.Valid())
+			return RL.LError("failed to read file");
 
-			{ "aes-ofb", AES_OFB },
-			{ "aes_ofb", AES_OFB },
+		RL.GetGlobal("loadstring");
+		push_file_contents(RL, File.Data(), File.Size());
+		RL.PCall(1, 1, 0);
 
-			{ "aes-gcm", AES_GCM },
-			{ "aes_gcm", AES_GCM },
+		return 1;
+	}
 
-			{ "aes-eax", AES_EAX },
-			{ "aes_eax", AES_EAX },
+    /* TODO: Abstract out base */
+	int RbxApi::writefile(DWORD rL)
+	{
+		PROFILE_ZONE(OBFUSCATE_STR("File write"));
+		syn::RbxLua RL(rL);
 
-			//Blowfish
-			{ "blowfish-cbc", BF_CBC },
-			{ "blowfish_cbc", BF_CBC },
-			{ "bf-cbc", BF_CBC },
-			{ "bf_cbc", BF_CBC },
+		size_t PathSize;
+		const auto PathCStr = RL.CheckLString(1, &PathSize);
 
-			{ "blowfish-cfb", BF_CFB },
-			{ "blowfish_cfb", BF_CFB },
-			{ "bf-cfb", BF_CFB },
-			{ "bf_cfb", BF_CFB },
+		size_t ContentsSize;
+		const auto ContentsCStr = check_bytes(RL, 2, &ContentsSize);
 
-			{ "blowfish-ofb", BF_OFB },
-			{ "blowfish_ofb", BF_OFB },
-			{ "bf-ofb", BF_OFB },
-			{ "bf_ofb", BF_OFB },
-		};
+		WorkspacePaths::Path Path;
+		if (const auto Error = resolve_workspace_path(PathCStr, PathSize, true, Path))
+			return RL.LError(Error);
 
-		std::transform(Algo.begin(), Algo.end(), Algo.begin(), tolower);
+		const auto Level = RL.ToBoolean(3) ? check_compression_level(RL, 3) : 0;
 
-		if (!CryptTranslationMap.count(Algo))
-			return RL.ArgError(1, "non-existant algorithm");
+		/* Coalesced per path and written behind, a config saved every frame costs one write per flush */
+		WorkspaceCache::GetSingleton()->Write(Path->Full, ContentsCStr, ContentsSize, Level);
 
-		const auto RAlgo = CryptTranslationMap[Algo];
+		return 0;
+	}
 
-		std::string Result;
+	int RbxApi::isfile(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
 
-		//This is intentional - blame Themida not supporting jump tables.
-		if (RAlgo == AES_CBC)
-		{
-			Result = DecryptWithAlgo<CryptoPP::CBC_Mode<CryptoPP::AES>::Decryption>(RL, Ciphertext, Key, Iv);
-		}
-		else if (RAlgo == AES_CFB)
-		{
-			Result = DecryptWithAlgo<CryptoPP::CFB_Mode<CryptoPP::AES>::Decryption>(RL, Ciphertext, Key, Iv);
-		}
-		else if (RAlgo == AES_CTR)
-		{
-			Result = DecryptWithAlgo<CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption>(RL, Ciphertext, Key, Iv);
-		}
-		else if (RAlgo == AES_OFB)
-		{
-			Result = DecryptWithAlgo<CryptoPP::OFB_Mode<CryptoPP::AES>::Decryption>(RL, Ciphertext, Key, Iv);
-		}
-		else if (RAlgo == AES_GCM)
-		{
-			Result = DecryptAuthenticatedWithAlgo<CryptoPP::GCM<CryptoPP::AES>::Decryption>(RL, Ciphertext, Key, Iv);
-		}
-		else if (RAlgo == AES_EAX)
-		{
-			Result = DecryptAuthenticatedWithAlgo<CryptoPP::EAX<CryptoPP::AES>::Decryption>(RL, Ciphertext, Key, Iv);
-		}
-		else if (RAlgo == BF_CBC)
-		{
-			Result = DecryptWithAlgo<CryptoPP::CBC_Mode<CryptoPP::Blowfish>::Decryption>(RL, Ciphertext, Key, Iv);
-		}
-		else if (RAlgo == BF_CFB)
+		size_t PathSize;
+		const auto PathCStr = RL.CheckLString(1, &PathSize);
+
+		WorkspacePaths::Path Path;
+		if (const auto Error = resolve_workspace_path(PathCStr, PathSize, false, Path))
+			return RL.LError(Error);
+
+		const char* PackData;
+		size_t PackSize;
+		if (AssetPacks::GetSingleton()->Find(Path->Relative, PackData, PackSize))
 		{
-			Result = DecryptWithAlgo<CryptoPP::CFB_Mode<CryptoPP::Blowfish>::Decryption>(RL, Ciphertext, Key, Iv);
+			RL.PushBoolean(true);
+			return 1;
 		}
-		else if (RAlgo == BF_OFB)
+
+		RL.PushBoolean(WorkspaceCache::GetSingleton()->Pending(Path->Full) || WorkspacePaths::GetSingleton()->KindOf(*Path) == WorkspacePaths::Kind::File);
+		return 1;
+	}
+
+	int RbxApi::isfolder(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		size_t PathSize;
+		const auto PathCStr = RL.CheckLString(1, &PathSize);
+
+		WorkspacePaths::Path Path;
+		if (const auto Error = resolve_workspace_path(PathCStr, PathSize, false, Path))
+			return RL.LError(Error);
+
+		RL.PushBoolean(WorkspacePaths::GetSingleton()->KindOf(*Path) == WorkspacePaths::Kind::Folder);
+		return 1;
+	}
+
+	/* listfiles(path [, { Recursive = bool, Metadata = bool }]), Metadata returns { Path, Type, Size, Modified } tables */
+	int RbxApi::listfiles(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		size_t PathSize;
+		const auto PathCStr = RL.CheckLString(1, &PathSize);
+
+		WorkspacePaths::Path Path;
+		if (const auto Error = resolve_workspace_path(PathCStr, PathSize, false, Path))
+			return RL.LError(Error);
+
+		auto Recursive = false, Metadata = false;
+		if (!RL.IsNoneOrNil(2))
 		{
-			Result = DecryptWithAlgo<CryptoPP::OFB_Mode<CryptoPP::Blowfish>::Decryption>(RL, Ciphertext, Key, Iv);
+			RL.CheckType(2, R_LUA_TTABLE);
+
+			RL.GetField(2, "Recursive");
+			Recursive = RL.ToBoolean(-1);
+			RL.GetField(2, "Metadata");
+			Metadata = RL.ToBoolean(-1);
+			RL.Pop(2);
 		}
-		else
+
+		const auto Cache = WorkspaceCache::GetSingleton();
+		Cache->Flush();
+
+		const auto Entries = Cache->List(WorkspaceDirectory, Path->Full, Recursive);
+		if (!Entries)
+			return RL.LError("folder does not exist");
+
+		RL.CreateTable((int) Entries->size(), 0);
+
+		int Index = 0;
+		for (const auto& Entry : *Entries)
 		{
-			return RL.ArgError(1, "non-existent algorithm");
-		}
+			if (Metadata)
+			{
+				RL.CreateTable(0, 4);
+				RL.PushLString(Entry.Path.c_str(), Entry.Path.size());
+				RL.SetField(-2, "Path");
+				RL.PushString(Entry.Folder ? "folder" : "file");
+				RL.SetField(-2, "Type");
+				RL.PushNumber((double) Entry.Size);
+				RL.SetField(-2, "Size");
+				RL.PushNumber((double) Entry.Modified);
+				RL.SetField(-2, "Modified");
+			}
+			else
+				RL.PushLString(Entry.Path.c_str(), Entry.Path.size());
 
-        VM_TIGER_LONDON_END;
-    	
-    	RL.PushLString(Result.c_str(), Result.size());
+			RL.RawSetI(-2, ++Index);
+		}
 
 		return 1;
 	}
 
-	int RbxApi::decryptstring(DWORD rL)
+	int RbxApi::makefolder(DWORD rL)
 	{
 		syn::RbxLua RL(rL);
 
-        VM_TIGER_WHITE_START;
+		size_t PathSize;
+		const auto PathCStr = RL.CheckLString(1, &PathSize);
 
-		size_t DataSize;
-		const auto DataCStr = RL.CheckLString(1, &DataSize);
+		WorkspacePaths::Path Path;
+		if (const auto Error = resolve_workspace_path(PathCStr, PathSize, false, Path))
+			return RL.LError(Error);
 
-		size_t KeySize;
-		const auto KeyCStr = RL.CheckLString(2, &KeySize);
+		std::filesystem::create_directories(Path->Full);
+		WorkspaceCache::GetSingleton()->Invalidate();
 
-		byte DerivedKey[32];
-		CryptoPP::PKCS5_PBKDF2_HMAC<CryptoPP::SHA384> KDF;
-		KDF.DeriveKey(DerivedKey, 32, 0, (byte*) KeyCStr, KeySize, NULL, 0, 10000);
+		return 0;
+	}
 
-		std::vector<std::string> Split;
-		SplitString(Base64Decode(std::string(DataCStr, DataSize)), "|", Split);
+	int RbxApi::delfolder(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
 
-		if (Split.size() != 2)
-			return RL.ArgError(1, "Invalid encrypted string specified");
+		size_t PathSize;
+		const auto PathCStr = RL.CheckLString(1, &PathSize);
 
-		auto Decrypted = DecryptAuthenticatedWithAlgo<CryptoPP::GCM<CryptoPP::AES>::Decryption>(RL,
-			Split.at(0),
-			std::string((const char*) DerivedKey, 32),
-			Base64Decode(Split.at(1)));
+		WorkspacePaths::Path Path;
+		if (const auto Error = resolve_workspace_path(PathCStr, PathSize, false, Path))
+			return RL.LError(Error);
 
-		RL.PushLString(Decrypted.c_str(), Decrypted.size());
+		WorkspaceCache::GetSingleton()->Flush();
+		const auto Removed = std::filesystem::remove_all(Path->Full);
+		WorkspaceCache::GetSingleton()->Invalidate();
 
-        VM_TIGER_WHITE_END;
+		if (!Removed)
+            return RL.LError("folder does not exist");
+		
+		return 0;
+	}
+
+	int RbxApi::delfile(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		size_t PathSize;
+		const auto PathCStr = RL.CheckLString(1, &PathSize);
+
+		WorkspacePaths::Path Path;
+		if (const auto Error = resolve_workspace_path(PathCStr, PathSize, false, Path))
+			return RL.LError(Error);
+
+		const auto Pending = WorkspaceCache::GetSingleton()->Discard(Path->Full);
+		const auto Removed = std::filesystem::remove(Path->Full);
+		WorkspaceCache::GetSingleton()->Invalidate();
+
+		if (!Removed && !Pending)
+            return RL.LError("file does not exist");
+
+		return 0;
+	}
+
+	int RbxApi::appendfile(DWORD rL)
+	{
+		PROFILE_ZONE(OBFUSCATE_STR("File append"));
+		syn::RbxLua RL(rL);
+
+		size_t PathSize;
+		const auto PathCStr = RL.CheckLString(1, &PathSize);
+
+		size_t ContentsSize;
+		const auto ContentsCStr = check_bytes(RL, 2, &ContentsSize);
+
+		WorkspacePaths::Path Path;
+		if (const auto Error = resolve_workspace_path(PathCStr, PathSize, false, Path))
+			return RL.LError(Error);
+
+		if (Path->Forbidden)
+			return RL.LError("file does not exist");
+
+		if (!WorkspaceCache::GetSingleton()->Append(Path->Full, ContentsCStr, ContentsSize))
+            return RL.LError("file does not exist");
+
+		return 0;
+	}
+
+	const char* RbxApi::resolve_workspace_path(const char* Path, const size_t Size, const bool Writing, WorkspacePaths::Path& Out)
+	{
+		if (const auto Error = WorkspacePaths::GetSingleton()->Resolve(WorkspaceDirectory, Path, Size, Out))
+			return Error;
 
+		if (Writing && Out->Forbidden)
+			return "forbidden extension";
+
+		return nullptr;
+	}
+
+	const char* RbxApi::resolve_workspace_path(const std::string& Path, const bool Writing, std::wstring& Out)
+	{
+		WorkspacePaths::Path Resolved;
+		if (const auto Error = resolve_workspace_path(Path.data(), Path.size(), Writing, Resolved))
+			return Error;
+
+		Out = Resolved->Full;
+		return nullptr;
+	}
+
+	/* readfileasync(path) -> string, readfileasync({ paths }) -> { contents } in the same order */
+	int RbxApi::readfileasync(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+		RbxYield RYield(RL);
+
+		const auto Batch = RL.IsTable(1);
+		if (!Batch)
+			RL.CheckLString(1, nullptr);
+
+		std::vector<FileOp> Ops;
+		std::vector<std::string> Paths;
+
+		const auto Count = Batch ? RL.ObjLen(1) : 1;
+		for (int i = 1; i <= Count; i++)
+		{
+			if (Batch)
+				RL.RawGetI(1, i);
+			else
+				RL.PushValue(1);
+
+			if (!RL.IsString(-1))
+				return RL.ArgError(1, "expected a path or a table of paths");
+
+			size_t PathSize;
+			const auto PathCStr = RL.ToLString(-1, &PathSize);
+			Paths.emplace_back(PathCStr, PathSize);
+			RL.Pop(1);
+
+			FileOp Op;
+			if (const auto Error = resolve_workspace_path(Paths.back(), false, Op.Path))
+				return RL.LError(Error);
+
+			WorkspaceCache::GetSingleton()->Sync(Op.Path);
+			Ops.push_back(std::move(Op));
+		}
+
+		return RYield.Execute([Ops, Paths, Batch]() mutable
+		{
+			AsyncFile::ReadBatch(Ops);
+
+			for (size_t i = 0; i < Ops.size(); i++)
+			{
+				if (!Ops[i].Success)
+					throw std::exception(("failed to read file '" + Paths[i] + "'").c_str());
+
+				std::string Inflated;
+				if (Compression::Decompress(Ops[i].Data.data(), Ops[i].Data.size(), Inflated))
+					Ops[i].Data = std::move(Inflated);
+			}
+
+			return [Ops = std::move(Ops), Batch](RbxLua NRL)
+			{
+				if (!Batch)
+				{
+					NRL.PushLString(Ops[0].Data.c_str(), Ops[0].Data.size());
+					return 1;
+				}
+
+				NRL.CreateTable((int) Ops.size(), 0);
+				for (size_t i = 0; i < Ops.size(); i++)
+				{
+					NRL.PushLString(Ops[i].Data.c_str(), Ops[i].Data.size());
+					NRL.RawSetI(-2, (int) i + 1);
+				}
+
+				return 1;
+			};
+		});
+	}
+
+	/* syn.mount_pack(path [, folder]), the pack's files read as if they were under folder in the workspace */
+	int RbxApi::mountpack(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		std::wstring WPath;
+		if (const auto Error = resolve_workspace_path(RL.CheckString(1), false, WPath))
+			return RL.LError(Error);
+
+		const std::string Point = RL.OptString(2, "");
+		if (Point.find("..") != std::string::npos)
+			return RL.LError("attempt to escape directory");
+
+		WorkspaceCache::GetSingleton()->Sync(WPath);
+		if (!AssetPacks::GetSingleton()->Mount(WPath, Point))
+			return RL.LError("failed to mount pack");
+
+		return 0;
+	}
+
+	/* syn.unmount_pack(path) -> whether it was mounted */
+	int RbxApi::unmountpack(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		std::wstring WPath;
+		if (const auto Error = resolve_workspace_path(RL.CheckString(1), false, WPath))
+			return RL.LError(Error);
+
+		RL.PushBoolean(AssetPacks::GetSingleton()->Unmount(WPath));
 		return 1;
 	}
 
-	char XProtectRepChar(const char Input)
+	/* syn.create_pack(path, { [name] = contents } [, compress]), compress takes the same levels as writefile */
+	int RbxApi::createpack(DWORD rL)
 	{
-		switch (Input)
+		PROFILE_ZONE(OBFUSCATE_STR("Pack create"));
+		syn::RbxLua RL(rL);
+
+		std::wstring WPath;
+		if (const auto Error = resolve_workspace_path(RL.CheckString(1), true, WPath))
+			return RL.LError(Error);
+
+		RL.CheckType(2, R_LUA_TTABLE);
+		const auto Level = RL.ToBoolean(3) ? check_compression_level(RL, 3) : 0;
+
+		std::vector<std::pair<std::string, std::string>> Files;
+
+		RL.PushNil();
+		while (RL.Next(2))
 		{
-			case 53:
+			if (RL.Type(-2) != R_LUA_TSTRING || RL.Type(-1) != R_LUA_TSTRING)
+				return RL.ArgError(2, "expected a table of string names and contents");
+
+			size_t NameSize, ContentsSize;
+			const auto NameCStr = RL.ToLString(-2, &NameSize);
+			const auto ContentsCStr = RL.ToLString(-1, &ContentsSize);
+
+			std::string Name(NameCStr, NameSize);
+			if (Name.find("..") != std::string::npos)
+				return RL.LError("attempt to escape directory");
+
+			Files.emplace_back(std::move(Name), std::string(ContentsCStr, ContentsSize));
+			RL.Pop(1);
+		}
+
+		/* A pending writefile of the same path would land on top of the pack */
+		WorkspaceCache::GetSingleton()->Discard(WPath);
+		if (!AssetPack::Build(WPath, Files, Level))
+			return RL.LError("failed to write pack");
+
+		WorkspaceCache::GetSingleton()->Invalidate();
+		return 0;
+	}
+
+	/* writefileasync(path, contents), writefileasync({ [path] = contents }) */
+	int RbxApi::writefileasync(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+		RbxYield RYield(RL);
+
+		std::vector<FileOp> Ops;
+		std::vector<std::string> Paths;
+
+		const auto Queue = [&](const int PathIndex, const int ContentsIndex) -> const char*
+		{
+			if (!RL.IsString(PathIndex) || !RL.IsString(ContentsIndex))
+				return "expected string paths and contents";
+
+			size_t PathSize, ContentsSize;
+			const auto PathCStr = RL.ToLString(PathIndex, &PathSize);
+			const auto ContentsCStr = RL.ToLString(ContentsIndex, &ContentsSize);
+
+			FileOp Op;
+			if (const auto Error = resolve_workspace_path(std::string(PathCStr, PathSize), true, Op.Path))
+				return Error;
+
+			/* An older write-behind for the same path must not land on top of this one */
+			WorkspaceCache::GetSingleton()->Sync(Op.Path);
+			Op.Data.assign(ContentsCStr, ContentsSize);
+			Paths.emplace_back(PathCStr, PathSize);
+			Ops.push_back(std::move(Op));
+			return nullptr;
+		};
+
+		if (RL.IsTable(1))
+		{
+			RL.PushNil();
+			while (RL.Next(1))
+			{
+				/* Copy the key so ToLString doesn't convert it in place and break Next */
+				RL.PushValue(-2);
+				const auto Error = Queue(-1, -2);
+				RL.Pop(2);
+
+				if (Error)
+					return RL.LError(Error);
+			}
+		}
+		else
+		{
+			RL.CheckLString(1, nullptr);
+			RL.CheckLString(2, nullptr);
+
+			if (const auto Error = Queue(1, 2))
+				return RL.LError(Error);
+		}
+
+		return RYield.Execute([Ops, Paths]() mutable
+		{
+			AsyncFile::WriteBatch(Ops);
+			WorkspaceCache::GetSingleton()->Invalidate();
+
+			for (size_t i = 0; i < Ops.size(); i++)
+				if (!Ops[i].Success)
+					throw std::exception(("failed to write file '" + Paths[i] + "'").c_str());
+
+			return [](RbxLua NRL)
+			{
+				return 0;
+			};
+		});
+	}
+
+	int RbxApi::isbeta(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+#ifdef EnableBetaRelease
+		RL.PushBoolean(true);
+#else
+		RL.PushBoolean(false);
+#endif
+
+		return 1;
+	}
+
+	int RbxApi::isluau(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		RL.PushBoolean(IsLuaU);
+
+		return 1;
+	}
+
+	int RbxApi::getnamecallmethod(DWORD rL)
+	{
+		const syn::RbxLua RL(rL);
+
+		if (!IsLuaU)
+			return RL.LError("'getnamecallmethod' is only supported on LuaU enabled games.");
+
+		RL.PushRawObject(*(uintptr_t*) (rL + L_NAMECALLMETHOD), R_LUA_TSTRING);
+
+		return 1;
+	}
+
+	int RbxApi::setnamecallmethod(DWORD rL)
+	{
+		const syn::RbxLua RL(rL);
+
+		if (!IsLuaU)
+			return RL.LError("'setnamecallmethod' is only supported on LuaU enabled games.");
+
+		if (!RL.IsString(1))
+			RL.TagError(1, R_LUA_TSTRING);
+
+		*(uintptr_t*)(rL + L_NAMECALLMETHOD) = (uintptr_t) RL.Index2Adr(1)->value.p;
+
+		return 0;
+	}
+
+	//Used in explorer.
+	int RbxApi::getpropvalue(DWORD rL)
+	{
+		const syn::RbxLua RL(rL);
+
+		RL.GetGlobal("tostring");
+		RL.GetField(1, RL.ToString(2));
+		RL.PCall(1, 1, 0);
+
+		size_t CSize;
+		const auto CStr = RL.ToLString(3, &CSize);
+
+		RL.Pop(2);
+
+		RL.PushLString(CStr, CSize);
+
+		return 1;
+	}	
+	
+	int RbxApi::setpropvalue(DWORD rL)
+	{
+		const syn::RbxLua RL(rL);
+
+		RL.SetField(1, RL.ToString(2));
+
+		return 0;
+	}
+
+	/* Connection list of the signal at Index: *Signal is the first connection, each links on at +0x8. A connection
+	   knows its signal, so connect a no-op handler, read it back and disconnect again */
+	static uintptr_t GetSignalList(RbxLua RL, int Index)
+	{
+		const auto Top = RL.GetTop();
+
+		RL.GetField(Index, OBFUSCATE_STR("Connect"));
+		RL.PushValue(Index);
+		RL.PushCFunction(RbxApi::getconnectionshandler);
+		RL.PCall(2, 1, 0);
+
+		const auto Connection = *reinterpret_cast<std::uintptr_t*>(reinterpret_cast<std::uintptr_t>(RL.ToUserData(-1)) + 4);
+		const auto Signal = *reinterpret_cast<std::uintptr_t*>(Connection + 0xC);
+
+		RL.GetField(-1, OBFUSCATE_STR("Disconnect"));
+		RL.Insert(-2);
+		RL.PCall(1, 0, 0);
+
+		RL.SetTop(Top);
+		return Signal;
+	}
+
+	int RbxApi::getconnections(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		if (!RL.IsUserData(1) || !checksignal(RL, 1))
+			return RL.ArgError(1, "signal expected");
+
+		const auto Signal = GetSignalList(RL, 1);
+
+		RL.NewTable();
+
+		auto n = 1;
+		for (auto Current = *reinterpret_cast<std::uintptr_t*>(Signal); Current; Current = *reinterpret_cast<std::uintptr_t*>(Current + 0x8))
+		{
+			RL.PushLightUserData(reinterpret_cast<void*>(Current));
+			RL.RawSetI(-2, n++);
+		}
+
+		return 1;
+	}
+
+	int RbxApi::disableconnection(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+        /* TODO: Check whether it is an actual syn signal */
+		if (!RL.IsUserData(1))
+			return RL.ArgError(1, "synapse signal expected");
+
+		const auto Connection = reinterpret_cast<std::uintptr_t>(RL.ToUserData(-1));
+		const auto Signal = *reinterpret_cast<std::uintptr_t*>(Connection + 0xC);
+
+		auto Previous = 0;
+		auto Current = *reinterpret_cast<std::uintptr_t*>(Signal);
+
+		while (Current && Current != Connection)
+		{
+			Previous = Current;
+			Current = *reinterpret_cast<std::uintptr_t*>(Current + 0x8);
+		}
+
+        if (!Current)
+            return RL.LError("synapse signal is not connected");
+
+		if (!Previous)
+			*reinterpret_cast<std::uintptr_t*>(Signal) = 0;
+		else
+			*reinterpret_cast<std::uintptr_t*>(Previous + 0x8) = *reinterpret_cast<std::uintptr_t*>(Current + 0x8);
+
+		RL.PushLightUserData(reinterpret_cast<void*>(Current));
+
+		return 1;
+	}
+
+	int RbxApi::enableconnection(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+        /* TODO: Check whether it is an actual syn signal */
+        if (!RL.IsUserData(1))
+            return RL.ArgError(1, "synapse signal expected");
+
+		const auto Connection = reinterpret_cast<std::uintptr_t>(RL.ToUserData(-1));
+		const auto Signal = *reinterpret_cast<std::uintptr_t*>(Connection + 0xC);
+
+		auto Previous = 0;
+		auto Current = *reinterpret_cast<std::uintptr_t*>(Signal);
+
+		while (Current != 0)
+		{
+			Previous = Current;
+			Current = *reinterpret_cast<std::uintptr_t*>(Current + 0x8);
+		}
+
+		if (!Previous)
+			*reinterpret_cast<std::uintptr_t*>(Signal) = Connection;
+		else
+			*reinterpret_cast<std::uintptr_t*>(Previous + 0x8) = Connection;
+
+		RL.PushLightUserData(reinterpret_cast<void*>(Current));
+
+		return 1;
+	}
+
+	/* Thread ref of a Lua connection, 0 for connections made from C++ */
+	static DWORD TryGetConnectionTR(DWORD Conn)
+	{
+		DWORD Ret = 0;
+
+		if (*(DWORD*)(Conn + 0x1C) == 0)
+			Ret = *(DWORD*)(Conn + 0x20);
+
+		else if (*(DWORD*)(Conn + 0x14) == 0)
+			Ret = *(DWORD*)(Conn + 0x18);
+
+		return Ret;
+	}
+
+	static DWORD GetConnectionTR(RbxLua RL, DWORD Conn)
+	{
+		const auto Ret = TryGetConnectionTR(Conn);
+		if (!Ret)
+			return RL.LError("internal error [0x01]");
+
+		return Ret;
+	}
+
+	/* Pushes the function behind a connection if it is a Lua connection of this VM */
+	static bool PushConnectionFunction(RbxLua RL, DWORD Conn)
+	{
+		const auto TR = TryGetConnectionTR(Conn);
+		if (!TR)
+			return false;
+
+		DWORD NRL = *(DWORD*)(*(DWORD*)(TR + 0x38) + 0x8);
+		if (syn::PointerObfuscation::DeObfuscateGlobalState(NRL + L_GS) != syn::PointerObfuscation::DeObfuscateGlobalState(RL + L_GS))
+			return false;
+
+		RbxLua RLX(NRL);
+
+		RLX.PushNumber(*(DWORD*)(TR + 0x40));
+		RLX.GetTable(LUA_REGISTRYINDEX);
+		RLX.XMove(RL, 1);
+
+		return true;
+	}
+
+	int RbxApi::getconnectionfunc(DWORD rL)
+	{
+		RbxLua RL(rL);
+
+        /* TODO: Check whether it is an actual syn signal */
+        if (!RL.IsUserData(1))
+            return RL.ArgError(1, "synapse signal expected");
+
+        VM_FISH_LITE_START;
+		DWORD Conn = (DWORD)RL.ToUserData(1);
+		DWORD TR = GetConnectionTR(RL, Conn);
+
+		DWORD NRL = *(DWORD*)(*(DWORD*)(TR + 0x38) + 0x8);
+		DWORD Idx = *(DWORD*)(TR + 0x40);
+        VM_FISH_LITE_END;
+
+		RbxLua RLX(NRL);
+
+		RLX.PushInteger(Idx);
+		RLX.GetTable(LUA_REGISTRYINDEX);
+		RLX.XMove(RL, 1);
+
+		return 1;
+	}
+
+	int RbxApi::getconnectionstate(DWORD rL)
+	{
+		/*
+			weakthreadref = signal + 0x18]
+			node = signal + 0x18] + 0x38]
+			luaState = signal + 0x18] + 0x38] + 0x8]
+		*/
+
+		RbxLua RL(rL);
+
+        /* TODO: Check whether it is an actual syn signal */
+        if (!RL.IsUserData(1))
+            return RL.ArgError(1, "synapse signal expected");
+        
+        VM_FISH_LITE_START;
+		DWORD Conn = (DWORD)RL.ToUserData(1);
+		DWORD TR = GetConnectionTR(RL, Conn);
+		DWORD NRL = *(DWORD*)(*(DWORD*)(TR + 0x38) + 0x8);
+        VM_FISH_LITE_END;
+
+		RL.PushLightUserData((void*)NRL);
+
+		return 1;
+	}
+
+	/* getconnectionsbulk({ signals }) -> { [i] = { { Connection = connection, State = thread, Function = function }, ... } }
+	   One walk per signal instead of a getconnections call plus a lookup per connection. State is only set for Lua
+	   connections and Function only for those of this VM */
+	int RbxApi::getconnectionsbulk(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+		RL.CheckType(1, R_LUA_TTABLE);
+
+		const auto Count = RL.ObjLen(1);
+		RL.CreateTable(Count, 0);
+
+		for (int i = 1; i <= Count; i++)
+		{
+			RL.RawGetI(1, i);
+			if (!RL.IsUserData(-1) || !checksignal(RL, RL.GetTop()))
+				return RL.LError("signal expected at index %d", i);
+
+			const auto Signal = GetSignalList(RL, RL.GetTop());
+			RL.Pop(1);
+
+			RL.NewTable();
+
+			auto n = 1;
+			for (auto Conn = *reinterpret_cast<std::uintptr_t*>(Signal); Conn; Conn = *reinterpret_cast<std::uintptr_t*>(Conn + 0x8))
+			{
+				RL.CreateTable(0, 3);
+
+				RL.PushLightUserData(reinterpret_cast<void*>(Conn));
+				RL.SetField(-2, "Connection");
+
+				if (const auto TR = TryGetConnectionTR(Conn))
+				{
+					RL.PushLightUserData((void*) *(DWORD*)(*(DWORD*)(TR + 0x38) + 0x8));
+					RL.SetField(-2, "State");
+				}
+
+				if (PushConnectionFunction(RL, Conn))
+					RL.SetField(-2, "Function");
+
+				RL.RawSetI(-2, n++);
+			}
+
+			RL.RawSetI(-2, i);
+		}
+
+		return 1;
+	}
+
+	/* The functions are fetched from their threads once up front, so a handler disconnecting itself (or another)
+	   doesn't change who gets called this time. Connections made from C++ have no function and are skipped */
+	static int PushSignalFunctions(RbxLua RL, uintptr_t Signal)
+	{
+		auto Count = 0;
+		for (auto Next = *reinterpret_cast<uintptr_t*>(Signal); Next; Next = *reinterpret_cast<uintptr_t*>(Next + 0x8))
+			if (PushConnectionFunction(RL, Next))
+				Count++;
+
+		return Count;
+	}
+
+	int RbxApi::firesignal(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		if (!RL.IsUserData(1) || !checksignal(RL, 1))
+			return RL.ArgError(1, "signal expected");
+
+		VM_FISH_LITE_START;
+
+		const auto Signal = GetSignalList(RL, 1);
+		RL.Remove(1);
+
+		const auto ArgumentCount = RL.GetTop();
+		const auto Functions = PushSignalFunctions(RL, Signal);
+
+		//Stack:
+		//Arg1
+		//Arg2
+		//Arg3
+		//[Functions]
+
+		for (int f = 1; f <= Functions; f++)
+		{
+			RL.PushValue(ArgumentCount + f);
+			for (int i = 1; i <= ArgumentCount; i++)
+				RL.PushValue(i);
+
+			RL.PCall(ArgumentCount, 0, 0);
+			RL.SetTop(ArgumentCount + Functions);
+		}
+
+		VM_FISH_LITE_END;
+
+		return 0;
+	}
+
+	/* firesignals(signal, { { args }, { args }, ... }) - fires once per argument list, the connection walk and function
+	   lookup happen once for the whole batch */
+	int RbxApi::firesignals(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		if (!RL.IsUserData(1) || !checksignal(RL, 1))
+			return RL.ArgError(1, "signal expected");
+		RL.CheckType(2, R_LUA_TTABLE);
+		RL.SetTop(2);
+
+		const auto Signal = GetSignalList(RL, 1);
+		const auto Functions = PushSignalFunctions(RL, Signal);
+		const auto Batches = RL.ObjLen(2);
+
+		for (int b = 1; b <= Batches; b++)
+		{
+			RL.RawGetI(2, b);
+			if (!RL.IsTable(-1))
+				return RL.LError("argument list expected at index %d", b);
+
+			const auto Arguments = RL.GetTop();
+			const auto ArgumentCount = RL.ObjLen(Arguments);
+
+			for (int f = 1; f <= Functions; f++)
+			{
+				RL.PushValue(2 + f);
+				for (int i = 1; i <= ArgumentCount; i++)
+					RL.RawGetI(Arguments, i);
+
+				RL.PCall(ArgumentCount, 0, 0);
+				RL.SetTop(Arguments);
+			}
+
+			RL.Pop(1);
+		}
+
+		return 0;
+	}
+
+	template<typename T>
+	__forceinline std::string EncryptWithAlgo(const syn::RbxLua RL, const std::string& Plaintext, const std::string& Key, const std::string& IV)
+    {
+		try
+		{
+			std::string Encrypted;
+
+			T Encryptor;
+			Encryptor.SetKeyWithIV((byte*) Key.c_str(), Key.size(), (byte*) IV.c_str(), IV.length());
+
+			CryptoPP::StringSource ss(Plaintext, true,
+				new CryptoPP::StreamTransformationFilter(Encryptor,
+					new CryptoPP::StringSink(Encrypted)
+				)
+			);
+
+			return Base64Encode((unsigned char*) Encrypted.c_str(), Encrypted.size());
+		}
+		catch (CryptoPP::Exception& e)
+		{
+			UNUSED(RL.LError(e.what()));
+			return "";
+		}
+    }
+
+	template<typename T>
+	__forceinline std::string EncryptAuthenticatedWithAlgo(const syn::RbxLua RL, const std::string& Plaintext, const std::string& Key, const std::string& IV)
+	{
+		try
+		{
+			std::string Encrypted;
+
+			T Encryptor;
+			Encryptor.SetKeyWithIV((byte*) Key.c_str(), Key.size(), (byte*) IV.c_str(), IV.size());
+
+			CryptoPP::AuthenticatedEncryptionFilter Aef(Encryptor,
+				new CryptoPP::StringSink(Encrypted)
+			);
+
+			Aef.Put((const byte*)Plaintext.data(), Plaintext.size());
+			Aef.MessageEnd();
+
+			return Base64Encode((unsigned char*) Encrypted.c_str(), Encrypted.size());
+		}
+		catch (CryptoPP::Exception& e)
+		{
+			UNUSED(RL.LError(e.what()));
+			return "";
+		}
+	}
+	
+	int RbxApi::encryptstringcustom(DWORD rL)
+    {
+		syn::RbxLua RL(rL);
+		
+        VM_TIGER_LONDON_START;
+
+		std::string Algo = RL.CheckString(1);
+
+		size_t DataSize;
+		const auto DataCStr = RL.CheckLString(2, &DataSize);
+		const std::string Plaintext(DataCStr, DataSize);
+
+		size_t KeySize;
+		const auto KeyCStr = RL.CheckLString(3, &KeySize);
+		const std::string Key(KeyCStr, KeySize);
+    	
+    	size_t IvSize;
+		const auto IvCStr = RL.CheckLString(4, &IvSize);
+		const std::string Iv(IvCStr, IvSize);
+
+		enum CryptModes
+		{
+			//AES
+			AES_CBC,
+			AES_CFB,
+			AES_CTR,
+			AES_OFB,
+			AES_GCM,
+			AES_EAX,
+
+			//Blowfish
+			BF_CBC,
+			BF_CFB,
+			BF_OFB
+		};
+
+		std::map<std::string, CryptModes> CryptTranslationMap =
+		{
+			//AES
+			{ "aes-cbc", AES_CBC },
+			{ "aes_cbc", AES_CBC },
+
+			{ "aes-cfb", AES_CFB },
+			{ "aes_cfb", AES_CFB },
+
+			{ "aes-ctr", AES_CTR },
+			{ "aes_ctr", AES_CTR },
+
+			{ "aes-ofb", AES_OFB },
+			{ "aes_ofb", AES_OFB },
+
+			{ "aes-gcm", AES_GCM },
+			{ "aes_gcm", AES_GCM },
+
+			{ "aes-eax", AES_EAX },
+			{ "aes_eax", AES_EAX },
+			
+			//Blowfish
+			{ "blowfish-cbc", BF_CBC },
+			{ "blowfish_cbc", BF_CBC },
+			{ "bf-cbc", BF_CBC },
+			{ "bf_cbc", BF_CBC },
+
+			{ "blowfish-cfb", BF_CFB },
+			{ "blowfish_cfb", BF_CFB },
+			{ "bf-cfb", BF_CFB },
+			{ "bf_cfb", BF_CFB },
+
+			{ "blowfish-ofb", BF_OFB },
+			{ "blowfish_ofb", BF_OFB },
+			{ "bf-ofb", BF_OFB },
+			{ "bf_ofb", BF_OFB },
+		};
+
+		std::transform(Algo.begin(), Algo.end(), Algo.begin(), tolower);
+
+		if (!CryptTranslationMap.count(Algo))
+			return RL.ArgError(1, "non-existant algorithm");
+
+		const auto RAlgo = CryptTranslationMap[Algo];
+
+		std::string Result;
+
+		//This is intentional - blame Themida not supporting jump tables.
+		if (RAlgo == AES_CBC)
+		{
+			Result = EncryptWithAlgo<CryptoPP::CBC_Mode<CryptoPP::AES>::Encryption>(RL, Plaintext, Key, Iv);
+		}
+		else if (RAlgo == AES_CFB)
+		{
+			Result = EncryptWithAlgo<CryptoPP::CBC_Mode<CryptoPP::AES>::Encryption>(RL, Plaintext, Key, Iv);
+		}
+		else if (RAlgo == AES_CTR)
+		{
+			Result = EncryptWithAlgo<CryptoPP::CTR_Mode<CryptoPP::AES>::Encryption>(RL, Plaintext, Key, Iv);
+		}
+		else if (RAlgo == AES_OFB)
+		{
+			Result = EncryptWithAlgo<CryptoPP::OFB_Mode<CryptoPP::AES>::Encryption>(RL, Plaintext, Key, Iv);
+		}
+		else if (RAlgo == AES_GCM)
+		{
+			Result = EncryptAuthenticatedWithAlgo<CryptoPP::GCM<CryptoPP::AES>::Encryption>(RL, Plaintext, Key, Iv);
+		}
+		else if (RAlgo == AES_EAX)
+		{
+			Result = EncryptAuthenticatedWithAlgo<CryptoPP::EAX<CryptoPP::AES>::Encryption>(RL, Plaintext, Key, Iv);
+		}
+		else if (RAlgo == BF_CBC)
+		{
+			Result = EncryptWithAlgo<CryptoPP::CBC_Mode<CryptoPP::Blowfish>::Encryption>(RL, Plaintext, Key, Iv);
+		}
+		else if (RAlgo == BF_CFB)
+		{
+			Result = EncryptWithAlgo<CryptoPP::CFB_Mode<CryptoPP::Blowfish>::Encryption>(RL, Plaintext, Key, Iv);
+		}
+		else if (RAlgo == BF_OFB)
+		{
+			Result = EncryptWithAlgo<CryptoPP::OFB_Mode<CryptoPP::Blowfish>::Encryption>(RL, Plaintext, Key, Iv);
+		}
+		else
+		{
+			return RL.ArgError(1, "non-existant algorithm");
+		}
+
+        VM_TIGER_LONDON_END;
+
+		RL.PushLString(Result.c_str(), Result.size());
+			
+		return 1;
+    }
+
+	int RbxApi::encryptstring(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+        VM_TIGER_WHITE_START;
+
+		size_t DataSize;
+		const auto DataCStr = RL.CheckLString(1, &DataSize);
+
+		size_t KeySize;
+		const auto KeyCStr = RL.CheckLString(2, &KeySize);
+
+		CryptoPP::AutoSeededRandomPool Prng;
+		byte IV[12];
+		Prng.GenerateBlock(IV, 12);
+
+		byte DerivedKey[32];
+		CryptoPP::PKCS5_PBKDF2_HMAC<CryptoPP::SHA384> KDF;
+		KDF.DeriveKey(DerivedKey, 32, 0, (byte*) KeyCStr, KeySize, NULL, 0, 10000);
+
+		auto Encrypted = EncryptAuthenticatedWithAlgo<CryptoPP::GCM<CryptoPP::AES>::Encryption>(RL, 
+			std::string(DataCStr, DataSize), 
+			std::string((const char*) DerivedKey, 32), 
+			std::string((const char*) IV, 12));
+
+		Encrypted += "|" + Base64Encode(IV, 12);
+		Encrypted = Base64Encode((byte*) Encrypted.data(), Encrypted.size());
+
+		RL.PushLString(Encrypted.c_str(), Encrypted.size());
+
+        VM_TIGER_WHITE_END;
+
+		return 1;
+	}
+
+	template<typename T>
+	__forceinline std::string DecryptWithAlgo(const syn::RbxLua RL, const std::string& Ciphertext, const std::string& Key, const std::string& IV)
+	{
+		try
+		{
+			std::string Decrypted;
+
+			T Decryptor;
+			Decryptor.SetKeyWithIV((byte*) Key.c_str(), Key.size(), (byte*) IV.c_str(), IV.length());
+
+			const auto Base = Base64Decode(Ciphertext);
+
+			CryptoPP::StringSource ss(Base, true,
+				new CryptoPP::StreamTransformationFilter(Decryptor,
+					new CryptoPP::StringSink(Decrypted)
+				)
+			);
+			
+			return Decrypted;
+		}
+		catch (CryptoPP::Exception& e)
+		{
+			UNUSED(RL.LError(e.what()));
+			return "";
+		}
+	}
+
+	template<typename T>
+	__forceinline std::string DecryptAuthenticatedWithAlgo(const syn::RbxLua RL, const std::string& Ciphertext, const std::string& Key, const std::string& IV)
+	{
+		try
+		{
+			std::string Decrypted;
+
+			T Decryptor;
+			Decryptor.SetKeyWithIV((byte*) Key.c_str(), Key.size(), (byte*) IV.c_str(), IV.size());
+
+			const auto Base = Base64Decode(Ciphertext);
+
+			CryptoPP::AuthenticatedDecryptionFilter Adf(Decryptor,
+				new CryptoPP::StringSink(Decrypted)
+			);
+
+			Adf.Put((const byte*)Base.data(), Base.size());
+			Adf.MessageEnd();
+
+			return Decrypted;
+		}
+		catch (CryptoPP::Exception& e)
+		{
+			UNUSED(RL.LError(e.what()));
+			return "";
+		}
+	}
+	
+	int RbxApi::decryptstringcustom(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+        VM_TIGER_LONDON_START;
+    	
+    	std::string Algo = RL.CheckString(1);
+
+		size_t DataSize;
+		const auto DataCStr = RL.CheckLString(2, &DataSize);
+		const std::string Ciphertext(DataCStr, DataSize);
+
+		size_t KeySize;
+		const auto KeyCStr = RL.CheckLString(3, &KeySize);
+		const std::string Key(KeyCStr, KeySize);
+
+		size_t IvSize;
+		const auto IvCStr = RL.CheckLString(4, &IvSize);
+		const std::string Iv(IvCStr, IvSize);
+
+		enum CryptModes
+		{
+			//AES
+			AES_CBC,
+			AES_CFB,
+			AES_CTR,
+			AES_OFB,
+			AES_GCM,
+			AES_EAX,
+
+			//Blowfish
+			BF_CBC,
+			BF_CFB,
+			BF_OFB
+		};
+
+		std::map<std::string, CryptModes> CryptTranslationMap =
+		{
+			//AES
+			{ "aes-cbc", AES_CBC },
+			{ "aes_cbc", AES_CBC },
+
+			{ "aes-cfb", AES_CFB },
+			{ "aes_cfb", AES_CFB },
+
+			{ "aes-ctr", AES_CTR },
+			{ "aes_ctr", AES_CTR },
+
+			{ "aes-ofb", AES_OFB },
+			{ "aes_ofb", AES_OFB },
+
+			{ "aes-gcm", AES_GCM },
+			{ "aes_gcm", AES_GCM },
+
+			{ "aes-eax", AES_EAX },
+			{ "aes_eax", AES_EAX },
+
+			//Blowfish
+			{ "blowfish-cbc", BF_CBC },
+			{ "blowfish_cbc", BF_CBC },
+			{ "bf-cbc", BF_CBC },
+			{ "bf_cbc", BF_CBC },
+
+			{ "blowfish-cfb", BF_CFB },
+			{ "blowfish_cfb", BF_CFB },
+			{ "bf-cfb", BF_CFB },
+			{ "bf_cfb", BF_CFB },
+
+			{ "blowfish-ofb", BF_OFB },
+			{ "blowfish_ofb", BF_OFB },
+			{ "bf-ofb", BF_OFB },
+			{ "bf_ofb", BF_OFB },
+		};
+
+		std::transform(Algo.begin(), Algo.end(), Algo.begin(), tolower);
+
+		if (!CryptTranslationMap.count(Algo))
+			return RL.ArgError(1, "non-existant algorithm");
+
+		const auto RAlgo = CryptTranslationMap[Algo];
+
+		std::string Result;
+
+		//This is intentional - blame Themida not supporting jump tables.
+		if (RAlgo == AES_CBC)
+		{
+			Result = DecryptWithAlgo<CryptoPP::CBC_Mode<CryptoPP::AES>::Decryption>(RL, Ciphertext, Key, Iv);
+		}
+		else if (RAlgo == AES_CFB)
+		{
+			Result = DecryptWithAlgo<CryptoPP::CFB_Mode<CryptoPP::AES>::Decryption>(RL, Ciphertext, Key, Iv);
+		}
+		else if (RAlgo == AES_CTR)
+		{
+			Result = DecryptWithAlgo<CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption>(RL, Ciphertext, Key, Iv);
+		}
+		else if (RAlgo == AES_OFB)
+		{
+			Result = DecryptWithAlgo<CryptoPP::OFB_Mode<CryptoPP::AES>::Decryption>(RL, Ciphertext, Key, Iv);
+		}
+		else if (RAlgo == AES_GCM)
+		{
+			Result = DecryptAuthenticatedWithAlgo<CryptoPP::GCM<CryptoPP::AES>::Decryption>(RL, Ciphertext, Key, Iv);
+		}
+		else if (RAlgo == AES_EAX)
+		{
+			Result = DecryptAuthenticatedWithAlgo<CryptoPP::EAX<CryptoPP::AES>::Decryption>(RL, Ciphertext, Key, Iv);
+		}
+		else if (RAlgo == BF_CBC)
+		{
+			Result = DecryptWithAlgo<CryptoPP::CBC_Mode<CryptoPP::Blowfish>::Decryption>(RL, Ciphertext, Key, Iv);
+		}
+		else if (RAlgo == BF_CFB)
+		{
+			Result = DecryptWithAlgo<CryptoPP::CFB_Mode<CryptoPP::Blowfish>::Decryption>(RL, Ciphertext, Key, Iv);
+		}
+		else if (RAlgo == BF_OFB)
+		{
+			Result = DecryptWithAlgo<CryptoPP::OFB_Mode<CryptoPP::Blowfish>::Decryption>(RL, Ciphertext, Key, Iv);
+		}
+		else
+		{
+			return RL.ArgError(1, "non-existent algorithm");
+		}
+
+        VM_TIGER_LONDON_END;
+    	
+    	RL.PushLString(Result.c_str(), Result.size());
+
+		return 1;
+	}
+
+	int RbxApi::decryptstring(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+        VM_TIGER_WHITE_START;
+
+		size_t DataSize;
+		const auto DataCStr = RL.CheckLString(1, &DataSize);
+
+		size_t KeySize;
+		const auto KeyCStr = RL.CheckLString(2, &KeySize);
+
+		byte DerivedKey[32];
+		CryptoPP::PKCS5_PBKDF2_HMAC<CryptoPP::SHA384> KDF;
+		KDF.DeriveKey(DerivedKey, 32, 0, (byte*) KeyCStr, KeySize, NULL, 0, 10000);
+
+		std::vector<std::string> Split;
+		SplitString(Base64Decode(DataCStr, DataSize), "|", Split);
+
+		if (Split.size() != 2)
+			return RL.ArgError(1, "Invalid encrypted string specified");
+
+		auto Decrypted = DecryptAuthenticatedWithAlgo<CryptoPP::GCM<CryptoPP::AES>::Decryption>(RL,
+			Split.at(0),
+			std::string((const char*) DerivedKey, 32),
+			Base64Decode(Split.at(1)));
+
+		RL.PushLString(Decrypted.c_str(), Decrypted.size());
+
+        VM_TIGER_WHITE_END;
+
+		return 1;
+	}
+
+	char XProtectRepChar(const char Input)
+	{
+		switch (Input)
+		{
+			case 53:
 				return 65;
 			case 52:
 				return 66;
@@ -3699,990 +5498,2968 @@ namespace syn
 			case 106:
 				return 122;
 			default:
-				return Input;
+				return Input;
+		}
+	}
+
+	__forceinline std::string XProtectDecryptNew(syn::RbxLua RL, std::string Data)
+	{
+		std::string OutputReal;
+
+		for (auto& I : Data)
+		{
+			I = XProtectRepChar(I);
+		}
+
+		const auto OutputAes = DecryptWithAlgo<CryptoPP::CFB_Mode<CryptoPP::AES>::Decryption>(RL, Data, OBFUSCATE_STR_TEA("gN1gFQXXoOB3DMy3DzJyECZ8LDAIPc3D"), OBFUSCATE_STR_TEA("ACUCcF3GDFffLC4f"));
+		return DecryptWithAlgo<CryptoPP::CFB_Mode<CryptoPP::Blowfish>::Decryption>(RL, OutputAes, OBFUSCATE_STR_TEA("QXXogN1gFOB3DMy3xDAIPX4nzJynCZ8L"), OBFUSCATE_STR_TEA("3dCUGc2G"));
+	}
+
+	int RbxApi::xprotect(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+        VM_TIGER_LONDON_START;
+		
+		const std::string Data = RL.CheckString(1);
+
+		auto Output = XProtectDecryptNew(RL, Data);
+		if (Output.find(OBFUSCATE_STR("2340@4$CdfHFSK(#)")) == std::string::npos)
+		{
+			//Decrypt with old XProtect
+			Output = DecryptWithAlgo<CryptoPP::CFB_Mode<CryptoPP::Blowfish>::Decryption>(RL, Data, OBFUSCATE_STR_TEA("CtyqqJ9Ci4vDstSe43Dfs6DlldOhFcvu"), OBFUSCATE_STR_TEA("2R0G7s7k"));
+		}
+
+		ReplaceAll(Output, OBFUSCATE_STR("if (isreadonly(game) == false) then return end"), "");
+
+		auto Schedule = syn::Scheduler::GetSingleton();
+		Schedule->Push(Output);
+
+        VM_TIGER_LONDON_END;
+		
+		return 0;
+	}
+
+	/* Streaming AES-GCM, CryptoPP picks AES-NI and CLMUL at runtime when the cpu has them */
+	struct CipherStream
+	{
+		CryptoPP::GCM<CryptoPP::AES>::Encryption Encryptor;
+		CryptoPP::GCM<CryptoPP::AES>::Decryption Decryptor;
+		bool Encrypting;
+		bool Finished = false;
+		byte IV[12];
+		std::string Scratch; /* reused output chunk, only grows */
+	};
+
+	static std::unordered_map<uintptr_t, std::unique_ptr<CipherStream>> CipherStreams;
+	static uintptr_t NextCipherStream = 0;
+
+	void RbxApi::cipher_invalidate()
+	{
+		CipherStreams.clear();
+	}
+
+	static CipherStream* cipher_check_stream(RbxLua RL, const int Index)
+	{
+		if (RL.IsLightUserData(Index))
+		{
+			const auto Found = CipherStreams.find((uintptr_t) RL.ToUserData(Index));
+			if (Found != CipherStreams.end())
+				return Found->second.get();
+		}
+
+		RL.ArgError(Index, "cipher stream expected");
+		return nullptr;
+	}
+
+	/* createcipher(mode, key, iv), key is a raw 16/24/32 byte AES key, iv is 12 bytes and random if omitted when encrypting */
+	int RbxApi::createcipher(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		const std::string Mode = RL.CheckString(1);
+		if (Mode != "encrypt" && Mode != "decrypt")
+			return RL.ArgError(1, "mode must be 'encrypt' or 'decrypt'");
+
+		size_t KeySize;
+		const auto KeyCStr = RL.CheckLString(2, &KeySize);
+		if (KeySize != 16 && KeySize != 24 && KeySize != 32)
+			return RL.ArgError(2, "key must be 16, 24 or 32 bytes");
+
+		auto Stream = std::make_unique<CipherStream>();
+		Stream->Encrypting = Mode == "encrypt";
+
+		if (RL.IsNoneOrNil(3))
+		{
+			if (!Stream->Encrypting)
+				return RL.ArgError(3, "iv expected");
+
+			CryptoPP::AutoSeededRandomPool Prng;
+			Prng.GenerateBlock(Stream->IV, sizeof(Stream->IV));
+		}
+		else
+		{
+			size_t IVSize;
+			const auto IVCStr = RL.CheckLString(3, &IVSize);
+			if (IVSize != sizeof(Stream->IV))
+				return RL.ArgError(3, "iv must be 12 bytes");
+
+			memcpy(Stream->IV, IVCStr, sizeof(Stream->IV));
+		}
+
+		if (Stream->Encrypting)
+			Stream->Encryptor.SetKeyWithIV((const byte*) KeyCStr, KeySize, Stream->IV, sizeof(Stream->IV));
+		else
+			Stream->Decryptor.SetKeyWithIV((const byte*) KeyCStr, KeySize, Stream->IV, sizeof(Stream->IV));
+
+		const auto Handle = ++NextCipherStream;
+		CipherStreams.emplace(Handle, std::move(Stream));
+
+		RL.PushLightUserData((void*) Handle);
+
+		return 1;
+	}
+
+	/* cipherupdate(cipher, data), returns the transformed chunk, same length as data */
+	int RbxApi::cipherupdate(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		const auto Stream = cipher_check_stream(RL, 1);
+		if (Stream->Finished)
+			return RL.LError("cipher stream already finished");
+
+		size_t DataSize;
+		const auto DataCStr = check_bytes(RL, 2, &DataSize);
+
+		if (Stream->Scratch.size() < DataSize)
+			Stream->Scratch.resize(DataSize);
+
+		const auto Out = (byte*) &Stream->Scratch[0];
+		if (Stream->Encrypting)
+			Stream->Encryptor.ProcessData(Out, (const byte*) DataCStr, DataSize);
+		else
+			Stream->Decryptor.ProcessData(Out, (const byte*) DataCStr, DataSize);
+
+		RL.PushLString((const char*) Out, DataSize);
+
+		return 1;
+	}
+
+	/* cipherfinal(cipher, tag), returns the 16 byte tag when encrypting, whether tag matched when decrypting */
+	int RbxApi::cipherfinal(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		const auto Stream = cipher_check_stream(RL, 1);
+		if (Stream->Finished)
+			return RL.LError("cipher stream already finished");
+
+		Stream->Finished = true;
+
+		if (Stream->Encrypting)
+		{
+			byte Tag[16];
+			Stream->Encryptor.TruncatedFinal(Tag, sizeof(Tag));
+
+			RL.PushLString((const char*) Tag, sizeof(Tag));
+			return 1;
+		}
+
+		size_t TagSize;
+		const auto TagCStr = RL.CheckLString(2, &TagSize);
+		if (TagSize != 16)
+			return RL.ArgError(2, "tag must be 16 bytes");
+
+		RL.PushBoolean(Stream->Decryptor.TruncatedVerify((const byte*) TagCStr, TagSize));
+
+		return 1;
+	}
+
+	int RbxApi::cipheriv(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		const auto Stream = cipher_check_stream(RL, 1);
+
+		RL.PushLString((const char*) Stream->IV, sizeof(Stream->IV));
+
+		return 1;
+	}
+
+	int RbxApi::destroycipher(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		if (RL.IsLightUserData(1))
+			CipherStreams.erase((uintptr_t) RL.ToUserData(1));
+
+		return 0;
+	}
+
+	template<typename T>
+	__forceinline std::string HashWithAlgo(const std::string& Input)
+	{
+		T Hash;
+		std::string Digest;
+
+		CryptoPP::StringSource SS(Input, true,
+			new CryptoPP::HashFilter(Hash,
+				new CryptoPP::HexEncoder(
+					new CryptoPP::StringSink(Digest), false
+				)));
+
+		return Digest;
+	}
+
+	int RbxApi::hashstring(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+        VM_TIGER_WHITE_START;
+
+		size_t DataSize;
+		const auto DataCStr = RL.CheckLString(1, &DataSize);
+
+		auto Hash = HashWithAlgo<CryptoPP::SHA384>(std::string(DataCStr, DataSize));
+
+		RL.PushLString(Hash.c_str(), Hash.size());
+
+        VM_TIGER_WHITE_END;
+
+		return 1;
+	}
+
+	/* xxHash3, for cache keys and change detection where SHA is needless work */
+	struct XXHashStream
+	{
+		std::unique_ptr<XXH3_state_t> State; /* XXH3_state_t is 64 byte aligned, aligned new keeps that */
+		bool Wide;
+	};
+
+	static std::unordered_map<uintptr_t, XXHashStream> XXHashStreams;
+	static uintptr_t NextXXHashStream = 0;
+
+	void RbxApi::xxhash_invalidate()
+	{
+		XXHashStreams.clear();
+	}
+
+	static bool xxhash_check_bits(RbxLua RL, const int Index)
+	{
+		const auto Bits = RL.OptInteger(Index, 64);
+		if (Bits != 64 && Bits != 128)
+			RL.ArgError(Index, "bits must be 64 or 128");
+
+		return Bits == 128;
+	}
+
+	static void xxhash_push_digest(RbxLua RL, const bool Wide, const XXH64_hash_t Low, const XXH64_hash_t High)
+	{
+		char Hex[33];
+		if (Wide)
+			snprintf(Hex, sizeof(Hex), "%016llx%016llx", High, Low);
+		else
+			snprintf(Hex, sizeof(Hex), "%016llx", Low);
+
+		RL.PushLString(Hex, Wide ? 32 : 16);
+	}
+
+	static void xxhash_push_oneshot(RbxLua RL, const void* Data, const size_t Size, const bool Wide, const XXH64_hash_t Seed)
+	{
+		if (Wide)
+		{
+			const auto Hash = XXH3_128bits_withSeed(Data, Size, Seed);
+			xxhash_push_digest(RL, true, Hash.low64, Hash.high64);
+		}
+		else
+		{
+			xxhash_push_digest(RL, false, XXH3_64bits_withSeed(Data, Size, Seed), 0);
+		}
+	}
+
+	/* crypt.xxhash.hash(data, bits, seed), data can be a string or a buffer */
+	int RbxApi::xxhash(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		size_t DataSize;
+		const auto DataCStr = check_bytes(RL, 1, &DataSize);
+		const auto Wide = xxhash_check_bits(RL, 2);
+		const auto Seed = (XXH64_hash_t) (long long) RL.OptNumber(3, 0);
+
+		xxhash_push_oneshot(RL, DataCStr, DataSize, Wide, Seed);
+
+		return 1;
+	}
+
+	/* crypt.xxhash.file(path, bits, seed), hashes straight off the file mapping */
+	int RbxApi::xxhashfile(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		size_t PathSize;
+		const auto PathCStr = RL.CheckLString(1, &PathSize);
+
+		const auto Wide = xxhash_check_bits(RL, 2);
+		const auto Seed = (XXH64_hash_t) (long long) RL.OptNumber(3, 0);
+
+		WorkspacePaths::Path Path;
+		if (const auto Error = resolve_workspace_path(PathCStr, PathSize, false, Path))
+			return RL.LError(Error);
+
+		WorkspaceCache::GetSingleton()->Sync(Path->Full);
+
+		if (WorkspacePaths::GetSingleton()->KindOf(*Path) == WorkspacePaths::Kind::Missing)
+			return RL.LError("file does not exist");
+
+		const MappedFile File(Path->Full);
+		if (!File.Valid())
+			return RL.LError("failed to read file");
+
+		xxhash_push_oneshot(RL, File.Data(), File.Size(), Wide, Seed);
+
+		return 1;
+	}
+
+	static XXHashStream* xxhash_check_stream(RbxLua RL, const int Index)
+	{
+		if (RL.IsLightUserData(Index))
+		{
+			const auto Found = XXHashStreams.find((uintptr_t) RL.ToUserData(Index));
+			if (Found != XXHashStreams.end())
+				return &Found->second;
+		}
+
+		RL.ArgError(Index, "xxhash stream expected");
+		return nullptr;
+	}
+
+	int RbxApi::createxxhash(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		XXHashStream Stream{ std::make_unique<XXH3_state_t>(), xxhash_check_bits(RL, 1) };
+		const auto Seed = (XXH64_hash_t) (long long) RL.OptNumber(2, 0);
+
+		if (Stream.Wide)
+			XXH3_128bits_reset_withSeed(Stream.State.get(), Seed);
+		else
+			XXH3_64bits_reset_withSeed(Stream.State.get(), Seed);
+
+		const auto Handle = ++NextXXHashStream;
+		XXHashStreams.emplace(Handle, std::move(Stream));
+
+		RL.PushLightUserData((void*) Handle);
+
+		return 1;
+	}
+
+	int RbxApi::xxhashupdate(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		const auto Stream = xxhash_check_stream(RL, 1);
+
+		size_t DataSize;
+		const auto DataCStr = check_bytes(RL, 2, &DataSize);
+
+		if (Stream->Wide)
+			XXH3_128bits_update(Stream->State.get(), DataCStr, DataSize);
+		else
+			XXH3_64bits_update(Stream->State.get(), DataCStr, DataSize);
+
+		return 0;
+	}
+
+	/* Digesting leaves the state alone, a stream can keep being updated afterwards */
+	int RbxApi::xxhashdigest(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		const auto Stream = xxhash_check_stream(RL, 1);
+
+		if (Stream->Wide)
+		{
+			const auto Hash = XXH3_128bits_digest(Stream->State.get());
+			xxhash_push_digest(RL, true, Hash.low64, Hash.high64);
+		}
+		else
+		{
+			xxhash_push_digest(RL, false, XXH3_64bits_digest(Stream->State.get()), 0);
+		}
+
+		return 1;
+	}
+
+	int RbxApi::destroyxxhash(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		if (RL.IsLightUserData(1))
+			XXHashStreams.erase((uintptr_t) RL.ToUserData(1));
+
+		return 0;
+	}
+
+	int RbxApi::hashstringcustom(DWORD rL)
+    {
+		syn::RbxLua RL(rL);
+
+        VM_TIGER_WHITE_START;
+    	
+    	std::string Algo = RL.CheckString(1);
+
+    	size_t DataSize;
+		const auto DataCStr = RL.CheckLString(2, &DataSize);
+		const std::string Data(DataCStr, DataSize);
+
+		enum HashModes
+		{
+			//MD5
+			MD5,
+
+			//SHA1
+			SHA1,
+
+			//SHA2
+			SHA224,
+			SHA256,
+			SHA384,
+			SHA512,
+
+			//SHA3
+			SHA3_256,
+			SHA3_384,
+			SHA3_512,
+		};
+
+		std::map<std::string, HashModes> HashTranslationMap =
+		{
+			//MD5
+			{ "md5", MD5 },
+
+			//SHA1
+			{ "sha1", SHA1 },
+
+			//SHA2
+			{ "sha224", SHA224 },
+			{ "sha256", SHA256 },
+			{ "sha384", SHA384 },
+			{ "sha512", SHA512 },
+
+			//SHA3
+			{ "sha3-256", SHA3_256 },
+			{ "sha3_256", SHA3_256 },
+			{ "sha3-384", SHA3_384 },
+			{ "sha3_384", SHA3_384 },
+			{ "sha3-512", SHA3_512 },
+			{ "sha3_512", SHA3_512 },
+		};
+
+		std::transform(Algo.begin(), Algo.end(), Algo.begin(), tolower);
+
+		if (!HashTranslationMap.count(Algo))
+			return RL.ArgError(1, "non-existant hash algorithm");
+
+		const auto RAlgo = HashTranslationMap[Algo];
+
+		std::string Hash;
+		
+		//This is intentional - blame Themida not supporting jump tables.
+		if (RAlgo == MD5)
+		{
+			Hash = HashWithAlgo<CryptoPP::Weak::MD5>(Data);
+		}
+		else if (RAlgo == SHA1)
+		{
+			Hash = HashWithAlgo<CryptoPP::SHA1>(Data);
+		}
+		else if (RAlgo == SHA224)
+		{
+			Hash = HashWithAlgo<CryptoPP::SHA224>(Data);
+		}
+		else if (RAlgo == SHA256)
+		{
+			Hash = HashWithAlgo<CryptoPP::SHA256>(Data);
+		}
+		else if (RAlgo == SHA384)
+		{
+			Hash = HashWithAlgo<CryptoPP::SHA384>(Data);
+		}
+		else if (RAlgo == SHA512)
+		{
+			Hash = HashWithAlgo<CryptoPP::SHA512>(Data);
+		}
+		else if (RAlgo == SHA3_256)
+		{
+			Hash = HashWithAlgo<CryptoPP::SHA3_256>(Data);
+		}
+		else if (RAlgo == SHA3_384)
+		{
+			Hash = HashWithAlgo<CryptoPP::SHA3_384>(Data);
+		}
+		else if (RAlgo == SHA3_512)
+		{
+			Hash = HashWithAlgo<CryptoPP::SHA3_512>(Data);
+		}
+		else
+		{
+			return RL.ArgError(1, "non-existant hash algorithm");
+		}
+
+		RL.PushLString(Hash.c_str(), Hash.size());
+
+        VM_TIGER_WHITE_END;
+
+		return 1;
+    }
+
+	int RbxApi::randomstring(DWORD rL)
+    {
+		syn::RbxLua RL(rL);
+
+        VM_TIGER_WHITE_START;
+    	
+		const auto Size = RL.CheckInt(1);
+
+		if (Size > 1024)
+			return RL.ArgError(1, "exceeded maximum size (1024)");
+
+		if (Size < 0)
+			return RL.ArgError(1, "negative size specified");
+
+		CryptoPP::AutoSeededRandomPool Prng;
+		auto Alloc = (byte*) operator new(Size);
+		Prng.GenerateBlock(Alloc, Size);
+
+		RL.PushLString((const char*) Alloc, Size);
+
+		delete Alloc;
+
+        VM_TIGER_WHITE_END;
+    	
+    	return 1;
+    }
+
+	int RbxApi::derivestring(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+        VM_TIGER_WHITE_START;
+    	
+    	size_t DataSize;
+		const auto DataCStr = RL.CheckLString(1, &DataSize);
+    	
+    	const auto Size = RL.CheckInt(2);
+
+		if (Size > 1024)
+			return RL.ArgError(2, "exceeded maximum size (1024)");
+
+		if (Size < 0)
+			return RL.ArgError(2, "negative size specified");
+
+		auto Alloc = (byte*) operator new(Size);
+		CryptoPP::PKCS5_PBKDF2_HMAC<CryptoPP::SHA384> KDF;
+		KDF.DeriveKey(Alloc, Size, 0, (byte*) DataCStr, DataSize, NULL, 0, 10000);
+
+		RL.PushLString((const char*) Alloc, Size);
+
+		delete Alloc;
+
+        VM_TIGER_WHITE_END;
+    	
+    	return 1;
+	}
+
+	int RbxApi::base64encode(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		size_t DataSize;
+		const auto DataCStr = check_bytes(RL, 1, &DataSize);
+
+		auto Encoded = Base64Encode((unsigned char*) DataCStr, DataSize);
+
+		RL.PushLString(Encoded.c_str(), Encoded.size());
+
+		return 1;
+	}
+
+	int RbxApi::base64decode(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		size_t DataSize;
+		const auto DataCStr = RL.CheckLString(1, &DataSize);
+
+		auto Decoded = Base64Decode(DataCStr, DataSize);
+
+		RL.PushLString(Decoded.c_str(), Decoded.size());
+
+		return 1;
+	}
+
+	/* Nesting past this is either hostile input or a cyclic table */
+	constexpr int JsonMaxDepth = 256;
+
+	/* lua_checkstack, a C function only starts with LUA_MINSTACK free slots */
+	static void json_checkstack(const RbxLua RL, const int N)
+	{
+		if (*(DWORD*)(RL + L_STKLAST) - *(DWORD*)(RL + L_TOP) <= N * sizeof(TValue))
+			RL.DGrowStk(N);
+	}
+
+	static void json_encode_string(std::string& Out, const char* Str, const size_t Len)
+	{
+		static const char Hex[] = "0123456789abcdef";
+
+		Out += '"';
+
+		/* Copy the runs that need no escaping in one go */
+		size_t Start = 0;
+		for (size_t i = 0; i < Len; i++)
+		{
+			const auto C = (unsigned char) Str[i];
+			if (C >= 0x20 && C != '"' && C != '\\')
+				continue;
+
+			Out.append(Str + Start, i - Start);
+			Start = i + 1;
+
+			switch (C)
+			{
+				case '"': Out += "\\\""; break;
+				case '\\': Out += "\\\\"; break;
+				case '\b': Out += "\\b"; break;
+				case '\f': Out += "\\f"; break;
+				case '\n': Out += "\\n"; break;
+				case '\r': Out += "\\r"; break;
+				case '\t': Out += "\\t"; break;
+				default:
+				{
+					const char Escape[6] = { '\\', 'u', '0', '0', Hex[C >> 4], Hex[C & 15] };
+					Out.append(Escape, sizeof(Escape));
+					break;
+				}
+			}
+		}
+
+		Out.append(Str + Start, Len - Start);
+		Out += '"';
+	}
+
+	static bool json_encode_number(std::string& Out, const double N)
+	{
+		if (N != N || N == HUGE_VAL || N == -HUGE_VAL)
+			return false;
+
+		/* Lua's own %.14g unless that loses bits, the decoder should get the same double back */
+		char Buffer[32];
+		auto Len = snprintf(Buffer, sizeof(Buffer), "%.14g", N);
+		if (strtod(Buffer, nullptr) != N)
+			Len = snprintf(Buffer, sizeof(Buffer), "%.17g", N);
+
+		Out.append(Buffer, Len);
+		return true;
+	}
+
+	static void json_encode(const RbxLua RL, std::string& Out, const int Index, const int Depth)
+	{
+		switch (RL.Type(Index))
+		{
+			case R_LUA_TNIL:
+				Out += "null";
+				return;
+			case R_LUA_TBOOLEAN:
+				Out += RL.ToBoolean(Index) ? "true" : "false";
+				return;
+			case R_LUA_TNUMBER:
+				if (!json_encode_number(Out, RL.ToNumber(Index)))
+					RL.LError("cannot encode NaN or infinity");
+				return;
+			case R_LUA_TSTRING:
+			{
+				size_t Len;
+				const auto Str = RL.ToLString(Index, &Len);
+				json_encode_string(Out, Str, Len);
+				return;
+			}
+			case R_LUA_TTABLE:
+				break;
+			default:
+				RL.LError("cannot encode a %s", RL.TypeName(RL.Type(Index)));
+				return;
+		}
+
+		if (Depth >= JsonMaxDepth)
+			RL.LError("table nesting too deep (cyclic table?)");
+
+		json_checkstack(RL, 3);
+
+		/* A table is an array only when its keys are exactly 1..#t, an empty one encodes as [] */
+		const auto Length = RL.ObjLen(Index);
+		auto Count = 0;
+		RL.PushNil();
+		while (RL.Next(Index))
+		{
+			RL.Pop(1);
+			if (++Count > Length)
+			{
+				RL.Pop(1);
+				break;
+			}
+		}
+
+		if (Count == Length)
+		{
+			Out += '[';
+			for (auto i = 1; i <= Length; i++)
+			{
+				if (i > 1)
+					Out += ',';
+
+				RL.RawGetI(Index, i);
+				json_encode(RL, Out, RL.GetTop(), Depth + 1);
+				RL.Pop(1);
+			}
+			Out += ']';
+			return;
+		}
+
+		Out += '{';
+		auto First = true;
+		RL.PushNil();
+		while (RL.Next(Index))
+		{
+			if (!First)
+				Out += ',';
+			First = false;
+
+			/* ToLString would turn a number key into a string in place and break Next */
+			if (RL.Type(-2) == R_LUA_TSTRING)
+			{
+				size_t Len;
+				const auto Key = RL.ToLString(-2, &Len);
+				json_encode_string(Out, Key, Len);
+			}
+			else if (RL.Type(-2) == R_LUA_TNUMBER)
+			{
+				Out += '"';
+				if (!json_encode_number(Out, RL.ToNumber(-2)))
+					RL.LError("cannot encode an infinite key");
+				Out += '"';
+			}
+			else
+			{
+				RL.LError("cannot encode a table with %s keys", RL.TypeName(RL.Type(-2)));
+			}
+
+			Out += ':';
+			json_encode(RL, Out, RL.GetTop(), Depth + 1);
+			RL.Pop(1);
+		}
+		Out += '}';
+	}
+
+	int RbxApi::jsonencode(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		RL.CheckAny(1);
+		RL.SetTop(1);
+
+		/* Keeps its capacity between calls, big payloads stop reallocating after the first encode */
+		static thread_local std::string Out;
+		Out.clear();
+
+		json_encode(RL, Out, 1, 0);
+
+		RL.PushLString(Out.c_str(), Out.size());
+
+		return 1;
+	}
+
+	/* SAX handler building Lua values straight on the stack, the containers being filled sit below the value */
+	class JsonDecoder
+	{
+	public:
+		explicit JsonDecoder(const RbxLua _RL) : RL(_RL) {}
+
+		bool null()
+		{
+			RL.PushNil();
+			return Attach();
+		}
+
+		bool boolean(const bool Val)
+		{
+			RL.PushBoolean(Val);
+			return Attach();
+		}
+
+		bool number_integer(const json::number_integer_t Val)
+		{
+			RL.PushNumber((lua_Number) Val);
+			return Attach();
+		}
+
+		bool number_unsigned(const json::number_unsigned_t Val)
+		{
+			RL.PushNumber((lua_Number) Val);
+			return Attach();
+		}
+
+		bool number_float(const json::number_float_t Val, const json::string_t&)
+		{
+			RL.PushNumber((lua_Number) Val);
+			return Attach();
+		}
+
+		bool string(json::string_t& Val)
+		{
+			RL.PushLString(Val.data(), Val.size());
+			return Attach();
+		}
+
+		bool key(json::string_t& Val)
+		{
+			RL.PushLString(Val.data(), Val.size());
+			return true;
+		}
+
+		bool start_object(std::size_t)
+		{
+			return Open(false);
+		}
+
+		bool end_object()
+		{
+			Frames.pop_back();
+			return Attach();
+		}
+
+		bool start_array(std::size_t)
+		{
+			return Open(true);
+		}
+
+		bool end_array()
+		{
+			Frames.pop_back();
+			return Attach();
+		}
+
+		bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& Ex)
+		{
+			Error = Ex.what();
+			return false;
+		}
+
+		std::string Error;
+
+	private:
+		struct Frame
+		{
+			bool Array;
+			int Next;
+		};
+
+		bool Open(const bool Array)
+		{
+			if (Frames.size() >= JsonMaxDepth)
+			{
+				Error = "json nesting too deep";
+				return false;
+			}
+
+			json_checkstack(RL, 3);
+			RL.CreateTable(0, 0);
+			Frames.push_back(Frame{ Array, 0 });
+			return true;
+		}
+
+		/* Moves the value on top into its container, the root stays on the stack */
+		bool Attach()
+		{
+			if (Frames.empty())
+				return true;
+
+			auto& Parent = Frames.back();
+			if (Parent.Array)
+				RL.RawSetI(-2, ++Parent.Next);
+			else
+				RL.SetTable(-3);
+
+			return true;
+		}
+
+		RbxLua RL;
+		std::vector<Frame> Frames;
+	};
+
+	int RbxApi::jsondecode(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		size_t Size;
+		const auto Data = RL.CheckLString(1, &Size);
+
+		JsonDecoder Decoder(RL);
+		if (!json::sax_parse(nlohmann::detail::input_adapter(Data, Size), &Decoder))
+		{
+			RL.SetTop(1);
+			return RL.LError("%s", Decoder.Error.c_str());
+		}
+
+		return 1;
+	}
+
+	/* syn.compress(data, level), a string or buffer into a deflate frame */
+	int RbxApi::compressstring(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		size_t DataSize;
+		const auto Data = check_bytes(RL, 1, &DataSize);
+
+		if (DataSize > Compression::MaxSize)
+			return RL.ArgError(1, "data too large to compress");
+
+		const auto Compressed = Compression::Compress(Data, DataSize, check_compression_level(RL, 2));
+
+		RL.PushLString(Compressed.c_str(), Compressed.size());
+
+		return 1;
+	}
+
+	int RbxApi::decompressstring(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		size_t DataSize;
+		const auto Data = check_bytes(RL, 1, &DataSize);
+
+		std::string Inflated;
+		if (!Compression::Decompress(Data, DataSize, Inflated))
+			return RL.LError("data is not compressed or is corrupt");
+
+		RL.PushLString(Inflated.c_str(), Inflated.size());
+
+		return 1;
+	}
+
+	/* syn.pack tags, 0x80 and up carry a small non-negative integer in the low bits */
+	enum PackTag : unsigned char
+	{
+		P_NIL,
+		P_FALSE,
+		P_TRUE,
+		P_INT8,
+		P_INT16,
+		P_INT32,
+		P_FLOAT,
+		P_DOUBLE,
+		P_STRING,
+		P_STRREF,
+		P_TABLE,
+		P_SMALLINT = 0x80
+	};
+
+	constexpr char PackMagic[4] = { 'S', 'Y', 'N', 'P' };
+
+	struct PackState
+	{
+		Buffer Out;
+
+		/* Lua strings are interned, and everything encoded stays reachable until we are done, so the data pointer is the identity */
+		std::unordered_map<const char*, std::uint32_t> Strings;
+	};
+
+	static void pack_varint(Buffer& Out, std::uint32_t N)
+	{
+		unsigned char Bytes[5];
+		size_t Len = 0;
+		while (N >= 0x80)
+		{
+			Bytes[Len++] = (unsigned char) (N | 0x80);
+			N >>= 7;
+		}
+		Bytes[Len++] = (unsigned char) N;
+
+		Out.writeRaw(Bytes, Len);
+	}
+
+	static void pack_number(Buffer& Out, const double N)
+	{
+		const auto I = (std::int32_t) N;
+		if (N >= INT32_MIN && N <= INT32_MAX && (double) I == N && !(N == 0 && std::signbit(N)))
+		{
+			if (I >= 0 && I < 0x80)
+				Out.writeUInt8((unsigned char) (P_SMALLINT | I));
+			else if (I >= INT8_MIN && I <= INT8_MAX)
+			{
+				Out.writeUInt8(P_INT8);
+				Out.writeInt8((char) I);
+			}
+			else if (I >= INT16_MIN && I <= INT16_MAX)
+			{
+				Out.writeUInt8(P_INT16);
+				Out.writeInt16_LE((short) I);
+			}
+			else
+			{
+				Out.writeUInt8(P_INT32);
+				Out.writeInt32_LE(I);
+			}
+			return;
+		}
+
+		/* Coordinates and the like usually came from floats in the first place */
+		const auto F = (float) N;
+		if ((double) F == N)
+		{
+			Out.writeUInt8(P_FLOAT);
+			Out.writeFloat_LE(F);
+			return;
+		}
+
+		Out.writeUInt8(P_DOUBLE);
+		Out.writeDouble_LE(N);
+	}
+
+	static void pack_string(PackState& State, const char* Str, const size_t Len)
+	{
+		const auto Found = State.Strings.find(Str);
+		if (Found != State.Strings.end())
+		{
+			State.Out.writeUInt8(P_STRREF);
+			pack_varint(State.Out, Found->second);
+			return;
+		}
+
+		State.Strings.emplace(Str, (std::uint32_t) State.Strings.size());
+
+		State.Out.writeUInt8(P_STRING);
+		pack_varint(State.Out, (std::uint32_t) Len);
+		State.Out.writeRaw(Str, Len);
+	}
+
+	static void pack_value(const RbxLua RL, PackState& State, const int Index, const int Depth)
+	{
+		switch (RL.Type(Index))
+		{
+			case R_LUA_TNIL:
+				State.Out.writeUInt8(P_NIL);
+				return;
+			case R_LUA_TBOOLEAN:
+				State.Out.writeUInt8(RL.ToBoolean(Index) ? P_TRUE : P_FALSE);
+				return;
+			case R_LUA_TNUMBER:
+				pack_number(State.Out, RL.ToNumber(Index));
+				return;
+			case R_LUA_TSTRING:
+			{
+				size_t Len;
+				const auto Str = RL.ToLString(Index, &Len);
+				pack_string(State, Str, Len);
+				return;
+			}
+			case R_LUA_TTABLE:
+				break;
+			default:
+				RL.LError("cannot pack a %s", RL.TypeName(RL.Type(Index)));
+				return;
+		}
+
+		if (Depth >= JsonMaxDepth)
+			RL.LError("table nesting too deep (cyclic table?)");
+
+		json_checkstack(RL, 3);
+
+		/* 1..#t goes out positionally, holes included, everything else as key/value pairs */
+		const auto Length = RL.ObjLen(Index);
+		std::uint32_t HashCount = 0;
+		RL.PushNil();
+		while (RL.Next(Index))
+		{
+			RL.Pop(1);
+
+			if (RL.Type(-1) == R_LUA_TNUMBER)
+			{
+				const auto Key = RL.ToNumber(-1);
+				if (Key >= 1 && Key <= Length && Key == (int) Key)
+					continue;
+			}
+
+			HashCount++;
+		}
+
+		State.Out.writeUInt8(P_TABLE);
+		pack_varint(State.Out, (std::uint32_t) Length);
+		pack_varint(State.Out, HashCount);
+
+		for (auto i = 1; i <= Length; i++)
+		{
+			RL.RawGetI(Index, i);
+			pack_value(RL, State, RL.GetTop(), Depth + 1);
+			RL.Pop(1);
+		}
+
+		RL.PushNil();
+		while (RL.Next(Index))
+		{
+			if (RL.Type(-2) == R_LUA_TNUMBER)
+			{
+				const auto Key = RL.ToNumber(-2);
+				if (Key >= 1 && Key <= Length && Key == (int) Key)
+				{
+					RL.Pop(1);
+					continue;
+				}
+			}
+
+			pack_value(RL, State, RL.GetTop() - 1, Depth + 1);
+			pack_value(RL, State, RL.GetTop(), Depth + 1);
+			RL.Pop(1);
+		}
+	}
+
+	int RbxApi::packtable(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		RL.CheckAny(1);
+		RL.SetTop(1);
+
+		/* Same as json.encode, the buffer keeps its capacity between calls */
+		static thread_local PackState State;
+		State.Out.clear();
+		State.Strings.clear();
+
+		State.Out.writeRaw(PackMagic, sizeof(PackMagic));
+		pack_value(RL, State, 1, 0);
+
+		RL.PushLString((const char*) State.Out.data(), State.Out.size());
+
+		return 1;
+	}
+
+	/* Bounds checked cursor over the packed bytes, strings point straight into them */
+	class PackReader
+	{
+	public:
+		PackReader(const RbxLua _RL, const char* _Data, const size_t _Size) : RL(_RL), Data(_Data), Size(_Size) {}
+
+		void Value(const int Depth)
+		{
+			const auto Tag = Byte();
+			if (Tag & P_SMALLINT)
+			{
+				RL.PushNumber(Tag & ~P_SMALLINT);
+				return;
+			}
+
+			switch (Tag)
+			{
+				case P_NIL:
+					RL.PushNil();
+					return;
+				case P_FALSE:
+				case P_TRUE:
+					RL.PushBoolean(Tag == P_TRUE);
+					return;
+				case P_INT8:
+					RL.PushNumber(Read<std::int8_t>());
+					return;
+				case P_INT16:
+					RL.PushNumber(Read<std::int16_t>());
+					return;
+				case P_INT32:
+					RL.PushNumber(Read<std::int32_t>());
+					return;
+				case P_FLOAT:
+					RL.PushNumber(Read<float>());
+					return;
+				case P_DOUBLE:
+					RL.PushNumber(Read<double>());
+					return;
+				case P_STRING:
+				{
+					const auto Len = Varint();
+					Need(Len);
+					Strings.emplace_back(Data + Offset, Len);
+					Offset += Len;
+
+					RL.PushLString(Strings.back().first, Len);
+					return;
+				}
+				case P_STRREF:
+				{
+					const auto Ref = Varint();
+					if (Ref >= Strings.size())
+						Corrupt();
+
+					RL.PushLString(Strings[Ref].first, Strings[Ref].second);
+					return;
+				}
+				case P_TABLE:
+					break;
+				default:
+					Corrupt();
+					return;
+			}
+
+			if (Depth >= JsonMaxDepth)
+				RL.LError("packed nesting too deep");
+
+			const auto Length = Varint();
+			const auto HashCount = Varint();
+
+			/* Every entry takes at least a byte, anything claiming more can't be real and would presize a huge table */
+			if (Length > Size - Offset || HashCount > (Size - Offset) / 2)
+				Corrupt();
+
+			json_checkstack(RL, 3);
+			RL.CreateTable((int) Length, (int) HashCount);
+
+			for (std::uint32_t i = 1; i <= Length; i++)
+			{
+				Value(Depth + 1);
+				if (RL.Type(-1) == R_LUA_TNIL)
+					RL.Pop(1);
+				else
+					RL.RawSetI(-2, (int) i);
+			}
+
+			for (std::uint32_t i = 0; i < HashCount; i++)
+			{
+				Value(Depth + 1);
+				if (RL.Type(-1) == R_LUA_TNIL || (RL.Type(-1) == R_LUA_TNUMBER && RL.ToNumber(-1) != RL.ToNumber(-1)))
+					Corrupt();
+
+				Value(Depth + 1);
+				RL.SetTable(-3);
+			}
+		}
+
+		bool Done() const { return Offset == Size; }
+
+		int Corrupt() const
+		{
+			return RL.LError("packed data is corrupt");
+		}
+
+	private:
+		void Need(const size_t N) const
+		{
+			if (N > Size - Offset)
+				Corrupt();
+		}
+
+		unsigned char Byte()
+		{
+			Need(1);
+			return (unsigned char) Data[Offset++];
+		}
+
+		template <typename T>
+		T Read()
+		{
+			Need(sizeof(T));
+
+			T Val;
+			memcpy(&Val, Data + Offset, sizeof(T));
+			Offset += sizeof(T);
+			return Val;
+		}
+
+		std::uint32_t Varint()
+		{
+			std::uint32_t N = 0;
+			for (auto Shift = 0; Shift < 35; Shift += 7)
+			{
+				const auto B = Byte();
+				N |= (std::uint32_t) (B & 0x7F) << Shift;
+				if (!(B & 0x80))
+					return N;
+			}
+
+			return Corrupt();
 		}
+
+		RbxLua RL;
+		const char* Data;
+		size_t Size;
+		size_t Offset = 0;
+		std::vector<std::pair<const char*, size_t>> Strings;
+	};
+
+	int RbxApi::unpacktable(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		size_t Size;
+		const auto Data = check_bytes(RL, 1, &Size);
+
+		if (Size < sizeof(PackMagic) || memcmp(Data, PackMagic, sizeof(PackMagic)) != 0)
+			return RL.ArgError(1, "data was not made by syn.pack");
+
+		PackReader Reader(RL, Data + sizeof(PackMagic), Size - sizeof(PackMagic));
+		Reader.Value(0);
+
+		if (!Reader.Done())
+			return Reader.Corrupt();
+
+		return 1;
 	}
 
-	__forceinline std::string XProtectDecryptNew(syn::RbxLua RL, std::string Data)
+	/* syn.string.split(s, sep = ","), an empty separator splits into characters. Pieces are pushed straight from the
+	   argument's TString, no patterns, and the result is sized up front from a first pass over the separators */
+	int RbxApi::stringsplit(DWORD rL)
 	{
-		std::string OutputReal;
+		syn::RbxLua RL(rL);
 
-		for (auto& I : Data)
+		size_t Size, SepSize;
+		const auto Str = RL.CheckLString(1, &Size);
+		const auto SepStr = RL.OptLString(2, ",", &SepSize);
+
+		const std::string_view View(Str, Size), Sep(SepStr, SepSize);
+
+		if (Sep.empty())
 		{
-			I = XProtectRepChar(I);
+			RL.CreateTable((int) Size, 0);
+			for (size_t i = 0; i < Size; i++)
+			{
+				RL.PushLString(Str + i, 1);
+				RL.RawSetI(-2, (int) i + 1);
+			}
+
+			return 1;
 		}
 
-		const auto OutputAes = DecryptWithAlgo<CryptoPP::CFB_Mode<CryptoPP::AES>::Decryption>(RL, Data, OBFUSCATE_STR_TEA("gN1gFQXXoOB3DMy3DzJyECZ8LDAIPc3D"), OBFUSCATE_STR_TEA("ACUCcF3GDFffLC4f"));
-		return DecryptWithAlgo<CryptoPP::CFB_Mode<CryptoPP::Blowfish>::Decryption>(RL, OutputAes, OBFUSCATE_STR_TEA("QXXogN1gFOB3DMy3xDAIPX4nzJynCZ8L"), OBFUSCATE_STR_TEA("3dCUGc2G"));
+		auto Count = 1;
+		for (auto At = View.find(Sep); At != std::string_view::npos; At = View.find(Sep, At + Sep.size()))
+			Count++;
+
+		RL.CreateTable(Count, 0);
+
+		size_t Begin = 0;
+		for (auto N = 1; N <= Count; N++)
+		{
+			const auto At = View.find(Sep, Begin);
+			const auto End = At == std::string_view::npos ? Size : At;
+
+			RL.PushLString(Str + Begin, End - Begin);
+			RL.RawSetI(-2, N);
+
+			Begin = End + Sep.size();
+		}
+
+		return 1;
 	}
 
-	int RbxApi::xprotect(DWORD rL)
+	/* syn.string.trim(s, chars = whitespace), strips any of chars from both ends */
+	int RbxApi::stringtrim(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		size_t Size, CharsSize;
+		const auto Str = RL.CheckLString(1, &Size);
+		const auto CharsStr = RL.OptLString(2, " \t\r\n\v\f", &CharsSize);
+
+		const std::string_view View(Str, Size), Chars(CharsStr, CharsSize);
+
+		const auto Begin = View.find_first_not_of(Chars);
+		if (Begin == std::string_view::npos)
+		{
+			RL.PushLString("", 0);
+			return 1;
+		}
+
+		const auto End = View.find_last_not_of(Chars) + 1;
+
+		/* Nothing to strip, hand back the same string instead of interning a copy */
+		if (Begin == 0 && End == Size)
+			RL.PushValue(1);
+		else
+			RL.PushLString(Str + Begin, End - Begin);
+
+		return 1;
+	}
+
+	int RbxApi::stringstartswith(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		size_t Size, PrefixSize;
+		const auto Str = RL.CheckLString(1, &Size);
+		const auto Prefix = RL.CheckLString(2, &PrefixSize);
+
+		RL.PushBoolean(PrefixSize <= Size && memcmp(Str, Prefix, PrefixSize) == 0);
+		return 1;
+	}
+
+	int RbxApi::stringendswith(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		size_t Size, SuffixSize;
+		const auto Str = RL.CheckLString(1, &Size);
+		const auto Suffix = RL.CheckLString(2, &SuffixSize);
+
+		RL.PushBoolean(SuffixSize <= Size && memcmp(Str + Size - SuffixSize, Suffix, SuffixSize) == 0);
+		return 1;
+	}
+
+	/* syn.string.join(t, sep = "", i = 1, j = #t), table.concat into a single buffer that is reused between calls */
+	int RbxApi::stringjoin(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		RL.CheckType(1, R_LUA_TTABLE);
+
+		size_t SepSize;
+		const auto Sep = RL.OptLString(2, "", &SepSize);
+		const auto First = RL.OptInt(3, 1);
+		const auto Last = RL.IsNoneOrNil(4) ? RL.ObjLen(1) : RL.CheckInt(4);
+
+		static thread_local std::string Buffer;
+		Buffer.clear();
+
+		for (auto i = First; i <= Last; i++)
+		{
+			RL.RawGetI(1, i);
+
+			const auto Type = RL.Type(-1);
+			if (Type != R_LUA_TSTRING && Type != R_LUA_TNUMBER)
+				return RL.LError("invalid value (at index %d) in table for 'join'", i);
+
+			size_t Size;
+			const auto Str = RL.ToLString(-1, &Size);
+
+			if (i != First)
+				Buffer.append(Sep, SepSize);
+			Buffer.append(Str, Size);
+
+			RL.Pop(1);
+		}
+
+		RL.PushLString(Buffer.data(), Buffer.size());
+		return 1;
+	}
+
+	/* syn.table.clone(t), shallow copy including the metatable, sized from the source's array and hash counts */
+	int RbxApi::tableclone(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		RL.CheckType(1, R_LUA_TTABLE);
+		RL.SetTop(1);
+
+		const auto Length = RL.ObjLen(1);
+
+		auto Count = 0;
+		RL.PushNil();
+		while (RL.Next(1))
+		{
+			RL.Pop(1);
+			Count++;
+		}
+
+		RL.CreateTable(Length, (std::max)(Count - Length, 0));
+
+		RL.PushNil();
+		while (RL.Next(1))
+		{
+			RL.PushValue(-2);
+			RL.PushValue(-2);
+			RL.SetTable(2);
+			RL.Pop(1);
+		}
+
+		if (RL.GetMetaTable(1))
+			RL.SetMetaTable(2);
+
+		return 1;
+	}
+
+	/* syn.table.clear(t), empties t in place and keeps its allocation for refilling */
+	int RbxApi::tableclear(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		RL.CheckType(1, R_LUA_TTABLE);
+		RL.SetTop(1);
+
+		/* Assigning nil to a key that exists is allowed mid-traversal and never reaches __newindex */
+		RL.PushNil();
+		while (RL.Next(1))
+		{
+			RL.Pop(1);
+			RL.PushValue(-1);
+			RL.PushNil();
+			RL.SetTable(1);
+		}
+
+		return 0;
+	}
+
+	static bool RawEquals(const TValue* A, const TValue* B)
+	{
+		if (A->tt != B->tt)
+			return false;
+
+		switch (A->tt)
+		{
+		case R_LUA_TNIL:
+			return true;
+		case R_LUA_TNUMBER:
+			return syn::RbxLua::XorDouble(A->value.n) == syn::RbxLua::XorDouble(B->value.n);
+		case R_LUA_TBOOLEAN:
+			return A->value.b == B->value.b;
+		default:
+			return A->value.p == B->value.p;
+		}
+	}
+
+	/* syn.table.find(t, value, init = 1), raw equality over the array part like Luau's table.find */
+	int RbxApi::tablefind(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		RL.CheckType(1, R_LUA_TTABLE);
+		RL.CheckAny(2);
+
+		const auto Length = RL.ObjLen(1);
+		for (auto i = (std::max)(RL.OptInt(3, 1), 1); i <= Length; i++)
+		{
+			RL.RawGetI(1, i);
+
+			/* Re-fetched every round, the push may have reallocated the stack */
+			const auto Found = RawEquals(RL.Index2Adr(-1), RL.Index2Adr(2));
+			RL.Pop(1);
+
+			if (Found)
+			{
+				RL.PushNumber(i);
+				return 1;
+			}
+		}
+
+		RL.PushNil();
+		return 1;
+	}
+
+	int RbxApi::securelua_gethwid(DWORD rL)
+	{
+		VM_TIGER_LONDON_START
+
+		const syn::RbxLua RL(rL);
+		RL.PushString(syn::HWID.c_str());
+
+		VM_TIGER_LONDON_END
+
+		return 1;
+	}
+
+	int RbxApi::securelua_randomstring(DWORD rL)
+	{
+		VM_TIGER_LONDON_START
+
+		const syn::RbxLua RL(rL);
+		RL.PushString(RandomString(RL.CheckInteger(1)).c_str());
+
+		VM_TIGER_LONDON_END
+
+		return 1;
+	}
+
+	int RbxApi::securelua_httpget(DWORD rL)
+	{
+		VM_TIGER_LONDON_START
+
+		const syn::RbxLua RL(rL);
+		const RbxYield RYield(RL);
+
+		size_t CSize;
+		const auto CStr = RL.CheckLString(1, &CSize);
+		const auto Url = std::string(CStr, CSize);
+
+		if (Url.find(OBFUSCATE_STR("http")))
+			return RL.ArgError(1, OBFUSCATE_STR("Invalid protocol specified (expected 'http://' or 'https://')"));
+
+		if (syn::AntiProxy::Check())
+			CrashRoblox();
+		
+		VM_TIGER_LONDON_END
+
+		return RYield.Execute([Url]()
+		{
+			const auto Result = cpr::Get(cpr::Url{ Url },
+				cpr::Header{ { OBFUSCATE_STR("User-Agent"), std::string(OBFUSCATE_STR("synx/")) + OBFUSCATE_STR(SYNAPSE_VERSION) } });
+
+			if (HttpStatus::isError(Result.status_code))
+			{
+				const auto Err = OBFUSCATE_STR("Http Error ") + std::to_string(Result.status_code) + " - " + HttpStatus::reasonPhrase(
+					Result.status_code);
+
+				throw std::exception(Err.c_str());
+			}
+
+			return [Result](RbxLua NRL) 
+			{
+				NRL.PushLString(Result.text.c_str(), Result.text.size());
+				return 1;
+			};
+		});
+	}
+
+	int RbxApi::createrenderobject(DWORD rL)
 	{
 		syn::RbxLua RL(rL);
 
-        VM_TIGER_LONDON_START;
-		
-		const std::string Data = RL.CheckString(1);
+		const std::string Type = RL.CheckString(1);
+
+		/* syn::D3D::Initialize checks if its already init'd, we don't need to add a check here */
+		syn::D3D::Initialize();
+
+		auto D3D = syn::D3D::GetSingleton();
+
+		D3DTypes D3Type;
+		if (Type == "Line")
+			D3Type = D3_LINE;
+		else if (Type == "Text")
+			D3Type = D3_TEXT;
+		else if (Type == "Square")
+			D3Type = D3_SQUARE;
+		else if (Type == "Circle")
+			D3Type = D3_CIRCLE;
+		else if (Type == "Image")
+			D3Type = D3_IMAGE;
+		else if (Type == "Polyline")
+			D3Type = D3_POLYLINE;
+		else if (Type == "Triangle" || Type == "Quad")
+			D3Type = D3_POLYGON;
+		else
+			return RL.LError("type does not exist");
+
+		const auto Sides = Type == "Triangle" ? 3 : 4;
 
-		auto Output = XProtectDecryptNew(RL, Data);
-		if (Output.find(OBFUSCATE_STR("2340@4$CdfHFSK(#)")) == std::string::npos)
+		/* A key opts the object into surviving teleports, see D3D::CreateKeptRenderObject */
+		D3DHandle Handle;
+		if (RL.IsNoneOrNil(2))
+			Handle = D3D->CreateRenderObject(D3Type, Sides);
+		else
 		{
-			//Decrypt with old XProtect
-			Output = DecryptWithAlgo<CryptoPP::CFB_Mode<CryptoPP::Blowfish>::Decryption>(RL, Data, OBFUSCATE_STR_TEA("CtyqqJ9Ci4vDstSe43Dfs6DlldOhFcvu"), OBFUSCATE_STR_TEA("2R0G7s7k"));
+			size_t KeySize;
+			const auto Key = RL.CheckLString(2, &KeySize);
+			Handle = D3D->CreateKeptRenderObject(std::string(Key, KeySize), D3Type, Sides);
 		}
 
-		ReplaceAll(Output, OBFUSCATE_STR("if (isreadonly(game) == false) then return end"), "");
+		if (!Handle)
+			return RL.LError("too many render objects");
 
-		auto Schedule = syn::Scheduler::GetSingleton();
-		Schedule->Push(Output);
+		RL.PushLightUserData((void*) Handle);
 
-        VM_TIGER_LONDON_END;
-		
-		return 0;
+		return 1;
 	}
 
-	template<typename T>
-	__forceinline std::string HashWithAlgo(const std::string& Input)
-	{
-		T Hash;
-		std::string Digest;
-
-		CryptoPP::StringSource SS(Input, true,
-			new CryptoPP::HashFilter(Hash,
-				new CryptoPP::HexEncoder(
-					new CryptoPP::StringSink(Digest), false
-				)));
+	const std::unordered_map<std::string, D3DProperty>& RbxApi::render_property_ids()
+	{
+		static const std::unordered_map<std::string, D3DProperty> Ids =
+		{
+			{ "Visible", DP_VISIBLE },
+			{ "From", DP_FROM },
+			{ "To", DP_TO },
+			{ "Color", DP_COLOR },
+			{ "Thickness", DP_THICKNESS },
+			{ "Transparency", DP_TRANSPARENCY },
+			{ "Text", DP_TEXT },
+			{ "Position", DP_POSITION },
+			{ "Size", DP_SIZE },
+			{ "Font", DP_FONT },
+			{ "Center", DP_CENTER },
+			{ "Outline", DP_OUTLINE },
+			{ "OutlineColor", DP_OUTLINECOLOR },
+			{ "TextBounds", DP_TEXTBOUNDS },
+			{ "Filled", DP_FILLED },
+			{ "Radius", DP_RADIUS },
+			{ "NumSides", DP_NUMSIDES },
+			{ "Data", DP_DATA },
+			{ "Rounding", DP_ROUNDING },
+			{ "ImageSize", DP_IMAGESIZE },
+			{ "Points", DP_POINTS },
+			{ "PointA", DP_POINTA },
+			{ "PointB", DP_POINTB },
+			{ "PointC", DP_POINTC },
+			{ "PointD", DP_POINTD },
+			{ "Closed", DP_CLOSED },
+			{ "ZIndex", DP_ZINDEX },
+		};
 
-		return Digest;
+		return Ids;
 	}
 
-	int RbxApi::hashstring(DWORD rL)
-	{
-		syn::RbxLua RL(rL);
+	/* Field names read and written for every render property */
+	static const RbxKey KeyX("X"), KeyY("Y"), KeyR("r"), KeyG("g"), KeyB("b");
+	static const RbxKey KeyVector2("Vector2"), KeyColor3("Color3"), KeyNew("new"), KeyFromRGB("fromRGB");
 
-        VM_TIGER_WHITE_START;
+	/* A buffer of float32 x, y pairs, a flat { x, y, x, y, ... } array or an array of Vector2s */
+	static void read_render_points(const RbxLua RL, const int Index, std::vector<ImVec2>& Out)
+	{
+		Out.clear();
 
-		size_t DataSize;
-		const auto DataCStr = RL.CheckLString(1, &DataSize);
+		if (const auto BB = RbxApi::to_binary_buffer(RL, Index))
+		{
+			if (BB->Length % (2 * sizeof(float)))
+				RL.LError("points buffer must hold float32 x, y pairs");
 
-		auto Hash = HashWithAlgo<CryptoPP::SHA384>(std::string(DataCStr, DataSize));
+			const auto Count = BB->Length / (2 * sizeof(float));
+			if (Count > D3DPolyline::MaxPoints)
+				RL.LError("too many points (%d max)", (int) D3DPolyline::MaxPoints);
 
-		RL.PushLString(Hash.c_str(), Hash.size());
+			Out.resize(Count);
+			memcpy(Out.data(), BB->Data(), Count * sizeof(ImVec2));
+			return;
+		}
 
-        VM_TIGER_WHITE_END;
+		if (!RL.IsTable(Index))
+			RL.LError("points must be a table or buffer");
 
-		return 1;
-	}
+		const auto Length = RL.ObjLen(Index);
+		if (!Length)
+			return;
 
-	int RbxApi::hashstringcustom(DWORD rL)
-    {
-		syn::RbxLua RL(rL);
+		RL.RawGetI(Index, 1);
+		const auto Flat = RL.Type(-1) == R_LUA_TNUMBER;
+		RL.Pop(1);
 
-        VM_TIGER_WHITE_START;
-    	
-    	std::string Algo = RL.CheckString(1);
+		if (Flat && Length % 2)
+			RL.LError("flat points array must hold x, y pairs");
 
-    	size_t DataSize;
-		const auto DataCStr = RL.CheckLString(2, &DataSize);
-		const std::string Data(DataCStr, DataSize);
+		const auto Count = (size_t) (Flat ? Length / 2 : Length);
+		if (Count > D3DPolyline::MaxPoints)
+			RL.LError("too many points (%d max)", (int) D3DPolyline::MaxPoints);
 
-		enum HashModes
+		Out.resize(Count);
+		for (size_t i = 0; i < Count; i++)
 		{
-			//MD5
-			MD5,
-
-			//SHA1
-			SHA1,
+			if (Flat)
+			{
+				RL.RawGetI(Index, (int) i * 2 + 1);
+				RL.RawGetI(Index, (int) i * 2 + 2);
+				Out[i] = ImVec2((float) RL.ToNumber(-2), (float) RL.ToNumber(-1));
+				RL.Pop(2);
+				continue;
+			}
 
-			//SHA2
-			SHA224,
-			SHA256,
-			SHA384,
-			SHA512,
+			RL.RawGetI(Index, (int) i + 1);
+			RL.GetFieldK(-1, KeyX);
+			RL.GetFieldK(-2, KeyY);
+			Out[i] = ImVec2((float) RL.ToNumber(-2), (float) RL.ToNumber(-1));
+			RL.Pop(3);
+		}
+	}
 
-			//SHA3
-			SHA3_256,
-			SHA3_384,
-			SHA3_512,
-		};
+	/* Index must be absolute, the vector/color readers push above it */
+	int RbxApi::set_render_property(RbxLua RL, const D3DHandle Handle, const D3DProperty Property, const int Index)
+	{
+		auto D3D = syn::D3D::GetSingleton();
 
-		std::map<std::string, HashModes> HashTranslationMap =
+		const auto GetVec2 = [&]
 		{
-			//MD5
-			{ "md5", MD5 },
+			RL.GetFieldK(Index, KeyX);
+			const float X = (float)RL.ToNumber(-1);
+			RL.Pop(1);
+			RL.GetFieldK(Index, KeyY);
+			const float Y = (float)RL.ToNumber(-1);
+			RL.Pop(1);
 
-			//SHA1
-			{ "sha1", SHA1 },
+			return ImVec2(X, Y);
+		};
 
-			//SHA2
-			{ "sha224", SHA224 },
-			{ "sha256", SHA256 },
-			{ "sha384", SHA384 },
-			{ "sha512", SHA512 },
+		const auto GetColor = [&](ImU32 Old)
+		{
+			RL.GetFieldK(Index, KeyR);
+			const float R = (float)RL.ToNumber(-1) * 255;
+			RL.Pop(1);
+			RL.GetFieldK(Index, KeyG);
+			const float G = (float)RL.ToNumber(-1) * 255;
+			RL.Pop(1);
+			RL.GetFieldK(Index, KeyB);
+			const float B = (float)RL.ToNumber(-1) * 255;
+			RL.Pop(1);
 
-			//SHA3
-			{ "sha3-256", SHA3_256 },
-			{ "sha3_256", SHA3_256 },
-			{ "sha3-384", SHA3_384 },
-			{ "sha3_384", SHA3_384 },
-			{ "sha3-512", SHA3_512 },
-			{ "sha3_512", SHA3_512 },
+			return ImGui::GetColorU32(ImVec4(R / 255, G / 255, B / 255, ImGui::ColorConvertU32ToFloat4(Old).w));
 		};
 
-		std::transform(Algo.begin(), Algo.end(), Algo.begin(), tolower);
+		const auto SetAlpha = [&](ImU32& Color)
+		{
+			auto Col = ImGui::ColorConvertU32ToFloat4(Color);
+			Col.w = (float)RL.ToNumber(Index);
+			Color = ImGui::GetColorU32(Col);
+		};
 
-		if (!HashTranslationMap.count(Algo))
-			return RL.ArgError(1, "non-existant hash algorithm");
+		if (Property == DP_VISIBLE)
+		{
+			const auto Visible = D3D->GetRenderVisible(Handle);
+			if (!Visible)
+				return RL.LError("can't find object");
 
-		const auto RAlgo = HashTranslationMap[Algo];
+			*Visible = RL.ToBoolean(Index);
 
-		std::string Hash;
-		
-		//This is intentional - blame Themida not supporting jump tables.
-		if (RAlgo == MD5)
-		{
-			Hash = HashWithAlgo<CryptoPP::Weak::MD5>(Data);
-		}
-		else if (RAlgo == SHA1)
-		{
-			Hash = HashWithAlgo<CryptoPP::SHA1>(Data);
-		}
-		else if (RAlgo == SHA224)
-		{
-			Hash = HashWithAlgo<CryptoPP::SHA224>(Data);
-		}
-		else if (RAlgo == SHA256)
-		{
-			Hash = HashWithAlgo<CryptoPP::SHA256>(Data);
-		}
-		else if (RAlgo == SHA384)
-		{
-			Hash = HashWithAlgo<CryptoPP::SHA384>(Data);
-		}
-		else if (RAlgo == SHA512)
-		{
-			Hash = HashWithAlgo<CryptoPP::SHA512>(Data);
-		}
-		else if (RAlgo == SHA3_256)
-		{
-			Hash = HashWithAlgo<CryptoPP::SHA3_256>(Data);
-		}
-		else if (RAlgo == SHA3_384)
-		{
-			Hash = HashWithAlgo<CryptoPP::SHA3_384>(Data);
+			return 0;
 		}
-		else if (RAlgo == SHA3_512)
+
+		if (Property == DP_ZINDEX)
 		{
-			Hash = HashWithAlgo<CryptoPP::SHA3_512>(Data);
+			if (!D3D->SetRenderZIndex(Handle, (int) RL.ToNumber(Index)))
+				return RL.LError("can't find object");
+
+			return 0;
 		}
-		else
+
+		switch (GetD3DHandleType(Handle))
 		{
-			return RL.ArgError(1, "non-existant hash algorithm");
-		}
+			case D3_LINE:
+			{
+				const auto Line = D3D->GetRenderObject<D3DLine>(Handle);
+				if (!Line)
+					break;
 
-		RL.PushLString(Hash.c_str(), Hash.size());
+				switch (Property)
+				{
+					case DP_FROM: Line->From = GetVec2(); return 0;
+					case DP_TO: Line->To = GetVec2(); return 0;
+					case DP_COLOR: Line->Color = GetColor(Line->Color); return 0;
+					case DP_THICKNESS: Line->Thickness = (float)RL.ToNumber(Index); return 0;
+					case DP_TRANSPARENCY: SetAlpha(Line->Color); return 0;
+				}
 
-        VM_TIGER_WHITE_END;
+				return RL.LError("invalid property for line");
+			}
 
-		return 1;
-    }
+			case D3_TEXT:
+			{
+				const auto Text = D3D->GetRenderObject<D3DText>(Handle);
+				if (!Text)
+					break;
 
-	int RbxApi::randomstring(DWORD rL)
-    {
-		syn::RbxLua RL(rL);
+				switch (Property)
+				{
+					case DP_TEXT:
+					{
+						size_t TextSize;
+						const auto TextCStr = RL.ToLString(Index, &TextSize);
 
-        VM_TIGER_WHITE_START;
-    	
-		const auto Size = RL.CheckInt(1);
+						Text->Text.assign(TextCStr, TextSize);
+						return 0;
+					}
+					case DP_POSITION: Text->Pos = GetVec2(); return 0;
+					case DP_SIZE: Text->Size = (float)RL.ToNumber(Index); return 0;
+					case DP_FONT: Text->Font = RL.ToInteger(Index); return 0;
+					case DP_COLOR: Text->Color = GetColor(Text->Color); return 0;
+					case DP_CENTER: Text->Center = RL.ToBoolean(Index); return 0;
+					case DP_OUTLINE: Text->Outline = RL.ToBoolean(Index); return 0;
+					case DP_OUTLINECOLOR: Text->OutlineColor = GetColor(Text->OutlineColor); return 0;
+					case DP_TRANSPARENCY:
+						SetAlpha(Text->Color);
+						SetAlpha(Text->OutlineColor);
+						return 0;
+					case DP_TEXTBOUNDS:
+						return RL.LError("TextBounds is a read only property for text");
+				}
 
-		if (Size > 1024)
-			return RL.ArgError(1, "exceeded maximum size (1024)");
+                return RL.LError("invalid property for text");
+			}
 
-		if (Size < 0)
-			return RL.ArgError(1, "negative size specified");
+			case D3_SQUARE:
+			{
+				const auto Square = D3D->GetRenderObject<D3DSquare>(Handle);
+				if (!Square)
+					break;
 
-		CryptoPP::AutoSeededRandomPool Prng;
-		auto Alloc = (byte*) operator new(Size);
-		Prng.GenerateBlock(Alloc, Size);
+				switch (Property)
+				{
+					case DP_POSITION: Square->Pos = GetVec2(); return 0;
+					case DP_SIZE: Square->Size = GetVec2(); return 0;
+					case DP_COLOR: Square->Color = GetColor(Square->Color); return 0;
+					case DP_THICKNESS: Square->Thickness = (float)RL.ToNumber(Index); return 0;
+					case DP_FILLED: Square->Filled = RL.ToBoolean(Index); return 0;
+					case DP_TRANSPARENCY: SetAlpha(Square->Color); return 0;
+				}
 
-		RL.PushLString((const char*) Alloc, Size);
+                return RL.LError("invalid property for square");
+			}
 
-		delete Alloc;
+			case D3_CIRCLE:
+			{
+				const auto Circle = D3D->GetRenderObject<D3DCircle>(Handle);
+				if (!Circle)
+					break;
 
-        VM_TIGER_WHITE_END;
-    	
-    	return 1;
-    }
+				switch (Property)
+				{
+					case DP_POSITION: Circle->Pos = GetVec2(); return 0;
+					case DP_RADIUS: Circle->Radius = (float)RL.ToNumber(Index); return 0;
+					case DP_COLOR: Circle->Color = GetColor(Circle->Color); return 0;
+					case DP_THICKNESS: Circle->Thickness = (float)RL.ToNumber(Index); return 0;
+					case DP_FILLED: Circle->Filled = RL.ToBoolean(Index); return 0;
+					case DP_TRANSPARENCY: SetAlpha(Circle->Color); return 0;
+					case DP_NUMSIDES: Circle->Sides = RL.ToInteger(Index); return 0;
+				}
 
-	int RbxApi::derivestring(DWORD rL)
-	{
-		syn::RbxLua RL(rL);
+                return RL.LError("invalid property for circle");
+			}
 
-        VM_TIGER_WHITE_START;
-    	
-    	size_t DataSize;
-		const auto DataCStr = RL.CheckLString(1, &DataSize);
-    	
-    	const auto Size = RL.CheckInt(2);
+			case D3_IMAGE:
+			{
+				const auto Image = D3D->GetRenderObject<D3DImage>(Handle);
+				if (!Image)
+					break;
 
-		if (Size > 1024)
-			return RL.ArgError(2, "exceeded maximum size (1024)");
+				switch (Property)
+				{
+					case DP_DATA:
+					{
+						/* Decoded on the pool, the image draws from the first frame after that finishes */
+						size_t DataSize;
+						const auto Data = check_bytes(RL, Index, &DataSize);
 
-		if (Size < 0)
-			return RL.ArgError(2, "negative size specified");
+						Image->Image = D3D->ImageCache.Acquire(Data, DataSize);
+						return 0;
+					}
+					case DP_POSITION: Image->Pos = GetVec2(); return 0;
+					case DP_SIZE: Image->Size = GetVec2(); return 0;
+					case DP_COLOR: Image->Color = GetColor(Image->Color); return 0;
+					case DP_ROUNDING: Image->Rounding = (float)RL.ToNumber(Index); return 0;
+					case DP_TRANSPARENCY: SetAlpha(Image->Color); return 0;
+					case DP_IMAGESIZE:
+						return RL.LError("ImageSize is a read only property for image");
+				}
 
-		auto Alloc = (byte*) operator new(Size);
-		CryptoPP::PKCS5_PBKDF2_HMAC<CryptoPP::SHA384> KDF;
-		KDF.DeriveKey(Alloc, Size, 0, (byte*) DataCStr, DataSize, NULL, 0, 10000);
+				return RL.LError("invalid property for image");
+			}
 
-		RL.PushLString((const char*) Alloc, Size);
+			case D3_POLYLINE:
+			{
+				const auto Polyline = D3D->GetRenderObject<D3DPolyline>(Handle);
+				if (!Polyline)
+					break;
 
-		delete Alloc;
+				switch (Property)
+				{
+					case DP_POINTS: read_render_points(RL, Index, Polyline->Points); return 0;
+					case DP_COLOR: Polyline->Color = GetColor(Polyline->Color); return 0;
+					case DP_THICKNESS: Polyline->Thickness = (float)RL.ToNumber(Index); return 0;
+					case DP_CLOSED: Polyline->Closed = RL.ToBoolean(Index); return 0;
+					case DP_FILLED: Polyline->Filled = RL.ToBoolean(Index); return 0;
+					case DP_TRANSPARENCY: SetAlpha(Polyline->Color); return 0;
+				}
 
-        VM_TIGER_WHITE_END;
-    	
-    	return 1;
+				return RL.LError("invalid property for polyline");
+			}
+
+			case D3_POLYGON:
+			{
+				const auto Polygon = D3D->GetRenderObject<D3DPolygon>(Handle);
+				if (!Polygon)
+					break;
+
+				switch (Property)
+				{
+					case DP_POINTS:
+					{
+						static thread_local std::vector<ImVec2> Points;
+						read_render_points(RL, Index, Points);
+						if (Points.size() != Polygon->Count)
+							return RL.LError("expected %d points", (int) Polygon->Count);
+
+						std::copy(Points.begin(), Points.end(), Polygon->Points);
+						return 0;
+					}
+					case DP_POINTA: Polygon->Points[0] = GetVec2(); return 0;
+					case DP_POINTB: Polygon->Points[1] = GetVec2(); return 0;
+					case DP_POINTC: Polygon->Points[2] = GetVec2(); return 0;
+					case DP_POINTD:
+						if (Polygon->Count < 4)
+							break;
+
+						Polygon->Points[3] = GetVec2();
+						return 0;
+					case DP_COLOR: Polygon->Color = GetColor(Polygon->Color); return 0;
+					case DP_THICKNESS: Polygon->Thickness = (float)RL.ToNumber(Index); return 0;
+					case DP_FILLED: Polygon->Filled = RL.ToBoolean(Index); return 0;
+					case DP_TRANSPARENCY: SetAlpha(Polygon->Color); return 0;
+				}
+
+				return RL.LError(Polygon->Count == 3 ? "invalid property for triangle" : "invalid property for quad");
+			}
+		}
+
+        return RL.LError("can't find object");
 	}
 
-	int RbxApi::base64encode(DWORD rL)
+	int RbxApi::setrenderproperty(DWORD rL)
 	{
 		syn::RbxLua RL(rL);
 
-		size_t DataSize;
-		const auto DataCStr = RL.CheckLString(1, &DataSize);
+        /* TODO: Check if its an actual render object */
+		if (!RL.IsUserData(1))
+			return RL.ArgError(1, "render object expected");
 
-		auto Encoded = Base64Encode((unsigned char*) DataCStr, DataSize);
+        const std::string Property = RL.CheckString(2);
+        RL.CheckAny(3);
 
-		RL.PushLString(Encoded.c_str(), Encoded.size());
+		const auto& Ids = render_property_ids();
+		const auto Id = Ids.find(Property);
 
-		return 1;
+		return set_render_property(RL, (D3DHandle) (uintptr_t) RL.ToUserData(1), Id != Ids.end() ? Id->second : DP_INVALID, 3);
 	}
 
-	int RbxApi::base64decode(DWORD rL)
+	/* setrenderpropertybulk({ object, property id, value, object, property id, value, ... })
+	   Flat so a frame's worth of updates is one table and one C call, objects may be handles or Drawing wrappers */
+	int RbxApi::setrenderpropertybulk(DWORD rL)
 	{
 		syn::RbxLua RL(rL);
 
-		size_t DataSize;
-		const auto DataCStr = RL.CheckLString(1, &DataSize);
+		RL.CheckType(1, R_LUA_TTABLE);
 
-		auto Decoded = Base64Decode(std::string(DataCStr, DataSize));
+		const auto Count = RL.ObjLen(1);
+		if (Count % 3)
+			return RL.ArgError(1, "expected (object, property id, value) triples");
 
-		RL.PushLString(Decoded.c_str(), Decoded.size());
+		for (int i = 1; i <= Count; i += 3)
+		{
+			RL.RawGetI(1, i);
+			if (RL.IsTable(-1))
+			{
+				/* __OBJECT is a raw field on the wrapper, so this never reaches its __index */
+				RL.GetField(-1, "__OBJECT");
+				RL.Remove(-2);
+			}
 
-		return 1;
-	}
+			if (!RL.IsUserData(-1))
+				return RL.LError("render object expected at index %d", i);
 
-	int RbxApi::securelua_gethwid(DWORD rL)
-	{
-		VM_TIGER_LONDON_START
+			const auto Handle = (D3DHandle) (uintptr_t) RL.ToUserData(-1);
 
-		const syn::RbxLua RL(rL);
-		RL.PushString(syn::HWID.c_str());
+			RL.RawGetI(1, i + 1);
+			const auto Property = (D3DProperty) RL.ToInteger(-1);
 
-		VM_TIGER_LONDON_END
+			RL.RawGetI(1, i + 2);
+			set_render_property(RL, Handle, Property >= 0 && Property < DP_INVALID ? Property : DP_INVALID, RL.GetTop());
 
-		return 1;
+			RL.Pop(3);
+		}
+
+		return 0;
 	}
 
-	int RbxApi::securelua_randomstring(DWORD rL)
+	int RbxApi::getrenderpropertyids(DWORD rL)
 	{
-		VM_TIGER_LONDON_START
+		syn::RbxLua RL(rL);
 
-		const syn::RbxLua RL(rL);
-		RL.PushString(RandomString(RL.CheckInteger(1)).c_str());
+		const auto& Ids = render_property_ids();
 
-		VM_TIGER_LONDON_END
+		RL.CreateTable(0, (int) Ids.size());
+		for (const auto& Id : Ids)
+		{
+			RL.PushNumber(Id.second);
+			RL.SetField(-2, Id.first.c_str());
+		}
 
 		return 1;
 	}
 
-	int RbxApi::securelua_httpget(DWORD rL)
+	int RbxApi::getrenderproperty(DWORD rL)
 	{
-		VM_TIGER_LONDON_START
-
-		const syn::RbxLua RL(rL);
-		const RbxYield RYield(RL);
-
-		size_t CSize;
-		const auto CStr = RL.CheckLString(1, &CSize);
-		const auto Url = std::string(CStr, CSize);
-
-		if (Url.find(OBFUSCATE_STR("http")))
-			return RL.ArgError(1, OBFUSCATE_STR("Invalid protocol specified (expected 'http://' or 'https://')"));
+		syn::RbxLua RL(rL);
 
-		if (syn::AntiProxy::Check())
-			CrashRoblox();
+        /* TODO: Check if its an actual render object */
+        if (!RL.IsUserData(1))
+            return RL.ArgError(1, "render object expected");
 		
-		VM_TIGER_LONDON_END
-
-		return RYield.Execute([Url]()
-		{
-			const auto Result = cpr::Get(cpr::Url{ Url },
-				cpr::Header{ { OBFUSCATE_STR("User-Agent"), std::string(OBFUSCATE_STR("synx/")) + OBFUSCATE_STR(SYNAPSE_VERSION) } });
-
-			if (HttpStatus::isError(Result.status_code))
-			{
-				const auto Err = OBFUSCATE_STR("Http Error ") + std::to_string(Result.status_code) + " - " + HttpStatus::reasonPhrase(
-					Result.status_code);
+        const std::string Property = RL.CheckString(2);
 
-				throw std::exception(Err.c_str());
-			}
+		const auto Handle = (D3DHandle) (uintptr_t) RL.ToUserData(1);
+		auto D3D = syn::D3D::GetSingleton();
 
-			return [Result](RbxLua NRL) 
-			{
-				NRL.PushLString(Result.text.c_str(), Result.text.size());
-				return 1;
-			};
-		});
-	}
+		const std::function<int(ImVec2)> PushVec2 = [=](ImVec2 Vec)
+		{
+			RL.GetGlobalK(KeyVector2);
+			RL.GetFieldK(-1, KeyNew);
+			RL.PushNumber(Vec.x);
+			RL.PushNumber(Vec.y);
+			RL.PCall(2, 1, 0);
 
-	int RbxApi::createrenderobject(DWORD rL)
-	{
-		syn::RbxLua RL(rL);
+			return 1;
+		};
 
-		const std::string Type = RL.CheckString(1);
+		const std::function<int(ImU32)> PushColor = [=](ImU32 Col)
+		{
+			const auto ColObj = ImGui::ColorConvertU32ToFloat4(Col);
 
-		/* syn::D3D::Initialize checks if its already init'd, we don't need to add a check here */
-		syn::D3D::Initialize();
+			RL.GetGlobalK(KeyColor3);
+			RL.GetFieldK(-1, KeyFromRGB);
+			RL.PushNumber(ColObj.x);
+			RL.PushNumber(ColObj.y);
+			RL.PushNumber(ColObj.z);
+			RL.PCall(3, 1, 0);
 
-		auto D3D = syn::D3D::GetSingleton();
+			return 1;
+		};
 
-		if (Type == "Line")
+		if (Property == "Visible")
 		{
-			auto Line = new D3DLine();
-			Line->Color = ImGui::GetColorU32(ImVec4(0, 0, 0, 255));
-			Line->From = ImVec2(0, 0);
-			Line->To = ImVec2(0, 0);
-			Line->Thickness = 0;
+			const auto Visible = D3D->GetRenderVisible(Handle);
+			if (!Visible)
+				return RL.LError("cant find object");
 
-			auto Obj = new D3DObject();
-			Obj->Header.Type = D3_LINE;
-			Obj->Header.Visible = FALSE;
-			Obj->Ptr = (DWORD*)Line;
-
-			D3D->AddToRenderList(Obj);
+			RL.PushBoolean(*Visible);
+			return 1;
+		}
 
-			RL.PushLightUserData(Obj);
+		if (Property == "ZIndex")
+		{
+			const auto ZIndex = D3D->GetRenderZIndex(Handle);
+			if (!ZIndex)
+				return RL.LError("cant find object");
 
+			RL.PushNumber(*ZIndex);
 			return 1;
 		}
 
-		if (Type == "Text")
+		switch (GetD3DHandleType(Handle))
 		{
-			auto Text = new D3DText();
-			Text->Color = ImGui::GetColorU32(ImVec4(0, 0, 0, 255));
-			Text->OutlineColor = ImGui::GetColorU32(ImVec4(0, 0, 0, 255));
-			Text->Center = FALSE;
-			Text->Outline = FALSE;
-			Text->Pos = ImVec2(0, 0);
-			Text->Size = 16;
-			Text->Font = 0;
-			Text->Text = new std::string("");
+			case D3_LINE:
+			{
+				const auto Line = D3D->GetRenderObject<D3DLine>(Handle);
+				if (!Line)
+					break;
 
-			auto Obj = new D3DObject();
-			Obj->Header.Type = D3_TEXT;
-			Obj->Header.Visible = FALSE;
-			Obj->Ptr = (DWORD*)Text;
+				if (Property == "From")
+				{
+					return PushVec2(Line->From);
+				}
 
-			D3D->AddToRenderList(Obj);
+				if (Property == "To")
+				{
+					return PushVec2(Line->To);
+				}
 
-			RL.PushLightUserData(Obj);
+				if (Property == "Color")
+				{
+					return PushColor(Line->Color);
+				}
 
-			return 1;
-		}
+				if (Property == "Thickness")
+				{
+					RL.PushNumber(Line->Thickness);
+					return 1;
+				}
 
-		if (Type == "Square")
-		{
-			auto Square = new D3DSquare();
-			Square->Color = ImGui::GetColorU32(ImVec4(0, 0, 0, 255));
-			Square->Filled = FALSE;
-			Square->Thickness = 16;
-			Square->Pos = ImVec2(0, 0);
-			Square->Size = ImVec2(16, 16);
+				if (Property == "Transparency")
+				{
+					const auto Col = ImGui::ColorConvertU32ToFloat4(Line->Color);
+					RL.PushNumber(Col.w);
+					return 1;
+				}
 
-			auto Obj = new D3DObject();
-			Obj->Header.Type = D3_SQUARE;
-			Obj->Header.Visible = FALSE;
-			Obj->Ptr = (DWORD*)Square;
+				throw std::exception("invalid property for line");
+			}
 
-			D3D->AddToRenderList(Obj);
+			case D3_TEXT:
+			{
+				const auto Text = D3D->GetRenderObject<D3DText>(Handle);
+				if (!Text)
+					break;
 
-			RL.PushLightUserData(Obj);
+				if (Property == "Text")
+				{
+					RL.PushLString(Text->Text.c_str(), Text->Text.length());
+					return 1;
+				}
 
-			return 1;
-		}
+				if (Property == "Position")
+				{
+					return PushVec2(Text->Pos);
+				}
 
-		if (Type == "Circle")
-		{
-			auto Circle = new D3DCircle();
-			Circle->Color = ImGui::GetColorU32(ImVec4(0, 0, 0, 255));
-			Circle->Filled = FALSE;
-			Circle->Thickness = 16;
-			Circle->Pos = ImVec2(0, 0);
-			Circle->Radius = 1;
-			Circle->Sides = 100;
+				if (Property == "Size")
+				{
+					RL.PushNumber(Text->Size);
+					return 1;
+				}
 
-			auto Obj = new D3DObject();
-			Obj->Header.Type = D3_CIRCLE;
-			Obj->Header.Visible = FALSE;
-			Obj->Ptr = (DWORD*)Circle;
+				if (Property == "Font")
+				{
+					RL.PushNumber(Text->Font);
+					return 1;
+				}
 
-			D3D->AddToRenderList(Obj);
+				if (Property == "Color")
+				{
+					return PushColor(Text->Color);
+				}
 
-			RL.PushLightUserData(Obj);
+				if (Property == "Center")
+				{
+					RL.PushBoolean(Text->Center);
+					return 1;
+				}
 
-			return 1;
-		}
+				if (Property == "Outline")
+				{
+					RL.PushBoolean(Text->Outline);
+					return 1;
+				}
 
-		return RL.LError("type does not exist");
-	}
+				if (Property == "OutlineColor")
+				{
+					return PushColor(Text->OutlineColor);
+				}
 
-	int RbxApi::setrenderproperty(DWORD rL)
-	{
-		syn::RbxLua RL(rL);
+				if (Property == "Transparency")
+				{
+					const auto Col = ImGui::ColorConvertU32ToFloat4(Text->Color);
+					RL.PushNumber(Col.w);
+					return 1;
+				}
 
-        /* TODO: Check if its an actual render object */
-		if (!RL.IsUserData(1))
-			return RL.ArgError(1, "render object expected");
+				if (Property == "TextBounds")
+				{
+					const auto TextSize = syn::D3D::GetSingleton()->GetFont(Text->Font)->CalcTextSizeA(
+						Text->Size, FLT_MAX, 0.0f, Text->Text.c_str());
+					return PushVec2(TextSize);
+				}
 
-        const std::string Property = RL.CheckString(2);
-        RL.CheckAny(3);
+                return RL.LError("invalid property for text");
+			}
 
-		const auto Obj = (D3DObject*)RL.ToUserData(1);
+			case D3_SQUARE:
+			{
+				const auto Square = D3D->GetRenderObject<D3DSquare>(Handle);
+				if (!Square)
+					break;
 
-		const std::function<ImVec2()> GetVec2 = [=]
-		{
-			RL.GetField(3, "X");
-			const float X = (float)RL.ToNumber(-1);
-			RL.Pop(1);
-			RL.GetField(3, "Y");
-			const float Y = (float)RL.ToNumber(-1);
-			RL.Pop(1);
+				if (Property == "Position")
+				{
+					return PushVec2(Square->Pos);
+				}
 
-			return ImVec2(X, Y);
-		};
+				if (Property == "Size")
+				{
+					return PushVec2(Square->Size);
+				}
 
-		const std::function<ImU32(ImU32)> GetColor = [=](ImU32 Old)
-		{
-			RL.GetField(3, "r");
-			const float R = (float)RL.ToNumber(-1) * 255;
-			RL.Pop(1);
-			RL.GetField(3, "g");
-			const float G = (float)RL.ToNumber(-1) * 255;
-			RL.Pop(1);
-			RL.GetField(3, "b");
-			const float B = (float)RL.ToNumber(-1) * 255;
-			RL.Pop(1);
+				if (Property == "Color")
+				{
+					return PushColor(Square->Color);
+				}
 
-			return ImGui::GetColorU32(ImVec4(R / 255, G / 255, B / 255, ImGui::ColorConvertU32ToFloat4(Old).w));
-		};
+				if (Property == "Thickness")
+				{
+					RL.PushNumber(Square->Thickness);
+					return 1;
+				}
 
-		if (Property == "Visible")
-		{
-			Obj->Header.Visible = RL.ToBoolean(3);
+				if (Property == "Filled")
+				{
+					RL.PushBoolean(Square->Filled);
+					return 1;
+				}
 
-			return 0;
-		}
+				if (Property == "Transparency")
+				{
+					const auto Col = ImGui::ColorConvertU32ToFloat4(Square->Color);
+					RL.PushNumber(Col.w);
+					return 1;
+				}
+
+                return RL.LError("invalid property for square");
+			}
 
-		switch (Obj->Header.Type)
-		{
-			case D3_LINE:
+			case D3_CIRCLE:
 			{
-				auto Line = (D3DLine*)Obj->Ptr;
+				const auto Circle = D3D->GetRenderObject<D3DCircle>(Handle);
+				if (!Circle)
+					break;
 
-				if (Property == "From")
+				if (Property == "Position")
 				{
-					Line->From = GetVec2();
-					return 0;
+					return PushVec2(Circle->Pos);
 				}
 
-				if (Property == "To")
+				if (Property == "Radius")
 				{
-					Line->To = GetVec2();
-					return 0;
+					RL.PushNumber(Circle->Radius);
+					return 1;
 				}
 
 				if (Property == "Color")
 				{
-					Line->Color = GetColor(Line->Color);
-					return 0;
+					return PushColor(Circle->Color);
 				}
 
 				if (Property == "Thickness")
 				{
-					Line->Thickness = (float)RL.ToNumber(3);
-					return 0;
+					RL.PushNumber(Circle->Thickness);
+					return 1;
+				}
+
+				if (Property == "Filled")
+				{
+					RL.PushBoolean(Circle->Filled);
+					return 1;
 				}
 
 				if (Property == "Transparency")
 				{
-					auto Col = ImGui::ColorConvertU32ToFloat4(Line->Color);
-					Col.w = (float)RL.ToNumber(3);
-					Line->Color = ImGui::GetColorU32(Col);
-					return 0;
+					const auto Col = ImGui::ColorConvertU32ToFloat4(Circle->Color);
+					RL.PushNumber(Col.w);
+					return 1;
 				}
 
-				return RL.LError("invalid property for line");
+				if (Property == "NumSides")
+				{
+					RL.PushNumber(Circle->Sides);
+					return 1;
+				}
+
+                return RL.LError("invalid property for circle");
 			}
 
-			case D3_TEXT:
+			case D3_IMAGE:
 			{
-				auto Text = (D3DText*)Obj->Ptr;
-
-				if (Property == "Text")
-				{
-					size_t TextSize;
-					const auto TextCStr = RL.ToLString(3, &TextSize);
-
-					delete Text->Text;
-					Text->Text = new std::string(TextCStr, TextSize);
-					return 0;
-				}
+				const auto Image = D3D->GetRenderObject<D3DImage>(Handle);
+				if (!Image)
+					break;
 
 				if (Property == "Position")
 				{
-					Text->Pos = GetVec2();
-					return 0;
+					return PushVec2(Image->Pos);
 				}
 
 				if (Property == "Size")
 				{
-					Text->Size = (float)RL.ToNumber(3);
-					return 0;
-				}
-
-				if (Property == "Font")
-				{
-					Text->Font = RL.ToInteger(3);
-					return 0;
+					return PushVec2(Image->Size);
 				}
 
 				if (Property == "Color")
 				{
-					Text->Color = GetColor(Text->Color);
-					return 0;
+					return PushColor(Image->Color);
 				}
 
-				if (Property == "Center")
-				{
-					Text->Center = RL.ToBoolean(3);
-					return 0;
-				}
-
-				if (Property == "Outline")
+				if (Property == "Rounding")
 				{
-					Text->Outline = RL.ToBoolean(3);
-					return 0;
+					RL.PushNumber(Image->Rounding);
+					return 1;
 				}
 
-				if (Property == "OutlineColor")
+				if (Property == "Transparency")
 				{
-					Text->OutlineColor = GetColor(Text->OutlineColor);
-					return 0;
+					const auto Col = ImGui::ColorConvertU32ToFloat4(Image->Color);
+					RL.PushNumber(Col.w);
+					return 1;
 				}
 
-				if (Property == "Transparency")
+				if (Property == "ImageSize")
 				{
-                    ImVec4 Col = ImGui::ColorConvertU32ToFloat4(Text->Color);
-					ImVec4 ColOutline = ImGui::ColorConvertU32ToFloat4(Text->OutlineColor);
-                    float Amt = (float)RL.ToNumber(3);
-
-					Col.w = Amt;
-					ColOutline.w = Amt;
-					Text->Color = ImGui::GetColorU32(Col);
-					Text->OutlineColor = ImGui::GetColorU32(ColOutline);
-
-					return 0;
+					return PushVec2(Image->Image ? Image->Image->Size() : ImVec2(0, 0));
 				}
 
-				if (Property == "TextBounds")
+				if (Property == "Data")
 				{
-                    return RL.LError("TextBounds is a read only property for text");
+					return RL.LError("Data is a write only property for image");
 				}
 
-                return RL.LError("invalid property for text");
+                return RL.LError("invalid property for image");
 			}
 
-			case D3_SQUARE:
+			case D3_POLYLINE:
 			{
-				auto Square = (D3DSquare*)Obj->Ptr;
+				const auto Polyline = D3D->GetRenderObject<D3DPolyline>(Handle);
+				if (!Polyline)
+					break;
 
-				if (Property == "Position")
+				if (Property == "Points")
 				{
-					Square->Pos = GetVec2();
-					return 0;
+					RL.CreateTable((int) Polyline->Points.size(), 0);
+					for (size_t i = 0; i < Polyline->Points.size(); i++)
+					{
+						PushVec2(Polyline->Points[i]);
+						RL.Remove(-2);
+						RL.RawSetI(-2, (int) i + 1);
+					}
+					return 1;
 				}
 
-				if (Property == "Size")
+				if (Property == "Color")
 				{
-					Square->Size = GetVec2();
-					return 0;
+					return PushColor(Polyline->Color);
 				}
 
-				if (Property == "Color")
+				if (Property == "Thickness")
 				{
-					Square->Color = GetColor(Square->Color);
-					return 0;
+					RL.PushNumber(Polyline->Thickness);
+					return 1;
 				}
 
-				if (Property == "Thickness")
+				if (Property == "Closed")
 				{
-					Square->Thickness = (float)RL.ToNumber(3);
-					return 0;
+					RL.PushBoolean(Polyline->Closed);
+					return 1;
 				}
 
 				if (Property == "Filled")
 				{
-					Square->Filled = RL.ToBoolean(3);
-					return 0;
+					RL.PushBoolean(Polyline->Filled);
+					return 1;
 				}
 
 				if (Property == "Transparency")
 				{
-					auto Col = ImGui::ColorConvertU32ToFloat4(Square->Color);
-					Col.w = (float)RL.ToNumber(3);
-					Square->Color = ImGui::GetColorU32(Col);
-					return 0;
+					const auto Col = ImGui::ColorConvertU32ToFloat4(Polyline->Color);
+					RL.PushNumber(Col.w);
+					return 1;
 				}
 
-                return RL.LError("invalid property for square");
+                return RL.LError("invalid property for polyline");
 			}
 
-			case D3_CIRCLE:
+			case D3_POLYGON:
 			{
-				auto Circle = (D3DCircle*)Obj->Ptr;
+				const auto Polygon = D3D->GetRenderObject<D3DPolygon>(Handle);
+				if (!Polygon)
+					break;
 
-				if (Property == "Position")
-				{
-					Circle->Pos = GetVec2();
-					return 0;
-				}
-
-				if (Property == "Radius")
+				static const char* PointNames[] = { "PointA", "PointB", "PointC", "PointD" };
+				for (auto i = 0; i < Polygon->Count; i++)
 				{
-					Circle->Radius = (float)RL.ToNumber(3);
-					return 0;
+					if (Property == PointNames[i])
+					{
+						return PushVec2(Polygon->Points[i]);
+					}
 				}
 
 				if (Property == "Color")
 				{
-					Circle->Color = GetColor(Circle->Color);
-					return 0;
+					return PushColor(Polygon->Color);
 				}
 
 				if (Property == "Thickness")
 				{
-					Circle->Thickness = (float)RL.ToNumber(3);
-					return 0;
+					RL.PushNumber(Polygon->Thickness);
+					return 1;
 				}
 
 				if (Property == "Filled")
 				{
-					Circle->Filled = RL.ToBoolean(3);
-					return 0;
+					RL.PushBoolean(Polygon->Filled);
+					return 1;
 				}
 
 				if (Property == "Transparency")
 				{
-					auto Col = ImGui::ColorConvertU32ToFloat4(Circle->Color);
-					Col.w = (float)RL.ToNumber(3);
-					Circle->Color = ImGui::GetColorU32(Col);
-					return 0;
-				}
-
-				if (Property == "NumSides")
-				{
-					Circle->Sides = RL.ToInteger(3);
-					return 0;
+					const auto Col = ImGui::ColorConvertU32ToFloat4(Polygon->Color);
+					RL.PushNumber(Col.w);
+					return 1;
 				}
 
-                return RL.LError("invalid property for circle");
+                return RL.LError(Polygon->Count == 3 ? "invalid property for triangle" : "invalid property for quad");
 			}
 		}
 
-        return RL.LError("can't find object");
+        return RL.LError("cant find object");
 	}
 
-	int RbxApi::getrenderproperty(DWORD rL)
+	int RbxApi::destroyrenderobject(DWORD rL)
 	{
 		syn::RbxLua RL(rL);
 
         /* TODO: Check if its an actual render object */
         if (!RL.IsUserData(1))
             return RL.ArgError(1, "render object expected");
-		
-        const std::string Property = RL.CheckString(2);
 
-		const auto Obj = (D3DObject*)RL.ToUserData(1);
+		syn::D3D::GetSingleton()->DestroyRenderObject((D3DHandle) (uintptr_t) RL.ToUserData(1));
 
-		const std::function<int(ImVec2)> PushVec2 = [=](ImVec2 Vec)
+		return 0;
+	}
+
+	int RbxApi::sweeprenderobjects(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		RL.CheckType(1, R_LUA_TTABLE);
+
+		std::vector<D3DHandle> Live;
+		RL.PushNil();
+		while (RL.Next(1))
 		{
-			RL.GetGlobal("Vector2");
-			RL.GetField(-1, "new");
-			RL.PushNumber(Vec.x);
-			RL.PushNumber(Vec.y);
-			RL.PCall(2, 1, 0);
+			if (RL.IsLightUserData(-1))
+				Live.push_back((D3DHandle) (uintptr_t) RL.ToUserData(-1));
+			RL.Pop(1);
+		}
 
-			return 1;
-		};
+		RL.PushNumber(syn::D3D::GetSingleton()->SweepRenderObjects(Live));
+		return 1;
+	}
 
-		const std::function<int(ImU32)> PushColor = [=](ImU32 Col)
+	int RbxApi::setfpscap(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		const auto FPS = RL.CheckNumber(1);
+		if (FPS < 0)
+			return RL.ArgError(1, "fps cap can't be negative");
+
+		if (!syn::D3D::SetFPSCap(FPS, RL.ToBoolean(2)))
+			return RL.LError("fps unlocker is unavailable");
+
+		return 0;
+	}
+
+	int RbxApi::getfpscap(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		RL.PushNumber(syn::D3D::FPSCap.load());
+		RL.PushBoolean(syn::D3D::FPSLowLatency.load());
+		return 2;
+	}
+
+	Buffer* RbxApi::check_string_builder(RbxLua RL, const int Index)
+	{
+		if (RL.IsLightUserData(Index))
 		{
-			const auto ColObj = ImGui::ColorConvertU32ToFloat4(Col);
+			const auto Found = StringBuilders.find((uintptr_t) RL.ToUserData(Index));
+			if (Found != StringBuilders.end())
+				return &Found->second;
+		}
 
-			RL.GetGlobal("Color3");
-			RL.GetField(-1, "fromRGB");
-			RL.PushNumber(ColObj.x);
-			RL.PushNumber(ColObj.y);
-			RL.PushNumber(ColObj.z);
-			RL.PCall(3, 1, 0);
+		RL.ArgError(Index, "string builder expected");
+		return nullptr;
+	}
 
-			return 1;
-		};
+	int RbxApi::createstringbuilder(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
 
-		if (Property == "Visible")
+		const auto Handle = ++NextStringBuilder;
+		StringBuilders[Handle].reserve((size_t) RL.OptInteger(1, 0));
+
+		RL.PushLightUserData((void*) Handle);
+
+		return 1;
+	}
+
+	/* stringbuilderappend(sb, ...) appends every string or number argument, numbers format like tostring */
+	int RbxApi::stringbuilderappend(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		const auto SB = check_string_builder(RL, 1);
+
+		const auto Top = RL.GetTop();
+		for (auto i = 2; i <= Top; i++)
 		{
-			RL.PushBoolean(Obj->Header.Visible);
-			return 1;
+			if (RL.Type(i) == R_LUA_TSTRING)
+			{
+				size_t Len;
+				const auto Str = RL.ToLString(i, &Len);
+				SB->writeRaw(Str, Len);
+			}
+			else if (RL.Type(i) == R_LUA_TNUMBER)
+			{
+				char Num[32];
+				SB->writeRaw(Num, (size_t) snprintf(Num, sizeof(Num), "%.14g", RL.ToNumber(i)));
+			}
+			else
+				return RL.ArgError(i, "string or number expected");
+		}
+
+		return 0;
+	}
+
+	int RbxApi::stringbuilderrep(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		const auto SB = check_string_builder(RL, 1);
+
+		size_t Len;
+		const auto Str = RL.CheckLString(2, &Len);
+		const auto Count = RL.CheckInteger(3);
+
+		if (Count > 0)
+			SB->writeRep(Str, Len, (size_t) Count);
+
+		return 0;
+	}
+
+	/* stringbuilderpack(sb, type, value, bigendian), type is one of int8/uint8/int16/uint16/int32/uint32/float/double */
+	int RbxApi::stringbuilderpack(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		const auto SB = check_string_builder(RL, 1);
+		const std::string Type = RL.CheckString(2);
+		const auto Value = RL.CheckNumber(3);
+		const auto LE = !RL.ToBoolean(4);
+
+		if (Type == "int8" || Type == "uint8")
+			SB->writeUInt8((unsigned char) (long long) Value);
+		else if (Type == "int16" || Type == "uint16")
+			LE ? SB->writeUInt16_LE((unsigned short) (long long) Value) : SB->writeUInt16_BE((unsigned short) (long long) Value);
+		else if (Type == "int32" || Type == "uint32")
+			LE ? SB->writeUInt32_LE((unsigned int) (long long) Value) : SB->writeUInt32_BE((unsigned int) (long long) Value);
+		else if (Type == "float")
+			LE ? SB->writeFloat_LE((float) Value) : SB->writeFloat_BE((float) Value);
+		else if (Type == "double")
+			LE ? SB->writeDouble_LE(Value) : SB->writeDouble_BE(Value);
+		else
+			return RL.ArgError(2, "invalid pack type");
+
+		return 0;
+	}
+
+	int RbxApi::stringbuildertostring(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		const auto SB = check_string_builder(RL, 1);
+
+		RL.PushLString((const char*) SB->data(), SB->size());
+
+		return 1;
+	}
+
+	int RbxApi::stringbuilderlen(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		const auto SB = check_string_builder(RL, 1);
+
+		RL.PushNumber((double) SB->size());
+
+		return 1;
+	}
+
+	int RbxApi::stringbuilderclear(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		check_string_builder(RL, 1)->clear();
+
+		return 0;
+	}
+
+	int RbxApi::destroystringbuilder(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		if (RL.IsLightUserData(1))
+			StringBuilders.erase((uintptr_t) RL.ToUserData(1));
+
+		return 0;
+	}
+
+	RbxApi::BinaryBuffer* RbxApi::to_binary_buffer(RbxLua RL, const int Index)
+	{
+		uintptr_t Handle = 0;
+
+		if (RL.IsLightUserData(Index))
+		{
+			Handle = (uintptr_t) RL.ToUserData(Index);
+		}
+		else if (RL.IsTable(Index))
+		{
+			RL.GetField(Index, "__OBJECT");
+			if (RL.IsLightUserData(-1))
+				Handle = (uintptr_t) RL.ToUserData(-1);
+			RL.Pop(1);
+		}
+
+		const auto Found = BinaryBuffers.find(Handle);
+		return Found != BinaryBuffers.end() ? &Found->second : nullptr;
+	}
+
+	RbxApi::BinaryBuffer* RbxApi::check_binary_buffer(RbxLua RL, const int Index)
+	{
+		const auto BB = to_binary_buffer(RL, Index);
+		if (!BB)
+			RL.ArgError(Index, "buffer expected");
+
+		return BB;
+	}
+
+	const char* RbxApi::check_bytes(RbxLua RL, const int Index, size_t* Len)
+	{
+		if (RL.Type(Index) != R_LUA_TSTRING)
+		{
+			if (const auto BB = to_binary_buffer(RL, Index))
+			{
+				*Len = BB->Length;
+				return (const char*) BB->Data();
+			}
+		}
+
+		return RL.CheckLString(Index, Len);
+	}
+
+	static void push_binary_buffer(RbxLua RL, RbxApi::BinaryBuffer&& BB)
+	{
+		const auto Handle = ++RbxApi::NextBinaryBuffer;
+		RbxApi::BinaryBuffers.emplace(Handle, std::move(BB));
+
+		RL.PushLightUserData((void*) Handle);
+	}
+
+	enum BufferType
+	{
+		BT_INVALID,
+		BT_I8, BT_U8, BT_I16, BT_U16, BT_I32, BT_U32, BT_F32, BT_F64
+	};
+
+	static BufferType buffer_type(const std::string& Type)
+	{
+		if (Type == "int8") return BT_I8;
+		if (Type == "uint8") return BT_U8;
+		if (Type == "int16") return BT_I16;
+		if (Type == "uint16") return BT_U16;
+		if (Type == "int32") return BT_I32;
+		if (Type == "uint32") return BT_U32;
+		if (Type == "float") return BT_F32;
+		if (Type == "double") return BT_F64;
+		return BT_INVALID;
+	}
+
+	static size_t buffer_type_size(const BufferType Type)
+	{
+		switch (Type)
+		{
+		case BT_I8: case BT_U8: return 1;
+		case BT_I16: case BT_U16: return 2;
+		case BT_I32: case BT_U32: case BT_F32: return 4;
+		case BT_F64: return 8;
+		default: return 0;
+		}
+	}
+
+	/* Unaligned loads and stores through memcpy, big endian is a byteswap of the integer image */
+	template <typename T, typename I>
+	static T buffer_load(const unsigned char* Src, const bool BE)
+	{
+		I Image;
+		memcpy(&Image, Src, sizeof(I));
+
+		if (BE)
+		{
+			if constexpr (sizeof(I) == 2) Image = _byteswap_ushort(Image);
+			else if constexpr (sizeof(I) == 4) Image = _byteswap_ulong(Image);
+			else if constexpr (sizeof(I) == 8) Image = _byteswap_uint64(Image);
+		}
+
+		T Value;
+		memcpy(&Value, &Image, sizeof(T));
+		return Value;
+	}
+
+	template <typename T, typename I>
+	static void buffer_store(unsigned char* Dst, const T Value, const bool BE)
+	{
+		I Image;
+		memcpy(&Image, &Value, sizeof(I));
+
+		if (BE)
+		{
+			if constexpr (sizeof(I) == 2) Image = _byteswap_ushort(Image);
+			else if constexpr (sizeof(I) == 4) Image = _byteswap_ulong(Image);
+			else if constexpr (sizeof(I) == 8) Image = _byteswap_uint64(Image);
 		}
 
-		switch (Obj->Header.Type)
-		{
-			case D3_LINE:
-			{
-				const auto Line = (D3DLine*)Obj->Ptr;
+		memcpy(Dst, &Image, sizeof(I));
+	}
 
-				if (Property == "From")
-				{
-					return PushVec2(Line->From);
-				}
+	static size_t check_buffer_range(RbxLua RL, const RbxApi::BinaryBuffer* BB, const int Index, const size_t Size)
+	{
+		const auto Offset = RL.CheckInteger(Index);
+		if (Offset < 0 || (size_t) Offset > BB->Length || Size > BB->Length - (size_t) Offset)
+			RL.ArgError(Index, "buffer access out of bounds");
 
-				if (Property == "To")
-				{
-					return PushVec2(Line->To);
-				}
+		return (size_t) Offset;
+	}
 
-				if (Property == "Color")
-				{
-					return PushColor(Line->Color);
-				}
+	/* createbuffer(size or string), offsets into buffers are zero based */
+	int RbxApi::createbuffer(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
 
-				if (Property == "Thickness")
-				{
-					RL.PushNumber(Line->Thickness);
-					return 1;
-				}
+		BinaryBuffer BB{ std::make_shared<Buffer>(), 0, 0 };
 
-				if (Property == "Transparency")
-				{
-					const auto Col = ImGui::ColorConvertU32ToFloat4(Line->Color);
-					RL.PushNumber(Col.w);
-					return 1;
-				}
+		if (RL.Type(1) == R_LUA_TSTRING)
+		{
+			size_t Len;
+			const auto Str = RL.ToLString(1, &Len);
+			BB.Storage->writeRaw(Str, Len);
+			BB.Length = Len;
+		}
+		else
+		{
+			const auto Size = RL.CheckInteger(1);
+			if (Size < 0)
+				return RL.ArgError(1, "invalid buffer size");
 
-				throw std::exception("invalid property for line");
-			}
+			BB.Storage->resize((size_t) Size);
+			BB.Length = (size_t) Size;
+		}
 
-			case D3_TEXT:
-			{
-				const auto Text = (D3DText*)Obj->Ptr;
+		push_binary_buffer(RL, std::move(BB));
 
-				if (Property == "Text")
-				{
-					RL.PushLString(Text->Text->c_str(), Text->Text->length());
-					return 1;
-				}
+		return 1;
+	}
 
-				if (Property == "Position")
-				{
-					return PushVec2(Text->Pos);
-				}
+	/* bufferread(buf, type, offset, bigendian) */
+	int RbxApi::bufferread(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
 
-				if (Property == "Size")
-				{
-					RL.PushNumber(Text->Size);
-					return 1;
-				}
+		const auto BB = check_binary_buffer(RL, 1);
+		const auto Type = buffer_type(RL.CheckString(2));
+		if (Type == BT_INVALID)
+			return RL.ArgError(2, "invalid buffer type");
+
+		const auto Src = BB->Data() + check_buffer_range(RL, BB, 3, buffer_type_size(Type));
+		const auto BE = RL.ToBoolean(4);
+
+		switch (Type)
+		{
+		case BT_I8: RL.PushNumber((double) (signed char) *Src); break;
+		case BT_U8: RL.PushNumber((double) *Src); break;
+		case BT_I16: RL.PushNumber((double) buffer_load<short, unsigned short>(Src, BE)); break;
+		case BT_U16: RL.PushNumber((double) buffer_load<unsigned short, unsigned short>(Src, BE)); break;
+		case BT_I32: RL.PushNumber((double) buffer_load<int, unsigned long>(Src, BE)); break;
+		case BT_U32: RL.PushNumber((double) buffer_load<unsigned int, unsigned long>(Src, BE)); break;
+		case BT_F32: RL.PushNumber((double) buffer_load<float, unsigned long>(Src, BE)); break;
+		case BT_F64: RL.PushNumber(buffer_load<double, unsigned long long>(Src, BE)); break;
+		default: break;
+		}
 
-				if (Property == "Font")
-				{
-					RL.PushNumber(Text->Font);
-					return 1;
-				}
+		return 1;
+	}
 
-				if (Property == "Color")
-				{
-					return PushColor(Text->Color);
-				}
+	/* bufferwrite(buf, type, offset, value, bigendian) */
+	int RbxApi::bufferwrite(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
 
-				if (Property == "Center")
-				{
-					RL.PushBoolean(Text->Center);
-					return 1;
-				}
+		const auto BB = check_binary_buffer(RL, 1);
+		const auto Type = buffer_type(RL.CheckString(2));
+		if (Type == BT_INVALID)
+			return RL.ArgError(2, "invalid buffer type");
 
-				if (Property == "Outline")
-				{
-					RL.PushBoolean(Text->Outline);
-					return 1;
-				}
+		const auto Dst = BB->Data() + check_buffer_range(RL, BB, 3, buffer_type_size(Type));
+		const auto Value = RL.CheckNumber(4);
+		const auto BE = RL.ToBoolean(5);
 
-				if (Property == "OutlineColor")
-				{
-					return PushColor(Text->OutlineColor);
-				}
+		switch (Type)
+		{
+		case BT_I8: case BT_U8: *Dst = (unsigned char) (long long) Value; break;
+		case BT_I16: case BT_U16: buffer_store<unsigned short, unsigned short>(Dst, (unsigned short) (long long) Value, BE); break;
+		case BT_I32: case BT_U32: buffer_store<unsigned long, unsigned long>(Dst, (unsigned long) (long long) Value, BE); break;
+		case BT_F32: buffer_store<float, unsigned long>(Dst, (float) Value, BE); break;
+		case BT_F64: buffer_store<double, unsigned long long>(Dst, Value, BE); break;
+		default: break;
+		}
 
-				if (Property == "Transparency")
-				{
-					const auto Col = ImGui::ColorConvertU32ToFloat4(Text->Color);
-					RL.PushNumber(Col.w);
-					return 1;
-				}
+		return 0;
+	}
 
-				if (Property == "TextBounds")
-				{
-					const auto TextSize = syn::D3D::GetSingleton()->GetFont(Text->Font)->CalcTextSizeA(
-						Text->Size, FLT_MAX, 0.0f, Text->Text->c_str());
-					return PushVec2(TextSize);
-				}
+	/* bufferreadstring(buf, offset, len) */
+	int RbxApi::bufferreadstring(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
 
-                return RL.LError("invalid property for text");
-			}
+		const auto BB = check_binary_buffer(RL, 1);
 
-			case D3_SQUARE:
-			{
-				const auto Square = (D3DSquare*)Obj->Ptr;
+		const auto Len = RL.CheckInteger(3);
+		if (Len < 0)
+			return RL.ArgError(3, "invalid length");
 
-				if (Property == "Position")
-				{
-					return PushVec2(Square->Pos);
-				}
+		const auto Offset = check_buffer_range(RL, BB, 2, (size_t) Len);
 
-				if (Property == "Size")
-				{
-					return PushVec2(Square->Size);
-				}
+		RL.PushLString((const char*) BB->Data() + Offset, (size_t) Len);
 
-				if (Property == "Color")
-				{
-					return PushColor(Square->Color);
-				}
+		return 1;
+	}
 
-				if (Property == "Thickness")
-				{
-					RL.PushNumber(Square->Thickness);
-					return 1;
-				}
+	/* bufferwritestring(buf, offset, data), data may also be a buffer */
+	int RbxApi::bufferwritestring(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
 
-				if (Property == "Filled")
-				{
-					RL.PushBoolean(Square->Filled);
-					return 1;
-				}
+		const auto BB = check_binary_buffer(RL, 1);
 
-				if (Property == "Transparency")
-				{
-					const auto Col = ImGui::ColorConvertU32ToFloat4(Square->Color);
-					RL.PushNumber(Col.w);
-					return 1;
-				}
+		size_t Len;
+		const auto Src = check_bytes(RL, 3, &Len);
 
-                return RL.LError("invalid property for square");
-			}
+		const auto Offset = check_buffer_range(RL, BB, 2, Len);
 
-			case D3_CIRCLE:
-			{
-				const auto Circle = (D3DCircle*)Obj->Ptr;
+		/* The source can be a slice of the same storage */
+		memmove(BB->Data() + Offset, Src, Len);
 
-				if (Property == "Position")
-				{
-					return PushVec2(Circle->Pos);
-				}
+		return 0;
+	}
 
-				if (Property == "Radius")
-				{
-					RL.PushNumber(Circle->Radius);
-					return 1;
-				}
+	/* bufferslice(buf, offset, len), the slice shares storage with buf */
+	int RbxApi::bufferslice(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
 
-				if (Property == "Color")
-				{
-					return PushColor(Circle->Color);
-				}
+		const auto BB = check_binary_buffer(RL, 1);
 
-				if (Property == "Thickness")
-				{
-					RL.PushNumber(Circle->Thickness);
-					return 1;
-				}
+		const auto Offset = RL.CheckInteger(2);
+		if (Offset < 0 || (size_t) Offset > BB->Length)
+			return RL.ArgError(2, "buffer access out of bounds");
 
-				if (Property == "Filled")
-				{
-					RL.PushBoolean(Circle->Filled);
-					return 1;
-				}
+		const auto Len = RL.OptInteger(3, (lua_Integer) (BB->Length - (size_t) Offset));
+		if (Len < 0 || (size_t) Len > BB->Length - (size_t) Offset)
+			return RL.ArgError(3, "buffer access out of bounds");
 
-				if (Property == "Transparency")
-				{
-					const auto Col = ImGui::ColorConvertU32ToFloat4(Circle->Color);
-					RL.PushNumber(Col.w);
-					return 1;
-				}
+		push_binary_buffer(RL, { BB->Storage, BB->Offset + (size_t) Offset, (size_t) Len });
 
-				if (Property == "NumSides")
-				{
-					RL.PushNumber(Circle->Sides);
-					return 1;
-				}
+		return 1;
+	}
 
-                return RL.LError("invalid property for circle");
-			}
-		}
+	int RbxApi::bufferlen(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
 
-        return RL.LError("cant find object");
+		RL.PushNumber((double) check_binary_buffer(RL, 1)->Length);
+
+		return 1;
 	}
 
-	int RbxApi::destroyrenderobject(DWORD rL)
+	int RbxApi::buffertostring(DWORD rL)
 	{
 		syn::RbxLua RL(rL);
 
-        /* TODO: Check if its an actual render object */
-        if (!RL.IsUserData(1))
-            return RL.ArgError(1, "render object expected");
-
-		const auto Obj = (D3DObject*)RL.ToUserData(1);
+		const auto BB = check_binary_buffer(RL, 1);
 
-		auto D3D = syn::D3D::GetSingleton();
+		RL.PushLString((const char*) BB->Data(), BB->Length);
 
-		D3D->RemoveFromRenderList(Obj);
+		return 1;
+	}
 
-		switch (Obj->Header.Type)
-		{
-			case D3_LINE:
-			{
-				delete (D3DLine*)Obj->Ptr;
-				break;
-			}
-			case D3_TEXT:
-			{
-				const auto Text = (D3DText*)Obj->Ptr;
-				delete Text->Text;
-				delete Text;
-				break;
-			}
-			case D3_CIRCLE:
-			{
-				delete (D3DCircle*)Obj->Ptr;
-				break;
-			}
-			case D3_SQUARE:
-			{
-				delete (D3DSquare*)Obj->Ptr;
-				break;
-			}
-		}
+	/* Only drops this handle, other slices keep the storage alive */
+	int RbxApi::destroybuffer(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
 
-		delete Obj;
+		if (RL.IsLightUserData(1))
+			BinaryBuffers.erase((uintptr_t) RL.ToUserData(1));
 
 		return 0;
 	}
@@ -4717,7 +8494,7 @@ namespace syn
 		size_t TextSize;
 		const auto TextCStr = RL.ToLString(1, &TextSize);
 
-		ConsoleOutput.emplace_back(std::make_pair(std::string(TextCStr, TextSize), Color));
+		ConsoleOutput.Push(std::string(TextCStr, TextSize), Color);
 
 		return 1;
 	}
@@ -5092,7 +8869,7 @@ namespace syn
 
 	int RbxApi::consoleclear(DWORD rL)
 	{
-		system("cls");
+		syn::Console::GetSingleton()->Clear();
 		return 0;
 	}
 
@@ -5102,7 +8879,7 @@ namespace syn
 
         const char* output = RL.CheckString(1);
 
-		syn::Console::GetSingleton()->Info(output);
+		syn::Console::GetSingleton()->Info("%s", output);
 		return 0;
 	}
 
@@ -5112,7 +8889,7 @@ namespace syn
 
         const char* output = RL.CheckString(1);
 
-		syn::Console::GetSingleton()->Warning(output);
+		syn::Console::GetSingleton()->Warning("%s", output);
 		return 0;
 	}
 
@@ -5122,7 +8899,7 @@ namespace syn
 
         const char* output = RL.CheckString(1);
 
-		syn::Console::GetSingleton()->Error(output);
+		syn::Console::GetSingleton()->Error("%s", output);
 		return 0;
 	}
 
@@ -5285,11 +9062,72 @@ namespace syn
 
 #define LockTable() *(BYTE*)(RL.ToPointer(-1) + RT_LOCKED) = TRUE
 
+/* the member list is only filled on the first attach, later attaches just reuse it */
+#define WrapLazyMember(func, name) \
+        if (FillLazy) Lazy[OBFUSCATE_STR(name)] = func
+
+#define WrapLazyGlobalTable(name, f) \
+        { \
+            auto& Lazy = LazyLibraries[OBFUSCATE_STR(name)]; \
+            const auto FillLazy = Lazy.empty(); \
+            WrapGlobalTable(name, PushLazyLibrary(RL, Lazy); f); \
+        }
+
+#define WrapLazyMemberTable(name, f) \
+        { \
+            auto& Lazy = LazyLibraries[OBFUSCATE_STR(name)]; \
+            const auto FillLazy = Lazy.empty(); \
+            WrapMemberTable(name, PushLazyLibrary(RL, Lazy); f); \
+        }
+
+	void RbxApi::PushLazyLibrary(RbxLua RL, LazyLibrary& Library)
+	{
+		/* table is on top, metatable keeps the library in [1] for the handler */
+		RL.CreateTable(1, 1);
+		RL.PushLightUserData(&Library);
+		RL.RawSetI(-2, 1);
+		RL.PushCFunction(lazylibraryhandler);
+		RL.SetField(-2, OBFUSCATE_STR("__index"));
+		RL.SetMetaTable(-2);
+	}
+
+	int RbxApi::lazylibraryhandler(DWORD rL)
+	{
+		syn::RbxLua RL(rL);
+
+		if (RL.Type(2) != R_LUA_TSTRING || !RL.GetMetaTable(1))
+			return 0;
+
+		RL.RawGetI(-1, 1);
+		const auto Library = (LazyLibrary*) RL.ToUserData(-1);
+		RL.Pop(2);
+
+		size_t Len;
+		const auto Key = RL.ToLString(2, &Len);
+		const auto Member = Library->find(std::string(Key, Len));
+		if (Member == Library->end())
+			return 0;
+
+		/* cache the closure in the table itself so the metamethod only runs once per member,
+		   library tables are usually locked so the flag is lifted for the store */
+		RL.PushCFunction(Member->second);
+		const auto Locked = (BYTE*)(RL.ToPointer(1) + RT_LOCKED);
+		const auto WasLocked = *Locked;
+		*Locked = FALSE;
+		RL.PushValue(2);
+		RL.PushValue(-2);
+		RL.SetTable(1);
+		*Locked = WasLocked;
+
+		return 1;
+	}
+
 	bool RbxApi::PushLibraries(RbxLua RL, DWORD ORL)
 	{
         VM_TIGER_WHITE_START;
 
         WrapGlobal(loadstring, "loadstring");
+        WrapGlobal(loadstringasync, "loadstringasync");
 
         WrapGlobal(getrawmetatable, "getrawmetatable");
         WrapGlobal(setrawmetatable, "setrawmetatable");
@@ -5324,6 +9162,7 @@ namespace syn
         WrapGlobal(setconstant, "setconstant");
 
         WrapGlobal(decompile, "decompile");
+        WrapGlobal(decompileall, "decompileall");
         WrapGlobal(dumpstring, "dumpstring");
 
         WrapGlobal(newcclosure, "newcclosure");
@@ -5349,6 +9188,8 @@ namespace syn
 
         WrapGlobal(getloadedmodules, "getloadedmodules");
         WrapGlobal(getloadedmodules, "get_loaded_modules");
+        WrapGlobal(getloadedmodulessince, "getloadedmodulessince");
+        WrapGlobal(getloadedmodulessince, "get_loaded_modules_since");
 
         WrapGlobal(getcallingscript, "getcallingscript");
         WrapGlobal(getcallingscript, "get_calling_script");
@@ -5358,6 +9199,8 @@ namespace syn
         WrapGlobal(getconnectionstate, "getconnectionstate");
 
         WrapGlobal(firesignal, "firesignal");
+        WrapGlobal(firesignals, "firesignals");
+        WrapGlobal(getconnectionsbulk, "getconnectionsbulk");
 
         WrapGlobal(getspecialinfo, "getspecialinfo");
 
@@ -5387,6 +9230,12 @@ namespace syn
         WrapGlobal(enableconnection, "enableconnection");
 
         WrapGlobal(getgc, "getgc");
+        WrapGlobal(getgciter, "getgciter");
+        WrapGlobal(scanclosures, "scanclosures");
+        WrapGlobal(heapsnapshot, "heapsnapshot");
+        WrapGlobal(heapdiff, "heapdiff");
+        WrapGlobal(heapsnapshotfree, "heapsnapshotfree");
+        WrapGlobal(finddescendants, "finddescendants");
 
         WrapGlobal(getsenv, "getsenv");
         WrapGlobal(getsenv, "getmenv");
@@ -5421,6 +9270,8 @@ namespace syn
         WrapGlobal(delfile, "delfile");
         WrapGlobal(loadfile, "loadfile");
         WrapGlobal(appendfile, "appendfile");
+        WrapGlobal(readfileasync, "readfileasync");
+        WrapGlobal(writefileasync, "writefileasync");
 
         WrapGlobal(checkrbxlocked, "checkrbxlocked");
         WrapGlobal(checkinst, "checkinst");
@@ -5434,8 +9285,44 @@ namespace syn
 
         WrapGlobal(createrenderobject, "createrenderobject");
         WrapGlobal(setrenderproperty, "setrenderproperty");
+        WrapGlobal(setrenderpropertybulk, "setrenderpropertybulk");
+        WrapGlobal(getrenderpropertyids, "getrenderpropertyids");
         WrapGlobal(getrenderproperty, "getrenderproperty");
         WrapGlobal(destroyrenderobject, "destroyrenderobject");
+        WrapGlobal(sweeprenderobjects, "sweeprenderobjects");
+
+        WrapGlobal(setfpscap, "setfpscap");
+        WrapGlobal(getfpscap, "getfpscap");
+
+        WrapGlobal(createstringbuilder, "createstringbuilder");
+        WrapGlobal(stringbuilderappend, "stringbuilderappend");
+        WrapGlobal(stringbuilderrep, "stringbuilderrep");
+        WrapGlobal(stringbuilderpack, "stringbuilderpack");
+        WrapGlobal(stringbuildertostring, "stringbuildertostring");
+        WrapGlobal(stringbuilderlen, "stringbuilderlen");
+        WrapGlobal(stringbuilderclear, "stringbuilderclear");
+        WrapGlobal(destroystringbuilder, "destroystringbuilder");
+
+        WrapGlobal(createbuffer, "createbuffer");
+        WrapGlobal(bufferread, "bufferread");
+        WrapGlobal(bufferwrite, "bufferwrite");
+        WrapGlobal(bufferreadstring, "bufferreadstring");
+        WrapGlobal(bufferwritestring, "bufferwritestring");
+        WrapGlobal(bufferslice, "bufferslice");
+        WrapGlobal(bufferlen, "bufferlen");
+        WrapGlobal(buffertostring, "buffertostring");
+        WrapGlobal(destroybuffer, "destroybuffer");
+
+        WrapGlobal(createxxhash, "createxxhash");
+        WrapGlobal(xxhashupdate, "xxhashupdate");
+        WrapGlobal(xxhashdigest, "xxhashdigest");
+        WrapGlobal(destroyxxhash, "destroyxxhash");
+
+        WrapGlobal(createcipher, "createcipher");
+        WrapGlobal(cipherupdate, "cipherupdate");
+        WrapGlobal(cipherfinal, "cipherfinal");
+        WrapGlobal(cipheriv, "cipheriv");
+        WrapGlobal(destroycipher, "destroycipher");
 
         WrapGlobal(messageboxasync, "messagebox");
         WrapGlobal(messageboxasync, "messageboxasync");
@@ -5465,15 +9352,20 @@ namespace syn
 				WrapMember(randomstring, "random");
 				WrapMember(derivestring, "derive");
 
-				WrapMemberTable("custom",
-					WrapMember(encryptstringcustom, "encrypt");
-					WrapMember(decryptstringcustom, "decrypt");
-					WrapMember(hashstringcustom, "hash");
+				WrapLazyMemberTable("custom",
+					WrapLazyMember(encryptstringcustom, "encrypt");
+					WrapLazyMember(decryptstringcustom, "decrypt");
+					WrapLazyMember(hashstringcustom, "hash");
 				);
 
-                WrapMemberTable("base64",
-                    WrapMember(base64encode, "encode");
-                    WrapMember(base64decode, "decode");
+                WrapLazyMemberTable("base64",
+                    WrapLazyMember(base64encode, "encode");
+                    WrapLazyMember(base64decode, "decode");
+                );
+
+                WrapLazyMemberTable("xxhash",
+                    WrapLazyMember(xxhash, "hash");
+                    WrapLazyMember(xxhashfile, "file");
                 );
                    
                 /* Copy legacy table */
@@ -5488,10 +9380,44 @@ namespace syn
             WrapMember(getidentity, "get_thread_identity");
             WrapMember(setidentity, "set_thread_identity");
 
+            WrapMember(synwait, "wait");
+            WrapMember(syndefer, "defer");
+            WrapMember(synscriptstats, "scriptstats");
+
+            WrapMember(compressstring, "compress");
+            WrapMember(decompressstring, "decompress");
+
+            WrapMember(packtable, "pack");
+            WrapMember(unpacktable, "unpack");
+
+            WrapLazyMemberTable("json",
+                WrapLazyMember(jsonencode, "encode");
+                WrapLazyMember(jsondecode, "decode");
+            );
+
+            WrapLazyMemberTable("string",
+                WrapLazyMember(stringsplit, "split");
+                WrapLazyMember(stringtrim, "trim");
+                WrapLazyMember(stringstartswith, "startswith");
+                WrapLazyMember(stringendswith, "endswith");
+                WrapLazyMember(stringjoin, "join");
+            );
+
+            WrapLazyMemberTable("table",
+                WrapLazyMember(tableclone, "clone");
+                WrapLazyMember(tableclear, "clear");
+                WrapLazyMember(tablefind, "find");
+            );
+
 			WrapMember(httprequest, "request");
+			WrapMember(httprequestbatch, "request_batch");
 
 			WrapMember(isbeta, "is_beta");
 
+            WrapMember(mountpack, "mount_pack");
+            WrapMember(unmountpack, "unmount_pack");
+            WrapMember(createpack, "create_pack");
+
             WrapMember(cachereplace, "cache_replace");
             WrapMember(cacheinvalidate, "cache_invalidate");
             WrapMember(iscache, "is_cached");
@@ -5500,51 +9426,51 @@ namespace syn
         );
 
 		/* initialise debug.* library */
-        WrapGlobalTable("debug",
+        WrapLazyGlobalTable("debug",
 
             WrapExistingMember("debug", "profilebegin");
             WrapExistingMember("debug", "profileend");
             WrapExistingMember("debug", "traceback");
 
             WrapExistingGlobal("getfenv");
-            WrapMember(getinfo, "getinfo");
-            WrapMember(getstack, "getstack");
-            WrapMember(setstack, "setstack");
-            WrapMember(getupvalue, "getupvalue");
-            WrapMember(getupvalues, "getupvalues");
-            WrapMember(setupvalue, "setupvalue");
-            WrapMember(setupvaluename, "setupvaluename");
-            WrapMember(getlocal, "getlocal");
-            WrapMember(getlocals, "getlocals");
-            WrapMember(setlocal, "setlocal");
-            WrapMember(getconstants, "getconstants");
-            WrapMember(getconstant, "getconstant");
-            WrapMember(setconstant, "setconstant");
-            WrapMember(getreg, "getregistry");
-            WrapMember(getrawmetatable, "getmetatable");
-            WrapMember(setrawmetatable, "setmetatable");
+            WrapLazyMember(getinfo, "getinfo");
+            WrapLazyMember(getstack, "getstack");
+            WrapLazyMember(setstack, "setstack");
+            WrapLazyMember(getupvalue, "getupvalue");
+            WrapLazyMember(getupvalues, "getupvalues");
+            WrapLazyMember(setupvalue, "setupvalue");
+            WrapLazyMember(setupvaluename, "setupvaluename");
+            WrapLazyMember(getlocal, "getlocal");
+            WrapLazyMember(getlocals, "getlocals");
+            WrapLazyMember(setlocal, "setlocal");
+            WrapLazyMember(getconstants, "getconstants");
+            WrapLazyMember(getconstant, "getconstant");
+            WrapLazyMember(setconstant, "setconstant");
+            WrapLazyMember(getreg, "getregistry");
+            WrapLazyMember(getrawmetatable, "getmetatable");
+            WrapLazyMember(setrawmetatable, "setmetatable");
 
             LockTable();
         );
 
 		/* initialise bit.* library */
-        WrapGlobalTable("bit",
-            WrapMember(bitbdiv, "bdiv");
-            WrapMember(bitarshift, "arshift");
-            WrapMember(bitrshift, "rshift");
-            WrapMember(bitbswap, "bswap");
-            WrapMember(bitbor, "bor");
-            WrapMember(bitbnot, "bnot");
-            WrapMember(bitbmul, "bmul");
-            WrapMember(bitbsub, "bsub");
-            WrapMember(bitbxor, "bxor");
-            WrapMember(bittobit, "tobit");
-            WrapMember(bitror, "ror");
-            WrapMember(bitrol, "rol");
-            WrapMember(bitlshift, "lshift");
-            WrapMember(bittohex, "tohex");
-            WrapMember(bitband, "band");
-            WrapMember(bitbadd, "badd");
+        WrapLazyGlobalTable("bit",
+            WrapLazyMember(bitbdiv, "bdiv");
+            WrapLazyMember(bitarshift, "arshift");
+            WrapLazyMember(bitrshift, "rshift");
+            WrapLazyMember(bitbswap, "bswap");
+            WrapLazyMember(bitbor, "bor");
+            WrapLazyMember(bitbnot, "bnot");
+            WrapLazyMember(bitbmul, "bmul");
+            WrapLazyMember(bitbsub, "bsub");
+            WrapLazyMember(bitbxor, "bxor");
+            WrapLazyMember(bittobit, "tobit");
+            WrapLazyMember(bitror, "ror");
+            WrapLazyMember(bitrol, "rol");
+            WrapLazyMember(bitlshift, "lshift");
+            WrapLazyMember(bittohex, "tohex");
+            WrapLazyMember(bitband, "band");
+            WrapLazyMember(bitbadd, "badd");
 
             LockTable();
         );
@@ -13,9 +13,16 @@
 #include "Scheduler.hpp"
 
 #include "../../Utilities/Utils.hpp"
+#include "../../Utilities/Buffer.hpp"
+#include "../../Utilities/HttpPool.hpp"
+#include "../../Utilities/AsyncFile.hpp"
+#include "../../Utilities/WorkspaceCache.hpp"
+#include "../../Utilities/AssetPack.hpp"
+#include "../../Utilities/WorkspacePaths.hpp"
 #include "../../Utilities/Hashing/fnv.hpp"
 
 #include "../Misc/D3D.hpp"
+#include "../Misc/Channel.hpp"
 #include "../Misc/PointerObfuscation.hpp"
 
 
@@ -73,6 +80,25 @@ namespace syn
 
 		int Execute(const std::function<YieldRetFunc()>& YieldedFunction) const;
 
+		/* Parks the thread on the scheduler's timer wheel, it resumes with the seconds actually slept */
+		int Wait(double Seconds) const;
+
+		/* Resumes Thread through the script context with Returns values on top of its stack */
+		static void Resume(RbxLua Thread, int Returns);
+
+		/* Keeps Thread referenced from the registry while nothing else may be holding it */
+		static void Park(RbxLua Thread, bool Parked);
+
+		/* Raises Error on a yielded thread through the script context */
+		static void Raise(RbxLua Thread, const std::string& Error);
+
+		/* Hands a yielded thread's work to the pool without ever blocking. While the pool is at its pending limit the
+		   work waits here, in order, and the thread just stays yielded */
+		static void Dispatch(std::function<void()> Work);
+
+		/* Game thread, once per step, moves waiting work into the pool as it frees up */
+		static void PumpDispatch();
+
 	private:
 		struct RbxThreadRef
 		{
@@ -83,6 +109,43 @@ namespace syn
 		RbxLua L = RbxLua(0);
 	};
 
+	/* A yield made of several native steps, the thread only resumes once after the last one. Then steps run on the
+	   thread pool and ThenOnStep steps on the game thread inside a scheduler step, the first throw raises in Lua:
+	     auto Body = std::make_shared<std::string>();
+	     return RbxYieldChain(RL).Then([=] { *Body = Fetch(); }).Then([=] { Write(*Body); }).Finish(...); */
+	class RbxYieldChain
+	{
+	public:
+		explicit RbxYieldChain(RbxLua _L);
+
+		RbxYieldChain& Then(std::function<void()> Work);
+
+		RbxYieldChain& ThenOnStep(std::function<void(RbxLua)> Work);
+
+		int Finish(YieldRetFunc Returns);
+
+	private:
+		struct Step
+		{
+			bool OnStep;
+			std::function<void()> Pool;
+			std::function<void(RbxLua)> Game;
+		};
+
+		struct State
+		{
+			RbxLua L = RbxLua(0);
+			std::vector<Step> Steps;
+			std::size_t Next = 0;
+			YieldRetFunc Returns;
+		};
+
+		static void Advance(const std::shared_ptr<State>& S);
+
+		RbxLua L = RbxLua(0);
+		std::vector<Step> Steps;
+	};
+
     /* TODO: Why is this a class? It's literally useless, none of this needs to be exposed */
 	class RbxApi
 	{
@@ -109,8 +172,16 @@ namespace syn
 
 		static int httprequest(DWORD rL);
 
+		static int httprequestbatch(DWORD rL);
+
+		static int http_read_request(RbxLua RL, int Index, HttpRequest& Request);
+
+		static void http_push_response(RbxLua RL, const cpr::Response& Response);
+
 		static int loadstring(DWORD rL);
 
+		static int loadstringasync(DWORD rL);
+
 		static int getrawmetatable(DWORD rL);
 
         static int setrawmetatable(DWORD rL);
@@ -183,10 +254,41 @@ namespace syn
 
 		static int getloadedmodules(DWORD rL);
 
+		static int getloadedmodulessince(DWORD rL);
+
 		static int getgc(DWORD rL);
 
+		static int getgciter(DWORD rL);
+
+		static int getgciterhandler(DWORD rL);
+
+		static int scanclosures(DWORD rL);
+
+		/* heapsnapshot() -> id, heapdiff(old [, new]) -> growth per script, heapsnapshotfree(id) */
+		static int heapsnapshot(DWORD rL);
+
+		static int heapdiff(DWORD rL);
+
+		static int heapsnapshotfree(DWORD rL);
+
+		static int finddescendants(DWORD rL);
+
+		static int finddescendantshandler(DWORD rL);
+
 		static int getsenv(DWORD rL);
 
+		/* ModuleScript -> thread index for getsenv, built in one root GC pass and cleared on teleport */
+		static inline std::unordered_map<DWORD, DWORD> ScriptThreads;
+		static inline GCObject* ScriptThreadsHead = nullptr;
+
+		static DWORD script_thread_lookup(RbxLua RL, DWORD Script);
+
+		static void script_thread_invalidate()
+		{
+			ScriptThreads.clear();
+			ScriptThreadsHead = nullptr;
+		}
+
 		static int islclosure(DWORD rL);
 
 		static int issynfunc(DWORD rL);
@@ -320,6 +422,8 @@ namespace syn
 
 		static int decompile(DWORD rL);
 
+		static int decompileall(DWORD rL);
+
 		static int dumpstring(DWORD rL);
 
 		static bool file_path_char_good(char c)
@@ -365,6 +469,20 @@ namespace syn
 
 		static int appendfile(DWORD rL);
 
+		/* Every file API goes through here, see WorkspacePaths */
+		static const char* resolve_workspace_path(const char* Path, size_t Size, bool Writing, WorkspacePaths::Path& Out);
+		static const char* resolve_workspace_path(const std::string& Path, bool Writing, std::wstring& Out);
+
+		static int readfileasync(DWORD rL);
+
+		static int writefileasync(DWORD rL);
+
+		static int mountpack(DWORD rL);
+
+		static int unmountpack(DWORD rL);
+
+		static int createpack(DWORD rL);
+
 		/* connection libraries */
 		static int getconnectionshandler(DWORD rL)
 		{
@@ -383,6 +501,10 @@ namespace syn
 
 		static int firesignal(DWORD rL);
 
+		static int firesignals(DWORD rL);
+
+		static int getconnectionsbulk(DWORD rL);
+
 		//static int firemessageout(DWORD rL);
 
 		//static int createmsgoutstring(DWORD rL);
@@ -408,10 +530,36 @@ namespace syn
 
 		static int decryptstring(DWORD rL);
 
+		static int createcipher(DWORD rL);
+
+		static int cipherupdate(DWORD rL);
+
+		static int cipherfinal(DWORD rL);
+
+		static int cipheriv(DWORD rL);
+
+		static int destroycipher(DWORD rL);
+
+		static void cipher_invalidate();
+
 		static int hashstring(DWORD rL);
 
 		static int hashstringcustom(DWORD rL);
 
+		static int xxhash(DWORD rL);
+
+		static int xxhashfile(DWORD rL);
+
+		static int createxxhash(DWORD rL);
+
+		static int xxhashupdate(DWORD rL);
+
+		static int xxhashdigest(DWORD rL);
+
+		static int destroyxxhash(DWORD rL);
+
+		static void xxhash_invalidate();
+
 		static int randomstring(DWORD rL);
 
 		static int derivestring(DWORD rL);
@@ -420,15 +568,130 @@ namespace syn
 
 		static int base64decode(DWORD rL);
 
+		static int jsonencode(DWORD rL);
+
+		static int jsondecode(DWORD rL);
+
+		static int compressstring(DWORD rL);
+
+		static int decompressstring(DWORD rL);
+
+		static int packtable(DWORD rL);
+
+		static int unpacktable(DWORD rL);
+
+		static int stringsplit(DWORD rL);
+
+		static int stringtrim(DWORD rL);
+
+		static int stringstartswith(DWORD rL);
+
+		static int stringendswith(DWORD rL);
+
+		static int stringjoin(DWORD rL);
+
+		static int tableclone(DWORD rL);
+
+		static int tableclear(DWORD rL);
+
+		static int tablefind(DWORD rL);
+
 		/* render libraries */
 		static int createrenderobject(DWORD rL);
 
+		static const std::unordered_map<std::string, D3DProperty>& render_property_ids();
+
+		static int set_render_property(RbxLua RL, D3DHandle Handle, D3DProperty Property, int Index);
+
 		static int setrenderproperty(DWORD rL);
 
+		static int setrenderpropertybulk(DWORD rL);
+
+		static int getrenderpropertyids(DWORD rL);
+
 		static int getrenderproperty(DWORD rL);
 
 		static int destroyrenderobject(DWORD rL);
 
+		/* sweeprenderobjects(refs), destroys every object whose handle isn't a value in refs and returns the live count */
+		static int sweeprenderobjects(DWORD rL);
+
+		/* setfpscap(fps [, lowlatency]), 0 goes back to Roblox's 60 */
+		static int setfpscap(DWORD rL);
+
+		static int getfpscap(DWORD rL);
+
+		/* string builders, appends go into a C++ buffer and the Lua string is only made once */
+		static inline std::unordered_map<uintptr_t, Buffer> StringBuilders;
+		static inline uintptr_t NextStringBuilder = 0;
+
+		static Buffer* check_string_builder(RbxLua RL, int Index);
+
+		static void string_builder_invalidate()
+		{
+			StringBuilders.clear();
+		}
+
+		static int createstringbuilder(DWORD rL);
+
+		static int stringbuilderappend(DWORD rL);
+
+		static int stringbuilderrep(DWORD rL);
+
+		static int stringbuilderpack(DWORD rL);
+
+		static int stringbuildertostring(DWORD rL);
+
+		static int stringbuilderlen(DWORD rL);
+
+		static int stringbuilderclear(DWORD rL);
+
+		static int destroystringbuilder(DWORD rL);
+
+		/* binary buffers, fixed size storage that slices share instead of copying */
+		struct BinaryBuffer
+		{
+			std::shared_ptr<Buffer> Storage;
+			size_t Offset;
+			size_t Length;
+
+			unsigned char* Data() const { return Storage->data() + Offset; }
+		};
+
+		static inline std::unordered_map<uintptr_t, BinaryBuffer> BinaryBuffers;
+		static inline uintptr_t NextBinaryBuffer = 0;
+
+		/* nullptr unless Index is a buffer handle or a script side Buffer object */
+		static BinaryBuffer* to_binary_buffer(RbxLua RL, int Index);
+
+		static BinaryBuffer* check_binary_buffer(RbxLua RL, int Index);
+
+		/* string or buffer argument, buffers are read in place */
+		static const char* check_bytes(RbxLua RL, int Index, size_t* Len);
+
+		static void binary_buffer_invalidate()
+		{
+			BinaryBuffers.clear();
+		}
+
+		static int createbuffer(DWORD rL);
+
+		static int bufferread(DWORD rL);
+
+		static int bufferwrite(DWORD rL);
+
+		static int bufferreadstring(DWORD rL);
+
+		static int bufferwritestring(DWORD rL);
+
+		static int bufferslice(DWORD rL);
+
+		static int bufferlen(DWORD rL);
+
+		static int buffertostring(DWORD rL);
+
+		static int destroybuffer(DWORD rL);
+
 		static int isredirectionenabled(DWORD rL);
 
 		static int printconsole(DWORD rL);
@@ -453,6 +716,8 @@ namespace syn
 
 		static void reattach_write_pipe(HANDLE Pipe, const std::string& Data)
 		{
+			Channel::GetSingleton()->Send(CM_STATUS, Data);
+
 			DWORD DwWritten;
 			WriteFile(Pipe, (Data + "\n").c_str(), Data.size() + 1, &DwWritten, NULL);
 			FlushFileBuffers(Pipe);
@@ -522,6 +787,22 @@ namespace syn
 
 		static int crash(DWORD rL);
 
+		/* lazy library tables, members are only turned into closures on first index */
+		typedef std::unordered_map<std::string, r_lua_CFunction> LazyLibrary;
+		static inline std::unordered_map<std::string, LazyLibrary> LazyLibraries;
+
+		static void PushLazyLibrary(RbxLua RL, LazyLibrary& Library);
+		static int lazylibraryhandler(DWORD rL);
+
+		/* syn.wait(seconds), resumes on the first scheduler step past the deadline */
+		static int synwait(DWORD rL);
+
+		/* syn.defer(f, ...), runs f on a new thread on the next scheduler step */
+		static int syndefer(DWORD rL);
+
+		/* syn.scriptstats([enable]), per-script resume time and heap change since attach, busiest first */
+		static int synscriptstats(DWORD rL);
+
 		static bool PushLibraries(RbxLua RL, DWORD ORL);
 
 		static void SetDataModel(DWORD DM)
@@ -9,54 +9,133 @@
 
 #include "RbxInstance.hpp"
 
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+
 syn::Instance syn::Instance::GetParent() const
 {
 	BoundsCheckInstance();
 	return *reinterpret_cast<DWORD*>(instance_ptr + 0x34);
 }
 
-std::vector<syn::Instance> syn::Instance::GetChildren() const
+syn::Instance syn::ChildSpan::Iterator::operator*() const
+{
+	return *reinterpret_cast<DWORD*>(Entry);
+}
+
+syn::Instance syn::ChildSpan::operator[](size_t Index) const
+{
+	return *reinterpret_cast<DWORD*>(Start + Index * 8);
+}
+
+syn::ChildSpan syn::Instance::Children() const
 {
 	BoundsCheckInstance();
-	std::vector<Instance> ChildrenVector;
 	const DWORD ChildVector = *reinterpret_cast<DWORD*>(instance_ptr + 44);
 	if (!ChildVector)
-		return ChildrenVector;
+		return ChildSpan(0, 0);
 
-	const DWORD ChildEnd = *reinterpret_cast<DWORD*>(ChildVector + 4);
-	DWORD ChildStart = *reinterpret_cast<DWORD*>(ChildVector);
-	const DWORD ChildMax = *reinterpret_cast<DWORD*>(ChildVector + 4) - (*reinterpret_cast<DWORD*>(ChildVector) >> 3);
-	DWORD ChildCount = 0;
-	for (; ChildStart != ChildEnd; ChildStart += 8)
-	{
-		if (ChildCount == ChildMax)
-			break;
-		ChildCount++;
-		ChildrenVector.emplace_back(*reinterpret_cast<DWORD*>(ChildStart));
-	}
+	return ChildSpan(*reinterpret_cast<DWORD*>(ChildVector), *reinterpret_cast<DWORD*>(ChildVector + 4));
+}
+
+std::vector<syn::Instance> syn::Instance::GetChildren() const
+{
+	const auto Span = Children();
+
+	std::vector<Instance> ChildrenVector;
+	ChildrenVector.reserve(Span.size());
+	for (const auto Child : Span)
+		ChildrenVector.push_back(Child);
 	return ChildrenVector;
 }
 
 syn::Instance syn::Instance::GetChildFromName(const char* InstanceName) const
 {
-	BoundsCheckInstance();
-	std::vector<Instance> ChildrenVector = GetChildren();
-	for (DWORD Child : ChildrenVector)
-		if (!strcmp(GetInstanceName(Child).c_str(), InstanceName))
+	for (const auto Child : Children())
+		if (NameRef(Child) == InstanceName)
 			return Child;
 	return NULL;
 }
 
 syn::Instance syn::Instance::GetChildFromClassName(const char* ClassName) const
 {
-	BoundsCheckInstance();
-	std::vector<Instance> ChildrenVector = GetChildren();
-	for (DWORD Child : ChildrenVector)
-		if (!strcmp(GetInstanceClassName(Child).c_str(), ClassName))
+	/* Class name -> descriptor, filled the first time a class is matched by name */
+	static std::mutex DescriptorMutex;
+	static std::unordered_map<std::string, DWORD> Descriptors;
+
+	DWORD Descriptor = 0;
+	{
+		std::lock_guard<std::mutex> Guard(DescriptorMutex);
+		const auto Found = Descriptors.find(ClassName);
+		if (Found != Descriptors.end())
+			Descriptor = Found->second;
+	}
+
+	for (const auto Child : Children())
+	{
+		if (Descriptor)
+		{
+			if (Child.GetClassDescriptor() == Descriptor)
+				return Child;
+			continue;
+		}
+
+		if (ClassNameRef(Child) == ClassName)
+		{
+			std::lock_guard<std::mutex> Guard(DescriptorMutex);
+			Descriptors.emplace(ClassName, Child.GetClassDescriptor());
 			return Child;
+		}
+	}
 	return NULL;
 }
 
+static std::atomic<std::uint64_t> ScriptContextCache{ 0 };
+
+syn::Instance syn::Instance::GetScriptContext(DWORD DataModel)
+{
+	if (!DataModel)
+		return NULL;
+
+	/* DataModel in the high half, ScriptContext in the low half, so readers never see a torn pair */
+	const auto Cached = ScriptContextCache.load(std::memory_order_acquire);
+	if ((DWORD) (Cached >> 32) == DataModel)
+		return (DWORD) Cached;
+
+	const auto ScriptContext = Instance(DataModel).GetChildFromClassName(OBFUSCATE_STR("ScriptContext"));
+	if (ScriptContext)
+		ScriptContextCache.store((std::uint64_t) DataModel << 32 | (DWORD) ScriptContext, std::memory_order_release);
+
+	return ScriptContext;
+}
+
+void syn::Instance::InvalidateScriptContext()
+{
+	ScriptContextCache.store(0, std::memory_order_release);
+}
+
+/* Reference to the name without copying it, only valid while the instance is alive */
+const std::string& syn::Instance::NameRef(DWORD Inst)
+{
+#ifdef _DEBUG
+	static thread_local std::string Name;
+	return Name = *(const char**)(Inst + 0x28);
+#else
+	return **(std::string**)(Inst + 0x28);
+#endif
+}
+
+const std::string& syn::Instance::ClassNameRef(DWORD Inst)
+{
+#ifdef _DEBUG
+	static thread_local std::string Name;
+	return Name = *(const char**)(*(DWORD*)(Inst + 0xC) + 4);
+#else
+	return **(std::string**)(*(DWORD*)(Inst + 0xC) + 4);
+#endif
+}
+
 /* Use 0 to signify getting the current instance's name */
 std::string syn::Instance::GetInstanceName(DWORD Inst) const
 {
@@ -14,21 +14,68 @@
 
 namespace syn
 {
+	class Instance;
+
+	/* Non-owning view over an instance's child vector, each entry is a shared_ptr (object, control block) */
+	class ChildSpan
+	{
+	public:
+		class Iterator
+		{
+		public:
+			explicit Iterator(DWORD Entry) : Entry(Entry) {}
+
+			Instance operator*() const;
+			Iterator& operator++() { Entry += 8; return *this; }
+			bool operator!=(const Iterator& Other) const { return Entry != Other.Entry; }
+
+		private:
+			DWORD Entry;
+		};
+
+		ChildSpan(DWORD Start, DWORD End) : Start(Start), End(End) {}
+
+		Iterator begin() const { return Iterator(Start); }
+		Iterator end() const { return Iterator(End); }
+		size_t size() const { return (End - Start) / 8; }
+		Instance operator[](size_t Index) const;
+		bool empty() const { return Start == End; }
+
+	private:
+		DWORD Start;
+		DWORD End;
+	};
+
 	class Instance
 	{
 	protected:
 		DWORD instance_ptr;
 
+		static const std::string& NameRef(DWORD Inst);
+		static const std::string& ClassNameRef(DWORD Inst);
+
 	public:
 		Instance GetParent() const;
+		ChildSpan Children() const;
 		std::vector<Instance> GetChildren() const;
 		Instance GetChildFromName(const char* InstanceName) const;
 		Instance GetChildFromClassName(const char* ClassName) const;
 		std::string GetInstanceName(DWORD Inst = 0) const;
 		std::string GetInstanceClassName(DWORD Inst = 0) const;
+
+		/* Name without a copy, only valid while the instance is alive */
+		const std::string& NameView() const { BoundsCheckInstance(); return NameRef(instance_ptr); }
 		bool IsEmpty() const { return !instance_ptr; }
 		bool IsRobloxLocked() const { BoundsCheckInstance(); return *(BYTE*)(instance_ptr + 0x27); }
 		Instance GetLocalPlayer() const { BoundsCheckInstance(); return *(DWORD*)(instance_ptr + 0xC8); }
+
+		/* The class descriptor is a per-class singleton, so it identifies the class without touching the name */
+		DWORD GetClassDescriptor() const { BoundsCheckInstance(); return *(DWORD*)(instance_ptr + 0xC); }
+
+		/* ScriptContext of the given DataModel, looked up once per DataModel */
+		static Instance GetScriptContext(DWORD DataModel);
+		static void InvalidateScriptContext();
+
 		operator DWORD() const { return instance_ptr; }
 		Instance(DWORD Address)
 		{
@@ -482,6 +482,72 @@ namespace syn
         r_decr_top(RState);  /* pop value */
     }
 
+    /* Bumped by GlobalState on every attach, so keys made on a previous state are recreated */
+    static std::atomic<DWORD> KeyEpoch{ 1 };
+
+    /* registry[&KeyAnchor] holds every cached key as key and value, nothing referenced from the registry is collected */
+    static BYTE KeyAnchor;
+
+    DWORD RbxLua::KeyString(const RbxKey& k) const
+    {
+        const auto Epoch = KeyEpoch.load(std::memory_order_acquire);
+        const auto Cached = k.Cached.load(std::memory_order_acquire);
+        if ((DWORD) (Cached >> 32) == Epoch)
+            return (DWORD) Cached;
+
+        PushLightUserData(&KeyAnchor);
+        GetTable(LUA_REGISTRYINDEX);
+        if (!IsTable(-1))
+        {
+            Pop(1);
+            CreateTable(0, 64);
+            PushLightUserData(&KeyAnchor);
+            PushValue(-2);
+            SetTable(LUA_REGISTRYINDEX);
+        }
+
+        PushLString(k.Name, k.Length);
+        const auto String = (DWORD) Index2Adr(-1)->value.gc;
+        PushValue(-1);
+        SetTable(-3);
+        Pop(1);
+
+        k.Cached.store((std::uint64_t) Epoch << 32 | String, std::memory_order_release);
+        return String;
+    }
+
+    void RbxLua::PushK(const RbxKey& k) const
+    {
+        const auto String = KeyString(k);
+        r_setsvalue(*(TValue**)(RState + L_TOP), String);
+        r_incr_top(RState);
+    }
+
+    void RbxLua::GetFieldK(int idx, const RbxKey& k) const
+    {
+        /* Resolved first, making the key pushes to the stack and may move it */
+        const auto String = KeyString(k);
+
+        StkId t;
+        TValue key;
+        t = Index2Adr(idx);
+        r_setsvalue(&key, String);
+        VGetTable(t, &key, *(TValue **)(RState + L_TOP));
+        r_incr_top(RState);
+    }
+
+    void RbxLua::SetFieldK(int idx, const RbxKey& k) const
+    {
+        const auto String = KeyString(k);
+
+        StkId t;
+        TValue key;
+        t = Index2Adr(idx);
+        r_setsvalue(&key, String);
+        VSetTable(t, &key, *(TValue**)(RState + L_TOP) - 1);
+        r_decr_top(RState);  /* pop value */
+    }
+
     int RbxLua::GetTop() const
     {
         return (int)(*(TValue**)(RState + L_TOP) - *(TValue**)(RState + L_BASE));
@@ -1098,7 +1164,11 @@ namespace syn
     uintptr_t RbxLua::GlobalState(uintptr_t RS)
 	{
 		static uintptr_t GState = 0;
-		if (RS) GState = RS;
+		if (RS)
+		{
+			GState = RS;
+			KeyEpoch.fetch_add(1, std::memory_order_acq_rel);
+		}
 		return GState;
 	}
 
@@ -16,6 +16,8 @@
 #include <headers/Detour/x86Detour.hpp>
 #include <headers/Enums.hpp>
 
+#include <atomic>
+
 /* TODO: Move to a separate file once we fully migrate */
 #define r_incr_top(rL) (*(uintptr_t*)((rL) + L_TOP) += sizeof(TValue)) 
 #define r_decr_top(rL) (*(uintptr_t*)((rL) + L_TOP) -= sizeof(TValue)) 
@@ -93,6 +95,20 @@ extern LPVOID OriginalZwFT;
 
 namespace syn
 {
+    /* Address of the game's number xor key, see RbxLua::XorDouble */
+    extern uintptr_t DXorKey;
+
+    /* A field name whose game string is created once per attach and kept alive from the registry, for GetFieldK/SetFieldK
+       on hot paths. Meant to be static, e.g. static const RbxKey WarnKey("warn") */
+    struct RbxKey
+    {
+        explicit RbxKey(const char* Name) : Name(Name), Length(strlen(Name)) {}
+
+        const char* Name;
+        size_t Length;
+        mutable std::atomic<std::uint64_t> Cached{ 0 };    /* attach epoch << 32 | TString address */
+    };
+
     class RbxLua
     {
         static void _PushCFunction(RbxLua* rL, r_lua_CFunction cF);
@@ -111,6 +127,7 @@ namespace syn
         void PushLightUserData(void* p) const;
         void PushLString(const char* s, size_t len) const;
         void PushString(const char* s) const;
+        void PushK(const RbxKey& k) const;
         void PushNil() const;
         void PushThread() const;
         void PushValue(int idx) const;
@@ -120,6 +137,7 @@ namespace syn
         void VGetTable(const TValue* t, TValue* key, StkId val) const;
         void GetTable(int idx) const;
         void GetField(int idx, const char* k) const;
+        void GetFieldK(int idx, const RbxKey& k) const;
         void RawGetI(int Index, int N) const;
         void RawSetI(int idx, int n) const;
         int GetMetaTable(int idx) const;
@@ -136,6 +154,7 @@ namespace syn
         void SetTable(int idx) const;
         int SetMetaTable(int objindex) const;
         void SetField(int idx, const char* k) const;
+        void SetFieldK(int idx, const RbxKey& k) const;
         void SetTop(int idx) const;
         const char* SetUpvalue(int idx, int n) const;
         const char* SetLocal(lua_Debug* ar, int n) const;
@@ -259,6 +278,9 @@ namespace syn
         const char* ToString(int idx) const { return ToLString(idx, 0); };
         void GetGlobal(const char* k) const { GetField(LUA_GLOBALSINDEX, k); };
         void SetGlobal(const char* k) const { SetField(LUA_GLOBALSINDEX, k); };
+        void GetGlobalK(const RbxKey& k) const { GetFieldK(LUA_GLOBALSINDEX, k); };
+        void SetGlobalK(const RbxKey& k) const { SetFieldK(LUA_GLOBALSINDEX, k); };
+        DWORD KeyString(const RbxKey& k) const;
         void NewTable() const { CreateTable(0, 0); };
         void Pop(int n) const { SetTop(-(n)-1); };
         DWORD SNew(const char* s) const { return NewLString(s, strlen(s)); };
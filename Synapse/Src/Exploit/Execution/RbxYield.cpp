@@ -1,12 +1,38 @@
 #include "RbxApi.hpp"
+#include "../Misc/FrameStats.hpp"
+#include "../Misc/ScriptStats.hpp"
+#include "../Misc/Metrics.hpp"
+#include "../../Utilities/ThreadPool.hpp"
 #include <themida/ThemidaSDK.h>
 
 namespace syn
 {
+	/* Work of yielded threads the pool had no room for yet, oldest first */
+	static std::mutex DeferredMutex;
+	static std::deque<std::function<void()>> Deferred;
+
 	RbxYield::RbxYield(RbxLua _L) : L(_L)
 	{
 	}
 
+	void RbxYield::Dispatch(std::function<void()> Work)
+	{
+		std::lock_guard<std::mutex> Guard(DeferredMutex);
+
+		/* Nothing overtakes work that is already waiting */
+		if (Deferred.empty() && syn::ThreadPool::GetSingleton()->TrySubmit(Work))
+			return;
+
+		Deferred.push_back(std::move(Work));
+	}
+
+	void RbxYield::PumpDispatch()
+	{
+		std::lock_guard<std::mutex> Guard(DeferredMutex);
+		while (!Deferred.empty() && syn::ThreadPool::GetSingleton()->TrySubmit(Deferred.front()))
+			Deferred.pop_front();
+	}
+
 	int RbxYield::Execute(const std::function<YieldRetFunc()>& YieldedFunction) const
 	{
 		auto LState = L;
@@ -20,26 +46,23 @@ namespace syn
 		LState.PushThread();
 		LState.SetField(LUA_REGISTRYINDEX, YMS.c_str());
 
-		std::thread([YieldedFunction, LState]
+		syn::Metrics::GetSingleton()->YieldsInFlight++;
+		Dispatch([YieldedFunction, LState]
 		{
 			auto Sched = syn::Scheduler::GetSingleton();
 
 			YieldRetFunc ReturnedFunc;
 			try
 			{
+				PROFILE_ZONE(OBFUSCATE_STR("Yield work"));
 				ReturnedFunc = YieldedFunction();
 			}
 			catch (std::exception& Ex)
 			{
-				Sched->Push([LState, Ex](DWORD)
+				Sched->Push([LState, Error = std::string(Ex.what())](DWORD)
 				{
-					LState.PushString(Ex.what());
-
-					const auto ScriptContext = syn::Instance(DataModel).GetChildFromClassName(
-						OBFUSCATE_STR("ScriptContext"));
-					((int(__thiscall*)(int, int))RobloxBase(OBFUSCATED_NUM(syn::Lua::RbxError)))(ScriptContext, LState);
-
-					LState.Pop(LState.GetTop());
+					syn::Metrics::GetSingleton()->YieldsInFlight--;
+					Raise(LState, Error);
 				});
 
 				return;
@@ -47,19 +70,174 @@ namespace syn
 
 			Sched->Push([ReturnedFunc, LState](DWORD)
 			{
-				const auto Returns = ReturnedFunc(LState);
+				PROFILE_ZONE(OBFUSCATE_STR("Yield resume"));
+				syn::Metrics::GetSingleton()->YieldsInFlight--;
+				Resume(LState, ReturnedFunc(LState));
+			});
+		});
 
-				RbxThreadRef Ref{};
-				Ref.L = LState;
+		*(BYTE*)(L - 36) |= 1;
+		return L.RYield(0);
+	}
 
-				const auto ScriptContext = syn::Instance(DataModel).GetChildFromClassName(
-					OBFUSCATE_STR("ScriptContext"));
-				((int(__thiscall*)(int, RbxThreadRef*, int))RobloxBase(OBFUSCATED_NUM(syn::Lua::RbxResume)))(
-					ScriptContext, &Ref, Returns);
-			});
-		}).detach();
+	int RbxYield::Wait(const double Seconds) const
+	{
+		const auto LState = L;
+		const auto Start = syn::FrameStats::Now();
+
+		Park(LState, true);
+		syn::Scheduler::GetSingleton()->After(Seconds, [LState, Start](DWORD)
+		{
+			PROFILE_ZONE(OBFUSCATE_STR("Wait resume"));
+			Park(LState, false);
+
+			LState.PushNumber((syn::FrameStats::Now() - Start) / 1000000.0);
+			Resume(LState, 1);
+		});
+
+		*(BYTE*)(L - 36) |= 1;
+		return L.RYield(0);
+	}
+
+	void RbxYield::Resume(const RbxLua Thread, const int Returns)
+	{
+		RbxThreadRef Ref{};
+		Ref.L = Thread;
+
+		const auto ScriptContext = syn::Instance::GetScriptContext(DataModel);
+		const syn::ScriptStats::Scope Measure(Thread);
+		((int(__thiscall*)(int, RbxThreadRef*, int))RobloxBase(OBFUSCATED_NUM(syn::Lua::RbxResume)))(
+			ScriptContext, &Ref, Returns);
+	}
+
+	void RbxYield::Raise(const RbxLua Thread, const std::string& Error)
+	{
+		Thread.PushString(Error.c_str());
+
+		const auto ScriptContext = syn::Instance::GetScriptContext(DataModel);
+		((int(__thiscall*)(int, int))RobloxBase(OBFUSCATED_NUM(syn::Lua::RbxError)))(ScriptContext, Thread);
+
+		Thread.Pop(Thread.GetTop());
+	}
+
+	RbxYieldChain::RbxYieldChain(RbxLua _L) : L(_L)
+	{
+	}
+
+	RbxYieldChain& RbxYieldChain::Then(std::function<void()> Work)
+	{
+		Steps.push_back(Step{ false, std::move(Work), nullptr });
+		return *this;
+	}
+
+	RbxYieldChain& RbxYieldChain::ThenOnStep(std::function<void(RbxLua)> Work)
+	{
+		Steps.push_back(Step{ true, nullptr, std::move(Work) });
+		return *this;
+	}
+
+	int RbxYieldChain::Finish(YieldRetFunc Returns)
+	{
+		const auto S = std::make_shared<State>();
+		S->L = L;
+		S->Steps = std::move(Steps);
+		S->Returns = std::move(Returns);
+
+		RbxYield::Park(L, true);
+		syn::Metrics::GetSingleton()->YieldsInFlight++;
+		Advance(S);
 
 		*(BYTE*)(L - 36) |= 1;
 		return L.RYield(0);
 	}
+
+	void RbxYieldChain::Advance(const std::shared_ptr<State>& S)
+	{
+		const auto Sched = syn::Scheduler::GetSingleton();
+
+		if (S->Next == S->Steps.size())
+		{
+			Sched->Push([S](DWORD)
+			{
+				PROFILE_ZONE(OBFUSCATE_STR("Yield resume"));
+				syn::Metrics::GetSingleton()->YieldsInFlight--;
+				RbxYield::Park(S->L, false);
+				RbxYield::Resume(S->L, S->Returns(S->L));
+			});
+
+			return;
+		}
+
+		/* Steps is never touched again once Finish moved it in, so the reference stays valid */
+		const auto& Current = S->Steps[S->Next++];
+		const auto Fail = [S](const std::exception& Ex)
+		{
+			syn::Scheduler::GetSingleton()->Push([S, Error = std::string(Ex.what())](DWORD)
+			{
+				syn::Metrics::GetSingleton()->YieldsInFlight--;
+				RbxYield::Park(S->L, false);
+				RbxYield::Raise(S->L, Error);
+			});
+		};
+
+		if (Current.OnStep)
+		{
+			Sched->Push([S, &Current, Fail](DWORD)
+			{
+				try
+				{
+					PROFILE_ZONE(OBFUSCATE_STR("Yield step"));
+					Current.Game(S->L);
+				}
+				catch (const std::exception& Ex)
+				{
+					Fail(Ex);
+					return;
+				}
+
+				Advance(S);
+			});
+		}
+		else
+		{
+			RbxYield::Dispatch([S, &Current, Fail]
+			{
+				try
+				{
+					PROFILE_ZONE(OBFUSCATE_STR("Yield work"));
+					Current.Pool();
+				}
+				catch (const std::exception& Ex)
+				{
+					Fail(Ex);
+					return;
+				}
+
+				Advance(S);
+			});
+		}
+	}
+
+	void RbxYield::Park(const RbxLua Thread, const bool Parked)
+	{
+		/* registry[Key][thread] = true, done on the thread's own stack so nothing is left behind */
+		static const auto Key = RandomString(16);
+
+		Thread.GetField(LUA_REGISTRYINDEX, Key.c_str());
+		if (!Thread.IsTable(-1))
+		{
+			Thread.Pop(1);
+			Thread.NewTable();
+			Thread.PushValue(-1);
+			Thread.SetField(LUA_REGISTRYINDEX, Key.c_str());
+		}
+
+		Thread.PushThread();
+		if (Parked)
+			Thread.PushBoolean(true);
+		else
+			Thread.PushNil();
+		Thread.SetTable(-3);
+		Thread.Pop(1);
+	}
 }
@@ -6,6 +6,11 @@
 #include "../Security/AntiTamper.hpp"
 #include "../Security/AntiDebug.hpp"
 #include "../Misc/PointerObfuscation.hpp"
+#include "../Misc/FrameStats.hpp"
+#include "../Misc/ScriptStats.hpp"
+#include "../Misc/Metrics.hpp"
+#include "../Misc/Flags.hpp"
+#include "../../Utilities/ThreadPool.hpp"
 #include "../../Utilities/MemSpoofer.hpp"
 #include "../Security/MemCheck.hpp"
 #include "../../Utilities/FakeMemoryHasher.hpp"
@@ -18,40 +23,21 @@ bool i_scheduler_onteleport(syn::Scheduler* scheduler)
 	syn::LastDataModel = syn::DataModel;
 	if (was_zero)
 		return false;
+	PROFILE_ZONE(OBFUSCATE_STR("Scheduler teleport"));
 	syn::Profiler::GetSingleton()->AddProfile("Teleport start");
 	syn::Teleported = true;
+	syn::RbxApi::script_thread_invalidate();
+	syn::RbxApi::string_builder_invalidate();
+	syn::RbxApi::binary_buffer_invalidate();
+	syn::RbxApi::xxhash_invalidate();
+	syn::RbxApi::cipher_invalidate();
+	syn::Instance::InvalidateScriptContext();
+	scheduler->ClearTimers();
+	syn::ScriptStats::GetSingleton()->Reset();
+	syn::WorkspaceCache::GetSingleton()->Flush();
 
 #pragma region Teleport D3D Clear
-	auto D3D = syn::D3D::GetSingleton();
-	std::vector<D3DObject*> RenderClearList{};
-	for (auto Obj : D3D->RenderChain)
-		RenderClearList.push_back(Obj);
-	for (auto Obj : RenderClearList)
-		D3D->RemoveFromRenderList(Obj);
-	for (auto Obj : RenderClearList)
-	{
-		switch (Obj->Header.Type)
-		{
-			case D3_LINE:
-				delete reinterpret_cast<D3DLine*>(Obj->Ptr);
-				break;
-			case D3_TEXT:
-			{
-				const auto Text = reinterpret_cast<D3DText*>(Obj->Ptr);
-				delete Text->Text;
-				delete Text;
-				break;
-			}
-			case D3_CIRCLE:
-				delete reinterpret_cast<D3DCircle*>(Obj->Ptr);
-				break;
-			case D3_SQUARE:
-				delete reinterpret_cast<D3DSquare*>(Obj->Ptr);
-				break;
-		}
-
-		delete Obj;
-	}
+	syn::D3D::GetSingleton()->TeleportRenderObjects();
 #pragma endregion
 
 	syn::PipeHandle = CreateFile(TEXT(OBFUSCATE_STR("\\\\.\\pipe\\SynapseInteract")),
@@ -68,10 +54,11 @@ bool i_scheduler_initialize(syn::Scheduler* sh)
 	using namespace syn;
 	VM_TIGER_WHITE_START;
 
-	DWORD scriptContext = syn::Instance(syn::DataModel).GetChildFromClassName(OBFUSCATE_STR("ScriptContext"));
+	DWORD scriptContext = syn::Instance::GetScriptContext(syn::DataModel);
 	if (!scriptContext || *(DWORD*)(scriptContext + 872) == 1) //check core key for initialization (if this is set, cKey is set as well)
 		return false;
 
+	PROFILE_ZONE(OBFUSCATE_STR("Scheduler initialize"));
 	syn::Profiler::GetSingleton()->AddProfile("Scheduler init start");
 
 	DWORD scriptState = syn::PointerObfuscation::DeObfuscateScriptState(scriptContext + OBFUSCATED_NUM(164));
@@ -85,6 +72,7 @@ bool i_scheduler_initialize(syn::Scheduler* sh)
 	prof->AddProfile(OBFUSCATE_STR("Set DKey"));
 
 	syn::LuaTranslator::GetSingleton()->SetDecodeKey(cKey);
+	syn::ScriptStats::GetSingleton()->SetGlobalState(globalState);
 
 	prof->AddProfile(OBFUSCATE_STR("GlobalState setup"));
 	syn::RbxLua::GlobalState(scriptState);
@@ -206,6 +194,13 @@ bool i_scheduler_initialize(syn::Scheduler* sh)
 	LSState.SetIdentity(6);
 
 	sh->MainThread = LSState;
+#if defined(EnableHSVM) || defined(EnableHSVMOnlyLuaU)
+	sh->Push([](DWORD nRL)
+	{
+		if (!syn::HSVM::Calibrate(nRL))
+			syn::Profiler::GetSingleton()->AddProfile(OBFUSCATE_STR("HSVM inline caches disabled, table layout not found"));
+	});
+#endif
 	sh->Push([](DWORD nRL)
 	{
 		syn::Profiler::GetSingleton()->AddProfile(OBFUSCATE_STR("Syn push libs"));
@@ -214,7 +209,13 @@ bool i_scheduler_initialize(syn::Scheduler* sh)
 
 	syn::InitScript->Process();
 #ifndef EnableLuaUTranslator
-	sh->Push(syn::InitScript->Get());
+	{
+		/* Compiled once per process and pinned in the proto cache, reattaching after a teleport only converts */
+		auto Init = syn::InitScript->Get();
+		prof->AddProfile(OBFUSCATE_STR("InitScript precompile"));
+		syn::LuaTranslator::GetSingleton()->Precompile(Init, syn::SM_SOURCE, true);
+		sh->Push(std::move(Init), syn::SM_SOURCE);
+	}
 #endif
 	syn::InitScript->Process();
 
@@ -222,22 +223,58 @@ bool i_scheduler_initialize(syn::Scheduler* sh)
 
 	if (std::filesystem::is_directory(AutoExec))
 	{
-		for (const auto& File : std::filesystem::directory_iterator(AutoExec))
+		/* Files are read and compiled into the proto cache on the pool while the init script runs. Each load queues
+		   a drain on the job thread, which pushes every loaded script in directory order through its own compile
+		   lane, the one the init script went down, so only the conversion is left here */
+		struct AutoExecLoad
 		{
-			std::ifstream Stream(File.path(), std::ios_base::binary);
-			std::string Final((std::istreambuf_iterator<char>(Stream)),
-				std::istreambuf_iterator<char>());
+			std::vector<std::wstring> Paths;
+			std::vector<std::string> Scripts;
+			std::unique_ptr<std::atomic<bool>[]> Loaded;
+			std::size_t Next = 0;
+			DWORD Model = 0;
+			std::mutex Mutex;
+		};
+
+		const auto Load = std::make_shared<AutoExecLoad>();
+		for (const auto& File : std::filesystem::directory_iterator(AutoExec))
+			Load->Paths.push_back(File.path().wstring());
 
-			VM_TIGER_WHITE_START
+		Load->Scripts.resize(Load->Paths.size());
+		Load->Loaded.reset(new std::atomic<bool>[Load->Paths.size()]());
+		Load->Model = syn::DataModel;
 
-			if (!SecureLuaFlag)
+		for (std::size_t i = 0; i < Load->Paths.size(); i++)
+		{
+			syn::ThreadPool::GetSingleton()->Post([Load, i]
 			{
-				ScriptRunCounter++;
+				auto& Script = Load->Scripts[i];
+				Script = ReadFileToString(Load->Paths[i]);
+				syn::LuaTranslator::GetSingleton()->Precompile(Script, syn::LuaTranslator::IsPrecompiled(Script) ? syn::SM_BYTECODE : syn::SM_SOURCE);
+				Load->Loaded[i].store(true, std::memory_order_release);
 
-				sh->Push(Final);
-			}
-
-			VM_TIGER_WHITE_END
+				syn::Scheduler::GetSingleton()->Push([Load](DWORD)
+				{
+					std::lock_guard<std::mutex> Lock(Load->Mutex);
+					for (; Load->Next < Load->Paths.size() && Load->Loaded[Load->Next].load(std::memory_order_acquire); Load->Next++)
+					{
+						auto& Final = Load->Scripts[Load->Next];
+
+						VM_TIGER_WHITE_START
+
+						/* Teleported before we got here, the next initialize loads them again */
+						if (!SecureLuaFlag && syn::DataModel == Load->Model)
+						{
+							ScriptRunCounter++;
+
+							const auto Mode = syn::LuaTranslator::IsPrecompiled(Final) ? syn::SM_BYTECODE : syn::SM_SOURCE;
+							syn::Scheduler::GetSingleton()->Push(std::move(Final), Mode);
+						}
+
+						VM_TIGER_WHITE_END
+					}
+				});
+			});
 		}
 	}
 
@@ -255,6 +292,9 @@ bool i_scheduler_initialize(syn::Scheduler* sh)
 
 void syn::Scheduler::StepSchedule()
 {
+	ConsoleOutput.Flush();
+	syn::D3D::GetSingleton()->PublishScene();
+
 	if (!syn::DataModel)
 		syn::RbxApi::SetDataModel(syn::RbxApi::GetDataModel());
 	if (!syn::DataModel)
@@ -269,6 +309,8 @@ void syn::Scheduler::StepSchedule()
 			return;
 
 	sh->Step++;
+	syn::RbxYield::PumpDispatch();
+
 	if (sh->Step % 300 == 0) 
 	{
 		if (syn::AntiDebug::Check())
@@ -277,14 +319,48 @@ void syn::Scheduler::StepSchedule()
 			CrashRoblox(true, OBFUSCATE_STR("AntiDebug - #5.5"));
 	}
 
+	if (!sh->Timers.empty())
+	{
+		sh->Timers.advance(TimerTick(), [sh](std::function<void(DWORD)>&& Fn)
+		{
+			sh->DueTimers.emplace_back(std::move(Fn));
+		});
+	}
+
+	/* Backlog at the start of the step, before this step's budget eats into it */
+	const auto Counters = syn::Metrics::GetSingleton();
+	Counters->QueueDepth.store(sh->Count(), std::memory_order_relaxed);
+	Counters->HeapBytes.store(syn::ScriptStats::GetSingleton()->TotalBytes(), std::memory_order_relaxed);
+
 	if (sh->Empty())
 		return;
 
-	while (!sh->Empty())
+	static LARGE_INTEGER Frequency{};
+	if (!Frequency.QuadPart)
+		QueryPerformanceFrequency(&Frequency);
+
+	LARGE_INTEGER Start;
+	QueryPerformanceCounter(&Start);
+
+	const auto OverBudget = [sh, &Start]()
+	{
+		LARGE_INTEGER Now;
+		QueryPerformanceCounter(&Now);
+		return (Now.QuadPart - Start.QuadPart) * 1000000 / Frequency.QuadPart >= sh->StepBudget;
+	};
+
+	/* Always run at least one task, even with no budget at all, stop once the step budget is spent */
+	Task ToRun;
+	for (auto First = true; (First || !OverBudget()) && sh->Pop(ToRun); First = false)
 	{
-		Task ToRun = sh->Pop();
+		if (ToRun.Queued)
+		{
+			static const auto QueueWait = syn::Profiler::GetSingleton()->Zone(OBFUSCATE_STR("Scheduler queue wait"));
+			syn::Profiler::GetSingleton()->Record(QueueWait, ToRun.Queued, syn::Profiler::Now());
+		}
 
-		syn::Profiler::GetSingleton()->AddProfile(OBFUSCATE_STR("Scheduler run task"));
+		PROFILE_ZONE(OBFUSCATE_STR("Scheduler run task"));
+		syn::Metrics::GetSingleton()->TasksRun.fetch_add(1, std::memory_order_relaxed);
 
 		if (ToRun.isC)
 			ToRun.FunctionValue(sh->MainThread);
@@ -309,11 +385,16 @@ void syn::Scheduler::StepSchedule()
 					VM_DOLPHIN_BLACK_END;
 				}
 
-				syn::Profiler::GetSingleton()->AddProfile(OBFUSCATE_STR("Scheduler run script"));
+				PROFILE_ZONE(OBFUSCATE_STR("Scheduler run script"));
 #ifdef EnableLuaUTranslator
 				LuaU_MagicMul = 227;
 #endif
-				syn::RbxLua Sthread = syn::LuaTranslator::GetSingleton()->Convert(sh->MainThread, ToRun.ScriptValue, ToRun.ScriptMode, nullptr);
+				/* Prepared under an older decode key (teleported since) is compiled again here */
+				const auto Translator = syn::LuaTranslator::GetSingleton();
+				syn::RbxLua Sthread = ToRun.Prepared && ToRun.Prepared->KeyGeneration == Translator->KeyGeneration.load(std::memory_order_acquire)
+					? Translator->Convert(sh->MainThread, *ToRun.Prepared)
+					: Translator->Convert(sh->MainThread, ToRun.ScriptValue, ToRun.ScriptMode, nullptr);
+				ToRun.Prepared.reset();
 #ifdef EnableLuaUTranslator
 				LuaU_MagicMul = 1;
 #endif
@@ -327,25 +408,96 @@ void syn::Scheduler::StepSchedule()
 				RbxThreadRef Ref{};
 				Ref.L = Sthread;
 
-				const auto ScriptContext = syn::Instance(DataModel).GetChildFromClassName(OBFUSCATE_STR("ScriptContext"));
+				const auto ScriptContext = syn::Instance::GetScriptContext(DataModel);
 				static DWORD RResume = 0;
 
 				if (!RResume)
 					RResume = RobloxBase(syn::Lua::RbxResume);
 
+				syn::ScriptStats::GetSingleton()->Register(Sthread, ToRun.ScriptValue);
 				MSpoofCallback();
 
+				const syn::ScriptStats::Scope Measure(Sthread);
 				((int(__thiscall*)(int, RbxThreadRef*, int))RResume)(ScriptContext, &Ref, 0);
-				syn::Profiler::GetSingleton()->AddProfile(OBFUSCATE_STR("Scheduler finish script exec"));
 			}
 			catch (const std::exception& ex)
 			{
-				sh->MainThread.GetGlobal("warn");
+				static const syn::RbxKey KeyWarn("warn");
+				sh->MainThread.GetGlobalK(KeyWarn);
 				sh->MainThread.PushString(ex.what());
 				sh->MainThread.PCall(1, 0, 0);
 			}
 		}
 	}
+
+	const auto Stats = syn::FrameStats::GetSingleton();
+	if (Stats->Enabled)
+	{
+		LARGE_INTEGER End;
+		QueryPerformanceCounter(&End);
+		Stats->Record(syn::FS_STEP_SCHEDULE, (float) ((End.QuadPart - Start.QuadPart) * 1000000 / Frequency.QuadPart));
+	}
+}
+
+void syn::Scheduler::Compile(Task&& Value)
+{
+	auto& Lane = Lanes[std::hash<std::thread::id>()(std::this_thread::get_id()) % Lanes.size()];
+
+	/* Nothing to translate against before the first initialize, and the SecureLua agent is rewritten on the job thread */
+	const auto Prepare = synf::UseCompilePipeline
+		&& syn::LuaTranslator::GetSingleton()->KeyGeneration.load(std::memory_order_acquire) != 0
+		&& Value.ScriptValue.rfind(OBFUSCATE_STR("\\SX_SLUA_"), 0) != 0;
+
+	std::shared_ptr<PendingCompile> Pending;
+	{
+		std::lock_guard<std::mutex> Guard(Lane.Mutex);
+
+		if (!Prepare && Lane.Queue.empty())
+		{
+			ScriptQueue.enqueue(std::move(Value));
+			return;
+		}
+
+		Pending = std::make_shared<PendingCompile>();
+		Pending->Value = std::move(Value);
+		Pending->Done = !Prepare;
+		Lane.Queue.push_back(Pending);
+		Compiling.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	if (!Prepare)
+		return;
+
+	syn::ThreadPool::GetCompilePool()->Post([this, &Lane, Pending]
+	{
+		{
+			PROFILE_ZONE(OBFUSCATE_STR("Scheduler compile"));
+
+			try
+			{
+				Pending->Value.Prepared = syn::LuaTranslator::GetSingleton()->PrepareChunk(Pending->Value.ScriptValue, Pending->Value.ScriptMode);
+			}
+			catch (const std::exception&)
+			{
+				/* Left unprepared, the job thread compiles it again and warns with the error */
+			}
+		}
+
+		std::lock_guard<std::mutex> Guard(Lane.Mutex);
+		Pending->Done = true;
+
+		while (!Lane.Queue.empty() && Lane.Queue.front()->Done)
+		{
+			ScriptQueue.enqueue(std::move(Lane.Queue.front()->Value));
+			Lane.Queue.pop_front();
+			Compiling.fetch_sub(1, std::memory_order_relaxed);
+		}
+	});
+}
+
+std::uint64_t syn::Scheduler::TimerTick()
+{
+	return (std::uint64_t) (syn::FrameStats::Now() / 1000.0);
 }
 
 void syn::Scheduler::Attach()
@@ -18,18 +18,38 @@
 
 #include <queue>
 #include "../Misc/Profiler.hpp"
-#include "../../Utilities/SafeQueue.hpp"
+#include "../../Utilities/MPSCQueue.hpp"
+#include "../../Utilities/TimerWheel.hpp"
+
+#include <array>
+#include <cmath>
+#include <deque>
+#include <mutex>
 
 namespace syn
 {
 	class Task
 	{
 	public:
-		bool isC;
-		std::uint8_t ScriptMode;
+		bool isC = false;
+		std::uint8_t ScriptMode = 0;
 		std::string ScriptValue;
 		std::function<void(DWORD)> FunctionValue;
 
+		/* QPC stamp from Push while tracing, 0 otherwise */
+		LONGLONG Queued = 0;
+
+		/* Filled in by the compile stage, the job thread only commits it */
+		std::shared_ptr<LuaTranslator::PreparedChunk> Prepared;
+
+		Task() = default;
+
+		/* Tasks are only ever moved through the scheduler queue */
+		Task(const Task&) = delete;
+		Task& operator=(const Task&) = delete;
+		Task(Task&&) = default;
+		Task& operator=(Task&&) = default;
+
 		Task(const std::string& Script, const std::uint8_t Mode = 0)
 		{
 			ScriptValue = Script;
@@ -37,6 +57,13 @@ namespace syn
 			isC = false;
 		}
 
+		Task(std::string&& Script, const std::uint8_t Mode)
+		{
+			ScriptValue = std::move(Script);
+			ScriptMode = Mode;
+			isC = false;
+		}
+
 		Task(std::function<void(DWORD)> Function)
 		{
 			FunctionValue = std::move(Function);
@@ -49,7 +76,41 @@ namespace syn
 	class Scheduler
 	{
 	private:
-		syn::SafeQueue<Task> ScriptQueue;
+		/* Function tasks (yield resumptions, callbacks) always run before new script compiles */
+		syn::MPSCQueue<Task> ResumeQueue;
+		syn::MPSCQueue<Task> ScriptQueue;
+
+		/* Sleeping continuations on millisecond ticks, game thread only. Expired ones wait in DueTimers for budget */
+		syn::TimerWheel<std::function<void(DWORD)>> Timers;
+		std::deque<Task> DueTimers;
+
+		/* Script tasks go through the compile pool before ScriptQueue. A producer thread always maps to the same lane and
+		   a lane only hands over its finished prefix, so one producer's scripts run in push order while different
+		   scripts compile side by side */
+		struct PendingCompile
+		{
+			Task Value;
+			bool Done = false;
+		};
+
+		struct CompileLane
+		{
+			std::mutex Mutex;
+			std::deque<std::shared_ptr<PendingCompile>> Queue;
+		};
+
+		std::array<CompileLane, 16> Lanes;
+		std::atomic<unsigned int> Compiling{ 0 };
+
+		/* Queues a script task behind its producer's lane, compiled on the pool once the translator has a key */
+		void Compile(Task&& Value);
+
+		static Task&& Stamp(Task&& Value)
+		{
+			if (Profiler::GetSingleton()->Tracing.load(std::memory_order_relaxed))
+				Value.Queued = Profiler::Now();
+			return std::move(Value);
+		}
 
 	public:
 		static void StepSchedule();
@@ -61,6 +122,12 @@ namespace syn
 		int Step = 0;
 		bool Initialized = false;
 
+		/* Time budget for a single step in microseconds, leftover tasks carry over to the next step */
+		std::uint32_t StepBudget = 4000;
+
+		/* Milliseconds on the QPC clock, the timer wheel's tick */
+		static std::uint64_t TimerTick();
+
 		static Scheduler* GetSingleton()
 		{
 			static Scheduler* scheduler = nullptr;
@@ -71,41 +138,81 @@ namespace syn
 
 		unsigned int Count()
 		{
-			return ScriptQueue.size();
+			return DueTimers.size() + ResumeQueue.size() + ScriptQueue.size() + Compiling.load(std::memory_order_relaxed);
 		}
 
-		Task Pop()
+		bool Pop(Task& Out)
 		{
-			return ScriptQueue.dequeue();
+			if (!DueTimers.empty())
+			{
+				Out = std::move(DueTimers.front());
+				DueTimers.pop_front();
+				return true;
+			}
+
+			return ResumeQueue.try_dequeue(Out) || ScriptQueue.try_dequeue(Out);
+		}
+
+		/* Runs FunctionValue on the first step at least Seconds from now, game thread only */
+		void After(const double Seconds, std::function<void(DWORD)> FunctionValue)
+		{
+			const auto Now = TimerTick();
+			if (Timers.empty())
+				Timers.reset(Now);
+
+			Timers.add(Now + (std::uint64_t) std::ceil((Seconds > 0 ? Seconds : 0) * 1000.0), std::move(FunctionValue));
+		}
+
+		/* Threads parked on the old state are gone after a teleport */
+		void ClearTimers()
+		{
+			Timers.reset(TimerTick());
+			DueTimers.clear();
 		}
 
 		void Push(const std::string& Script)
 		{
-			syn::Profiler::GetSingleton()->AddProfile(OBFUSCATE_STR("Scheduler push script"));
-			ScriptQueue.enqueue({ Script });
+			PROFILE_ZONE(OBFUSCATE_STR("Scheduler push script"));
+			Compile(Stamp(Task(Script)));
 		}
 
 		void Push(const std::string& Script, const std::uint8_t Mode)
 		{
-			syn::Profiler::GetSingleton()->AddProfile(OBFUSCATE_STR("Scheduler push script"));
-			ScriptQueue.enqueue({ Script, Mode });
+			PROFILE_ZONE(OBFUSCATE_STR("Scheduler push script"));
+			Compile(Stamp(Task(Script, Mode)));
+		}
+
+		/* Takes the caller's buffer, large scripts from IPC aren't copied again */
+		void Push(std::string&& Script, const std::uint8_t Mode)
+		{
+			PROFILE_ZONE(OBFUSCATE_STR("Scheduler push script"));
+			Compile(Stamp(Task(std::move(Script), Mode)));
 		}
 
 		void Push(std::function<void(DWORD)> FunctionValue)
 		{
-			syn::Profiler::GetSingleton()->AddProfile(OBFUSCATE_STR("Scheduler push function"));
-			ScriptQueue.enqueue(std::move(FunctionValue));
+			PROFILE_ZONE(OBFUSCATE_STR("Scheduler push function"));
+			ResumeQueue.enqueue(Stamp(Task(std::move(FunctionValue))));
 		}
 
 		void Clear()
 		{
 			syn::Profiler::GetSingleton()->AddProfile(OBFUSCATE_STR("Scheduler clear"));
+			ResumeQueue.clear();
 			ScriptQueue.clear();
+
+			/* Compiles still running finish into a lane entry nobody holds any more */
+			for (auto& Lane : Lanes)
+			{
+				std::lock_guard<std::mutex> Guard(Lane.Mutex);
+				Compiling.fetch_sub((unsigned int) Lane.Queue.size(), std::memory_order_relaxed);
+				Lane.Queue.clear();
+			}
 		}
 
 		bool Empty()
 		{
-			return !ScriptQueue.size();
+			return DueTimers.empty() && ResumeQueue.empty() && ScriptQueue.empty();
 		}
 
 		void Attach();
@@ -4,6 +4,7 @@
  */
 
 #include "./HSVM.hpp"
+#include "./HSVMProfiler.hpp"
 #include "./VMBase.hpp"
 
 #include "../RbxLua.hpp"
@@ -12,6 +13,7 @@
 #include "../../../Source Dependencies/Lua/lvm.h"
 #include "../../Misc/Structures.hpp"
 #include "../../Misc/PointerObfuscation.hpp"
+#include "../../Misc/Flags.hpp"
 #include "../Conversion/RbxLuauConversion.hpp"
 #include "../Scheduler.hpp"
 #include "../RbxApi.hpp"
@@ -68,17 +70,152 @@ uint32_t OriginalLuaUDispatcher;
 
 #define runtime_check(L, c)	{ if (!(c)) break; }
 
+/* Same as RbxLua::XorDouble, with the key loaded once per Execute instead of per operand */
+static __forceinline lua_Number xor_num(const lua_Number n, const uint64_t key)
+{
+	uint64_t u;
+	memcpy(&u, &n, sizeof(u));
+	u ^= key;
+
+	lua_Number r;
+	memcpy(&r, &u, sizeof(r));
+	return r;
+}
+
 #define arith_op(op,tm) { \
         TValue *rb = RKB(i); \
         TValue *rc = RKC(i); \
         if (ttype(rb) == R_LUA_TNUMBER && ttype(rc) == R_LUA_TNUMBER) { \
-          lua_Number nb = SL.XorDouble(nvalue(rb)), nc = SL.XorDouble(nvalue(rc)); \
-          r_setnvalue(ra, SL.XorDouble(op(nb, nc))); \
+          lua_Number nb = xor_num(nvalue(rb), numkey), nc = xor_num(nvalue(rc), numkey); \
+          r_setnvalue(ra, xor_num(op(nb, nc), numkey)); \
         } \
         else \
           Protect(SL.VArith(ra, rb, rc, tm)); \
       }
 
+/* ADD/SUB/MUL/DIV of two numbers, false without touching ra for anything else */
+static __forceinline bool num_arith(const Instruction i, StkId base, TValue* k, const uint64_t numkey)
+{
+	const auto op = GET_OPCODE(i);
+	if (op < OpCode::OP_ADD || op > OpCode::OP_DIV)
+		return false;
+
+	TValue* rb = RKB(i);
+	TValue* rc = RKC(i);
+	if (ttype(rb) != R_LUA_TNUMBER || ttype(rc) != R_LUA_TNUMBER)
+		return false;
+
+	const lua_Number nb = xor_num(nvalue(rb), numkey), nc = xor_num(nvalue(rc), numkey);
+	lua_Number res;
+	switch (op)
+	{
+		case OpCode::OP_ADD: res = luai_numadd(nb, nc); break;
+		case OpCode::OP_SUB: res = luai_numsub(nb, nc); break;
+		case OpCode::OP_MUL: res = luai_nummul(nb, nc); break;
+		default: res = luai_numdiv(nb, nc); break;
+	}
+
+	StkId ra = RA(i);
+	r_setnvalue(ra, xor_num(res, numkey));
+	return true;
+}
+
+/*
+ * Superinstruction for hot pairs: after LOADK/MOVE/FORLOOP, a numeric ADD/SUB/MUL/DIV that follows is run
+ * in place without going back through the dispatch switch. Anything else falls through to the normal loop.
+ * The fused instruction still counts towards the opcode histogram while a proto is being profiled.
+ */
+static __forceinline bool fuse_arith(Instruction*& pc, StkId base, TValue* k, const uint64_t numkey,
+	syn::HSVM::Instrumentation* Instr, syn::HSVM::ProfiledProto* Profiled)
+{
+	if (!num_arith(*pc, base, k, numkey))
+		return false;
+
+	if constexpr (synf::UseHSVMInstrumentation)
+	{
+		if (Profiled)
+			Instr->Count(GET_OPCODE(*pc), Profiled);
+	}
+
+	pc++;
+	return true;
+}
+
+/* EQ/LT/LE of two numbers including the jump that follows, false for anything else */
+static __forceinline bool num_compare(const Instruction i, Instruction*& pc, StkId base, TValue* k, const uint64_t numkey)
+{
+	TValue* rb = RKB(i);
+	TValue* rc = RKC(i);
+	if (ttype(rb) != R_LUA_TNUMBER || ttype(rc) != R_LUA_TNUMBER)
+		return false;
+
+	const lua_Number nb = xor_num(nvalue(rb), numkey), nc = xor_num(nvalue(rc), numkey);
+	int res;
+	switch (GET_OPCODE(i))
+	{
+		case OpCode::OP_EQ: res = luai_numeq(nb, nc); break;
+		case OpCode::OP_LT: res = luai_numlt(nb, nc); break;
+		default: res = luai_numle(nb, nc); break;
+	}
+
+	if (res == GETARG_A(i))
+		dojump(pc, GETARG_sAx(*pc));
+	pc++;
+	return true;
+}
+
+/*
+ * OP_CONCAT over a range of only strings and numbers: the pieces are copied (numbers formatted) into one buffer and
+ * interned once into *first, where VConcat would leave it. Numbers no longer become strings of their own on the way.
+ * Anything else, or a result too long for an int, returns false with the range untouched so VConcat handles it.
+ */
+static __forceinline bool fast_concat(const syn::RbxLua& SL, StkId first, StkId last, const uint64_t numkey)
+{
+	constexpr size_t InlineSize = 1024;
+
+	size_t Bound = 0;
+	for (auto o = first; o <= last; o++)
+	{
+		if (ttype(o) == R_LUA_TSTRING)
+			Bound += SL.RawSLen(rawtsvalue(o));
+		else if (ttype(o) == R_LUA_TNUMBER)
+			Bound += LUAI_MAXNUMBER2STR;
+		else
+			return false;
+	}
+
+	if (Bound >= INT_MAX)
+		return false;
+
+	char Inline[InlineSize];
+	static thread_local std::string Large;
+
+	char* Buffer = Inline;
+	if (Bound > InlineSize)
+	{
+		Large.resize(Bound);
+		Buffer = &Large[0];
+	}
+
+	size_t Length = 0;
+	for (auto o = first; o <= last; o++)
+	{
+		if (ttype(o) == R_LUA_TSTRING)
+		{
+			const auto Size = (size_t) SL.RawSLen(rawtsvalue(o));
+			memcpy(Buffer + Length, SL.GetStr(rawtsvalue(o)), Size);
+			Length += Size;
+		}
+		else
+		{
+			Length += snprintf(Buffer + Length, LUAI_MAXNUMBER2STR, LUA_NUMBER_FMT, xor_num(nvalue(o), numkey));
+		}
+	}
+
+	r_setsvalue(first, SL.NewLString(Buffer, Length));
+	return true;
+}
+
 #define R_TM_ADD 8
 #define R_TM_SUB 11
 #define R_TM_MUL 6
@@ -91,6 +228,98 @@ uint32_t OriginalLuaUDispatcher;
 
 namespace syn::HSVM
 {
+	TableLayout Layout{};
+
+	/* Tables with more nodes than this aren't worth a linear scan to fill a cache slot */
+	constexpr uint32_t InlineCacheScanLimit = 256;
+
+	/* Lua callers whose decoded state is kept while their callee runs, deeper chains return through reentry instead */
+	constexpr int FrameCacheDepth = 64;
+
+	struct CachedFrame
+	{
+		DWORD Closure;
+		uintptr_t Proto;
+		Instruction* PcBase;
+		TValue* K;
+		HSvmSettings* Settings;
+		ProfiledProto* Profiled;
+	};
+
+	/* A site that failed to fill this many times is megamorphic, stop trying */
+	constexpr uint8_t InlineCacheMissLimit = 16;
+
+	/* A site de-quickened this many times keeps running generic, its operands don't settle */
+	constexpr uint8_t QuickMissLimit = 4;
+
+	static __forceinline void quicken(HSvmQuickSite* Site, const HSvmQuickKinds Kind)
+	{
+		if (Site->Kind == HSVM_QUICK_NONE && Site->Misses < QuickMissLimit)
+			Site->Kind = Kind;
+	}
+
+	static __declspec(noinline) void dequicken(HSvmQuickSite* Site)
+	{
+		Site->Kind = HSVM_QUICK_NONE;
+		Site->Misses++;
+	}
+
+	static __forceinline bool ic_key_is(const TValue* key, const TValue* name)
+	{
+		return ((uint32_t) key->tt & Layout.KeyTagMask) == (uint32_t) R_LUA_TSTRING && key->value.gc == name->value.gc;
+	}
+
+	/* Hit only while the table still owns the same node array at the same size and the node still holds name */
+	static __forceinline bool ic_get(const HSvmInlineCache& IC, const TValue* t, const TValue* name, StkId ra)
+	{
+		if (!Layout.Valid || ttype(t) != R_LUA_TTABLE)
+			return false;
+
+		const auto H = (uintptr_t) gcvalue(t);
+		if (IC.Table != H || *(uintptr_t*)(H + Layout.Node) != IC.Nodes || *(uint8_t*)(H + Layout.LSizeNode) != IC.LSizeNode)
+			return false;
+
+		if (!ic_key_is((const TValue*)(IC.Node + Layout.Key), name))
+			return false;
+
+		const auto V = (const TValue*)(IC.Node + Layout.Value);
+		if (ttype(V) == R_LUA_TNIL)
+			return false;
+
+		r_setobj(ra, V);
+		return true;
+	}
+
+	static __declspec(noinline) void ic_fill(HSvmInlineCache& IC, const TValue* t, const TValue* name)
+	{
+		if (!Layout.Valid || ttype(t) != R_LUA_TTABLE || IC.Misses >= InlineCacheMissLimit)
+			return;
+
+		const auto H = (uintptr_t) gcvalue(t);
+		const auto Nodes = *(uintptr_t*)(H + Layout.Node);
+		const auto LSize = *(uint8_t*)(H + Layout.LSizeNode);
+		const auto Size = 1u << LSize;
+
+		if (Size <= InlineCacheScanLimit)
+		{
+			for (uint32_t n = 0; n < Size; n++)
+			{
+				const auto N = Nodes + n * Layout.Stride;
+				if (ic_key_is((const TValue*)(N + Layout.Key), name))
+				{
+					IC.Table = H;
+					IC.Nodes = Nodes;
+					IC.Node = N;
+					IC.LSizeNode = LSize;
+					IC.Misses = 0;
+					return;
+				}
+			}
+		}
+
+		IC.Misses++;
+	}
+
 #pragma region HSVM Normal
 	int __cdecl Execute(DWORD L, int nexeccalls, int from)
 	{
@@ -100,12 +329,20 @@ namespace syn::HSVM
 		Instruction* pc;
 		Instruction* pcBase;
 		syn::RbxLua SL(L);
+		const uint64_t numkey = *(uint64_t*) syn::DXorKey;
+		const auto Instr = Instrumentation::GetSingleton();
 
         auto SEntry = false;
 
+		/* Calls made from this activation, the first FrameCacheDepth of them have their caller in Frames */
+		CachedFrame Frames[FrameCacheDepth];
+		auto Depth = 0;
+
+		syn::Structures::rProto P(0);
+
 	reentry:  /* entry point */
 		cl = **(DWORD**)(*(DWORD*)(L + L_CI) + CI_FUNC);
-		syn::Structures::rProto P(syn::PointerObfuscation::DeObfuscateLClosure(cl + 20));
+		P.Proto = syn::PointerObfuscation::DeObfuscateLClosure(cl + 20);
 
 		if (P.lastlinedefined != LastDefineKey)
 		{
@@ -128,8 +365,17 @@ namespace syn::HSVM
 		
 		SEntry = true;
 
-		const auto VMMarker = (HSvmSettings*) (uint32_t) P.linedefined;
+		auto VMMarker = (HSvmSettings*) (uint32_t) P.linedefined;
 		auto ShadowK = VMMarker->ShadowK;
+		auto Caches = VMMarker->Caches;
+		auto Quick = VMMarker->Quick;
+
+		ProfiledProto* Profiled = nullptr;
+		if constexpr (synf::UseHSVMInstrumentation)
+		{
+			if (Instr->Enabled.load(std::memory_order_relaxed))
+				Profiled = Instr->Enter(L, *(DWORD*)(L + L_CI), VMMarker, P);
+		}
 
 #ifndef EnableHSVMOnlyLuaU
 		if (IsLuaU)
@@ -224,6 +470,63 @@ namespace syn::HSVM
 		{
 			const Instruction i = *pc++;
 
+			if constexpr (synf::UseHSVMInstrumentation)
+			{
+				if (Profiled)
+				{
+					Instr->Count(GET_OPCODE(i), Profiled);
+					if (GET_OPCODE(i) == OpCode::OP_FORLOOP || (GET_OPCODE(i) == OpCode::OP_JMP && GETARG_sAx(i) < 0))
+						Instr->Backedge(Profiled, pc, pcBase);
+					if (Instr->SampleDue.load(std::memory_order_relaxed))
+					{
+						Instr->SampleDue.store(false, std::memory_order_relaxed);
+						Instr->Sample(Profiled, pc, pcBase);
+					}
+				}
+			}
+
+			/* Quickened sites try their specialised form first, a guard miss de-quickens and runs the generic handler below */
+			HSvmQuickSite* Site = nullptr;
+			if constexpr (synf::UseHSVMQuickening)
+			{
+				Site = Quick + (pc - 1 - pcBase);
+				switch (Site->Kind)
+				{
+					case HSVM_QUICK_NONE:
+						break;
+					case HSVM_QUICK_ARITH_NUM:
+					{
+						if (num_arith(i, base, k, numkey))
+							continue;
+						dequicken(Site);
+						break;
+					}
+					case HSVM_QUICK_COMPARE_NUM:
+					{
+						if (num_compare(i, pc, base, k, numkey))
+							continue;
+						dequicken(Site);
+						break;
+					}
+					case HSVM_QUICK_CONSTKEY:
+					{
+						if (ic_get(Caches[pc - 1 - pcBase], RB(i), k + INDEXK(GETARG_C(i)), RA(i)))
+							continue;
+						dequicken(Site);
+						break;
+					}
+					case HSVM_QUICK_GLOBAL:
+					{
+						TValue g;
+						r_sethvalue(&g, *(TValue**)(cl + LCL_ENV));
+						if (ic_get(Caches[pc - 1 - pcBase], &g, KBx(i), RA(i)))
+							continue;
+						dequicken(Site);
+						break;
+					}
+				}
+			}
+
 			/* warning!! several calls may realloc the stack and invalidate `ra' */
 			switch (GET_OPCODE(i))
 			{
@@ -231,12 +534,16 @@ namespace syn::HSVM
 				{
 					StkId ra = RA(i);
 					r_setobj(ra, RB(i));
+					if constexpr (synf::UseHSVMSuperInstructions)
+						fuse_arith(pc, base, k, numkey, Instr, Profiled);
 					continue;
 				}
 				case OpCode::OP_LOADK:
 				{
 					StkId ra = RA(i);
 					r_setobj(ra, KBx(i));
+					if constexpr (synf::UseHSVMSuperInstructions)
+						fuse_arith(pc, base, k, numkey, Instr, Profiled);
 					continue;
 				}
 
@@ -302,6 +609,16 @@ namespace syn::HSVM
 						TValue g;
 						TValue* rb = KBx(i);
 						r_sethvalue(&g, env);
+						if constexpr (synf::UseHSVMInlineCaches)
+						{
+							auto& IC = Caches[pc - 1 - pcBase];
+							if (ic_get(IC, &g, rb, ra))
+								continue;
+
+							Protect(SL.VGetTable(&g, rb, RA(i)));
+							ic_fill(IC, &g, rb);
+							continue;
+						}
 						Protect(SL.VGetTable(&g, rb, ra));
 					}
 
@@ -313,12 +630,44 @@ namespace syn::HSVM
 					TValue g;
 					TValue* rb = KBx(i);
 					r_sethvalue(&g, *(TValue**)(cl + LCL_ENV));
+					if constexpr (synf::UseHSVMInlineCaches)
+					{
+						auto& IC = Caches[pc - 1 - pcBase];
+						if (ic_get(IC, &g, rb, ra))
+						{
+							if constexpr (synf::UseHSVMQuickening)
+								quicken(Site, HSVM_QUICK_GLOBAL);
+							continue;
+						}
+
+						Protect(SL.VGetTable(&g, rb, RA(i)));
+						ic_fill(IC, &g, rb);
+						continue;
+					}
 					Protect(SL.VGetTable(&g, rb, ra));
 					continue;
 				}
 				case OpCode::OP_GETTABLE:
 				{
 					StkId ra = RA(i);
+					if constexpr (synf::UseHSVMInlineCaches)
+					{
+						if (ISK(GETARG_C(i)) && ttype(k + INDEXK(GETARG_C(i))) == R_LUA_TSTRING)
+						{
+							auto& IC = Caches[pc - 1 - pcBase];
+							TValue* rc = k + INDEXK(GETARG_C(i));
+							if (ic_get(IC, RB(i), rc, ra))
+							{
+								if constexpr (synf::UseHSVMQuickening)
+									quicken(Site, HSVM_QUICK_CONSTKEY);
+								continue;
+							}
+
+							Protect(SL.VGetTable(RB(i), rc, RA(i)));
+							ic_fill(IC, RB(i), rc);
+							continue;
+						}
+					}
 					Protect(SL.VGetTable(RB(i), RKC(i), ra));
 					continue;
 				}
@@ -408,30 +757,65 @@ namespace syn::HSVM
 #endif
 
 					r_setobj(ra + 1, rb);
+					if constexpr (synf::UseHSVMInlineCaches)
+					{
+						/* Method lookups on plain tables (module objects), userdata still goes through namecall above */
+						if (ISK(GETARG_C(i)) && ttype(k + INDEXK(GETARG_C(i))) == R_LUA_TSTRING)
+						{
+							auto& IC = Caches[pc - 1 - pcBase];
+							TValue* rc = k + INDEXK(GETARG_C(i));
+							if (ic_get(IC, rb, rc, ra))
+								continue;
+
+							Protect(SL.VGetTable(rb, rc, ra));
+							ic_fill(IC, RA(i) + 1, rc);
+							continue;
+						}
+					}
 					Protect(SL.VGetTable(rb, RKC(i), ra));
 					continue;
 				}
 				case OpCode::OP_ADD:
 				{
 					StkId ra = RA(i);
+					if constexpr (synf::UseHSVMQuickening)
+					{
+						if (ttype(RKB(i)) == R_LUA_TNUMBER && ttype(RKC(i)) == R_LUA_TNUMBER)
+							quicken(Site, HSVM_QUICK_ARITH_NUM);
+					}
 					arith_op(luai_numadd, R_TM_ADD);
 					continue;
 				}
 				case OpCode::OP_SUB:
 				{
 					StkId ra = RA(i);
+					if constexpr (synf::UseHSVMQuickening)
+					{
+						if (ttype(RKB(i)) == R_LUA_TNUMBER && ttype(RKC(i)) == R_LUA_TNUMBER)
+							quicken(Site, HSVM_QUICK_ARITH_NUM);
+					}
 					arith_op(luai_numsub, R_TM_SUB);
 					continue;
 				}
 				case OpCode::OP_MUL:
 				{
 					StkId ra = RA(i);
+					if constexpr (synf::UseHSVMQuickening)
+					{
+						if (ttype(RKB(i)) == R_LUA_TNUMBER && ttype(RKC(i)) == R_LUA_TNUMBER)
+							quicken(Site, HSVM_QUICK_ARITH_NUM);
+					}
 					arith_op(luai_nummul, R_TM_MUL);
 					continue;
 				}
 				case OpCode::OP_DIV:
 				{
 					StkId ra = RA(i);
+					if constexpr (synf::UseHSVMQuickening)
+					{
+						if (ttype(RKB(i)) == R_LUA_TNUMBER && ttype(RKC(i)) == R_LUA_TNUMBER)
+							quicken(Site, HSVM_QUICK_ARITH_NUM);
+					}
 					arith_op(luai_numdiv, R_TM_DIV);
 					continue;
 				}
@@ -453,8 +837,8 @@ namespace syn::HSVM
 					TValue* rb = RB(i);
 					if (ttype(rb) == R_LUA_TNUMBER)
 					{
-						lua_Number nb = SL.XorDouble(nvalue(rb));
-						r_setnvalue(ra, SL.XorDouble(luai_numunm(nb)));
+						lua_Number nb = xor_num(nvalue(rb), numkey);
+						r_setnvalue(ra, xor_num(luai_numunm(nb), numkey));
 					}
 					else
 					{
@@ -499,7 +883,11 @@ namespace syn::HSVM
 				{
 					int b = GETARG_B(i);
 					int c = GETARG_C(i);
-                    Protect(SL.VConcat(c - b + 1, c); SL.CheckGC());
+					auto Done = false;
+					if constexpr (synf::UseHSVMFastConcat)
+						Protect(Done = fast_concat(SL, base + b, base + c, numkey); if (Done) SL.CheckGC());
+					if (!Done)
+						Protect(SL.VConcat(c - b + 1, c); SL.CheckGC());
 					r_setobj(RA(i), base + b); /* previous call may change the stack */
 					continue;
 				}
@@ -512,13 +900,44 @@ namespace syn::HSVM
 				{
 					TValue* rb = RKB(i);
 					TValue* rc = RKC(i);
-					if ((ttype(rb) == ttype(rc) && SL.VEqualVal(rb, rc)) == GETARG_A(i))
+					if constexpr (synf::UseHSVMQuickening)
+					{
+						if (ttype(rb) == R_LUA_TNUMBER && ttype(rc) == R_LUA_TNUMBER)
+							quicken(Site, HSVM_QUICK_COMPARE_NUM);
+					}
+					int res;
+					if (ttype(rb) != ttype(rc))
+						res = 0;
+					else if (ttype(rb) == R_LUA_TNUMBER) /* decode, the key keeps 0 == -0 and NaN ~= NaN from holding on raw bits */
+						res = luai_numeq(xor_num(nvalue(rb), numkey), xor_num(nvalue(rc), numkey));
+					else if (ttype(rb) == R_LUA_TNIL)
+						res = 1;
+					else if (ttype(rb) == R_LUA_TSTRING || (r_iscollectable(rb) && rb->value.gc == rc->value.gc))
+						res = rb->value.gc == rc->value.gc; /* strings are interned, same object is always equal */
+					else
+						res = SL.VEqualVal(rb, rc);
+
+					if (res == GETARG_A(i))
 						dojump(pc, GETARG_sAx(*pc));
 					pc++;
 					continue;
 				}
 				case OpCode::OP_LT:
 				{
+					TValue* rb = RKB(i);
+					TValue* rc = RKC(i);
+					if constexpr (synf::UseHSVMQuickening)
+					{
+						if (ttype(rb) == R_LUA_TNUMBER && ttype(rc) == R_LUA_TNUMBER)
+							quicken(Site, HSVM_QUICK_COMPARE_NUM);
+					}
+					if (ttype(rb) == R_LUA_TNUMBER && ttype(rc) == R_LUA_TNUMBER)
+					{
+						if (luai_numlt(xor_num(nvalue(rb), numkey), xor_num(nvalue(rc), numkey)) == GETARG_A(i))
+							dojump(pc, GETARG_sAx(*pc));
+						pc++;
+						continue;
+					}
 					Protect(
 						if (SL.LessThan(RKB(i), RKC(i)) == GETARG_A(i))
 							dojump(pc, GETARG_sAx(*pc));
@@ -528,6 +947,20 @@ namespace syn::HSVM
 				}
 				case OpCode::OP_LE:
 				{
+					TValue* rb = RKB(i);
+					TValue* rc = RKC(i);
+					if constexpr (synf::UseHSVMQuickening)
+					{
+						if (ttype(rb) == R_LUA_TNUMBER && ttype(rc) == R_LUA_TNUMBER)
+							quicken(Site, HSVM_QUICK_COMPARE_NUM);
+					}
+					if (ttype(rb) == R_LUA_TNUMBER && ttype(rc) == R_LUA_TNUMBER)
+					{
+						if (luai_numle(xor_num(nvalue(rb), numkey), xor_num(nvalue(rc), numkey)) == GETARG_A(i))
+							dojump(pc, GETARG_sAx(*pc));
+						pc++;
+						continue;
+					}
 					Protect(
 						if (SL.LessEqual(RKB(i), RKC(i)) == GETARG_A(i))
 							dojump(pc, GETARG_sAx(*pc));
@@ -583,6 +1016,13 @@ namespace syn::HSVM
 					{
 						case PCRLUA:
 						{
+							if constexpr (synf::UseHSVMFrameCache)
+							{
+								if (Depth < FrameCacheDepth)
+									Frames[Depth] = { cl, P.Proto, pcBase, k, VMMarker, Profiled };
+								Depth++;
+							}
+
 							nexeccalls++;
 							goto reentry;  /* restart syn::HSVM::Execute over new Lua function */
 						}
@@ -625,6 +1065,45 @@ namespace syn::HSVM
 					{
 						/* yes: continue its execution */
 						if (b) *(DWORD*)(L + L_TOP) = *(DWORD*)(*(DWORD*)(L + L_CI) + CI_TOP);
+
+						/* A caller that called from this activation is known to be ours and past its prologue, pick it
+						   back up from the cache rather than decoding its closure and proto again */
+						if constexpr (synf::UseHSVMFrameCache)
+						{
+							if (Depth > 0 && --Depth < FrameCacheDepth)
+							{
+								const auto& Frame = Frames[Depth];
+								cl = Frame.Closure;
+								P.Proto = Frame.Proto;
+								pcBase = Frame.PcBase;
+								k = Frame.K;
+								VMMarker = Frame.Settings;
+								ShadowK = VMMarker->ShadowK;
+								Caches = VMMarker->Caches;
+								Quick = VMMarker->Quick;
+								Profiled = Frame.Profiled;
+
+								/* Keeps the profiler's shadow stack in step, only while it's recording */
+								if constexpr (synf::UseHSVMInstrumentation)
+								{
+									if (Profiled)
+										Profiled = Instr->Enter(L, *(DWORD*)(L + L_CI), VMMarker, P);
+								}
+
+#ifndef EnableHSVMOnlyLuaU
+								if (IsLuaU)
+									pc = *(Instruction**)(*(DWORD*)(L + L_CI) + CI_SAVEDPC);
+								else
+									pc = (Instruction*) syn::PointerObfuscation::DeObfuscateSavedPC(L + L_SAVEDPC);
+#else
+								pc = *(Instruction**)(*(DWORD*)(L + L_CI) + CI_SAVEDPC);
+#endif
+
+								base = *(StkId*)(L + L_BASE);
+								continue;
+							}
+						}
+
 						goto reentry;
 					}
 				}
@@ -640,7 +1119,9 @@ namespace syn::HSVM
 					{
 						dojump(pc, GETARG_sBx(i));  /* jump back */
 						r_setnvalue(ra, idx);  /* update internal index... */
-						r_setnvalue(ra + 3, SL.XorDouble(idx));  /* ...and external index */
+						r_setnvalue(ra + 3, xor_num(idx, numkey));  /* ...and external index */
+						if constexpr (synf::UseHSVMSuperInstructions)
+							fuse_arith(pc, base, k, numkey, Instr, Profiled);
 					}
 					continue;
 				}
@@ -716,11 +1197,18 @@ namespace syn::HSVM
 					if (last > *(int*)(h + 12))  /* needs more space? */
 						SL.HResizeArray((Table*)h, last); /* pre-alloc it at once */
 
-					for (; n > 0; n--) 
+					if (n == 0)
+						continue;
+
+					/* Every key of the flush is inside the array part now, so its slots are contiguous from the first one */
+					TValue* slots = SL.HSetNum((Table*)h, last - n + 1);
+					memcpy(slots, ra + 1, n * sizeof(TValue));
+
+					/* Only a black table needs the barrier, and one barrierback is enough to turn it gray again */
+					if (*(BYTE*)(h + 4) & 4)
 					{
-						TValue* val = ra + n;
-						r_setobj(SL.HSetNum((Table*)h, last--), val);
-						SL.CBarrierT((DWORD)h, (DWORD)val);
+						for (TValue* val = ra + 1; val <= ra + n && (*(BYTE*)(h + 4) & 4); val++)
+							SL.CBarrierT((DWORD)h, (DWORD)val);
 					}
 					continue;
 				}
@@ -739,6 +1227,21 @@ namespace syn::HSVM
 					p = rp[GETARG_Bx(i)];
 					nup = *(BYTE*)(p + PO_NUPS);
 
+					/* Nothing captured, so the last closure made for this child in the same environment is as good as a new one */
+					TValue* cached = nullptr;
+					if constexpr (synf::UseHSVMClosureCache)
+					{
+						if (nup == 0 && VMMarker->ClosureK >= 0)
+						{
+							cached = k + VMMarker->ClosureK + GETARG_Bx(i);
+							if (cached->tt == R_LUA_TFUNCTION && *(DWORD*)((DWORD) cached->value.gc + LCL_ENV) == *(DWORD*)(cl + LCL_ENV))
+							{
+								r_setobj(ra, cached);
+								continue;
+							}
+						}
+					}
+
                     DWORD lc = SL.NewLClosure(nup, *(BYTE*)(p + PO_MAXSTACKSIZE), *(DWORD*)(cl + LCL_ENV));
                     syn::PointerObfuscation::ObfuscateLClosure(lc + 20, p);
 
@@ -756,6 +1259,13 @@ namespace syn::HSVM
 					}
 
 					r_setclvalue(ra, lc);
+
+					if (cached)
+					{
+						r_setclvalue(cached, lc);
+						SL.CBarrier(P.Proto, (DWORD) cached);
+					}
+
                     Protect(SL.CheckGC());
 					continue;
 				}
@@ -980,6 +1490,148 @@ namespace syn::HSVM
 		}
 	}
 
+	/* Probe tables: Small holds Names[0..1] in a 2 node array, Large holds Names[0..3] in a 4 node array */
+	static bool ScanTableLayout(const uintptr_t Small, const uintptr_t Large, const uintptr_t* Names, const uint64_t* Bits, const uint32_t KeyTagMask, TableLayout& Out)
+	{
+		const auto IsName = [&](const uintptr_t At, const int Which)
+		{
+			const auto V = (const TValue*) At;
+			return ((uint32_t) V->tt & KeyTagMask) == (uint32_t) R_LUA_TSTRING && (uintptr_t) V->value.gc == Names[Which];
+		};
+
+		__try
+		{
+			for (uint32_t Off = 8; Off < 64; Off += 4)
+			{
+				const auto Nodes = *(uintptr_t*)(Small + Off);
+				if (Nodes < 0x10000 || Nodes == Small)
+					continue;
+
+				/* Both keys of the small table land in its two nodes, their distance is the node stride */
+				int32_t Hit[2] = { -1, -1 };
+				for (uint32_t At = 0; At + sizeof(TValue) <= 128; At += 4)
+				{
+					for (auto j = 0; j < 2; j++)
+						if (Hit[j] < 0 && IsName(Nodes + At, j))
+							Hit[j] = (int32_t) At;
+				}
+
+				if (Hit[0] < 0 || Hit[1] < 0)
+					continue;
+
+				const auto Key = (uint32_t) (std::min)(Hit[0], Hit[1]);
+				const auto Stride = (uint32_t) std::abs(Hit[0] - Hit[1]);
+				if (Stride < 2 * sizeof(TValue) || Key >= Stride)
+					continue;
+
+				int32_t Value = -1;
+				for (uint32_t VOff = 0; VOff + sizeof(TValue) <= Stride; VOff += 4)
+				{
+					if (VOff + sizeof(TValue) > Key && VOff < Key + sizeof(TValue))
+						continue;
+
+					auto Match = true;
+					for (auto j = 0; j < 2 && Match; j++)
+					{
+						const auto V = (const TValue*)(Nodes + Hit[j] - Key + VOff);
+						Match = ttype(V) == R_LUA_TNUMBER && memcmp(&V->value, &Bits[j], sizeof(uint64_t)) == 0;
+					}
+
+					if (Match)
+					{
+						Value = (int32_t) VOff;
+						break;
+					}
+				}
+
+				if (Value < 0)
+					continue;
+
+				int32_t LSize = -1;
+				for (uint32_t B = 4; B < 64; B++)
+				{
+					if (*(uint8_t*)(Small + B) == 1 && *(uint8_t*)(Large + B) == 2)
+					{
+						LSize = (int32_t) B;
+						break;
+					}
+				}
+
+				if (LSize < 0)
+					continue;
+
+				/* The large table must agree, every one of its 4 nodes holds one of its 4 keys */
+				const auto LargeNodes = *(uintptr_t*)(Large + Off);
+				uint32_t Seen = 0;
+				for (uint32_t n = 0; n < 4; n++)
+				{
+					for (auto j = 0; j < 4; j++)
+						if (IsName(LargeNodes + n * Stride + Key, j))
+							Seen |= 1u << j;
+				}
+
+				if (Seen != 0xF)
+					continue;
+
+				Out.Node = Off;
+				Out.LSizeNode = (uint32_t) LSize;
+				Out.Stride = Stride;
+				Out.Key = Key;
+				Out.Value = (uint32_t) Value;
+				Out.KeyTagMask = KeyTagMask;
+				Out.Valid = true;
+				return true;
+			}
+		}
+		__except (EXCEPTION_EXECUTE_HANDLER)
+		{
+		}
+
+		return false;
+	}
+
+	bool Calibrate(DWORD L)
+	{
+		if (Layout.Valid)
+			return true;
+
+		syn::RbxLua RL(L);
+		const auto Top = RL.GetTop();
+
+		static const char* ProbeNames[4] = { "\x01synic0", "\x01synic1", "\x01synic2", "\x01synic3" };
+		uintptr_t Names[4];
+		uint64_t Bits[4];
+		uintptr_t Tables[2];
+
+		for (auto t = 0; t < 2; t++)
+		{
+			const auto Count = t == 0 ? 2 : 4;
+			RL.CreateTable(0, Count);
+
+			for (auto j = 0; j < Count; j++)
+			{
+				RL.PushNumber(1000.25 + j);
+				memcpy(&Bits[j], &RL.Index2Adr(-1)->value, sizeof(uint64_t));
+				RL.SetField(-2, ProbeNames[j]);
+
+				RL.PushString(ProbeNames[j]);
+				Names[j] = (uintptr_t) RL.Index2Adr(-1)->value.gc;
+				RL.Pop(1);
+			}
+
+			Tables[t] = (uintptr_t) RL.Index2Adr(-1)->value.gc;
+		}
+
+		/* Luau packs the node chain into the key tag, try the plain tag first */
+		TableLayout Found{};
+		if (!ScanTableLayout(Tables[0], Tables[1], Names, Bits, 0xFFFFFFFF, Found))
+			ScanTableLayout(Tables[0], Tables[1], Names, Bits, 0xF, Found);
+
+		RL.SetTop(Top);
+		Layout = Found;
+		return Layout.Valid;
+	}
+
 	void Attach()
 	{
 		VM_DOLPHIN_RED_START
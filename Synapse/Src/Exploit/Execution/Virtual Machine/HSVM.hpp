@@ -11,4 +11,21 @@ namespace syn::HSVM
 {
 	int __cdecl Execute(DWORD L, int nexeccalls, int from);
 	__declspec(noinline) void Attach();
+
+	/* Table node layout for the inline caches, Roblox shuffles it between builds so it is found at runtime */
+	struct TableLayout
+	{
+		bool Valid;
+		uint32_t Node;
+		uint32_t LSizeNode;
+		uint32_t Stride;
+		uint32_t Key;
+		uint32_t Value;
+		uint32_t KeyTagMask;
+	};
+
+	extern TableLayout Layout;
+
+	/* Builds probe tables on L to find Layout, leaves the inline caches off if the layout can't be matched */
+	__declspec(noinline) bool Calibrate(DWORD L);
 }
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include "./HSVMProfiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace syn::HSVM
+{
+	Instrumentation* Instrumentation::GetSingleton()
+	{
+		static Instrumentation* instrumentation = nullptr;
+		if (instrumentation == nullptr)
+			instrumentation = new Instrumentation();
+
+		return instrumentation;
+	}
+
+	void Instrumentation::Start()
+	{
+		OpCounts.fill(0);
+
+		{
+			std::lock_guard<std::mutex> Guard(ProtoMutex);
+			for (auto& Proto : Protos)
+			{
+				Proto.Instructions = 0;
+				std::fill(Proto.Backedges.begin(), Proto.Backedges.end(), 0);
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> Guard(SampleMutex);
+			Samples.clear();
+		}
+
+		/* Frames recorded before a restart can't be trusted, Enter drops them on the next call */
+		Generation.fetch_add(1, std::memory_order_relaxed);
+
+		if (!SamplerRunning.exchange(true))
+		{
+			Sampler = std::thread([this]
+			{
+				while (SamplerRunning.load(std::memory_order_relaxed))
+				{
+					Sleep(SampleIntervalMs);
+					SampleDue.store(true, std::memory_order_relaxed);
+				}
+			});
+		}
+
+		Enabled.store(true);
+	}
+
+	void Instrumentation::Stop()
+	{
+		Enabled.store(false);
+		SamplerRunning.store(false);
+
+		if (Sampler.joinable())
+			Sampler.join();
+	}
+
+	static std::string FrameSafe(std::string Name)
+	{
+		/* ';' separates frames and a newline ends the record in the folded format */
+		for (auto& C : Name)
+			if (C == ';' || C == '\n' || C == '\r')
+				C = ' ';
+		return Name;
+	}
+
+	ProfiledProto* Instrumentation::Enter(const DWORD L, const DWORD Ci, const void* Settings, syn::Structures::rProto& P)
+	{
+		ProfiledProto* Proto;
+
+		{
+			std::lock_guard<std::mutex> Guard(ProtoMutex);
+
+			const auto Found = ProtoIds.find(Settings);
+			if (Found != ProtoIds.end())
+			{
+				Proto = Found->second;
+			}
+			else
+			{
+				Proto = &Protos.emplace_back();
+
+				const auto Source = (TString*) P.source;
+				if (Source)
+				{
+					const auto Str = getstr(Source);
+					Proto->Source = FrameSafe(*Str == '@' || *Str == '=' ? std::string(Str + 1, Source->tsv.len - 1) : std::string(Str, Source->tsv.len));
+				}
+				else
+				{
+					Proto->Source = "?";
+				}
+
+				const auto LineInfo = (int*) P.lineinfo;
+				const auto SizeLineInfo = (int) P.sizelineinfo;
+				if (LineInfo && SizeLineInfo > 0)
+					Proto->Lines.assign(LineInfo, LineInfo + SizeLineInfo);
+
+				Proto->Name = Proto->Source + ':' + (Proto->Lines.empty() ? std::string("?") : std::to_string(Proto->Lines.front()));
+				Proto->Backedges.resize((size_t) (std::max)((int) P.sizecode, 0));
+				ProtoIds.emplace(Settings, Proto);
+			}
+		}
+
+		const auto Current = Generation.load(std::memory_order_relaxed);
+		if (StackThread != L || StackGeneration != Current)
+		{
+			Stack.clear();
+			StackThread = L;
+			StackGeneration = Current;
+		}
+
+		/* A returning or tail calling frame reenters at the same or a shallower ci than what we last saw */
+		while (!Stack.empty() && Stack.back().Ci >= Ci)
+			Stack.pop_back();
+
+		Stack.push_back({ Ci, Proto });
+		return Proto;
+	}
+
+	void Instrumentation::Sample(ProfiledProto* Proto, const Instruction* pc, const Instruction* pcBase)
+	{
+		std::string Key;
+		if (!Stack.empty() && Stack.back().Proto == Proto)
+		{
+			for (size_t i = 0; i + 1 < Stack.size(); i++)
+			{
+				Key += Stack[i].Proto->Name;
+				Key += ';';
+			}
+		}
+
+		/* pc was already advanced past the instruction being run */
+		const auto Index = (size_t) (pc - pcBase) - 1;
+		Key += Proto->Source;
+		Key += ':';
+		Key += Index < Proto->Lines.size() ? std::to_string(Proto->Lines[Index]) : std::string("?");
+
+		std::lock_guard<std::mutex> Guard(SampleMutex);
+		Samples[Key]++;
+	}
+
+	std::string Instrumentation::DumpCounts()
+	{
+		std::vector<std::pair<uint64_t, int>> Ops;
+		for (auto Op = 0; Op < NUM_OPCODES; Op++)
+			if (OpCounts[Op])
+				Ops.emplace_back(OpCounts[Op], Op);
+
+		std::sort(Ops.begin(), Ops.end(), std::greater<>());
+
+		std::vector<std::pair<uint64_t, std::string>> Hot;
+		std::vector<std::pair<uint64_t, std::string>> Loops;
+		{
+			std::lock_guard<std::mutex> Guard(ProtoMutex);
+			for (const auto& Proto : Protos)
+			{
+				if (Proto.Instructions)
+					Hot.emplace_back(Proto.Instructions, Proto.Name);
+
+				for (size_t Pc = 0; Pc < Proto.Backedges.size(); Pc++)
+				{
+					if (const auto Count = Proto.Backedges[Pc])
+						Loops.emplace_back(Count, Proto.Source + ':' + (Pc < Proto.Lines.size() ? std::to_string(Proto.Lines[Pc]) : std::string("?")));
+				}
+			}
+		}
+
+		std::sort(Hot.begin(), Hot.end(), std::greater<>());
+		std::sort(Loops.begin(), Loops.end(), std::greater<>());
+
+		std::ostringstream oss;
+		oss << "Opcodes\n";
+		for (const auto& [Count, Op] : Ops)
+			oss << luaP_opnames[Op] << ' ' << Count << '\n';
+
+		oss << "\nProtos\n";
+		for (const auto& [Count, Name] : Hot)
+			oss << Name << ' ' << Count << '\n';
+
+		oss << "\nLoops\n";
+		for (const auto& [Count, Name] : Loops)
+			oss << Name << ' ' << Count << '\n';
+
+		return oss.str();
+	}
+
+	bool Instrumentation::DumpFolded(const std::wstring& Path)
+	{
+		std::ofstream Out(Path, std::ios::binary);
+		if (!Out)
+			return false;
+
+		std::lock_guard<std::mutex> Guard(SampleMutex);
+		for (const auto& [Frames, Count] : Samples)
+			Out << Frames << ' ' << Count << '\n';
+
+		return Out.good();
+	}
+}
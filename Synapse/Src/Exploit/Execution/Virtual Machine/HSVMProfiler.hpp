@@ -0,0 +1,104 @@
+
+/*
+*
+*	SYNAPSE X
+*	File.:	HSVMProfiler.hpp
+*	Desc.:	Opt-in HSVM instrumentation, opcode and proto counters plus a sampled folded stack dump
+*
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+
+#include "../../Misc/Static.hpp"
+#include "../../Misc/Structures.hpp"
+
+namespace syn::HSVM
+{
+	struct ProfiledProto
+	{
+		std::string Name;	/* chunk:linedefined, fixed when the proto is first seen so dumps never touch game memory */
+		std::string Source;
+		std::vector<int> Lines;
+		uint64_t Instructions = 0;
+		std::vector<uint64_t> Backedges; /* hits per pc of loop closing FORLOOPs and backward JMPs, sized once by sizecode */
+	};
+
+	class Instrumentation
+	{
+	public:
+		static constexpr DWORD SampleIntervalMs = 1;
+
+		/* Execute checks this once per instruction, everything else is skipped while it is false */
+		std::atomic<bool> Enabled{ false };
+
+		/* Raised by the sampler thread, the interpreter takes the sample on its next instruction */
+		std::atomic<bool> SampleDue{ false };
+
+		static Instrumentation* GetSingleton();
+
+		/* Clears all counters and samples, then starts the sampler */
+		void Start();
+		void Stop();
+
+		/* Frame bookkeeping at every Execute (re)entry, returns the proto counter the interpreter bumps */
+		ProfiledProto* Enter(DWORD L, DWORD Ci, const void* Settings, syn::Structures::rProto& P);
+
+		/* Counters are only written by the script thread, dumps read them without locking */
+		__forceinline void Count(const OpCode Op, ProfiledProto* Proto)
+		{
+			OpCounts[Op]++;
+			Proto->Instructions++;
+		}
+
+		void Sample(ProfiledProto* Proto, const Instruction* pc, const Instruction* pcBase);
+
+		/* Loop iteration counts, the hot loop list a compiling tier would pick its candidates from. The array is never
+		   resized after Enter creates it, so this is as safe as Count against a concurrent dump or Start */
+		__forceinline void Backedge(ProfiledProto* Proto, const Instruction* pc, const Instruction* pcBase)
+		{
+			const auto Index = (size_t) (pc - pcBase) - 1;
+			if (Index < Proto->Backedges.size())
+				Proto->Backedges[Index]++;
+		}
+
+		/* Opcode, per proto instruction and loop totals as text, hottest first */
+		std::string DumpCounts();
+
+		/* One "frame;frame;leaf count" line per distinct stack, as flamegraph.pl and speedscope expect */
+		bool DumpFolded(const std::wstring& Path);
+
+	private:
+		struct Frame
+		{
+			DWORD Ci;
+			ProfiledProto* Proto;
+		};
+
+		std::array<uint64_t, NUM_OPCODES> OpCounts{};
+
+		std::mutex ProtoMutex;
+		std::deque<ProfiledProto> Protos;
+		std::unordered_map<const void*, ProfiledProto*> ProtoIds; /* keyed by HSvmSettings, which are never freed or reused */
+
+		/* Call chain of the interpreted frames on the current lua thread, ci grows with depth */
+		DWORD StackThread = 0;
+		uint32_t StackGeneration = 0;
+		std::vector<Frame> Stack;
+		std::atomic<uint32_t> Generation{ 0 };
+
+		std::mutex SampleMutex;
+		std::unordered_map<std::string, uint64_t> Samples;
+
+		std::thread Sampler;
+		std::atomic<bool> SamplerRunning{ false };
+	};
+}
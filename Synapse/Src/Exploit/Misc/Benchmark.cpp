@@ -0,0 +1,699 @@
+#include "./Benchmark.hpp"
+#include "./FrameStats.hpp"
+#include "./D3D.hpp"
+#include "./Flags.hpp"
+
+#ifdef EnableBenchmarks
+
+#include "../Execution/Conversion/RbxConversion.hpp"
+#include "../Execution/Conversion/RbxLuauConversion.hpp"
+#include "../Execution/Scheduler.hpp"
+#include "../Execution/Lorraine/lorraine_llex.hpp"
+
+#include "../../Source Dependencies/ImGUI/imgui_impl_dx11.h"
+
+#include <filesystem>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <thread>
+
+namespace syn
+{
+	Benchmark* Benchmark::GetSingleton()
+	{
+		static Benchmark* Singleton;
+		if (!Singleton)
+			Singleton = new Benchmark();
+		return Singleton;
+	}
+
+	/* lua_Alloc that keeps a running total of every byte handed out, frees aren't subtracted */
+	static void* CountingAlloc(void* Ud, void* Ptr, const size_t OSize, const size_t NSize)
+	{
+		if (NSize == 0)
+		{
+			free(Ptr);
+			return nullptr;
+		}
+
+		if (NSize > OSize)
+			*(std::uint64_t*) Ud += NSize - OSize;
+		return realloc(Ptr, NSize);
+	}
+
+#ifdef EnableLuaUTranslator
+	static size_t TranslateTree(Proto* P)
+	{
+		auto Size = OneWayLuauTranslator(P).Convert(P->code, P->sizecode).size() * sizeof(LuauInstruction);
+		for (auto i = 0; i < P->sizep; i++)
+			Size += TranslateTree(P->p[i]);
+		return Size;
+	}
+#endif
+
+	std::vector<Benchmark::Script> Benchmark::LoadCorpus(const std::wstring& Path)
+	{
+		std::vector<Script> Corpus;
+
+		std::error_code Error;
+		for (const auto& Entry : std::filesystem::recursive_directory_iterator(Path, Error))
+		{
+			if (!Entry.is_regular_file())
+				continue;
+
+			const auto Extension = Entry.path().extension();
+			if (Extension != L".lua" && Extension != L".txt")
+				continue;
+
+			std::ifstream In(Entry.path(), std::ios::binary);
+			std::ostringstream Source;
+			Source << In.rdbuf();
+
+			Corpus.push_back({ Entry.path().filename().u8string(), Source.str() });
+		}
+
+		return Corpus;
+	}
+
+	std::vector<Benchmark::Stage> Benchmark::RunPipeline(const std::vector<Script>& Corpus)
+	{
+		enum { ST_LOAD, ST_TRANSLATE, ST_LEX, ST_COUNT };
+
+		std::vector<Stage> Stages(ST_COUNT);
+		Stages[ST_LOAD].Name = "luaL_loadbuffer";
+		Stages[ST_TRANSLATE].Name = "OneWayLuauTranslator";
+		Stages[ST_LEX].Name = "Lorraine lexer";
+
+		std::uint64_t LuaBytes = 0;
+		const auto L = lua_newstate(CountingAlloc, &LuaBytes);
+
+		for (auto Run = 0; Run < Repeat; Run++)
+		{
+			for (const auto& S : Corpus)
+			{
+				/* Parse and code generation, what every execute pays before conversion */
+				const auto LoadBytes = LuaBytes;
+				auto Begin = FrameStats::Now();
+				const auto Failed = luaL_loadbuffer(L, S.Source.c_str(), S.Source.size(), BS_LUA, S.Name.c_str()) != 0;
+				Stages[ST_LOAD].Micros.push_back(FrameStats::Now() - Begin);
+				Stages[ST_LOAD].Bytes += LuaBytes - LoadBytes;
+				Stages[ST_LOAD].Input += S.Source.size();
+
+				if (Failed)
+				{
+					Stages[ST_LOAD].Failures++;
+					lua_settop(L, 0);
+					continue;
+				}
+
+#ifdef EnableLuaUTranslator
+				/* Output size stands in for allocations, the translator's own scratch is freed before it returns */
+				Begin = FrameStats::Now();
+				Stages[ST_TRANSLATE].Bytes += TranslateTree(((Closure*) lua_topointer(L, -1))->l.p);
+				Stages[ST_TRANSLATE].Micros.push_back(FrameStats::Now() - Begin);
+				Stages[ST_TRANSLATE].Input += S.Source.size();
+#endif
+
+				lua_settop(L, 0);
+
+				/* The lexer reads UTF-16, widening is done outside of the timed region */
+				const std::wstring Wide(S.Source.begin(), S.Source.end());
+
+				Begin = FrameStats::Now();
+				lorraine::lorraine_lexer Lexer;
+				Lexer.lexer_input = Wide;
+				if (!Lexer.pass())
+					Stages[ST_LEX].Failures++;
+				Stages[ST_LEX].Micros.push_back(FrameStats::Now() - Begin);
+				Stages[ST_LEX].Bytes += Lexer.singlets.capacity() * sizeof(lorraine::lorraine_lexer_singlet) + Lexer.line_starts.capacity() * sizeof(lorraine::qint);
+				Stages[ST_LEX].Input += S.Source.size();
+			}
+
+			/* Drop this run's chunks so the next one doesn't parse into a growing heap */
+			lua_gc(L, LUA_GCCOLLECT, 0);
+		}
+
+		lua_close(L);
+
+		/* Stages compiled out of this build have nothing to report */
+		Stages.erase(std::remove_if(Stages.begin(), Stages.end(), [](const Stage& S) { return S.Micros.empty(); }), Stages.end());
+		return Stages;
+	}
+
+	static double Percentile(std::vector<double> Samples, const double P)
+	{
+		if (Samples.empty())
+			return 0;
+
+		const auto Rank = (size_t) (P / 100.0 * (Samples.size() - 1) + 0.5);
+		std::nth_element(Samples.begin(), Samples.begin() + Rank, Samples.end());
+		return Samples[Rank];
+	}
+
+	std::string Benchmark::Report(const std::vector<Stage>& Stages, const size_t Scripts)
+	{
+		std::ostringstream oss;
+		oss << Scripts << " scripts, " << Repeat << " runs each\n\n";
+		oss << std::left << std::setw(24) << "Stage" << std::right
+			<< std::setw(12) << "p50 (us)" << std::setw(12) << "p99 (us)"
+			<< std::setw(14) << "KB/run" << std::setw(10) << "MB/s" << std::setw(10) << "Failed" << '\n';
+
+		oss << std::fixed << std::setprecision(1);
+		for (const auto& S : Stages)
+		{
+			double Total = 0;
+			for (const auto M : S.Micros)
+				Total += M;
+
+			oss << std::left << std::setw(24) << S.Name << std::right
+				<< std::setw(12) << Percentile(S.Micros, 50) << std::setw(12) << Percentile(S.Micros, 99)
+				<< std::setw(14) << (double) S.Bytes / 1024.0 / S.Micros.size()
+				<< std::setw(10) << (Total > 0 ? (double) S.Input / Total : 0.0) /* bytes per us is MB/s */
+				<< std::setw(10) << S.Failures << '\n';
+		}
+
+		return oss.str();
+	}
+
+	bool Benchmark::Start(const std::wstring& Corpus, const std::wstring& Output)
+	{
+		if (Running.exchange(true))
+			return false;
+
+		std::thread([this, Corpus, Output]
+		{
+			const auto Scripts = LoadCorpus(Corpus);
+			std::ofstream(Output, std::ios::binary) << Report(RunPipeline(Scripts), Scripts.size());
+			Running.store(false);
+		}).detach();
+
+		return true;
+	}
+
+	static constexpr int MicroRepeat = 5;
+
+	const std::vector<Benchmark::Script>& Benchmark::MicroSuite()
+	{
+		static const std::vector<Script> Suite =
+		{
+			{ "fib", "local function fib(n) if n < 2 then return n end return fib(n - 1) + fib(n - 2) end fib(24)" },
+			{ "table insert", "local t = {} for i = 1, 200000 do t[#t + 1] = i end" },
+			{ "string concat", "local s = '' for i = 1, 20000 do s = s .. 'x' end local p = {} for i = 1, 20000 do p[i] = 'a' .. i .. 'b' end" },
+			{ "method calls", "local o = { n = 0 } function o:add(x) self.n = self.n + x end for i = 1, 200000 do o:add(i) end" },
+			{ "for loop", "local s = 0 for i = 1, 2000000 do s = s + i * 2 end" },
+		};
+		return Suite;
+	}
+
+	Benchmark::OpClass Benchmark::ClassOf(const OpCode Op)
+	{
+		switch (Op)
+		{
+			case OP_MOVE: case OP_LOADK: case OP_LOADBOOL: case OP_LOADNIL: case OP_GETUPVAL: case OP_SETUPVAL:
+			case OP_LOADENCK: case OP_LOADENCHIGHK:
+				return OC_LOAD;
+			case OP_GETGLOBAL: case OP_SETGLOBAL: case OP_CGETGLOBAL: case OP_CSETGLOBAL:
+				return OC_GLOBAL;
+			case OP_GETTABLE: case OP_SETTABLE: case OP_NEWTABLE: case OP_SELF: case OP_SETLIST:
+				return OC_TABLE;
+			case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: case OP_MOD: case OP_POW:
+			case OP_UNM: case OP_NOT: case OP_LEN: case OP_CONCAT:
+				return OC_ARITH;
+			case OP_JMP: case OP_EQ: case OP_LT: case OP_LE: case OP_TEST: case OP_TESTSET:
+				return OC_BRANCH;
+			case OP_FORLOOP: case OP_FORPREP: case OP_TFORLOOP:
+				return OC_LOOP;
+			default:
+				return OC_CALL;
+		}
+	}
+
+	static std::uint64_t* MicroOps;
+
+	/* Count hook every instruction, lvm.c has already stepped savedpc past the one about to run */
+	static void CountHook(lua_State* L, lua_Debug*)
+	{
+		MicroOps[Benchmark::ClassOf(GET_OPCODE(*(L->savedpc - 1)))]++;
+	}
+
+	static double Median(std::vector<double> Samples)
+	{
+		std::nth_element(Samples.begin(), Samples.begin() + Samples.size() / 2, Samples.end());
+		return Samples[Samples.size() / 2];
+	}
+
+	std::vector<Benchmark::Micro> Benchmark::RunMicroVanilla()
+	{
+		std::vector<Micro> Micros;
+
+		const auto L = luaL_newstate();
+		luaL_openlibs(L);
+
+		for (const auto& S : MicroSuite())
+		{
+			Micro M;
+			M.Name = S.Name;
+
+			if (luaL_loadbuffer(L, S.Source.c_str(), S.Source.size(), BS_LUA, S.Name.c_str()))
+			{
+				lua_settop(L, 0);
+				continue;
+			}
+
+			/* One counted run for the mix, the hook is far too slow to time with */
+			MicroOps = M.Ops.data();
+			lua_pushvalue(L, -1);
+			lua_sethook(L, CountHook, LUA_MASKCOUNT, 1);
+			lua_pcall(L, 0, 0, 0);
+			lua_sethook(L, nullptr, 0, 0);
+			lua_settop(L, 1);
+
+			for (const auto Count : M.Ops)
+				M.Instructions += Count;
+
+			std::vector<double> Runs;
+			for (auto Run = 0; Run < MicroRepeat; Run++)
+			{
+				lua_pushvalue(L, -1);
+				const auto Begin = FrameStats::Now();
+				lua_pcall(L, 0, 0, 0);
+				Runs.push_back(FrameStats::Now() - Begin);
+				lua_settop(L, 1);
+				lua_gc(L, LUA_GCCOLLECT, 0);
+			}
+
+			M.Vanilla = Median(Runs);
+			Micros.push_back(M);
+			lua_settop(L, 0);
+		}
+
+		lua_close(L);
+		return Micros;
+	}
+
+	void Benchmark::RunMicroHsvm(const DWORD rL, std::vector<Micro>& Micros)
+	{
+		const auto Translator = LuaTranslator::GetSingleton();
+
+		for (auto& M : Micros)
+		{
+			const auto It = std::find_if(MicroSuite().begin(), MicroSuite().end(), [&M](const Script& S) { return S.Name == M.Name; });
+
+			std::vector<double> Runs;
+			for (auto Run = 0; Run < MicroRepeat; Run++)
+			{
+				try
+				{
+					/* Compiled and converted once per run, only the call is timed */
+					const auto RL = Translator->Convert(RbxLua(rL), It->Source, 0);
+
+					const auto Begin = FrameStats::Now();
+					const auto Failed = RL.PCall(0, 0, 0) != 0;
+					const auto Elapsed = FrameStats::Now() - Begin;
+
+					RL.SetTop(0);
+					if (Failed)
+						break;
+					Runs.push_back(Elapsed);
+				}
+				catch (const std::exception&)
+				{
+					break;
+				}
+			}
+
+			M.Hsvm = Runs.size() == MicroRepeat ? Median(Runs) : 0;
+		}
+	}
+
+	std::string Benchmark::MicroReport(const std::vector<Micro>& Micros)
+	{
+		static const char* ClassNames[OC_COUNT] = { "load/move", "global", "table", "arith", "branch", "call", "loop" };
+
+		std::ostringstream oss;
+		oss << std::fixed << std::setprecision(1);
+		oss << std::left << std::setw(16) << "Benchmark" << std::right << std::setw(14) << "Instructions"
+			<< std::setw(14) << "Lua (us)" << std::setw(14) << "HSVM (us)" << std::setw(12) << "Lua Mi/s" << std::setw(12) << "HSVM Mi/s" << '\n';
+
+		/* Time spent per class is estimated by its share of each benchmark's instructions */
+		std::array<double, OC_COUNT> Count{}, VanillaTime{}, HsvmTime{};
+		for (const auto& M : Micros)
+		{
+			oss << std::left << std::setw(16) << M.Name << std::right << std::setw(14) << M.Instructions
+				<< std::setw(14) << M.Vanilla << std::setw(14) << M.Hsvm
+				<< std::setw(12) << (M.Vanilla > 0 ? M.Instructions / M.Vanilla : 0.0)
+				<< std::setw(12) << (M.Hsvm > 0 ? M.Instructions / M.Hsvm : 0.0) << '\n';
+
+			if (!M.Instructions)
+				continue;
+
+			for (auto C = 0; C < OC_COUNT; C++)
+			{
+				const auto Share = (double) M.Ops[C] / M.Instructions;
+				Count[C] += M.Ops[C];
+				VanillaTime[C] += M.Vanilla * Share;
+				HsvmTime[C] += M.Hsvm * Share;
+			}
+		}
+
+		oss << '\n' << std::left << std::setw(16) << "Opcode class" << std::right << std::setw(14) << "Instructions"
+			<< std::setw(12) << "Lua Mi/s" << std::setw(12) << "HSVM Mi/s" << '\n';
+		for (auto C = 0; C < OC_COUNT; C++)
+		{
+			oss << std::left << std::setw(16) << ClassNames[C] << std::right << std::setw(14) << (std::uint64_t) Count[C]
+				<< std::setw(12) << (VanillaTime[C] > 0 ? Count[C] / VanillaTime[C] : 0.0)
+				<< std::setw(12) << (HsvmTime[C] > 0 ? Count[C] / HsvmTime[C] : 0.0) << '\n';
+		}
+
+		return oss.str();
+	}
+
+	bool Benchmark::StartMicro(const std::wstring& Output)
+	{
+		if (Running.exchange(true))
+			return false;
+
+		std::thread([this, Output]
+		{
+			auto Micros = std::make_shared<std::vector<Micro>>(RunMicroVanilla());
+
+			Scheduler::GetSingleton()->Push([this, Output, Micros](const DWORD rL)
+			{
+				RunMicroHsvm(rL, *Micros);
+				std::ofstream(Output, std::ios::binary) << MicroReport(*Micros);
+				Running.store(false);
+			});
+		}).detach();
+
+		return true;
+	}
+
+	static constexpr float OverlayWidth = 1920;
+	static constexpr float OverlayHeight = 1080;
+
+	/* Fixed seed, every run draws the same scenes */
+	static void AddSyntheticLines(D3DScene& Scene, std::mt19937& Random, const size_t Count)
+	{
+		std::uniform_real_distribution<float> X(0, OverlayWidth), Y(0, OverlayHeight);
+		for (size_t i = 0; i < Count; i++)
+			Scene.Lines.push_back({ ImVec2(X(Random), Y(Random)), ImVec2(X(Random), Y(Random)), 0xFF000000 | Random(), 1.0f + (float) (i % 3) });
+	}
+
+	static void AddSyntheticTexts(D3DScene& Scene, std::mt19937& Random, const size_t Count)
+	{
+		std::uniform_real_distribution<float> X(0, OverlayWidth), Y(0, OverlayHeight);
+		for (size_t i = 0; i < Count; i++)
+		{
+			D3DText Text;
+			Text.Text = "Player" + std::to_string(i) + " [" + std::to_string(Random() % 1000) + "m]";
+			Text.Pos = ImVec2(X(Random), Y(Random));
+			Text.Size = 14.0f + (float) (i % 4) * 2;
+			Text.Color = 0xFF000000 | Random();
+			Text.Center = (BYTE) (i % 2);
+			Text.Outline = (BYTE) (i % 3 == 0);
+			Text.OutlineColor = 0xFF000000;
+			Scene.Texts.push_back(std::move(Text));
+		}
+	}
+
+	static void AddSyntheticShapes(D3DScene& Scene, std::mt19937& Random, const size_t Count)
+	{
+		std::uniform_real_distribution<float> X(0, OverlayWidth), Y(0, OverlayHeight), Size(4, 120);
+		for (size_t i = 0; i < Count; i++)
+		{
+			Scene.Squares.push_back({ ImVec2(X(Random), Y(Random)), ImVec2(Size(Random), Size(Random)), 0xFF000000 | Random(), 1.0f, (BYTE) (i % 2) });
+			Scene.Circles.push_back({ ImVec2(X(Random), Y(Random)), Size(Random) * 0.5f, 0xFF000000 | Random(), 1.0f, (BYTE) (i % 2), 24 });
+		}
+	}
+
+	/* Everything in one layer at ZIndex 0, like a script that never sets one */
+	static void FinishSyntheticScene(D3DScene& Scene)
+	{
+		SceneLayer Layer{};
+		Layer.End[D3_LINE] = Scene.Lines.size();
+		Layer.End[D3_TEXT] = Scene.Texts.size();
+		Layer.End[D3_SQUARE] = Scene.Squares.size();
+		Layer.End[D3_CIRCLE] = Scene.Circles.size();
+		Scene.Layers.push_back(Layer);
+	}
+
+	/* Stands in for the DataModel, children of a node are contiguous */
+	struct SyntheticNode
+	{
+		std::string Name;
+		size_t FirstChild;
+		size_t Children;
+	};
+
+	static std::vector<SyntheticNode> BuildSyntheticTree(const size_t FanOut, const int Depth)
+	{
+		std::vector<SyntheticNode> Nodes{ { "Game", 1, 0 } };
+
+		size_t LevelBegin = 0, LevelEnd = 1;
+		for (auto Level = 0; Level < Depth; Level++)
+		{
+			for (auto i = LevelBegin; i < LevelEnd; i++)
+			{
+				Nodes[i].FirstChild = Nodes.size();
+				Nodes[i].Children = Level + 1 < Depth ? FanOut : FanOut * 2;
+				for (size_t c = 0; c < Nodes[i].Children; c++)
+					Nodes.push_back({ "Instance" + std::to_string(Nodes.size()), 0, 0 });
+			}
+
+			LevelBegin = LevelEnd;
+			LevelEnd = Nodes.size();
+		}
+
+		return Nodes;
+	}
+
+	struct SyntheticRow
+	{
+		size_t Node;
+		int Depth;
+	};
+
+	/* Same walk and widgets as the Explorer window, with every node left open */
+	static void DrawSyntheticTree(const std::vector<SyntheticNode>& Nodes, std::vector<SyntheticRow>& Rows)
+	{
+		ImGui::SetNextWindowPos(ImVec2(0, 0), ImGuiCond_Always);
+		ImGui::SetNextWindowSize(ImVec2(420, OverlayHeight), ImGuiCond_Always);
+		ImGui::Begin("Explorer", NULL, NULL);
+
+		const auto Storage = ImGui::GetStateStorage();
+
+		Rows.clear();
+		std::vector<SyntheticRow> Stack{ { 0, -1 } };
+		while (!Stack.empty())
+		{
+			const auto Top = Stack.back();
+			Stack.pop_back();
+
+			if (Top.Depth >= 0)
+			{
+				Rows.push_back(Top);
+				if (!Nodes[Top.Node].Children || !Storage->GetInt(ImGui::GetID((void*)(uintptr_t) (Top.Node + 1)), 1))
+					continue;
+			}
+
+			const auto& Node = Nodes[Top.Node];
+			for (auto c = Node.Children; c-- > 0;)
+				Stack.push_back({ Node.FirstChild + c, Top.Depth + 1 });
+		}
+
+		const auto Texture = ImGui::GetIO().Fonts->TexID;
+
+		ImGuiListClipper Clipper((int) Rows.size());
+		while (Clipper.Step())
+		{
+			for (auto i = Clipper.DisplayStart; i < Clipper.DisplayEnd; i++)
+			{
+				const auto& Row = Rows[i];
+				const auto& Node = Nodes[Row.Node];
+
+				auto NodeFlags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick | ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_DefaultOpen;
+				if (!Node.Children)
+					NodeFlags |= ImGuiTreeNodeFlags_Leaf;
+
+				const auto Indent = Row.Depth * ImGui::GetTreeNodeToLabelSpacing();
+				if (Indent > 0)
+					ImGui::Indent(Indent);
+
+				ImGui::Image(Texture, ImVec2(16, 16), ImVec2(0, 0), ImVec2(0.01f, 0.01f));
+				ImGui::SameLine();
+				ImGui::TreeNodeEx((void*)(uintptr_t) (Row.Node + 1), NodeFlags, "%s", Node.Name.c_str());
+
+				if (Indent > 0)
+					ImGui::Unindent(Indent);
+			}
+		}
+
+		ImGui::End();
+	}
+
+	void Benchmark::RunOverlay(ID3D11Device* Device, ID3D11DeviceContext* Context)
+	{
+		std::vector<OverlayCase> Cases;
+
+		D3D11_TEXTURE2D_DESC Desc{};
+		Desc.Width = (UINT) OverlayWidth;
+		Desc.Height = (UINT) OverlayHeight;
+		Desc.MipLevels = 1;
+		Desc.ArraySize = 1;
+		Desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		Desc.SampleDesc.Count = 1;
+		Desc.Usage = D3D11_USAGE_DEFAULT;
+		Desc.BindFlags = D3D11_BIND_RENDER_TARGET;
+
+		ID3D11Texture2D* Target = NULL;
+		ID3D11RenderTargetView* TargetView = NULL;
+		if (FAILED(Device->CreateTexture2D(&Desc, NULL, &Target)) || FAILED(Device->CreateRenderTargetView(Target, NULL, &TargetView)))
+		{
+			if (Target)
+				Target->Release();
+
+			std::ofstream(OverlayOutput, std::ios::binary) << "Couldn't create the offscreen target\n";
+			OverlayPending.store(false);
+			Running.store(false);
+			return;
+		}
+
+		/* Shares the live atlas and style, nothing the overlay itself keeps (windows, open nodes, input) is touched */
+		const auto LiveContext = ImGui::GetCurrentContext();
+		const auto LiveStyle = ImGui::GetStyle();
+		const auto BenchContext = ImGui::CreateContext(ImGui::GetIO().Fonts);
+		ImGui::SetCurrentContext(BenchContext);
+		ImGui::GetStyle() = LiveStyle;
+
+		auto& IO = ImGui::GetIO();
+		IO.IniFilename = NULL;
+		IO.DisplaySize = ImVec2(OverlayWidth, OverlayHeight);
+		IO.DeltaTime = 1.0f / 60.0f;
+
+		const auto Renderer = D3D::GetSingleton();
+		std::mt19937 Random(0x5EED);
+
+		D3DScene Lines;
+		AddSyntheticLines(Lines, Random, 10000);
+		FinishSyntheticScene(Lines);
+
+		D3DScene Texts;
+		AddSyntheticTexts(Texts, Random, 2000);
+		FinishSyntheticScene(Texts);
+
+		/* Six children a node, twelve under the last level: 1,554 folders and 15,552 leaves */
+		const auto Tree = BuildSyntheticTree(6, 5);
+		std::vector<SyntheticRow> Rows;
+
+		D3DScene Mixed;
+		AddSyntheticLines(Mixed, Random, 10000);
+		AddSyntheticTexts(Mixed, Random, 2000);
+		AddSyntheticShapes(Mixed, Random, 1000);
+		FinishSyntheticScene(Mixed);
+
+		const D3DScene Empty;
+		const struct
+		{
+			const char* Name;
+			const D3DScene* Scene;
+			bool Tree;
+		} Suite[] =
+		{
+			{ "10k lines", &Lines, false },
+			{ "2k text labels", &Texts, false },
+			{ "Explorer tree", &Empty, true },
+			{ "Mixed + tree", &Mixed, true },
+		};
+
+		for (const auto& Entry : Suite)
+		{
+			OverlayCase Case;
+			Case.Name = Entry.Name;
+
+			for (auto Frame = 0; Frame < OverlayWarmup + OverlayFrames; Frame++)
+			{
+				const auto BuildStart = FrameStats::Now();
+
+				ImGui_ImplDX11_NewFrame();
+				ImGui::NewFrame();
+
+				Renderer->BeginScene();
+				Renderer->DrawScene(*Entry.Scene);
+				Renderer->EndScene();
+
+				if (Entry.Tree)
+					DrawSyntheticTree(Tree, Rows);
+
+				ImGui::Render();
+
+				const auto SubmitStart = FrameStats::Now();
+
+				Context->OMSetRenderTargets(1, &TargetView, NULL);
+				const auto DrawData = ImGui::GetDrawData();
+				ImGui_ImplDX11_RenderDrawData(DrawData);
+
+				const auto SubmitEnd = FrameStats::Now();
+
+				if (Frame < OverlayWarmup)
+					continue;
+
+				Case.Build.push_back(SubmitStart - BuildStart);
+				Case.Submit.push_back(SubmitEnd - SubmitStart);
+
+				Case.Vertices = DrawData->TotalVtxCount;
+				Case.Indices = DrawData->TotalIdxCount;
+				Case.DrawCalls = 0;
+				for (auto i = 0; i < DrawData->CmdListsCount; i++)
+					Case.DrawCalls += DrawData->CmdLists[i]->CmdBuffer.Size;
+			}
+
+			Cases.push_back(std::move(Case));
+		}
+
+		ImGui::DestroyContext(BenchContext);
+		ImGui::SetCurrentContext(LiveContext);
+
+		TargetView->Release();
+		Target->Release();
+
+		std::ofstream(OverlayOutput, std::ios::binary) << OverlayReport(Cases);
+		OverlayPending.store(false);
+		Running.store(false);
+	}
+
+	std::string Benchmark::OverlayReport(const std::vector<OverlayCase>& Cases)
+	{
+		std::ostringstream oss;
+		oss << OverlayFrames << " frames per case at " << (int) OverlayWidth << "x" << (int) OverlayHeight
+			<< (synf::UseInstancedDrawing && D3D::GetSingleton()->Instancer.Ready() ? ", instanced shapes" : ", ImDrawList shapes") << "\n\n";
+		oss << std::left << std::setw(18) << "Case" << std::right
+			<< std::setw(12) << "Build p50" << std::setw(12) << "Build p99"
+			<< std::setw(13) << "Submit p50" << std::setw(13) << "Submit p99"
+			<< std::setw(12) << "Vertices" << std::setw(12) << "Indices" << std::setw(8) << "Draws" << '\n';
+
+		oss << std::fixed << std::setprecision(1);
+		for (const auto& C : Cases)
+		{
+			oss << std::left << std::setw(18) << C.Name << std::right
+				<< std::setw(12) << Percentile(C.Build, 50) << std::setw(12) << Percentile(C.Build, 99)
+				<< std::setw(13) << Percentile(C.Submit, 50) << std::setw(13) << Percentile(C.Submit, 99)
+				<< std::setw(12) << C.Vertices << std::setw(12) << C.Indices << std::setw(8) << C.DrawCalls << '\n';
+		}
+
+		oss << "\nTimes are CPU microseconds on the render thread, Submit covers the vertex upload and draw calls but not the GPU\n";
+		return oss.str();
+	}
+
+	bool Benchmark::StartOverlay(const std::wstring& Output)
+	{
+		if (Running.exchange(true))
+			return false;
+
+		OverlayOutput = Output;
+		OverlayPending.store(true, std::memory_order_release);
+		return true;
+	}
+}
+
+#endif
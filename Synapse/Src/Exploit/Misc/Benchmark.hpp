@@ -0,0 +1,132 @@
+
+/*
+*
+*	SYNAPSE X
+*	File.:	Benchmark.hpp
+*	Desc.:	Compile pipeline, VM micro and overlay benchmarks, latencies, allocations, instruction rates and frame costs
+*
+*/
+
+#pragma once
+
+#include "Static.hpp"
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <vector>
+
+struct ID3D11Device;
+struct ID3D11DeviceContext;
+
+namespace syn
+{
+#ifdef EnableBenchmarks
+	class Benchmark
+	{
+	public:
+		/* Every script goes through every stage this many times, the first run warms the string tables */
+		static constexpr int Repeat = 8;
+
+		struct Script
+		{
+			std::string Name;
+			std::string Source;
+		};
+
+		struct Stage
+		{
+			std::string Name;
+			std::vector<double> Micros;	/* one per script run */
+			std::uint64_t Bytes = 0;	/* allocated by the stage, summed over all runs */
+			std::uint64_t Input = 0;	/* source bytes fed to the stage, summed over all runs */
+			std::uint64_t Failures = 0;
+		};
+
+		/* Opcode groups instruction rates are reported for */
+		enum OpClass
+		{
+			OC_LOAD,		/* moves, constants, upvalues */
+			OC_GLOBAL,
+			OC_TABLE,
+			OC_ARITH,		/* arithmetic, unary, concat */
+			OC_BRANCH,		/* jumps, compares, tests */
+			OC_CALL,		/* calls, returns, closures, varargs */
+			OC_LOOP,
+			OC_COUNT
+		};
+
+		struct Micro
+		{
+			std::string Name;
+			std::array<std::uint64_t, OC_COUNT> Ops{};	/* one run, counted on vanilla Lua */
+			std::uint64_t Instructions = 0;
+			double Vanilla = 0;							/* median run, us */
+			double Hsvm = 0;							/* median run, us, 0 if it didn't run */
+		};
+
+		/* Frames timed per overlay case, after OverlayWarmup untimed ones */
+		static constexpr int OverlayFrames = 240;
+		static constexpr int OverlayWarmup = 16;
+
+		struct OverlayCase
+		{
+			std::string Name;
+			std::vector<double> Build;		/* NewFrame through Render, us per frame */
+			std::vector<double> Submit;		/* ImGui_ImplDX11_RenderDrawData, us per frame */
+			DWORD Vertices = 0;				/* last frame */
+			DWORD Indices = 0;
+			DWORD DrawCalls = 0;
+		};
+
+		std::atomic<bool> Running{ false };
+
+		/* Set by StartOverlay, PresentHook runs the overlay benchmark on its next frame */
+		std::atomic<bool> OverlayPending{ false };
+
+		static Benchmark* GetSingleton();
+
+		/* Every .lua and .txt file below Path, recursively */
+		static std::vector<Script> LoadCorpus(const std::wstring& Path);
+
+		/* Runs the corpus through luaL_loadbuffer, the Luau translator and the Lorraine lexer without touching the game */
+		std::vector<Stage> RunPipeline(const std::vector<Script>& Corpus);
+
+		/* Table of p50/p99 (us), allocations and MB/s per stage */
+		static std::string Report(const std::vector<Stage>& Stages, size_t Scripts);
+
+		/* Loads Corpus and writes the report to Output on a worker thread, false if a run is already going */
+		bool Start(const std::wstring& Corpus, const std::wstring& Output);
+
+		/* fib, table inserts, string concat, method calls and a numeric for loop */
+		static const std::vector<Script>& MicroSuite();
+
+		static OpClass ClassOf(OpCode Op);
+
+		/* Instruction mix and timings on the bundled lvm.c, offline */
+		std::vector<Micro> RunMicroVanilla();
+
+		/* Same sources through the normal execute path on the game thread, so LuaU games run them on HSVM */
+		void RunMicroHsvm(DWORD rL, std::vector<Micro>& Micros);
+
+		/* Per benchmark timings plus instructions/sec per opcode class for both VMs */
+		static std::string MicroReport(const std::vector<Micro>& Micros);
+
+		/* Vanilla on a worker thread, then HSVM on the next scheduler step, false if a run is already going */
+		bool StartMicro(const std::wstring& Output);
+
+		/* Render thread, from PresentHook. Draws 10k lines, 2k text labels, an expanded explorer sized tree and all of
+		   them together through D3D::DrawScene and the DX11 backend, in a private ImGui context onto an offscreen target */
+		void RunOverlay(ID3D11Device* Device, ID3D11DeviceContext* Context);
+
+		/* p50/p99 build and submit time per case, plus the last frame's vertices, indices and draw calls */
+		static std::string OverlayReport(const std::vector<OverlayCase>& Cases);
+
+		/* Queues RunOverlay for the next Present, false if a run is already going */
+		bool StartOverlay(const std::wstring& Output);
+
+	private:
+		std::wstring OverlayOutput;
+	};
+#endif
+}
@@ -0,0 +1,223 @@
+#include "./Channel.hpp"
+
+#include <thread>
+
+namespace syn
+{
+	Channel* Channel::GetSingleton()
+	{
+		static Channel* channel = nullptr;
+		if (channel == nullptr)
+			channel = new Channel();
+
+		return channel;
+	}
+
+	void Channel::Start(const std::string& Name, Handler Callback)
+	{
+		OnMessage = std::move(Callback);
+
+		ReadEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+		WriteEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+		SendEvent = CreateEventA(NULL, FALSE, FALSE, NULL);
+
+		std::thread([this, Name] { Run(Name); }).detach();
+	}
+
+	void Channel::Send(const ChannelMessage Type, const std::string& Payload)
+	{
+		if (!Connected())
+			return;
+
+		const auto Length = (std::uint32_t) Payload.size();
+
+		{
+			std::lock_guard<std::mutex> Guard(SendMutex);
+
+			const auto Offset = Outgoing.size();
+			Outgoing.resize(Offset + 5 + Payload.size());
+			memcpy(Outgoing.data() + Offset, &Length, 4);
+			Outgoing[Offset + 4] = (char) Type;
+			memcpy(Outgoing.data() + Offset + 5, Payload.data(), Payload.size());
+		}
+
+		SetEvent(SendEvent);
+	}
+
+	void Channel::Run(const std::string& Name)
+	{
+		const auto Path = std::string("\\\\.\\pipe\\") + Name;
+
+		while (true)
+		{
+			Pipe = CreateNamedPipeA(Path.c_str(),
+				PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED,
+				PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT,
+				1,
+				PipeBufferSize,
+				PipeBufferSize,
+				0,
+				NULL);
+
+			if (Pipe == INVALID_HANDLE_VALUE)
+			{
+				Sleep(1000);
+				continue;
+			}
+
+			OVERLAPPED Overlapped{};
+			Overlapped.hEvent = ReadEvent;
+
+			auto Accepted = ConnectNamedPipe(Pipe, &Overlapped) != FALSE;
+			if (!Accepted)
+			{
+				const auto Error = GetLastError();
+				if (Error == ERROR_IO_PENDING)
+				{
+					DWORD Unused;
+					Accepted = GetOverlappedResult(Pipe, &Overlapped, &Unused, TRUE) != FALSE;
+				}
+				else
+				{
+					Accepted = Error == ERROR_PIPE_CONNECTED;
+				}
+			}
+
+			if (Accepted)
+			{
+				IsConnected.store(true);
+				Serve();
+				IsConnected.store(false);
+
+				std::lock_guard<std::mutex> Guard(SendMutex);
+				Outgoing.clear();
+			}
+
+			DisconnectNamedPipe(Pipe);
+			CloseHandle(Pipe);
+			Pipe = INVALID_HANDLE_VALUE;
+		}
+	}
+
+	/* Keeps one read pending while writing whatever Send queued, until the client goes away.
+	   Headers and frames that fit go through ReadBuffer, the rest of a larger frame is read straight into its presized
+	   payload, which is then moved all the way to the scheduler */
+	bool Channel::Serve()
+	{
+		std::vector<char> ReadBuffer(PipeBufferSize);
+		size_t Buffered = 0;
+
+		std::string Payload;
+		size_t Filled = 0;
+		auto PayloadType = CM_INIT;
+		auto InPayload = false;
+
+		while (true)
+		{
+			OVERLAPPED Overlapped{};
+			Overlapped.hEvent = ReadEvent;
+
+			const auto Target = InPayload ? &Payload[Filled] : ReadBuffer.data() + Buffered;
+			const auto Wanted = (DWORD) (InPayload ? Payload.size() - Filled : PipeBufferSize - Buffered);
+
+			if (!ReadFile(Pipe, Target, Wanted, NULL, &Overlapped) && GetLastError() != ERROR_IO_PENDING)
+				return false;
+
+			while (true)
+			{
+				const HANDLE Events[] = { ReadEvent, SendEvent };
+				const auto Signaled = WaitForMultipleObjects(2, Events, FALSE, INFINITE);
+
+				if (Signaled == WAIT_OBJECT_0 + 1)
+				{
+					if (!Flush())
+					{
+						CancelIo(Pipe);
+						return false;
+					}
+
+					continue;
+				}
+
+				if (Signaled != WAIT_OBJECT_0)
+				{
+					CancelIo(Pipe);
+					return false;
+				}
+
+				break;
+			}
+
+			DWORD Read;
+			if (!GetOverlappedResult(Pipe, &Overlapped, &Read, FALSE))
+				return false;
+
+			if (InPayload)
+			{
+				Filled += Read;
+				if (Filled == Payload.size())
+				{
+					InPayload = false;
+					OnMessage(PayloadType, std::move(Payload));
+					Payload = std::string();
+				}
+
+				continue;
+			}
+
+			Buffered += Read;
+
+			size_t Position = 0;
+			while (Buffered - Position >= 5)
+			{
+				std::uint32_t Length;
+				memcpy(&Length, ReadBuffer.data() + Position, 4);
+
+				if (Length > MaxFrameSize)
+					return false;
+
+				const auto Type = (ChannelMessage) ReadBuffer[Position + 4];
+				const auto Available = Buffered - Position - 5;
+
+				if (Available >= Length)
+				{
+					OnMessage(Type, std::string(ReadBuffer.data() + Position + 5, Length));
+					Position += 5 + Length;
+					continue;
+				}
+
+				/* Only part of the body is here, whatever follows it can't be in the buffer yet */
+				Payload.resize(Length);
+				memcpy(&Payload[0], ReadBuffer.data() + Position + 5, Available);
+				Filled = Available;
+				PayloadType = Type;
+				InPayload = true;
+				Position = Buffered;
+			}
+
+			memmove(ReadBuffer.data(), ReadBuffer.data() + Position, Buffered - Position);
+			Buffered -= Position;
+		}
+	}
+
+	bool Channel::Flush()
+	{
+		{
+			std::lock_guard<std::mutex> Guard(SendMutex);
+			Writing.swap(Outgoing);
+		}
+
+		if (Writing.empty())
+			return true;
+
+		OVERLAPPED Overlapped{};
+		Overlapped.hEvent = WriteEvent;
+
+		DWORD Written = 0;
+		const auto Ok = (WriteFile(Pipe, Writing.data(), (DWORD) Writing.size(), NULL, &Overlapped) || GetLastError() == ERROR_IO_PENDING)
+			&& GetOverlappedResult(Pipe, &Overlapped, &Written, TRUE);
+
+		Writing.clear();
+		return Ok;
+	}
+}
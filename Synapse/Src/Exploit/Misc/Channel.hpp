@@ -0,0 +1,70 @@
+
+/*
+*
+*	SYNAPSE X
+*	File.:	Channel.hpp
+*	Desc.:	Persistent framed duplex pipe between Synapse and the UI
+*
+*/
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Static.hpp"
+
+namespace syn
+{
+	/* Every frame is a little endian uint32 payload length, a type byte, then the payload */
+	enum ChannelMessage : BYTE
+	{
+		CM_INIT = 1,	/* UI -> Synapse, the SYN_FILE_PATH|... settings string the legacy pipe sends first */
+		CM_EXECUTE,		/* UI -> Synapse, script source or bytecode */
+		CM_EDITOR,		/* UI -> Synapse, text for the in-game editor */
+		CM_STATUS,		/* Synapse -> UI, SYN_READY and friends */
+		CM_CONSOLE,		/* Synapse -> UI, console lines pushed during a scheduler step, newline separated */
+		CM_EXECUTE_DEFLATE,	/* UI -> Synapse, uint32 source size then the raw deflate stream, once DEFLATE was agreed in CM_INIT */
+		CM_METRICS		/* Synapse -> UI, Metrics::Format once per Metrics::Interval */
+	};
+
+	class Channel
+	{
+	public:
+		static constexpr DWORD PipeBufferSize = 64 * 1024;
+		static constexpr DWORD MaxFrameSize = 64 * 1024 * 1024;
+
+		typedef std::function<void(ChannelMessage, std::string&&)> Handler;
+
+		static Channel* GetSingleton();
+
+		/* Serves Name on its own thread, accepting one client at a time and reconnecting when it leaves */
+		void Start(const std::string& Name, Handler OnMessage);
+
+		/* Queues a frame for the client, dropped when none is connected. Never blocks on the pipe */
+		void Send(ChannelMessage Type, const std::string& Payload);
+
+		bool Connected() const { return IsConnected.load(std::memory_order_relaxed); }
+
+	private:
+		void Run(const std::string& Name);
+		bool Serve();
+		bool Flush();
+
+		Handler OnMessage;
+
+		HANDLE Pipe = INVALID_HANDLE_VALUE;
+		HANDLE ReadEvent = NULL;
+		HANDLE SendEvent = NULL;
+		HANDLE WriteEvent = NULL;
+
+		std::atomic<bool> IsConnected{ false };
+
+		std::mutex SendMutex;
+		std::vector<char> Outgoing;	/* frames queued since the last write, written with a single WriteFile */
+		std::vector<char> Writing;
+	};
+}
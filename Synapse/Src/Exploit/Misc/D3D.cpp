@@ -1,6 +1,18 @@
 #include "./D3D.hpp"
 
 #include "./ExplorerIcons.hpp"
+#include "./ExplorerSearch.hpp"
+#include "./Benchmark.hpp"
+#include "./FrameStats.hpp"
+#include "./Metrics.hpp"
+#include "./ScriptStats.hpp"
+#include "./Profiler.hpp"
+#include "./Channel.hpp"
+#include "./Flags.hpp"
+
+#define XXH_STATIC_LINKING_ONLY
+#define XXH_INLINE_ALL
+#include "../../Utilities/Hashing/XXHash/xxhash.h"
 
 #include "../../Source Dependencies/ImGUI/imgui.h"
 #include "../../Source Dependencies/ImGUI/imgui_internal.h"
@@ -8,10 +20,16 @@
 
 #include "../Execution/RbxApi.hpp"
 #include "../Execution/Scheduler.hpp"
+#include "../Execution/Virtual Machine/HSVMProfiler.hpp"
 
 #include "../../Utilities/Scanner.hpp"
 #include "../../Utilities/MemSpoofer.hpp"
 #include "../../Utilities/Hashing/fnv.hpp"
+#include "../../Utilities/ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
 
 namespace syn
 {
@@ -71,8 +89,14 @@ namespace syn
 		return 0;
 	}
 
-	void syn::D3D::SetupFPSUnlocker()
+	bool syn::D3D::SetupFPSUnlocker()
 	{
+		/* The scan only ever runs once, later calls just report whether it worked */
+		static auto Scanned = false;
+		if (Scanned)
+			return FPSUnlocked != FALSE;
+		Scanned = true;
+
 		TaskSched = FindTaskScheduler();
 		if (!TaskSched)
 		{
@@ -80,7 +104,7 @@ namespace syn
 				NULL,
 				"Failed to find required variables for FPS unlocker (1) - it will be disabled. Please wait for Synapse to update.",
 				"Synapse X", MB_OK);
-			return;
+			return false;
 		}
 		TaskSchedDelay = FindDelayOffset(TaskSched);
 		if (!TaskSchedDelay)
@@ -89,9 +113,85 @@ namespace syn
 				NULL,
 				"Failed to find required variables for FPS unlocker (2) - it will be disabled. Please wait for Synapse to update.",
 				"Synapse X", MB_OK);
-			return;
+			return false;
 		}
 		FPSUnlocked = TRUE;
+		return true;
+	}
+
+	bool syn::D3D::SetFPSCap(const double FPS, const bool LowLatency)
+	{
+		if (!SetupFPSUnlocker())
+			return false;
+
+		FPSCap.store(FPS > 0 ? FPS : 0);
+		FPSLowLatency.store(LowLatency);
+		return true;
+	}
+
+	double syn::D3D::GetSchedulerDelay()
+	{
+		/* Slightly under the cap's interval so Roblox's scheduler never ends up as the limiter, PaceFrame owns the spacing */
+		const auto Cap = FPSCap.load(std::memory_order_relaxed);
+		return Cap > 0 ? 1.0 / (Cap * 1.05) : 1.0 / 60.0;
+	}
+
+	void syn::D3D::PaceFrame()
+	{
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+		static HANDLE Timer = NULL;
+		static LARGE_INTEGER Frequency{};
+		static LONGLONG Deadline = 0;
+
+		const auto Cap = FPSCap.load(std::memory_order_relaxed);
+		if (!FPSUnlocked || Cap <= 0)
+		{
+			Deadline = 0;
+			return;
+		}
+
+		if (!Frequency.QuadPart)
+		{
+			QueryPerformanceFrequency(&Frequency);
+
+			/* High resolution timers need 1803+, older systems get a regular one (and a longer spin) */
+			Timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+			if (!Timer)
+				Timer = CreateWaitableTimerW(NULL, FALSE, NULL);
+		}
+
+		LARGE_INTEGER Now;
+		QueryPerformanceCounter(&Now);
+
+		const auto Interval = (LONGLONG) (Frequency.QuadPart / Cap);
+
+		/* First frame, or more than a frame behind: start over instead of rushing to catch up */
+		if (!Deadline || Now.QuadPart - Deadline > Interval)
+		{
+			Deadline = Now.QuadPart + Interval;
+			return;
+		}
+
+		/* Sleep on the timer until the last stretch, then spin on the counter for the rest */
+		const auto SpinTicks = Frequency.QuadPart / 1000 * 2;
+		const auto Remaining = Deadline - Now.QuadPart;
+		if (Timer && Remaining > SpinTicks)
+		{
+			LARGE_INTEGER Due;
+			Due.QuadPart = -((Remaining - SpinTicks) * 10000000 / Frequency.QuadPart);
+			if (SetWaitableTimer(Timer, &Due, 0, NULL, NULL, FALSE))
+				WaitForSingleObject(Timer, INFINITE);
+		}
+
+		do
+		{
+			YieldProcessor();
+			QueryPerformanceCounter(&Now);
+		} while (Now.QuadPart < Deadline);
+
+		Deadline += Interval;
 	}
 
 	std::wstring syn::D3D::GetWorkingPath()
@@ -149,6 +249,8 @@ namespace syn
 		wcscpy(IniPath, (GetWorkingPath() + L"\\bin\\ImGui.ini").c_str());
 		ImGui::GetIO().IniFilename = IniPath;
 
+		LoadExplorerProperties();
+
 		return true;
 	}
 
@@ -160,9 +262,19 @@ namespace syn
 		return d3d;
 	}
 
-	void syn::D3D::AddFont(ImFont* _Font)
+	void syn::D3D::InitializeFonts()
 	{
-		Fonts.push_back(_Font);
+		FontCache.Initialize(Fonts);
+	}
+
+	bool syn::D3D::UpdateFonts()
+	{
+		if (!FontCache.Update(Fonts))
+			return false;
+
+		/* Cached runs hold UVs into the old atlas */
+		GlyphRuns.clear();
+		return true;
 	}
 
 	ImFont* syn::D3D::GetFont(int idx) const
@@ -180,49 +292,376 @@ namespace syn
 		ImGui::SetWindowSize(ImVec2(ImGui::GetIO().DisplaySize.x, ImGui::GetIO().DisplaySize.y), ImGuiSetCond_Always);
 	}
 
+	static void DrawSceneChunk(ImDrawList* DrawList, const D3DScene& Scene, const SceneChunk& Chunk)
+	{
+		switch (Chunk.Batch)
+		{
+			case SB_LINES:
+			{
+				for (auto i = Chunk.Begin; i < Chunk.End; i++)
+				{
+					const auto& Line = Scene.Lines[i];
+					DrawList->AddLine(Line.From, Line.To, Line.Color, Line.Thickness);
+				}
+				break;
+			}
+			case SB_SQUARES:
+			{
+				for (auto i = Chunk.Begin; i < Chunk.End; i++)
+				{
+					const auto& Square = Scene.Squares[i];
+					if (!Square.Filled)
+						DrawList->AddRect(Square.Pos, ImVec2(Square.Pos.x + Square.Size.x, Square.Pos.y + Square.Size.y), Square.Color, 0, ~0, Square.Thickness);
+				}
+				break;
+			}
+			case SB_FILLED_SQUARES:
+			{
+				/* Filled squares share one reservation */
+				auto FilledSquares = 0;
+				for (auto i = Chunk.Begin; i < Chunk.End; i++)
+					FilledSquares += Scene.Squares[i].Filled ? 1 : 0;
+
+				if (!FilledSquares)
+					break;
+
+				DrawList->PrimReserve(FilledSquares * 6, FilledSquares * 4);
+				for (auto i = Chunk.Begin; i < Chunk.End; i++)
+				{
+					const auto& Square = Scene.Squares[i];
+					if (Square.Filled)
+						DrawList->PrimRect(Square.Pos, ImVec2(Square.Pos.x + Square.Size.x, Square.Pos.y + Square.Size.y), Square.Color);
+				}
+				break;
+			}
+			case SB_CIRCLES:
+			{
+				for (auto i = Chunk.Begin; i < Chunk.End; i++)
+				{
+					const auto& Circle = Scene.Circles[i];
+					if (Circle.Filled)
+						DrawList->AddCircleFilled(Circle.Pos, Circle.Radius, Circle.Color, Circle.Sides);
+					else
+						DrawList->AddCircle(Circle.Pos, Circle.Radius, Circle.Color, Circle.Sides, Circle.Thickness);
+				}
+				break;
+			}
+		}
+	}
+
+	/* Straight onto ImDrawList, the instancer has no shape for arbitrary points */
+	static void DrawScenePolys(ImDrawList* DrawList, const D3DScene& Scene, const SceneLayer& Layer)
+	{
+		for (auto i = Layer.Begin[D3_POLYLINE]; i < Layer.End[D3_POLYLINE]; i++)
+		{
+			const auto& Polyline = Scene.Polylines[i];
+			const auto Count = (int) Polyline.Points.size();
+			if (Count < 2)
+				continue;
+
+			if (Polyline.Filled && Count >= 3)
+				DrawList->AddConvexPolyFilled(Polyline.Points.data(), Count, Polyline.Color);
+			else
+				DrawList->AddPolyline(Polyline.Points.data(), Count, Polyline.Color, Polyline.Closed, Polyline.Thickness);
+		}
+
+		for (auto i = Layer.Begin[D3_POLYGON]; i < Layer.End[D3_POLYGON]; i++)
+		{
+			const auto& Polygon = Scene.Polygons[i];
+			const auto& P = Polygon.Points;
+			if (Polygon.Count == 3)
+			{
+				if (Polygon.Filled)
+					DrawList->AddTriangleFilled(P[0], P[1], P[2], Polygon.Color);
+				else
+					DrawList->AddTriangle(P[0], P[1], P[2], Polygon.Color, Polygon.Thickness);
+			}
+			else
+			{
+				if (Polygon.Filled)
+					DrawList->AddQuadFilled(P[0], P[1], P[2], P[3], Polygon.Color);
+				else
+					DrawList->AddQuad(P[0], P[1], P[2], P[3], Polygon.Color, Polygon.Thickness);
+			}
+		}
+	}
+
+	/* One textured quad each, images still decoding are skipped until their texture exists */
+	static void DrawSceneImages(ImDrawList* DrawList, const D3DScene& Scene, const SceneLayer& Layer)
+	{
+		for (auto i = Layer.Begin[D3_IMAGE]; i < Layer.End[D3_IMAGE]; i++)
+		{
+			const auto& Image = Scene.Images[i];
+			const auto Texture = Image.Image ? Image.Image->Texture() : NULL;
+			if (!Texture)
+				continue;
+
+			/* No size set draws it at its own */
+			const auto Size = Image.Size.x == 0 && Image.Size.y == 0 ? Image.Image->Size() : Image.Size;
+			const ImVec2 Max(Image.Pos.x + Size.x, Image.Pos.y + Size.y);
+			if (Image.Rounding > 0)
+				DrawList->AddImageRounded(Texture, Image.Pos, Max, ImVec2(0, 0), ImVec2(1, 1), Image.Color, Image.Rounding);
+			else
+				DrawList->AddImage(Texture, Image.Pos, Max, ImVec2(0, 0), ImVec2(1, 1), Image.Color);
+		}
+	}
+
+	/* Appends Source's geometry to DrawList, one command's vertex range at a time so 16 bit indices never overflow */
+	static void AppendDrawList(ImDrawList* DrawList, const ImDrawList& Source)
+	{
+		for (auto c = 0; c < Source.CmdBuffer.Size; c++)
+		{
+			const auto& Cmd = Source.CmdBuffer[c];
+			if (!Cmd.ElemCount)
+				continue;
+
+			auto VtxEnd = (unsigned int) Source.VtxBuffer.Size;
+			for (auto n = c + 1; n < Source.CmdBuffer.Size; n++)
+			{
+				if (Source.CmdBuffer[n].VtxOffset != Cmd.VtxOffset)
+				{
+					VtxEnd = Source.CmdBuffer[n].VtxOffset;
+					break;
+				}
+			}
+
+			const auto VtxCount = (int) (VtxEnd - Cmd.VtxOffset);
+			DrawList->PrimReserve((int) Cmd.ElemCount, VtxCount);
+
+			memcpy(DrawList->_VtxWritePtr, Source.VtxBuffer.Data + Cmd.VtxOffset, VtxCount * sizeof(ImDrawVert));
+
+			const auto Base = DrawList->_VtxCurrentIdx;
+			const auto Indices = Source.IdxBuffer.Data + Cmd.IdxOffset;
+			for (unsigned int i = 0; i < Cmd.ElemCount; i++)
+				DrawList->_IdxWritePtr[i] = (ImDrawIdx) (Indices[i] + Base);
+
+			DrawList->_VtxWritePtr += VtxCount;
+			DrawList->_IdxWritePtr += Cmd.ElemCount;
+			DrawList->_VtxCurrentIdx += VtxCount;
+		}
+	}
+
+	/* Splits the scene into ParallelSceneChunk sized chunks, tessellates each into its own list on the pool and merges them in order */
+	void syn::D3D::DrawSceneParallel(ImDrawList* DrawList, const D3DScene& Scene, const SceneChunk (&Batches)[4], const size_t Helpers) const
+	{
+		struct ParallelState
+		{
+			std::atomic<size_t> Next{ 0 };
+			std::atomic<size_t> Done{ 0 };
+			std::mutex Mutex;
+			std::condition_variable Finished;
+		};
+
+		SceneChunks.clear();
+		for (const auto& Batch : Batches)
+			for (auto Begin = Batch.Begin; Begin < Batch.End; Begin += ParallelSceneChunk)
+				SceneChunks.push_back({ Batch.Batch, Begin, (std::min)(Begin + ParallelSceneChunk, Batch.End) });
+
+		const auto Count = SceneChunks.size();
+		while (SceneLists.size() < Count)
+			SceneLists.push_back(std::make_unique<ImDrawList>(ImGui::GetDrawListSharedData()));
+
+		for (size_t i = 0; i < Count; i++)
+		{
+			auto& List = *SceneLists[i];
+			List.Clear();
+			List.PushTextureID(DrawList->_TextureIdStack.back());
+			List.PushClipRect(ImVec2(DrawList->_ClipRectStack.back().x, DrawList->_ClipRectStack.back().y),
+				ImVec2(DrawList->_ClipRectStack.back().z, DrawList->_ClipRectStack.back().w));
+		}
+
+		/* Helpers that start after the caller ran out of work only touch the shared counters */
+		const auto State = std::make_shared<ParallelState>();
+		const auto Work = [this, State, &Scene, Count]()
+		{
+			size_t Index;
+			while ((Index = State->Next.fetch_add(1)) < Count)
+			{
+				DrawSceneChunk(SceneLists[Index].get(), Scene, SceneChunks[Index]);
+
+				if (State->Done.fetch_add(1) + 1 == Count)
+				{
+					std::lock_guard<std::mutex> Guard(State->Mutex);
+					State->Finished.notify_one();
+				}
+			}
+		};
+
+		/* The render thread draws chunks too, helpers the pool can't take right now are simply not needed */
+		for (size_t i = 0; i < (std::min)(Helpers, Count - 1); i++)
+			if (!syn::ThreadPool::GetSingleton()->TrySubmit(Work))
+				break;
+
+		Work();
+
+		{
+			std::unique_lock<std::mutex> Lock(State->Mutex);
+			State->Finished.wait(Lock, [&State, Count]() { return State->Done.load() == Count; });
+		}
+
+		for (size_t i = 0; i < Count; i++)
+			AppendDrawList(DrawList, *SceneLists[i]);
+	}
+
+	void syn::D3D::PublishScene()
+	{
+		if (KeptSince)
+			ExpireKeptRenderObjects();
+
+		if (!SceneDirty)
+			return;
+
+		auto& Scene = Scenes[SceneBack];
+		Lines.CopyVisible(Scene.Lines, LayerRanges[D3_LINE]);
+		Texts.CopyVisible(Scene.Texts, LayerRanges[D3_TEXT]);
+		Squares.CopyVisible(Scene.Squares, LayerRanges[D3_SQUARE]);
+		Circles.CopyVisible(Scene.Circles, LayerRanges[D3_CIRCLE]);
+		Images.CopyVisible(Scene.Images, LayerRanges[D3_IMAGE]);
+		Polylines.CopyVisible(Scene.Polylines, LayerRanges[D3_POLYLINE]);
+		Polygons.CopyVisible(Scene.Polygons, LayerRanges[D3_POLYGON]);
+
+		/* Merge the per-type layers by ZIndex, every type's ranges are already in ascending order */
+		size_t Next[D3_TYPE_COUNT]{};
+		size_t Ends[D3_TYPE_COUNT]{};
+		Scene.Layers.clear();
+
+		while (true)
+		{
+			auto Found = false;
+			auto ZIndex = 0;
+			for (auto Type = 0; Type < D3_TYPE_COUNT; Type++)
+			{
+				if (Next[Type] < LayerRanges[Type].size() && (!Found || LayerRanges[Type][Next[Type]].first < ZIndex))
+				{
+					ZIndex = LayerRanges[Type][Next[Type]].first;
+					Found = true;
+				}
+			}
+
+			if (!Found)
+				break;
+
+			SceneLayer Layer{ ZIndex };
+			for (auto Type = 0; Type < D3_TYPE_COUNT; Type++)
+			{
+				Layer.Begin[Type] = Ends[Type];
+				if (Next[Type] < LayerRanges[Type].size() && LayerRanges[Type][Next[Type]].first == ZIndex)
+					Ends[Type] = LayerRanges[Type][Next[Type]++].second;
+				Layer.End[Type] = Ends[Type];
+			}
+
+			Scene.Layers.push_back(Layer);
+		}
+
+		Scene.Counts[D3_LINE] = Lines.Count();
+		Scene.Counts[D3_TEXT] = Texts.Count();
+		Scene.Counts[D3_SQUARE] = Squares.Count();
+		Scene.Counts[D3_CIRCLE] = Circles.Count();
+		Scene.Counts[D3_IMAGE] = Images.Count();
+		Scene.Counts[D3_POLYLINE] = Polylines.Count();
+		Scene.Counts[D3_POLYGON] = Polygons.Count();
+
+		DWORD Total = 0;
+		for (const auto Count : Scene.Counts)
+			Total += Count;
+		Metrics::GetSingleton()->RenderObjects.store(Total, std::memory_order_relaxed);
+
+		SceneDirty = false;
+
+		/* Scripts that rewrite the same values every step shouldn't cost Present a rebuild */
+		if (Scene == Scenes[ScenePublished])
+			return;
+
+		ScenePublished = SceneBack;
+		SceneBack = SceneReady.exchange(SceneBack | SceneFresh, std::memory_order_acq_rel) & ~SceneFresh;
+	}
+
 	void syn::D3D::DrawScene() const
 	{
-		if (!RenderChain.empty())
+		if (SceneReady.load(std::memory_order_relaxed) & SceneFresh)
+			SceneFront = SceneReady.exchange(SceneFront, std::memory_order_acq_rel) & ~SceneFresh;
+
+		DrawScene(Scenes[SceneFront]);
+	}
+
+	void syn::D3D::DrawScene(const D3DScene& Scene) const
+	{
+		const auto DrawList = ImGui::GetCurrentWindow()->DrawList;
+
+		ImageCache.TakeDecoded();
+
+		const auto Instanced = synf::UseInstancedDrawing && Instancer.Ready();
+		if (Instanced)
+			Instancer.Clear();
+
+		/* Layers draw back to front, each one in the fixed type order */
+		for (const auto& Layer : Scene.Layers)
 		{
-			for (auto Rend : RenderChain)
+			if (Instanced)
 			{
-				if (Rend->Header.Visible)
+				/* Same order as below, each layer's batch is one draw call between ImGui's commands */
+				for (auto i = Layer.Begin[D3_LINE]; i < Layer.End[D3_LINE]; i++)
 				{
-					switch (Rend->Header.Type)
-					{
-					case D3_LINE:
-					{
-						const auto Line = (D3DLine*)Rend->Ptr;
-						DrawLine(Line->From, Line->To, Line->Color, Line->Thickness);
-						break;
-					}
-					case D3_SQUARE:
-					{
-						const auto Square = (D3DSquare*)Rend->Ptr;
-						if (Square->Filled)
-							DrawBoxFilled(Square->Pos, Square->Size, Square->Color);
-						else
-							DrawBox(Square->Pos, Square->Size, Square->Color, Square->Thickness);
-						break;
-					}
-					case D3_CIRCLE:
-					{
-						const auto Circle = (D3DCircle*)Rend->Ptr;
-						if (Circle->Filled)
-							DrawCircleFilled(Circle->Pos, Circle->Radius, Circle->Color, Circle->Sides);
-						else
-							DrawCircle(Circle->Pos, Circle->Radius, Circle->Color, Circle->Thickness, Circle->Sides);
-						break;
-					}
-					case D3_TEXT:
-					{
-						const auto Text = (D3DText*)Rend->Ptr;
-						DrawText(GetFont(Text->Font), *Text->Text, Text->Pos, Text->Size, Text->Color,
-							Text->OutlineColor, Text->Center, Text->Outline);
-						break;
-					}
-					}
+					const auto& Line = Scene.Lines[i];
+					Instancer.AddLine(Line.From, Line.To, Line.Color, Line.Thickness);
 				}
+
+				for (auto i = Layer.Begin[D3_SQUARE]; i < Layer.End[D3_SQUARE]; i++)
+				{
+					const auto& Square = Scene.Squares[i];
+					if (!Square.Filled)
+						Instancer.AddRect(Square.Pos, Square.Size, Square.Color, Square.Thickness, false);
+				}
+
+				for (auto i = Layer.Begin[D3_SQUARE]; i < Layer.End[D3_SQUARE]; i++)
+				{
+					const auto& Square = Scene.Squares[i];
+					if (Square.Filled)
+						Instancer.AddRect(Square.Pos, Square.Size, Square.Color, 0, true);
+				}
+
+				for (auto i = Layer.Begin[D3_CIRCLE]; i < Layer.End[D3_CIRCLE]; i++)
+				{
+					const auto& Circle = Scene.Circles[i];
+					Instancer.AddCircle(Circle.Pos, Circle.Radius, Circle.Color, Circle.Thickness, Circle.Filled, Circle.Sides);
+				}
+
+				Instancer.Submit(DrawList);
+			}
+			else
+			{
+				/* One pass per type over contiguous storage, outlines before fills like the instanced path */
+				const SceneChunk Batches[] =
+				{
+					{ SB_LINES, Layer.Begin[D3_LINE], Layer.End[D3_LINE] },
+					{ SB_SQUARES, Layer.Begin[D3_SQUARE], Layer.End[D3_SQUARE] },
+					{ SB_FILLED_SQUARES, Layer.Begin[D3_SQUARE], Layer.End[D3_SQUARE] },
+					{ SB_CIRCLES, Layer.Begin[D3_CIRCLE], Layer.End[D3_CIRCLE] },
+				};
+
+				const auto Objects = (Layer.End[D3_LINE] - Layer.Begin[D3_LINE]) + (Layer.End[D3_SQUARE] - Layer.Begin[D3_SQUARE]) * 2
+					+ (Layer.End[D3_CIRCLE] - Layer.Begin[D3_CIRCLE]);
+				const auto Helpers = (std::min)((size_t) (std::max)(std::thread::hardware_concurrency(), 2u) - 1, Objects / ParallelSceneChunk);
+
+				/* Small layers (and a busy pool) are cheaper to tessellate inline */
+				if (Objects < ParallelSceneThreshold || Helpers == 0 || syn::ThreadPool::GetSingleton()->Pending() != 0)
+				{
+					for (const auto& Batch : Batches)
+						DrawSceneChunk(DrawList, Scene, Batch);
+				}
+				else
+				{
+					DrawSceneParallel(DrawList, Scene, Batches, Helpers);
+				}
+			}
+
+			DrawScenePolys(DrawList, Scene, Layer);
+			DrawSceneImages(DrawList, Scene, Layer);
+
+			for (auto i = Layer.Begin[D3_TEXT]; i < Layer.End[D3_TEXT]; i++)
+			{
+				const auto& Text = Scene.Texts[i];
+				DrawText(GetFont(Text.Font), Text.Text, Text.Pos, Text.Size, Text.Color, Text.OutlineColor, Text.Center, Text.Outline);
 			}
 		}
 	}
@@ -266,70 +705,372 @@ namespace syn
 		std::string Value;
 	};
 
-	std::map<std::string, ImTextureID> ExplorerIcons;
-	std::string DecScript;
+	/* A class's own properties are Properties[Begin, End), its full set continues with its superclass's */
+	struct ExplorerClass
+	{
+		std::uint32_t Begin;
+		std::uint32_t End;
+		int Super;
+	};
 
-	void DrawInstance(const syn::Instance& Inst)
+	/* Property metadata for every class, with inherited properties stored once on the class that declares them */
+	struct ExplorerPropertyIndex
 	{
-		const auto Children = Inst.GetChildren();
+		std::vector<RbxProperty> Properties;
+		std::deque<RbxKey> Keys;		/* Properties[i]'s name as a cached key, the properties panel reads them every refresh */
+		std::vector<ExplorerClass> Classes;
+		std::unordered_map<std::string, int> ClassIds;
+
+		int Find(const std::string& Class) const
+		{
+			const auto Found = ClassIds.find(Class);
+			return Found != ClassIds.end() ? Found->second : -1;
+		}
+
+		/* Own properties first, then each superclass's in order up to the root */
+		template <typename F>
+		void ForEach(int Class, F&& Fn) const
+		{
+			for (; Class >= 0; Class = Classes[Class].Super)
+				for (auto i = Classes[Class].Begin; i < Classes[Class].End; i++)
+					Fn(Properties[i]);
+		}
+	};
+
+	/* Filled once by LoadExplorerProperties */
+	ExplorerPropertyIndex ExplorerProperties;
+	std::atomic<bool> ExplorerInit{ false };
+
+	/* Fetches the API dump and builds ExplorerProperties off the render thread, started at attach */
+	void syn::D3D::LoadExplorerProperties()
+	{
+		std::thread([]
+		{
+			const auto ApiDump = json::parse(cpr::Get(cpr::Url{ OBFUSCATE_STR("https://anaminus.github.io/rbx/json/api/latest.json") }).text);
+
+			std::map<std::string, std::vector<RbxProperty>> OwnProperties;
+			std::map<std::string, std::string> SuperClassTree;
+
+			for (const auto& It : ApiDump.items())
+			{
+				const auto Value = It.value();
+				const auto Type = Value["type"].get<std::string>();
+
+				if (Type == "Class")
+				{
+					const auto Name = Value["Name"].get<std::string>();
+
+					if (!Value["Superclass"].is_null())
+					{
+						//Some classes might have no properties of their own.
+						if (!OwnProperties.count(Name))
+							OwnProperties[Name] = std::vector<RbxProperty>();
+
+						SuperClassTree[Name] = Value["Superclass"].get<std::string>();
+					}
+					else
+					{
+						SuperClassTree[Name] = "<<<ROOT>>>";
+					}
+				}
+				else if (Type == "Property")
+				{
+					const auto Class = Value["Class"].get<std::string>();
+					const auto Name = Value["Name"].get<std::string>();
+					const auto ValueType = Value["ValueType"].get<std::string>();
+
+					if (!OwnProperties.count(Class))
+						OwnProperties[Class] = std::vector<RbxProperty>();
 
-		auto NodeFlags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick;
+					auto Flags = 0;
+					for (const auto& ItTag : Value["tags"].items())
+					{
+						const auto ValueTag = ItTag.value().get<std::string>();
+
+						if (ValueTag == "readonly")
+						{
+							Flags |= READONLY;
+						}
+						else if (ValueTag == "deprecated" || ValueTag == "hidden")
+						{
+							goto BreakLoop;
+						}
+					}
+
+					RbxProperty Prop{};
+					Prop.Property = Name;
+
+					if (ValueType == "int"
+						|| ValueType == "int64"
+						|| ValueType == "double"
+						|| ValueType == "float"
+					)
+					{
+						Prop.Type = NUMBER;
+					}
+					else if (ValueType == "bool")
+					{
+						Prop.Type = BOOL;
+					}
+					else if (ValueType == "string")
+					{
+						Prop.Type = STRING;
+					}
+					else
+					{
+						Prop.Type = CLASS;
+					}
+
+					Prop.Flags = Flags;
+
+					OwnProperties[Class].push_back(Prop);
+				}
+
+				BreakLoop:
+				continue;
+			}
+
+			ExplorerPropertyIndex Index;
+			for (const auto& [Class, Arr] : OwnProperties)
+			{
+				Index.ClassIds.emplace(Class, (int) Index.Classes.size());
+				Index.Classes.push_back({ (std::uint32_t) Index.Properties.size(), (std::uint32_t) (Index.Properties.size() + Arr.size()), -1 });
+				Index.Properties.insert(Index.Properties.end(), Arr.begin(), Arr.end());
+			}
+
+			for (const auto& [Class, Id] : Index.ClassIds)
+			{
+				const auto SuperClass = SuperClassTree.find(Class);
+				if (SuperClass != SuperClassTree.end() && SuperClass->second != "<<<ROOT>>>")
+					Index.Classes[Id].Super = Index.Find(SuperClass->second);
+			}
+
+			ExplorerProperties = std::move(Index);
+
+			/* After the move, short names live inside the strings themselves */
+			for (const auto& Prop : ExplorerProperties.Properties)
+				ExplorerProperties.Keys.emplace_back(Prop.Property.c_str());
+
+			ExplorerInit.store(true, std::memory_order_release);
+		}).detach();
+	}
+
+	/* Where a class's icon sits in ExplorerAtlas */
+	struct ExplorerIcon
+	{
+		ImVec2 UV0;
+		ImVec2 UV1;
+	};
+
+	ImTextureID ExplorerAtlas = NULL;
+	std::map<std::string, ExplorerIcon> ExplorerIcons;
+
+	struct ExplorerRow
+	{
+		DWORD Inst;
+		int Depth;
+		bool HasChildren;
+	};
+
+	/* Expanded part of the explorer tree, flattened so only on-screen rows get drawn */
+	std::vector<ExplorerRow> ExplorerRows;
+
+	/* Search box state, the index is only walked while there's a query */
+	ExplorerSearch ExplorerIndex;
+	char ExplorerQuery[128]{};
+	DWORD ExplorerJump = 0;				/* instance to open the tree down to and scroll to on the next frame */
+	float ExplorerRowHeight = 0;
+	std::vector<DWORD> ExplorerJumpPath;
+
+	/* Class descriptor -> icon, so rows never build the class name string once resolved */
+	std::unordered_map<DWORD, ExplorerIcon> ExplorerIconCache;
+
+	void BuildExplorerRows(const syn::Instance& Parent, const int Depth)
+	{
+		const auto Storage = ImGui::GetStateStorage();
+
+		for (const auto Child : Parent.Children())
+		{
+			const auto HasChildren = !Child.Children().empty();
+			ExplorerRows.push_back({ Child, Depth, HasChildren });
+
+			if (InstanceSelected == Child)
+				IsInstanceSeen = true;
+
+			/* TreeNodeEx keeps its open state under the same id, so collapsed subtrees are never walked */
+			if (HasChildren && Storage->GetInt(ImGui::GetID((void*)(uintptr_t) Child), 0))
+				BuildExplorerRows(Child, Depth + 1);
+		}
+	}
+
+	/* Packs every icon into ExplorerAtlas on the render thread the first time the explorer draws a row */
+	void CreateExplorerAtlas()
+	{
+		/* Every icon goes into one atlas so the whole tree draws with a single texture. Cells are padded
+		   by a transparent texel so filtering never picks up a neighbouring icon, and classes that share
+		   an image share its cell */
+		constexpr int IconSize = 16;
+		constexpr int CellSize = IconSize + 2;
+
+		std::unordered_map<const ImU32*, size_t> IconCells;
+		for (const auto& [ClassName, TexInfo] : ExplorerImagesMap)
+			IconCells.emplace(TexInfo, IconCells.size());
+
+		const auto Columns = (int) std::ceil(std::sqrt((double) IconCells.size()));
+		const auto Rows = ((int) IconCells.size() + Columns - 1) / Columns;
+		const auto AtlasWidth = Columns * CellSize;
+		const auto AtlasHeight = Rows * CellSize;
+
+		std::vector<ImU32> AtlasPixels(AtlasWidth * AtlasHeight, 0);
+		for (const auto& [TexInfo, Cell] : IconCells)
+		{
+			const auto X = (int) (Cell % Columns) * CellSize + 1;
+			const auto Y = (int) (Cell / Columns) * CellSize + 1;
+
+			for (auto Row = 0; Row < IconSize; Row++)
+				memcpy(&AtlasPixels[(Y + Row) * AtlasWidth + X], TexInfo + Row * IconSize, IconSize * sizeof(ImU32));
+		}
+
+		D3D11_TEXTURE2D_DESC desc;
+		ZeroMemory(&desc, sizeof(desc));
+		desc.Width = AtlasWidth;
+		desc.Height = AtlasHeight;
+		desc.MipLevels = 1;
+		desc.ArraySize = 1;
+		desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		desc.SampleDesc.Count = 1;
+		desc.Usage = D3D11_USAGE_IMMUTABLE;
+		desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+		desc.CPUAccessFlags = 0;
+
+		ID3D11Texture2D* pTexture = NULL;
+		D3D11_SUBRESOURCE_DATA subResource;
+		subResource.pSysMem = AtlasPixels.data();
+		subResource.SysMemPitch = desc.Width * 4;
+		subResource.SysMemSlicePitch = 0;
+		g_pd3dDevice->CreateTexture2D(&desc, &subResource, &pTexture);
+
+		D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+		ZeroMemory(&srvDesc, sizeof srvDesc);
+		srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+		srvDesc.Texture2D.MipLevels = desc.MipLevels;
+		srvDesc.Texture2D.MostDetailedMip = 0;
+
+		ID3D11ShaderResourceView* Texture = NULL;
+		if (pTexture)
+		{
+			g_pd3dDevice->CreateShaderResourceView(pTexture, &srvDesc, &Texture);
+			pTexture->Release();
+		}
+
+		ExplorerAtlas = (ImTextureID) Texture;
+
+		for (const auto& [ClassName, TexInfo] : ExplorerImagesMap)
+		{
+			const auto Cell = IconCells[TexInfo];
+			const auto X = (float) ((Cell % Columns) * CellSize + 1);
+			const auto Y = (float) ((Cell / Columns) * CellSize + 1);
+
+			ExplorerIcons[ClassName] = {
+				ImVec2(X / AtlasWidth, Y / AtlasHeight),
+				ImVec2((X + IconSize) / AtlasWidth, (Y + IconSize) / AtlasHeight)
+			};
+		}
+	}
+
+	ExplorerIcon GetExplorerIcon(const syn::Instance& Inst)
+	{
+		const auto Descriptor = Inst.GetClassDescriptor();
+
+		const auto Cached = ExplorerIconCache.find(Descriptor);
+		if (Cached != ExplorerIconCache.end())
+			return Cached->second;
+
+		const auto Found = ExplorerIcons.find(Inst.GetInstanceClassName());
+		const auto Icon = Found != ExplorerIcons.end() ? Found->second : ExplorerIcons["Default"];
+
+		ExplorerIconCache.emplace(Descriptor, Icon);
+
+		return Icon;
+	}
+
+	void DrawInstanceRow(const ExplorerRow& Row)
+	{
+		const syn::Instance Inst(Row.Inst);
+
+		auto NodeFlags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick | ImGuiTreeNodeFlags_NoTreePushOnOpen;
 		if (InstanceSelected == Inst)
 			NodeFlags |= ImGuiTreeNodeFlags_Selected;
-		if (Children.empty())
+		if (!Row.HasChildren)
 			NodeFlags |= ImGuiTreeNodeFlags_Leaf;
 
-		const auto ClassName = Inst.GetInstanceClassName();
-
-		if (ExplorerIcons.count(ClassName))
-			ImGui::Image(ExplorerIcons[ClassName], ImVec2(16, 16));
-		else
-			ImGui::Image(ExplorerIcons["Default"], ImVec2(16, 16));
+		const auto Indent = Row.Depth * ImGui::GetTreeNodeToLabelSpacing();
+		if (Indent > 0)
+			ImGui::Indent(Indent);
 
+		const auto Icon = GetExplorerIcon(Inst);
+		ImGui::Image(ExplorerAtlas, ImVec2(16, 16), Icon.UV0, Icon.UV1);
 		ImGui::SameLine();
 
-		const auto Res = ImGui::TreeNodeEx((void*)(uintptr_t) Inst, NodeFlags, "%s", Inst.GetInstanceName().c_str());
+		ImGui::TreeNodeEx((void*)(uintptr_t) Inst, NodeFlags, "%s", Inst.GetInstanceName().c_str());
 		if (ImGui::IsItemClicked())
 			InstanceSelected = Inst;
 
-		if (InstanceSelected == Inst)
-			IsInstanceSeen = true;
+		if (Indent > 0)
+			ImGui::Unindent(Indent);
+	}
 
-		if (Res)
-		{
-			for (auto& CInst : Children)
-			{
-				DrawInstance(CInst);
-			}
+	/* tostring, instance, name -> tostring(instance[name]), run under its own PCall so an unreadable property only fails itself */
+	int ReadPropertyString(DWORD rL)
+	{
+		const syn::RbxLua RL(rL);
 
-			ImGui::TreePop();
-		}
+		RL.PushValue(1);
+		RL.PushValue(3);
+		RL.GetTable(2);
+		RL.PCall(1, 1, 0);
+
+		return 1;
 	}
 
-	std::string GetInstanceValue(const RbxLua RL, const syn::Instance& Inst, const std::string& Property)
+	/* Every property of Inst in one pass, tostring and the instance are pushed once instead of per property */
+	void GetInstanceValues(RbxLua RL, const syn::Instance& Inst, const int Class, std::map<std::string, RbxPropertyValue>& Out)
 	{
 		static DWORD PushF = NULL;
 		if (!PushF) PushF = RbxLua::GetBinValue(FNVA1_CONSTEXPR("pushinstance"));
 
 		const auto RealInst = (DWORD) Inst;
+		const auto Top = RL.GetTop();
 
-		RL.GetGlobal("getpropvalue");
+		static const RbxKey KeyToString("tostring");
+
+		RL.PushCFunction(ReadPropertyString);
+		RL.GetGlobalK(KeyToString);
 		((int(__cdecl*)(DWORD, DWORD))PushF)(RL, (DWORD) &RealInst);
-		RL.PushString(Property.c_str());
 
-		if (RL.PCall(2, 1, 0))
+		ExplorerProperties.ForEach(Class, [&](const RbxProperty& Prop)
 		{
-			RL.Pop(RL.GetTop());
+			RbxPropertyValue Value{ Prop.Type, Prop.Flags, "N/A" };
 
-			return "N/A";
-		}
+			RL.PushValue(Top + 1);
+			RL.PushValue(Top + 2);
+			RL.PushValue(Top + 3);
+			RL.PushK(ExplorerProperties.Keys[&Prop - ExplorerProperties.Properties.data()]);
 
-		size_t CSize;
-		const auto CStr = RL.ToLString(-1, &CSize);
+			if (!RL.PCall(3, 1, 0))
+			{
+				size_t CSize;
+				const auto CStr = RL.ToLString(-1, &CSize);
+				if (CStr)
+					Value.Value.assign(CStr, CSize);
+			}
 
-		RL.Pop(RL.GetTop());
+			RL.SetTop(Top + 3);
+			Out[Prop.Property] = std::move(Value);
+		});
 
-		return std::string(CStr, CSize);
+		RL.SetTop(Top);
 	}
 
 	bool SetInstanceValue(const RbxLua RL, const syn::Instance& Inst, const std::string& Property, const RbxPropertyType Type, const std::string& Value)
@@ -417,11 +1158,18 @@ namespace syn
 	int SetDecScript(DWORD RL)
 	{
 		const syn::RbxLua NRL(RL);
+		const auto Renderer = syn::D3D::GetSingleton();
+
+		if (Renderer->DecompilerThread != RL)
+			return 0;
+
+		Renderer->DecompilerThread = 0;
 
 		size_t DScriptSize;
 		const auto DScriptCStr = NRL.ToLString(1, &DScriptSize);
 
-		DecScript = std::string(DScriptCStr, DScriptSize);
+		if (DScriptCStr)
+			Renderer->AppendDecompilerText(Renderer->DecompilerGeneration.load(), DScriptCStr, DScriptSize, true);
 
 		return 0;
 	}
@@ -443,13 +1191,10 @@ namespace syn
 		static TextEditor DecompilerEditor;
 		static auto EditorInit = FALSE;
 		static auto ScriptHubInit = FALSE;
-		static auto ExplorerInit = FALSE;
 		static CRITICAL_SECTION ScriptHubSection;
-		static CRITICAL_SECTION ExplorerSection;
 		static std::vector<std::wstring> ListBoxContents;
 		static std::vector<std::string> ListBoxAnsiContents;
 		static std::vector<std::string> ScriptHubContents;
-		static std::map<std::string, std::vector<RbxProperty>> ExplorerProperties;
 		if (!EditorInit)
 		{
 			const auto Lang = TextEditor::LanguageDefinition::Lua();
@@ -524,148 +1269,17 @@ namespace syn
 			}
 
 			UNUSED(InitializeCriticalSectionAndSpinCount(&ScriptHubSection, 0x00000400UL));
-			UNUSED(InitializeCriticalSectionAndSpinCount(&ExplorerSection, 0x00000400UL));
-
-			std::thread([]
-			{
-				const auto ApiDump = json::parse(cpr::Get(cpr::Url{ OBFUSCATE_STR("https://anaminus.github.io/rbx/json/api/latest.json") }).text);
-
-				EnterCriticalSection(&ExplorerSection);
-
-				std::map<std::string, std::string> SuperClassTree;
-
-				for (const auto& It : ApiDump.items())
-				{
-					const auto Value = It.value();
-					const auto Type = Value["type"].get<std::string>();
-
-					if (Type == "Class")
-					{
-						const auto Name = Value["Name"].get<std::string>();
-
-						if (!Value["Superclass"].is_null())
-						{
-							//Some classes might have no properties of their own.
-							if (!ExplorerProperties.count(Name))
-								ExplorerProperties[Name] = std::vector<RbxProperty>();
-
-							SuperClassTree[Name] = Value["Superclass"].get<std::string>();
-						}
-						else
-						{
-							SuperClassTree[Name] = "<<<ROOT>>>";
-						}
-					}
-					else if (Type == "Property")
-					{
-						const auto Class = Value["Class"].get<std::string>();
-						const auto Name = Value["Name"].get<std::string>();
-						const auto ValueType = Value["ValueType"].get<std::string>();
-
-						if (!ExplorerProperties.count(Class))
-							ExplorerProperties[Class] = std::vector<RbxProperty>();
-
-						auto Flags = 0;
-						for (const auto& ItTag : Value["tags"].items())
-						{
-							const auto ValueTag = ItTag.value().get<std::string>();
-
-							if (ValueTag == "readonly")
-							{
-								Flags |= READONLY;
-							}
-							else if (ValueTag == "deprecated" || ValueTag == "hidden")
-							{
-								goto BreakLoop;
-							}
-						}
 
-						RbxProperty Prop{};
-						Prop.Property = Name;
-
-						if (ValueType == "int"
-							|| ValueType == "int64"
-							|| ValueType == "double"
-							|| ValueType == "float"
-						)
-						{
-							Prop.Type = NUMBER;
-						}
-						else if (ValueType == "bool")
-						{
-							Prop.Type = BOOL;
-						}
-						else if (ValueType == "string")
-						{
-							Prop.Type = STRING;
-						}
-						else
-						{
-							Prop.Type = CLASS;
-						}
-
-						Prop.Flags = Flags;
-
-						ExplorerProperties[Class].push_back(Prop);
-					}
-
-					BreakLoop:
-					continue;
-				}
-
-				for (auto& [Key, Arr] : ExplorerProperties)
-				{
-					auto SuperClass = SuperClassTree[Key];
-
-					while (SuperClass != "<<<ROOT>>>")
-					{
-						Arr.insert(std::end(Arr), std::begin(ExplorerProperties[SuperClass]), std::end(ExplorerProperties[SuperClass]));
-
-						SuperClass = SuperClassTree[SuperClass];
-					}
-				}
-
-				for (auto& [ClassName, TexInfo] : ExplorerImagesMap)
-				{
-					ID3D11ShaderResourceView* Texture;
-
-					//todo: disgusting
-					D3D11_TEXTURE2D_DESC desc;
-					ZeroMemory(&desc, sizeof(desc));
-					desc.Width = 16;
-					desc.Height = 16;
-					desc.MipLevels = 1;
-					desc.ArraySize = 1;
-					desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-					desc.SampleDesc.Count = 1;
-					desc.Usage = D3D11_USAGE_DEFAULT;
-					desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-					desc.CPUAccessFlags = 0;
-
-					ID3D11Texture2D* pTexture = NULL;
-					D3D11_SUBRESOURCE_DATA subResource;
-					subResource.pSysMem = TexInfo;
-					subResource.SysMemPitch = desc.Width * 4;
-					subResource.SysMemSlicePitch = 0;
-					g_pd3dDevice->CreateTexture2D(&desc, &subResource, &pTexture);
-
-					D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
-					ZeroMemory(&srvDesc, sizeof srvDesc);
-					srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-					srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-					srvDesc.Texture2D.MipLevels = desc.MipLevels;
-					srvDesc.Texture2D.MostDetailedMip = 0;
-					g_pd3dDevice->CreateShaderResourceView(pTexture, &srvDesc, &Texture);
-
-					pTexture->Release();
-
-					ExplorerIcons[ClassName] = (ImTextureID) Texture;
-				}
-
-				ExplorerInit = TRUE;
+		}
 
-				LeaveCriticalSection(&ExplorerSection);
-			}).detach();
+		{
+			std::lock_guard<std::mutex> Guard(EditorMutex);
+			if (EditorTextPending)
+			{
+				Editor.SetText(PendingEditorText);
+				PendingEditorText.clear();
+				EditorTextPending = false;
+			}
 		}
 
 		ImGui::SetNextWindowSizeConstraints(ImVec2(210, 110), ImVec2(FLT_MAX, FLT_MAX));
@@ -856,11 +1470,21 @@ namespace syn
 			const auto HeightToReserve = ImGui::GetStyle().ItemSpacing.y + ImGui::GetFrameHeightWithSpacing();
 			ImGui::BeginChild("ScrollingRegion", ImVec2(0, -HeightToReserve), false, ImGuiWindowFlags_HorizontalScrollbar);
 			ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(4, 1));
-			for (const auto& Item : ConsoleOutput)
 			{
-				ImGui::PushStyleColor(ImGuiCol_Text, Item.second);
-				ImGui::TextUnformatted(Item.first.c_str());
-				ImGui::PopStyleColor();
+				/* Only the visible lines are submitted */
+				std::lock_guard<std::mutex> Guard(ConsoleOutput.Mutex);
+
+				ImGuiListClipper Clipper((int) ConsoleOutput.Size());
+				while (Clipper.Step())
+				{
+					for (auto i = Clipper.DisplayStart; i < Clipper.DisplayEnd; i++)
+					{
+						const auto& Item = ConsoleOutput.At(i);
+						ImGui::PushStyleColor(ImGuiCol_Text, Item.Color);
+						ImGui::TextUnformatted(Item.Text.data(), Item.Text.data() + Item.Text.size());
+						ImGui::PopStyleColor();
+					}
+				}
 			}
 
 			if (AutoScroll)
@@ -879,7 +1503,7 @@ namespace syn
 				if (InputBuf[0])
 				{
 					syn::Scheduler::GetSingleton()->Push(InputBuf);
-					ConsoleOutput.emplace_back("> " + std::string(InputBuf), 0xFFA0A0A0);
+					ConsoleOutput.Push("> " + std::string(InputBuf), 0xFFA0A0A0);
 				}
 
 				SecureZeroMemory(InputBuf, 256);
@@ -898,7 +1522,7 @@ namespace syn
 
 			if (ImGui::SmallButton("Clear"))
 			{
-				ConsoleOutput.clear();
+				ConsoleOutput.Clear();
 			}
 		}
 
@@ -926,40 +1550,172 @@ namespace syn
 			ImGui::BeginChild("ScrollingRegion", ImVec2(0, -HeightToReserve), false, ImGuiWindowFlags_HorizontalScrollbar);
 			ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(4, 1));
 
-			if (CurrentItem != -1)
-			{
-				ImGui::PushStyleColor(ImGuiCol_Text, ImVec4{ 255, 255, 255, 255 });
-				ImGui::TextUnformatted(ScriptHubData[ScriptHubContents.at(CurrentItem)].Description.c_str());
-				ImGui::PopStyleColor();
+			if (CurrentItem != -1)
+			{
+				ImGui::PushStyleColor(ImGuiCol_Text, ImVec4{ 255, 255, 255, 255 });
+				ImGui::TextUnformatted(ScriptHubData[ScriptHubContents.at(CurrentItem)].Description.c_str());
+				ImGui::PopStyleColor();
+			}
+
+			ImGui::PopStyleVar();
+			ImGui::EndChild();
+
+			ImGui::Separator();
+
+			if (ImGui::Button("Run", ImVec2(ImGui::GetWindowWidth(), 20)) && CurrentItem != -1)
+			{
+				auto Url = ScriptHubData[ScriptHubContents.at(CurrentItem)].Url;
+
+				VM_TIGER_WHITE_START;
+
+				if (!SecureLuaFlag)
+				{
+					ScriptRunCounter++;
+
+					std::thread([Url]
+					{
+						syn::Scheduler::GetSingleton()->Push(cpr::Get(cpr::Url{ Url }).text);
+					}).detach();
+				}
+
+				VM_TIGER_WHITE_END;
+			}*/
+		}
+
+		LeaveCriticalSection(&ScriptHubSection);
+
+		ImGui::End();
+		ImGui::PopFont();
+
+		ImGui::PushFont(GetFont(1));
+
+		if (ImGui::Begin("Stats", NULL, NULL))
+		{
+			const auto Stats = FrameStats::GetSingleton();
+
+			ImGui::Checkbox("Collect", &Stats->Enabled);
+
+			if (Stats->Enabled)
+			{
+				static const char* MetricNames[FS_COUNT] = { "Present hook", "ImGui build", "StepSchedule" };
+
+				ImGui::Columns(3, "StatsColumns");
+				ImGui::Text("Timer (us)"); ImGui::NextColumn();
+				ImGui::Text("p50"); ImGui::NextColumn();
+				ImGui::Text("p99"); ImGui::NextColumn();
+				ImGui::Separator();
+
+				for (auto i = 0; i < FS_COUNT; i++)
+				{
+					ImGui::Text("%s", MetricNames[i]); ImGui::NextColumn();
+					ImGui::Text("%.1f", Stats->Percentile((FrameMetric) i, 50)); ImGui::NextColumn();
+					ImGui::Text("%.1f", Stats->Percentile((FrameMetric) i, 99)); ImGui::NextColumn();
+				}
+
+				ImGui::Columns(1);
+				ImGui::Separator();
+
+				const auto Last = Stats->Last();
+				ImGui::Text("Vertices: %u  Indices: %u  Draw calls: %u", Last.Vertices, Last.Indices, Last.DrawCalls);
+				const auto& Counts = Scenes[SceneFront].Counts;
+				ImGui::Text("Lines: %u  Texts: %u  Squares: %u  Circles: %u  Images: %u  Polylines: %u  Polygons: %u", Counts[D3_LINE], Counts[D3_TEXT], Counts[D3_SQUARE],
+					Counts[D3_CIRCLE], Counts[D3_IMAGE], Counts[D3_POLYLINE], Counts[D3_POLYGON]);
+				ImGui::Text("Live objects: %u  Collected: %u", Metrics::GetSingleton()->RenderObjects.load(std::memory_order_relaxed),
+					SweptObjects.load(std::memory_order_relaxed));
+
+				if (ImGui::Button("Export CSV"))
+					Stats->ExportCsv(GetWorkingPath() + L"\\bin\\FrameStats.csv");
+			}
+
+			ImGui::Separator();
+
+			const auto Prof = Profiler::GetSingleton();
+
+			auto Tracing = Prof->Tracing.load();
+			if (ImGui::Checkbox("Trace zones", &Tracing))
+				Prof->Tracing.store(Tracing);
+
+			ImGui::SameLine();
+
+			if (ImGui::Button("Dump trace"))
+				Prof->DumpTrace(GetWorkingPath() + L"\\bin\\Trace.json");
+
+			const auto Instr = HSVM::Instrumentation::GetSingleton();
+
+			auto Instrumenting = Instr->Enabled.load();
+			if (ImGui::Checkbox("HSVM profile", &Instrumenting))
+			{
+				if (Instrumenting)
+					Instr->Start();
+				else
+					Instr->Stop();
+			}
+
+			ImGui::SameLine();
+
+			if (ImGui::Button("Dump HSVM profile"))
+			{
+				Instr->DumpFolded(GetWorkingPath() + L"\\bin\\HSVM.folded");
+				std::ofstream(GetWorkingPath() + L"\\bin\\HSVMCounts.txt", std::ios::binary) << Instr->DumpCounts();
+			}
+
+			ImGui::Separator();
+
+			const auto Scripts = ScriptStats::GetSingleton();
+
+			ImGui::Checkbox("Script accounting", &Scripts->Enabled);
+
+			if (Scripts->Enabled)
+			{
+				ImGui::SameLine();
+
+				if (ImGui::Button("Reset"))
+					Scripts->Reset();
+
+				ImGui::Columns(5, "ScriptColumns");
+				ImGui::Text("Script"); ImGui::NextColumn();
+				ImGui::Text("Resumes"); ImGui::NextColumn();
+				ImGui::Text("Time (ms)"); ImGui::NextColumn();
+				ImGui::Text("Peak (ms)"); ImGui::NextColumn();
+				ImGui::Text("Heap (KB)"); ImGui::NextColumn();
+				ImGui::Separator();
+
+				for (const auto& Script : Scripts->Snapshot())
+				{
+					ImGui::TextUnformatted(Script.Label.c_str()); ImGui::NextColumn();
+					ImGui::Text("%llu", Script.Resumes); ImGui::NextColumn();
+					ImGui::Text("%.2f", Script.Micros / 1000.0); ImGui::NextColumn();
+					ImGui::Text("%.2f", Script.PeakMicros / 1000.0); ImGui::NextColumn();
+					ImGui::Text("%.1f", Script.NetBytes / 1024.0); ImGui::NextColumn();
+				}
+
+				ImGui::Columns(1);
 			}
 
-			ImGui::PopStyleVar();
-			ImGui::EndChild();
-
+#ifdef EnableBenchmarks
 			ImGui::Separator();
 
-			if (ImGui::Button("Run", ImVec2(ImGui::GetWindowWidth(), 20)) && CurrentItem != -1)
+			const auto Bench = Benchmark::GetSingleton();
+			if (Bench->Running.load())
+				ImGui::Text("Benchmarking...");
+			else
 			{
-				auto Url = ScriptHubData[ScriptHubContents.at(CurrentItem)].Url;
+				if (ImGui::Button("Benchmark compile pipeline"))
+					Bench->Start(GetWorkingPath() + L"\\scripts", GetWorkingPath() + L"\\bin\\Benchmark.txt");
 
-				VM_TIGER_WHITE_START;
+				ImGui::SameLine();
 
-				if (!SecureLuaFlag)
-				{
-					ScriptRunCounter++;
+				if (ImGui::Button("Benchmark VM"))
+					Bench->StartMicro(GetWorkingPath() + L"\\bin\\MicroBenchmark.txt");
 
-					std::thread([Url]
-					{
-						syn::Scheduler::GetSingleton()->Push(cpr::Get(cpr::Url{ Url }).text);
-					}).detach();
-				}
+				ImGui::SameLine();
 
-				VM_TIGER_WHITE_END;
-			}*/
+				if (ImGui::Button("Benchmark overlay"))
+					Bench->StartOverlay(GetWorkingPath() + L"\\bin\\OverlayBenchmark.txt");
+			}
+#endif
 		}
 
-		LeaveCriticalSection(&ScriptHubSection);
-
 		ImGui::End();
 		ImGui::PopFont();
 
@@ -969,9 +1725,84 @@ namespace syn
 		{
 			IsInstanceSeen = false;
 
-			for (auto& CInst : syn::Instance(DataModel).GetChildren())
+			ImGui::PushItemWidth(-1);
+			ImGui::InputText("##ExplorerSearch", ExplorerQuery, sizeof ExplorerQuery);
+			ImGui::PopItemWidth();
+
+			if (ExplorerQuery[0])
+			{
+				ExplorerIndex.Step(DataModel, 8192);
+				ExplorerIndex.Query(ExplorerQuery);
+
+				const auto& Matches = ExplorerIndex.Matches();
+				if (!ExplorerIndex.Ready())
+					ImGui::Text("Indexing... %u instances", (DWORD) ExplorerIndex.Pending());
+				else
+					ImGui::Text("%u of %u instances", (DWORD) Matches.size(), (DWORD) ExplorerIndex.Size());
+
+				/* Rows come from the index alone, nothing off screen is read */
+				ImGui::BeginChild("##ExplorerResults", ImVec2(0, ImGui::GetTextLineHeightWithSpacing() * 10), true);
+				ImGuiListClipper Results((int) Matches.size());
+				while (Results.Step())
+				{
+					for (auto i = Results.DisplayStart; i < Results.DisplayEnd; i++)
+					{
+						const auto& Entry = ExplorerIndex.At(Matches[i]);
+						const auto Name = ExplorerIndex.Name(Entry);
+
+						ImGui::PushID(i);
+						if (ImGui::Selectable("##Result", InstanceSelected == Entry.Inst))
+							ExplorerJump = Entry.Inst;
+						ImGui::SameLine();
+						ImGui::Text("%.*s", (int) Name.size(), Name.data());
+						ImGui::SameLine();
+						ImGui::TextDisabled("%s", ExplorerIndex.ClassName(Entry).c_str());
+						ImGui::PopID();
+					}
+				}
+				ImGui::EndChild();
+			}
+
+			/* Open every ancestor the index knows of, under the ids the tree nodes use */
+			const auto Jump = ExplorerJump;
+			if (Jump)
+			{
+				InstanceSelected = Jump;
+				ExplorerIndex.Ancestors(Jump, ExplorerJumpPath);
+
+				const auto Storage = ImGui::GetStateStorage();
+				for (const auto Ancestor : ExplorerJumpPath)
+					Storage->SetInt(ImGui::GetID((void*)(uintptr_t) Ancestor), 1);
+
+				ExplorerJump = 0;
+			}
+
+			ExplorerRows.clear();
+			if (DataModel)
+				BuildExplorerRows(syn::Instance(DataModel), 0);
+
+			if (!ExplorerAtlas)
+				CreateExplorerAtlas();
+
+			const auto TreeTop = ImGui::GetCursorPosY();
+			if (Jump && ExplorerRowHeight > 0)
+			{
+				for (size_t i = 0; i < ExplorerRows.size(); i++)
+				{
+					if (ExplorerRows[i].Inst == Jump)
+					{
+						ImGui::SetScrollY(TreeTop + i * ExplorerRowHeight - ImGui::GetWindowHeight() * 0.5f);
+						break;
+					}
+				}
+			}
+
+			ImGuiListClipper Clipper((int) ExplorerRows.size());
+			while (Clipper.Step())
 			{
-				DrawInstance(CInst);
+				ExplorerRowHeight = Clipper.ItemsHeight;
+				for (auto i = Clipper.DisplayStart; i < Clipper.DisplayEnd; i++)
+					DrawInstanceRow(ExplorerRows[i]);
 			}
 		}
 
@@ -980,46 +1811,54 @@ namespace syn
 
 		ImGui::PushFont(GetFont(1));
 
-		if (ImGui::Begin("Explorer Properties", NULL, NULL) && IsInstanceSeen && ExplorerInit)
+		if (ImGui::Begin("Explorer Properties", NULL, NULL) && IsInstanceSeen && ExplorerInit.load(std::memory_order_acquire))
 		{
-			EnterCriticalSection(&ExplorerSection);
-
 			const auto Inst = syn::Instance(InstanceSelected);
 			const auto ClassName = Inst.GetInstanceClassName();
 
-			if (!ExplorerProperties.count(ClassName))
-			{
-				LeaveCriticalSection(&ExplorerSection);
+			const auto ClassId = ExplorerProperties.Find(ClassName);
+			if (ClassId < 0)
 				goto ExplorerExit; //It's better then a nested if statement.
-			}
-
-			LeaveCriticalSection(&ExplorerSection);
 
+			/* Both maps are shared with the game thread's refresh job */
+			static std::mutex PropertiesMutex;
 			static std::map<std::string, RbxPropertyValue> PropertiesMap;
 			static std::map<std::string, std::string> NewPropertiesMap;
 			static std::string LastClassName;
-			static uint32_t Step = 0;
+			static ULONGLONG LastRefresh = 0;
+			static std::atomic<bool> RefreshPending{ false };
 			static uintptr_t ScriptImpPtr = 0;
 			if (!ScriptImpPtr)
 				ScriptImpPtr = syn::RobloxBase(syn::Lua::RbxImpersonatorConstruct);
 
 			if (LastClassName != ClassName)
 			{
-				Step = 31;
+				LastRefresh = 0;
+
+				std::lock_guard<std::mutex> Guard(PropertiesMutex);
 				PropertiesMap.clear();
 
 				LastClassName = ClassName;
 			}
 
-			if (Step >= 30)
+			/* Values are read at PropertyRefreshRate, and never with a previous refresh still queued */
+			const auto Now = GetTickCount64();
+			if (!RefreshPending && Now - LastRefresh >= 1000 / (std::max)(PropertyRefreshRate, 1u))
 			{
-				Step = 0;
+				LastRefresh = Now;
+				RefreshPending = true;
 
-				syn::Scheduler::GetSingleton()->Push([Inst, ClassName](const DWORD RL)
+				syn::Scheduler::GetSingleton()->Push([Inst, ClassId](const DWORD RL)
 				{
+					std::map<std::string, std::string> Changes;
+					{
+						std::lock_guard<std::mutex> Guard(PropertiesMutex);
+						Changes.swap(NewPropertiesMap);
+					}
+
 					if (InstanceSelected != Inst || !IsInstanceSeen)
 					{
-						NewPropertiesMap.clear();
+						RefreshPending = false;
 						return;
 					}
 
@@ -1028,31 +1867,27 @@ namespace syn
 					DWORD _this{};
 					((void(__thiscall*)(DWORD*, DWORD))ScriptImpPtr)(&_this, 6);
 
-					for (auto& Prop : ExplorerProperties[ClassName])
+					ExplorerProperties.ForEach(ClassId, [&](const RbxProperty& Prop)
 					{
-						RbxPropertyValue Value{};
-						Value.Type = Prop.Type;
-						Value.Flags = Prop.Flags;
-						Value.Value = GetInstanceValue(RL, Inst, Prop.Property);
-
-						PropertiesMap[Prop.Property] = Value;
+						const auto Changed = Changes.find(Prop.Property);
+						if (Changed != Changes.end())
+							SetInstanceValue(RL, Inst, Prop.Property, Prop.Type, Changed->second);
+					});
 
-						if (NewPropertiesMap.count(Prop.Property))
-						{
-							SetInstanceValue(RL, Inst, Prop.Property, Prop.Type, NewPropertiesMap[Prop.Property]);
-						}
-					}
+					std::map<std::string, RbxPropertyValue> Values;
+					GetInstanceValues(RL, Inst, ClassId, Values);
 
 					((void(__thiscall*)(DWORD*, DWORD))ScriptImpPtr)(&_this, OldIdentity);
 
-					NewPropertiesMap.clear();
+					{
+						std::lock_guard<std::mutex> Guard(PropertiesMutex);
+						PropertiesMap.swap(Values);
+					}
+
+					RefreshPending = false;
 				});
 			}
 
-			Step++;
-
-			static std::string DecScriptBackup;
-
 			if (ImGui::SmallButton("Destroy"))
 			{
 				auto Scheduler = syn::Scheduler::GetSingleton();
@@ -1076,18 +1911,26 @@ namespace syn
 			if (ClassName == "LocalScript" || ClassName == "ModuleScript")
 			{
 				static uintptr_t LastScript = 0;
+				static auto DecompilerOpen = false;
 
-				if (DecScript.empty())
+				if (!DecompilerOpen)
 				{
 					ImGui::SameLine();
 
 					if (ImGui::SmallButton("Decompile"))
 					{
 						LastScript = InstanceSelected;
+						DecompilerOpen = true;
 
-						syn::Scheduler::GetSingleton()->Push([](DWORD RL)
+						DecompilerEditor.SetText("");
+						DecompilerEditor.SetReadOnly(true);
+
+						const auto Generation = BeginDecompilerText();
+
+						syn::Scheduler::GetSingleton()->Push([Generation](DWORD RL)
 						{
-							if (!IsInstanceSeen)
+							const auto Renderer = syn::D3D::GetSingleton();
+							if (!IsInstanceSeen || Renderer->DecompilerGeneration.load() != Generation)
 								return;
 
 							const auto SelectedInst = syn::Instance(InstanceSelected);
@@ -1110,6 +1953,7 @@ namespace syn
 							Sthread.SetGlobal(OBFUSCATE_STR("setdecscript"));
 
 							Sthread.PCall(0, 1, 0);
+							Renderer->DecompilerThread = Sthread;
 
 							struct RbxThreadRef
 							{
@@ -1120,7 +1964,7 @@ namespace syn
 							RbxThreadRef Ref{};
 							Ref.L = Sthread;
 
-							const auto ScriptContext = syn::Instance(DataModel).GetChildFromClassName(OBFUSCATE_STR("ScriptContext"));
+							const auto ScriptContext = syn::Instance::GetScriptContext(DataModel);
 							static DWORD RResume = 0;
 							static DWORD PushF = 0;
 
@@ -1138,11 +1982,11 @@ namespace syn
 					}
 				}
 
-				if (!DecScript.empty())
+				if (DecompilerOpen)
 				{
 					if (LastScript != InstanceSelected)
 					{
-						DecScript = "";
+						DecompilerOpen = false;
 					}
 					else
 					{
@@ -1150,21 +1994,26 @@ namespace syn
 
 						if (ImGui::SmallButton("Properties"))
 						{
-							DecScript = "";
+							DecompilerOpen = false;
 						}
 					}
+
+					if (!DecompilerOpen)
+						++DecompilerGeneration;
 				}
 
-				if (!DecScript.empty())
+				if (DecompilerOpen)
 				{
 					ImGui::Separator();
 
-					if (DecScript != DecScriptBackup)
+					/* Only what arrived since the last frame is appended, the editor draws and colorizes just the visible lines */
 					{
-						DecompilerEditor.SetText(DecScript);
-						DecompilerEditor.SetReadOnly(true);
-
-						DecScriptBackup = DecScript;
+						std::lock_guard<std::mutex> Guard(DecompilerMutex);
+						if (!PendingDecompilerText.empty())
+						{
+							DecompilerEditor.AppendText(PendingDecompilerText);
+							PendingDecompilerText.clear();
+						}
 					}
 
 					DecompilerEditor.Render("TextEditorDecompiler");
@@ -1179,6 +2028,7 @@ namespace syn
 			char Buf[256];
 			SecureZeroMemory(Buf, 256);
 
+			std::lock_guard<std::mutex> Guard(PropertiesMutex);
 			for (auto& [Prop, Value] : PropertiesMap)
 			{
 				ImGui::Text("%s", Prop.c_str());
@@ -1206,71 +2056,487 @@ namespace syn
 		ImGui::PopFont();
 	}
 
-	void syn::D3D::AddToRenderList(D3DObject* Object)
+	syn::D3DHandle syn::D3D::CreateRenderObject(const D3DTypes Type, const int Sides)
+	{
+		SceneDirty = true;
+
+		const auto Black = ImGui::GetColorU32(ImVec4(0, 0, 0, 255));
+
+		switch (Type)
+		{
+			case D3_LINE:
+			{
+				D3DLine Line;
+				Line.Color = Black;
+				Line.From = ImVec2(0, 0);
+				Line.To = ImVec2(0, 0);
+				Line.Thickness = 0;
+				return Lines.Allocate(std::move(Line));
+			}
+			case D3_TEXT:
+			{
+				D3DText Text;
+				Text.Color = Black;
+				Text.OutlineColor = Black;
+				Text.Center = FALSE;
+				Text.Outline = FALSE;
+				Text.Pos = ImVec2(0, 0);
+				Text.Size = 16;
+				Text.Font = 0;
+				return Texts.Allocate(std::move(Text));
+			}
+			case D3_SQUARE:
+			{
+				D3DSquare Square;
+				Square.Color = Black;
+				Square.Filled = FALSE;
+				Square.Thickness = 16;
+				Square.Pos = ImVec2(0, 0);
+				Square.Size = ImVec2(16, 16);
+				return Squares.Allocate(std::move(Square));
+			}
+			case D3_CIRCLE:
+			{
+				D3DCircle Circle;
+				Circle.Color = Black;
+				Circle.Filled = FALSE;
+				Circle.Thickness = 16;
+				Circle.Pos = ImVec2(0, 0);
+				Circle.Radius = 1;
+				Circle.Sides = 100;
+				return Circles.Allocate(std::move(Circle));
+			}
+			case D3_IMAGE:
+			{
+				D3DImage Image;
+				Image.Color = IM_COL32_WHITE;
+				Image.Pos = ImVec2(0, 0);
+				Image.Size = ImVec2(0, 0);
+				Image.Rounding = 0;
+				return Images.Allocate(std::move(Image));
+			}
+			case D3_POLYLINE:
+			{
+				D3DPolyline Polyline;
+				Polyline.Color = Black;
+				Polyline.Thickness = 1;
+				Polyline.Closed = FALSE;
+				Polyline.Filled = FALSE;
+				return Polylines.Allocate(std::move(Polyline));
+			}
+			case D3_POLYGON:
+			{
+				D3DPolygon Polygon;
+				Polygon.Count = Sides == 3 ? 3 : 4;
+				Polygon.Color = Black;
+				Polygon.Thickness = 1;
+				Polygon.Filled = FALSE;
+				for (auto& Point : Polygon.Points)
+					Point = ImVec2(0, 0);
+				return Polygons.Allocate(std::move(Polygon));
+			}
+		}
+
+		return 0;
+	}
+
+	bool syn::D3D::DestroyRenderObject(const D3DHandle Handle)
+	{
+		SceneDirty = true;
+
+		switch (GetD3DHandleType(Handle))
+		{
+			case D3_LINE: return Lines.Free(Handle);
+			case D3_TEXT: return Texts.Free(Handle);
+			case D3_SQUARE: return Squares.Free(Handle);
+			case D3_CIRCLE: return Circles.Free(Handle);
+			case D3_IMAGE:
+			{
+				/* Slots keep their item until reused, the texture shouldn't wait for that */
+				if (const auto Image = Images.Get(Handle))
+					Image->Image.reset();
+
+				return Images.Free(Handle);
+			}
+			case D3_POLYLINE: return Polylines.Free(Handle);
+			case D3_POLYGON: return Polygons.Free(Handle);
+		}
+
+		return false;
+	}
+
+	BYTE* syn::D3D::GetRenderVisible(const D3DHandle Handle)
+	{
+		SceneDirty = true;
+
+		switch (GetD3DHandleType(Handle))
+		{
+			case D3_LINE: return Lines.GetVisible(Handle);
+			case D3_TEXT: return Texts.GetVisible(Handle);
+			case D3_SQUARE: return Squares.GetVisible(Handle);
+			case D3_CIRCLE: return Circles.GetVisible(Handle);
+			case D3_IMAGE: return Images.GetVisible(Handle);
+			case D3_POLYLINE: return Polylines.GetVisible(Handle);
+			case D3_POLYGON: return Polygons.GetVisible(Handle);
+		}
+
+		return nullptr;
+	}
+
+	const int* syn::D3D::GetRenderZIndex(const D3DHandle Handle) const
+	{
+		switch (GetD3DHandleType(Handle))
+		{
+			case D3_LINE: return Lines.GetZIndex(Handle);
+			case D3_TEXT: return Texts.GetZIndex(Handle);
+			case D3_SQUARE: return Squares.GetZIndex(Handle);
+			case D3_CIRCLE: return Circles.GetZIndex(Handle);
+			case D3_IMAGE: return Images.GetZIndex(Handle);
+			case D3_POLYLINE: return Polylines.GetZIndex(Handle);
+			case D3_POLYGON: return Polygons.GetZIndex(Handle);
+		}
+
+		return nullptr;
+	}
+
+	bool syn::D3D::SetRenderZIndex(const D3DHandle Handle, const int ZIndex)
+	{
+		SceneDirty = true;
+
+		switch (GetD3DHandleType(Handle))
+		{
+			case D3_LINE: return Lines.SetZIndex(Handle, ZIndex);
+			case D3_TEXT: return Texts.SetZIndex(Handle, ZIndex);
+			case D3_SQUARE: return Squares.SetZIndex(Handle, ZIndex);
+			case D3_CIRCLE: return Circles.SetZIndex(Handle, ZIndex);
+			case D3_IMAGE: return Images.SetZIndex(Handle, ZIndex);
+			case D3_POLYLINE: return Polylines.SetZIndex(Handle, ZIndex);
+			case D3_POLYGON: return Polygons.SetZIndex(Handle, ZIndex);
+		}
+
+		return false;
+	}
+
+	void syn::ConsoleBuffer::Push(std::string Text, const ImU32 Color)
+	{
+		std::lock_guard<std::mutex> Guard(Mutex);
+
+		if (syn::Channel::GetSingleton()->Connected())
+		{
+			Pending += Text;
+			Pending += '\n';
+		}
+
+		auto& Slot = Lines[(Head + Count) % Capacity];
+		Slot.Text = std::move(Text);
+		Slot.Color = Color;
+
+		if (Count < Capacity)
+			Count++;
+		else
+			Head = (Head + 1) % Capacity;
+	}
+
+	void syn::ConsoleBuffer::Clear()
+	{
+		std::lock_guard<std::mutex> Guard(Mutex);
+
+		for (auto& Item : Lines)
+			std::string().swap(Item.Text);
+
+		Head = 0;
+		Count = 0;
+	}
+
+	void syn::ConsoleBuffer::Flush()
+	{
+		std::string Batch;
+
+		{
+			std::lock_guard<std::mutex> Guard(Mutex);
+			if (Pending.empty())
+				return;
+
+			Batch.swap(Pending);
+		}
+
+		syn::Channel::GetSingleton()->Send(syn::CM_CONSOLE, Batch);
+	}
+
+	void syn::D3D::SetEditorText(std::string Text)
+	{
+		std::lock_guard<std::mutex> Guard(EditorMutex);
+		PendingEditorText = std::move(Text);
+		EditorTextPending = true;
+	}
+
+	DWORD syn::D3D::BeginDecompilerText() const
+	{
+		std::lock_guard<std::mutex> Guard(DecompilerMutex);
+		PendingDecompilerText.clear();
+		DecompilerStreamed = false;
+
+		return ++DecompilerGeneration;
+	}
+
+	void syn::D3D::AppendDecompilerText(const DWORD Generation, const char* Text, const size_t Size, const bool Final) const
+	{
+		std::lock_guard<std::mutex> Guard(DecompilerMutex);
+		if (Generation != DecompilerGeneration.load() || (Final && DecompilerStreamed))
+			return;
+
+		DecompilerStreamed = true;
+		PendingDecompilerText.append(Text, Size);
+	}
+
+	void syn::D3D::ClearRenderObjects()
+	{
+		SceneDirty = true;
+
+		Lines.Reset();
+		Texts.Reset();
+		Squares.Reset();
+		Circles.Reset();
+		Images.Clear();
+		Polylines.Reset();
+		Polygons.Reset();
+	}
+
+	DWORD syn::D3D::SweepRenderObjects(std::vector<D3DHandle>& Live)
+	{
+		/* Leftovers of the last session aren't in anyone's wrapper table until they're claimed */
+		for (const auto& [Key, Kept] : KeptObjects)
+			if (!Kept.Claimed)
+				Live.push_back(Kept.Handle);
+
+		std::sort(Live.begin(), Live.end());
+		SweptObjects.fetch_add(DestroyRenderObjectsExcept(Live), std::memory_order_relaxed);
+
+		return Lines.Count() + Texts.Count() + Squares.Count() + Circles.Count() + Images.Count() + Polylines.Count() + Polygons.Count();
+	}
+
+	DWORD syn::D3D::DestroyRenderObjectsExcept(const std::vector<D3DHandle>& Live)
+	{
+		std::vector<D3DHandle> Dead;
+		const auto Collect = [&](const D3DHandle Handle)
+		{
+			if (!std::binary_search(Live.begin(), Live.end(), Handle))
+				Dead.push_back(Handle);
+		};
+
+		Lines.ForEachAlive(Collect);
+		Texts.ForEachAlive(Collect);
+		Squares.ForEachAlive(Collect);
+		Circles.ForEachAlive(Collect);
+		Images.ForEachAlive(Collect);
+		Polylines.ForEachAlive(Collect);
+		Polygons.ForEachAlive(Collect);
+
+		for (const auto Handle : Dead)
+			DestroyRenderObject(Handle);
+
+		return (DWORD) Dead.size();
+	}
+
+	syn::D3DHandle syn::D3D::CreateKeptRenderObject(const std::string& Key, const D3DTypes Type, const int Sides)
+	{
+		const auto Found = KeptObjects.find(Key);
+		if (Found != KeptObjects.end() && !Found->second.Claimed)
+		{
+			const auto Handle = Found->second.Handle;
+			const auto Polygon = Type == D3_POLYGON ? Polygons.Get(Handle) : nullptr;
+
+			if (GetD3DHandleType(Handle) == Type && GetRenderZIndex(Handle) && (Type != D3_POLYGON || (Polygon && Polygon->Count == Sides)))
+			{
+				Found->second.Claimed = true;
+				return Handle;
+			}
+
+			/* Asked for as something else this time */
+			DestroyRenderObject(Handle);
+		}
+
+		/* A claimed key asked for again moves to the new object, the old one stays an ordinary Drawing */
+		const auto Handle = CreateRenderObject(Type, Sides);
+		if (Handle)
+			KeptObjects[Key] = { Handle, true };
+		else if (Found != KeptObjects.end())
+			KeptObjects.erase(Found);
+
+		return Handle;
+	}
+
+	void syn::D3D::TeleportRenderObjects()
 	{
-		RenderChain.push_back(Object);
+		std::vector<D3DHandle> Kept;
+		for (auto It = KeptObjects.begin(); It != KeptObjects.end();)
+		{
+			/* Removed or collected during the session */
+			if (!GetRenderZIndex(It->second.Handle))
+			{
+				It = KeptObjects.erase(It);
+				continue;
+			}
+
+			It->second.Claimed = false;
+			Kept.push_back(It->second.Handle);
+			++It;
+		}
+
+		if (Kept.empty())
+		{
+			KeptSince = 0;
+			ClearRenderObjects();
+			return;
+		}
+
+		std::sort(Kept.begin(), Kept.end());
+		DestroyRenderObjectsExcept(Kept);
+		KeptSince = GetTickCount64();
 	}
 
-	void syn::D3D::RemoveFromRenderList(D3DObject* Object)
+	void syn::D3D::ExpireKeptRenderObjects()
 	{
-		RenderChain.erase(std::remove(RenderChain.begin(), RenderChain.end(), Object), RenderChain.end());
+		if (GetTickCount64() - KeptSince < KeptGrace)
+			return;
+
+		KeptSince = 0;
+		for (auto It = KeptObjects.begin(); It != KeptObjects.end();)
+		{
+			if (It->second.Claimed)
+			{
+				++It;
+				continue;
+			}
+
+			DestroyRenderObject(It->second.Handle);
+			It = KeptObjects.erase(It);
+		}
 	}
 
 	float syn::D3D::DrawText(ImFont* font, const std::string& text, const ImVec2& pos, float size, ImU32 color,
 		ImU32 ocolor, bool center, bool outline) const
 	{
 		auto Window = ImGui::GetCurrentWindow();
+		const auto DrawList = Window->DrawList;
 
 		ImGui::PushFont(font);
 
+		std::uint32_t SizeBits;
+		memcpy(&SizeBits, &size, sizeof SizeBits);
+		const auto Key = XXH3_64bits_withSeed(text.data(), text.size(),
+			(std::uint64_t) SizeBits << 32 ^ (uintptr_t) font ^ (center << 1 | outline));
+
+		/* AddText emits nothing for fully transparent colors, so those runs can't be replayed or captured */
+		const auto Opaque = (color & IM_COL32_A_MASK) && (!outline || (ocolor & IM_COL32_A_MASK));
+
+		const auto Cached = GlyphRuns.find(Key);
+		if (Opaque && Cached != GlyphRuns.end())
+		{
+			const auto& Run = Cached->second;
+
+			DrawList->PrimReserve((int) Run.Indices.size(), (int) Run.Vertices.size());
+
+			const auto Base = DrawList->_VtxCurrentIdx;
+			for (size_t i = 0; i < Run.Vertices.size(); i++)
+			{
+				auto Vertex = Run.Vertices[i];
+				Vertex.pos.x += pos.x;
+				Vertex.pos.y += pos.y;
+				Vertex.col = Run.OutlineMask[i] ? ocolor : color;
+				*DrawList->_VtxWritePtr++ = Vertex;
+			}
+
+			for (const auto Index : Run.Indices)
+				*DrawList->_IdxWritePtr++ = (ImDrawIdx) (Base + Index);
+
+			DrawList->_VtxCurrentIdx += (unsigned int) Run.Vertices.size();
+
+			ImGui::PopFont();
+
+			return pos.y + Run.Height;
+		}
+
+		const auto VtxStart = DrawList->VtxBuffer.Size;
+		const auto IdxStart = DrawList->IdxBuffer.Size;
+		const auto IdxBase = DrawList->_VtxCurrentIdx;
+		const auto VtxOffset = DrawList->_VtxCurrentOffset;
+
+		std::vector<BYTE> OutlineMask;
+		const auto MarkEmitted = [&](const BYTE IsOutline)
+		{
+			OutlineMask.resize(DrawList->VtxBuffer.Size - VtxStart, IsOutline);
+		};
+
+		/* Codepoints the atlas lacks draw as the fallback glyph until a rebuild with them is swapped in */
+		for (auto s = text.c_str(), End = s + text.size(); s < End;)
+		{
+			unsigned int c;
+			const auto Length = ImTextCharFromUtf8(&c, s, End);
+			if (!Length)
+				break;
+
+			s += Length;
+			if (c >= 0x20 && !font->FindGlyphNoFallback((ImWchar) c))
+				FontCache.Request(c);
+		}
+
 		std::stringstream steam(text);
 		std::string line;
 
+		auto MinX = pos.x, MaxX = pos.x;
 		auto y = 0.0f;
 		auto i = 0;
 
 		while (std::getline(steam, line))
 		{
 			const auto TextSize = font->CalcTextSizeA(size, FLT_MAX, 0.0f, line.c_str());
+			const auto X = center ? pos.x - TextSize.x / 2.0f : pos.x;
 
-			if (center)
-			{
-				if (outline)
-				{
-					Window->DrawList->AddText(font, size, ImVec2(pos.x - TextSize.x / 2.0f + 1, pos.y + TextSize.y * i + 1),
-						ocolor, line.c_str());
-					Window->DrawList->AddText(font, size, ImVec2(pos.x - TextSize.x / 2.0f - 1, pos.y + TextSize.y * i - 1),
-						ocolor, line.c_str());
-					Window->DrawList->AddText(font, size, ImVec2(pos.x - TextSize.x / 2.0f + 1, pos.y + TextSize.y * i - 1),
-						ocolor, line.c_str());
-					Window->DrawList->AddText(font, size, ImVec2(pos.x - TextSize.x / 2.0f - 1, pos.y + TextSize.y * i + 1),
-						ocolor, line.c_str());
-				}
+			MinX = (std::min)(MinX, X - 1);
+			MaxX = (std::max)(MaxX, X + TextSize.x + 1);
 
-				Window->DrawList->AddText(font, size, ImVec2(pos.x - TextSize.x / 2.0f, pos.y + TextSize.y * i), color,
-					line.c_str());
-			}
-			else
+			if (outline)
 			{
-				if (outline)
-				{
-					Window->DrawList->AddText(font, size, ImVec2(pos.x + 1, pos.y + TextSize.y * i + 1), ocolor,
-						line.c_str());
-					Window->DrawList->AddText(font, size, ImVec2(pos.x - 1, pos.y + TextSize.y * i - 1), ocolor,
-						line.c_str());
-					Window->DrawList->AddText(font, size, ImVec2(pos.x + 1, pos.y + TextSize.y * i - 1), ocolor,
-						line.c_str());
-					Window->DrawList->AddText(font, size, ImVec2(pos.x - 1, pos.y + TextSize.y * i + 1), ocolor,
-						line.c_str());
-				}
-
-				Window->DrawList->AddText(font, size, ImVec2(pos.x, pos.y + TextSize.y * i), color, line.c_str());
+				Window->DrawList->AddText(font, size, ImVec2(X + 1, pos.y + TextSize.y * i + 1), ocolor, line.c_str());
+				Window->DrawList->AddText(font, size, ImVec2(X - 1, pos.y + TextSize.y * i - 1), ocolor, line.c_str());
+				Window->DrawList->AddText(font, size, ImVec2(X + 1, pos.y + TextSize.y * i - 1), ocolor, line.c_str());
+				Window->DrawList->AddText(font, size, ImVec2(X - 1, pos.y + TextSize.y * i + 1), ocolor, line.c_str());
+				MarkEmitted(TRUE);
 			}
 
+			Window->DrawList->AddText(font, size, ImVec2(X, pos.y + TextSize.y * i), color, line.c_str());
+			MarkEmitted(FALSE);
+
 			y = pos.y + TextSize.y * (i + 1);
 			i++;
 		}
 
+		/* Only keep runs that weren't clipped and didn't straddle a vertex offset reset, anything else depends on where it was drawn */
+		const auto& Clip = DrawList->_ClipRectStack.back();
+		const auto Unclipped = MinX >= Clip.x && MaxX <= Clip.z && pos.y - 1 >= Clip.y && y + 1 <= Clip.w;
+
+		if (Opaque && Unclipped && VtxOffset == DrawList->_VtxCurrentOffset)
+		{
+			if (GlyphRuns.size() >= GlyphRunLimit)
+				GlyphRuns.clear();
+
+			auto& Run = GlyphRuns[Key];
+			Run.Vertices.assign(DrawList->VtxBuffer.Data + VtxStart, DrawList->VtxBuffer.Data + DrawList->VtxBuffer.Size);
+			for (auto& Vertex : Run.Vertices)
+			{
+				Vertex.pos.x -= pos.x;
+				Vertex.pos.y -= pos.y;
+			}
+
+			Run.Indices.resize(DrawList->IdxBuffer.Size - IdxStart);
+			for (size_t Idx = 0; Idx < Run.Indices.size(); Idx++)
+				Run.Indices[Idx] = (ImDrawIdx) (DrawList->IdxBuffer.Data[IdxStart + Idx] - IdxBase);
+
+			Run.OutlineMask = std::move(OutlineMask);
+			Run.Height = y - pos.y;
+		}
+
 		ImGui::PopFont();
 
 		return y;
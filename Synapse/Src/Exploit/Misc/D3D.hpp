@@ -10,10 +10,19 @@
 #pragma once
 
 #include "Static.hpp"
+#include "D3DInstancer.hpp"
+#include "D3DFonts.hpp"
+#include "D3DImages.hpp"
 #include "../../Utilities/Utils.hpp"
 #include "../../Source Dependencies/ImGUI/imgui.h"
 #include "../../Source Dependencies/ImGUITextEditor/TextEditor.h"
 
+#include <array>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <unordered_map>
 #include <filesystem>
 #pragma warning(disable: 26495 4005)
 #include <D3D11.h>
@@ -33,7 +42,43 @@ extern bool OutputRedirection;
 extern bool AutoScroll;
 extern DWORD TaskSched;
 extern DWORD TaskSchedDelay;
-extern std::vector<std::pair<std::string, ImU32>> ConsoleOutput;
+namespace syn
+{
+	/* Fixed capacity console, the oldest line is overwritten once it is full */
+	class ConsoleBuffer
+	{
+	public:
+		static constexpr size_t Capacity = 4096;
+
+		struct Line
+		{
+			std::string Text;
+			ImU32 Color;
+		};
+
+		/* Held by the overlay while it draws, and by Push/Clear */
+		mutable std::mutex Mutex;
+
+		void Push(std::string Text, ImU32 Color);
+		void Clear();
+
+		/* Oldest first, callers hold Mutex */
+		size_t Size() const { return Count; }
+		const Line& At(size_t Index) const { return Lines[(Head + Index) % Capacity]; }
+
+		/* Sends the lines pushed since the last call to the UI as one frame, called once per scheduler step */
+		void Flush();
+
+	private:
+		std::array<Line, Capacity> Lines;
+		size_t Head = 0;
+		size_t Count = 0;
+
+		std::string Pending; /* newline separated, only built while the UI channel is connected */
+	};
+}
+
+extern syn::ConsoleBuffer ConsoleOutput;
 
 namespace syn
 {
@@ -43,12 +88,43 @@ namespace syn
 		D3_TEXT,
 		D3_SQUARE,
 		D3_CIRCLE,
+		D3_IMAGE,
+		D3_POLYLINE,
+		D3_POLYGON,		/* Triangle and Quad */
+		D3_TYPE_COUNT
 	};
 
-	struct D3DHeader
+	/* Property ids for setrenderproperty/Drawing.update, resolved from names once on the Lua side */
+	enum D3DProperty
 	{
-		BYTE Visible;
-		D3DTypes Type;
+		DP_VISIBLE,
+		DP_FROM,
+		DP_TO,
+		DP_COLOR,
+		DP_THICKNESS,
+		DP_TRANSPARENCY,
+		DP_TEXT,
+		DP_POSITION,
+		DP_SIZE,
+		DP_FONT,
+		DP_CENTER,
+		DP_OUTLINE,
+		DP_OUTLINECOLOR,
+		DP_TEXTBOUNDS,
+		DP_FILLED,
+		DP_RADIUS,
+		DP_NUMSIDES,
+		DP_DATA,
+		DP_ROUNDING,
+		DP_IMAGESIZE,
+		DP_POINTS,
+		DP_POINTA,
+		DP_POINTB,
+		DP_POINTC,
+		DP_POINTD,
+		DP_CLOSED,
+		DP_ZINDEX,
+		DP_INVALID
 	};
 
 	struct D3DLine
@@ -80,7 +156,7 @@ namespace syn
 
 	struct D3DText
 	{
-		std::string* Text{};
+		std::string Text;
 		ImVec2 Pos;
 		float Size{};
 		ImU32 Font{};
@@ -90,15 +166,365 @@ namespace syn
 		ImU32 OutlineColor{};
 	};
 
-	struct D3DObject
+	struct D3DImage
+	{
+		ImVec2 Pos;
+		ImVec2 Size;
+		ImU32 Color{};		/* tint, white draws the image as is */
+		float Rounding{};
+		std::shared_ptr<D3DImageTexture> Image;
+	};
+
+	struct D3DPolyline
 	{
-		D3DHeader Header;
-		DWORD* Ptr;
+		/* Keeps one AddPolyline within what a single reservation of 16 bit indices can address */
+		static constexpr size_t MaxPoints = 8192;
+
+		std::vector<ImVec2> Points;
+		ImU32 Color{};
+		float Thickness{};
+		BYTE Closed{};
+		BYTE Filled{};		/* the points have to describe a convex polygon */
+	};
+
+	struct D3DPolygon
+	{
+		ImVec2 Points[4];
+		BYTE Count{};		/* 3 for triangles, 4 for quads */
+		ImU32 Color{};
+		float Thickness{};
+		BYTE Filled{};
+	};
+
+	/* Memberwise, lets a publish that rewrote the same values be dropped */
+	inline bool operator==(const ImVec2& A, const ImVec2& B) { return A.x == B.x && A.y == B.y; }
+	inline bool operator==(const D3DLine& A, const D3DLine& B) { return A.From == B.From && A.To == B.To && A.Color == B.Color && A.Thickness == B.Thickness; }
+	inline bool operator==(const D3DSquare& A, const D3DSquare& B) { return A.Pos == B.Pos && A.Size == B.Size && A.Color == B.Color && A.Thickness == B.Thickness && A.Filled == B.Filled; }
+	inline bool operator==(const D3DCircle& A, const D3DCircle& B) { return A.Pos == B.Pos && A.Radius == B.Radius && A.Color == B.Color && A.Thickness == B.Thickness && A.Filled == B.Filled && A.Sides == B.Sides; }
+	inline bool operator==(const D3DImage& A, const D3DImage& B) { return A.Pos == B.Pos && A.Size == B.Size && A.Color == B.Color && A.Rounding == B.Rounding && A.Image == B.Image; }
+	inline bool operator==(const D3DPolyline& A, const D3DPolyline& B) { return A.Color == B.Color && A.Thickness == B.Thickness && A.Closed == B.Closed && A.Filled == B.Filled && A.Points == B.Points; }
+	inline bool operator==(const D3DPolygon& A, const D3DPolygon& B)
+	{
+		return A.Count == B.Count && A.Color == B.Color && A.Thickness == B.Thickness && A.Filled == B.Filled
+			&& std::equal(A.Points, A.Points + A.Count, B.Points);
+	}
+	inline bool operator==(const D3DText& A, const D3DText& B)
+	{
+		return A.Pos == B.Pos && A.Size == B.Size && A.Font == B.Font && A.Color == B.Color && A.Center == B.Center
+			&& A.Outline == B.Outline && A.OutlineColor == B.OutlineColor && A.Text == B.Text;
+	}
+
+	/* Handles are [Type + 1 : 3][Generation : 12][Index : 17], never zero so they survive as light userdata. That leaves room for 7 types */
+	typedef DWORD D3DHandle;
+
+	inline D3DHandle MakeD3DHandle(const D3DTypes Type, const DWORD Generation, const DWORD Index) { return (Type + 1) << 29 | (Generation & 0xFFF) << 17 | Index; }
+	inline D3DTypes GetD3DHandleType(const D3DHandle Handle) { return (D3DTypes) ((Handle >> 29) - 1); }
+	inline DWORD GetD3DHandleGeneration(const D3DHandle Handle) { return Handle >> 17 & 0xFFF; }
+	inline DWORD GetD3DHandleIndex(const D3DHandle Handle) { return Handle & 0x1FFFF; }
+
+	/* Per-type slab arena. Slabs never move once allocated, slots are recycled through a free list and
+	   every reuse bumps the slot's generation so handles to the previous occupant stop resolving.
+	   Live slots are also kept in one bucket per ZIndex, in the order they entered it, so publishing walks them
+	   already sorted and only a ZIndex change moves a slot */
+	template <typename T, D3DTypes Type>
+	class D3DPool
+	{
+		static constexpr DWORD SlabSize = 256;
+		static constexpr DWORD MaxSlots = 0x20000;
+
+		struct Slab
+		{
+			T Items[SlabSize];
+			BYTE Visible[SlabSize]{};
+			BYTE Alive[SlabSize]{};
+			WORD Generation[SlabSize]{};
+			int ZIndex[SlabSize]{};
+			DWORD LayerPos[SlabSize]{};	/* position in its layer's Slots */
+		};
+
+		/* Removed slots leave a tombstone, compacted once they make up half of the layer */
+		static constexpr DWORD DeadSlot = ~0u;
+
+		struct Layer
+		{
+			std::vector<DWORD> Slots;
+			DWORD Dead = 0;
+		};
+
+		std::vector<std::unique_ptr<Slab>> Slabs;
+		std::vector<DWORD> FreeSlots;
+		std::map<int, Layer> Layers;
+		DWORD Used = 0;
+
+		void Insert(const DWORD Index, const int ZIndex)
+		{
+			auto& S = *Slabs[Index / SlabSize];
+			auto& L = Layers[ZIndex];
+
+			S.ZIndex[Index % SlabSize] = ZIndex;
+			S.LayerPos[Index % SlabSize] = (DWORD) L.Slots.size();
+			L.Slots.push_back(Index);
+		}
+
+		void Remove(const DWORD Index)
+		{
+			auto& S = *Slabs[Index / SlabSize];
+			const auto It = Layers.find(S.ZIndex[Index % SlabSize]);
+			auto& L = It->second;
+
+			L.Slots[S.LayerPos[Index % SlabSize]] = DeadSlot;
+			if (++L.Dead == L.Slots.size())
+			{
+				Layers.erase(It);
+				return;
+			}
+
+			if (L.Dead * 2 < L.Slots.size())
+				return;
+
+			/* Stable, so the layer keeps its draw order */
+			DWORD Count = 0;
+			for (const auto Slot : L.Slots)
+			{
+				if (Slot == DeadSlot)
+					continue;
+
+				Slabs[Slot / SlabSize]->LayerPos[Slot % SlabSize] = Count;
+				L.Slots[Count++] = Slot;
+			}
+
+			L.Slots.resize(Count);
+			L.Dead = 0;
+		}
+
+		Slab* Resolve(const D3DHandle Handle, DWORD& Slot) const
+		{
+			const auto Index = GetD3DHandleIndex(Handle);
+			if (GetD3DHandleType(Handle) != Type || Index >= Used)
+				return nullptr;
+
+			const auto S = Slabs[Index / SlabSize].get();
+			Slot = Index % SlabSize;
+			return S->Alive[Slot] && S->Generation[Slot] == GetD3DHandleGeneration(Handle) ? S : nullptr;
+		}
+
+	public:
+		D3DHandle Allocate(T&& Item)
+		{
+			DWORD Index;
+			if (!FreeSlots.empty())
+			{
+				Index = FreeSlots.back();
+				FreeSlots.pop_back();
+			}
+			else
+			{
+				if (Used == MaxSlots)
+					return 0;
+
+				if (Used == Slabs.size() * SlabSize)
+					Slabs.push_back(std::make_unique<Slab>());
+
+				Index = Used++;
+			}
+
+			auto& S = *Slabs[Index / SlabSize];
+			const auto Slot = Index % SlabSize;
+
+			S.Items[Slot] = std::move(Item);
+			S.Visible[Slot] = FALSE;
+			S.Alive[Slot] = TRUE;
+			S.Generation[Slot] = (S.Generation[Slot] + 1) & 0xFFF;
+			Insert(Index, 0);
+
+			return MakeD3DHandle(Type, S.Generation[Slot], Index);
+		}
+
+		bool Free(const D3DHandle Handle)
+		{
+			DWORD Slot;
+			const auto S = Resolve(Handle, Slot);
+			if (!S)
+				return false;
+
+			S->Visible[Slot] = FALSE;
+			S->Alive[Slot] = FALSE;
+			Remove(GetD3DHandleIndex(Handle));
+			FreeSlots.push_back(GetD3DHandleIndex(Handle));
+			return true;
+		}
+
+		const int* GetZIndex(const D3DHandle Handle) const
+		{
+			DWORD Slot;
+			const auto S = Resolve(Handle, Slot);
+			return S ? &S->ZIndex[Slot] : nullptr;
+		}
+
+		/* Moves the slot to the end of its new layer, setting the ZIndex it already has keeps its place */
+		bool SetZIndex(const D3DHandle Handle, const int ZIndex)
+		{
+			DWORD Slot;
+			const auto S = Resolve(Handle, Slot);
+			if (!S)
+				return false;
+
+			if (S->ZIndex[Slot] != ZIndex)
+			{
+				Remove(GetD3DHandleIndex(Handle));
+				Insert(GetD3DHandleIndex(Handle), ZIndex);
+			}
+
+			return true;
+		}
+
+		T* Get(const D3DHandle Handle) const
+		{
+			DWORD Slot;
+			const auto S = Resolve(Handle, Slot);
+			return S ? &S->Items[Slot] : nullptr;
+		}
+
+		BYTE* GetVisible(const D3DHandle Handle) const
+		{
+			DWORD Slot;
+			const auto S = Resolve(Handle, Slot);
+			return S ? &S->Visible[Slot] : nullptr;
+		}
+
+		DWORD Count() const
+		{
+			return Used - (DWORD) FreeSlots.size();
+		}
+
+		/* Calls Visit with the handle of every live slot */
+		template <typename Fn>
+		void ForEachAlive(Fn&& Visit) const
+		{
+			for (DWORD Index = 0; Index < Used; Index++)
+			{
+				const auto& S = *Slabs[Index / SlabSize];
+				if (S.Alive[Index % SlabSize])
+					Visit(MakeD3DHandle(Type, S.Generation[Index % SlabSize], Index));
+			}
+		}
+
+		/* O(1), slots past Used are dead by definition and get their state rewritten on reuse */
+		void Reset()
+		{
+			Used = 0;
+			FreeSlots.clear();
+			Layers.clear();
+		}
+
+		/* Reset that also drops what the items hold, for types owning more than memory */
+		void Clear()
+		{
+			for (DWORD Index = 0; Index < Used; Index++)
+				Slabs[Index / SlabSize]->Items[Index % SlabSize] = T();
+
+			Reset();
+		}
+
+		/* Copies every visible item into Out by ascending ZIndex, assigning over existing elements so their storage gets reused.
+		   Ranges gets (ZIndex, end of that layer in Out) for every layer that had something visible */
+		void CopyVisible(std::vector<T>& Out, std::vector<std::pair<int, size_t>>& Ranges) const
+		{
+			size_t Count = 0;
+			Ranges.clear();
+
+			for (const auto& Entry : Layers)
+			{
+				const auto Begin = Count;
+				for (const auto Index : Entry.second.Slots)
+				{
+					if (Index == DeadSlot)
+						continue;
+
+					const auto& S = *Slabs[Index / SlabSize];
+					if (!S.Visible[Index % SlabSize])
+						continue;
+
+					if (Count < Out.size())
+						Out[Count] = S.Items[Index % SlabSize];
+					else
+						Out.push_back(S.Items[Index % SlabSize]);
+					Count++;
+				}
+
+				if (Count != Begin)
+					Ranges.emplace_back(Entry.first, Count);
+			}
+
+			Out.resize(Count);
+		}
+	};
+
+	/* A range of one of the scene's shape passes, in draw order */
+	enum SceneBatch
+	{
+		SB_LINES,
+		SB_SQUARES,
+		SB_FILLED_SQUARES,
+		SB_CIRCLES
+	};
+
+	struct SceneChunk
+	{
+		SceneBatch Batch;
+		size_t Begin;
+		size_t End;
+	};
+
+	/* The slice of every type's vector drawn at one ZIndex, types keep their fixed order within a layer */
+	struct SceneLayer
+	{
+		int ZIndex;
+		size_t Begin[D3_TYPE_COUNT];
+		size_t End[D3_TYPE_COUNT];
+
+		bool operator==(const SceneLayer& Other) const
+		{
+			return ZIndex == Other.ZIndex && !memcmp(Begin, Other.Begin, sizeof Begin) && !memcmp(End, Other.End, sizeof End);
+		}
+	};
+
+	/* What Present draws, copied out of the pools once per scheduler step */
+	struct D3DScene
+	{
+		std::vector<D3DLine> Lines;
+		std::vector<D3DText> Texts;
+		std::vector<D3DSquare> Squares;
+		std::vector<D3DCircle> Circles;
+		std::vector<D3DImage> Images;
+		std::vector<D3DPolyline> Polylines;
+		std::vector<D3DPolygon> Polygons;
+		std::vector<SceneLayer> Layers;		/* ascending ZIndex */
+		DWORD Counts[D3_TYPE_COUNT]{};	/* live objects per D3DTypes, visible or not */
+
+		bool operator==(const D3DScene& Other) const
+		{
+			return Lines == Other.Lines && Squares == Other.Squares && Circles == Other.Circles && Texts == Other.Texts
+				&& Images == Other.Images && Polylines == Other.Polylines && Polygons == Other.Polygons && Layers == Other.Layers
+				&& !memcmp(Counts, Other.Counts, sizeof Counts);
+		}
+	};
+
+	/* Vertices of one DrawText call, relative to its position so a moved label can be replayed */
+	struct GlyphRun
+	{
+		std::vector<ImDrawVert> Vertices;
+		std::vector<ImDrawIdx> Indices;
+		std::vector<BYTE> OutlineMask;
+		float Height;
 	};
 
 	class D3D
 	{
 		std::vector<ImFont*> Fonts;
+
+		static constexpr size_t GlyphRunLimit = 2048;
+		mutable std::unordered_map<std::uint64_t, GlyphRun> GlyphRuns;
 		inline static wchar_t IniPath[23767]{};
 
 		static bool WriteMemory(void* Addr, const void* Patch, size_t Sz);
@@ -109,17 +535,92 @@ namespace syn
 
 		static int FindDelayOffset(DWORD Sched);
 
-		static void SetupFPSUnlocker();
+		static bool SetupFPSUnlocker();
 	public:
-		std::vector<D3DObject*> RenderChain;
+		D3DPool<D3DLine, D3_LINE> Lines;
+		D3DPool<D3DText, D3_TEXT> Texts;
+		D3DPool<D3DSquare, D3_SQUARE> Squares;
+		D3DPool<D3DCircle, D3_CIRCLE> Circles;
+		D3DPool<D3DImage, D3_IMAGE> Images;
+		D3DPool<D3DPolyline, D3_POLYLINE> Polylines;
+		D3DPool<D3DPolygon, D3_POLYGON> Polygons;
+
+		/* The pools belong to the game thread. PublishScene snapshots them into a triple buffer that Present
+		   swaps out of without locking, so a frame never sees half of a step's writes */
+		static constexpr DWORD SceneFresh = 4;
+		std::array<D3DScene, 3> Scenes;
+		DWORD SceneBack = 0;						/* game thread */
+		mutable DWORD SceneFront = 1;				/* render thread */
+		std::atomic<DWORD> SceneReady{ 2 };			/* last published index, | SceneFresh until Present takes it */
+		DWORD ScenePublished = 2;					/* game thread, never handed back to it while it's the newest */
+		bool SceneDirty = true;						/* pools touched since the last publish, game thread */
+
+		/* Shapes go through the GPU when synf::UseInstancedDrawing is set and the device supports it */
+		mutable D3DInstancer Instancer;
+
+		/* Grows as texts need new codepoints, DrawText queues them */
+		mutable D3DFonts FontCache;
+
+		/* Textures behind D3DImage, shared by identical data */
+		mutable D3DImages ImageCache;
+
+		/* Otherwise scenes past ParallelSceneThreshold shapes are tessellated on the thread pool, render thread only */
+		static constexpr size_t ParallelSceneThreshold = 4096;
+		static constexpr size_t ParallelSceneChunk = 1024;
+		mutable std::vector<SceneChunk> SceneChunks;
+		mutable std::vector<std::unique_ptr<ImDrawList>> SceneLists;
+
+		void DrawSceneParallel(ImDrawList* DrawList, const D3DScene& Scene, const SceneChunk (&Batches)[4], size_t Helpers) const;
+
+		/* PublishScene's per-type layer ranges before they're merged into D3DScene::Layers, game thread */
+		std::array<std::vector<std::pair<int, size_t>>, D3_TYPE_COUNT> LayerRanges;
+
+		/* Text sent by the UI for the in-game editor, applied by the render thread on its next frame */
+		mutable std::mutex EditorMutex;
+		mutable std::string PendingEditorText;
+		mutable bool EditorTextPending = false;
+
+		/* How often the explorer's properties panel re-reads the selected instance, in Hz */
+		DWORD PropertyRefreshRate = 10;
+
+		/* Explorer decompiler output, appended by the decompile worker as unluac writes it and drained by the render thread each frame */
+		mutable std::mutex DecompilerMutex;
+		mutable std::string PendingDecompilerText;
+		mutable bool DecompilerStreamed = false;
+		mutable std::atomic<DWORD> DecompilerGeneration{ 0 };	/* bumped whenever the view is reopened or closed, stale output is dropped */
+		mutable DWORD DecompilerThread = 0;	/* Lua thread running the view's decompile call, game thread only */
 
 		static std::wstring GetWorkingPath();
 
 		static bool __declspec(noinline) Initialize(bool UnlockFPS = FALSE);
 
+		/* Frame limiter applied by PresentHook once the unlocker found the task scheduler, 0 leaves Roblox's own 60 */
+		inline static std::atomic<double> FPSCap{ 144.0 };
+		inline static std::atomic<bool> FPSLowLatency{ false };	/* present without vsync, frames are paced by the limiter alone */
+
+		/* False if the task scheduler couldn't be found */
+		static bool SetFPSCap(double FPS, bool LowLatency);
+
+		static double GetSchedulerDelay();
+
+		/* Waits out the rest of the frame after Present, so the next frame samples input as late as possible */
+		static void PaceFrame();
+
+		static void LoadExplorerProperties();
+
 		static D3D* GetSingleton();
 
-		void AddFont(ImFont* _Font);
+		/* Render thread, once ImGui is initialized */
+		void InitializeFonts();
+
+		/* Whether the first atlas is built, Present draws nothing before */
+		bool FontsReady() const { return FontCache.Ready(); }
+
+		/* Whether a rebuilt atlas is waiting for UpdateFonts */
+		bool HasNewFonts() const { return FontCache.HasNewAtlas(); }
+
+		/* Render thread, before NewFrame. Swaps in a rebuilt atlas or starts one for the codepoints texts asked for */
+		bool UpdateFonts();
 
 		ImFont* GetFont(int idx) const;
 
@@ -127,13 +628,79 @@ namespace syn
 
 		void DrawScene() const;
 
+		/* Draws Scene in place of the published one, the overlay benchmark feeds its synthetic scenes through here */
+		void DrawScene(const D3DScene& Scene) const;
+
 		void EndScene();
 
 		void DrawUI() const;
 
-		void AddToRenderList(D3DObject* Object);
+		/* Sides picks between a triangle and a quad for D3_POLYGON */
+		D3DHandle CreateRenderObject(D3DTypes Type, int Sides = 4);
+
+		bool DestroyRenderObject(D3DHandle Handle);
+
+		/* Returns the object's visibility flag, or nullptr if the handle is dead */
+		BYTE* GetRenderVisible(D3DHandle Handle);
 
-		void RemoveFromRenderList(D3DObject* Object);
+		/* Objects draw in ascending ZIndex, ties in the order they were created or last moved to it */
+		const int* GetRenderZIndex(D3DHandle Handle) const;
+
+		bool SetRenderZIndex(D3DHandle Handle, int ZIndex);
+
+		template <typename T>
+		T* GetRenderObject(D3DHandle Handle);
+
+		void ClearRenderObjects();
+
+		/* Destroys every object whose handle isn't in Live (sorted in place) and returns how many are left.
+		   Drawing.new keeps its objects in a weak table, so whatever the Lua GC collected drops out of it */
+		DWORD SweepRenderObjects(std::vector<D3DHandle>& Live);
+
+		std::atomic<DWORD> SweptObjects{ 0 };	/* total destroyed by SweepRenderObjects, shown on the overlay */
+
+		/* Drawing.new(Type, Key): the same key after a teleport hands back the object the last session left, properties
+		   and all, so HUDs redrawn by autoexec show up without a blank frame. Ones nobody asks for within KeptGrace go */
+		static constexpr ULONGLONG KeptGrace = 15000;
+		D3DHandle CreateKeptRenderObject(const std::string& Key, D3DTypes Type, int Sides = 4);
+
+		/* ClearRenderObjects for a teleport, except for the keyed objects */
+		void TeleportRenderObjects();
+
+	private:
+		struct KeptRenderObject
+		{
+			D3DHandle Handle;
+			bool Claimed;	/* asked for by the current session, its wrapper owns it again */
+		};
+
+		/* Game thread */
+		std::unordered_map<std::string, KeptRenderObject> KeptObjects;
+		ULONGLONG KeptSince = 0;	/* teleport whose leftovers are still unclaimed, 0 for none */
+
+		/* Destroys every object not in Live (sorted), returns how many were */
+		DWORD DestroyRenderObjectsExcept(const std::vector<D3DHandle>& Live);
+
+		void ExpireKeptRenderObjects();
+
+	public:
+
+		/* Called once per scheduler step on the game thread */
+		void PublishScene();
+
+		/* Whether a scene was published that Present hasn't drawn yet */
+		bool HasNewScene() const { return (SceneReady.load(std::memory_order_relaxed) & SceneFresh) != 0; }
+
+		/* Whether an image the scene may be waiting on finished decoding */
+		bool HasNewImages() const { return ImageCache.HasDecoded(); }
+
+		void SetEditorText(std::string Text);
+
+		/* Starts a new decompiler view and returns its generation */
+		DWORD BeginDecompilerText() const;
+
+		/* Final is the decompile result itself, only used when nothing was streamed for that generation */
+		void AppendDecompilerText(DWORD Generation, const char* Text, size_t Size, bool Final = false) const;
 
 		float DrawText(ImFont* font, const std::string& text, const ImVec2& pos, float size, ImU32 color, ImU32 ocolor,
 		               bool center, bool outline) const;
@@ -148,4 +715,13 @@ namespace syn
 
 		static void DrawCircleFilled(const ImVec2& position, float radius, ImU32 color, int sides);
 	};
-}
\ No newline at end of file
+
+	/* Callers get a writable pointer, so the next publish has to re-snapshot */
+	template <> inline D3DLine* D3D::GetRenderObject<D3DLine>(const D3DHandle Handle) { SceneDirty = true; return Lines.Get(Handle); }
+	template <> inline D3DText* D3D::GetRenderObject<D3DText>(const D3DHandle Handle) { SceneDirty = true; return Texts.Get(Handle); }
+	template <> inline D3DSquare* D3D::GetRenderObject<D3DSquare>(const D3DHandle Handle) { SceneDirty = true; return Squares.Get(Handle); }
+	template <> inline D3DCircle* D3D::GetRenderObject<D3DCircle>(const D3DHandle Handle) { SceneDirty = true; return Circles.Get(Handle); }
+	template <> inline D3DImage* D3D::GetRenderObject<D3DImage>(const D3DHandle Handle) { SceneDirty = true; return Images.Get(Handle); }
+	template <> inline D3DPolyline* D3D::GetRenderObject<D3DPolyline>(const D3DHandle Handle) { SceneDirty = true; return Polylines.Get(Handle); }
+	template <> inline D3DPolygon* D3D::GetRenderObject<D3DPolygon>(const D3DHandle Handle) { SceneDirty = true; return Polygons.Get(Handle); }
+}
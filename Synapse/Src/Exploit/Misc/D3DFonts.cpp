@@ -0,0 +1,314 @@
+#include "./D3DFonts.hpp"
+#include "./D3D.hpp"
+#include "./Flags.hpp"
+#include "./Fonts.hpp"
+
+#include "../../Source Dependencies/ImGUI/imgui_impl_dx11.h"
+#include "../../Source Dependencies/ImGUI/imgui_freetype.h"
+#include "../../Utilities/Hashing/XXHash/xxhash.h"
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace syn
+{
+	/* Bump whenever the atlas layout or the font setup in AddFonts changes */
+	static constexpr DWORD FontCacheMagic = 0x464E5953;	/* SYNF */
+	static constexpr DWORD FontCacheVersion = 1;
+	static constexpr float FontSize = 32.0f;
+
+	struct FontCacheHeader
+	{
+		DWORD Magic;
+		DWORD Version;
+		std::uint64_t Key;
+		int TexWidth, TexHeight;
+		ImVec2 TexUvWhitePixel;
+		int RangeCount;
+		int FontCount;
+		int RectCount;
+		int RectId;
+	};
+
+	struct FontCacheRect
+	{
+		unsigned int ID;
+		unsigned short Width, Height, X, Y;
+		float GlyphAdvanceX;
+		ImVec2 GlyphOffset;
+		int Font;
+	};
+
+	struct FontCacheFont
+	{
+		float FontSize, Ascent, Descent;
+		int MetricsTotalSurface;
+		int GlyphCount;
+	};
+
+	void D3DFonts::AddFonts(ImFontAtlas* Atlas, const ImWchar* Ranges)
+	{
+		ImFontConfig Config{};
+		Config.OversampleH = 3;
+		Config.OversampleV = 3;
+		Config.GlyphRanges = Ranges;
+
+		/* Order matters, Drawing fonts are indices into these */
+		Atlas->AddFontFromMemoryCompressedTTF(seoge_ui_compressed_data, seoge_ui_compressed_size, FontSize, &Config);
+		Atlas->AddFontDefault(&Config);
+		Atlas->AddFontFromMemoryCompressedTTF(ibm_plex_compressed_data, ibm_plex_compressed_size, FontSize, &Config);
+		Atlas->AddFontFromMemoryCompressedTTF(sometype_mono_compressed_data, sometype_mono_compressed_size, FontSize, &Config);
+
+		Atlas->TexGlyphPadding = 1;
+		for (auto n = 0; n < Atlas->ConfigData.Size; n++)
+		{
+			auto* FontCfg = &Atlas->ConfigData[n];
+			FontCfg->RasterizerMultiply = 1.0f;
+			FontCfg->RasterizerFlags = 0;
+		}
+	}
+
+	std::uint64_t D3DFonts::CacheKey()
+	{
+		/* The default font is compiled into ImGui, so its version stands in for it */
+		auto Key = XXH3_64bits_withSeed(seoge_ui_compressed_data, seoge_ui_compressed_size,
+			(std::uint64_t) IMGUI_VERSION_NUM << 32 | sizeof(ImFontGlyph));
+		Key = XXH3_64bits_withSeed(ibm_plex_compressed_data, ibm_plex_compressed_size, Key);
+		return XXH3_64bits_withSeed(sometype_mono_compressed_data, sometype_mono_compressed_size, Key);
+	}
+
+	std::wstring D3DFonts::CachePath()
+	{
+		return D3D::GetWorkingPath() + L"\\bin\\fontatlas.bin";
+	}
+
+	bool D3DFonts::LoadCache(ImFontAtlas* Atlas, ImVector<ImWchar>& Ranges)
+	{
+		std::ifstream File(CachePath(), std::ios::binary);
+		if (!File)
+			return false;
+
+		const auto Read = [&File](void* Out, const size_t Size)
+		{
+			return (bool) File.read((char*) Out, Size);
+		};
+
+		FontCacheHeader Header{};
+		if (!Read(&Header, sizeof Header) || Header.Magic != FontCacheMagic || Header.Version != FontCacheVersion
+			|| Header.Key != CacheKey() || Header.FontCount != Atlas->Fonts.Size)
+			return false;
+
+		if (Header.TexWidth <= 0 || Header.TexHeight <= 0 || Header.TexWidth > 16384 || Header.TexHeight > 16384
+			|| Header.RangeCount <= 0 || Header.RangeCount > 0x20000 || Header.RectCount < 0 || Header.RectCount > 0x10000)
+			return false;
+
+		/* Everything is read into temporaries first, a truncated file leaves the atlas untouched */
+		ImVector<ImWchar> CachedRanges;
+		CachedRanges.resize(Header.RangeCount);
+		if (!Read(CachedRanges.Data, Header.RangeCount * sizeof(ImWchar)) || CachedRanges.back() != 0)
+			return false;
+
+		std::vector<FontCacheRect> Rects(Header.RectCount);
+		if (!Rects.empty() && !Read(Rects.data(), Rects.size() * sizeof(FontCacheRect)))
+			return false;
+
+		std::vector<FontCacheFont> Fonts(Header.FontCount);
+		std::vector<ImVector<ImFontGlyph>> Glyphs(Header.FontCount);
+		for (auto i = 0; i < Header.FontCount; i++)
+		{
+			if (!Read(&Fonts[i], sizeof(FontCacheFont)) || Fonts[i].GlyphCount < 0 || Fonts[i].GlyphCount >= 0xFFFF)
+				return false;
+
+			Glyphs[i].resize(Fonts[i].GlyphCount);
+			if (Fonts[i].GlyphCount && !Read(Glyphs[i].Data, Fonts[i].GlyphCount * sizeof(ImFontGlyph)))
+				return false;
+		}
+
+		const auto PixelCount = (size_t) Header.TexWidth * Header.TexHeight;
+		const auto Pixels = (unsigned char*) ImGui::MemAlloc(PixelCount);
+		if (!Read(Pixels, PixelCount))
+		{
+			ImGui::MemFree(Pixels);
+			return false;
+		}
+
+		Atlas->ClearTexData();
+		Atlas->TexPixelsAlpha8 = Pixels;
+		Atlas->TexWidth = Header.TexWidth;
+		Atlas->TexHeight = Header.TexHeight;
+		Atlas->TexUvScale = ImVec2(1.0f / Header.TexWidth, 1.0f / Header.TexHeight);
+		Atlas->TexUvWhitePixel = Header.TexUvWhitePixel;
+
+		Atlas->CustomRects.resize(Header.RectCount);
+		for (auto i = 0; i < Header.RectCount; i++)
+		{
+			const auto& Cached = Rects[i];
+			auto& Rect = Atlas->CustomRects[i];
+			Rect.ID = Cached.ID;
+			Rect.Width = Cached.Width;
+			Rect.Height = Cached.Height;
+			Rect.X = Cached.X;
+			Rect.Y = Cached.Y;
+			Rect.GlyphAdvanceX = Cached.GlyphAdvanceX;
+			Rect.GlyphOffset = Cached.GlyphOffset;
+			Rect.Font = Cached.Font >= 0 && Cached.Font < Atlas->Fonts.Size ? Atlas->Fonts[Cached.Font] : NULL;
+		}
+		Atlas->CustomRectIds[0] = Header.RectId < Header.RectCount ? Header.RectId : -1;
+
+		/* What ImFontAtlasBuildSetupFont and the glyph loop would have left behind, fonts are never merged here */
+		for (auto i = 0; i < Header.FontCount; i++)
+		{
+			const auto Font = Atlas->Fonts[i];
+			Font->ClearOutputData();
+			Font->FontSize = Fonts[i].FontSize;
+			Font->ConfigData = &Atlas->ConfigData[i];
+			Font->ConfigDataCount = 1;
+			Font->ContainerAtlas = Atlas;
+			Font->Ascent = Fonts[i].Ascent;
+			Font->Descent = Fonts[i].Descent;
+			Font->MetricsTotalSurface = Fonts[i].MetricsTotalSurface;
+			Font->Glyphs.swap(Glyphs[i]);
+			Font->BuildLookupTable();
+		}
+
+		Ranges.swap(CachedRanges);
+		return true;
+	}
+
+	void D3DFonts::SaveCache(const ImFontAtlas* Atlas, const ImVector<ImWchar>& Ranges)
+	{
+		if (!Atlas->TexPixelsAlpha8)
+			return;
+
+		FontCacheHeader Header{};
+		Header.Magic = FontCacheMagic;
+		Header.Version = FontCacheVersion;
+		Header.Key = CacheKey();
+		Header.TexWidth = Atlas->TexWidth;
+		Header.TexHeight = Atlas->TexHeight;
+		Header.TexUvWhitePixel = Atlas->TexUvWhitePixel;
+		Header.RangeCount = Ranges.Size;
+		Header.FontCount = Atlas->Fonts.Size;
+		Header.RectCount = Atlas->CustomRects.Size;
+		Header.RectId = Atlas->CustomRectIds[0];
+
+		/* Written next to the cache and moved over it, a session killed mid write can't leave a torn file behind */
+		const auto Path = CachePath();
+		const auto TempPath = Path + L".tmp";
+		{
+			std::ofstream File(TempPath, std::ios::binary | std::ios::trunc);
+			if (!File)
+				return;
+
+			File.write((const char*) &Header, sizeof Header);
+			File.write((const char*) Ranges.Data, Ranges.Size * sizeof(ImWchar));
+
+			for (const auto& Rect : Atlas->CustomRects)
+			{
+				FontCacheRect Cached{ Rect.ID, Rect.Width, Rect.Height, Rect.X, Rect.Y, Rect.GlyphAdvanceX, Rect.GlyphOffset, -1 };
+				for (auto i = 0; i < Atlas->Fonts.Size; i++)
+					if (Atlas->Fonts[i] == Rect.Font)
+						Cached.Font = i;
+				File.write((const char*) &Cached, sizeof Cached);
+			}
+
+			for (const auto Font : Atlas->Fonts)
+			{
+				const FontCacheFont Cached{ Font->FontSize, Font->Ascent, Font->Descent, Font->MetricsTotalSurface, Font->Glyphs.Size };
+				File.write((const char*) &Cached, sizeof Cached);
+				File.write((const char*) Font->Glyphs.Data, Font->Glyphs.Size * sizeof(ImFontGlyph));
+			}
+
+			File.write((const char*) Atlas->TexPixelsAlpha8, (size_t) Atlas->TexWidth * Atlas->TexHeight);
+			if (!File)
+				return;
+		}
+
+		if (!MoveFileExW(TempPath.c_str(), Path.c_str(), MOVEFILE_REPLACE_EXISTING))
+			DeleteFileW(TempPath.c_str());
+	}
+
+	void D3DFonts::Initialize(std::vector<ImFont*>& Fonts)
+	{
+		const auto Atlas = ImGui::GetIO().Fonts;
+		AddFonts(Atlas, Atlas->GetGlyphRangesDefault());
+
+		Fonts.assign(Atlas->Fonts.begin(), Atlas->Fonts.end());
+
+		/* Rasterizing every embedded font takes long enough to hitch the game, so it happens off the render
+		   thread. ImGui_ImplDX11_NewFrame uploads the atlas on the first frame after it's done */
+		std::thread([this, Atlas]
+		{
+			if (!synf::UseFontDiskCache || !LoadCache(Atlas, Ranges))
+			{
+				ImFontGlyphRangesBuilder Builder;
+				Builder.AddRanges(Atlas->GetGlyphRangesDefault());
+				Builder.BuildRanges(&Ranges);
+
+				ImGuiFreeType::BuildFontAtlas(Atlas, 0);
+
+				if (synf::UseFontDiskCache)
+					SaveCache(Atlas, Ranges);
+			}
+
+			/* A cached atlas may already hold codepoints earlier sessions asked for */
+			Wanted.AddRanges(Ranges.Data);
+
+			IsReady.store(true, std::memory_order_release);
+		}).detach();
+	}
+
+	bool D3DFonts::Update(std::vector<ImFont*>& Fonts)
+	{
+		if (!Ready())
+			return false;
+
+		if (HasNewAtlas())
+		{
+			auto& IO = ImGui::GetIO();
+
+			if (Retired)
+				IM_DELETE(Retired);
+
+			Retired = IO.Fonts;
+			RetiredRanges.swap(Ranges);
+
+			IO.Fonts = Rebuilt;
+			Ranges.swap(RebuiltRanges);
+			Rebuilt = NULL;
+
+			/* Same size, the game thread can keep indexing it while the pointers are rewritten */
+			for (size_t i = 0; i < Fonts.size() && i < (size_t) IO.Fonts->Fonts.Size; i++)
+				Fonts[i] = IO.Fonts->Fonts[(int) i];
+
+			ImGui_ImplDX11_UpdateFontsTexture();
+
+			State.store(FS_IDLE, std::memory_order_relaxed);
+			return true;
+		}
+
+		if (Dirty && State.load(std::memory_order_relaxed) == FS_IDLE)
+		{
+			Dirty = false;
+			State.store(FS_BUILDING, std::memory_order_relaxed);
+
+			std::thread([this, Snapshot = Wanted]() mutable
+			{
+				Snapshot.BuildRanges(&RebuiltRanges);
+
+				const auto Atlas = IM_NEW(ImFontAtlas)();
+				AddFonts(Atlas, RebuiltRanges.Data);
+				ImGuiFreeType::BuildFontAtlas(Atlas, 0);
+
+				if (synf::UseFontDiskCache)
+					SaveCache(Atlas, RebuiltRanges);
+
+				Rebuilt = Atlas;
+				State.store(FS_BUILT, std::memory_order_release);
+			}).detach();
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,84 @@
+/*
+*
+*	SYNAPSE X
+*	File.:	D3DFonts.hpp
+*	Desc.:	Overlay font atlas, grown on demand and cached on disk between sessions
+*
+*/
+
+#pragma once
+
+#include "Static.hpp"
+#include "../../Source Dependencies/ImGUI/imgui.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace syn
+{
+	/* Owns io.Fonts. The first atlas is loaded from the disk cache when it was built from the same fonts, otherwise it's
+	   rasterized with freetype on a worker thread. Codepoints D3DText draws that the atlas lacks are queued, a bigger atlas
+	   is built in the background and Update swaps it in between frames. Every font is rasterized once at 32px and scaled
+	   when drawn, so codepoints are the only thing that ever needs adding */
+	class D3DFonts
+	{
+	public:
+		/* Render thread, once ImGui is initialized. Adds the fonts to io.Fonts, fills Fonts and starts the first build */
+		void Initialize(std::vector<ImFont*>& Fonts);
+
+		/* Whether io.Fonts has glyphs yet, nothing is drawn before */
+		bool Ready() const { return IsReady.load(std::memory_order_acquire); }
+
+		/* Render thread. Queues Codepoint for the next rebuild, codepoints the fonts don't have are only ever queued once */
+		void Request(unsigned int Codepoint)
+		{
+			if (Codepoint > 0xFFFF || Wanted.GetBit((int) Codepoint))
+				return;
+
+			Wanted.SetBit((int) Codepoint);
+			Dirty = true;
+		}
+
+		/* Whether a rebuilt atlas is waiting for Update */
+		bool HasNewAtlas() const { return State.load(std::memory_order_acquire) == FS_BUILT; }
+
+		/* Render thread, before NewFrame. Swaps in a finished atlas, rewriting Fonts in place, and starts a rebuild when
+		   codepoints were requested. True when the fonts changed, anything holding their UVs has to be dropped */
+		bool Update(std::vector<ImFont*>& Fonts);
+
+	private:
+		enum States
+		{
+			FS_IDLE,
+			FS_BUILDING,
+			FS_BUILT
+		};
+
+		static void AddFonts(ImFontAtlas* Atlas, const ImWchar* Ranges);
+
+		static std::uint64_t CacheKey();
+
+		static std::wstring CachePath();
+
+		static bool LoadCache(ImFontAtlas* Atlas, ImVector<ImWchar>& Ranges);
+
+		static void SaveCache(const ImFontAtlas* Atlas, const ImVector<ImWchar>& Ranges);
+
+		ImFontGlyphRangesBuilder Wanted;	/* render thread only once Ready */
+		bool Dirty = false;
+
+		std::atomic<bool> IsReady{ false };
+		std::atomic<int> State{ FS_IDLE };
+
+		/* The ranges a font config was built from have to outlive its atlas */
+		ImVector<ImWchar> Ranges;
+		ImFontAtlas* Rebuilt = NULL;
+		ImVector<ImWchar> RebuiltRanges;
+
+		/* The previous atlas lives on until the next swap, the game thread may still be measuring text with it */
+		ImFontAtlas* Retired = NULL;
+		ImVector<ImWchar> RetiredRanges;
+	};
+}
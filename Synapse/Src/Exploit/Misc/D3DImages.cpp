@@ -0,0 +1,145 @@
+#include "./D3DImages.hpp"
+
+#include "../../Source Dependencies/ImGUI/imgui_impl_dx11.h"
+#include "../../Utilities/ThreadPool.hpp"
+
+#define XXH_STATIC_LINKING_ONLY
+#include "../../Utilities/Hashing/XXHash/xxhash.h"
+
+#include <wincodec.h>
+
+namespace syn
+{
+	D3DImageTexture::~D3DImageTexture()
+	{
+		if (View)
+			View->Release();
+	}
+
+	ImVec2 D3DImageTexture::Size() const
+	{
+		if (State.load(std::memory_order_acquire) != IS_DECODED)
+			return ImVec2(0, 0);
+
+		return ImVec2((float) Width, (float) Height);
+	}
+
+	ImTextureID D3DImageTexture::Texture()
+	{
+		if (View || State.load(std::memory_order_acquire) != IS_DECODED || Pixels.empty())
+			return (ImTextureID) View;
+
+		D3D11_TEXTURE2D_DESC Desc{};
+		Desc.Width = Width;
+		Desc.Height = Height;
+		Desc.MipLevels = 1;
+		Desc.ArraySize = 1;
+		Desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		Desc.SampleDesc.Count = 1;
+		Desc.Usage = D3D11_USAGE_IMMUTABLE;
+		Desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+		D3D11_SUBRESOURCE_DATA Initial{};
+		Initial.pSysMem = Pixels.data();
+		Initial.SysMemPitch = Width * 4;
+
+		ID3D11Texture2D* Texture = NULL;
+		if (SUCCEEDED(g_pd3dDevice->CreateTexture2D(&Desc, &Initial, &Texture)))
+		{
+			D3D11_SHADER_RESOURCE_VIEW_DESC ViewDesc{};
+			ViewDesc.Format = Desc.Format;
+			ViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+			ViewDesc.Texture2D.MipLevels = 1;
+
+			g_pd3dDevice->CreateShaderResourceView(Texture, &ViewDesc, &View);
+			Texture->Release();
+		}
+
+		/* Either way there is no second attempt, the pixels only live on in the texture */
+		std::vector<BYTE>().swap(Pixels);
+		if (!View)
+			State.store(IS_FAILED, std::memory_order_release);
+
+		return (ImTextureID) View;
+	}
+
+	std::shared_ptr<D3DImageTexture> D3DImages::Acquire(const char* Data, const size_t Size)
+	{
+		const auto Key = XXH3_64bits(Data, Size);
+
+		std::lock_guard<std::mutex> Guard(Mutex);
+
+		auto& Slot = Textures[Key];
+		if (auto Existing = Slot.lock())
+			return Existing;
+
+		auto Image = std::make_shared<D3DImageTexture>();
+		Slot = Image;
+
+		/* Images nothing holds anymore leave an expired slot behind, swept whenever the map doubles */
+		if (Textures.size() >= SweepAt)
+		{
+			for (auto It = Textures.begin(); It != Textures.end();)
+				It = It->second.expired() ? Textures.erase(It) : std::next(It);
+
+			SweepAt = (std::max)(Textures.size() * 2, (size_t) 64);
+		}
+
+		ThreadPool::GetSingleton()->Post([this, Weak = std::weak_ptr<D3DImageTexture>(Image), Bytes = std::string(Data, Size)]()
+		{
+			if (const auto Image = Weak.lock())
+				Decode(*Image, Bytes);
+		});
+
+		return Image;
+	}
+
+	void D3DImages::Decode(D3DImageTexture& Image, const std::string& Data)
+	{
+		const auto Com = CoInitializeEx(NULL, COINIT_MULTITHREADED);
+
+		IWICImagingFactory* Factory = NULL;
+		IWICStream* Stream = NULL;
+		IWICBitmapDecoder* Decoder = NULL;
+		IWICBitmapFrameDecode* Frame = NULL;
+		IWICFormatConverter* Converter = NULL;
+
+		UINT Width = 0, Height = 0;
+		auto Ok = SUCCEEDED(CoCreateInstance(CLSID_WICImagingFactory, NULL, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&Factory)))
+			&& SUCCEEDED(Factory->CreateStream(&Stream))
+			&& SUCCEEDED(Stream->InitializeFromMemory((BYTE*) Data.data(), (DWORD) Data.size()))
+			&& SUCCEEDED(Factory->CreateDecoderFromStream(Stream, NULL, WICDecodeMetadataCacheOnDemand, &Decoder))
+			&& SUCCEEDED(Decoder->GetFrame(0, &Frame))
+			&& SUCCEEDED(Frame->GetSize(&Width, &Height))
+			&& Width && Height && Width <= MaxDimension && Height <= MaxDimension
+			&& SUCCEEDED(Factory->CreateFormatConverter(&Converter))
+			&& SUCCEEDED(Converter->Initialize(Frame, GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, NULL, 0.0, WICBitmapPaletteTypeCustom));
+
+		if (Ok)
+		{
+			Image.Pixels.resize((size_t) Width * Height * 4);
+			Ok = SUCCEEDED(Converter->CopyPixels(NULL, Width * 4, (UINT) Image.Pixels.size(), Image.Pixels.data()));
+		}
+
+		if (Converter) Converter->Release();
+		if (Frame) Frame->Release();
+		if (Decoder) Decoder->Release();
+		if (Stream) Stream->Release();
+		if (Factory) Factory->Release();
+
+		if (SUCCEEDED(Com))
+			CoUninitialize();
+
+		if (!Ok)
+		{
+			std::vector<BYTE>().swap(Image.Pixels);
+			Image.State.store(D3DImageTexture::IS_FAILED, std::memory_order_release);
+			return;
+		}
+
+		Image.Width = Width;
+		Image.Height = Height;
+		Image.State.store(D3DImageTexture::IS_DECODED, std::memory_order_release);
+		Decoded.store(true, std::memory_order_release);
+	}
+}
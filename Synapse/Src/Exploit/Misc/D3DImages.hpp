@@ -0,0 +1,84 @@
+
+/*
+*
+*	SYNAPSE X
+*	File.:	D3DImages.hpp
+*	Desc.:	Drawing image textures, decoded off-thread and shared by content hash
+*
+*/
+
+#pragma once
+
+#include "Static.hpp"
+#include "../../Source Dependencies/ImGUI/imgui.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#pragma warning(disable: 26495 4005)
+#include <D3D11.h>
+#pragma warning(default: 26495 4005)
+
+namespace syn
+{
+	/* One decoded image. Held by every D3DImage showing it, so the scenes Present draws from keep it alive on their own */
+	class D3DImageTexture
+	{
+		friend class D3DImages;
+
+		enum States
+		{
+			IS_DECODING,
+			IS_DECODED,
+			IS_FAILED
+		};
+
+		std::atomic<int> State{ IS_DECODING };
+		UINT Width = 0;
+		UINT Height = 0;
+		std::vector<BYTE> Pixels;					/* RGBA, dropped once uploaded */
+		ID3D11ShaderResourceView* View = NULL;		/* render thread */
+
+	public:
+		D3DImageTexture() = default;
+		D3DImageTexture(const D3DImageTexture&) = delete;
+		D3DImageTexture& operator=(const D3DImageTexture&) = delete;
+		~D3DImageTexture();
+
+		/* Any thread, (0, 0) until decoding finished */
+		ImVec2 Size() const;
+
+		/* Render thread, uploads the pixels the first time. Null while decoding or if the data wasn't an image */
+		ImTextureID Texture();
+	};
+
+	/* Image data goes through WIC on the thread pool, identical data maps to the same texture for as long as something uses it */
+	class D3DImages
+	{
+	public:
+		/* Decoded images past this in either dimension are refused */
+		static constexpr UINT MaxDimension = 4096;
+
+		/* Game thread */
+		std::shared_ptr<D3DImageTexture> Acquire(const char* Data, size_t Size);
+
+		/* Whether an image finished decoding since the last TakeDecoded, a reused frame wouldn't show it */
+		bool HasDecoded() const { return Decoded.load(std::memory_order_acquire); }
+
+		/* Render thread, before drawing the scene */
+		void TakeDecoded() { Decoded.store(false, std::memory_order_relaxed); }
+
+	private:
+		void Decode(D3DImageTexture& Image, const std::string& Data);
+
+		std::atomic<bool> Decoded{ false };
+
+		std::mutex Mutex;
+		std::unordered_map<std::uint64_t, std::weak_ptr<D3DImageTexture>> Textures;
+		size_t SweepAt = 64;
+	};
+}
@@ -0,0 +1,282 @@
+#include "./D3DInstancer.hpp"
+
+#include "../../Source Dependencies/ImGUI/imgui_impl_dx11.h"
+
+#include <algorithm>
+#include <cmath>
+#include <D3Dcompiler.h>
+
+namespace syn
+{
+	static const char* InstancerShaders = R"(
+cbuffer Globals : register(b0)
+{
+	float4 Scale;
+};
+
+struct VS_INPUT
+{
+	uint Vertex : SV_VertexID;
+	float2 Center : CENTER;
+	float2 Half : HALF;
+	float2 Axis : AXIS;
+	float4 Params : PARAMS;
+	float4 Color : COLOR;
+};
+
+struct PS_INPUT
+{
+	float4 Pos : SV_POSITION;
+	float2 Local : LOCAL;
+	nointerpolation float2 Half : HALF;
+	nointerpolation float4 Params : PARAMS;
+	nointerpolation float4 Color : COLOR;
+};
+
+PS_INPUT vs_main(VS_INPUT input)
+{
+	PS_INPUT output;
+
+	float2 corner = float2((input.Vertex & 1) ? 1.0 : -1.0, (input.Vertex & 2) ? 1.0 : -1.0);
+	float2 local = corner * (input.Half + input.Params.x * 0.5 + 1.0);
+	float2 world = input.Center + local.x * input.Axis + local.y * float2(-input.Axis.y, input.Axis.x);
+
+	output.Pos = float4(world.x * Scale.x - 1.0, 1.0 - world.y * Scale.y, 0.0, 1.0);
+	output.Local = local;
+	output.Half = input.Half;
+	output.Params = input.Params;
+	output.Color = input.Color;
+	return output;
+}
+
+float sd_box(float2 p, float2 h)
+{
+	float2 d = abs(p) - h;
+	return length(max(d, 0.0)) + min(max(d.x, d.y), 0.0);
+}
+
+float4 ps_main(PS_INPUT input) : SV_Target
+{
+	float2 p = input.Local;
+	float thickness = input.Params.x;
+	float sides = input.Params.y;
+	float kind = input.Params.z;
+
+	float sd;
+	if (kind < 1.5)
+	{
+		sd = sd_box(p, input.Half);
+	}
+	else if (sides >= 3.0)
+	{
+		float an = 3.14159265 / sides;
+		float a = atan2(p.y, p.x) - an;
+		float bn = a - 2.0 * an * round(a / (2.0 * an));
+		sd = length(p) * cos(bn) - input.Half.x * cos(an);
+	}
+	else
+	{
+		sd = length(p) - input.Half.x;
+	}
+
+	if (thickness > 0.0)
+		sd = abs(sd) - thickness * 0.5;
+
+	return float4(input.Color.rgb, input.Color.a * saturate(0.5 - sd));
+}
+)";
+
+	bool D3DInstancer::CreateDeviceObjects()
+	{
+		ID3DBlob* VertexBlob = NULL;
+		ID3DBlob* PixelBlob = NULL;
+		const auto Length = strlen(InstancerShaders);
+
+		if (FAILED(D3DCompile(InstancerShaders, Length, NULL, NULL, NULL, "vs_main", "vs_4_0", 0, 0, &VertexBlob, NULL)))
+			return false;
+
+		if (FAILED(D3DCompile(InstancerShaders, Length, NULL, NULL, NULL, "ps_main", "ps_4_0", 0, 0, &PixelBlob, NULL)))
+		{
+			VertexBlob->Release();
+			return false;
+		}
+
+		const D3D11_INPUT_ELEMENT_DESC Layout[] =
+		{
+			{ "CENTER", 0, DXGI_FORMAT_R32G32_FLOAT, 0, (UINT) offsetof(D3DInstance, Center), D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "HALF", 0, DXGI_FORMAT_R32G32_FLOAT, 0, (UINT) offsetof(D3DInstance, Half), D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "AXIS", 0, DXGI_FORMAT_R32G32_FLOAT, 0, (UINT) offsetof(D3DInstance, Axis), D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "PARAMS", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, (UINT) offsetof(D3DInstance, Thickness), D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, (UINT) offsetof(D3DInstance, Color), D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		};
+
+		auto Ok = SUCCEEDED(g_pd3dDevice->CreateVertexShader(VertexBlob->GetBufferPointer(), VertexBlob->GetBufferSize(), NULL, &VertexShader))
+			&& SUCCEEDED(g_pd3dDevice->CreatePixelShader(PixelBlob->GetBufferPointer(), PixelBlob->GetBufferSize(), NULL, &PixelShader))
+			&& SUCCEEDED(g_pd3dDevice->CreateInputLayout(Layout, ARRAYSIZE(Layout), VertexBlob->GetBufferPointer(), VertexBlob->GetBufferSize(), &InputLayout));
+
+		VertexBlob->Release();
+		PixelBlob->Release();
+
+		if (!Ok)
+			return false;
+
+		D3D11_BUFFER_DESC Desc{};
+		Desc.ByteWidth = 16;
+		Desc.Usage = D3D11_USAGE_DYNAMIC;
+		Desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+		Desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+		if (FAILED(g_pd3dDevice->CreateBuffer(&Desc, NULL, &ConstantBuffer)))
+			return false;
+
+		/* ImGui's state scissors to the last command's clip rect, Drawing is always full screen */
+		D3D11_RASTERIZER_DESC Raster{};
+		Raster.FillMode = D3D11_FILL_SOLID;
+		Raster.CullMode = D3D11_CULL_NONE;
+		Raster.DepthClipEnable = TRUE;
+		return SUCCEEDED(g_pd3dDevice->CreateRasterizerState(&Raster, &RasterizerState));
+	}
+
+	bool D3DInstancer::Ready()
+	{
+		if (!Initialized && !Failed && g_pd3dDevice)
+		{
+			Initialized = CreateDeviceObjects();
+			Failed = !Initialized;
+		}
+
+		return Initialized;
+	}
+
+	void D3DInstancer::AddLine(const ImVec2& From, const ImVec2& To, const ImU32 Color, const float Thickness)
+	{
+		/* Same half pixel offset ImDrawList::AddLine uses */
+		const auto DX = To.x - From.x;
+		const auto DY = To.y - From.y;
+		const auto Length = std::sqrt(DX * DX + DY * DY);
+		const auto Axis = Length > 0 ? ImVec2(DX / Length, DY / Length) : ImVec2(1, 0);
+
+		Instances.push_back({
+			ImVec2((From.x + To.x) * 0.5f + 0.5f, (From.y + To.y) * 0.5f + 0.5f),
+			ImVec2(Length * 0.5f, (std::max)(Thickness, 1.0f) * 0.5f),
+			Axis, 0, 0, (float) IK_LINE, 0, Color });
+	}
+
+	void D3DInstancer::AddRect(const ImVec2& Pos, const ImVec2& Size, const ImU32 Color, const float Thickness, const bool Filled)
+	{
+		/* Outlines run through the middle of the edge pixels like ImDrawList::AddRect */
+		const auto Inset = Filled ? 0.0f : 0.5f;
+
+		Instances.push_back({
+			ImVec2(Pos.x + Size.x * 0.5f, Pos.y + Size.y * 0.5f),
+			ImVec2((std::max)(std::fabs(Size.x) * 0.5f - Inset, 0.0f), (std::max)(std::fabs(Size.y) * 0.5f - Inset, 0.0f)),
+			ImVec2(1, 0), Filled ? 0 : (std::max)(Thickness, 1.0f), 0, (float) IK_RECT, 0, Color });
+	}
+
+	void D3DInstancer::AddCircle(const ImVec2& Pos, const float Radius, const ImU32 Color, const float Thickness, const bool Filled, const DWORD Sides)
+	{
+		const auto R = Filled ? Radius : Radius - 0.5f;
+
+		/* Past half a pixel of deviation from the true circle the polygon is indistinguishable from it */
+		const auto Polygon = Sides >= 3 && R * (1.0f - std::cos(3.14159265f / Sides)) > 0.5f;
+
+		Instances.push_back({
+			Pos,
+			ImVec2(R, R),
+			ImVec2(1, 0), Filled ? 0 : (std::max)(Thickness, 1.0f), Polygon ? (float) Sides : 0, (float) IK_CIRCLE, 0, Color });
+	}
+
+	void D3DInstancer::Clear()
+	{
+		Instances.clear();
+		Batches.clear();
+		Submitted = 0;
+	}
+
+	void D3DInstancer::Submit(ImDrawList* List)
+	{
+		const auto Count = (UINT) Instances.size();
+		if (Count == Submitted)
+			return;
+
+		Batches.push_back({ this, Submitted, Count - Submitted });
+		Submitted = Count;
+
+		List->AddCallback(Render, &Batches.back());
+		List->AddCallback(ImDrawCallback_ResetRenderState, NULL);
+	}
+
+	bool D3DInstancer::Upload(ID3D11DeviceContext* Context)
+	{
+		const auto Count = (UINT) Instances.size();
+
+		if (Count > InstanceCapacity)
+		{
+			if (InstanceBuffer)
+			{
+				InstanceBuffer->Release();
+				InstanceBuffer = NULL;
+			}
+
+			auto Capacity = (std::max)(InstanceCapacity, 1024u);
+			while (Capacity < Count)
+				Capacity *= 2;
+
+			D3D11_BUFFER_DESC Desc{};
+			Desc.ByteWidth = Capacity * sizeof(D3DInstance);
+			Desc.Usage = D3D11_USAGE_DYNAMIC;
+			Desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+			Desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+			InstanceCapacity = SUCCEEDED(g_pd3dDevice->CreateBuffer(&Desc, NULL, &InstanceBuffer)) ? Capacity : 0;
+		}
+
+		D3D11_MAPPED_SUBRESOURCE Mapped;
+		if (!InstanceCapacity || FAILED(Context->Map(InstanceBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &Mapped)))
+			return false;
+
+		memcpy(Mapped.pData, Instances.data(), Count * sizeof(D3DInstance));
+		Context->Unmap(InstanceBuffer, 0);
+
+		if (SUCCEEDED(Context->Map(ConstantBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &Mapped)))
+		{
+			const auto& Display = ImGui::GetIO().DisplaySize;
+			const float Scale[4] = { 2.0f / Display.x, 2.0f / Display.y, 0, 0 };
+			memcpy(Mapped.pData, Scale, sizeof Scale);
+			Context->Unmap(ConstantBuffer, 0);
+		}
+
+		return true;
+	}
+
+	void D3DInstancer::Render(const ImDrawList* List, const ImDrawCmd* Cmd)
+	{
+		const auto Batch = (const InstanceBatch*) Cmd->UserCallbackData;
+		const auto Self = Batch->Owner;
+
+		ID3D11DeviceContext* Context = NULL;
+		g_pd3dDevice->GetImmediateContext(&Context);
+
+		/* The frame's first batch uploads every layer's instances, the others draw their range of the same buffer */
+		if (Batch->Begin == 0)
+			Self->Uploaded = Self->Upload(Context);
+
+		if (!Self->Uploaded)
+		{
+			Context->Release();
+			return;
+		}
+
+		const UINT Stride = sizeof(D3DInstance);
+		const UINT Offset = 0;
+		Context->IASetInputLayout(Self->InputLayout);
+		Context->IASetVertexBuffers(0, 1, &Self->InstanceBuffer, &Stride, &Offset);
+		Context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+		Context->VSSetShader(Self->VertexShader, NULL, 0);
+		Context->VSSetConstantBuffers(0, 1, &Self->ConstantBuffer);
+		Context->PSSetShader(Self->PixelShader, NULL, 0);
+		Context->RSSetState(Self->RasterizerState);
+
+		Context->DrawInstanced(4, Batch->Count, 0, Batch->Begin);
+		Context->Release();
+	}
+}
@@ -0,0 +1,91 @@
+
+/*
+*
+*	SYNAPSE X
+*	File.:	D3DInstancer.hpp
+*	Desc.:	Instanced SDF renderer for Drawing lines, squares and circles
+*
+*/
+
+#pragma once
+
+#include "Static.hpp"
+#include "../../Source Dependencies/ImGUI/imgui.h"
+
+#include <deque>
+#include <vector>
+#pragma warning(disable: 26495 4005)
+#include <D3D11.h>
+#pragma warning(default: 26495 4005)
+
+namespace syn
+{
+	/* Matches the instance input layout, shapes are described in a local space centered on the shape */
+	struct D3DInstance
+	{
+		ImVec2 Center;
+		ImVec2 Half;		/* half extents, lines are (length / 2, thickness / 2) */
+		ImVec2 Axis;		/* local x axis in screen space */
+		float Thickness;	/* outline width, 0 when filled */
+		float Sides;		/* polygon sides for circles, 0 for a smooth circle */
+		float Kind;
+		float Unused;
+		ImU32 Color;
+	};
+
+	/* Draws every queued shape with one DrawInstanced call from inside the ImGui draw data, tessellating nothing on the CPU.
+	   Device objects are created on the render thread the first time it's used, Ready turns false for good if that fails */
+	class D3DInstancer
+	{
+		enum Kinds
+		{
+			IK_LINE,
+			IK_RECT,
+			IK_CIRCLE
+		};
+
+		std::vector<D3DInstance> Instances;
+
+		/* One per Submit, a deque so the callbacks' pointers into it stay put */
+		struct InstanceBatch
+		{
+			D3DInstancer* Owner;
+			UINT Begin;
+			UINT Count;
+		};
+
+		std::deque<InstanceBatch> Batches;
+		UINT Submitted = 0;
+		bool Uploaded = false;
+
+		ID3D11VertexShader* VertexShader = NULL;
+		ID3D11PixelShader* PixelShader = NULL;
+		ID3D11InputLayout* InputLayout = NULL;
+		ID3D11Buffer* ConstantBuffer = NULL;
+		ID3D11Buffer* InstanceBuffer = NULL;
+		ID3D11RasterizerState* RasterizerState = NULL;
+		UINT InstanceCapacity = 0;
+		bool Initialized = false;
+		bool Failed = false;
+
+		bool CreateDeviceObjects();
+
+		bool Upload(ID3D11DeviceContext* Context);
+
+		static void Render(const ImDrawList* List, const ImDrawCmd* Cmd);
+
+	public:
+		bool Ready();
+
+		void Clear();
+
+		void AddLine(const ImVec2& From, const ImVec2& To, ImU32 Color, float Thickness);
+
+		void AddRect(const ImVec2& Pos, const ImVec2& Size, ImU32 Color, float Thickness, bool Filled);
+
+		void AddCircle(const ImVec2& Pos, float Radius, ImU32 Color, float Thickness, bool Filled, DWORD Sides);
+
+		/* Queues the shapes added since the last Submit on List at its current position, ImGui's own state is restored right after */
+		void Submit(ImDrawList* List);
+	};
+}
@@ -28,12 +28,17 @@
 #include "../Execution/RbxInstance.hpp"
 #include "../Execution/Conversion/RbxConversion.hpp"
 
+#include "../../Utilities/Compression.hpp"
 #include "../../Utilities/Console.hpp"
+#include "../../Utilities/HttpCache.hpp"
 #include "../../Utilities/FakeMemoryHasher.hpp"
 
 #include "../../Utilities/Hashing/sha512.h"
 
 #include "./Profiler.hpp"
+#include "./Channel.hpp"
+#include "./Metrics.hpp"
+
 #include "../Security/AntiDebug.hpp"
 #include "../Security/AntiProxy.hpp"
 
@@ -183,12 +188,100 @@ LONG WINAPI SynapseExceptionFilter(PEXCEPTION_POINTERS ExceptionInfo)
     return EXCEPTION_CONTINUE_SEARCH;
 }
 
-/* TODO: rewrite */
+/* SYN_FILE_PATH|<path>|<unlock fps>|<websocket>|<internal ui>|<chat>[|DEFLATE], accepted once from either pipe */
+static std::atomic<bool> IpcInitialized{ false };
+
+static void IpcInitialize(const std::string& Settings)
+{
+	if (IpcInitialized.exchange(true))
+		return;
+
+	syn::Profiler *prof = syn::Profiler::GetSingleton();
+	prof->AddProfile(OBFUSCATE_STR("Syn Pipe Init"));
+
+	std::vector<std::string> SplitContents;
+	SplitString(Settings, "|", SplitContents);
+
+	/* Initialize static (for window) */
+	syn::Static::InitializeWindow();
+
+	if (SplitContents.at(2) == "TRUE" || SplitContents.at(4) == "TRUE")
+		syn::D3D::Initialize(SplitContents.at(2) == "TRUE");
+
+	if (SplitContents.at(3) == "TRUE")
+	{
+		syn::WSocketEnabled = 2;
+	}
+	else
+	{
+		syn::WSocketEnabled = 1;
+	}
+
+	if (SplitContents.at(4) == "TRUE")
+	{
+		IGuiEnabled = TRUE;
+	}
+
+	if (SplitContents.at(5) == "TRUE")
+	{
+		syn::IngameChatEnabled = 2;
+	}
+	else
+	{
+		syn::IngameChatEnabled = 1;
+	}
+
+	/* The UI offers compression, it only sends CM_EXECUTE_DEFLATE frames after seeing this answer */
+	if (SplitContents.size() > 6 && SplitContents.at(6) == "DEFLATE")
+		syn::Channel::GetSingleton()->Send(syn::CM_STATUS, OBFUSCATE_STR("SYN_COMPRESSION|DEFLATE"));
+
+	prof->AddProfile(OBFUSCATE_STR("Syn Pipe Init complete"));
+}
+
+static void IpcExecute(std::string&& Script)
+{
+	syn::Profiler::GetSingleton()->AddProfile(OBFUSCATE_STR("Syn Pipe received script"));
+
+	VM_TIGER_WHITE_START
+
+	if (!SecureLuaFlag)
+	{
+		ScriptRunCounter++;
+
+		const auto Mode = syn::LuaTranslator::IsPrecompiled(Script) ? syn::SM_BYTECODE : syn::SM_SOURCE;
+		syn::Scheduler::GetSingleton()->Push(std::move(Script), Mode);
+	}
+
+	VM_TIGER_WHITE_END
+}
+
+/* Inflates into a buffer sized from the frame header, which then goes to the scheduler as is */
+static void IpcExecuteDeflate(const std::string& Payload)
+{
+	std::uint32_t Size;
+	if (Payload.size() < sizeof(Size))
+		return;
+
+	memcpy(&Size, Payload.data(), sizeof(Size));
+	if (Size > syn::Channel::MaxFrameSize)
+		return;
+
+	std::string Script(Size, '\0');
+
+	if (!syn::Compression::Inflate(Payload.data() + sizeof(Size), Payload.size() - sizeof(Size), &Script[0], Script.size()))
+	{
+		syn::Profiler::GetSingleton()->AddProfile(OBFUSCATE_STR("Syn Pipe bad compressed script"));
+		return;
+	}
+
+	IpcExecute(std::move(Script));
+}
+
+/* Legacy connect-per-script pipe, kept for UIs that don't speak the framed channel yet */
 DWORD WINAPI SynapseScriptIPC([[maybe_unused]] LPVOID Param)
 {
 	syn::Profiler *prof = syn::Profiler::GetSingleton();
 	prof->AddProfile(OBFUSCATE_STR("Script IPC Start"));
-	auto FirstScript = TRUE;
 
 	std::string PipeName = sha512(OBFUSCATE_STR("SynapseScript") + std::to_string(syn::ProcID)).substr(0, 16);
 
@@ -196,78 +289,37 @@ DWORD WINAPI SynapseScriptIPC([[maybe_unused]] LPVOID Param)
 		PIPE_ACCESS_DUPLEX | PIPE_TYPE_BYTE | PIPE_READMODE_BYTE,
 		PIPE_WAIT,
 		1,
-		1024,
-		1024,
+		syn::Channel::PipeBufferSize,
+		syn::Channel::PipeBufferSize,
 		NMPWAIT_USE_DEFAULT_WAIT,
 		NULL);
 
-	auto Scheduler = syn::Scheduler::GetSingleton();
-
 	while (Pipe != INVALID_HANDLE_VALUE)
 	{
 		if (ConnectNamedPipe(Pipe, NULL) != FALSE)
 		{
+			/* No size up front on this pipe, so reads go straight into the script's spare capacity instead of through a bounce buffer */
 			std::string Script;
+			size_t Size = 0;
 
-			char buffer[1024] = {};
 			DWORD Read;
-			while (ReadFile(Pipe, buffer, 1024, &Read, NULL) != FALSE)
-				Script.append(buffer, Read);
-
-			if (FirstScript && Script.find("SYN_FILE_PATH|") == 0)
+			while (true)
 			{
-				prof->AddProfile(OBFUSCATE_STR("Syn Pipe Init"));
-
-				FirstScript = FALSE;
-				std::vector<std::string> SplitContents;
-				SplitString(Script, "|", SplitContents);
-
-				/* Initialize static (for window) */
-				syn::Static::InitializeWindow();
-
-				if (SplitContents.at(2) == "TRUE" || SplitContents.at(4) == "TRUE")
-					syn::D3D::Initialize(SplitContents.at(2) == "TRUE");
-
-				if (SplitContents.at(3) == "TRUE")
-				{
-					syn::WSocketEnabled = 2;
-				}
-				else
-				{
-					syn::WSocketEnabled = 1;
-				}
-
-				if (SplitContents.at(4) == "TRUE")
-				{
-					IGuiEnabled = TRUE;
-				}
-
-				if (SplitContents.at(5) == "TRUE")
-				{
-					syn::IngameChatEnabled = 2;
-				}
-				else
-				{
-					syn::IngameChatEnabled = 1;
-				}
-
-				prof->AddProfile(OBFUSCATE_STR("Syn Pipe Init complete"));
-			}
-			else
-			{
-				prof->AddProfile(OBFUSCATE_STR("Syn Pipe received script"));
+				if (Script.size() - Size < syn::Channel::PipeBufferSize)
+					Script.resize((std::max)(Script.size() * 2, Size + syn::Channel::PipeBufferSize));
 
-				VM_TIGER_WHITE_START
+				if (ReadFile(Pipe, &Script[Size], (DWORD) (std::min)(Script.size() - Size, (size_t) MAXDWORD), &Read, NULL) == FALSE)
+					break;
 
-				if (!SecureLuaFlag)
-				{
-					ScriptRunCounter++;
+				Size += Read;
+			}
 
-					Scheduler->Push(Script);
-				}
+			Script.resize(Size);
 
-				VM_TIGER_WHITE_END
-			}
+			if (!IpcInitialized && Script.find("SYN_FILE_PATH|") == 0)
+				IpcInitialize(Script);
+			else
+				IpcExecute(std::move(Script));
 		}
 
 		DisconnectNamedPipe(Pipe);
@@ -276,8 +328,43 @@ DWORD WINAPI SynapseScriptIPC([[maybe_unused]] LPVOID Param)
 	return 0;
 }
 
+/* One long lived framed pipe, no connection setup per script and no flush per message */
+static void SynapseChannelIPC()
+{
+	const auto ChannelName = sha512(OBFUSCATE_STR("SynapseChannel") + std::to_string(syn::ProcID)).substr(0, 16);
+
+	syn::Channel::GetSingleton()->Start(ChannelName, [](const syn::ChannelMessage Type, std::string&& Payload)
+	{
+		switch (Type)
+		{
+		case syn::CM_INIT:
+			IpcInitialize(Payload);
+			break;
+
+		case syn::CM_EXECUTE:
+			IpcExecute(std::move(Payload));
+			break;
+
+		case syn::CM_EXECUTE_DEFLATE:
+			IpcExecuteDeflate(Payload);
+			break;
+
+		case syn::CM_EDITOR:
+			syn::D3D::GetSingleton()->SetEditorText(std::move(Payload));
+			break;
+
+		default:
+			break;
+		}
+	});
+
+	syn::Metrics::GetSingleton()->Start();
+}
+
 void WritePipe(HANDLE Pipe, const std::string& Data)
 {
+	syn::Channel::GetSingleton()->Send(syn::CM_STATUS, Data);
+
 	DWORD DwWritten;
 	WriteFile(Pipe, (Data + "\n").c_str(), Data.size() + 1, &DwWritten, NULL);
 	FlushFileBuffers(Pipe);
@@ -403,6 +490,7 @@ DWORD WINAPI SynapseMain(LPVOID Param)
 
 	prof->AddProfile(OBFUSCATE_STR("IPC start"));
 	CreateThread(NULL, NULL, SynapseScriptIPC, NULL, NULL, NULL);
+	SynapseChannelIPC();
 
     VM_TIGER_LONDON_END;
 
@@ -468,6 +556,9 @@ BOOL APIENTRY DllMain(HMODULE mod, DWORD reason, LPVOID)
 		syn::Module = mod;
 		syn::Static::Initialize();
 
+		/* Before the first AddProfile, so a session started ahead of time sees the whole attach */
+		syn::EventTrace::Register();
+
 		syn::Profiler* prof = syn::Profiler::GetSingleton();
 		prof->AddProfile(OBFUSCATE_STR("Set exception filter"));
 
@@ -496,6 +587,7 @@ BOOL APIENTRY DllMain(HMODULE mod, DWORD reason, LPVOID)
 		const auto WS = std::filesystem::path(std::wstring(Path)).parent_path().parent_path().wstring() + L"\\workspace";
 
 		syn::WorkspaceDirectory = WS;
+		syn::HttpCache::GetSingleton()->SetFolder(WS + L"\\.httpcache");
 
 		prof->AddProfile(OBFUSCATE_STR("AntiTamper Setup"));
 
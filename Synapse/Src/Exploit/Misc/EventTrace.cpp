@@ -0,0 +1,43 @@
+#include "./EventTrace.hpp"
+
+#include <winmeta.h>
+
+/* {8cdc77c2-290e-42bb-bf36-a1da98e304e4} */
+TRACELOGGING_DEFINE_PROVIDER(SynTraceProvider, "Synapse.Runtime",
+	(0x8cdc77c2, 0x290e, 0x42bb, 0xbf, 0x36, 0xa1, 0xda, 0x98, 0xe3, 0x04, 0xe4));
+
+namespace syn
+{
+	void EventTrace::Register()
+	{
+		TraceLoggingRegister(SynTraceProvider);
+	}
+
+	void EventTrace::Unregister()
+	{
+		TraceLoggingUnregister(SynTraceProvider);
+	}
+
+	void EventTrace::Begin(const char* Zone)
+	{
+		TraceLoggingWrite(SynTraceProvider, "Zone",
+			TraceLoggingOpcode(WINEVENT_OPCODE_START),
+			TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+			TraceLoggingString(Zone, "Name"));
+	}
+
+	void EventTrace::End(const char* Zone)
+	{
+		TraceLoggingWrite(SynTraceProvider, "Zone",
+			TraceLoggingOpcode(WINEVENT_OPCODE_STOP),
+			TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+			TraceLoggingString(Zone, "Name"));
+	}
+
+	void EventTrace::Message(const char* Text)
+	{
+		TraceLoggingWrite(SynTraceProvider, "Message",
+			TraceLoggingLevel(WINEVENT_LEVEL_INFO),
+			TraceLoggingString(Text, "Text"));
+	}
+}
@@ -0,0 +1,40 @@
+
+/*
+*
+*	SYNAPSE X
+*	File.:	EventTrace.hpp
+*	Desc.:	TraceLogging provider mirroring profiler zones and lifecycle messages onto ETW
+*
+*/
+
+#pragma once
+
+#include "Static.hpp"
+
+#include <TraceLoggingProvider.h>
+
+TRACELOGGING_DECLARE_PROVIDER(SynTraceProvider);
+
+namespace syn
+{
+	/* Lets WPA, PerfView or xperf line our zones up against the rest of the system. Enabled is an inline test of
+	   the provider's session mask, nothing is formatted or sent while no session listens */
+	class EventTrace
+	{
+	public:
+		static void Register();
+		static void Unregister();
+
+		static bool Enabled()
+		{
+			return TraceLoggingProviderEnabled(SynTraceProvider, 0, 0);
+		}
+
+		/* Start/stop pair around a zone, matched up on name and thread */
+		static void Begin(const char* Zone);
+		static void End(const char* Zone);
+
+		/* Lifecycle markers, fed by Profiler::AddProfile */
+		static void Message(const char* Text);
+	};
+}
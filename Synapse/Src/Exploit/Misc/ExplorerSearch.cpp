@@ -0,0 +1,149 @@
+#include "./ExplorerSearch.hpp"
+#include "../Execution/RbxInstance.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace syn
+{
+	static void AppendLower(std::string& Out, const char* Text, const size_t Size)
+	{
+		for (size_t i = 0; i < Size; i++)
+			Out.push_back((char) std::tolower((unsigned char) Text[i]));
+	}
+
+	void ExplorerSearch::Index::Clear()
+	{
+		Entries.clear();
+		Names.clear();
+		LowerNames.clear();
+		Positions.clear();
+	}
+
+	WORD ExplorerSearch::ClassOf(const DWORD Inst)
+	{
+		const Instance I(Inst);
+		const auto Descriptor = I.GetClassDescriptor();
+
+		const auto Found = ClassIds.find(Descriptor);
+		if (Found != ClassIds.end())
+			return Found->second;
+
+		/* Only ever a few hundred classes, the last id soaks up anything past the limit */
+		if (Classes.size() == 0xFFFF)
+			return 0xFFFE;
+
+		const auto Id = (WORD) Classes.size();
+		Classes.push_back(I.GetInstanceClassName());
+		LowerClasses.emplace_back();
+		AppendLower(LowerClasses.back(), Classes.back().data(), Classes.back().size());
+
+		ClassIds.emplace(Descriptor, Id);
+		return Id;
+	}
+
+	void ExplorerSearch::Step(const DWORD DataModel, size_t Budget)
+	{
+		if (DataModel != Root)
+		{
+			Live.Clear();
+			Next.Clear();
+			Stack.clear();
+			Matched.clear();
+			Root = DataModel;
+			Generation = 0;
+			LastGeneration = 0;
+			LastQuery.clear();
+		}
+
+		if (!Root)
+			return;
+
+		if (Stack.empty())
+			for (const auto Child : Instance(Root).Children())
+				Stack.emplace_back(Child, Root);
+
+		while (Budget-- && !Stack.empty())
+		{
+			const auto [Inst, Parent] = Stack.back();
+			Stack.pop_back();
+
+			/* Moved or destroyed since it was queued, wherever it went gets picked up by the next walk */
+			const Instance I(Inst);
+			if (I.GetParent() != Parent)
+				continue;
+
+			const auto& Name = I.NameView();
+
+			Entry E;
+			E.Inst = Inst;
+			E.Parent = Parent;
+			E.NameBegin = (DWORD) Next.Names.size();
+			E.NameSize = (WORD) (std::min)(Name.size(), (size_t) 0xFFFF);
+			E.Class = ClassOf(Inst);
+
+			Next.Names.append(Name.data(), E.NameSize);
+			AppendLower(Next.LowerNames, Name.data(), E.NameSize);
+			Next.Positions.emplace(Inst, (DWORD) Next.Entries.size());
+			Next.Entries.push_back(E);
+
+			/* Reversed so the walk pops children in tree order */
+			const auto Children = I.Children();
+			for (auto i = Children.size(); i-- > 0;)
+				Stack.emplace_back(Children[i], Inst);
+		}
+
+		if (!Stack.empty())
+			return;
+
+		std::swap(Live, Next);
+		Next.Clear();
+		Generation++;
+	}
+
+	void ExplorerSearch::Query(const std::string& Text)
+	{
+		std::string Lower;
+		AppendLower(Lower, Text.data(), Text.size());
+
+		if (Lower == LastQuery && Generation == LastGeneration)
+			return;
+
+		LastQuery = Lower;
+		LastGeneration = Generation;
+		Matched.clear();
+
+		if (Lower.empty())
+			return;
+
+		std::vector<BYTE> ClassMatches(LowerClasses.size());
+		for (size_t i = 0; i < LowerClasses.size(); i++)
+			ClassMatches[i] = LowerClasses[i].find(Lower) != std::string::npos;
+
+		const std::string_view Names(Live.LowerNames);
+		for (DWORD i = 0; i < (DWORD) Live.Entries.size(); i++)
+		{
+			const auto& E = Live.Entries[i];
+			if ((E.Class < ClassMatches.size() && ClassMatches[E.Class]) || Names.substr(E.NameBegin, E.NameSize).find(Lower) != std::string_view::npos)
+				Matched.push_back(i);
+		}
+	}
+
+	void ExplorerSearch::Ancestors(const DWORD Inst, std::vector<DWORD>& Out) const
+	{
+		Out.clear();
+
+		auto Found = Live.Positions.find(Inst);
+		while (Found != Live.Positions.end())
+		{
+			const auto Parent = Live.Entries[Found->second].Parent;
+			if (Parent == Root)
+				break;
+
+			Out.push_back(Parent);
+			Found = Live.Positions.find(Parent);
+		}
+
+		std::reverse(Out.begin(), Out.end());
+	}
+}
@@ -0,0 +1,88 @@
+
+/*
+*
+*	SYNAPSE X
+*	File.:	ExplorerSearch.hpp
+*	Desc.:	Name and class index behind the overlay Explorer's search box
+*
+*/
+
+#pragma once
+
+#include "Static.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+
+namespace syn
+{
+	/* Snapshot of every instance under the DataModel, rebuilt a budget of instances per frame so it never stalls the overlay.
+	   A finished walk replaces the live index in one go, queries only ever see complete walks. Render thread only */
+	class ExplorerSearch
+	{
+	public:
+		struct Entry
+		{
+			DWORD Inst;
+			DWORD Parent;
+			DWORD NameBegin;	/* into Names and LowerNames */
+			WORD NameSize;
+			WORD Class;
+		};
+
+		/* Walks up to Budget more instances, a new DataModel throws the index away */
+		void Step(DWORD DataModel, size_t Budget);
+
+		/* Recomputes the matches when the query or the index changed, a query matches names containing it or classes containing it */
+		void Query(const std::string& Text);
+
+		const std::vector<DWORD>& Matches() const { return Matched; }
+
+		const Entry& At(const DWORD Index) const { return Live.Entries[Index]; }
+
+		std::string_view Name(const Entry& E) const { return std::string_view(Live.Names).substr(E.NameBegin, E.NameSize); }
+
+		const std::string& ClassName(const Entry& E) const { return Classes[E.Class]; }
+
+		/* Parents of Inst from the index, outermost first, without touching the instances themselves */
+		void Ancestors(DWORD Inst, std::vector<DWORD>& Out) const;
+
+		size_t Size() const { return Live.Entries.size(); }
+
+		/* Instances walked by the round in progress */
+		size_t Pending() const { return Next.Entries.size(); }
+
+		/* Whether a full walk has finished since the last DataModel change */
+		bool Ready() const { return Generation != 0; }
+
+	private:
+		struct Index
+		{
+			std::vector<Entry> Entries;
+			std::string Names;
+			std::string LowerNames;
+			std::unordered_map<DWORD, DWORD> Positions;		/* instance -> entry */
+
+			void Clear();
+		};
+
+		WORD ClassOf(DWORD Inst);
+
+		Index Live;
+		Index Next;
+		std::vector<std::pair<DWORD, DWORD>> Stack;		/* (instance, parent) still to visit */
+		DWORD Root = 0;
+		DWORD Generation = 0;							/* bumped whenever Live is replaced */
+
+		/* Class descriptors are per-class singletons, names are read once per class */
+		std::unordered_map<DWORD, WORD> ClassIds;
+		std::vector<std::string> Classes;
+		std::vector<std::string> LowerClasses;
+
+		std::string LastQuery;
+		DWORD LastGeneration = 0;
+		std::vector<DWORD> Matched;
+	};
+}
@@ -10,4 +10,16 @@ namespace synf
 	FLAG(UseRemoteFiles, true);
 	FLAG(UseStaticCallingConventions, false);
 	FLAG(UseLuauOpMap, false);
+	FLAG(UseHSVMSuperInstructions, true);
+	FLAG(UseHSVMInlineCaches, true);
+	FLAG(UseHSVMInstrumentation, true);
+	FLAG(UseHSVMFrameCache, true);
+	FLAG(UseHSVMFastConcat, true);
+	FLAG(UseHSVMClosureCache, true);
+	FLAG(UseHSVMQuickening, true);
+	FLAG(UseBytecodeOptimizer, true);
+	FLAG(UseDecompilerDiskCache, true);
+	FLAG(UseInstancedDrawing, true);
+	FLAG(UseFontDiskCache, true);
+	FLAG(UseCompilePipeline, true);
 }
\ No newline at end of file
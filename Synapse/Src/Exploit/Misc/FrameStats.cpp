@@ -0,0 +1,94 @@
+#include "./FrameStats.hpp"
+
+#include <algorithm>
+
+namespace syn
+{
+	FrameStats* FrameStats::GetSingleton()
+	{
+		static FrameStats* Singleton;
+		if (!Singleton)
+			Singleton = new FrameStats();
+		return Singleton;
+	}
+
+	double FrameStats::Now()
+	{
+		static LARGE_INTEGER Frequency{};
+		if (!Frequency.QuadPart)
+			QueryPerformanceFrequency(&Frequency);
+
+		LARGE_INTEGER Counter;
+		QueryPerformanceCounter(&Counter);
+		return (double) Counter.QuadPart * 1000000.0 / (double) Frequency.QuadPart;
+	}
+
+	void FrameStats::Record(const FrameMetric Metric, const float Micros)
+	{
+		std::lock_guard<std::mutex> Guard(StatsMutex);
+
+		Metrics[Metric].Push(Micros);
+		Latest[Metric] = Micros;
+	}
+
+	void FrameStats::EndFrame(const DWORD Vertices, const DWORD Indices, const DWORD DrawCalls)
+	{
+		std::lock_guard<std::mutex> Guard(StatsMutex);
+
+		/* StepSchedule runs on the game thread at its own rate, the frame takes whatever it last reported */
+		Frames[NextFrame] = { Latest[FS_PRESENT], Latest[FS_IMGUI_BUILD], Latest[FS_STEP_SCHEDULE], Vertices, Indices, DrawCalls };
+		NextFrame = (NextFrame + 1) % Window;
+		FrameCount = (std::min)(FrameCount + 1, Window);
+	}
+
+	float FrameStats::Percentile(const FrameMetric Metric, const float P) const
+	{
+		std::array<float, Window> Sorted;
+		size_t Count;
+		{
+			std::lock_guard<std::mutex> Guard(StatsMutex);
+			Count = Metrics[Metric].Count;
+			std::copy_n(Metrics[Metric].Samples.begin(), Count, Sorted.begin());
+		}
+
+		if (!Count)
+			return 0;
+
+		const auto Rank = (size_t) (P / 100.0f * (Count - 1) + 0.5f);
+		std::nth_element(Sorted.begin(), Sorted.begin() + Rank, Sorted.begin() + Count);
+		return Sorted[Rank];
+	}
+
+	FrameStats::FrameSample FrameStats::Last() const
+	{
+		std::lock_guard<std::mutex> Guard(StatsMutex);
+		return FrameCount ? Frames[(NextFrame + Window - 1) % Window] : FrameSample{};
+	}
+
+	bool FrameStats::ExportCsv(const std::wstring& Path) const
+	{
+		std::ostringstream Csv;
+		Csv << "frame,present_us,imgui_build_us,step_schedule_us,vertices,indices,draw_calls\n";
+
+		{
+			std::lock_guard<std::mutex> Guard(StatsMutex);
+
+			/* Oldest first */
+			const auto First = (NextFrame + Window - FrameCount) % Window;
+			for (size_t i = 0; i < FrameCount; i++)
+			{
+				const auto& F = Frames[(First + i) % Window];
+				Csv << i << ',' << F.Present << ',' << F.ImGuiBuild << ',' << F.StepSchedule << ','
+					<< F.Vertices << ',' << F.Indices << ',' << F.DrawCalls << '\n';
+			}
+		}
+
+		std::ofstream Out(Path, std::ios::out | std::ios::binary);
+		if (!Out)
+			return false;
+
+		const auto Text = Csv.str();
+		Out.write(Text.c_str(), Text.size());
+		return Out.good();
+	}
+}
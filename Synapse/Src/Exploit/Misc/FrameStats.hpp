@@ -0,0 +1,85 @@
+
+/*
+*
+*	SYNAPSE X
+*	File.:	FrameStats.hpp
+*	Desc.:	Rolling overlay/scheduler timings for the stats panel
+*
+*/
+
+#pragma once
+
+#include "Static.hpp"
+
+#include <mutex>
+#include <array>
+
+namespace syn
+{
+	enum FrameMetric
+	{
+		FS_PRESENT,
+		FS_IMGUI_BUILD,
+		FS_STEP_SCHEDULE,
+		FS_COUNT
+	};
+
+	class FrameStats
+	{
+	public:
+		static constexpr size_t Window = 512;
+
+		struct FrameSample
+		{
+			float Present;
+			float ImGuiBuild;
+			float StepSchedule;
+			DWORD Vertices;
+			DWORD Indices;
+			DWORD DrawCalls;
+		};
+
+		/* Off by default, the hooks skip all timing while this is false */
+		bool Enabled = false;
+
+		static FrameStats* GetSingleton();
+
+		/* Microseconds since an arbitrary epoch, from QPC */
+		static double Now();
+
+		void Record(FrameMetric Metric, float Micros);
+
+		/* Called once per Present with the finished ImGui draw data */
+		void EndFrame(DWORD Vertices, DWORD Indices, DWORD DrawCalls);
+
+		/* Percentile (0-100) of the last Window samples, 0 when there are none */
+		float Percentile(FrameMetric Metric, float P) const;
+
+		FrameSample Last() const;
+
+		bool ExportCsv(const std::wstring& Path) const;
+
+	private:
+		struct Ring
+		{
+			std::array<float, Window> Samples{};
+			size_t Count = 0;
+			size_t Next = 0;
+
+			void Push(float Value)
+			{
+				Samples[Next] = Value;
+				Next = (Next + 1) % Window;
+				Count = (std::min)(Count + 1, Window);
+			}
+		};
+
+		mutable std::mutex StatsMutex;
+		std::array<Ring, FS_COUNT> Metrics;
+		std::array<float, FS_COUNT> Latest{};
+
+		std::array<FrameSample, Window> Frames{};
+		size_t FrameCount = 0;
+		size_t NextFrame = 0;
+	};
+}
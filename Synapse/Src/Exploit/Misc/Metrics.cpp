@@ -0,0 +1,68 @@
+#include "./Metrics.hpp"
+#include "./Channel.hpp"
+#include "./FrameStats.hpp"
+#include "../../Utilities/HttpPool.hpp"
+
+#include <thread>
+
+namespace syn
+{
+	Metrics* Metrics::GetSingleton()
+	{
+		static Metrics* Singleton;
+		if (!Singleton)
+			Singleton = new Metrics();
+		return Singleton;
+	}
+
+	void Metrics::Start()
+	{
+		if (Started.exchange(true))
+			return;
+
+		std::thread([this] { Run(); }).detach();
+	}
+
+	std::string Metrics::Format(const double Seconds)
+	{
+		const auto Tasks = TasksRun.load(std::memory_order_relaxed);
+		const auto TaskRate = Seconds > 0 ? (Tasks - LastTasks) / Seconds : 0;
+		LastTasks = Tasks;
+
+		const auto CompileCount = Compiles.load(std::memory_order_relaxed);
+		const auto CompileAverage = CompileCount ? CompileMicros.load(std::memory_order_relaxed) / 1000.0 / CompileCount : 0;
+
+		PROCESS_MEMORY_COUNTERS_EX Memory{};
+		GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*) &Memory, sizeof Memory);
+
+		const auto Http = HttpSessionPool::GetSingleton()->GetStats();
+
+		char Buffer[512];
+		sprintf_s(Buffer, "queue=%u;tasks=%.1f;compiles=%llu;compile_ms=%.2f;yields=%d;http_leased=%u;http_idle=%u;http_reused=%llu;http_created=%llu;render=%u;heap=%u;private=%llu;working=%llu",
+			QueueDepth.load(std::memory_order_relaxed), TaskRate, CompileCount, CompileAverage, YieldsInFlight.load(std::memory_order_relaxed),
+			(unsigned) Http.Leased, (unsigned) Http.Idle, Http.Reused, Http.Created, RenderObjects.load(std::memory_order_relaxed),
+			HeapBytes.load(std::memory_order_relaxed), (unsigned long long) Memory.PrivateUsage, (unsigned long long) Memory.WorkingSetSize);
+
+		return Buffer;
+	}
+
+	void Metrics::Run()
+	{
+		const auto Chan = Channel::GetSingleton();
+		auto Last = FrameStats::Now();
+
+		while (true)
+		{
+			Sleep(Interval);
+
+			const auto Now = FrameStats::Now();
+			const auto Seconds = (Now - Last) / 1000000.0;
+			Last = Now;
+
+			if (Chan->Connected())
+				Chan->Send(CM_METRICS, Format(Seconds));
+			else
+				LastTasks = TasksRun.load(std::memory_order_relaxed);
+		}
+	}
+}
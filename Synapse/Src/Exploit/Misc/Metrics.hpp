@@ -0,0 +1,49 @@
+
+/*
+*
+*	SYNAPSE X
+*	File.:	Metrics.hpp
+*	Desc.:	Runtime counters sent to the UI over the channel
+*
+*/
+
+#pragma once
+
+#include "Static.hpp"
+
+#include <atomic>
+
+namespace syn
+{
+	class Metrics
+	{
+	public:
+		/* Milliseconds between CM_METRICS frames */
+		static constexpr DWORD Interval = 1000;
+
+		/* Bumped from wherever the work happens */
+		std::atomic<std::uint64_t> TasksRun{ 0 };
+		std::atomic<std::uint64_t> Compiles{ 0 };
+		std::atomic<std::uint64_t> CompileMicros{ 0 };
+		std::atomic<std::int32_t> YieldsInFlight{ 0 };
+
+		/* Sampled by the game thread once per scheduler step */
+		std::atomic<std::uint32_t> QueueDepth{ 0 };
+		std::atomic<std::uint32_t> HeapBytes{ 0 };
+		std::atomic<std::uint32_t> RenderObjects{ 0 };
+
+		static Metrics* GetSingleton();
+
+		/* Starts the sender thread once, frames are only built while the UI is connected */
+		void Start();
+
+		/* key=value pairs separated by ';', rates are over the last Seconds */
+		std::string Format(double Seconds);
+
+	private:
+		void Run();
+
+		std::atomic<bool> Started{ false };
+		std::uint64_t LastTasks = 0;
+	};
+}
@@ -0,0 +1,192 @@
+#include "./Profiler.hpp"
+
+#include <fstream>
+#include <sstream>
+
+namespace syn
+{
+	Profiler* Profiler::GetSingleton()
+	{
+		static Profiler* profiler = nullptr;
+		if (profiler == nullptr)
+			profiler = new Profiler();
+
+		return profiler;
+	}
+
+	ProfileZoneId Profiler::Zone(const std::string& Name)
+	{
+		std::lock_guard<std::mutex> Guard(ZoneMutex);
+
+		const auto Found = ZoneIds.find(Name);
+		if (Found != ZoneIds.end())
+			return Found->second;
+
+		/* Out of ids, the dump skips anything it can't name */
+		if (ZoneNames.size() >= 0xFFFF)
+			return 0xFFFF;
+
+		const auto Id = (ProfileZoneId) ZoneNames.size();
+		ZoneNames.push_back(Name);
+		ZoneIds.emplace(Name, Id);
+		return Id;
+	}
+
+	const char* Profiler::ZoneName(const ProfileZoneId Zone)
+	{
+		std::lock_guard<std::mutex> Guard(ZoneMutex);
+		return Zone < ZoneNames.size() ? ZoneNames[Zone].c_str() : "";
+	}
+
+	Profiler::ThreadRing* Profiler::GetThreadRing()
+	{
+		/* Rings are never freed, a thread that exits leaves its events behind for the dump */
+		static thread_local ThreadRing* Ring = nullptr;
+		if (Ring)
+			return Ring;
+
+		Ring = new ThreadRing();
+		Ring->ThreadId = GetCurrentThreadId();
+
+		std::lock_guard<std::mutex> Guard(RingMutex);
+		Rings.push_back(Ring);
+		return Ring;
+	}
+
+	void Profiler::Record(const ProfileZoneId Zone, const LONGLONG Begin, const LONGLONG End, const bool Instant)
+	{
+		const auto Ring = GetThreadRing();
+		const auto Head = Ring->Head.load(std::memory_order_relaxed);
+
+		auto& Event = Ring->Events[Head % RingSize];
+		Event.Begin = Begin;
+		Event.End = End;
+		Event.Zone = Zone;
+		Event.Instant = Instant;
+
+		Ring->Head.store(Head + 1, std::memory_order_release);
+	}
+
+	void Profiler::AddProfile(const std::string& profilerStr)
+	{
+		DbgConsoleExec(*syn::Console::GetSingleton() << ("[PROFILER OUTPUT]: " + profilerStr + '\n'));
+
+		{
+			std::lock_guard<std::mutex> Guard(MessageMutex);
+
+			auto& Info = Messages[NextMessage];
+			Info.Message = profilerStr;
+			Info.Time = std::time(nullptr);
+
+			NextMessage = (NextMessage + 1) % MessageLimit;
+			MessageCount = (std::min)(MessageCount + 1, MessageLimit);
+		}
+
+		if (EventTrace::Enabled())
+			EventTrace::Message(profilerStr.c_str());
+
+		if (Tracing.load(std::memory_order_relaxed))
+		{
+			const auto Stamp = Now();
+			Record(Zone(profilerStr), Stamp, Stamp, true);
+		}
+	}
+
+	std::string Profiler::DumpProfile()
+	{
+		std::lock_guard<std::mutex> Guard(MessageMutex);
+
+		std::ostringstream oss;
+		const auto First = (NextMessage + MessageLimit - MessageCount) % MessageLimit;
+		for (size_t i = 0; i < MessageCount; i++)
+		{
+			const auto& Info = Messages[(First + i) % MessageLimit];
+			const auto PTM = std::localtime(&Info.Time);
+			char Buffer[32];
+			std::strftime(Buffer, 32, "%H:%M:%S", PTM);
+
+			oss << i << ". " << Info.Message << " (" << Buffer << ")\n";
+		}
+		return oss.str();
+	}
+
+	static std::string EscapeTraceName(const std::string& Name)
+	{
+		std::string Out;
+		Out.reserve(Name.size());
+		for (const auto C : Name)
+		{
+			if (C == '"' || C == '\\')
+				Out += '\\';
+			if ((unsigned char) C < 0x20)
+				continue;
+			Out += C;
+		}
+		return Out;
+	}
+
+	bool Profiler::DumpTrace(const std::wstring& Path)
+	{
+		LARGE_INTEGER Frequency;
+		QueryPerformanceFrequency(&Frequency);
+		const auto ToMicros = [&Frequency](const LONGLONG Ticks)
+		{
+			return (double) Ticks * 1000000.0 / (double) Frequency.QuadPart;
+		};
+
+		std::vector<std::string> Names;
+		{
+			std::lock_guard<std::mutex> Guard(ZoneMutex);
+			Names.assign(ZoneNames.begin(), ZoneNames.end());
+		}
+
+		for (auto& Name : Names)
+			Name = EscapeTraceName(Name);
+
+		std::vector<ThreadRing*> Snapshot;
+		{
+			std::lock_guard<std::mutex> Guard(RingMutex);
+			Snapshot = Rings;
+		}
+
+		std::ofstream Out(Path, std::ios::binary);
+		if (!Out)
+			return false;
+
+		const auto Pid = GetCurrentProcessId();
+		auto First = true;
+
+		Out << "{\"traceEvents\":[";
+		Out.precision(3);
+		Out << std::fixed;
+
+		for (const auto Ring : Snapshot)
+		{
+			/* Events this far behind Head may already be overwritten by the owner, only the newest RingSize are read */
+			const auto Head = Ring->Head.load(std::memory_order_acquire);
+			const auto Start = Head > RingSize ? Head - (std::uint32_t) RingSize : 0;
+
+			for (auto i = Start; i < Head; i++)
+			{
+				const auto Event = Ring->Events[i % RingSize];
+				if (Event.Zone >= Names.size())
+					continue;
+
+				if (!First)
+					Out << ',';
+				First = false;
+
+				Out << "{\"name\":\"" << Names[Event.Zone] << "\",\"pid\":" << Pid << ",\"tid\":" << Ring->ThreadId
+					<< ",\"ts\":" << ToMicros(Event.Begin);
+
+				if (Event.Instant)
+					Out << ",\"ph\":\"i\",\"s\":\"t\"}";
+				else
+					Out << ",\"ph\":\"X\",\"dur\":" << ToMicros(Event.End - Event.Begin) << '}';
+			}
+		}
+
+		Out << "],\"displayTimeUnit\":\"ms\"}";
+		return Out.good();
+	}
+}
@@ -1,59 +1,137 @@
+
+/*
+*
+*	SYNAPSE X
+*	File.:	Profiler.hpp
+*	Desc.:	Scoped zone profiler with per-thread event rings and a Chrome trace dump
+*
+*/
+
 #pragma once
+
+#include <array>
+#include <atomic>
+#include <ctime>
+#include <deque>
+#include <mutex>
 #include <vector>
-#include <iomanip>
-#include <sstream>
+#include <unordered_map>
 
 #include "../../Utilities/Utils.hpp"
 #include "../../Utilities/Console.hpp"
+#include "./EventTrace.hpp"
+
+#define SYN_PROFILE_CAT2(A, B) A##B
+#define SYN_PROFILE_CAT(A, B) SYN_PROFILE_CAT2(A, B)
+
+/* Times the rest of the enclosing scope, the name is interned once per call site */
+#define PROFILE_ZONE(Name) \
+	static const auto SYN_PROFILE_CAT(ProfileZoneId, __LINE__) = syn::Profiler::GetSingleton()->Zone(Name); \
+	static const auto SYN_PROFILE_CAT(ProfileZoneName, __LINE__) = syn::Profiler::GetSingleton()->ZoneName(SYN_PROFILE_CAT(ProfileZoneId, __LINE__)); \
+	const syn::ProfileScope SYN_PROFILE_CAT(ProfileZoneScope, __LINE__)(SYN_PROFILE_CAT(ProfileZoneId, __LINE__), SYN_PROFILE_CAT(ProfileZoneName, __LINE__))
 
 namespace syn
 {
-	struct Profiler
+	typedef std::uint16_t ProfileZoneId;
+
+	struct ProfileEvent
 	{
+		LONGLONG Begin;
+		LONGLONG End;
+		ProfileZoneId Zone;
+		bool Instant;
+	};
+
+	class Profiler
+	{
+	public:
+		static constexpr size_t RingSize = 8192;
+		static constexpr size_t MessageLimit = 50;
+
+		/* Written only by its owning thread, Head is published with release so the dump can read without locking */
+		struct ThreadRing
+		{
+			DWORD ThreadId = 0;
+			std::atomic<std::uint32_t> Head{ 0 };
+			std::array<ProfileEvent, RingSize> Events{};
+		};
+
+		/* Zones cost one branch while this is false */
+		std::atomic<bool> Tracing{ false };
+
+		static Profiler* GetSingleton();
+
+		static LONGLONG Now()
+		{
+			LARGE_INTEGER Counter;
+			QueryPerformanceCounter(&Counter);
+			return Counter.QuadPart;
+		}
+
+		/* Returns a stable id for Name, the same name always maps to the same id */
+		ProfileZoneId Zone(const std::string& Name);
+
+		/* Interned name of a zone, the pointer stays valid for the life of the process */
+		const char* ZoneName(ProfileZoneId Zone);
+
+		void Record(ProfileZoneId Zone, LONGLONG Begin, LONGLONG End, bool Instant = false);
+
+		/* Cold path log message, also emitted as an instant event while tracing and as an ETW message while a session listens */
+		void AddProfile(const std::string& profilerStr);
+
+		/* The last MessageLimit AddProfile messages, oldest first */
+		std::string DumpProfile();
+
+		/* Writes every thread ring as Chrome trace event JSON (chrome://tracing, Perfetto, Tracy import) */
+		bool DumpTrace(const std::wstring& Path);
+
+	private:
 		struct ProfileInfo
 		{
 			std::string Message;
 			std::time_t Time{};
 		};
 
-		std::vector<ProfileInfo> ProfilerInfo;
-
-		void AddProfile(const std::string &profilerStr)
-		{
-			if (ProfilerInfo.size() > 50)
-				ProfilerInfo.erase(ProfilerInfo.begin());
+		ThreadRing* GetThreadRing();
 
-			DbgConsoleExec(*syn::Console::GetSingleton() << ("[PROFILER OUTPUT]: " + profilerStr + '\n'));
+		std::mutex ZoneMutex;
+		std::deque<std::string> ZoneNames;
+		std::unordered_map<std::string, ProfileZoneId> ZoneIds;
 
-			ProfileInfo Info;
-			Info.Message = Base64Encode((byte*) profilerStr.c_str(), profilerStr.length());
-			Info.Time = std::time(nullptr);
+		std::mutex RingMutex;
+		std::vector<ThreadRing*> Rings;
 
-			ProfilerInfo.push_back(Info);
-		}
+		std::mutex MessageMutex;
+		std::array<ProfileInfo, MessageLimit> Messages;
+		size_t MessageCount = 0;
+		size_t NextMessage = 0;
+	};
 
-		std::string DumpProfile()
+	class ProfileScope
+	{
+	public:
+		ProfileScope(const ProfileZoneId Zone, const char* Name) : Zone(Zone), Begin(Profiler::GetSingleton()->Tracing.load(std::memory_order_relaxed) ? Profiler::Now() : 0),
+			Name(EventTrace::Enabled() ? Name : nullptr)
 		{
-			std::ostringstream oss;
-			for (unsigned i = 0; i < ProfilerInfo.size(); i++)
-			{
-				const auto PTM = std::localtime(&ProfilerInfo[i].Time);
-				char Buffer[32];
-				std::strftime(Buffer, 32, "%H:%M:%S", PTM);
-
-				oss << std::to_string(i) << ". " << Base64Decode(ProfilerInfo[i].Message) << " (" << std::string(Buffer) << ")\n";
-			}
-			return oss.str();
+			if (this->Name)
+				EventTrace::Begin(this->Name);
 		}
 
-		static Profiler* GetSingleton()
+		~ProfileScope()
 		{
-			static Profiler* profiler = nullptr;
-			if (profiler == nullptr)
-				profiler = new Profiler();
+			if (Begin)
+				Profiler::GetSingleton()->Record(Zone, Begin, Profiler::Now());
 
-			return profiler; 
+			if (Name)
+				EventTrace::End(Name);
 		}
 
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+	private:
+		ProfileZoneId Zone;
+		LONGLONG Begin;
+		const char* Name;	/* null unless an ETW session saw the start */
 	};
 }
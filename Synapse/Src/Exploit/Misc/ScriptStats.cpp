@@ -0,0 +1,133 @@
+#include "./ScriptStats.hpp"
+#include "./FrameStats.hpp"
+#include "./Updated.hpp"
+
+#include <algorithm>
+
+namespace syn
+{
+	ScriptStats* ScriptStats::GetSingleton()
+	{
+		static ScriptStats* Singleton;
+		if (!Singleton)
+			Singleton = new ScriptStats();
+		return Singleton;
+	}
+
+	DWORD ScriptStats::KeyOf(const DWORD Thread)
+	{
+		return *(DWORD*) (Thread + L_ENV);
+	}
+
+	ScriptStats::Entry& ScriptStats::Find(const DWORD Key)
+	{
+		auto& Script = Scripts[Key];
+		if (!Script.Id)
+		{
+			Script.Id = ++NextId;
+			Script.Label = "script #" + std::to_string(Script.Id);
+		}
+
+		return Script;
+	}
+
+	DWORD ScriptStats::TotalBytes() const
+	{
+		return GlobalState ? *(DWORD*) (GlobalState + G_TOTALBYTES) : 0;
+	}
+
+	void ScriptStats::Register(const DWORD Thread, const std::string& Source)
+	{
+		if (!Enabled)
+			return;
+
+		/* First non-blank line, bytecode has nothing readable to show */
+		std::string Label;
+		if (Source.empty() || Source[0] != '\x1b')
+		{
+			const auto Begin = Source.find_first_not_of(" \t\r\n");
+			if (Begin != std::string::npos)
+				Label = Source.substr(Begin, (std::min)(Source.find_first_of("\r\n", Begin), Begin + 48) - Begin);
+		}
+
+		std::lock_guard<std::mutex> Guard(Mutex);
+
+		auto& Script = Find(KeyOf(Thread));
+		if (!Label.empty())
+			Script.Label = "#" + std::to_string(Script.Id) + " " + Label;
+	}
+
+	void ScriptStats::SetGlobalState(const DWORD State)
+	{
+		std::lock_guard<std::mutex> Guard(Mutex);
+		GlobalState = State;
+	}
+
+	std::string ScriptStats::LabelOf(const DWORD Key) const
+	{
+		std::lock_guard<std::mutex> Guard(Mutex);
+
+		const auto Found = Scripts.find(Key);
+		return Found != Scripts.end() ? Found->second.Label : std::string();
+	}
+
+	std::vector<ScriptStats::Entry> ScriptStats::Snapshot() const
+	{
+		std::vector<Entry> Out;
+		{
+			std::lock_guard<std::mutex> Guard(Mutex);
+			Out.reserve(Scripts.size());
+			for (const auto& Script : Scripts)
+				Out.push_back(Script.second);
+		}
+
+		std::sort(Out.begin(), Out.end(), [](const Entry& A, const Entry& B) { return A.Micros > B.Micros; });
+		return Out;
+	}
+
+	void ScriptStats::Reset()
+	{
+		std::lock_guard<std::mutex> Guard(Mutex);
+		Scripts.clear();
+		NextId = 0;
+	}
+
+	ScriptStats::Scope::Scope(const DWORD Thread)
+	{
+		const auto Stats = GetSingleton();
+		if (!Stats->Enabled)
+			return;
+
+		/* A resume started from inside another one is already being timed by the outer scope */
+		std::lock_guard<std::mutex> Guard(Stats->Mutex);
+		Counted = true;
+		if (Stats->Depth++)
+			return;
+
+		Key = KeyOf(Thread);
+		StartBytes = Stats->TotalBytes();
+		Start = FrameStats::Now();
+	}
+
+	ScriptStats::Scope::~Scope()
+	{
+		if (!Counted)
+			return;
+
+		const auto Stats = GetSingleton();
+		const auto End = FrameStats::Now();
+
+		std::lock_guard<std::mutex> Guard(Stats->Mutex);
+		Stats->Depth--;
+		if (!Key)
+			return;
+
+		const auto Micros = End - Start;
+
+		auto& Script = Stats->Find(Key);
+		Script.Resumes++;
+		Script.Micros += Micros;
+		Script.PeakMicros = (std::max)(Script.PeakMicros, Micros);
+		Script.NetBytes += (std::int64_t) Stats->TotalBytes() - (std::int64_t) StartBytes;
+	}
+}
@@ -0,0 +1,85 @@
+
+/*
+*
+*	SYNAPSE X
+*	File.:	ScriptStats.hpp
+*	Desc.:	Per-script resume time and memory accounting
+*
+*/
+
+#pragma once
+
+#include "Static.hpp"
+
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+
+namespace syn
+{
+	class ScriptStats
+	{
+	public:
+		struct Entry
+		{
+			std::uint32_t Id = 0;
+			std::string Label;
+			std::uint64_t Resumes = 0;
+			double Micros = 0;
+			double PeakMicros = 0;
+			/* Change of the VM heap across this script's resumes, frees by the GC during a resume count against it */
+			std::int64_t NetBytes = 0;
+		};
+
+		/* Measures one resume on the game thread, recorded when it goes out of scope */
+		class Scope
+		{
+		public:
+			explicit Scope(DWORD Thread);
+			~Scope();
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+
+		private:
+			bool Counted = false;
+			DWORD Key = 0;
+			double Start = 0;
+			DWORD StartBytes = 0;
+		};
+
+		/* Off by default, resumes aren't measured while this is false */
+		bool Enabled = false;
+
+		static ScriptStats* GetSingleton();
+
+		/* Names the script running on Thread after the first line of its source */
+		void Register(DWORD Thread, const std::string& Source);
+
+		/* Game global_State, the heap total is read from it around every resume */
+		void SetGlobalState(DWORD State);
+
+		/* Game heap total in bytes, 0 before the first attach. Game thread */
+		DWORD TotalBytes() const;
+
+		/* Label of the script with this environment table, empty if it was never seen */
+		std::string LabelOf(DWORD Key) const;
+
+		/* Every script seen since the last reset, busiest first */
+		std::vector<Entry> Snapshot() const;
+
+		void Reset();
+
+	private:
+		/* Scripts are keyed by their environment table, threads a script spawns share it */
+		static DWORD KeyOf(DWORD Thread);
+
+		Entry& Find(DWORD Key);
+
+		mutable std::mutex Mutex;
+		std::unordered_map<DWORD, Entry> Scripts;
+		std::uint32_t NextId = 0;
+		DWORD GlobalState = 0;
+		std::uint32_t Depth = 0;
+	};
+}
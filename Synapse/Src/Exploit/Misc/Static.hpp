@@ -68,6 +68,7 @@ extern "C"
 	#include "../../Source Dependencies/Lua/lopcodes.h"
 	#include "../../Source Dependencies/Lua/lstring.h"
 	#include "../../Source Dependencies/Lua/ldo.h"
+	#include "../../Source Dependencies/Lua/lundump.h"
     #include "../../Source Dependencies/Lua/llex.h"
 }
 
@@ -109,6 +110,9 @@ extern "C"
 /* turn this on for the Lua U decompiler. this is so the decompiler is not accidentally compiled into release builds. */
 //#define EnableLuaUDecompiler
 
+/* turn this on for the offline compile pipeline benchmarks in the stats window. this is so they are not accidentally compiled into release builds. */
+//#define EnableBenchmarks
+
 /* turn this on for SecureLua HSVMs. */
 #define EnableSecureLua
 
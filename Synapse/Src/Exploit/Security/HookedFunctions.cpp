@@ -2,7 +2,9 @@
 #include "../Execution/RbxApi.hpp"
 
 #include "../Misc/D3D.hpp"
-#include "../Misc/Fonts.hpp"
+#include "../Misc/FrameStats.hpp"
+#include "../Misc/Profiler.hpp"
+#include "../Misc/Benchmark.hpp"
 
 #include "../../Source Dependencies/ImGUI/imgui_impl_dx11.h"
 #include "../../Source Dependencies/ImGUI/imgui_impl_win32.h"
@@ -44,7 +46,7 @@ PLH::CapstoneDisassembler x86Disasm{ PLH::Mode::x86 };
 LPVOID OriginalNtQVM = nullptr;
 LPVOID OriginalZwFT = nullptr;
 std::string D3DWorkspaceDirectory;
-std::vector<std::pair<std::string, ImU32>> ConsoleOutput;
+syn::ConsoleBuffer ConsoleOutput;
 std::unordered_map<std::uintptr_t, SynCClosure> HookedFunctionsMap;
 uintptr_t CurrentInstanceMsgOut;
 
@@ -222,7 +224,7 @@ int MsgOutHookHandler(DWORD* Data)
 		if (Msg->find(ChunkName) != std::string::npos)
 		{
 			const auto Color = ImGui::GetColorU32(ImVec4(1, 0, 0, 1));
-			ConsoleOutput.emplace_back(std::make_pair(*Msg, Color));
+			ConsoleOutput.Push(*Msg, Color);
 
 			return 0;
 		}
@@ -293,6 +295,12 @@ int CallcheckProxy(DWORD rL)
 
 HRESULT __stdcall PresentHook(IDXGISwapChain* pSwapChain, UINT SyncInterval, UINT Flags)
 {
+	PROFILE_ZONE(OBFUSCATE_STR("Present hook"));
+
+	const auto Stats = syn::FrameStats::GetSingleton();
+	const auto Collect = Stats->Enabled;
+	const auto HookStart = Collect ? syn::FrameStats::Now() : 0.0;
+
 	if (ID3DFirst)
 	{
 		ID3DChain = pSwapChain;
@@ -311,27 +319,7 @@ HRESULT __stdcall PresentHook(IDXGISwapChain* pSwapChain, UINT SyncInterval, UIN
 		ImGui_ImplWin32_Init(RbxHwnd);
 		ImGui_ImplDX11_Init(ID3DDevice, ID3DContext);
 
-		ImFontConfig Config{};
-		Config.OversampleH = 3;
-		Config.OversampleV = 3;
-
-		auto& IO = ImGui::GetIO();
-		auto SD3D = syn::D3D::GetSingleton();
-		SD3D->AddFont(IO.Fonts->AddFontFromMemoryCompressedTTF(seoge_ui_compressed_data, seoge_ui_compressed_size, 32.0f, &Config));
-		SD3D->AddFont(IO.Fonts->AddFontDefault(&Config));
-		SD3D->AddFont(IO.Fonts->AddFontFromMemoryCompressedTTF(ibm_plex_compressed_data, ibm_plex_compressed_size, 32.0f, &Config));
-		SD3D->AddFont(IO.Fonts->AddFontFromMemoryCompressedTTF(sometype_mono_compressed_data, sometype_mono_compressed_size, 32.0f, &Config));
-
-		IO.Fonts->TexGlyphPadding = 1;
-		for (auto n = 0; n < IO.Fonts->ConfigData.Size; n++)
-		{
-			auto* FontCfg = (ImFontConfig*) &IO.Fonts->ConfigData[n];
-			FontCfg->RasterizerMultiply = 1.0f;
-			FontCfg->RasterizerFlags = 0;
-		}
-
-		ImGuiFreeType::BuildFontAtlas(IO.Fonts, 0);
-		ImGui_ImplDX11_CreateDeviceObjects();
+		syn::D3D::GetSingleton()->InitializeFonts();
 
 		ID3DRenderTarget->Release();
 
@@ -341,7 +329,10 @@ HRESULT __stdcall PresentHook(IDXGISwapChain* pSwapChain, UINT SyncInterval, UIN
 	if (FPSUnlocked)
 	{
         /* TODO: Move to renderstepped */
-        *(double*)(TaskSched + TaskSchedDelay) = 1.0 / 144.0;
+        *(double*)(TaskSched + TaskSchedDelay) = syn::D3D::GetSchedulerDelay();
+
+		if (syn::D3D::FPSLowLatency.load(std::memory_order_relaxed))
+			SyncInterval = 0;
 	}
 
 	if (SUCCEEDED(pSwapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), reinterpret_cast<LPVOID*>(&ID3DRenderTargetTexture))))
@@ -352,32 +343,88 @@ HRESULT __stdcall PresentHook(IDXGISwapChain* pSwapChain, UINT SyncInterval, UIN
 
 	ID3DContext->OMSetRenderTargets(1, &ID3DRenderTarget, NULL);
 
-	ImGui_ImplDX11_NewFrame();
-	ImGui_ImplWin32_NewFrame();
-	ImGui::NewFrame();
+	if (!syn::D3D::GetSingleton()->FontsReady())
+	{
+		ID3DRenderTarget->Release();
+		return OrigIDXGISwapChainPresent(pSwapChain, SyncInterval, Flags);
+	}
+
+	const auto BuildStart = Collect ? syn::FrameStats::Now() : 0.0;
 
 	const auto D3DRender = syn::D3D::GetSingleton();
 
-	D3DRender->BeginScene();
-	D3DRender->DrawScene();
-	D3DRender->EndScene();
+	/* With the UI closed a frame only depends on the Drawing scene and the window size, so while neither changes
+	   the previous draw data is drawn again from the buffers it was already uploaded to */
+	static bool HaveFrame = false;
+	static bool WasOpen = false;
+	static RECT LastClient{};
 
-	if (IGuiEnabled)
+#ifdef EnableBenchmarks
+	/* The benchmark's frames go through the same backend buffers and instancer, the last frame can't be replayed after it */
+	if (syn::Benchmark::GetSingleton()->OverlayPending.load(std::memory_order_acquire))
 	{
-		if (IGuiOpen)
+		syn::Benchmark::GetSingleton()->RunOverlay(ID3DDevice, ID3DContext);
+		ID3DContext->OMSetRenderTargets(1, &ID3DRenderTarget, NULL);
+		HaveFrame = false;
+	}
+#endif
+
+	RECT Client{};
+	GetClientRect(syn::RobloxWindow, &Client);
+
+	const auto Open = IGuiEnabled && IGuiOpen;
+	const auto Reuse = HaveFrame && !Open && !WasOpen && !D3DRender->HasNewScene() && !D3DRender->HasNewFonts() && !D3DRender->HasNewImages() && memcmp(&Client, &LastClient, sizeof Client) == 0;
+	WasOpen = Open;
+	LastClient = Client;
+
+	if (!Reuse)
+	{
+		D3DRender->UpdateFonts();
+
+		ImGui_ImplDX11_NewFrame();
+		ImGui_ImplWin32_NewFrame();
+		ImGui::NewFrame();
+
+		D3DRender->BeginScene();
+		D3DRender->DrawScene();
+		D3DRender->EndScene();
+
+		if (IGuiEnabled)
 		{
-			ImGui::GetIO().MouseDrawCursor = TRUE;
-			D3DRender->DrawUI();
+			if (IGuiOpen)
+			{
+				ImGui::GetIO().MouseDrawCursor = TRUE;
+				D3DRender->DrawUI();
+			}
+			else ImGui::GetIO().MouseDrawCursor = FALSE;
 		}
-		else ImGui::GetIO().MouseDrawCursor = FALSE;
+
+		ImGui::Render();
+		HaveFrame = true;
+
+		if (Collect)
+			Stats->Record(syn::FS_IMGUI_BUILD, (float) (syn::FrameStats::Now() - BuildStart));
 	}
 
-	ImGui::Render();
-	ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+	const auto DrawData = ImGui::GetDrawData();
+	ImGui_ImplDX11_RenderDrawData(DrawData, Reuse);
 
 	ID3DRenderTarget->Release();
 
-	return OrigIDXGISwapChainPresent(pSwapChain, SyncInterval, Flags);
+	if (Collect)
+	{
+		DWORD DrawCalls = 0;
+		for (auto i = 0; i < DrawData->CmdListsCount; i++)
+			DrawCalls += DrawData->CmdLists[i]->CmdBuffer.Size;
+
+		Stats->Record(syn::FS_PRESENT, (float) (syn::FrameStats::Now() - HookStart));
+		Stats->EndFrame(DrawData->TotalVtxCount, DrawData->TotalIdxCount, DrawCalls);
+	}
+
+	const auto Result = OrigIDXGISwapChainPresent(pSwapChain, SyncInterval, Flags);
+	syn::D3D::PaceFrame();
+
+	return Result;
 }
 
 LRESULT __stdcall WndProcHook(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
@@ -54,6 +54,10 @@ static ID3D11RasterizerState*   g_pRasterizerState = NULL;
 static ID3D11BlendState*        g_pBlendState = NULL;
 static ID3D11DepthStencilState* g_pDepthStencilState = NULL;
 static int                      g_VertexBufferSize = 5000, g_IndexBufferSize = 10000;
+static int                      g_VertexRingPos = 0, g_IndexRingPos = 0;
+static int                      g_VertexLowFrames = 0, g_IndexLowFrames = 0;
+static ImVector<int>            g_ListBaseVertex;
+static int                      g_LastVertexStart = 0, g_LastIndexStart = 0;
 
 struct VERTEX_CONSTANT_BUFFER
 {
@@ -91,9 +95,50 @@ static void ImGui_ImplDX11_SetupRenderState(ImDrawData* draw_data, ID3D11DeviceC
     ctx->RSSetState(g_pRasterizerState);
 }
 
+// Keeps a dynamic buffer large enough for a frame. It grows geometrically when a frame doesn't fit and only shrinks
+// once usage has stayed far below capacity for a while, so scenes hovering around a size don't recreate it every few frames.
+// The spare capacity doubles as room for the upload ring.
+static bool ImGui_ImplDX11_ResizeBuffer(ID3D11Buffer** buffer, int* size, int* ring_pos, int* low_frames, int needed, int min_size, UINT stride, UINT bind_flags)
+{
+    int new_size = *size;
+    if (!*buffer || needed > *size)
+    {
+        while (new_size < needed * 2)
+            new_size *= 2;
+        *low_frames = 0;
+    }
+    else if (needed * 8 < *size && *size > min_size)
+    {
+        if (++*low_frames >= 600)
+        {
+            new_size = *size / 2 > min_size ? *size / 2 : min_size;
+            *low_frames = 0;
+        }
+    }
+    else
+    {
+        *low_frames = 0;
+    }
+
+    if (*buffer && new_size == *size)
+        return true;
+
+    if (*buffer) { (*buffer)->Release(); *buffer = NULL; }
+    *size = new_size;
+    *ring_pos = new_size;   // First map of the new buffer discards
+    D3D11_BUFFER_DESC desc;
+    memset(&desc, 0, sizeof(D3D11_BUFFER_DESC));
+    desc.Usage = D3D11_USAGE_DYNAMIC;
+    desc.ByteWidth = new_size * stride;
+    desc.BindFlags = bind_flags;
+    desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    desc.MiscFlags = 0;
+    return g_pd3dDevice->CreateBuffer(&desc, NULL, buffer) >= 0;
+}
+
 // Render function
 // (this used to be set in io.RenderDrawListsFn and called by ImGui::Render(), but you can now call this directly from your main loop)
-void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
+void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data, bool reuse_buffers)
 {
     // Avoid rendering when minimized
     if (draw_data->DisplaySize.x <= 0.0f || draw_data->DisplaySize.y <= 0.0f)
@@ -101,53 +146,75 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
 
     ID3D11DeviceContext* ctx = g_pd3dDeviceContext;
 
-    // Create and grow vertex/index buffers if needed
-    if (!g_pVB || g_VertexBufferSize < draw_data->TotalVtxCount)
+    // A frame the caller knows is identical to the last one draws from the ranges already uploaded
+    int ring_vtx_start = g_LastVertexStart;
+    int ring_idx_start = g_LastIndexStart;
+    if (!reuse_buffers || !g_pVB || !g_pIB || g_ListBaseVertex.Size != draw_data->CmdListsCount)
     {
-        if (g_pVB) { g_pVB->Release(); g_pVB = NULL; }
-        g_VertexBufferSize = draw_data->TotalVtxCount + 5000;
-        D3D11_BUFFER_DESC desc;
-        memset(&desc, 0, sizeof(D3D11_BUFFER_DESC));
-        desc.Usage = D3D11_USAGE_DYNAMIC;
-        desc.ByteWidth = g_VertexBufferSize * sizeof(ImDrawVert);
-        desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-        desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-        desc.MiscFlags = 0;
-        if (g_pd3dDevice->CreateBuffer(&desc, NULL, &g_pVB) < 0)
+        // Create and grow vertex/index buffers if needed
+        if (!ImGui_ImplDX11_ResizeBuffer(&g_pVB, &g_VertexBufferSize, &g_VertexRingPos, &g_VertexLowFrames, draw_data->TotalVtxCount, 5000, sizeof(ImDrawVert), D3D11_BIND_VERTEX_BUFFER))
             return;
-    }
-    if (!g_pIB || g_IndexBufferSize < draw_data->TotalIdxCount)
-    {
-        if (g_pIB) { g_pIB->Release(); g_pIB = NULL; }
-        g_IndexBufferSize = draw_data->TotalIdxCount + 10000;
-        D3D11_BUFFER_DESC desc;
-        memset(&desc, 0, sizeof(D3D11_BUFFER_DESC));
-        desc.Usage = D3D11_USAGE_DYNAMIC;
-        desc.ByteWidth = g_IndexBufferSize * sizeof(ImDrawIdx);
-        desc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-        desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-        if (g_pd3dDevice->CreateBuffer(&desc, NULL, &g_pIB) < 0)
+        if (!ImGui_ImplDX11_ResizeBuffer(&g_pIB, &g_IndexBufferSize, &g_IndexRingPos, &g_IndexLowFrames, draw_data->TotalIdxCount, 10000, sizeof(ImDrawIdx), D3D11_BIND_INDEX_BUFFER))
             return;
-    }
 
-    // Upload vertex/index data into a single contiguous GPU buffer
-    D3D11_MAPPED_SUBRESOURCE vtx_resource, idx_resource;
-    if (ctx->Map(g_pVB, 0, D3D11_MAP_WRITE_DISCARD, 0, &vtx_resource) != S_OK)
-        return;
-    if (ctx->Map(g_pIB, 0, D3D11_MAP_WRITE_DISCARD, 0, &idx_resource) != S_OK)
-        return;
-    ImDrawVert* vtx_dst = (ImDrawVert*)vtx_resource.pData;
-    ImDrawIdx* idx_dst = (ImDrawIdx*)idx_resource.pData;
-    for (int n = 0; n < draw_data->CmdListsCount; n++)
-    {
-        const ImDrawList* cmd_list = draw_data->CmdLists[n];
-        memcpy(vtx_dst, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
-        memcpy(idx_dst, cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
-        vtx_dst += cmd_list->VtxBuffer.Size;
-        idx_dst += cmd_list->IdxBuffer.Size;
+        // Upload vertex/index data after the previous frames' data, only discarding the buffer once it wraps around.
+        // Mapping with NO_OVERWRITE lets the driver skip renaming the buffer while the GPU still reads the older ranges.
+        D3D11_MAP vtx_map = D3D11_MAP_WRITE_NO_OVERWRITE, idx_map = D3D11_MAP_WRITE_NO_OVERWRITE;
+        if (g_VertexRingPos + draw_data->TotalVtxCount > g_VertexBufferSize) { g_VertexRingPos = 0; vtx_map = D3D11_MAP_WRITE_DISCARD; }
+        if (g_IndexRingPos + draw_data->TotalIdxCount > g_IndexBufferSize) { g_IndexRingPos = 0; idx_map = D3D11_MAP_WRITE_DISCARD; }
+        ring_vtx_start = g_VertexRingPos;
+        ring_idx_start = g_IndexRingPos;
+
+        D3D11_MAPPED_SUBRESOURCE vtx_resource, idx_resource;
+        if (ctx->Map(g_pVB, 0, vtx_map, 0, &vtx_resource) != S_OK)
+            return;
+        if (ctx->Map(g_pIB, 0, idx_map, 0, &idx_resource) != S_OK)
+        {
+            ctx->Unmap(g_pVB, 0);
+            return;
+        }
+        ImDrawVert* vtx_dst = (ImDrawVert*)vtx_resource.pData + ring_vtx_start;
+        ImDrawIdx* idx_dst = (ImDrawIdx*)idx_resource.pData + ring_idx_start;
+
+        // Lists are rebased onto a shared base vertex while their indices still fit in ImDrawIdx, so draws from
+        // different lists can be merged below. Lists that already use VtxOffset (64k+ vertices) keep their own base.
+        g_ListBaseVertex.resize(draw_data->CmdListsCount);
+        int batch_base = 0;
+        int global_vtx = 0;
+        for (int n = 0; n < draw_data->CmdListsCount; n++)
+        {
+            const ImDrawList* cmd_list = draw_data->CmdLists[n];
+
+            bool uses_vtx_offset = false;
+            for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size && !uses_vtx_offset; cmd_i++)
+                uses_vtx_offset = cmd_list->CmdBuffer[cmd_i].VtxOffset != 0;
+
+            if (uses_vtx_offset || global_vtx + cmd_list->VtxBuffer.Size - batch_base > (1 << (sizeof(ImDrawIdx) * 8)))
+                batch_base = global_vtx;
+
+            const int rebase = global_vtx - batch_base;
+            memcpy(vtx_dst, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
+            if (rebase == 0)
+                memcpy(idx_dst, cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
+            else
+                for (int i = 0; i < cmd_list->IdxBuffer.Size; i++)
+                    idx_dst[i] = (ImDrawIdx)(cmd_list->IdxBuffer.Data[i] + rebase);
+
+            g_ListBaseVertex[n] = batch_base;
+            if (uses_vtx_offset)
+                batch_base = global_vtx + cmd_list->VtxBuffer.Size;
+
+            vtx_dst += cmd_list->VtxBuffer.Size;
+            idx_dst += cmd_list->IdxBuffer.Size;
+            global_vtx += cmd_list->VtxBuffer.Size;
+        }
+        ctx->Unmap(g_pVB, 0);
+        ctx->Unmap(g_pIB, 0);
+        g_VertexRingPos += draw_data->TotalVtxCount;
+        g_IndexRingPos += draw_data->TotalIdxCount;
+        g_LastVertexStart = ring_vtx_start;
+        g_LastIndexStart = ring_idx_start;
     }
-    ctx->Unmap(g_pVB, 0);
-    ctx->Unmap(g_pIB, 0);
 
     // Setup orthographic projection matrix into our constant buffer
     // Our visible imgui space lies from draw_data->DisplayPos (top left) to draw_data->DisplayPos+data_data->DisplaySize (bottom right). DisplayPos is (0,0) for single viewport apps.
@@ -218,8 +285,40 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
 
     // Render command lists
     // (Because we merged all buffers into a single one, we maintain our own offset into them)
-    int global_idx_offset = 0;
-    int global_vtx_offset = 0;
+    // Consecutive commands sharing a texture, clip rect and base vertex over adjacent indices go out as one DrawIndexed,
+    // and the scissor rect and texture are only set when they change.
+    struct PENDING_DRAW
+    {
+        ID3D11ShaderResourceView*   Texture;
+        D3D11_RECT                  Clip;
+        UINT                        IdxStart, IdxCount;
+        INT                         BaseVertex;
+    };
+    PENDING_DRAW pending = {};
+    ID3D11ShaderResourceView* bound_texture = NULL;
+    D3D11_RECT bound_clip = {};
+    bool state_bound = false;
+
+    auto flush = [&]()
+    {
+        if (pending.IdxCount == 0)
+            return;
+        if (!state_bound || memcmp(&bound_clip, &pending.Clip, sizeof(D3D11_RECT)) != 0)
+        {
+            ctx->RSSetScissorRects(1, &pending.Clip);
+            bound_clip = pending.Clip;
+        }
+        if (!state_bound || bound_texture != pending.Texture)
+        {
+            ctx->PSSetShaderResources(0, 1, &pending.Texture);
+            bound_texture = pending.Texture;
+        }
+        state_bound = true;
+        ctx->DrawIndexed(pending.IdxCount, pending.IdxStart, pending.BaseVertex);
+        pending.IdxCount = 0;
+    };
+
+    int global_idx_offset = ring_idx_start;
     ImVec2 clip_off = draw_data->DisplayPos;
     for (int n = 0; n < draw_data->CmdListsCount; n++)
     {
@@ -231,26 +330,41 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
             {
                 // User callback, registered via ImDrawList::AddCallback()
                 // (ImDrawCallback_ResetRenderState is a special callback value used by the user to request the renderer to reset render state.)
+                flush();
                 if (pcmd->UserCallback == ImDrawCallback_ResetRenderState)
                     ImGui_ImplDX11_SetupRenderState(draw_data, ctx);
                 else
                     pcmd->UserCallback(cmd_list, pcmd);
+                state_bound = false;
             }
-            else
+            else if (pcmd->ElemCount > 0)
             {
-                // Apply scissor/clipping rectangle
                 const D3D11_RECT r = { (LONG)(pcmd->ClipRect.x - clip_off.x), (LONG)(pcmd->ClipRect.y - clip_off.y), (LONG)(pcmd->ClipRect.z - clip_off.x), (LONG)(pcmd->ClipRect.w - clip_off.y) };
-                ctx->RSSetScissorRects(1, &r);
-
-                // Bind texture, Draw
                 ID3D11ShaderResourceView* texture_srv = (ID3D11ShaderResourceView*)pcmd->TextureId;
-                ctx->PSSetShaderResources(0, 1, &texture_srv);
-                ctx->DrawIndexed(pcmd->ElemCount, pcmd->IdxOffset + global_idx_offset, pcmd->VtxOffset + global_vtx_offset);
+                const UINT idx_start = pcmd->IdxOffset + global_idx_offset;
+                const INT base_vertex = ring_vtx_start + g_ListBaseVertex[n] + pcmd->VtxOffset;
+
+                if (pending.IdxCount > 0
+                    && pending.Texture == texture_srv
+                    && pending.BaseVertex == base_vertex
+                    && pending.IdxStart + pending.IdxCount == idx_start
+                    && memcmp(&pending.Clip, &r, sizeof(D3D11_RECT)) == 0)
+                {
+                    pending.IdxCount += pcmd->ElemCount;
+                    continue;
+                }
+
+                flush();
+                pending.Texture = texture_srv;
+                pending.Clip = r;
+                pending.IdxStart = idx_start;
+                pending.IdxCount = pcmd->ElemCount;
+                pending.BaseVertex = base_vertex;
             }
         }
         global_idx_offset += cmd_list->IdxBuffer.Size;
-        global_vtx_offset += cmd_list->VtxBuffer.Size;
     }
+    flush();
 
     // Restore modified DX state
     ctx->RSSetScissorRects(old.ScissorRectsCount, old.ScissorRects);
@@ -314,7 +428,8 @@ static void ImGui_ImplDX11_CreateFontsTexture()
     // Store our identifier
     io.Fonts->TexID = (ImTextureID)g_pFontTextureView;
 
-    // Create texture sampler
+    // Create texture sampler (kept when only the atlas is re-uploaded)
+    if (!g_pFontSampler)
     {
         D3D11_SAMPLER_DESC desc;
         ZeroMemory(&desc, sizeof(desc));
@@ -330,6 +445,15 @@ static void ImGui_ImplDX11_CreateFontsTexture()
     }
 }
 
+void    ImGui_ImplDX11_UpdateFontsTexture()
+{
+    if (!g_pd3dDevice || !g_pFontSampler)
+        return;
+
+    if (g_pFontTextureView) { g_pFontTextureView->Release(); g_pFontTextureView = NULL; }
+    ImGui_ImplDX11_CreateFontsTexture();
+}
+
 bool    ImGui_ImplDX11_CreateDeviceObjects()
 {
     if (!g_pd3dDevice)
@@ -19,8 +19,11 @@ extern ID3D11Device* g_pd3dDevice;
 IMGUI_IMPL_API bool     ImGui_ImplDX11_Init(ID3D11Device* device, ID3D11DeviceContext* device_context);
 IMGUI_IMPL_API void     ImGui_ImplDX11_Shutdown();
 IMGUI_IMPL_API void     ImGui_ImplDX11_NewFrame();
-IMGUI_IMPL_API void     ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data);
+IMGUI_IMPL_API void     ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data, bool reuse_buffers = false);   // reuse_buffers: draw_data is unchanged since the last call, skip the upload
 
 // Use if you want to reset your rendering device without losing ImGui state.
 IMGUI_IMPL_API void     ImGui_ImplDX11_InvalidateDeviceObjects();
 IMGUI_IMPL_API bool     ImGui_ImplDX11_CreateDeviceObjects();
+
+// Use after replacing io.Fonts with a rebuilt atlas, uploads it and drops the old texture. No-op before the device objects exist.
+IMGUI_IMPL_API void     ImGui_ImplDX11_UpdateFontsTexture();
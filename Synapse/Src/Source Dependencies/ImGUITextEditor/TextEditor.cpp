@@ -45,7 +45,14 @@ TextEditor::TextEditor()
 	, mColorRangeMin(0)
 	, mColorRangeMax(0)
 	, mSelectionMode(SelectionMode::Normal)
-	, mCheckComments(true)
+	, mCommentFrom(0)
+	, mColorDoneMin(0)
+	, mColorDoneMax(0)
+	, mVisibleLineMin(0)
+	, mVisibleLineMax(0)
+	, mColorizeBudget(2000)
+	, mPlainModeThreshold(20000)
+	, mPlainMode(false)
 	, mLastClick(-1.0f)
 {
 	SetPalette(GetDarkPalette());
@@ -651,6 +658,9 @@ void TextEditor::Render()
 	auto globalLineMax = (int)mLines.size();
 	auto lineMax = std::max(0, std::min((int)mLines.size() - 1, lineNo + (int)floor((scrollY + contentSize.y) / mCharAdvance.y)));
 
+	mVisibleLineMin = lineNo;
+	mVisibleLineMax = lineMax;
+
 	// Deduce mTextStart by evaluating mLines size (global lineMax) plus two spaces as text width
 	char buf[16];
 	snprintf(buf, 16, " %d ", globalLineMax);
@@ -883,6 +893,27 @@ void TextEditor::SetText(const std::string & aText)
 	Colorize();
 }
 
+void TextEditor::AppendText(const std::string & aText)
+{
+	const int fromLine = (int)mLines.size() - 1;
+
+	for (auto chr : aText)
+	{
+		if (chr == '\r')
+		{
+			// ignore the carriage return character
+		}
+		else if (chr == '\n')
+			mLines.emplace_back(Line());
+		else
+			mLines.back().emplace_back(Glyph(chr, PaletteIndex::Default));
+	}
+
+	mTextChanged = true;
+
+	Colorize(fromLine, (int)mLines.size() - fromLine);
+}
+
 void TextEditor::SetTextLines(const std::vector<std::string> & aLines)
 {
 	mLines.clear();
@@ -1743,7 +1774,8 @@ void TextEditor::Colorize(int aFromLine, int aLines)
 	mColorRangeMax = std::max(mColorRangeMax, toLine);
 	mColorRangeMin = std::max(0, mColorRangeMin);
 	mColorRangeMax = std::max(mColorRangeMin, mColorRangeMax);
-	mCheckComments = true;
+	mColorDoneMin = mColorDoneMax = 0;
+	mCommentFrom = std::min(mCommentFrom, std::max(0, aFromLine));
 }
 
 void TextEditor::ColorizeRange(int aFromLine, int aToLine)
@@ -1851,124 +1883,185 @@ void TextEditor::ColorizeRange(int aFromLine, int aToLine)
 	}
 }
 
+void TextEditor::ColorizeComments(int aLine, CommentState& aState)
+{
+	auto& line = mLines[aLine];
+
+	if (!aState.mConcatenate)
+	{
+		aState.mWithinSingleLineComment = false;
+		aState.mWithinPreproc = false;
+	}
+
+	auto firstChar = !aState.mConcatenate;	// there is no other non-whitespace characters in the line before
+	aState.mConcatenate = !line.empty() && line.back().mChar == '\\';
+
+	auto pred = [](const char& a, const Glyph& b) { return a == b.mChar; };
+	auto& startStr = mLanguageDefinition.mCommentStart;
+	auto& endStr = mLanguageDefinition.mCommentEnd;
+	auto& singleStartStr = mLanguageDefinition.mSingleLineComment;
+
+	for (int i = 0; i < (int)line.size(); ++i)
+	{
+		auto c = line[i].mChar;
+
+		if (c != mLanguageDefinition.mPreprocChar && !isspace(c))
+			firstChar = false;
+
+		bool inComment = aState.mWithinComment;
+
+		if (aState.mWithinString)
+		{
+			line[i].mMultiLineComment = inComment;
+
+			if (c == '\"')
+			{
+				if (i + 1 < (int)line.size() && line[i + 1].mChar == '\"')
+					line[++i].mMultiLineComment = inComment;
+				else
+					aState.mWithinString = false;
+			}
+			else if (c == '\\')
+			{
+				if (i + 1 < (int)line.size())
+					line[++i].mMultiLineComment = inComment;
+			}
+		}
+		else
+		{
+			if (firstChar && c == mLanguageDefinition.mPreprocChar)
+				aState.mWithinPreproc = true;
+
+			if (c == '\"')
+			{
+				aState.mWithinString = true;
+				line[i].mMultiLineComment = inComment;
+			}
+			else
+			{
+				auto from = line.begin() + i;
+				if (singleStartStr.size() > 0 &&
+					i + singleStartStr.size() <= line.size() &&
+					equals(singleStartStr.begin(), singleStartStr.end(), from, from + singleStartStr.size(), pred))
+					aState.mWithinSingleLineComment = true;
+				else if (!aState.mWithinSingleLineComment && i + startStr.size() <= line.size() &&
+					equals(startStr.begin(), startStr.end(), from, from + startStr.size(), pred))
+					aState.mWithinComment = true;
+
+				inComment = aState.mWithinComment;
+
+				line[i].mMultiLineComment = inComment;
+				line[i].mComment = aState.mWithinSingleLineComment;
+
+				if (i + 1 >= (int)endStr.size() &&
+					equals(endStr.begin(), endStr.end(), from + 1 - endStr.size(), from + 1, pred))
+					aState.mWithinComment = false;
+			}
+		}
+		line[i].mPreprocessor = aState.mWithinPreproc;
+	}
+}
+
 void TextEditor::ColorizeInternal()
 {
 	if (mLines.empty())
 		return;
 
-	if (mCheckComments)
+	// Above the threshold nothing is colorized at all, dropping back under it colorizes everything again
+	const bool plainMode = mPlainModeThreshold > 0 && (int)mLines.size() > mPlainModeThreshold;
+	if (plainMode != mPlainMode)
 	{
-		auto end = Coordinates((int)mLines.size(), 0);
-		auto commentStart = end;
-		auto withinString = false;
-		auto withinSingleLineComment = false;
-		auto withinPreproc = false;
-		auto firstChar = true;			// there is no other non-whitespace characters in the line before
-		auto concatenate = false;		// '\' on the very end of the line
+		mPlainMode = plainMode;
 
-		for (auto currentCoord = Coordinates(0, 0); currentCoord < end; Advance(currentCoord))
+		if (mPlainMode)
 		{
-			auto& line = mLines[currentCoord.mLine];
+			for (auto& line : mLines)
+				for (auto& glyph : line)
+					glyph = Glyph(glyph.mChar, PaletteIndex::Default);
+		}
+		else
+			Colorize();
+	}
 
-			if (currentCoord.mColumn == 0 && !concatenate)
-			{
-				withinSingleLineComment = false;
-				withinPreproc = false;
-				firstChar = true;
-			}
+	if (mPlainMode)
+		return;
 
-			concatenate = false;
+	// Everything below shares one time slice per frame, whatever is left over carries on next frame
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(mColorizeBudget);
+	const int step = (mLanguageDefinition.mTokenize == nullptr) ? 8 : 256;
 
-			if (!line.empty())
-			{
-				auto& g = line[currentCoord.mColumn];
-				auto c = g.mChar;
+	// Comment and string state, resumed from the first line whose starting state changed
+	if (mCommentFrom < (int)mLines.size())
+	{
+		if ((int)mLineStates.size() < (int)mLines.size())
+			mLineStates.resize(mLines.size());
 
-				if (c != mLanguageDefinition.mPreprocChar && !isspace(c))
-					firstChar = false;
+		auto state = mCommentFrom == 0 ? CommentState() : mLineStates[mCommentFrom];
 
-				if (currentCoord.mColumn == line.size() - 1 && line[line.size() - 1].mChar == '\\')
-					concatenate = true;
+		while (mCommentFrom < (int)mLines.size())
+		{
+			mLineStates[mCommentFrom] = state;
+			ColorizeComments(mCommentFrom++, state);
 
-				bool inComment = commentStart <= currentCoord;
+			if ((mCommentFrom % step) == 0 && std::chrono::steady_clock::now() >= deadline)
+				break;
+		}
 
-				if (withinString)
-				{
-					line[currentCoord.mColumn].mMultiLineComment = inComment;
+		if (mCommentFrom < (int)mLines.size())
+			mLineStates[mCommentFrom] = state;
+		else
+			mCommentFrom = std::numeric_limits<int>::max();
+	}
 
-					if (c == '\"')
-					{
-						if (currentCoord.mColumn + 1 < (int)line.size() && line[currentCoord.mColumn + 1].mChar == '\"')
-						{
-							Advance(currentCoord);
-							if (currentCoord.mColumn < (int)line.size())
-								line[currentCoord.mColumn].mMultiLineComment = inComment;
-						}
-						else
-							withinString = false;
-					}
-					else if (c == '\\')
-					{
-						Advance(currentCoord);
-						if (currentCoord.mColumn < (int)line.size())
-							line[currentCoord.mColumn].mMultiLineComment = inComment;
-					}
-				}
-				else
-				{
-					if (firstChar && c == mLanguageDefinition.mPreprocChar)
-						withinPreproc = true;
+	// Dirty lines inside the last rendered viewport go next, the sweep below skips them afterwards.
+	// Token colors depend on the preprocessor flags, so neither runs ahead of the comment pass
+	if (mColorRangeMin < mColorRangeMax)
+	{
+		const int first = std::max(mColorRangeMin, mVisibleLineMin);
+		const int last = std::min(std::min(mColorRangeMax, mVisibleLineMax + 1), mCommentFrom);
 
-					if (c == '\"')
-					{
-						withinString = true;
-						line[currentCoord.mColumn].mMultiLineComment = inComment;
-					}
-					else
-					{
-						auto pred = [](const char& a, const Glyph& b) { return a == b.mChar; };
-						auto from = line.begin() + currentCoord.mColumn;
-						auto& startStr = mLanguageDefinition.mCommentStart;
-						auto& singleStartStr = mLanguageDefinition.mSingleLineComment;
-						if (singleStartStr.size() > 0 &&
-							currentCoord.mColumn + singleStartStr.size() <= line.size() &&
-							equals(singleStartStr.begin(), singleStartStr.end(), from, from + singleStartStr.size(), pred))
-							withinSingleLineComment = true;
-						else if (!withinSingleLineComment && currentCoord.mColumn + startStr.size() <= line.size() &&
-							equals(startStr.begin(), startStr.end(), from, from + startStr.size(), pred))
-							commentStart = currentCoord;
-
-						inComment = commentStart <= currentCoord;
-
-						line[currentCoord.mColumn].mMultiLineComment = inComment;
-						line[currentCoord.mColumn].mComment = withinSingleLineComment;
-
-						auto& endStr = mLanguageDefinition.mCommentEnd;
-						if (currentCoord.mColumn + 1 >= (int)endStr.size() &&
-							equals(endStr.begin(), endStr.end(), from + 1 - endStr.size(), from + 1, pred))
-							commentStart = end;
-					}
-				}
-				line[currentCoord.mColumn].mPreprocessor = withinPreproc;
+		if (first < last && !(first >= mColorDoneMin && last <= mColorDoneMax))
+		{
+			ColorizeRange(first, last);
+
+			if (first == mColorRangeMin)
+				mColorRangeMin = last;
+			else if (last == mColorRangeMax)
+				mColorRangeMax = first;
+			else
+			{
+				mColorDoneMin = first;
+				mColorDoneMax = last;
 			}
 		}
-		mCheckComments = false;
-		return;
 	}
 
-	if (mColorRangeMin < mColorRangeMax)
+	while (mColorRangeMin < mColorRangeMax)
 	{
-		const int increment = (mLanguageDefinition.mTokenize == nullptr) ? 10 : 10000;
-		const int to = std::min(mColorRangeMin + increment, mColorRangeMax);
+		if (mColorRangeMin >= mColorDoneMin && mColorRangeMin < mColorDoneMax)
+		{
+			mColorRangeMin = mColorDoneMax;
+			continue;
+		}
+
+		int to = std::min(std::min(mColorRangeMin + step, mColorRangeMax), mCommentFrom);
+		if (mColorRangeMin < mColorDoneMin)
+			to = std::min(to, mColorDoneMin);
+		if (to <= mColorRangeMin)
+			break;
+
 		ColorizeRange(mColorRangeMin, to);
 		mColorRangeMin = to;
 
-		if (mColorRangeMax == mColorRangeMin)
-		{
-			mColorRangeMin = std::numeric_limits<int>::max();
-			mColorRangeMax = 0;
-		}
-		return;
+		if (std::chrono::steady_clock::now() >= deadline)
+			break;
+	}
+
+	if (mColorRangeMin >= mColorRangeMax)
+	{
+		mColorRangeMin = std::numeric_limits<int>::max();
+		mColorRangeMax = 0;
+		mColorDoneMin = mColorDoneMax = 0;
 	}
 }
 
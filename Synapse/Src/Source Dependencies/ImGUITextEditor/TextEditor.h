@@ -188,6 +188,7 @@ public:
 	void Render(const char* aTitle, const ImVec2& aSize = ImVec2(), bool aBorder = false);
 	void SetText(const std::string& aText);
 	void SetTextLines(const std::vector<std::string>& aLines);
+	void AppendText(const std::string& aText);	// adds to the end, leaves the cursor and undo buffer alone
 	std::string GetText() const;
 	std::vector<std::string> GetTextLines() const;
 	std::string GetSelectedText() const;
@@ -201,6 +202,14 @@ public:
 	bool IsTextChanged() const { return mTextChanged; }
 	bool IsCursorPositionChanged() const { return mCursorPositionChanged; }
 
+	// Texts with more lines than this are shown uncolored, 0 always colorizes
+	void SetPlainModeThreshold(int aLines) { mPlainModeThreshold = aLines; }
+	int GetPlainModeThreshold() const { return mPlainModeThreshold; }
+	bool IsPlainMode() const { return mPlainMode; }
+
+	// Microseconds per frame spent colorizing, the rest is picked up on later frames
+	void SetColorizeBudget(int aMicroseconds) { mColorizeBudget = aMicroseconds; }
+
 	Coordinates GetCursorPosition() const { return GetActualCursorCoordinates(); }
 	void SetCursorPosition(const Coordinates& aPosition);
 
@@ -282,10 +291,21 @@ private:
 
 	typedef std::vector<UndoRecord> UndoBuffer;
 
+	// Comment/string/preprocessor state at the start of a line, lets the comment pass resume mid-document
+	struct CommentState
+	{
+		bool mWithinComment = false;
+		bool mWithinString = false;
+		bool mWithinSingleLineComment = false;
+		bool mWithinPreproc = false;
+		bool mConcatenate = false;		// '\' on the very end of the previous line
+	};
+
 	void ProcessInputs();
 	void Colorize(int aFromLine = 0, int aCount = -1);
 	void ColorizeRange(int aFromLine = 0, int aToLine = 0);
 	void ColorizeInternal();
+	void ColorizeComments(int aLine, CommentState& aState);
 	float TextDistanceToLineStart(const Coordinates& aFrom) const;
 	void EnsureCursorVisible();
 	int GetPageSize() const;
@@ -339,7 +359,13 @@ private:
 	LanguageDefinition mLanguageDefinition;
 	RegexList mRegexList;
 
-	bool mCheckComments;
+	int mCommentFrom;                    // first line whose comment state is stale
+	std::vector<CommentState> mLineStates;
+	int mColorDoneMin, mColorDoneMax;    // viewport lines already colorized inside the dirty range
+	int mVisibleLineMin, mVisibleLineMax;
+	int mColorizeBudget;
+	int mPlainModeThreshold;
+	bool mPlainMode;
 	Breakpoints mBreakpoints;
 	ErrorMarkers mErrorMarkers;
 	ImVec2 mCharAdvance;
@@ -9,6 +9,13 @@
 #include <locale.h>
 #include <string.h>
 
+/* -- Synapse Change -- */
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#include <emmintrin.h>
+#define LEX_SSE2
+#endif
+/* -- Synapse Change -- */
+
 #define llex_c
 #define LUA_CORE
 
@@ -61,6 +68,63 @@ static void save (LexState *ls, int c) {
 }
 
 
+/* -- Synapse Change -- */
+static void save_span (LexState *ls, const char *s, size_t l) {
+  Mbuffer *b = ls->buff;
+  if (b->n + l > b->buffsize) {
+    size_t newsize = b->buffsize;
+    do {
+      if (newsize >= MAX_SIZET/2)
+        luaX_lexerror(ls, "lexical element too long", 0);
+      newsize *= 2;
+    } while (b->n + l > newsize);
+    luaZ_resizebuffer(ls->L, b, newsize);
+  }
+  memcpy(b->buffer + b->n, s, l);
+  b->n += l;
+}
+
+
+/*
+** length of the run at `p' holding none of the bytes long strings and
+** comments stop at, so it can be taken out of the zio buffer in one go
+*/
+static size_t plain_span (const char *p, size_t n) {
+  size_t i = 0;
+#if defined(LEX_SSE2)
+  const __m128i rb = _mm_set1_epi8(']'), lb = _mm_set1_epi8('[');
+  const __m128i nl = _mm_set1_epi8('\n'), cr = _mm_set1_epi8('\r');
+  for (; i + 16 <= n; i += 16) {
+    const __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+    const __m128i m = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(v, rb), _mm_cmpeq_epi8(v, lb)),
+      _mm_or_si128(_mm_cmpeq_epi8(v, nl), _mm_cmpeq_epi8(v, cr)));
+    if (_mm_movemask_epi8(m)) break;  /* the byte loop finds which one */
+  }
+#endif
+  for (; i < n; i++) {
+    const char c = p[i];
+    if (c == ']' || c == '[' || c == '\n' || c == '\r') break;
+  }
+  return i;
+}
+
+
+/* skip (and save, when `keep') the plain run following `current' */
+static void skip_plain (LexState *ls, int keep) {
+  ZIO *z = ls->z;
+  const size_t l = plain_span(z->p, z->n);
+  if (keep) {
+    save(ls, ls->current);
+    save_span(ls, z->p, l);
+  }
+  z->p += l;
+  z->n -= l;
+  next(ls);
+}
+/* -- Synapse Change -- */
+
+
 void luaX_init (lua_State *L) {
   int i;
   for (i=0; i<NUM_RESERVED; i++) {
@@ -264,8 +328,9 @@ static void read_long_string (LexState *ls, SemInfo *seminfo, int sep) {
         break;
       }
       default: {
-        if (seminfo) save_and_next(ls);
-        else next(ls);
+        /* -- Synapse Change -- */
+        skip_plain(ls, seminfo != NULL);
+        /* -- Synapse Change -- */
       }
     }
   } endloop:
@@ -356,7 +421,7 @@ static int llex (LexState *ls, SemInfo *seminfo) {
         }
         /* else short comment */
         while (!currIsNewline(ls) && ls->current != EOZ)
-          next(ls);
+          skip_plain(ls, 0);  /* -- Synapse Change -- */
         continue;
       }
       case '[': {
@@ -35,6 +35,7 @@ class Session::Impl {
     void SetBody(const Body& body);
     void SetLowSpeed(const LowSpeed& low_speed);
     void SetVerifySsl(const VerifySsl& verify);
+    void Reset();
 
     Response Delete();
     Response Get();
@@ -51,6 +52,7 @@ class Session::Impl {
     Proxies proxies_;
 
     Response makeRequest(CURL* curl);
+    static void setDefaults(CURL* curl);
     static void freeHolder(CurlHolder* holder);
     static CurlHolder* newHolder();
 };
@@ -60,26 +62,34 @@ Session::Impl::Impl() {
                                                                           &Impl::freeHolder);
     auto curl = curl_->handle;
     if (curl) {
-        // Set up some sensible defaults
-        auto version_info = curl_version_info(CURLVERSION_NOW);
-        auto version = std::string{"curl/"} + std::string{version_info->version};
-        curl_easy_setopt(curl, CURLOPT_USERAGENT, version.data());
-        curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1L);
-        curl_easy_setopt(curl, CURLOPT_MAXREDIRS, 50L);
+        setDefaults(curl);
         curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, curl_->error);
-        curl_easy_setopt(curl, CURLOPT_COOKIEFILE, "");
+    }
+}
+
+void Session::Impl::setDefaults(CURL* curl) {
+    // Set up some sensible defaults
+    auto version_info = curl_version_info(CURLVERSION_NOW);
+    auto version = std::string{"curl/"} + std::string{version_info->version};
+    curl_easy_setopt(curl, CURLOPT_USERAGENT, version.data());
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1L);
+    curl_easy_setopt(curl, CURLOPT_MAXREDIRS, 50L);
+    curl_easy_setopt(curl, CURLOPT_COOKIEFILE, "");
 #ifdef CPR_CURL_NOSIGNAL
-        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
 #endif
 #if LIBCURL_VERSION_MAJOR >= 7
 #if LIBCURL_VERSION_MINOR >= 25
 #if LIBCURL_VERSION_PATCH >= 0
-        curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
 #endif
 #endif
 #endif
-    }
+#if LIBCURL_VERSION_NUM >= 0x072F00
+    // Negotiate HTTP/2 over TLS where the server (and our libcurl build) supports it
+    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, (long) CURL_HTTP_VERSION_2TLS);
+#endif
 }
 
 void Session::Impl::freeHolder(CurlHolder* holder) {
@@ -97,6 +107,26 @@ CurlHolder* Session::Impl::newHolder() {
     return holder;
 }
 
+void Session::Impl::Reset() {
+    auto curl = curl_->handle;
+    if (curl) {
+        // Live connections, the DNS cache and TLS session ids survive the reset
+        curl_easy_reset(curl);
+        setDefaults(curl);
+        curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, curl_->error);
+        curl_easy_setopt(curl, CURLOPT_COOKIELIST, "ALL");
+    }
+
+    curl_slist_free_all(curl_->chunk);
+    curl_->chunk = NULL;
+    curl_formfree(curl_->formpost);
+    curl_->formpost = NULL;
+
+    url_ = Url{};
+    parameters_ = Parameters{};
+    proxies_ = Proxies{};
+}
+
 void Session::Impl::SetUrl(const Url& url) {
     url_ = url;
 }
@@ -445,6 +475,7 @@ void Session::SetBody(const Body& body) { pimpl_->SetBody(body); }
 void Session::SetBody(Body&& body) { pimpl_->SetBody(std::move(body)); }
 void Session::SetLowSpeed(const LowSpeed& low_speed) { pimpl_->SetLowSpeed(low_speed); }
 void Session::SetVerifySsl(const VerifySsl& verify) { pimpl_->SetVerifySsl(verify); }
+void Session::Reset() { pimpl_->Reset(); }
 void Session::SetOption(const Url& url) { pimpl_->SetUrl(url); }
 void Session::SetOption(const Parameters& parameters) { pimpl_->SetParameters(parameters); }
 void Session::SetOption(Parameters&& parameters) { pimpl_->SetParameters(std::move(parameters)); }
@@ -47,6 +47,9 @@ class Session {
     void SetLowSpeed(const LowSpeed& low_speed);
     void SetVerifySsl(const VerifySsl& verify);
 
+    // Clears all per-request state but keeps the connection cache for reuse
+    void Reset();
+
     // Used in templated functions
     void SetOption(const Url& url);
     void SetOption(const Parameters& parameters);
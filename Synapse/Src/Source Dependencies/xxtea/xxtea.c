@@ -257,4 +257,55 @@ void* xxtea_encrypt(const void* data, size_t len, const void* key, size_t * out_
 void* xxtea_decrypt(const void* data, size_t len, const void* key, size_t * out_len) {
 	FIXED_KEY
 		return xxtea_ubyte_decrypt((const uint8_t*)data, len, fixed_key, out_len);
+}
+
+size_t xxtea_encrypt_size(size_t len) {
+	return ((((len & 3) == 0) ? (len >> 2) : ((len >> 2) + 1)) + 1) << 2;
+}
+
+#if !(defined(BYTE_ORDER) && (BYTE_ORDER == LITTLE_ENDIAN))
+static void xxtea_swap_uint_array(uint32_t * data, size_t len, int to_uint) {
+	size_t i;
+	uint8_t* b;
+
+	for (i = 0; i < len; ++i) {
+		b = (uint8_t*)&data[i];
+		if (to_uint) {
+			data[i] = (uint32_t)b[0] | (uint32_t)b[1] << 8 | (uint32_t)b[2] << 16 | (uint32_t)b[3] << 24;
+		}
+		else {
+			uint32_t v = data[i];
+			b[0] = (uint8_t)v; b[1] = (uint8_t)(v >> 8); b[2] = (uint8_t)(v >> 16); b[3] = (uint8_t)(v >> 24);
+		}
+	}
+}
+#endif
+
+size_t xxtea_encrypt_inplace(void* data, size_t len, const void* key) {
+	uint32_t* data_array = (uint32_t*)data;
+	uint32_t key_array[4];
+	size_t n, out_len;
+	FIXED_KEY
+
+	if (!len) return 0;
+
+	out_len = xxtea_encrypt_size(len);
+	n = (out_len >> 2) - 1;
+
+	/* Zero the padding, the trailing word carries the plain length like xxtea_to_uint_array */
+	memset((uint8_t*)data + len, 0, out_len - len);
+	memcpy(key_array, fixed_key, 16);
+
+#if defined(BYTE_ORDER) && (BYTE_ORDER == LITTLE_ENDIAN)
+	data_array[n] = (uint32_t)len;
+	xxtea_uint_encrypt(data_array, n + 1, key_array);
+#else
+	xxtea_swap_uint_array(data_array, n, 1);
+	xxtea_swap_uint_array(key_array, 4, 1);
+	data_array[n] = (uint32_t)len;
+	xxtea_uint_encrypt(data_array, n + 1, key_array);
+	xxtea_swap_uint_array(data_array, n + 1, 0);
+#endif
+
+	return out_len;
 }
\ No newline at end of file
@@ -47,6 +47,24 @@ extern "C" {
 	 */
 	void* xxtea_decrypt(const void* data, size_t len, const void* key, size_t* out_len);
 
+	/**
+	 * Function: xxtea_encrypt_size
+	 * @len:     Length of the data to be encrypted
+	 * Returns:  Length of the encrypted data, the buffer size xxtea_encrypt_inplace needs
+	 */
+	size_t xxtea_encrypt_size(size_t len);
+
+	/**
+	 * Function: xxtea_encrypt_inplace
+	 * @data:    Data to be encrypted, 4 byte aligned and xxtea_encrypt_size(len) bytes large
+	 * @len:     Length of the data to be encrypted
+	 * @key:     Symmetric key
+	 * Returns:  Length of the encrypted data or 0 on failure
+	 *
+	 * Writes the same output as xxtea_encrypt without allocating.
+	 */
+	size_t xxtea_encrypt_inplace(void* data, size_t len, const void* key);
+
 #ifdef __cplusplus
 }
 #endif
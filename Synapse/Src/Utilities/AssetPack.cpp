@@ -0,0 +1,201 @@
+#include "./AssetPack.hpp"
+#include "./Compression.hpp"
+
+#define XXH_STATIC_LINKING_ONLY
+#include "./Hashing/XXHash/xxhash.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+
+namespace syn
+{
+	std::string AssetPack::Normalize(std::string Path)
+	{
+		for (auto& C : Path)
+			C = C == '/' ? '\\' : (char) std::tolower((unsigned char) C);
+		return Path;
+	}
+
+	std::uint64_t AssetPack::HashOf(const std::string& Key)
+	{
+		return XXH3_64bits(Key.data(), Key.size());
+	}
+
+	bool AssetPack::Open(const std::wstring& Path)
+	{
+		auto Mapped = std::make_unique<MappedFile>(Path);
+		if (!Mapped->Valid() || Mapped->Size() < sizeof(Header))
+			return false;
+
+		const auto Base = Mapped->Data();
+		const auto Size = Mapped->Size();
+
+		Header H;
+		memcpy(&H, Base, sizeof(H));
+		if (memcmp(H.Magic, Magic, sizeof(Magic)) != 0 || H.Version != Version)
+			return false;
+
+		if (H.Count > (Size - sizeof(Header)) / sizeof(IndexEntry))
+			return false;
+
+		/* Checked once here so lookups can trust every offset */
+		const auto Entries = (const IndexEntry*) (Base + sizeof(Header));
+		for (std::uint32_t i = 0; i < H.Count; i++)
+		{
+			const auto& E = Entries[i];
+			if ((std::uint64_t) E.NameOffset + E.NameSize > Size || (std::uint64_t) E.DataOffset + E.DataSize > Size)
+				return false;
+			if (i && Entries[i - 1].Hash > E.Hash)
+				return false;
+		}
+
+		File = std::move(Mapped);
+		Index = Entries;
+		Count = H.Count;
+		return true;
+	}
+
+	bool AssetPack::Find(const std::string& Key, const char*& Data, size_t& Size) const
+	{
+		const auto Hash = HashOf(Key);
+		const auto Base = File->Data();
+
+		auto Found = std::lower_bound(Index, Index + Count, Hash, [](const IndexEntry& E, const std::uint64_t H) { return E.Hash < H; });
+		for (; Found != Index + Count && Found->Hash == Hash; Found++)
+		{
+			if (Found->NameSize != Key.size() || memcmp(Base + Found->NameOffset, Key.data(), Key.size()) != 0)
+				continue;
+
+			Data = Base + Found->DataOffset;
+			Size = Found->DataSize;
+			return true;
+		}
+
+		return false;
+	}
+
+	bool AssetPack::Build(const std::wstring& Path, const std::vector<std::pair<std::string, std::string>>& Files, const int Level)
+	{
+		struct Pending
+		{
+			std::string Key;
+			std::string Blob;
+			std::uint64_t Hash;
+		};
+
+		/* Later duplicates win, the same as writing the files one after another would */
+		std::vector<Pending> Sorted;
+		Sorted.reserve(Files.size());
+		for (const auto& [Name, Contents] : Files)
+		{
+			Pending P;
+			P.Key = Normalize(Name);
+			P.Hash = HashOf(P.Key);
+
+			const auto Existing = std::find_if(Sorted.begin(), Sorted.end(), [&P](const Pending& O) { return O.Key == P.Key; });
+			auto& Target = Existing != Sorted.end() ? *Existing : Sorted.emplace_back(std::move(P));
+
+			Target.Blob = Contents;
+			if (Level)
+			{
+				auto Compressed = Compression::Compress(Contents.data(), Contents.size(), Level);
+				if (Compressed.size() < Contents.size())
+					Target.Blob = std::move(Compressed);
+			}
+		}
+
+		std::sort(Sorted.begin(), Sorted.end(), [](const Pending& A, const Pending& B) { return A.Hash < B.Hash; });
+
+		std::uint64_t Offset = sizeof(Header) + Sorted.size() * sizeof(IndexEntry);
+		std::vector<IndexEntry> Entries(Sorted.size());
+		for (size_t i = 0; i < Sorted.size(); i++)
+		{
+			Entries[i].Hash = Sorted[i].Hash;
+			Entries[i].NameOffset = (std::uint32_t) Offset;
+			Entries[i].NameSize = (std::uint32_t) Sorted[i].Key.size();
+			Offset += Sorted[i].Key.size();
+		}
+
+		for (size_t i = 0; i < Sorted.size(); i++)
+		{
+			Entries[i].DataOffset = (std::uint32_t) Offset;
+			Entries[i].DataSize = (std::uint32_t) Sorted[i].Blob.size();
+			Offset += Sorted[i].Blob.size();
+		}
+
+		/* MappedFile won't open anything past 4GB */
+		if (Offset > UINT32_MAX)
+			return false;
+
+		Header H;
+		memcpy(H.Magic, Magic, sizeof(Magic));
+		H.Version = Version;
+		H.Count = (std::uint32_t) Sorted.size();
+
+		std::ofstream Out(Path, std::ios_base::binary | std::ios_base::trunc);
+		if (!Out)
+			return false;
+
+		Out.write((const char*) &H, sizeof(H));
+		Out.write((const char*) Entries.data(), Entries.size() * sizeof(IndexEntry));
+		for (const auto& P : Sorted)
+			Out.write(P.Key.data(), P.Key.size());
+		for (const auto& P : Sorted)
+			Out.write(P.Blob.data(), P.Blob.size());
+
+		return Out.good();
+	}
+
+	bool AssetPacks::Mount(const std::wstring& Path, const std::string& Point)
+	{
+		auto Pack = std::make_shared<AssetPack>();
+		if (!Pack->Open(Path))
+			return false;
+
+		auto Prefix = AssetPack::Normalize(Point);
+		while (!Prefix.empty() && Prefix.back() == '\\')
+			Prefix.pop_back();
+		if (!Prefix.empty())
+			Prefix.push_back('\\');
+
+		std::unique_lock<std::shared_mutex> Lock(Mutex);
+
+		Mounts.erase(std::remove_if(Mounts.begin(), Mounts.end(), [&Path](const Mounted& M) { return _wcsicmp(M.Path.c_str(), Path.c_str()) == 0; }), Mounts.end());
+		Mounts.push_back({ Path, std::move(Prefix), std::move(Pack) });
+		Count.store(Mounts.size(), std::memory_order_release);
+		return true;
+	}
+
+	bool AssetPacks::Unmount(const std::wstring& Path)
+	{
+		std::unique_lock<std::shared_mutex> Lock(Mutex);
+
+		const auto Before = Mounts.size();
+		Mounts.erase(std::remove_if(Mounts.begin(), Mounts.end(), [&Path](const Mounted& M) { return _wcsicmp(M.Path.c_str(), Path.c_str()) == 0; }), Mounts.end());
+		Count.store(Mounts.size(), std::memory_order_release);
+		return Mounts.size() != Before;
+	}
+
+	AssetPacks::Holder AssetPacks::Find(const std::string& Path, const char*& Data, size_t& Size)
+	{
+		if (Count.load(std::memory_order_acquire) == 0)
+			return nullptr;
+
+		const auto Key = AssetPack::Normalize(Path);
+
+		std::shared_lock<std::shared_mutex> Lock(Mutex);
+
+		for (auto M = Mounts.rbegin(); M != Mounts.rend(); ++M)
+		{
+			if (Key.compare(0, M->Point.size(), M->Point) != 0)
+				continue;
+
+			if (M->Pack->Find(Key.substr(M->Point.size()), Data, Size))
+				return M->Pack;
+		}
+
+		return nullptr;
+	}
+}
@@ -0,0 +1,107 @@
+
+/*
+*
+*	SYNAPSE X
+*	File.:	AssetPack.hpp
+*	Desc.:	Read-only workspace file packs, mapped once and looked up by path hash
+*
+*/
+
+#pragma once
+
+#include "../Exploit/Misc/Static.hpp"
+#include "./Utils.hpp"
+
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace syn
+{
+	/* "SYNP", version, entry count, the index sorted by path hash, the names and then the blobs. A blob is the file as
+	   is or a Compression frame, readers inflate frames the same way they do for files written compressed */
+	class AssetPack
+	{
+	public:
+		static constexpr std::uint32_t Version = 1;
+
+		/* Maps the pack, false if it isn't one or anything in its index points past the end */
+		bool Open(const std::wstring& Path);
+
+		/* Blob stored under a key from Normalize, pointing into the mapping */
+		bool Find(const std::string& Key, const char*& Data, size_t& Size) const;
+
+		/* Packs (path, contents) pairs, each one deflated at Level when that makes it smaller, 0 stores them as is */
+		static bool Build(const std::wstring& Path, const std::vector<std::pair<std::string, std::string>>& Files, int Level);
+
+		/* Workspace paths are case insensitive and scripts mix both separators */
+		static std::string Normalize(std::string Path);
+
+	private:
+#pragma pack(push, 1)
+		struct Header
+		{
+			char Magic[4];
+			std::uint32_t Version;
+			std::uint32_t Count;
+		};
+
+		struct IndexEntry
+		{
+			std::uint64_t Hash;
+			std::uint32_t NameOffset;
+			std::uint32_t NameSize;
+			std::uint32_t DataOffset;
+			std::uint32_t DataSize;
+		};
+#pragma pack(pop)
+
+		static constexpr char Magic[4] = { 'S', 'Y', 'N', 'P' };
+
+		static std::uint64_t HashOf(const std::string& Key);
+
+		std::unique_ptr<MappedFile> File;
+		const IndexEntry* Index = nullptr;
+		std::uint32_t Count = 0;
+	};
+
+	/* Packs mounted into the workspace, readfile, loadfile and isfile look here before they go to the disk. The last
+	   pack mounted wins where several hold the same path */
+	class AssetPacks
+	{
+	public:
+		static AssetPacks* GetSingleton()
+		{
+			static AssetPacks* Singleton = nullptr;
+			if (Singleton == nullptr)
+				Singleton = new AssetPacks();
+			return Singleton;
+		}
+
+		typedef std::shared_ptr<const AssetPack> Holder;
+
+		/* Mounts the pack at Path under the workspace relative folder Point, mounting it again replaces it */
+		bool Mount(const std::wstring& Path, const std::string& Point);
+
+		bool Unmount(const std::wstring& Path);
+
+		/* Data stays valid while the returned holder is, null if no pack has the file */
+		Holder Find(const std::string& Path, const char*& Data, size_t& Size);
+
+	private:
+		struct Mounted
+		{
+			std::wstring Path;
+			std::string Point;
+			Holder Pack;
+		};
+
+		std::shared_mutex Mutex;
+		std::vector<Mounted> Mounts;
+
+		/* Lets lookups skip the lock and the key building while nothing is mounted */
+		std::atomic<size_t> Count{ 0 };
+	};
+}
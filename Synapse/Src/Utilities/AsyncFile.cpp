@@ -0,0 +1,130 @@
+#include "./AsyncFile.hpp"
+
+namespace syn
+{
+	void AsyncFile::ReadBatch(std::vector<FileOp>& Ops)
+	{
+		Perform(Ops, false);
+	}
+
+	void AsyncFile::WriteBatch(std::vector<FileOp>& Ops)
+	{
+		Perform(Ops, true);
+	}
+
+	void AsyncFile::Perform(std::vector<FileOp>& Ops, const bool Write)
+	{
+		struct Pending
+		{
+			OVERLAPPED Overlapped{};
+			HANDLE File = INVALID_HANDLE_VALUE;
+			FileOp* Op = nullptr;
+		};
+
+		const auto Port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 0);
+		if (!Port)
+		{
+			const auto Error = GetLastError();
+			for (auto& Op : Ops)
+				Op.Error = Error;
+			return;
+		}
+
+		std::vector<Pending> Requests(Ops.size());
+		size_t InFlight = 0;
+
+		for (size_t i = 0; i < Ops.size(); i++)
+		{
+			auto& Op = Ops[i];
+			auto& Req = Requests[i];
+			Req.Op = &Op;
+
+			Req.File = CreateFileW(Op.Path.c_str(), Write ? GENERIC_WRITE : GENERIC_READ, Write ? 0 : FILE_SHARE_READ | FILE_SHARE_WRITE,
+				NULL, Write ? CREATE_ALWAYS : OPEN_EXISTING, FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+			if (Req.File == INVALID_HANDLE_VALUE)
+			{
+				Op.Error = GetLastError();
+				continue;
+			}
+
+			if (!Write)
+			{
+				LARGE_INTEGER Size;
+				if (!GetFileSizeEx(Req.File, &Size) || Size.HighPart)
+				{
+					Op.Error = Size.HighPart ? ERROR_FILE_TOO_LARGE : GetLastError();
+					continue;
+				}
+
+				Op.Data.resize(Size.LowPart);
+			}
+
+			/* Nothing to transfer, CreateFile already did the work */
+			if (Op.Data.empty())
+			{
+				Op.Success = true;
+				continue;
+			}
+
+			if (!CreateIoCompletionPort(Req.File, Port, (ULONG_PTR) &Req, 0))
+			{
+				Op.Error = GetLastError();
+				continue;
+			}
+
+			const auto Issued = Write
+				? WriteFile(Req.File, Op.Data.data(), (DWORD) Op.Data.size(), NULL, &Req.Overlapped)
+				: ReadFile(Req.File, Op.Data.data(), (DWORD) Op.Data.size(), NULL, &Req.Overlapped);
+
+			/* Synchronous completions still post a packet, only real failures don't */
+			if (!Issued && GetLastError() != ERROR_IO_PENDING)
+			{
+				Op.Error = GetLastError();
+				continue;
+			}
+
+			InFlight++;
+		}
+
+		OVERLAPPED_ENTRY Entries[64];
+		while (InFlight)
+		{
+			ULONG Count = 0;
+			if (!GetQueuedCompletionStatusEx(Port, Entries, _countof(Entries), &Count, INFINITE, FALSE))
+				break;
+
+			for (ULONG i = 0; i < Count; i++)
+			{
+				auto Req = (Pending*) Entries[i].lpCompletionKey;
+
+				DWORD Transferred;
+				if (!GetOverlappedResult(Req->File, &Req->Overlapped, &Transferred, FALSE))
+					Req->Op->Error = GetLastError();
+				else if (Transferred != Req->Op->Data.size())
+					Req->Op->Error = ERROR_HANDLE_EOF;
+				else
+					Req->Op->Success = true;
+
+				InFlight--;
+			}
+		}
+
+		for (auto& Req : Requests)
+		{
+			if (Req.File == INVALID_HANDLE_VALUE)
+				continue;
+
+			/* Only reachable if the port wait failed, the buffers must outlive the kernel's use of them */
+			DWORD Transferred;
+			if (InFlight && CancelIoEx(Req.File, &Req.Overlapped))
+				GetOverlappedResult(Req.File, &Req.Overlapped, &Transferred, TRUE);
+
+			CloseHandle(Req.File);
+
+			if (!Req.Op->Success && !Write)
+				Req.Op->Data.clear();
+		}
+
+		CloseHandle(Port);
+	}
+}
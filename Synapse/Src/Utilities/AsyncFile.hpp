@@ -0,0 +1,38 @@
+
+/*
+*
+*	SYNAPSE X
+*	File.:	AsyncFile.hpp
+*	Desc.:	Batched overlapped file I/O on a completion port
+*
+*/
+
+#pragma once
+
+#include "../Exploit/Misc/Static.hpp"
+
+#include <vector>
+
+namespace syn
+{
+	struct FileOp
+	{
+		std::wstring Path;
+		std::string Data;
+		bool Success = false;
+		DWORD Error = 0;
+	};
+
+	class AsyncFile
+	{
+	public:
+		/* Issues every read at once and waits for all of them, Data receives the file contents */
+		static void ReadBatch(std::vector<FileOp>& Ops);
+
+		/* Same as ReadBatch, but truncates each file and writes Data to it */
+		static void WriteBatch(std::vector<FileOp>& Ops);
+
+	private:
+		static void Perform(std::vector<FileOp>& Ops, bool Write);
+	};
+}
@@ -1,5 +1,7 @@
 #include "./Buffer.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <iomanip> // byteStr()
 
 /************************* WRITING *************************/
@@ -23,6 +25,22 @@ void Buffer::clear() noexcept {
 	readOffset = 0;
 	writeOffset = 0;
 }
+void Buffer::reserve(size_t size) noexcept {
+	buffer.reserve(size);
+}
+
+const unsigned char *Buffer::data() const noexcept {
+	return buffer.data();
+}
+unsigned char *Buffer::data() noexcept {
+	return buffer.data();
+}
+void Buffer::resize(size_t size) noexcept {
+	buffer.resize(size);
+}
+size_t Buffer::size() const noexcept {
+	return buffer.size();
+}
 
 std::string Buffer::byteStr(bool LE) const noexcept {
 	std::stringstream byteStr;
@@ -43,13 +61,13 @@ std::string Buffer::byteStr(bool LE) const noexcept {
 
 template <class T> inline void Buffer::writeBytes(const T &val, bool LE) {
 	unsigned int size = sizeof(T);
+	unsigned const char *array = reinterpret_cast<unsigned const char*>(&val);
 
+	// x86 is little endian, so LE is the in-memory layout
 	if (LE == true) {
-		for (unsigned int i = 0, mask = 0; i < size; ++i, mask += 8)
-			buffer.push_back(val >> mask);
+		buffer.insert(buffer.end(), array, array + size);
 	}
 	else {
-		unsigned const char *array = reinterpret_cast<unsigned const char*>(&val);
 		for (unsigned int i = 0; i < size; ++i)
 			buffer.push_back(array[size - i - 1]);
 	}
@@ -60,11 +78,32 @@ unsigned long long Buffer::getWriteOffset() const noexcept {
 	return writeOffset;
 }
 
+void Buffer::writeRaw(const void *data, size_t size) noexcept {
+	const auto bytes = static_cast<const unsigned char*>(data);
+	buffer.insert(buffer.end(), bytes, bytes + size);
+	writeOffset += size;
+}
+void Buffer::writeRep(const void *data, size_t size, size_t count) noexcept {
+	if (size == 0 || count == 0)
+		return;
+
+	const auto start = buffer.size();
+	buffer.resize(start + size * count);
+
+	// Copy once, then keep doubling what's already written
+	unsigned char *out = buffer.data() + start;
+	memcpy(out, data, size);
+	for (size_t done = size, total = size * count; done < total; done *= 2)
+		memcpy(out + done, out, (std::min)(done, total - done));
+
+	writeOffset += size * count;
+}
+
 void Buffer::writeBool(bool val) noexcept {
 	writeBytes<bool>(val);
 }
 void Buffer::writeStr(const std::string &str) noexcept {
-	for (const unsigned char &s : str) writeInt8(s);
+	writeRaw(str.data(), str.size());
 }
 void Buffer::writeInt8(char val) noexcept {
 	writeBytes<char>(val);
@@ -10,6 +10,12 @@ public:
 	void setBuffer(std::vector<unsigned char>&) noexcept;
 	const std::vector<unsigned char> &getBuffer() const noexcept;
 	void clear() noexcept;
+	void reserve(size_t) noexcept;
+
+	const unsigned char* data() const noexcept;
+	unsigned char* data() noexcept;
+	size_t size() const noexcept;
+	void resize(size_t) noexcept;
 
 	std::string byteStr(bool LE = true) const noexcept;
 
@@ -18,6 +24,10 @@ public:
 	template <class T> inline void writeBytes(const T &val, bool LE = true);
 	unsigned long long getWriteOffset() const noexcept;
 
+	// Bulk appends, one memcpy instead of a push_back per byte
+	void writeRaw(const void*, size_t) noexcept;
+	void writeRep(const void*, size_t, size_t count) noexcept;
+
 	void writeBool(bool) noexcept;
 	void writeStr(const std::string&) noexcept;
 	void writeInt8(char) noexcept;
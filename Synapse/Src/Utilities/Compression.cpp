@@ -0,0 +1,64 @@
+#include "./Compression.hpp"
+
+#include <cryptopp/zdeflate.h>
+#include <cryptopp/zinflate.h>
+
+namespace syn
+{
+	std::string Compression::Compress(const char* Data, const size_t Size, const int Level)
+	{
+		const auto Inflated = (std::uint32_t) Size;
+
+		std::string Out;
+		Out.reserve(HeaderSize + Size / 2);
+		Out.append(Magic, sizeof(Magic));
+		Out.append((const char*) &Inflated, sizeof(Inflated));
+
+		CryptoPP::Deflator Deflate(new CryptoPP::StringSink(Out), Level);
+		Deflate.Put((const byte*) Data, Size);
+		Deflate.MessageEnd();
+
+		return Out;
+	}
+
+	bool Compression::IsCompressed(const char* Data, const size_t Size)
+	{
+		return Size >= HeaderSize && memcmp(Data, Magic, sizeof(Magic)) == 0;
+	}
+
+	bool Compression::Decompress(const char* Data, const size_t Size, std::string& Out)
+	{
+		if (!IsCompressed(Data, Size))
+			return false;
+
+		std::uint32_t Inflated;
+		memcpy(&Inflated, Data + sizeof(Magic), sizeof(Inflated));
+		if (Inflated > MaxSize)
+			return false;
+
+		std::string Result(Inflated, '\0');
+		if (!Inflate(Data + HeaderSize, Size - HeaderSize, &Result[0], Result.size()))
+			return false;
+
+		Out = std::move(Result);
+		return true;
+	}
+
+	bool Compression::Inflate(const char* Data, const size_t Size, char* Out, const size_t OutSize)
+	{
+		try
+		{
+			const auto Sink = new CryptoPP::ArraySink((byte*) Out, OutSize);
+
+			CryptoPP::Inflator Inflate(Sink);
+			Inflate.Put((const byte*) Data, Size);
+			Inflate.MessageEnd();
+
+			return Sink->TotalPutLength() == OutSize;
+		}
+		catch (CryptoPP::Exception&)
+		{
+			return false;
+		}
+	}
+}
@@ -0,0 +1,43 @@
+
+/*
+*
+*	SYNAPSE X
+*	File.:	Compression.hpp
+*	Desc.:	Framed deflate shared by the script API, workspace files and IPC
+*
+*/
+
+#pragma once
+
+#include "../Exploit/Misc/Static.hpp"
+
+#include <string>
+
+namespace syn
+{
+	/* A frame is "SYNZ", the inflated size and the raw deflate stream, so it decompresses in one presized pass */
+	class Compression
+	{
+	public:
+		static constexpr int FastLevel = 1;
+		static constexpr int DefaultLevel = 6;
+		static constexpr int BestLevel = 9;
+
+		/* Frames claiming more than this are rejected before anything is allocated */
+		static constexpr size_t MaxSize = 256 * 1024 * 1024;
+
+		static std::string Compress(const char* Data, size_t Size, int Level = DefaultLevel);
+
+		static bool IsCompressed(const char* Data, size_t Size);
+
+		/* False unless Data is a whole frame that inflates to exactly its recorded size */
+		static bool Decompress(const char* Data, size_t Size, std::string& Out);
+
+		/* Raw deflate stream into exactly OutSize bytes */
+		static bool Inflate(const char* Data, size_t Size, char* Out, size_t OutSize);
+
+	private:
+		static constexpr char Magic[4] = { 'S', 'Y', 'N', 'Z' };
+		static constexpr size_t HeaderSize = sizeof(Magic) + sizeof(std::uint32_t);
+	};
+}
@@ -11,6 +11,7 @@
 #pragma warning(disable: 4996)
 
 #include "../Exploit/Misc/Static.hpp"
+#include "MPSCQueue.hpp"
 
 #define BLACK "@@BLACK@@"
 #define BLUE "@@BLUE@@"
@@ -33,6 +34,150 @@ namespace syn
 {
 	class Console
 	{
+		/* One queued write. Star lines render as "[*]: Text" with the star in Color, otherwise Color (if set) applies
+		   from here on and Text is written raw */
+		struct Entry
+		{
+			std::string Text;
+			int Color = -1;
+			bool Star = false;
+			bool Clear = false;
+		};
+
+		/* Producers never wait on console I/O, when the writer falls this far behind new lines are dropped */
+		syn::MPSCQueue<Entry, 4096> Queue;
+		std::atomic<std::uint32_t> Dropped{ 0 };
+		HANDLE Wake = nullptr;
+
+		void Enqueue(Entry&& Value) const
+		{
+			auto& Self = const_cast<Console&>(*this);
+			if (!Self.Queue.try_enqueue(std::move(Value)))
+			{
+				Self.Dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			SetEvent(Wake);
+		}
+
+		static std::string Format(const char* Str, va_list Args)
+		{
+			va_list Copy;
+			va_copy(Copy, Args);
+			const auto Size = vsnprintf(nullptr, 0, Str, Copy);
+			va_end(Copy);
+
+			if (Size <= 0)
+				return std::string();
+
+			std::string Out(Size, '\0');
+			vsnprintf(&Out[0], Size + 1, Str, Args);
+			return Out;
+		}
+
+		void Line(const int StarColor, std::string&& Text) const
+		{
+			Entry Value;
+			Value.Text = std::move(Text);
+			Value.Color = StarColor;
+			Value.Star = true;
+			Enqueue(std::move(Value));
+		}
+
+		/* Background writer, batches runs of same colored text into single WriteConsoleW calls */
+		void Writer()
+		{
+			const auto Out = GetStdHandle(STD_OUTPUT_HANDLE);
+			std::wstring Run;
+			int Current = -1;
+
+			const auto FlushRun = [&]()
+			{
+				if (Run.empty())
+					return;
+
+				DWORD Written;
+				WriteConsoleW(Out, Run.data(), (DWORD) Run.size(), &Written, nullptr);
+				Run.clear();
+			};
+
+			const auto Color = [&](const int New)
+			{
+				if (New == Current)
+					return;
+
+				FlushRun();
+				SetConsoleTextAttribute(Out, (WORD) New);
+				Current = New;
+			};
+
+			const auto Append = [&](const std::string& Text)
+			{
+				if (Text.empty())
+					return;
+
+				const auto Start = Run.size();
+				const auto Length = MultiByteToWideChar(CP_UTF8, 0, Text.data(), (int) Text.size(), nullptr, 0);
+				Run.resize(Start + Length);
+				MultiByteToWideChar(CP_UTF8, 0, Text.data(), (int) Text.size(), &Run[Start], Length);
+			};
+
+			while (true)
+			{
+				WaitForSingleObject(Wake, INFINITE);
+
+				Entry Value;
+				while (Queue.try_dequeue(Value))
+				{
+					if (Value.Clear)
+					{
+						FlushRun();
+						ClearScreen(Out);
+						continue;
+					}
+
+					if (Value.Star)
+					{
+						Color(7);
+						Append("[");
+						Color(Value.Color);
+						Append("*");
+						Color(7);
+						Append("]: ");
+						Append(Value.Text);
+						Append("\n");
+						continue;
+					}
+
+					if (Value.Color >= 0)
+						Color(Value.Color);
+					Append(Value.Text);
+				}
+
+				if (const auto Lost = Dropped.exchange(0, std::memory_order_relaxed))
+				{
+					Color(8);
+					Append("[" + std::to_string(Lost) + " console lines dropped]\n");
+				}
+
+				FlushRun();
+			}
+		}
+
+		static void ClearScreen(const HANDLE Out)
+		{
+			CONSOLE_SCREEN_BUFFER_INFO Info;
+			if (!GetConsoleScreenBufferInfo(Out, &Info))
+				return;
+
+			const DWORD Cells = Info.dwSize.X * Info.dwSize.Y;
+			DWORD Written;
+			FillConsoleOutputCharacterW(Out, L' ', Cells, { 0, 0 }, &Written);
+			FillConsoleOutputAttribute(Out, Info.wAttributes, Cells, { 0, 0 }, &Written);
+			SetConsoleCursorPosition(Out, { 0, 0 });
+		}
+
 	public:
 		static void Init(std::string Name)
 		{
@@ -58,7 +203,7 @@ namespace syn
 			return singleton;
 		}
 
-		Console operator<<(std::string str) const
+		const Console& operator<<(std::string str) const
 		{
 			if (str == BLACK) { SetColor(0); }
 			else if (str == BLUE) { SetColor(1); }
@@ -78,94 +223,68 @@ namespace syn
 			else if (str == WHITE) { SetColor(15); }
 			else
 			{
-				std::cout << str;
+				Entry Value;
+				Value.Text = std::move(str);
+				Enqueue(std::move(Value));
 			}
 			return *this;
 		}
 
 		void Info(std::string str, ...) const
 		{
-			int final_n, n = ((int)str.size()) * 2;
-			std::unique_ptr<char[]> formatted;
 			va_list ap;
-			while (1) {
-				formatted.reset(new char[n]);
-				strcpy(&formatted[0], str.c_str());
-				va_start(ap, str);
-				final_n = vsnprintf(&formatted[0], n, str.c_str(), ap);
-				va_end(ap);
-				if (final_n < 0 || final_n >= n)
-					n += abs(final_n - n + 1);
-				else
-					break;
-			}
+			va_start(ap, str);
+			auto Text = Format(str.c_str(), ap);
+			va_end(ap);
 
-			SetColor(7);
-			std::cout << "[";
-			SetColor(15);
-			std::cout << "*";
-			SetColor(7);
-			std::cout << "]: " << formatted.get() << "\n";
+			Line(15, std::move(Text));
 		}
 
 		void Warning(std::string str, ...) const
 		{
-			int final_n, n = ((int)str.size()) * 2;
-			std::unique_ptr<char[]> formatted;
 			va_list ap;
-			while (1) {
-				formatted.reset(new char[n]);
-				strcpy(&formatted[0], str.c_str());
-				va_start(ap, str);
-				final_n = vsnprintf(&formatted[0], n, str.c_str(), ap);
-				va_end(ap);
-				if (final_n < 0 || final_n >= n)
-					n += abs(final_n - n + 1);
-				else
-					break;
-			}
+			va_start(ap, str);
+			auto Text = Format(str.c_str(), ap);
+			va_end(ap);
 
-			SetColor(7);
-			std::cout << "[";
-			SetColor(14);
-			std::cout << "*";
-			SetColor(7);
-			std::cout << "]: " << formatted.get() << "\n";
+			Line(14, std::move(Text));
 		}
 
 		void Error(std::string str, ...) const
 		{
-			int final_n, n = ((int)str.size()) * 2;
-			std::unique_ptr<char[]> formatted;
 			va_list ap;
-			while (1) {
-				formatted.reset(new char[n]);
-				strcpy(&formatted[0], str.c_str());
-				va_start(ap, str);
-				final_n = vsnprintf(&formatted[0], n, str.c_str(), ap);
-				va_end(ap);
-				if (final_n < 0 || final_n >= n)
-					n += abs(final_n - n + 1);
-				else
-					break;
-			}
+			va_start(ap, str);
+			auto Text = Format(str.c_str(), ap);
+			va_end(ap);
+
+			Line(4, std::move(Text));
+		}
 
-			SetColor(7);
-			std::cout << "[";
-			SetColor(4);
-			std::cout << "*";
-			SetColor(7);
-			std::cout << "]: " << formatted.get() << "\n";
+		/* Queued like any other write so earlier lines are never wiped after the fact */
+		void Clear() const
+		{
+			Entry Value;
+			Value.Clear = true;
+			Enqueue(std::move(Value));
 		}
 
+		/* Color changes go through the writer too, they stay in order with the text around them */
 		static void SetColor(int color)
 		{
-			SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), (WORD)color);
+			Entry Value;
+			Value.Color = color;
+			GetSingleton()->Enqueue(std::move(Value));
 		}
 
 		Console(std::string str = "")
 		{
 			Init(str);
+
+			Wake = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+			std::thread([this] { Writer(); }).detach();
 		}
+
+		Console(const Console&) = delete;
+		Console& operator=(const Console&) = delete;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,468 @@
+#include "./HttpCache.hpp"
+#include "./Utils.hpp"
+
+#define XXH_STATIC_LINKING_ONLY
+#include "./Hashing/XXHash/xxhash.h"
+
+#include <algorithm>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace syn
+{
+	namespace
+	{
+		constexpr char Magic[4] = { 'S', 'Y', 'N', 'H' };
+
+		std::string Lower(std::string Value)
+		{
+			std::transform(Value.begin(), Value.end(), Value.begin(), tolower);
+			return Value;
+		}
+
+		std::string Trim(const std::string& Value)
+		{
+			const auto Begin = Value.find_first_not_of(" \t");
+			if (Begin == std::string::npos)
+				return std::string();
+
+			return Value.substr(Begin, Value.find_last_not_of(" \t") - Begin + 1);
+		}
+
+		/* Comma separated header list, lowercased */
+		std::vector<std::string> Tokens(const std::string& Value)
+		{
+			std::vector<std::string> Out;
+			std::stringstream Stream(Value);
+			std::string Item;
+			while (std::getline(Stream, Item, ','))
+			{
+				Item = Lower(Trim(Item));
+				if (!Item.empty())
+					Out.push_back(std::move(Item));
+			}
+
+			return Out;
+		}
+
+		std::string HeaderOf(const cpr::Header& Header, const char* Name)
+		{
+			const auto Found = Header.find(Name);
+			return Found == Header.end() ? std::string() : Found->second;
+		}
+
+		/* RFC 1123 dates, anything unparseable counts as already expired */
+		std::int64_t ParseDate(const std::string& Value)
+		{
+			std::tm Time{};
+			std::istringstream Stream(Value);
+			Stream.imbue(std::locale::classic());
+			Stream >> std::get_time(&Time, "%a, %d %b %Y %H:%M:%S");
+			if (Stream.fail())
+				return 0;
+
+			const auto Result = _mkgmtime(&Time);
+			return Result == -1 ? 0 : Result;
+		}
+
+		void PutInt(std::string& Out, const std::uint64_t Value)
+		{
+			Out.append((const char*) &Value, sizeof(Value));
+		}
+
+		void PutString(std::string& Out, const std::string& Value)
+		{
+			PutInt(Out, Value.size());
+			Out.append(Value);
+		}
+
+		cpr::Response Served(std::string&& Body, cpr::Header&& Header, const std::string& Url, const double Elapsed, cpr::Cookies&& Cookies)
+		{
+			return cpr::Response(200, std::move(Body), std::move(Header), Url, Elapsed, std::move(Cookies), cpr::Error{});
+		}
+
+		struct Reader
+		{
+			const std::string& Data;
+			size_t Offset;
+
+			bool Int(std::uint64_t& Out)
+			{
+				if (Data.size() - Offset < sizeof(Out))
+					return false;
+
+				memcpy(&Out, Data.data() + Offset, sizeof(Out));
+				Offset += sizeof(Out);
+				return true;
+			}
+
+			bool String(std::string& Out)
+			{
+				std::uint64_t Size;
+				if (!Int(Size) || Data.size() - Offset < Size)
+					return false;
+
+				Out.assign(Data.data() + Offset, (size_t) Size);
+				Offset += (size_t) Size;
+				return true;
+			}
+		};
+	}
+
+	HttpCache* HttpCache::GetSingleton()
+	{
+		static HttpCache* Singleton;
+		if (!Singleton)
+			Singleton = new HttpCache();
+		return Singleton;
+	}
+
+	void HttpCache::SetFolder(const std::wstring& Path)
+	{
+		std::lock_guard<std::mutex> Guard(Mutex);
+		Folder = Path;
+		Indexed = false;
+		Index.clear();
+		Total = 0;
+	}
+
+	cpr::Response HttpCache::Fetch(const HttpRequest& Request, const std::function<cpr::Response(const HttpRequest&)>& Perform)
+	{
+		/* A caller sending its own validators wants to see the 304 */
+		if (Request.Method != H_GET || Request.Headers.count("If-None-Match") || Request.Headers.count("If-Modified-Since"))
+			return Perform(Request);
+
+		const auto Path = PathOf(Request.Url);
+		if (Path.empty())
+			return Perform(Request);
+
+		Entry Cached;
+		const auto Hit = Load(Path, Request, Cached);
+		const auto Now = (std::int64_t) std::time(nullptr);
+
+		if (Hit && !Cached.Revalidate && Now < Cached.Expires)
+			return Served(std::move(Cached.Body), std::move(Cached.Header), Request.Url, 0.0, cpr::Cookies{});
+
+		auto Conditional = Request;
+		if (Hit && !Cached.ETag.empty())
+			Conditional.Headers["If-None-Match"] = Cached.ETag;
+		if (Hit && !Cached.LastModified.empty())
+			Conditional.Headers["If-Modified-Since"] = Cached.LastModified;
+
+		auto Response = Perform(Conditional);
+
+		if (Hit && Response.status_code == 304)
+		{
+			/* The 304 may carry a new lifetime or validators, the body stays */
+			const auto ETag = Cached.ETag;
+			const auto LastModified = Cached.LastModified;
+			const auto Expires = Cached.Expires;
+
+			for (const auto& Header : Response.header)
+			{
+				if (Lower(Header.first) != "content-length")
+					Cached.Header[Header.first] = Header.second;
+			}
+
+			if (!ReadPolicy(Cached.Header, Cached))
+				Remove(Path);
+			else if (Cached.ETag != ETag || Cached.LastModified != LastModified || Cached.Expires != Expires)
+				Store(Path, Cached);
+
+			return Served(std::move(Cached.Body), std::move(Cached.Header), Request.Url, Response.elapsed, std::move(Response.cookies));
+		}
+
+		if (Response.status_code != 200)
+			return Response;
+
+		Entry Fresh;
+		Fresh.Url = Request.Url;
+
+		if (!ReadPolicy(Response.header, Fresh) || Response.text.size() > EntryLimit)
+		{
+			if (Hit)
+				Remove(Path);
+
+			return Response;
+		}
+
+		for (const auto& Name : Tokens(HeaderOf(Response.header, "Vary")))
+		{
+			if (Name == "*")
+			{
+				if (Hit)
+					Remove(Path);
+
+				return Response;
+			}
+
+			Fresh.Vary.emplace_back(Name, HeaderOf(Request.Headers, Name.c_str()));
+		}
+
+		Fresh.Header = Response.header;
+		Fresh.Body = Response.text;
+		Store(Path, Fresh);
+
+		return Response;
+	}
+
+	bool HttpCache::ReadPolicy(const cpr::Header& Header, Entry& Out)
+	{
+		Out.ETag = HeaderOf(Header, "ETag");
+		Out.LastModified = HeaderOf(Header, "Last-Modified");
+		Out.Revalidate = false;
+		Out.Expires = 0;
+
+		auto HasLifetime = false;
+		std::int64_t MaxAge = 0;
+
+		for (const auto& Directive : Tokens(HeaderOf(Header, "Cache-Control") + "," + HeaderOf(Header, "Pragma")))
+		{
+			if (Directive == "no-store")
+				return false;
+
+			if (Directive == "no-cache")
+				Out.Revalidate = true;
+			else if (Directive.compare(0, 8, "max-age=") == 0)
+			{
+				HasLifetime = true;
+				MaxAge = std::strtoll(Directive.c_str() + 8, nullptr, 10);
+			}
+		}
+
+		const auto Now = (std::int64_t) std::time(nullptr);
+
+		if (HasLifetime)
+		{
+			const auto Age = std::strtoll(HeaderOf(Header, "Age").c_str(), nullptr, 10);
+			Out.Expires = Now + MaxAge - (std::max)(Age, 0ll);
+		}
+		else
+		{
+			const auto Expires = HeaderOf(Header, "Expires");
+			if (!Expires.empty())
+			{
+				HasLifetime = true;
+				Out.Expires = ParseDate(Expires);
+			}
+		}
+
+		/* Without a validator or a lifetime there is nothing to serve it by */
+		return (HasLifetime && Out.Expires > Now) || !Out.ETag.empty() || !Out.LastModified.empty();
+	}
+
+	std::string HttpCache::Serialize(const Entry& Value)
+	{
+		std::string Out;
+		Out.reserve(Value.Body.size() + 1024);
+		Out.append(Magic, sizeof(Magic));
+
+		PutString(Out, Value.Url);
+		PutInt(Out, Value.Vary.size());
+		for (const auto& Item : Value.Vary)
+		{
+			PutString(Out, Item.first);
+			PutString(Out, Item.second);
+		}
+
+		PutString(Out, Value.ETag);
+		PutString(Out, Value.LastModified);
+		PutInt(Out, (std::uint64_t) Value.Expires);
+		PutInt(Out, Value.Revalidate);
+
+		PutInt(Out, Value.Header.size());
+		for (const auto& Item : Value.Header)
+		{
+			PutString(Out, Item.first);
+			PutString(Out, Item.second);
+		}
+
+		PutString(Out, Value.Body);
+		return Out;
+	}
+
+	bool HttpCache::Deserialize(const std::string& Data, Entry& Out)
+	{
+		if (Data.size() < sizeof(Magic) || memcmp(Data.data(), Magic, sizeof(Magic)) != 0)
+			return false;
+
+		Reader In{ Data, sizeof(Magic) };
+
+		std::uint64_t Count;
+		if (!In.String(Out.Url) || !In.Int(Count))
+			return false;
+
+		for (std::uint64_t i = 0; i < Count; i++)
+		{
+			std::string Name, Value;
+			if (!In.String(Name) || !In.String(Value))
+				return false;
+
+			Out.Vary.emplace_back(std::move(Name), std::move(Value));
+		}
+
+		std::uint64_t Expires, Revalidate;
+		if (!In.String(Out.ETag) || !In.String(Out.LastModified) || !In.Int(Expires) || !In.Int(Revalidate) || !In.Int(Count))
+			return false;
+
+		Out.Expires = (std::int64_t) Expires;
+		Out.Revalidate = Revalidate != 0;
+
+		for (std::uint64_t i = 0; i < Count; i++)
+		{
+			std::string Name, Value;
+			if (!In.String(Name) || !In.String(Value))
+				return false;
+
+			Out.Header[Name] = std::move(Value);
+		}
+
+		return In.String(Out.Body);
+	}
+
+	std::wstring HttpCache::PathOf(const std::string& Url) const
+	{
+		std::lock_guard<std::mutex> Guard(Mutex);
+		if (Folder.empty())
+			return std::wstring();
+
+		wchar_t Name[17];
+		swprintf_s(Name, L"%016llx", (unsigned long long) XXH64(Url.data(), Url.size(), 0));
+
+		return Folder + L"\\" + Name;
+	}
+
+	bool HttpCache::Load(const std::wstring& Path, const HttpRequest& Request, Entry& Out)
+	{
+		{
+			std::lock_guard<std::mutex> Guard(Mutex);
+			BuildIndex();
+
+			const auto Found = Index.find(Path);
+			if (Found == Index.end())
+				return false;
+
+			Found->second.Tick = ++Tick;
+		}
+
+		if (!Deserialize(ReadFileToString(Path), Out))
+			return false;
+
+		/* Hash collisions and different variants are both just misses, the next store replaces them */
+		if (Out.Url != Request.Url)
+			return false;
+
+		for (const auto& Item : Out.Vary)
+		{
+			if (HeaderOf(Request.Headers, Item.first.c_str()) != Item.second)
+				return false;
+		}
+
+		return true;
+	}
+
+	void HttpCache::Store(const std::wstring& Path, const Entry& Value)
+	{
+		const auto Data = Serialize(Value);
+
+		std::wstringstream Temp;
+		Temp << Path << L"." << std::this_thread::get_id() << L".tmp";
+
+		{
+			std::lock_guard<std::mutex> Guard(Mutex);
+			BuildIndex();
+			CreateDirectoryW(Folder.c_str(), nullptr);
+		}
+
+		std::ofstream Out(Temp.str(), std::ios_base::binary | std::ios_base::trunc);
+		if (!Out.is_open())
+			return;
+
+		Out.write(Data.data(), Data.size());
+		Out.close();
+
+		/* Readers only ever see a whole file */
+		if (!MoveFileExW(Temp.str().c_str(), Path.c_str(), MOVEFILE_REPLACE_EXISTING))
+		{
+			DeleteFileW(Temp.str().c_str());
+			return;
+		}
+
+		std::lock_guard<std::mutex> Guard(Mutex);
+
+		auto& Slot = Index[Path];
+		Total -= Slot.Size;
+		Slot.Size = Data.size();
+		Slot.Tick = ++Tick;
+		Total += Slot.Size;
+
+		Evict();
+	}
+
+	void HttpCache::Remove(const std::wstring& Path)
+	{
+		std::lock_guard<std::mutex> Guard(Mutex);
+
+		const auto Found = Index.find(Path);
+		if (Found == Index.end())
+			return;
+
+		Total -= Found->second.Size;
+		Index.erase(Found);
+		DeleteFileW(Path.c_str());
+	}
+
+	void HttpCache::BuildIndex()
+	{
+		if (Indexed)
+			return;
+
+		Indexed = true;
+
+		std::error_code Error;
+		std::vector<std::pair<std::filesystem::file_time_type, std::wstring>> Found;
+		for (const auto& Item : std::filesystem::directory_iterator(Folder, Error))
+		{
+			if (!Item.is_regular_file(Error))
+				continue;
+
+			/* Leftovers from a store that never finished */
+			if (Item.path().extension() == L".tmp")
+			{
+				std::filesystem::remove(Item.path(), Error);
+				continue;
+			}
+
+			const auto Size = Item.file_size(Error);
+			Found.emplace_back(Item.last_write_time(Error), Item.path().wstring());
+			Index[Found.back().second] = Use{ Size, 0 };
+			Total += Size;
+		}
+
+		/* Oldest writes are the first to go until real uses are seen */
+		std::sort(Found.begin(), Found.end());
+		for (const auto& Item : Found)
+			Index[Item.second].Tick = ++Tick;
+
+		Evict();
+	}
+
+	void HttpCache::Evict()
+	{
+		while (Total > SizeLimit && !Index.empty())
+		{
+			const auto Oldest = std::min_element(Index.begin(), Index.end(), [](const auto& A, const auto& B)
+			{
+				return A.second.Tick < B.second.Tick;
+			});
+
+			Total -= Oldest->second.Size;
+			DeleteFileW(Oldest->first.c_str());
+			Index.erase(Oldest);
+		}
+	}
+}
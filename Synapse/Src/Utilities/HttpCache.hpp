@@ -0,0 +1,81 @@
+
+/*
+*
+*	SYNAPSE X
+*	File.:	HttpCache.hpp
+*	Desc.:	On-disk HTTP cache with ETag/Last-Modified revalidation
+*
+*/
+
+#pragma once
+
+#include "./HttpPool.hpp"
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+namespace syn
+{
+	/* Opt-in GET cache under the workspace, one file per URL. Fresh entries are served without touching the network,
+	   stale ones are revalidated with If-None-Match/If-Modified-Since so a 304 skips the download */
+	class HttpCache
+	{
+	public:
+		static constexpr std::uint64_t SizeLimit = 128 * 1024 * 1024;
+
+		/* Bodies past this would just push everything else out */
+		static constexpr std::uint64_t EntryLimit = SizeLimit / 8;
+
+		static HttpCache* GetSingleton();
+
+		/* Nothing is cached until the folder is set, it is created on the first store */
+		void SetFolder(const std::wstring& Path);
+
+		/* Runs a request through the cache, Perform is called for misses and revalidations. Anything but a plain GET
+		   (or one carrying its own conditional headers) goes straight to Perform */
+		cpr::Response Fetch(const HttpRequest& Request, const std::function<cpr::Response(const HttpRequest&)>& Perform);
+
+	private:
+		struct Entry
+		{
+			std::string Url;
+			std::vector<std::pair<std::string, std::string>> Vary;
+			std::string ETag;
+			std::string LastModified;
+			std::int64_t Expires = 0;
+			bool Revalidate = false;
+			cpr::Header Header;
+			std::string Body;
+		};
+
+		struct Use
+		{
+			std::uint64_t Size;
+			std::uint64_t Tick;
+		};
+
+		/* Fills the freshness fields from the response's headers, false if it must not be stored */
+		static bool ReadPolicy(const cpr::Header& Header, Entry& Out);
+
+		static std::string Serialize(const Entry& Value);
+		static bool Deserialize(const std::string& Data, Entry& Out);
+
+		std::wstring PathOf(const std::string& Url) const;
+
+		bool Load(const std::wstring& Path, const HttpRequest& Request, Entry& Out);
+		void Store(const std::wstring& Path, const Entry& Value);
+		void Remove(const std::wstring& Path);
+
+		/* Caller holds Mutex */
+		void BuildIndex();
+		void Evict();
+
+		mutable std::mutex Mutex;
+		std::wstring Folder;
+		bool Indexed = false;
+		std::unordered_map<std::wstring, Use> Index;
+		std::uint64_t Total = 0;
+		std::uint64_t Tick = 0;
+	};
+}
@@ -0,0 +1,335 @@
+#include "./HttpPool.hpp"
+#include "../Exploit/Misc/Profiler.hpp"
+
+#include <curl/curl.h>
+#include "../Source Dependencies/cpr/util.h"
+
+namespace syn
+{
+	HttpSessionPool::Lease::Lease(HttpSessionPool* Owner, std::string Origin, std::unique_ptr<cpr::Session> Session)
+		: Owner(Owner), Origin(std::move(Origin)), Session(std::move(Session))
+	{
+	}
+
+	HttpSessionPool::Lease::~Lease()
+	{
+		if (Owner && Session)
+			Owner->Release(Origin, std::move(Session));
+	}
+
+	HttpSessionPool* HttpSessionPool::GetSingleton()
+	{
+		static HttpSessionPool* Singleton;
+		if (!Singleton)
+			Singleton = new HttpSessionPool();
+		return Singleton;
+	}
+
+	std::string HttpSessionPool::GetOrigin(const std::string& Url)
+	{
+		const auto SchemeEnd = Url.find("://");
+		if (SchemeEnd == std::string::npos)
+			return Url;
+
+		auto Scheme = Url.substr(0, SchemeEnd);
+		std::transform(Scheme.begin(), Scheme.end(), Scheme.begin(), tolower);
+
+		const auto HostStart = SchemeEnd + 3;
+		auto HostEnd = Url.find_first_of("/?#", HostStart);
+		if (HostEnd == std::string::npos)
+			HostEnd = Url.size();
+
+		auto Host = Url.substr(HostStart, HostEnd - HostStart);
+		if (Host.empty())
+			return Url;
+
+		std::transform(Host.begin(), Host.end(), Host.begin(), tolower);
+
+		/* Strip credentials, they are per-request */
+		const auto At = Host.rfind('@');
+		if (At != std::string::npos)
+			Host = Host.substr(At + 1);
+
+		const auto HasPort = !Host.empty() && Host[0] == '[' ? Host.find("]:") != std::string::npos : Host.find(':') != std::string::npos;
+		if (!HasPort)
+			Host += Scheme == "https" ? ":443" : ":80";
+
+		return Scheme + "://" + Host;
+	}
+
+	HttpSessionPool::Lease HttpSessionPool::Acquire(const std::string& Url)
+	{
+		auto Origin = GetOrigin(Url);
+
+		{
+			std::lock_guard<std::mutex> Guard(PoolMutex);
+
+			for (auto It = Idle.begin(); It != Idle.end(); ++It)
+			{
+				if (It->Origin != Origin)
+					continue;
+
+				auto Session = std::move(It->Session);
+				Idle.erase(It);
+				Reused++;
+				Leased++;
+				return Lease(this, std::move(Origin), std::move(Session));
+			}
+		}
+
+		Created++;
+		Leased++;
+		return Lease(this, std::move(Origin), std::make_unique<cpr::Session>());
+	}
+
+	HttpSessionPool::Stats HttpSessionPool::GetStats()
+	{
+		size_t IdleCount;
+		{
+			std::lock_guard<std::mutex> Guard(PoolMutex);
+			IdleCount = Idle.size();
+		}
+
+		return { Leased.load(), IdleCount, Reused.load(), Created.load() };
+	}
+
+	void HttpSessionPool::Release(const std::string& Origin, std::unique_ptr<cpr::Session> Session)
+	{
+		Leased--;
+
+		/* Wipe headers/body/cookies so nothing leaks into the next request */
+		Session->Reset();
+
+		/* Evicted sessions close their sockets once the lock is gone */
+		std::unique_ptr<cpr::Session> Evicted;
+		{
+			std::lock_guard<std::mutex> Guard(PoolMutex);
+
+			const auto Same = (size_t) std::count_if(Idle.begin(), Idle.end(), [&](const Parked& P) { return P.Origin == Origin; });
+			if (Same >= IdleLimit)
+				return;
+
+			Idle.push_front(Parked{ Origin, std::move(Session) });
+
+			if (Idle.size() > TotalIdleLimit)
+			{
+				Evicted = std::move(Idle.back().Session);
+				Idle.pop_back();
+			}
+		}
+	}
+
+	/* Same defaults as cpr::Session, plus the request itself */
+	static curl_slist* SetupHandle(CURL* Handle, const HttpRequest& Request, char* Error)
+	{
+		curl_easy_setopt(Handle, CURLOPT_URL, Request.Url.c_str());
+		curl_easy_setopt(Handle, CURLOPT_FOLLOWLOCATION, 1L);
+		curl_easy_setopt(Handle, CURLOPT_MAXREDIRS, 50L);
+		curl_easy_setopt(Handle, CURLOPT_NOPROGRESS, 1L);
+		curl_easy_setopt(Handle, CURLOPT_NOSIGNAL, 1L);
+		curl_easy_setopt(Handle, CURLOPT_TCP_KEEPALIVE, 1L);
+		curl_easy_setopt(Handle, CURLOPT_HTTP_VERSION, (long) CURL_HTTP_VERSION_2TLS);
+		curl_easy_setopt(Handle, CURLOPT_PIPEWAIT, 1L);
+		curl_easy_setopt(Handle, CURLOPT_COOKIEFILE, "");
+		curl_easy_setopt(Handle, CURLOPT_ERRORBUFFER, Error);
+
+		curl_slist* Headers = nullptr;
+		for (const auto& Header : Request.Headers)
+		{
+			const auto Line = Header.second.empty() ? Header.first + ";" : Header.first + ": " + Header.second;
+			Headers = curl_slist_append(Headers, Line.c_str());
+		}
+		curl_easy_setopt(Handle, CURLOPT_HTTPHEADER, Headers);
+
+		if (!Request.Cookies.map_.empty())
+			curl_easy_setopt(Handle, CURLOPT_COOKIE, Request.Cookies.GetEncoded().c_str());
+
+		switch (Request.Method)
+		{
+			case H_HEAD:
+				curl_easy_setopt(Handle, CURLOPT_NOBODY, 1L);
+				break;
+			case H_POST:
+			case H_PUT:
+			case H_DELETE:
+			case H_OPTIONS:
+			{
+				static const char* Verbs[] = { "GET", "HEAD", "POST", "PUT", "DELETE", "OPTIONS" };
+				curl_easy_setopt(Handle, CURLOPT_POSTFIELDSIZE, (long) Request.Body.size());
+				curl_easy_setopt(Handle, CURLOPT_COPYPOSTFIELDS, Request.Body.c_str());
+				curl_easy_setopt(Handle, CURLOPT_CUSTOMREQUEST, Verbs[Request.Method]);
+				break;
+			}
+			default:
+				curl_easy_setopt(Handle, CURLOPT_HTTPGET, 1L);
+				break;
+		}
+
+		return Headers;
+	}
+
+	static cpr::Response CollectResponse(CURL* Handle, const CURLcode Result, std::string&& Text, const std::string& HeaderText, const char* Error)
+	{
+		long StatusCode = 0;
+		double Elapsed = 0;
+		char* EffectiveUrl = nullptr;
+		curl_easy_getinfo(Handle, CURLINFO_RESPONSE_CODE, &StatusCode);
+		curl_easy_getinfo(Handle, CURLINFO_TOTAL_TIME, &Elapsed);
+		curl_easy_getinfo(Handle, CURLINFO_EFFECTIVE_URL, &EffectiveUrl);
+
+		cpr::Cookies Cookies;
+		curl_slist* RawCookies = nullptr;
+		curl_easy_getinfo(Handle, CURLINFO_COOKIELIST, &RawCookies);
+		for (auto Cookie = RawCookies; Cookie; Cookie = Cookie->next)
+		{
+			auto Tokens = cpr::util::split(Cookie->data, '\t');
+			auto Value = Tokens.back();
+			Tokens.pop_back();
+			Cookies[Tokens.back()] = Value;
+		}
+		curl_slist_free_all(RawCookies);
+
+		return cpr::Response((std::int32_t) StatusCode, std::move(Text), cpr::util::parseHeader(HeaderText),
+			std::string(EffectiveUrl ? EffectiveUrl : ""), Elapsed, std::move(Cookies), cpr::Error(Result, std::string(Error)));
+	}
+
+	std::vector<cpr::Response> HttpSessionPool::PerformBatch(const std::vector<HttpRequest>& Requests)
+	{
+		PROFILE_ZONE(OBFUSCATE_STR("Http batch"));
+
+		struct Transfer
+		{
+			CURL* Handle = nullptr;
+			curl_slist* Headers = nullptr;
+			CURLcode Result = CURLE_OK;
+			std::string Text;
+			std::string HeaderText;
+			char Error[CURL_ERROR_SIZE]{};
+		};
+
+		std::vector<Transfer> Transfers(Requests.size());
+
+		const auto Multi = curl_multi_init();
+		curl_multi_setopt(Multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+		curl_multi_setopt(Multi, CURLMOPT_MAX_HOST_CONNECTIONS, 6L);
+
+		for (size_t i = 0; i < Requests.size(); i++)
+		{
+			auto& T = Transfers[i];
+
+			T.Handle = curl_easy_init();
+			if (!T.Handle)
+			{
+				T.Result = CURLE_FAILED_INIT;
+				continue;
+			}
+
+			T.Headers = SetupHandle(T.Handle, Requests[i], T.Error);
+
+			curl_easy_setopt(T.Handle, CURLOPT_WRITEFUNCTION, cpr::util::writeFunction);
+			curl_easy_setopt(T.Handle, CURLOPT_WRITEDATA, &T.Text);
+			curl_easy_setopt(T.Handle, CURLOPT_HEADERDATA, &T.HeaderText);
+			curl_easy_setopt(T.Handle, CURLOPT_PRIVATE, (void*) &T);
+
+			curl_multi_add_handle(Multi, T.Handle);
+		}
+
+		int Running = 0;
+		do
+		{
+			if (curl_multi_perform(Multi, &Running) != CURLM_OK)
+				break;
+
+			if (Running)
+				curl_multi_wait(Multi, nullptr, 0, 1000, nullptr);
+
+			int Queued;
+			while (const auto Message = curl_multi_info_read(Multi, &Queued))
+			{
+				if (Message->msg != CURLMSG_DONE)
+					continue;
+
+				Transfer* T;
+				curl_easy_getinfo(Message->easy_handle, CURLINFO_PRIVATE, (char**) &T);
+				T->Result = Message->data.result;
+			}
+		} while (Running);
+
+		std::vector<cpr::Response> Responses;
+		Responses.reserve(Transfers.size());
+
+		for (auto& T : Transfers)
+		{
+			if (!T.Handle)
+			{
+				Responses.emplace_back(0, std::string(), cpr::Header{}, std::string(), 0.0, cpr::Cookies{}, cpr::Error(T.Result, std::string("curl_easy_init failed")));
+				continue;
+			}
+
+			Responses.push_back(CollectResponse(T.Handle, T.Result, std::move(T.Text), T.HeaderText, T.Error));
+
+			curl_multi_remove_handle(Multi, T.Handle);
+			curl_easy_cleanup(T.Handle);
+			curl_slist_free_all(T.Headers);
+		}
+
+		curl_multi_cleanup(Multi);
+
+		return Responses;
+	}
+
+	cpr::Response HttpSessionPool::PerformStreaming(const HttpRequest& Request, const std::function<void(std::string&&)>& OnChunk, const size_t ChunkSize)
+	{
+		PROFILE_ZONE(OBFUSCATE_STR("Http stream"));
+
+		struct Stream
+		{
+			const std::function<void(std::string&&)>* OnChunk;
+			size_t ChunkSize;
+			std::string Buffer;
+		};
+
+		const auto Handle = curl_easy_init();
+		if (!Handle)
+			throw std::exception("curl_easy_init failed");
+
+		char Error[CURL_ERROR_SIZE]{};
+		const auto Headers = SetupHandle(Handle, Request, Error);
+
+		Stream S{ &OnChunk, ChunkSize, std::string() };
+		S.Buffer.reserve(ChunkSize);
+
+		std::string HeaderText;
+
+		/* Coalesce curl's small writes and hand off whole chunks, the body is never accumulated */
+		curl_easy_setopt(Handle, CURLOPT_WRITEFUNCTION, static_cast<size_t(*)(char*, size_t, size_t, void*)>([](char* Ptr, size_t Size, size_t Count, void* UserData) -> size_t
+		{
+			auto St = (Stream*) UserData;
+			St->Buffer.append(Ptr, Size * Count);
+
+			if (St->Buffer.size() >= St->ChunkSize)
+			{
+				(*St->OnChunk)(std::move(St->Buffer));
+				St->Buffer = std::string();
+				St->Buffer.reserve(St->ChunkSize);
+			}
+
+			return Size * Count;
+		}));
+		curl_easy_setopt(Handle, CURLOPT_WRITEDATA, &S);
+		curl_easy_setopt(Handle, CURLOPT_HEADERFUNCTION, cpr::util::writeFunction);
+		curl_easy_setopt(Handle, CURLOPT_HEADERDATA, &HeaderText);
+
+		const auto Result = curl_easy_perform(Handle);
+
+		if (!S.Buffer.empty())
+			OnChunk(std::move(S.Buffer));
+
+		auto Response = CollectResponse(Handle, Result, std::string(), HeaderText, Error);
+
+		curl_easy_cleanup(Handle);
+		curl_slist_free_all(Headers);
+
+		return Response;
+	}
+}
@@ -0,0 +1,110 @@
+
+/*
+*
+*	SYNAPSE X
+*	File.:	HttpPool.hpp
+*	Desc.:	Keep-alive cpr::Session pool, keyed by origin
+*
+*/
+
+#pragma once
+
+#include "../Exploit/Misc/Static.hpp"
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <list>
+#include <unordered_map>
+
+namespace syn
+{
+	enum HttpMethod
+	{
+		H_GET,
+		H_HEAD,
+		H_POST,
+		H_PUT,
+		H_DELETE,
+		H_OPTIONS
+	};
+
+	struct HttpRequest
+	{
+		HttpMethod Method = H_GET;
+		std::string Url;
+		cpr::Header Headers;
+		cpr::Cookies Cookies;
+		std::string Body;
+
+		/* GETs go through HttpCache */
+		bool Cache = false;
+	};
+
+	class HttpSessionPool
+	{
+	public:
+		/* Returns the session to the pool when it goes out of scope */
+		class Lease
+		{
+		public:
+			Lease(HttpSessionPool* Owner, std::string Origin, std::unique_ptr<cpr::Session> Session);
+			~Lease();
+
+			Lease(const Lease&) = delete;
+			Lease& operator=(const Lease&) = delete;
+			Lease(Lease&&) = default;
+
+			cpr::Session* operator->() const { return Session.get(); }
+
+		private:
+			HttpSessionPool* Owner;
+			std::string Origin;
+			std::unique_ptr<cpr::Session> Session;
+		};
+
+		struct Stats
+		{
+			size_t Leased;
+			size_t Idle;
+			std::uint64_t Reused;
+			std::uint64_t Created;
+		};
+
+		static HttpSessionPool* GetSingleton();
+
+		Stats GetStats();
+
+		Lease Acquire(const std::string& Url);
+
+		/* scheme://host:port, with the default port filled in */
+		static std::string GetOrigin(const std::string& Url);
+
+		/* Runs every request concurrently on one curl multi handle, results are in request order */
+		static std::vector<cpr::Response> PerformBatch(const std::vector<HttpRequest>& Requests);
+
+		/* Hands the body to OnChunk in ChunkSize pieces as it arrives, the returned response has no body */
+		static cpr::Response PerformStreaming(const HttpRequest& Request, const std::function<void(std::string&&)>& OnChunk, size_t ChunkSize = 64 * 1024);
+
+	private:
+		/* Per origin, and across all of them. Past the total the least recently released session is closed */
+		static constexpr size_t IdleLimit = 4;
+		static constexpr size_t TotalIdleLimit = 32;
+
+		struct Parked
+		{
+			std::string Origin;
+			std::unique_ptr<cpr::Session> Session;
+		};
+
+		void Release(const std::string& Origin, std::unique_ptr<cpr::Session> Session);
+
+		/* Most recently released first, short enough that a linear scan beats keeping an index per origin */
+		std::mutex PoolMutex;
+		std::list<Parked> Idle;
+
+		std::atomic<size_t> Leased{ 0 };
+		std::atomic<std::uint64_t> Reused{ 0 };
+		std::atomic<std::uint64_t> Created{ 0 };
+	};
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <cstddef>
+
+namespace syn
+{
+	// Bounded lock-free multi-producer/single-consumer ring (Vyukov style).
+	// Producers never block the consumer, the consumer moves elements out.
+	template <class T, std::size_t Capacity = 1024>
+	class MPSCQueue
+	{
+		static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "MPSCQueue capacity must be a power of two");
+
+		struct Cell
+		{
+			std::atomic<std::size_t> Sequence;
+			alignas(T) unsigned char Storage[sizeof(T)];
+		};
+
+	public:
+		MPSCQueue()
+		{
+			for (std::size_t i = 0; i < Capacity; i++)
+				Cells[i].Sequence.store(i, std::memory_order_relaxed);
+		}
+
+		~MPSCQueue()
+		{
+			clear();
+		}
+
+		MPSCQueue(const MPSCQueue&) = delete;
+		MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+		// Add an element to the queue, returns false if the ring is full.
+		bool try_enqueue(T&& Value)
+		{
+			std::size_t Pos = EnqueuePos.load(std::memory_order_relaxed);
+			Cell* C;
+
+			while (true)
+			{
+				C = &Cells[Pos & (Capacity - 1)];
+				const std::size_t Seq = C->Sequence.load(std::memory_order_acquire);
+				const std::ptrdiff_t Diff = (std::ptrdiff_t) Seq - (std::ptrdiff_t) Pos;
+
+				if (Diff == 0)
+				{
+					if (EnqueuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (Diff < 0)
+					return false;
+				else
+					Pos = EnqueuePos.load(std::memory_order_relaxed);
+			}
+
+			new (C->Storage) T(std::move(Value));
+			Count.fetch_add(1, std::memory_order_relaxed);
+			C->Sequence.store(Pos + 1, std::memory_order_release);
+
+			return true;
+		}
+
+		// Add an element to the queue, yields while the ring is full.
+		void enqueue(T Value)
+		{
+			while (!try_enqueue(std::move(Value)))
+				std::this_thread::yield();
+		}
+
+		// Move the "front"-element out. Consumer thread only.
+		bool try_dequeue(T& Out)
+		{
+			Cell* C = &Cells[DequeuePos & (Capacity - 1)];
+			const std::size_t Seq = C->Sequence.load(std::memory_order_acquire);
+
+			if ((std::ptrdiff_t) Seq - (std::ptrdiff_t) (DequeuePos + 1) < 0)
+				return false;
+
+			T* Value = reinterpret_cast<T*>(C->Storage);
+			Out = std::move(*Value);
+			Value->~T();
+
+			C->Sequence.store(DequeuePos + Capacity, std::memory_order_release);
+			DequeuePos++;
+			Count.fetch_sub(1, std::memory_order_relaxed);
+
+			return true;
+		}
+
+		// Approximate while producers are active.
+		std::size_t size() const
+		{
+			return Count.load(std::memory_order_relaxed);
+		}
+
+		bool empty() const
+		{
+			return !size();
+		}
+
+		// Consumer thread only.
+		void clear()
+		{
+			while (true)
+			{
+				Cell* C = &Cells[DequeuePos & (Capacity - 1)];
+				if ((std::ptrdiff_t) C->Sequence.load(std::memory_order_acquire) - (std::ptrdiff_t) (DequeuePos + 1) < 0)
+					break;
+
+				reinterpret_cast<T*>(C->Storage)->~T();
+				C->Sequence.store(DequeuePos + Capacity, std::memory_order_release);
+				DequeuePos++;
+				Count.fetch_sub(1, std::memory_order_relaxed);
+			}
+		}
+
+	private:
+		Cell Cells[Capacity];
+		alignas(64) std::atomic<std::size_t> EnqueuePos{ 0 };
+		alignas(64) std::size_t DequeuePos = 0;
+		std::atomic<std::size_t> Count{ 0 };
+	};
+}
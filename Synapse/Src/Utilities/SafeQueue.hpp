@@ -24,7 +24,7 @@ namespace syn
 		void enqueue(T t)
 		{
 			std::lock_guard<std::mutex> lock(m);
-			q.push(t);
+			q.push(std::move(t));
 			c.notify_one();
 		}
 
@@ -38,7 +38,7 @@ namespace syn
 				// release lock as long as the wait and reaquire it afterwards.
 				c.wait(lock);
 			}
-			T val = q.front();
+			T val = std::move(q.front());
 			q.pop();
 			return val;
 		}
@@ -11,11 +11,20 @@
 
 #include "../Exploit/Misc/Static.hpp"
 
+#include <emmintrin.h>
+#include <intrin.h>
+
 namespace syn
 {
 	class MemoryScanner
 	{
 	public:
+		struct Signature
+		{
+			const char* Aob;
+			const char* Mask;
+		};
+
 		static bool Compare(const char* location, const char* aob, const char* mask)
 		{
 			for (; *mask; ++aob, ++mask, ++location)
@@ -43,17 +52,130 @@ namespace syn
 			return true;
 		}
 
-		static BYTE* Scan(const char* aob, const char* mask, DWORD start, DWORD end)
+		/* One pass over [Start, End) for every signature, Results[i] is the first match of Signatures[i] or nullptr.
+		   Signatures are anchored on their first unmasked byte, 16 bytes are tested against every distinct anchor
+		   with SSE2 per step and only the hits go through Compare */
+		static void ScanMany(const Signature* Signatures, const size_t Count, const DWORD Start, const DWORD End, BYTE** Results)
 		{
-			if (start <= end)
+			struct Anchored
+			{
+				size_t Index;
+				size_t Offset;
+				size_t Length;
+			};
+
+			std::vector<Anchored> Buckets[256];
+			std::vector<BYTE> Anchors;
+			size_t Remaining = 0;
+
+			for (size_t i = 0; i < Count; i++)
+			{
+				Results[i] = nullptr;
+
+				const auto Length = strlen(Signatures[i].Mask);
+				const auto Offset = strcspn(Signatures[i].Mask, "x");
+				if (Length > End - Start)
+					continue;
+
+				/* Nothing to anchor on, anything matches */
+				if (Offset == Length)
+				{
+					Results[i] = (BYTE*) Start;
+					continue;
+				}
+
+				const auto Byte = (BYTE) Signatures[i].Aob[Offset];
+				if (Buckets[Byte].empty())
+					Anchors.push_back(Byte);
+
+				Buckets[Byte].push_back({ i, Offset, Length });
+				Remaining++;
+			}
+
+			const auto Candidate = [&](const DWORD At)
 			{
-				for (; start <= end; ++start)
+				for (auto& Entry : Buckets[*(BYTE*) At])
 				{
-					if (Compare((char*) start, (char*) aob, mask))
+					if (Results[Entry.Index] || At - Start < Entry.Offset)
+						continue;
+
+					const auto Begin = At - Entry.Offset;
+					if (End - Begin < Entry.Length)
+						continue;
+
+					if (Compare((char*) Begin, Signatures[Entry.Index].Aob, Signatures[Entry.Index].Mask))
 					{
-						return (BYTE*) start;
+						Results[Entry.Index] = (BYTE*) Begin;
+						Remaining--;
 					}
 				}
+			};
+
+			auto At = Start;
+			for (; Remaining && End - At >= 16; At += 16)
+			{
+				const auto Block = _mm_loadu_si128((const __m128i*) At);
+
+				unsigned long Hits = 0;
+				for (const auto Byte : Anchors)
+					Hits |= _mm_movemask_epi8(_mm_cmpeq_epi8(Block, _mm_set1_epi8((char) Byte)));
+
+				unsigned long Bit;
+				while (Hits && _BitScanForward(&Bit, Hits))
+				{
+					Candidate(At + Bit);
+					Hits &= Hits - 1;
+				}
+			}
+
+			for (; Remaining && At < End; At++)
+				Candidate(At);
+		}
+
+		/* The image's .text section, the whole image if it has none */
+		static bool CodeRange(const HMODULE Module, DWORD& Start, DWORD& End)
+		{
+			MODULEINFO Info;
+			if (!GetModuleInformation(syn::RobloxProcess, Module, &Info, sizeof Info))
+				return false;
+
+			Start = (DWORD) Info.lpBaseOfDll;
+			End = Start + Info.SizeOfImage;
+
+			const auto Nt = (PIMAGE_NT_HEADERS) (Start + ((PIMAGE_DOS_HEADER) Start)->e_lfanew);
+			auto Section = IMAGE_FIRST_SECTION(Nt);
+			for (WORD i = 0; i < Nt->FileHeader.NumberOfSections; i++, Section++)
+			{
+				if (!strncmp((const char*) Section->Name, ".text", IMAGE_SIZEOF_SHORT_NAME))
+				{
+					End = Start + Section->VirtualAddress + Section->Misc.VirtualSize;
+					Start += Section->VirtualAddress;
+					break;
+				}
+			}
+
+			return true;
+		}
+
+		static void ScanMany(const char* module, const Signature* Signatures, const size_t Count, BYTE** Results)
+		{
+			DWORD Start, End;
+			if (CodeRange(GetModuleHandle(module), Start, End))
+				return ScanMany(Signatures, Count, Start, End, Results);
+
+			for (size_t i = 0; i < Count; i++)
+				Results[i] = nullptr;
+		}
+
+		static BYTE* Scan(const char* aob, const char* mask, DWORD start, DWORD end)
+		{
+			if (start <= end)
+			{
+				/* Matches may start anywhere up to and including end */
+				const Signature Sig{ aob, mask };
+				BYTE* Result;
+				ScanMany(&Sig, 1, start, end + (DWORD) strlen(mask), &Result);
+				return Result;
 			}
 			else
 			{
@@ -73,11 +195,10 @@ namespace syn
 
 		static BYTE* Scan(const char* module, const char* aob, const char* mask)
 		{
-			MODULEINFO Info;
-			if (GetModuleInformation(syn::RobloxProcess, GetModuleHandle(module), &Info, sizeof Info))
-				return Scan(aob, mask, (DWORD) Info.lpBaseOfDll, (DWORD) Info.lpBaseOfDll + Info.SizeOfImage);
-
-			return nullptr;
+			const Signature Sig{ aob, mask };
+			BYTE* Result;
+			ScanMany(module, &Sig, 1, &Result);
+			return Result;
 		}
 
 		static void* VfScan(DWORD Vftable, size_t Size)
@@ -0,0 +1,194 @@
+#include "./ThreadPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace syn
+{
+	ThreadPool* ThreadPool::GetSingleton()
+	{
+		static ThreadPool* Singleton;
+		if (!Singleton)
+			Singleton = new ThreadPool((std::max)(8u, std::thread::hardware_concurrency() * 2), 256, 64);
+		return Singleton;
+	}
+
+	ThreadPool* ThreadPool::GetCompilePool()
+	{
+		/* One core stays with the game's job thread */
+		static ThreadPool* Singleton;
+		if (!Singleton)
+			Singleton = new ThreadPool((std::max)(3u, std::thread::hardware_concurrency()) - 1, 256);
+		return Singleton;
+	}
+
+	ThreadPool::ThreadPool(const size_t WorkerCount, const size_t PendingLimit, const size_t MaxSpares) : Limit(PendingLimit), MaxSpares(MaxSpares)
+	{
+		for (size_t i = 0; i < WorkerCount; i++)
+			Workers.push_back(std::make_unique<Worker>());
+
+		for (size_t i = 0; i < WorkerCount; i++)
+			std::thread(&ThreadPool::Run, this, i).detach();
+
+		if (MaxSpares)
+			std::thread(&ThreadPool::Monitor, this).detach();
+	}
+
+	void ThreadPool::Submit(Job Work)
+	{
+		{
+			std::unique_lock<std::mutex> Lock(StateMutex);
+			SpaceAvailable.wait(Lock, [this] { return Queued < Limit; });
+			Queued++;
+		}
+
+		Push(std::move(Work));
+	}
+
+	bool ThreadPool::TrySubmit(Job Work)
+	{
+		{
+			std::lock_guard<std::mutex> Lock(StateMutex);
+			if (Queued >= Limit)
+				return false;
+			Queued++;
+		}
+
+		Push(std::move(Work));
+		return true;
+	}
+
+	void ThreadPool::Post(Job Work)
+	{
+		{
+			std::lock_guard<std::mutex> Lock(StateMutex);
+			Queued++;
+		}
+
+		Push(std::move(Work));
+	}
+
+	void ThreadPool::Push(Job Work)
+	{
+		/* Spread jobs round-robin, idle workers steal from the others */
+		auto& Target = *Workers[NextWorker++ % Workers.size()];
+		{
+			std::lock_guard<std::mutex> Lock(Target.Mutex);
+			Target.Jobs.push_back(std::move(Work));
+		}
+
+		std::lock_guard<std::mutex> Lock(StateMutex);
+		WorkAvailable.notify_one();
+	}
+
+	size_t ThreadPool::Pending() const
+	{
+		std::lock_guard<std::mutex> Lock(StateMutex);
+		return Queued;
+	}
+
+	bool ThreadPool::TryPop(const size_t Index, Job& Out)
+	{
+		/* Own queue first (newest job), then steal the oldest job from everyone else */
+		for (size_t i = 0; i < Workers.size(); i++)
+		{
+			auto& Victim = *Workers[(Index + i) % Workers.size()];
+			std::lock_guard<std::mutex> Lock(Victim.Mutex);
+			if (Victim.Jobs.empty())
+				continue;
+
+			if (i == 0)
+			{
+				Out = std::move(Victim.Jobs.back());
+				Victim.Jobs.pop_back();
+			}
+			else
+			{
+				Out = std::move(Victim.Jobs.front());
+				Victim.Jobs.pop_front();
+			}
+
+			return true;
+		}
+
+		return false;
+	}
+
+	void ThreadPool::Run(const size_t Index)
+	{
+		while (true)
+		{
+			Job Work;
+			if (!TryPop(Index, Work))
+			{
+				std::unique_lock<std::mutex> Lock(StateMutex);
+				WorkAvailable.wait(Lock, [this] { return Queued != 0; });
+				continue;
+			}
+
+			Execute(Work);
+		}
+	}
+
+	void ThreadPool::RunSpare(size_t Index)
+	{
+		while (true)
+		{
+			Job Work;
+			if (!TryPop(Index++ % Workers.size(), Work))
+			{
+				std::unique_lock<std::mutex> Lock(StateMutex);
+				if (!WorkAvailable.wait_for(Lock, std::chrono::milliseconds(SpareIdleTimeout), [this] { return Queued != 0; }))
+				{
+					Spares--;
+					return;
+				}
+				continue;
+			}
+
+			Execute(Work);
+		}
+	}
+
+	void ThreadPool::Execute(Job& Work)
+	{
+		{
+			std::lock_guard<std::mutex> Lock(StateMutex);
+			Queued--;
+			SpaceAvailable.notify_one();
+		}
+
+		Active++;
+		try
+		{
+			Work();
+		}
+		catch (...) {}
+		Active--;
+		Completed++;
+	}
+
+	void ThreadPool::Monitor()
+	{
+		/* Blocking jobs (message boxes, long polls, socket waits) can hold every thread at once. Nothing finishing
+		   while jobs wait and no thread is free means they would wait for as long as those block */
+		auto Seen = Completed.load();
+		while (true)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(StallInterval));
+
+			const auto Done = Completed.load();
+			bool Stalled;
+			{
+				std::lock_guard<std::mutex> Lock(StateMutex);
+				Stalled = Queued != 0 && Done == Seen && Spares < MaxSpares && Active.load() >= Workers.size() + Spares;
+				if (Stalled)
+					Spares++;
+			}
+			Seen = Done;
+
+			if (Stalled)
+				std::thread(&ThreadPool::RunSpare, this, (size_t) Done).detach();
+		}
+	}
+}
@@ -0,0 +1,93 @@
+
+/*
+*
+*	SYNAPSE X
+*	File.:	ThreadPool.hpp
+*	Desc.:	Shared worker pool for yielding functions
+*
+*/
+
+#pragma once
+
+#include <deque>
+#include <cstdint>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+namespace syn
+{
+	class ThreadPool
+	{
+	public:
+		using Job = std::function<void()>;
+
+		static ThreadPool* GetSingleton();
+
+		/* Workers of their own for the scheduler's compile stage, compiles never queue behind yielding functions */
+		static ThreadPool* GetCompilePool();
+
+		/* How long every thread may be busy with nothing finishing before a spare thread is added, and how long a
+		   spare waits for work before it exits again */
+		static constexpr std::uint32_t StallInterval = 100;
+		static constexpr std::uint32_t SpareIdleTimeout = 10000;
+
+		/* Queue a job, blocks the caller while the pool is at its pending limit */
+		void Submit(Job Work);
+
+		/* Queue a job unless the pool is at its pending limit, never blocks. For optional helpers the caller can do
+		   without, like the ones sharing a batch with a thread that works through it too */
+		bool TrySubmit(Job Work);
+
+		/* Queue a job past the limit if need be, never blocks. For the game and render threads, whose work can't be
+		   dropped and which must not stall behind a saturated pool */
+		void Post(Job Work);
+
+		size_t Pending() const;
+
+	private:
+		struct Worker
+		{
+			std::deque<Job> Jobs;
+			std::mutex Mutex;
+		};
+
+		/* A pool with MaxSpares grows while blocking jobs hold all of its threads, so they can't starve the rest */
+		ThreadPool(size_t WorkerCount, size_t PendingLimit, size_t MaxSpares = 0);
+
+		void Run(size_t Index);
+
+		/* Steals from every worker and exits once idle for SpareIdleTimeout */
+		void RunSpare(size_t Index);
+
+		/* Popped job, Queued not yet released */
+		void Execute(Job& Work);
+
+		void Monitor();
+
+		/* Queued already counted */
+		void Push(Job Work);
+
+		bool TryPop(size_t Index, Job& Out);
+
+		std::vector<std::unique_ptr<Worker>> Workers;
+		std::atomic<size_t> NextWorker{ 0 };
+
+		size_t Limit;
+		size_t Queued = 0;
+
+		/* Spares is guarded by StateMutex */
+		size_t MaxSpares;
+		size_t Spares = 0;
+		std::atomic<size_t> Active{ 0 };
+		std::atomic<std::uint64_t> Completed{ 0 };
+
+		mutable std::mutex StateMutex;
+		std::condition_variable WorkAvailable;
+		std::condition_variable SpaceAvailable;
+	};
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace syn
+{
+	// Hierarchical timer wheel, Levels wheels of 2^Bits slots each, one tick per slot on the first level.
+	// Adding is O(1), every timer is cascaded down at most Levels - 1 times before it expires.
+	// Not thread safe, the owner adds and advances from one thread.
+	template <class T, unsigned Bits = 6, unsigned Levels = 4>
+	class TimerWheel
+	{
+		static constexpr std::uint64_t Slots = 1ull << Bits;
+		static constexpr std::uint64_t Mask = Slots - 1;
+
+		struct Timer
+		{
+			std::uint64_t Due;
+			T Value;
+		};
+
+	public:
+		// Forget every timer and restart counting at Tick.
+		void reset(const std::uint64_t Tick)
+		{
+			for (auto& Level : Wheel)
+				for (auto& Slot : Level)
+					Slot.clear();
+
+			Current = Tick;
+			Count = 0;
+		}
+
+		std::uint64_t now() const { return Current; }
+
+		std::size_t size() const { return Count; }
+
+		bool empty() const { return Count == 0; }
+
+		// Schedule Value to expire on tick Due, ticks already passed expire on the next advance.
+		void add(const std::uint64_t Due, T&& Value)
+		{
+			Place(Timer{ Due > Current ? Due : Current + 1, std::move(Value) });
+			Count++;
+		}
+
+		// Walk the wheel forward to Tick, every timer due by then is moved into Expired.
+		template <class Fn>
+		void advance(const std::uint64_t Tick, Fn&& Expired)
+		{
+			while (Current < Tick && Count)
+			{
+				Current++;
+
+				/* Whenever a level wraps the next level's slot for this tick is spread back down */
+				for (unsigned L = 1; L < Levels && (Current & ((1ull << (Bits * L)) - 1)) == 0; L++)
+				{
+					auto Cascade = std::move(Wheel[L][(Current >> (Bits * L)) & Mask]);
+					Wheel[L][(Current >> (Bits * L)) & Mask].clear();
+
+					for (auto& Entry : Cascade)
+						Place(std::move(Entry));
+				}
+
+				auto& Slot = Wheel[0][Current & Mask];
+				if (Slot.empty())
+					continue;
+
+				auto Due = std::move(Slot);
+				Slot.clear();
+				Count -= Due.size();
+
+				for (auto& Entry : Due)
+					Expired(std::move(Entry.Value));
+			}
+
+			/* Nothing left to walk for, jump straight to the target */
+			if (Current < Tick)
+				Current = Tick;
+		}
+
+	private:
+		void Place(Timer&& Entry)
+		{
+			const auto Delta = Entry.Due - Current;
+
+			unsigned L = 0;
+			while (L + 1 < Levels && Delta >= (1ull << (Bits * (L + 1))))
+				L++;
+
+			/* Past the top level's range the timer parks in the furthest slot and is cascaded again from there */
+			auto Due = Entry.Due;
+			if (Delta >= (1ull << (Bits * Levels)))
+				Due = Current + (1ull << (Bits * Levels)) - 1;
+
+			Wheel[L][(Due >> (Bits * L)) & Mask].push_back(std::move(Entry));
+		}
+
+		std::vector<Timer> Wheel[Levels][Slots];
+		std::uint64_t Current = 0;
+		std::size_t Count = 0;
+	};
+}
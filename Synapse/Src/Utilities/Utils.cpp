@@ -11,6 +11,10 @@
 
 #include "cryptopp\cryptlib.h"
 
+#include <array>
+#include <intrin.h>
+#include <immintrin.h>
+
 DWORD RandomInteger(DWORD Min, DWORD Max) 
 {
 	std::random_device rd;
@@ -58,27 +62,245 @@ void ReplaceAll(std::string& Str, const std::string& From, const std::string& To
 	}
 }
 
-std::string Base64Decode(const std::string& encoded_string)
+/* Base64, SSSE3/AVX2 blocks with a scalar tail (Mula and Lemire's shuffle based codec) */
+static const char Base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+enum Base64Simd
+{
+	B64_SCALAR,
+	B64_SSSE3,
+	B64_AVX2
+};
+
+static Base64Simd Base64Level()
+{
+	static const auto Level = []
+	{
+		int Info[4];
+		__cpuid(Info, 0);
+		const auto MaxLeaf = Info[0];
+
+		__cpuid(Info, 1);
+		const auto Ssse3 = (Info[2] & (1 << 9)) != 0;
+		const auto OsAvx = (Info[2] & (1 << 27)) && (Info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+
+		if (OsAvx && MaxLeaf >= 7)
+		{
+			__cpuidex(Info, 7, 0);
+			if (Info[1] & (1 << 5))
+				return B64_AVX2;
+		}
+
+		return Ssse3 ? B64_SSSE3 : B64_SCALAR;
+	}();
+
+	return Level;
+}
+
+/* 12 bytes in the low lanes of In to 16 characters */
+static __forceinline __m128i Base64EncodeBlock(__m128i In)
 {
-    std::string decoded;
-    CryptoPP::StringSource ss(encoded_string, true,
-        new CryptoPP::Base64Decoder(
-            new CryptoPP::StringSink(decoded)
-        ));
+	In = _mm_shuffle_epi8(In, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+	const auto T0 = _mm_mulhi_epu16(_mm_and_si128(In, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+	const auto T1 = _mm_mullo_epi16(_mm_and_si128(In, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+	const auto Indices = _mm_or_si128(T0, T1);
+
+	/* 0..25 -> 13, 26..51 -> 0, 52..63 -> 1..12, each picking the offset to its character */
+	auto Class = _mm_subs_epu8(Indices, _mm_set1_epi8(51));
+	Class = _mm_or_si128(Class, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), Indices), _mm_set1_epi8(13)));
 
-    return decoded;
+	const auto Offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+	return _mm_add_epi8(_mm_shuffle_epi8(Offsets, Class), Indices);
+}
+
+static __forceinline __m256i Base64EncodeBlock(__m256i In)
+{
+	In = _mm256_shuffle_epi8(In, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1, 10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+	const auto T0 = _mm256_mulhi_epu16(_mm256_and_si256(In, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+	const auto T1 = _mm256_mullo_epi16(_mm256_and_si256(In, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+	const auto Indices = _mm256_or_si256(T0, T1);
+
+	auto Class = _mm256_subs_epu8(Indices, _mm256_set1_epi8(51));
+	Class = _mm256_or_si256(Class, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), Indices), _mm256_set1_epi8(13)));
+
+	const auto Offsets = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+		'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+	return _mm256_add_epi8(_mm256_shuffle_epi8(Offsets, Class), Indices);
 }
 
 std::string Base64Encode(const byte* bytes_to_encode, size_t in_len)
 {
-    std::string encoded;
-    CryptoPP::StringSource ss(bytes_to_encode, in_len, true,
-        new CryptoPP::Base64Encoder(
-            new CryptoPP::StringSink(encoded),
-			false
-        ));
-
-    return encoded;
+	std::string Encoded((in_len + 2) / 3 * 4, '\0');
+
+	auto Src = bytes_to_encode;
+	auto Dst = (unsigned char*) &Encoded[0];
+	auto Left = in_len;
+
+	/* Blocks load 4 bytes past the 12 they consume, so they stop while that much input is left */
+	const auto Level = Base64Level();
+	if (Level == B64_AVX2)
+	{
+		for (; Left >= 28; Left -= 24, Src += 24, Dst += 32)
+		{
+			const auto In = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*) Src)), _mm_loadu_si128((const __m128i*) (Src + 12)), 1);
+			_mm256_storeu_si256((__m256i*) Dst, Base64EncodeBlock(In));
+		}
+	}
+
+	if (Level >= B64_SSSE3)
+	{
+		for (; Left >= 16; Left -= 12, Src += 12, Dst += 16)
+			_mm_storeu_si128((__m128i*) Dst, Base64EncodeBlock(_mm_loadu_si128((const __m128i*) Src)));
+	}
+
+	for (; Left >= 3; Left -= 3, Src += 3, Dst += 4)
+	{
+		const auto Triple = (Src[0] << 16) | (Src[1] << 8) | Src[2];
+		Dst[0] = Base64Alphabet[(Triple >> 18) & 63];
+		Dst[1] = Base64Alphabet[(Triple >> 12) & 63];
+		Dst[2] = Base64Alphabet[(Triple >> 6) & 63];
+		Dst[3] = Base64Alphabet[Triple & 63];
+	}
+
+	if (Left)
+	{
+		const auto Triple = (Src[0] << 16) | (Left == 2 ? Src[1] << 8 : 0);
+		Dst[0] = Base64Alphabet[(Triple >> 18) & 63];
+		Dst[1] = Base64Alphabet[(Triple >> 12) & 63];
+		Dst[2] = Left == 2 ? Base64Alphabet[(Triple >> 6) & 63] : '=';
+		Dst[3] = '=';
+	}
+
+	return Encoded;
+}
+
+/* 16 characters to 12 bytes in the low lanes, false if any of them is outside the alphabet */
+static __forceinline bool Base64DecodeBlock(__m128i& In)
+{
+	const auto LutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+	const auto LutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	const auto LutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+	const auto Mask2F = _mm_set1_epi8(0x2f);
+
+	const auto HiNibbles = _mm_and_si128(_mm_srli_epi32(In, 4), Mask2F);
+	const auto Lo = _mm_shuffle_epi8(LutLo, _mm_and_si128(In, Mask2F));
+	const auto Hi = _mm_shuffle_epi8(LutHi, HiNibbles);
+
+	if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(Lo, Hi), _mm_setzero_si128())))
+		return false;
+
+	const auto Roll = _mm_shuffle_epi8(LutRoll, _mm_add_epi8(_mm_cmpeq_epi8(In, Mask2F), HiNibbles));
+	const auto Sextets = _mm_add_epi8(In, Roll);
+
+	const auto Pairs = _mm_maddubs_epi16(Sextets, _mm_set1_epi32(0x01400140));
+	const auto Triples = _mm_madd_epi16(Pairs, _mm_set1_epi32(0x00011000));
+	In = _mm_shuffle_epi8(Triples, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+	return true;
+}
+
+/* 32 characters to 24 bytes in the low lanes */
+static __forceinline bool Base64DecodeBlock(__m256i& In)
+{
+	const auto LutLo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a,
+		0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+	const auto LutHi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+		0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	const auto LutRoll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+	const auto Mask2F = _mm256_set1_epi8(0x2f);
+
+	const auto HiNibbles = _mm256_and_si256(_mm256_srli_epi32(In, 4), Mask2F);
+	const auto Lo = _mm256_shuffle_epi8(LutLo, _mm256_and_si256(In, Mask2F));
+	const auto Hi = _mm256_shuffle_epi8(LutHi, HiNibbles);
+
+	if (!_mm256_testz_si256(Lo, Hi))
+		return false;
+
+	const auto Roll = _mm256_shuffle_epi8(LutRoll, _mm256_add_epi8(_mm256_cmpeq_epi8(In, Mask2F), HiNibbles));
+	const auto Sextets = _mm256_add_epi8(In, Roll);
+
+	const auto Pairs = _mm256_maddubs_epi16(Sextets, _mm256_set1_epi32(0x01400140));
+	const auto Triples = _mm256_madd_epi16(Pairs, _mm256_set1_epi32(0x00011000));
+	const auto Packed = _mm256_shuffle_epi8(Triples, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+		2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+	In = _mm256_permutevar8x32_epi32(Packed, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1));
+
+	return true;
+}
+
+std::string Base64Decode(const char* encoded_string, size_t in_len)
+{
+	/* Blocks store a few bytes past the ones they produce, the slack is trimmed at the end */
+	std::string Decoded(in_len / 4 * 3 + 3 + 8, '\0');
+
+	auto Src = (const unsigned char*) encoded_string;
+	auto Dst = (unsigned char*) &Decoded[0];
+	auto Left = in_len;
+
+	/* Blocks only run over clean input, anything else (padding, whitespace) goes to the scalar loop */
+	const auto Level = Base64Level();
+	if (Level == B64_AVX2)
+	{
+		for (; Left >= 32; Left -= 32, Src += 32, Dst += 24)
+		{
+			auto In = _mm256_loadu_si256((const __m256i*) Src);
+			if (!Base64DecodeBlock(In))
+				break;
+
+			_mm256_storeu_si256((__m256i*) Dst, In);
+		}
+	}
+
+	if (Level >= B64_SSSE3)
+	{
+		for (; Left >= 16; Left -= 16, Src += 16, Dst += 12)
+		{
+			auto In = _mm_loadu_si128((const __m128i*) Src);
+			if (!Base64DecodeBlock(In))
+				break;
+
+			_mm_storeu_si128((__m128i*) Dst, In);
+		}
+	}
+
+	/* Characters outside the alphabet are skipped, the same as the CryptoPP decoder did */
+	static const auto Lookup = []
+	{
+		std::array<signed char, 256> Table;
+		Table.fill(-1);
+		for (auto i = 0; i < 64; i++)
+			Table[(unsigned char) Base64Alphabet[i]] = (signed char) i;
+		return Table;
+	}();
+
+	unsigned int Accumulator = 0;
+	auto Bits = 0;
+	for (; Left; Left--, Src++)
+	{
+		const auto Value = Lookup[*Src];
+		if (Value < 0)
+			continue;
+
+		Accumulator = (Accumulator << 6) | Value;
+		Bits += 6;
+
+		if (Bits >= 8)
+		{
+			Bits -= 8;
+			*Dst++ = (unsigned char) (Accumulator >> Bits);
+		}
+	}
+
+	Decoded.resize(Dst - (unsigned char*) Decoded.data());
+	return Decoded;
+}
+
+std::string Base64Decode(const std::string& encoded_string)
+{
+	return Base64Decode(encoded_string.data(), encoded_string.size());
 }
 
 std::wstring ConvertToWStr(std::string const& ascii)
@@ -86,6 +308,57 @@ std::wstring ConvertToWStr(std::string const& ascii)
 	return std::wstring(ascii.begin(), ascii.end());
 }
 
+MappedFile::MappedFile(const std::wstring& Path)
+{
+	File = CreateFileW(Path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (File == INVALID_HANDLE_VALUE)
+		return;
+
+	LARGE_INTEGER FileSize;
+	if (!GetFileSizeEx(File, &FileSize) || FileSize.HighPart)
+		return;
+
+	Length = FileSize.LowPart;
+
+	if (Length < MapThreshold)
+	{
+		Small.resize(Length);
+
+		DWORD Read = 0;
+		if (Length && (!ReadFile(File, Small.data(), (DWORD) Length, &Read, NULL) || Read != Length))
+			return;
+
+		Success = true;
+		return;
+	}
+
+	Mapping = CreateFileMappingW(File, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!Mapping)
+		return;
+
+	View = MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+	Success = View != nullptr;
+}
+
+MappedFile::~MappedFile()
+{
+	if (View)
+		UnmapViewOfFile(View);
+	if (Mapping)
+		CloseHandle(Mapping);
+	if (File != INVALID_HANDLE_VALUE)
+		CloseHandle(File);
+}
+
+std::string ReadFileToString(const std::wstring& Path)
+{
+	const MappedFile Mapped(Path);
+	if (!Mapped.Valid())
+		return std::string();
+
+	return std::string(Mapped.Data(), Mapped.Size());
+}
+
 void SuspendRoblox() 
 {
 	const auto hThreadSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
@@ -17,10 +17,38 @@ void SplitString(std::string Str, std::string By, std::vector<std::string> &Toke
 void ReplaceAll(std::string& Str, const std::string& From, const std::string& To);
 
 std::string Base64Decode(const std::string& encoded_string);
+std::string Base64Decode(const char* encoded_string, size_t in_len);
 std::string Base64Encode(const byte* bytes_to_encode, size_t in_len);
 
 std::wstring ConvertToWStr(std::string const& utf8);
 
+/* Read-only view of a whole file. Large files are memory mapped, small ones are read into a presized buffer */
+class MappedFile
+{
+public:
+	explicit MappedFile(const std::wstring& Path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Valid() const { return Success; }
+	const char* Data() const { return View ? (const char*) View : Small.data(); }
+	size_t Size() const { return Length; }
+
+private:
+	static constexpr size_t MapThreshold = 64 * 1024;
+
+	HANDLE File = INVALID_HANDLE_VALUE;
+	HANDLE Mapping = nullptr;
+	LPVOID View = nullptr;
+	std::string Small;
+	size_t Length = 0;
+	bool Success = false;
+};
+
+std::string ReadFileToString(const std::wstring& Path);
+
 void SuspendRoblox();
 
 void ResumeRoblox();
@@ -0,0 +1,459 @@
+#include "./WorkspaceCache.hpp"
+#include "./AsyncFile.hpp"
+#include "./Compression.hpp"
+#include "./Utils.hpp"
+#include "./Console.hpp"
+#include "../Exploit/Misc/Profiler.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace syn
+{
+	WorkspaceCache::WorkspaceCache()
+	{
+		std::thread([this] { Flusher(); }).detach();
+	}
+
+	std::wstring WorkspaceCache::Key(const std::wstring& Path)
+	{
+		/* Windows paths are case insensitive and scripts mix both separators */
+		auto Out = Path;
+		std::replace(Out.begin(), Out.end(), L'/', L'\\');
+		CharLowerBuffW(&Out[0], (DWORD) Out.size());
+		return Out;
+	}
+
+	bool WorkspaceCache::Write(const std::wstring& Path, const char* Data, const size_t Size, const int Level)
+	{
+		const auto K = Key(Path);
+
+		std::unique_lock<std::mutex> Lock(Mutex);
+
+		auto Found = Entries.find(K);
+		if (Found == Entries.end())
+		{
+			/* Only the first write of a batch asks the disk, a missing folder failed with ofstream too */
+			const auto Slash = Path.find_last_of(L"\\/");
+			if (Slash != std::wstring::npos)
+			{
+				const auto Attributes = GetFileAttributesW(Path.substr(0, Slash).c_str());
+				if (Attributes == INVALID_FILE_ATTRIBUTES || !(Attributes & FILE_ATTRIBUTE_DIRECTORY))
+					return false;
+			}
+
+			Found = Entries.emplace(K, Entry{ Path }).first;
+		}
+
+		Bytes -= Found->second.Data.size();
+		Found->second.Data.assign(Data, Size);
+		Found->second.Append = false;
+		Found->second.Level = Level;
+		Bytes += Size;
+
+		if (Bytes >= FlushThreshold)
+			Wake.notify_one();
+
+		return true;
+	}
+
+	bool WorkspaceCache::Append(const std::wstring& Path, const char* Data, const size_t Size)
+	{
+		const auto K = Key(Path);
+
+		std::unique_lock<std::mutex> Lock(Mutex);
+		if (AppendPending(K, Data, Size))
+			return true;
+
+		/* Not pending, but a batch on its way to disk may be what creates the file */
+		if (const auto Previous = Writing(K))
+		{
+			if (Previous->Append)
+			{
+				/* Only an append is in flight, the next batch goes out after it and appends in order */
+				Entries.emplace(K, Entry{ Path, std::string(Data, Size), true });
+				Bytes += Size;
+			}
+			else
+			{
+				/* The in-flight copy is the whole file, carried over so a compressed one is rewritten whole */
+				auto Whole = Previous->Data;
+				Whole.append(Data, Size);
+				Bytes += Whole.size();
+				Entries.emplace(K, Entry{ Path, std::move(Whole), false, Previous->Level });
+			}
+
+			if (Bytes >= FlushThreshold)
+				Wake.notify_one();
+
+			return true;
+		}
+
+		if (!std::filesystem::exists(Path))
+			return false;
+
+		/* Raw bytes on the end of a compressed file would corrupt it, so the whole file comes back to be rewritten */
+		std::string Inflated;
+		const MappedFile File(Path);
+		if (File.Valid() && Compression::Decompress(File.Data(), File.Size(), Inflated))
+		{
+			Inflated.append(Data, Size);
+			Bytes += Inflated.size();
+			Entries.emplace(K, Entry{ Path, std::move(Inflated), false, Compression::DefaultLevel });
+		}
+		else
+		{
+			Entries.emplace(K, Entry{ Path, std::string(Data, Size), true });
+			Bytes += Size;
+		}
+
+		if (Bytes >= FlushThreshold)
+			Wake.notify_one();
+
+		return true;
+	}
+
+	bool WorkspaceCache::AppendPending(const std::wstring& K, const char* Data, const size_t Size)
+	{
+		const auto Found = Entries.find(K);
+		if (Found == Entries.end())
+			return false;
+
+		/* Appends after a pending write just extend it, appends to the disk copy accumulate until the flush */
+		Found->second.Data.append(Data, Size);
+		Bytes += Size;
+
+		if (Bytes >= FlushThreshold)
+			Wake.notify_one();
+
+		return true;
+	}
+
+	bool WorkspaceCache::Read(const std::wstring& Path, std::string& Out)
+	{
+		const auto K = Key(Path);
+
+		{
+			std::unique_lock<std::mutex> Lock(Mutex);
+
+			const auto Found = Entries.find(K);
+			if (Found != Entries.end() && !Found->second.Append)
+			{
+				Out = Found->second.Data;
+				return true;
+			}
+
+			/* A whole-file write on its way to disk is served as is, the disk copy may be half written */
+			const auto Previous = Writing(K);
+			if (Previous && !Previous->Append)
+			{
+				Out = Previous->Data;
+				if (Found != Entries.end())
+					Out += Found->second.Data;
+				return true;
+			}
+
+			if (Found == Entries.end() && !Previous)
+				return false;
+		}
+
+		/* Appends to the disk copy, only they still need it on disk before it can be read */
+		Sync(Path);
+		return false;
+	}
+
+	const WorkspaceCache::Entry* WorkspaceCache::Writing(const std::wstring& K) const
+	{
+		if (!InFlight)
+			return nullptr;
+
+		const auto Found = InFlight->find(K);
+		return Found != InFlight->end() ? &Found->second : nullptr;
+	}
+
+	bool WorkspaceCache::Pending(const std::wstring& Path)
+	{
+		const auto K = Key(Path);
+
+		std::lock_guard<std::mutex> Lock(Mutex);
+		return Entries.find(K) != Entries.end() || Writing(K);
+	}
+
+	bool WorkspaceCache::Discard(const std::wstring& Path)
+	{
+		const auto K = Key(Path);
+
+		std::unique_lock<std::mutex> Lock(Mutex);
+
+		/* Waits out an in-flight batch holding the path so it can't recreate the file after the caller deletes it */
+		if (Writing(K))
+		{
+			Lock.unlock();
+			{
+				std::lock_guard<std::mutex> Flushing(FlushMutex);
+			}
+			Lock.lock();
+		}
+
+		const auto Found = Entries.find(K);
+		if (Found == Entries.end())
+			return false;
+
+		Bytes -= Found->second.Data.size();
+		Entries.erase(Found);
+		return true;
+	}
+
+	void WorkspaceCache::Sync(const std::wstring& Path)
+	{
+		const auto K = Key(Path);
+
+		bool Queued, Busy;
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			Queued = Entries.find(K) != Entries.end();
+			Busy = Writing(K) != nullptr;
+		}
+
+		if (Queued)
+		{
+			Flush();
+			return;
+		}
+
+		/* Only a batch that holds the path is worth waiting for */
+		if (Busy)
+		{
+			std::lock_guard<std::mutex> Flushing(FlushMutex);
+		}
+	}
+
+	void WorkspaceCache::Flush()
+	{
+		PROFILE_ZONE(OBFUSCATE_STR("Workspace flush"));
+		std::lock_guard<std::mutex> Flushing(FlushMutex);
+
+		const auto Written = std::make_shared<Batch>();
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			Written->swap(Entries);
+			Bytes = 0;
+
+			if (Written->empty())
+				return;
+
+			/* Stays readable while it's written, the entries aren't touched until it's taken back down */
+			InFlight = Written;
+		}
+
+		/* Whole-file writes go out together on the completion port, appends are rare enough to stay simple */
+		std::vector<FileOp> Writes;
+		size_t Failed = 0;
+		std::wstring FailedPath;
+		DWORD FailedError = 0;
+
+		for (const auto& Item : *Written)
+		{
+			const auto& Value = Item.second;
+
+			if (!Value.Append)
+			{
+				FileOp Op;
+				Op.Path = Value.Path;
+				Op.Data = Value.Level ? Compression::Compress(Value.Data.data(), Value.Data.size(), Value.Level) : Value.Data;
+				Writes.push_back(std::move(Op));
+				continue;
+			}
+
+			std::ofstream Out;
+			Out.open(Value.Path, std::ios_base::app | std::ios_base::binary);
+			Out.write(Value.Data.data(), Value.Data.size());
+			Out.close();
+
+			if (Out.fail() && !Failed++)
+			{
+				FailedPath = Value.Path;
+				FailedError = GetLastError();
+			}
+		}
+
+		if (!Writes.empty())
+			AsyncFile::WriteBatch(Writes);
+
+		for (const auto& Op : Writes)
+		{
+			if (!Op.Success && !Failed++)
+			{
+				FailedPath = Op.Path;
+				FailedError = Op.Error;
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			InFlight.reset();
+		}
+
+		if (Failed)
+			Report(FailedPath, FailedError, Failed);
+
+		/* Don't wait for the watcher to notice our own writes */
+		Invalidate();
+	}
+
+	void WorkspaceCache::Report(const std::wstring& Path, const DWORD Error, const size_t Failed)
+	{
+		/* The script that wrote it has long moved on, so this is the only trace a lost write leaves */
+		wchar_t Message[512];
+		swprintf(Message, sizeof(Message) / sizeof(*Message), L"workspace: failed to write '%ls' (error %lu), %zu write(s) lost in this batch\n",
+			Path.c_str(), Error, Failed);
+		OutputDebugStringW(Message);
+
+		DbgConsoleExec(syn::Console::GetSingleton()->Warning("workspace: failed to write '%ls' (error %lu), %zu write(s) lost", Path.c_str(), Error, Failed));
+	}
+
+	WorkspaceCache::Listing WorkspaceCache::List(const std::wstring& Root, const std::wstring& Folder, const bool Recursive)
+	{
+		const auto K = Key(Folder) + (Recursive ? L"|r" : L"");
+		std::uint64_t Scanned;
+
+		{
+			std::lock_guard<std::mutex> Lock(ListMutex);
+			Scanned = Generation;
+			StartWatching(Root);
+
+			const auto Found = Listings.find(K);
+			if (Found != Listings.end())
+				return Found->second;
+		}
+
+		auto Entries = std::make_shared<std::vector<DirEntry>>();
+		if (!Scan(Root, Folder, Recursive, *Entries))
+			return nullptr;
+
+		/* Without a working watcher nothing would ever invalidate it, so only cache while watching. A change during
+		   the scan bumps the generation and the possibly stale result isn't kept */
+		if (Watching.load(std::memory_order_acquire))
+		{
+			std::lock_guard<std::mutex> Lock(ListMutex);
+			if (Generation == Scanned)
+				Listings[K] = Entries;
+		}
+
+		return Entries;
+	}
+
+	void WorkspaceCache::Invalidate()
+	{
+		std::lock_guard<std::mutex> Lock(ListMutex);
+		Listings.clear();
+		Generation++;
+	}
+
+	bool WorkspaceCache::Snapshot(const std::wstring& Root, std::uint64_t& Out)
+	{
+		std::lock_guard<std::mutex> Lock(ListMutex);
+		StartWatching(Root);
+
+		Out = Generation;
+		return Watching.load(std::memory_order_acquire);
+	}
+
+	void WorkspaceCache::StartWatching(const std::wstring& Root)
+	{
+		if (WatchStarted)
+			return;
+
+		WatchStarted = true;
+		std::thread([this, Root] { Watch(Root); }).detach();
+	}
+
+	bool WorkspaceCache::Scan(const std::wstring& Root, const std::wstring& Folder, const bool Recursive, std::vector<DirEntry>& Out)
+	{
+		std::vector<std::wstring> Pending{ Folder };
+
+		for (size_t i = 0; i < Pending.size(); i++)
+		{
+			const auto Current = Pending[i];
+
+			/* Basic info skips the 8.3 name lookup, large fetch pulls entries in bigger batches per syscall */
+			WIN32_FIND_DATAW Data;
+			const auto Find = FindFirstFileExW((Current + L"\\*").c_str(), FindExInfoBasic, &Data, FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+			if (Find == INVALID_HANDLE_VALUE)
+			{
+				if (i == 0)
+					return false;
+				continue;
+			}
+
+			do
+			{
+				if (Data.cFileName[0] == L'.' && (!Data.cFileName[1] || (Data.cFileName[1] == L'.' && !Data.cFileName[2])))
+					continue;
+
+				const auto Full = Current + L"\\" + Data.cFileName;
+				const auto Relative = Full.substr(Root.length() + 1);
+
+				DirEntry Entry;
+				Entry.Path.assign(Relative.begin(), Relative.end());
+				Entry.Folder = (Data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+				Entry.Size = Entry.Folder ? 0 : ((std::uint64_t) Data.nFileSizeHigh << 32) | Data.nFileSizeLow;
+
+				/* FILETIME to unix seconds */
+				const auto Written = ((std::uint64_t) Data.ftLastWriteTime.dwHighDateTime << 32) | Data.ftLastWriteTime.dwLowDateTime;
+				Entry.Modified = Written > 116444736000000000ull ? (Written - 116444736000000000ull) / 10000000ull : 0;
+
+				if (Recursive && Entry.Folder && !(Data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT))
+					Pending.push_back(Full);
+
+				Out.push_back(std::move(Entry));
+			} while (FindNextFileW(Find, &Data));
+
+			FindClose(Find);
+		}
+
+		return true;
+	}
+
+	void WorkspaceCache::Watch(const std::wstring Root)
+	{
+		const auto Directory = CreateFileW(Root.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+		if (Directory == INVALID_HANDLE_VALUE)
+			return;
+
+		Watching.store(true, std::memory_order_release);
+
+		/* Only the fact that something changed matters, an overflowed buffer still returns and invalidates */
+		alignas(DWORD) BYTE Buffer[16 * 1024];
+		DWORD Returned;
+		while (ReadDirectoryChangesW(Directory, Buffer, sizeof(Buffer), TRUE,
+			FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE,
+			&Returned, nullptr, nullptr))
+		{
+			Invalidate();
+		}
+
+		Watching.store(false, std::memory_order_release);
+		Invalidate();
+		CloseHandle(Directory);
+	}
+
+	void WorkspaceCache::Flusher()
+	{
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> Lock(Mutex);
+				Wake.wait_for(Lock, std::chrono::milliseconds(FlushInterval), [this] { return Bytes >= FlushThreshold; });
+
+				if (Entries.empty())
+					continue;
+			}
+
+			Flush();
+		}
+	}
+}
@@ -0,0 +1,131 @@
+
+/*
+*
+*	SYNAPSE X
+*	File.:	WorkspaceCache.hpp
+*	Desc.:	Write-behind cache for workspace files
+*
+*/
+
+#pragma once
+
+#include "../Exploit/Misc/Static.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace syn
+{
+	/* writefile/appendfile land here and are coalesced per path, a background thread puts them on disk every
+	   FlushInterval. Anything that reads the disk copy of a pending path has to call Sync first */
+	class WorkspaceCache
+	{
+	public:
+		static constexpr DWORD FlushInterval = 500;
+
+		/* Pending bytes that wake the flusher early */
+		static constexpr size_t FlushThreshold = 8 * 1024 * 1024;
+
+		static WorkspaceCache* GetSingleton()
+		{
+			static WorkspaceCache* Singleton = nullptr;
+			if (Singleton == nullptr)
+				Singleton = new WorkspaceCache();
+			return Singleton;
+		}
+
+		/* Replaces the file's contents, false if its folder doesn't exist. A Level goes to disk as a compressed
+		   frame, deflated by the flusher */
+		bool Write(const std::wstring& Path, const char* Data, size_t Size, int Level = 0);
+
+		/* Appends to the file, false if it exists neither on disk nor in the cache */
+		bool Append(const std::wstring& Path, const char* Data, size_t Size);
+
+		/* True with Out filled when the cache holds the whole file, false means read the (now current) disk copy */
+		bool Read(const std::wstring& Path, std::string& Out);
+
+		/* Whether the path will exist once pending writes are flushed */
+		bool Pending(const std::wstring& Path);
+
+		/* Drops any pending write for the path, returns whether there was one */
+		bool Discard(const std::wstring& Path);
+
+		/* Flushes everything if the path has a pending write, so the disk copy can be used directly */
+		void Sync(const std::wstring& Path);
+
+		/* Puts every pending write on disk before returning */
+		void Flush();
+
+		struct DirEntry
+		{
+			std::string Path;
+			bool Folder;
+			std::uint64_t Size;
+			std::uint64_t Modified;
+		};
+
+		typedef std::shared_ptr<const std::vector<DirEntry>> Listing;
+
+		/* Entries of Folder (recursively if asked) with paths relative to Root, null if Folder can't be listed.
+		   Snapshots are kept until something under Root changes */
+		Listing List(const std::wstring& Root, const std::wstring& Folder, bool Recursive);
+
+		/* Drops every cached listing, the directory watcher calls this for changes made outside of us */
+		void Invalidate();
+
+		/* The generation Invalidate moves on, false while no watcher runs to move it for outside changes */
+		bool Snapshot(const std::wstring& Root, std::uint64_t& Out);
+
+	private:
+		struct Entry
+		{
+			std::wstring Path;
+			std::string Data;
+			bool Append = false;
+			int Level = 0;
+		};
+
+		WorkspaceCache();
+
+		static std::wstring Key(const std::wstring& Path);
+
+		/* Mutex held, extends an existing entry */
+		bool AppendPending(const std::wstring& K, const char* Data, size_t Size);
+
+		void Flusher();
+
+		void Watch(std::wstring Root);
+
+		/* ListMutex held */
+		void StartWatching(const std::wstring& Root);
+
+		static bool Scan(const std::wstring& Root, const std::wstring& Folder, bool Recursive, std::vector<DirEntry>& Out);
+
+		typedef std::unordered_map<std::wstring, Entry> Batch;
+
+		/* Mutex held, the entry for K in the batch being written, null if it isn't part of it */
+		const Entry* Writing(const std::wstring& K) const;
+
+		/* Once per batch, the first failed path and how many failed with it */
+		static void Report(const std::wstring& Path, DWORD Error, size_t Failed);
+
+		/* Entries holds what hasn't been written yet, InFlight the swapped out batch while FlushMutex is held to
+		   write it. Paths outside of InFlight never have to wait for the flusher */
+		std::mutex Mutex;
+		std::mutex FlushMutex;
+		std::condition_variable Wake;
+		Batch Entries;
+		std::shared_ptr<const Batch> InFlight;
+		size_t Bytes = 0;
+
+		std::mutex ListMutex;
+		std::unordered_map<std::wstring, Listing> Listings;
+		std::uint64_t Generation = 0;
+		std::atomic<bool> Watching{ false };
+		bool WatchStarted = false;
+	};
+}
@@ -0,0 +1,126 @@
+#include "./WorkspacePaths.hpp"
+#include "./WorkspaceCache.hpp"
+#include "./Utils.hpp"
+
+#include <cstring>
+
+namespace syn
+{
+	static bool is_forbidden_extension(const char* Extension, const size_t Size)
+	{
+		static const char* DisallowedExtensions[] =
+		{
+			".exe", ".scr", ".bat", ".com", ".csh", ".msi", ".vb", ".vbs", ".vbe", ".ws", ".wsf", ".wsh", ".ps1"
+		};
+
+		for (const auto Test : DisallowedExtensions)
+		{
+			if (strlen(Test) == Size && _strnicmp(Extension, Test, Size) == 0)
+				return true;
+		}
+
+		return false;
+	}
+
+	const char* WorkspacePaths::Resolve(const std::wstring& Root, const char* Data, const size_t Size, Path& Out)
+	{
+		const std::string_view Key(Data, Size);
+		const auto Slot = std::hash<std::string_view>()(Key) % Slots;
+		const auto Cacheable = Size <= MaxCached;
+
+		if (Cacheable)
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			if (Root.size() == this->Root.size() && Root == this->Root && Recent[Slot] && Recent[Slot]->Key == Key)
+			{
+				Out = Recent[Slot];
+				return nullptr;
+			}
+		}
+
+		/* One pass for the separators, the escape check and the extension, PathFindExtensionA's rules: the last dot
+		   after the last separator or space, and nothing past an embedded null counts */
+		char Stack[MaxCached];
+		std::string Heap;
+		const auto Buffer = Cacheable ? Stack : (Heap.resize(Size), Heap.data());
+
+		size_t Extension = Size;
+		auto Terminated = false;
+		for (size_t i = 0; i < Size; i++)
+		{
+			auto C = Data[i];
+			if (C == '/')
+				C = '\\';
+
+			if (C == '.' && i && Data[i - 1] == '.')
+				return "attempt to escape directory";
+
+			if (!C)
+				Terminated = true;
+			else if (!Terminated)
+			{
+				if (C == '\\' || C == ' ')
+					Extension = Size;
+				else if (C == '.')
+					Extension = i;
+			}
+
+			Buffer[i] = C;
+		}
+
+		auto Resolved = std::make_shared<Entry>();
+		Resolved->Key.assign(Data, Size);
+		Resolved->Relative.assign(Buffer, Size);
+		Resolved->Full = Root + L"\\" + ConvertToWStr(Resolved->Relative);
+
+		if (Extension != Size)
+		{
+			auto End = Extension;
+			while (End < Size && Buffer[End])
+				End++;
+			Resolved->Forbidden = is_forbidden_extension(Buffer + Extension, End - Extension);
+		}
+
+		if (Cacheable)
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			if (Root != this->Root)
+			{
+				this->Root = Root;
+				Recent.fill(nullptr);
+			}
+
+			Recent[Slot] = Resolved;
+		}
+
+		Out = std::move(Resolved);
+		return nullptr;
+	}
+
+	WorkspacePaths::Kind WorkspacePaths::KindOf(const Entry& P)
+	{
+		std::uint64_t Generation;
+		bool Trusted;
+
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			Trusted = !Root.empty() && WorkspaceCache::GetSingleton()->Snapshot(Root, Generation);
+			if (Trusted && P.Seen != Kind::Unknown && P.SeenAt == Generation)
+				return P.Seen;
+		}
+
+		const auto Attributes = GetFileAttributesW(P.Full.c_str());
+		const auto Found = Attributes == INVALID_FILE_ATTRIBUTES ? Kind::Missing : (Attributes & FILE_ATTRIBUTE_DIRECTORY) ? Kind::Folder : Kind::File;
+
+		/* Stamped with the generation from before the query, a change racing it moves the generation on and the
+		   result is asked for again */
+		if (Trusted)
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			P.Seen = Found;
+			P.SeenAt = Generation;
+		}
+
+		return Found;
+	}
+}
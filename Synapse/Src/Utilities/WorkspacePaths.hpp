@@ -0,0 +1,81 @@
+
+/*
+*
+*	SYNAPSE X
+*	File.:	WorkspacePaths.hpp
+*	Desc.:	Workspace path resolution shared by the file APIs, with recent results cached
+*
+*/
+
+#pragma once
+
+#include "../Exploit/Misc/Static.hpp"
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace syn
+{
+	/* Turns a script's path into the full workspace path once. The last few paths are remembered with what they
+	   pointed at, so a script hammering the same files skips the conversion and most of the existence checks */
+	class WorkspacePaths
+	{
+	public:
+		static WorkspacePaths* GetSingleton()
+		{
+			static WorkspacePaths* Singleton = nullptr;
+			if (Singleton == nullptr)
+				Singleton = new WorkspacePaths();
+			return Singleton;
+		}
+
+		enum class Kind : std::uint8_t
+		{
+			Unknown,
+			Missing,
+			File,
+			Folder
+		};
+
+		struct Entry
+		{
+			std::string Key;
+
+			/* Separators turned into backslashes, what the asset packs are searched with */
+			std::string Relative;
+			std::wstring Full;
+
+			/* An extension writefile and appendfile refuse */
+			bool Forbidden = false;
+
+		private:
+			friend class WorkspacePaths;
+
+			/* Guarded by the resolver's mutex, only trusted while the listing generation it was seen at is current */
+			mutable Kind Seen = Kind::Unknown;
+			mutable std::uint64_t SeenAt = 0;
+		};
+
+		typedef std::shared_ptr<const Entry> Path;
+
+		/* nullptr with Out filled, or the error for a path that tries to leave Root */
+		const char* Resolve(const std::wstring& Root, const char* Data, size_t Size, Path& Out);
+
+		/* What the path is on disk, pending writes aren't counted. One attribute query at most per change to the
+		   workspace while the WorkspaceCache watcher runs, one per call otherwise */
+		Kind KindOf(const Entry& P);
+
+	private:
+		static constexpr size_t Slots = 64;
+
+		/* Longer paths are resolved on the heap and never cached */
+		static constexpr size_t MaxCached = 520;
+
+		std::mutex Mutex;
+		std::wstring Root;
+		std::array<Path, Slots> Recent;
+	};
+}